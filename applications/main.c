@@ -12,6 +12,7 @@
 #include "base/i2c_api.h"
 #include "base/uart_api.h"
 #include "base/spi_api.h"
+#include "base/dma_api.h"
 
 /* 定义任务栈大小 */
 #define TASK_STACK_SIZE         (1024)
@@ -288,6 +289,11 @@ int main(void)
     
     printf("RTOS initialized\n");
     
+#if (TARGET_PLATFORM == PLATFORM_STM32)
+    /* DMA内存拷贝引擎依赖RTOS同步对象，在RTOS初始化之后创建 */
+    dma_memcpy_init();
+#endif
+    
     /* 创建消息队列 */
     rtos_queue_create(&g_message_queue, sizeof(message_t), QUEUE_LENGTH);
     
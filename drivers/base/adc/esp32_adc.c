@@ -10,8 +10,35 @@
 #include "esp_log.h"
 #include "driver/adc.h"
 #include "esp_adc_cal.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <stdlib.h>
 #include <string.h>
 
+/* 流式采样DMA每次中断搬运的字节数 */
+#ifndef CONFIG_ADC_STREAM_FRAME_SIZE
+#define CONFIG_ADC_STREAM_FRAME_SIZE        256
+#endif
+
+/* 流式采样驱动缓冲池大小，用于吸收任务调度延迟 */
+#ifndef CONFIG_ADC_STREAM_POOL_SIZE
+#define CONFIG_ADC_STREAM_POOL_SIZE         4096
+#endif
+
+/* 流式采样任务配置 */
+#ifndef CONFIG_ADC_STREAM_TASK_STACK_SIZE
+#define CONFIG_ADC_STREAM_TASK_STACK_SIZE   3072
+#endif
+
+#ifndef CONFIG_ADC_STREAM_TASK_PRIORITY
+#define CONFIG_ADC_STREAM_TASK_PRIORITY     12
+#endif
+
+#ifndef CONFIG_ADC_STREAM_READ_TIMEOUT_MS
+#define CONFIG_ADC_STREAM_READ_TIMEOUT_MS   100
+#endif
+
 /* 日志标签 */
 static const char *TAG = "ESP32_ADC";
 
@@ -40,6 +67,32 @@ typedef struct {
 /* ADC设备句柄数组 */
 static esp32_adc_handle_t g_adc_handles[ADC_CHANNEL_MAX];
 
+/* ADC流式采样状态 */
+typedef struct {
+    adc_stream_config_t config;    /* 流式采样配置 */
+    esp32_adc_handle_t *owner;     /* 启动流的句柄 */
+    volatile bool running;         /* 运行标志 */
+    SemaphoreHandle_t exit_sem;    /* 任务退出信号 */
+    uint8_t pattern_channel[CONFIG_ADC_SCAN_MAX_CHANNELS]; /* 扫描序列的硬件通道 */
+    uint16_t frame_raw[CONFIG_ADC_SCAN_MAX_CHANNELS];      /* 正在组装的帧 */
+    uint32_t accumulator[CONFIG_ADC_SCAN_MAX_CHANNELS];    /* 过采样累加值 */
+    uint8_t position;              /* 帧内位置 */
+    bool synced;                   /* 已与扫描序列对齐 */
+    uint32_t decimation;           /* 过采样倍数 */
+    uint32_t decimation_count;     /* 当前累加帧数 */
+    uint16_t *blocks[2];           /* 双缓冲数据块 */
+    uint8_t fill_index;            /* 正在填充的数据块 */
+    uint32_t frame_count;          /* 当前数据块已填帧数 */
+    uint8_t raw[CONFIG_ADC_STREAM_FRAME_SIZE]; /* DMA原始结果 */
+    adc_stream_stats_t stats;      /* 统计信息 */
+} esp32_adc_stream_t;
+
+static esp32_adc_stream_t g_adc_stream;
+
+/* ADC1由流式采样或连续转换独占，占用标志在该临界区内检查和设置 */
+static portMUX_TYPE g_adc_unit_mux = portMUX_INITIALIZER_UNLOCKED;
+static bool g_adc_stream_claimed;
+
 /**
  * @brief 将抽象分辨率转换为ESP32分辨?
  * 
@@ -187,6 +240,9 @@ int adc_deinit(adc_handle_t handle)
     if (esp32_handle->continuous_mode) {
         adc_stop_continuous(handle);
     }
+
+    /* 停止由该句柄启动的流式采样 */
+    adc_stop_stream(handle);
     
     /* 重置句柄 */
     memset(esp32_handle, 0, sizeof(esp32_adc_handle_t));
@@ -286,15 +342,18 @@ int adc_start_continuous(adc_handle_t handle, adc_conversion_callback_t callback
         return ERROR_NOT_INITIALIZED;
     }
     
-    /* 检查是否已处于连续模式 */
-    if (esp32_handle->continuous_mode) {
+    /* 检查是否已处于连续模式，流式采样占用ADC1时也不能启动 */
+    portENTER_CRITICAL(&g_adc_unit_mux);
+    if (esp32_handle->continuous_mode || g_adc_stream_claimed) {
+        portEXIT_CRITICAL(&g_adc_unit_mux);
         return ERROR_BUSY;
     }
+    esp32_handle->continuous_mode = true;
+    portEXIT_CRITICAL(&g_adc_unit_mux);
     
     /* 设置回调函数和用户数?*/
     esp32_handle->callback = callback;
     esp32_handle->user_data = user_data;
-    esp32_handle->continuous_mode = true;
     
     /* 创建ADC转换任务 */
     ret = xTaskCreate(continuous_adc_task, "adc_task", 2048, 
@@ -411,3 +470,319 @@ int adc_set_trigger_source(adc_handle_t handle, uint32_t trigger_source)
     return ERROR_NOT_SUPPORTED;
 }
 
+/**
+ * @brief 按帧整理一段DMA原始结果
+ *
+ * 结果按扫描序列顺序到达，通道号不符时丢弃当前帧并等待序列首通道重新
+ * 对齐。低于硬件最低采样率时以整数倍过采样，每decimation帧取平均
+ *
+ * @param stream 流式采样状态
+ * @param raw DMA原始结果
+ * @param length 字节数
+ */
+static void adc_stream_process(esp32_adc_stream_t *stream, const uint8_t *raw, uint32_t length)
+{
+    uint32_t channel_count = stream->config.channel_count;
+
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= length; i += SOC_ADC_DIGI_RESULT_BYTES) {
+        const adc_digi_output_data_t *out = (const adc_digi_output_data_t *)&raw[i];
+        uint8_t channel = out->type1.channel;
+
+        if (channel != stream->pattern_channel[stream->position]) {
+            if (stream->synced) {
+                stream->synced = false;
+                stream->stats.resyncs++;
+            }
+            stream->position = 0;
+            if (channel != stream->pattern_channel[0]) {
+                continue;
+            }
+        }
+        stream->synced = true;
+
+        stream->frame_raw[stream->position++] = out->type1.data;
+        if (stream->position < channel_count) {
+            continue;
+        }
+        stream->position = 0;
+
+        for (uint32_t ch = 0; ch < channel_count; ch++) {
+            stream->accumulator[ch] += stream->frame_raw[ch];
+        }
+        if (++stream->decimation_count < stream->decimation) {
+            continue;
+        }
+        stream->decimation_count = 0;
+
+        uint16_t *frame = &stream->blocks[stream->fill_index][stream->frame_count * channel_count];
+        for (uint32_t ch = 0; ch < channel_count; ch++) {
+            frame[ch] = (uint16_t)(stream->accumulator[ch] / stream->decimation);
+            stream->accumulator[ch] = 0;
+        }
+
+        if (++stream->frame_count == stream->config.frames_per_block) {
+            /* 交付后切换到另一个缓冲区，刚交付的数据块在下一块填满前保持不变 */
+            stream->frame_count = 0;
+            stream->stats.blocks++;
+            stream->config.callback(stream->blocks[stream->fill_index],
+                                    stream->config.frames_per_block, stream->config.user_data);
+            stream->fill_index ^= 1;
+        }
+    }
+}
+
+/**
+ * @brief 流式采样任务
+ *
+ * DMA按帧中断搬运结果，任务每次取出一整帧DMA数据，不再逐个采样唤醒
+ *
+ * @param arg 流式采样状态
+ */
+static void adc_stream_task(void *arg)
+{
+    esp32_adc_stream_t *stream = (esp32_adc_stream_t *)arg;
+    uint32_t length;
+    esp_err_t ret;
+
+    while (stream->running) {
+        ret = adc_digi_read_bytes(stream->raw, sizeof(stream->raw), &length,
+                                  CONFIG_ADC_STREAM_READ_TIMEOUT_MS);
+        if (ret == ESP_ERR_INVALID_STATE) {
+            /* 驱动缓冲池已满，中间有数据丢失，当前帧作废 */
+            stream->stats.overruns++;
+            stream->synced = false;
+            stream->position = 0;
+        } else if (ret != ESP_OK) {
+            continue;
+        }
+
+        adc_stream_process(stream, stream->raw, length);
+    }
+
+    xSemaphoreGive(stream->exit_sem);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief 判断是否有句柄处于连续转换模式
+ *
+ * 须在g_adc_unit_mux临界区内调用
+ */
+static bool adc_continuous_active(void)
+{
+    for (int i = 0; i < ADC_CHANNEL_MAX; i++) {
+        if (g_adc_handles[i].continuous_mode) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief 配置数字控制器并启动流式采样任务
+ *
+ * @param esp32_handle ADC设备句柄
+ * @param config 流式采样配置
+ * @return int 0表示成功，非0表示失败
+ */
+static int adc_stream_open(esp32_adc_handle_t *esp32_handle, const adc_stream_config_t *config)
+{
+    esp32_adc_stream_t *stream = &g_adc_stream;
+    adc_digi_pattern_config_t pattern[CONFIG_ADC_SCAN_MAX_CHANNELS];
+    adc_digi_init_config_t init_config;
+    adc_digi_configuration_t digi_config;
+    uint32_t channel_mask = 0;
+    esp_err_t ret;
+
+    memset(stream, 0, sizeof(esp32_adc_stream_t));
+    stream->config = *config;
+    stream->owner = esp32_handle;
+
+    /* 扫描序列只支持ADC1，衰减与句柄通道一致 */
+    for (uint8_t i = 0; i < config->channel_count; i++) {
+        if (config->channels[i] > ADC_CHANNEL_7) {
+            ESP_LOGE(TAG, "Invalid ADC stream channel: %d", config->channels[i]);
+            return ERROR_INVALID_PARAM;
+        }
+        stream->pattern_channel[i] = (uint8_t)ADC1_CHANNEL_MAP[config->channels[i]];
+        pattern[i].atten = convert_reference(esp32_handle->config.reference);
+        pattern[i].channel = stream->pattern_channel[i];
+        pattern[i].unit = 0;
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+        channel_mask |= BIT(stream->pattern_channel[i]);
+    }
+
+    /* 低于硬件最低转换率时过采样后平均 */
+    uint32_t conversion_rate = config->frame_rate_hz * config->channel_count;
+    stream->decimation = 1;
+    while (conversion_rate * stream->decimation < SOC_ADC_SAMPLE_FREQ_THRES_LOW) {
+        stream->decimation++;
+    }
+    if (conversion_rate * stream->decimation > SOC_ADC_SAMPLE_FREQ_THRES_HIGH) {
+        ESP_LOGE(TAG, "ADC stream rate too high: %u", (unsigned)conversion_rate);
+        return ERROR_INVALID_PARAM;
+    }
+
+    /* 双缓冲数据块 */
+    uint32_t block_samples = config->frames_per_block * config->channel_count;
+    stream->blocks[0] = malloc(2 * block_samples * sizeof(uint16_t));
+    if (stream->blocks[0] == NULL) {
+        return ERROR_MEMORY;
+    }
+    stream->blocks[1] = stream->blocks[0] + block_samples;
+
+    stream->exit_sem = xSemaphoreCreateBinary();
+    if (stream->exit_sem == NULL) {
+        free(stream->blocks[0]);
+        return ERROR_MEMORY;
+    }
+
+    init_config.max_store_buf_size = CONFIG_ADC_STREAM_POOL_SIZE;
+    init_config.conv_num_each_intr = CONFIG_ADC_STREAM_FRAME_SIZE;
+    init_config.adc1_chan_mask = channel_mask;
+    init_config.adc2_chan_mask = 0;
+    ret = adc_digi_initialize(&init_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "ADC digi initialize failed: %d", ret);
+        goto error;
+    }
+
+    digi_config.conv_limit_en = true;
+    digi_config.conv_limit_num = 250;
+    digi_config.pattern_num = config->channel_count;
+    digi_config.adc_pattern = pattern;
+    digi_config.sample_freq_hz = conversion_rate * stream->decimation;
+    digi_config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    digi_config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+    ret = adc_digi_controller_configure(&digi_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "ADC digi configure failed: %d", ret);
+        adc_digi_deinitialize();
+        goto error;
+    }
+
+    stream->running = true;
+    if (xTaskCreate(adc_stream_task, "adc_stream", CONFIG_ADC_STREAM_TASK_STACK_SIZE,
+                    stream, CONFIG_ADC_STREAM_TASK_PRIORITY, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create ADC stream task");
+        stream->running = false;
+        adc_digi_deinitialize();
+        goto error;
+    }
+
+    adc_digi_start();
+
+    ESP_LOGI(TAG, "ADC stream started: channels=%d, rate=%uHz, decimation=%u",
+             config->channel_count, (unsigned)config->frame_rate_hz, (unsigned)stream->decimation);
+
+    return DRIVER_OK;
+
+error:
+    vSemaphoreDelete(stream->exit_sem);
+    free(stream->blocks[0]);
+    stream->blocks[0] = NULL;
+    return ERROR_HARDWARE;
+}
+
+/**
+ * @brief 启动定时器触发的DMA流式采样
+ *
+ * ESP32的数字控制器由I2S采样时钟触发转换，结果经DMA写入驱动缓冲池
+ *
+ * @param handle ADC设备句柄
+ * @param config 流式采样配置
+ * @return int 0表示成功，非0表示失败
+ */
+int adc_start_stream(adc_handle_t handle, const adc_stream_config_t *config)
+{
+    esp32_adc_handle_t *esp32_handle = (esp32_adc_handle_t *)handle;
+    int ret;
+
+    /* 参数检查 */
+    if (esp32_handle == NULL || config == NULL || config->channels == NULL || config->callback == NULL ||
+        config->channel_count == 0 || config->channel_count > CONFIG_ADC_SCAN_MAX_CHANNELS ||
+        config->frame_rate_hz == 0 || config->frames_per_block == 0) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if (!esp32_handle->initialized) {
+        return ERROR_NOT_INITIALIZED;
+    }
+
+    /* DMA控制器只有一个，任一句柄的流式采样或连续转换都占用整个ADC1 */
+    portENTER_CRITICAL(&g_adc_unit_mux);
+    if (g_adc_stream_claimed || adc_continuous_active()) {
+        portEXIT_CRITICAL(&g_adc_unit_mux);
+        return ERROR_BUSY;
+    }
+    g_adc_stream_claimed = true;
+    portEXIT_CRITICAL(&g_adc_unit_mux);
+
+    ret = adc_stream_open(esp32_handle, config);
+    if (ret != DRIVER_OK) {
+        portENTER_CRITICAL(&g_adc_unit_mux);
+        g_adc_stream_claimed = false;
+        portEXIT_CRITICAL(&g_adc_unit_mux);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief 停止流式采样
+ *
+ * @param handle ADC设备句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int adc_stop_stream(adc_handle_t handle)
+{
+    esp32_adc_stream_t *stream = &g_adc_stream;
+
+    if (handle == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if (!stream->running || stream->owner != (esp32_adc_handle_t *)handle) {
+        return DRIVER_OK;
+    }
+
+    /* 等待任务退出后再释放缓冲区，返回后不会再有回调 */
+    stream->running = false;
+    adc_digi_stop();
+    xSemaphoreTake(stream->exit_sem, portMAX_DELAY);
+    adc_digi_deinitialize();
+
+    vSemaphoreDelete(stream->exit_sem);
+    free(stream->blocks[0]);
+    stream->blocks[0] = NULL;
+    stream->blocks[1] = NULL;
+
+    portENTER_CRITICAL(&g_adc_unit_mux);
+    g_adc_stream_claimed = false;
+    portEXIT_CRITICAL(&g_adc_unit_mux);
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 获取流式采样统计信息
+ *
+ * @param handle ADC设备句柄
+ * @param stats 统计信息输出
+ * @return int 0表示成功，非0表示失败
+ */
+int adc_get_stream_stats(adc_handle_t handle, adc_stream_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if (g_adc_stream.owner != (esp32_adc_handle_t *)handle) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    *stats = g_adc_stream.stats;
+
+    return DRIVER_OK;
+}
@@ -0,0 +1,330 @@
+/**
+ * @file common_can_soft_filter.c
+ * @brief CAN软件验收过滤器实现（平台无关）
+ */
+
+#include "base/can_soft_filter_api.h"
+#include <string.h>
+
+#if (CONFIG_CAN_SOFT_FILTER_EXT_HASH_SIZE & (CONFIG_CAN_SOFT_FILTER_EXT_HASH_SIZE - 1)) != 0
+#error "CONFIG_CAN_SOFT_FILTER_EXT_HASH_SIZE must be a power of two"
+#endif
+
+/* 私有定义 */
+#define EXT_HASH_MASK       (CONFIG_CAN_SOFT_FILTER_EXT_HASH_SIZE - 1)
+#define EXT_HASH_MAX_LOAD   (CONFIG_CAN_SOFT_FILTER_EXT_HASH_SIZE * 3 / 4)
+#define EXT_ID_MAX          0x1FFFFFFFU
+#define EXT_SLOT_EMPTY      0xFFFFFFFFU     /* 扩展帧ID仅29位，高位全1的值不会与有效ID冲突 */
+#define EXT_SLOT_DELETED    0xFFFFFFFEU
+#define STD_ID_MAX          (CAN_SOFT_FILTER_STD_IDS - 1)
+
+#if defined(__arm__)
+/*
+ * 统计计数同时在接收中断和线程上下文中更新。Cortex-M0没有LDREX/STREX，
+ * __atomic_fetch_add会变成libatomic调用，单核上用PRIMASK临界区即可
+ */
+static inline void filter_stat_inc(uint32_t *counter) {
+    uint32_t primask;
+
+    __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (primask) : : "memory");
+    (*counter)++;
+    __asm volatile ("msr primask, %0" : : "r" (primask) : "memory");
+}
+#else
+static inline void filter_stat_inc(uint32_t *counter) {
+    __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED);
+}
+#endif
+
+/**
+ * @brief 扩展帧ID哈希（Fibonacci散列）
+ */
+static inline uint32_t ext_hash(uint32_t id) {
+    return (id * 2654435761U) >> 16;
+}
+
+/**
+ * @brief 在哈希表中查找扩展帧ID
+ *
+ * @return int 表项索引，未找到返回-1
+ */
+static int ext_find(const can_soft_filter_t *filter, uint32_t id) {
+    uint32_t slot = ext_hash(id);
+
+    for (uint32_t i = 0; i < CONFIG_CAN_SOFT_FILTER_EXT_HASH_SIZE; i++, slot++) {
+        uint32_t key = __atomic_load_n(&filter->ext_table[slot & EXT_HASH_MASK].id, __ATOMIC_ACQUIRE);
+
+        if (key == id) {
+            return (int)(slot & EXT_HASH_MASK);
+        }
+
+        if (key == EXT_SLOT_EMPTY) {
+            break;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief 删除扩展帧哈希表项（后移删除）
+ *
+ * 将探测链上后续可前移的表项逐个搬入空位，不留下删除标记，
+ * 反复增删不会使探测链变长。搬移时先在空位发布副本再标记原位置，
+ * 中断中的查找在任意时刻都能找到每个有效ID；只有链尾的空位才写为空闲
+ */
+static void ext_remove(can_soft_filter_t *filter, uint32_t hole) {
+    __atomic_store_n(&filter->ext_table[hole].id, EXT_SLOT_DELETED, __ATOMIC_RELEASE);
+
+    for (uint32_t next = (hole + 1) & EXT_HASH_MASK; next != hole; next = (next + 1) & EXT_HASH_MASK) {
+        can_soft_filter_ext_entry_t *entry = &filter->ext_table[next];
+        uint32_t key = entry->id;
+
+        if (key == EXT_SLOT_EMPTY) {
+            break;
+        }
+
+        /* 仅当空位位于该项的探测路径[home, next)上时才能前移 */
+        uint32_t home = ext_hash(key) & EXT_HASH_MASK;
+        if (((next - home) & EXT_HASH_MASK) < ((next - hole) & EXT_HASH_MASK)) {
+            continue;
+        }
+
+        filter->ext_table[hole].routes = entry->routes;
+        __atomic_store_n(&filter->ext_table[hole].id, key, __ATOMIC_RELEASE);
+        __atomic_store_n(&entry->id, EXT_SLOT_DELETED, __ATOMIC_RELEASE);
+        hole = next;
+    }
+
+    filter->ext_table[hole].routes = 0;
+    __atomic_store_n(&filter->ext_table[hole].id, EXT_SLOT_EMPTY, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief 判断扩展帧规则是否命中
+ */
+static inline bool ext_rule_match(const can_soft_filter_rule_t *rule, uint32_t id) {
+    if (rule->type == CAN_SOFT_FILTER_RULE_RANGE) {
+        return id >= rule->id && id <= rule->id_end;
+    }
+
+    return (id & rule->id_end) == (rule->id & rule->id_end);
+}
+
+/**
+ * @brief 初始化软件过滤器
+ */
+int can_soft_filter_init(can_soft_filter_t *filter) {
+    if (filter == NULL) {
+        return CAN_SOFT_FILTER_INVALID_PARAM;
+    }
+
+    memset(filter, 0, sizeof(can_soft_filter_t));
+
+    return can_soft_filter_clear(filter);
+}
+
+/**
+ * @brief 注册订阅者
+ */
+int can_soft_filter_subscribe(can_soft_filter_t *filter, uint8_t route,
+                              can_soft_filter_handler_t handler, void *arg) {
+    if (filter == NULL || route == 0 || route >= CAN_SOFT_FILTER_MAX_ROUTES) {
+        return CAN_SOFT_FILTER_INVALID_PARAM;
+    }
+
+    /* 先清除处理函数，避免接收路径看到新旧参数混合 */
+    filter->subscribers[route].handler = NULL;
+    filter->subscribers[route].arg = arg;
+    __atomic_store_n(&filter->subscribers[route].handler, handler, __ATOMIC_RELEASE);
+
+    return CAN_SOFT_FILTER_OK;
+}
+
+/**
+ * @brief 设置标准帧ID范围的路由
+ */
+int can_soft_filter_set_std_range(can_soft_filter_t *filter, uint32_t id_start,
+                                  uint32_t id_end, uint8_t routes) {
+    if (filter == NULL || id_start > id_end || id_end > STD_ID_MAX) {
+        return CAN_SOFT_FILTER_INVALID_PARAM;
+    }
+
+    /* 单字节写入，接收路径无需加锁 */
+    memset(&filter->std_routes[id_start], routes, id_end - id_start + 1);
+
+    return CAN_SOFT_FILTER_OK;
+}
+
+/**
+ * @brief 按掩码设置标准帧路由
+ */
+int can_soft_filter_set_std_mask(can_soft_filter_t *filter, uint32_t id,
+                                 uint32_t mask, uint8_t routes) {
+    if (filter == NULL || id > STD_ID_MAX) {
+        return CAN_SOFT_FILTER_INVALID_PARAM;
+    }
+
+    /* 掩码规则在配置时展开到路由表，接收路径仍为一次查表 */
+    mask &= STD_ID_MAX;
+    for (uint32_t i = 0; i < CAN_SOFT_FILTER_STD_IDS; i++) {
+        if ((i & mask) == (id & mask)) {
+            filter->std_routes[i] = routes;
+        }
+    }
+
+    return CAN_SOFT_FILTER_OK;
+}
+
+/**
+ * @brief 设置单个扩展帧ID的路由
+ */
+int can_soft_filter_set_ext(can_soft_filter_t *filter, uint32_t id, uint8_t routes) {
+    if (filter == NULL || id > EXT_ID_MAX) {
+        return CAN_SOFT_FILTER_INVALID_PARAM;
+    }
+
+    int index = ext_find(filter, id);
+
+    if (index >= 0) {
+        if (routes == 0) {
+            ext_remove(filter, (uint32_t)index);
+            filter->ext_count--;
+        } else {
+            filter->ext_table[index].routes = routes;
+        }
+        return CAN_SOFT_FILTER_OK;
+    }
+
+    if (routes == 0) {
+        return CAN_SOFT_FILTER_OK;
+    }
+
+    if (filter->ext_count >= EXT_HASH_MAX_LOAD) {
+        return CAN_SOFT_FILTER_NO_SPACE;
+    }
+
+    /* 删除时不留删除标记，探测链上第一个空闲槽位即插入位置 */
+    uint32_t slot = ext_hash(id);
+    for (uint32_t i = 0; i < CONFIG_CAN_SOFT_FILTER_EXT_HASH_SIZE; i++, slot++) {
+        can_soft_filter_ext_entry_t *entry = &filter->ext_table[slot & EXT_HASH_MASK];
+
+        if (entry->id == EXT_SLOT_EMPTY) {
+            /* 先写路由再发布ID */
+            entry->routes = routes;
+            __atomic_store_n(&entry->id, id, __ATOMIC_RELEASE);
+            filter->ext_count++;
+            return CAN_SOFT_FILTER_OK;
+        }
+    }
+
+    return CAN_SOFT_FILTER_NO_SPACE;
+}
+
+/**
+ * @brief 添加扩展帧范围或掩码规则
+ */
+int can_soft_filter_add_ext_rule(can_soft_filter_t *filter, const can_soft_filter_rule_t *rule) {
+    if (filter == NULL || rule == NULL || rule->routes == 0) {
+        return CAN_SOFT_FILTER_INVALID_PARAM;
+    }
+
+    if (rule->type == CAN_SOFT_FILTER_RULE_RANGE && (rule->id > rule->id_end || rule->id_end > EXT_ID_MAX)) {
+        return CAN_SOFT_FILTER_INVALID_PARAM;
+    }
+
+    uint32_t count = filter->ext_rule_count;
+    if (count >= CONFIG_CAN_SOFT_FILTER_EXT_RULES) {
+        return CAN_SOFT_FILTER_NO_SPACE;
+    }
+
+    /* 规则写完后再发布数量 */
+    memcpy(&filter->ext_rules[count], rule, sizeof(can_soft_filter_rule_t));
+    __atomic_store_n(&filter->ext_rule_count, count + 1, __ATOMIC_RELEASE);
+
+    return CAN_SOFT_FILTER_OK;
+}
+
+/**
+ * @brief 清除所有过滤规则
+ */
+int can_soft_filter_clear(can_soft_filter_t *filter) {
+    if (filter == NULL) {
+        return CAN_SOFT_FILTER_INVALID_PARAM;
+    }
+
+    filter->ext_rule_count = 0;
+    memset(filter->std_routes, 0, sizeof(filter->std_routes));
+
+    for (uint32_t i = 0; i < CONFIG_CAN_SOFT_FILTER_EXT_HASH_SIZE; i++) {
+        filter->ext_table[i].id = EXT_SLOT_EMPTY;
+        filter->ext_table[i].routes = 0;
+    }
+    filter->ext_count = 0;
+
+    return CAN_SOFT_FILTER_OK;
+}
+
+/**
+ * @brief 查找帧ID对应的路由掩码
+ */
+uint8_t can_soft_filter_match(can_soft_filter_t *filter, uint32_t id, can_id_type_t id_type) {
+    uint8_t routes = 0;
+
+    if (id_type == CAN_ID_STANDARD) {
+        routes = id <= STD_ID_MAX ? filter->std_routes[id] : 0;
+    } else {
+        int index = ext_find(filter, id);
+        if (index >= 0) {
+            routes = filter->ext_table[index].routes;
+        }
+
+        uint32_t count = __atomic_load_n(&filter->ext_rule_count, __ATOMIC_ACQUIRE);
+        for (uint32_t i = 0; i < count; i++) {
+            if (ext_rule_match(&filter->ext_rules[i], id)) {
+                routes |= filter->ext_rules[i].routes;
+            }
+        }
+    }
+
+    if (routes != 0) {
+        filter_stat_inc(&filter->stats.accepted);
+    } else {
+        filter_stat_inc(&filter->stats.dropped);
+    }
+
+    return routes;
+}
+
+/**
+ * @brief 将消息分发给路由掩码中的订阅者
+ */
+void can_soft_filter_dispatch(const can_soft_filter_t *filter, uint8_t routes, const can_message_t *message) {
+    /* 路由0为驱动接收队列 */
+    routes &= (uint8_t)~CAN_SOFT_FILTER_ROUTE_QUEUE;
+
+    while (routes != 0) {
+        uint32_t route = (uint32_t)__builtin_ctz(routes);
+        can_soft_filter_handler_t handler = __atomic_load_n(&filter->subscribers[route].handler, __ATOMIC_ACQUIRE);
+
+        if (handler != NULL) {
+            handler(message, filter->subscribers[route].arg);
+        }
+
+        routes &= (uint8_t)(routes - 1);
+    }
+}
+
+/**
+ * @brief 获取过滤器统计信息
+ */
+int can_soft_filter_get_stats(const can_soft_filter_t *filter, can_soft_filter_stats_t *stats) {
+    if (filter == NULL || stats == NULL) {
+        return CAN_SOFT_FILTER_INVALID_PARAM;
+    }
+
+    stats->accepted = __atomic_load_n(&filter->stats.accepted, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&filter->stats.dropped, __ATOMIC_RELAXED);
+
+    return CAN_SOFT_FILTER_OK;
+}
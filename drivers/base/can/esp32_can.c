@@ -4,6 +4,7 @@
  */
 
 #include "base/can_api.h"
+#include "base/can_soft_filter_api.h"
 #include "esp32_platform.h"
 #include <string.h>
 #include "driver/twai.h"
@@ -31,6 +32,7 @@ typedef struct {
     uint32_t timestamp;                 /* 时间?*/
     TaskHandle_t rx_task_handle;        /* 接收任务句柄 */
     bool rx_task_running;               /* 接收任务运行标志 */
+    can_soft_filter_t *soft_filter;     /* 软件过滤器，NULL表示接收所有帧 */
 } esp32_can_t;
 
 /* CAN设备实例 */
@@ -85,22 +87,39 @@ static void can_rx_task(void *arg) {
         esp_err_t ret = twai_receive(&twai_msg, pdMS_TO_TICKS(100));
         
         if (ret == ESP_OK) {
+            /* 更新统计信息 */
+            can_dev->stats.rx_count++;
+            
+            /* 软件过滤，未命中的帧在转换前丢弃 */
+            can_soft_filter_t *filter = can_dev->soft_filter;
+            uint8_t routes = CAN_SOFT_FILTER_ROUTE_QUEUE;
+            if (filter != NULL) {
+                routes = can_soft_filter_match(filter, twai_msg.identifier,
+                                               (twai_msg.flags & TWAI_MSG_FLAG_EXTD) ? CAN_ID_EXTENDED : CAN_ID_STANDARD);
+                if (routes == 0) {
+                    continue;
+                }
+            }
+            
             /* 转换消息格式 */
             can_message_t can_msg;
             twai_to_can_message(&twai_msg, &can_msg);
             can_msg.timestamp = can_dev->timestamp++;
             
-            /* 更新统计信息 */
-            can_dev->stats.rx_count++;
-            
             /* 存储消息 */
-            memcpy(&can_dev->rx_msg, &can_msg, sizeof(can_message_t));
-            can_dev->rx_pending = true;
+            if (routes & CAN_SOFT_FILTER_ROUTE_QUEUE) {
+                memcpy(&can_dev->rx_msg, &can_msg, sizeof(can_message_t));
+                can_dev->rx_pending = true;
+            }
             
             /* 调用用户回调函数 */
             if (can_dev->callback != NULL) {
                 can_dev->callback(can_dev->callback_arg, CAN_STATUS_COMPLETE, &can_msg);
             }
+            
+            if (filter != NULL) {
+                can_soft_filter_dispatch(filter, routes, &can_msg);
+            }
         } else if (ret == ESP_ERR_TIMEOUT) {
             /* 超时，继续等?*/
         } else {
@@ -426,6 +445,27 @@ int can_receive(can_handle_t handle, can_message_t *msg, uint32_t timeout_ms) {
     return -1; /* 接收超时或失?*/
 }
 
+/**
+ * @brief 批量接收CAN消息
+ */
+int can_receive_batch(can_handle_t handle, can_message_t *msgs, uint32_t max_count, uint32_t timeout_ms) {
+    if (msgs == NULL || max_count == 0) {
+        return -1;
+    }
+    
+    /* 仅首帧等待，其余帧取TWAI驱动队列中已有的消息 */
+    if (can_receive(handle, &msgs[0], timeout_ms) != 0) {
+        return 0;
+    }
+    
+    uint32_t count = 1;
+    while (count < max_count && can_receive(handle, &msgs[count], 0) == 0) {
+        count++;
+    }
+    
+    return (int)count;
+}
+
 /**
  * @brief 获取CAN统计信息
  */
@@ -580,6 +620,21 @@ int can_set_rx_callback(can_handle_t handle, can_callback_t callback, void *arg)
     return 0;
 }
 
+/**
+ * @brief 挂接CAN软件过滤器
+ */
+int can_set_soft_filter(can_handle_t handle, can_soft_filter_t *filter) {
+    esp32_can_t *can_dev = (esp32_can_t *)handle;
+    
+    if (can_dev == NULL || !can_dev->initialized) {
+        return -1;
+    }
+    
+    can_dev->soft_filter = filter;
+    
+    return 0;
+}
+
 /**
  * @brief 获取CAN设备状?
  */
@@ -4,13 +4,36 @@
  */
 
 #include "base/can_api.h"
+#include "base/can_soft_filter_api.h"
 #include "stm32_platform.h"
+#include <stddef.h>
 #include <string.h>
 
+#if (CURRENT_RTOS != RTOS_NONE)
+#include "common/rtos_api.h"
+#endif
+
 /* 私有定义 */
 #define STM32_CAN_MAX_FILTERS      14  /* STM32 CAN外设最大过滤器数量 */
 #define STM32_CAN_MAX_INSTANCES    2   /* STM32 CAN外设最大实例数?*/
 
+/* 每个实例的接收环形队列深度，必须为2的幂 */
+#ifndef CONFIG_CAN_RX_QUEUE_SIZE
+#define CONFIG_CAN_RX_QUEUE_SIZE   32
+#endif
+
+#if (CONFIG_CAN_RX_QUEUE_SIZE & (CONFIG_CAN_RX_QUEUE_SIZE - 1)) != 0
+#error "CONFIG_CAN_RX_QUEUE_SIZE must be a power of two"
+#endif
+
+#define STM32_CAN_RX_QUEUE_MASK    (CONFIG_CAN_RX_QUEUE_SIZE - 1)
+
+/* 接收时间戳来源（微秒） */
+#ifndef STM32_CAN_TIME_US
+extern uint64_t platform_get_time_us(void);
+#define STM32_CAN_TIME_US()        ((uint32_t)platform_get_time_us())
+#endif
+
 /* 波特率预分频和时序定?*/
 typedef struct {
     uint32_t prescaler;    /* 预分频器?*/
@@ -43,77 +66,140 @@ typedef struct {
     can_config_t config;                    /* CAN配置参数 */
     can_stats_t stats;                      /* 统计信息 */
     can_status_t status;                    /* 设备状?*/
-    bool rx_pending;                        /* 接收挂起标志 */
-    can_message_t rx_msg;                   /* 接收消息缓存 */
-    uint32_t timestamp;                     /* 时间?*/
+    can_message_t rx_queue[CONFIG_CAN_RX_QUEUE_SIZE]; /* 接收环形队列 */
+    volatile uint32_t rx_head;              /* 队列写索引，仅由接收中断推进 */
+    volatile uint32_t rx_tail;              /* 队列读索引，仅由接收者推进 */
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_sem_t rx_sem;                      /* 新消息到达通知 */
+#endif
+    can_soft_filter_t *soft_filter;         /* 软件过滤器，NULL表示接收所有帧 */
 } stm32_can_t;
 
 /* CAN设备实例 */
 static stm32_can_t can_instances[STM32_CAN_MAX_INSTANCES];
 
+/**
+ * @brief 由HAL句柄获取设备实例
+ */
+static inline stm32_can_t *stm32_can_from_hal(CAN_HandleTypeDef *hcan) {
+    return (stm32_can_t *)((uint8_t *)hcan - offsetof(stm32_can_t, hcan));
+}
+
 /**
  * @brief CAN接收中断回调函数
+ *
+ * 一次中断取空硬件FIFO，消息直接写入接收环形队列的空闲槽位，
+ * 队列满时丢弃新消息并计入溢出计数。挂接软件过滤器时，未命中的帧
+ * 不发布到队列也不触发回调，槽位留给下一帧复用
  */
 static void stm32_can_rx_callback(CAN_HandleTypeDef *hcan, uint32_t fifo) {
-    stm32_can_t *can_dev = NULL;
+    stm32_can_t *can_dev = stm32_can_from_hal(hcan);
     
-    /* 查找对应的设备实?*/
-    for (int i = 0; i < STM32_CAN_MAX_INSTANCES; i++) {
-        if (can_instances[i].initialized && &can_instances[i].hcan == hcan) {
-            can_dev = &can_instances[i];
+    if (!can_dev->initialized) {
+        return;
+    }
+    
+    can_soft_filter_t *filter = can_dev->soft_filter;
+    uint32_t timestamp = STM32_CAN_TIME_US();
+    uint32_t head = can_dev->rx_head;
+    uint32_t queued = 0;
+    
+    while (HAL_CAN_GetRxFifoFillLevel(hcan, fifo) > 0) {
+        CAN_RxHeaderTypeDef rx_header;
+        can_message_t overflow_msg;
+        can_message_t *msg;
+        bool full = (head - __atomic_load_n(&can_dev->rx_tail, __ATOMIC_ACQUIRE)) >= CONFIG_CAN_RX_QUEUE_SIZE;
+        
+        /* 队列满时仍需读出硬件FIFO以清除中断 */
+        msg = full ? &overflow_msg : &can_dev->rx_queue[head & STM32_CAN_RX_QUEUE_MASK];
+        
+        if (HAL_CAN_GetRxMessage(hcan, fifo, &rx_header, msg->data) != HAL_OK) {
+            can_dev->stats.error_count++;
             break;
         }
+        
+        can_dev->stats.rx_count++;
+        
+        /* 填充接收消息结构 */
+        msg->id = rx_header.IDE == CAN_ID_STD ? rx_header.StdId : rx_header.ExtId;
+        msg->id_type = rx_header.IDE == CAN_ID_STD ? CAN_ID_STANDARD : CAN_ID_EXTENDED;
+        
+        /* 软件过滤，未命中的帧在填充其余字段前丢弃 */
+        uint8_t routes = CAN_SOFT_FILTER_ROUTE_QUEUE;
+        if (filter != NULL) {
+            routes = can_soft_filter_match(filter, msg->id, msg->id_type);
+            if (routes == 0) {
+                continue;
+            }
+        }
+        
+        msg->frame_type = rx_header.RTR == CAN_RTR_DATA ? CAN_FRAME_DATA : CAN_FRAME_REMOTE;
+        msg->dlc = rx_header.DLC;
+        msg->timestamp = timestamp;
+        
+        /* 调用用户回调函数 */
+        if (can_dev->callback != NULL) {
+            can_dev->callback(can_dev->callback_arg, CAN_STATUS_COMPLETE, msg);
+        }
+        
+        if (filter != NULL) {
+            can_soft_filter_dispatch(filter, routes, msg);
+        }
+        
+        if (!(routes & CAN_SOFT_FILTER_ROUTE_QUEUE)) {
+            continue;
+        }
+        
+        if (full) {
+            can_dev->stats.overrun_count++;
+        } else {
+            head++;
+            queued++;
+        }
     }
     
-    if (can_dev == NULL) {
+    if (queued == 0) {
         return;
     }
     
-    /* 接收CAN消息 */
-    CAN_RxHeaderTypeDef rx_header;
-    uint8_t data[8];
+    /* 消息内容写完后再发布写索引 */
+    __atomic_store_n(&can_dev->rx_head, head, __ATOMIC_RELEASE);
     
-    if (HAL_CAN_GetRxMessage(hcan, fifo, &rx_header, data) != HAL_OK) {
-        can_dev->stats.error_count++;
-        return;
-    }
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_sem_give(can_dev->rx_sem);
+#endif
+}
+
+/**
+ * @brief 从接收环形队列取出消息
+ *
+ * @return uint32_t 取出的消息数量
+ */
+static uint32_t stm32_can_rx_pop(stm32_can_t *can_dev, can_message_t *msgs, uint32_t max_count) {
+    uint32_t tail = can_dev->rx_tail;
+    uint32_t count = __atomic_load_n(&can_dev->rx_head, __ATOMIC_ACQUIRE) - tail;
     
-    can_dev->stats.rx_count++;
+    if (count > max_count) {
+        count = max_count;
+    }
     
-    /* 填充接收消息结构 */
-    can_message_t msg;
-    msg.id = rx_header.IDE == CAN_ID_STD ? rx_header.StdId : rx_header.ExtId;
-    msg.id_type = rx_header.IDE == CAN_ID_STD ? CAN_ID_STANDARD : CAN_ID_EXTENDED;
-    msg.frame_type = rx_header.RTR == CAN_RTR_DATA ? CAN_FRAME_DATA : CAN_FRAME_REMOTE;
-    msg.dlc = rx_header.DLC;
-    memcpy(msg.data, data, msg.dlc);
-    msg.timestamp = can_dev->timestamp++;
+    for (uint32_t i = 0; i < count; i++) {
+        memcpy(&msgs[i], &can_dev->rx_queue[(tail + i) & STM32_CAN_RX_QUEUE_MASK], sizeof(can_message_t));
+    }
     
-    /* 存储消息并设置标?*/
-    memcpy(&can_dev->rx_msg, &msg, sizeof(can_message_t));
-    can_dev->rx_pending = true;
+    /* 复制完成后再释放槽位 */
+    __atomic_store_n(&can_dev->rx_tail, tail + count, __ATOMIC_RELEASE);
     
-    /* 调用用户回调函数 */
-    if (can_dev->callback != NULL) {
-        can_dev->callback(can_dev->callback_arg, CAN_STATUS_COMPLETE, &msg);
-    }
+    return count;
 }
 
 /**
  * @brief CAN错误中断回调函数
  */
 static void stm32_can_error_callback(CAN_HandleTypeDef *hcan) {
-    stm32_can_t *can_dev = NULL;
-    
-    /* 查找对应的设备实?*/
-    for (int i = 0; i < STM32_CAN_MAX_INSTANCES; i++) {
-        if (can_instances[i].initialized && &can_instances[i].hcan == hcan) {
-            can_dev = &can_instances[i];
-            break;
-        }
-    }
+    stm32_can_t *can_dev = stm32_can_from_hal(hcan);
     
-    if (can_dev == NULL) {
+    if (!can_dev->initialized) {
         return;
     }
     
@@ -131,6 +217,11 @@ static void stm32_can_error_callback(CAN_HandleTypeDef *hcan) {
         can_dev->stats.passive_error = true;
     }
     
+    if (error & HAL_CAN_ERROR_RX_FOV0) {
+        /* 硬件接收FIFO溢出 */
+        can_dev->stats.overrun_count++;
+    }
+    
     if (error & HAL_CAN_ERROR_STUFF) {
         /* 位填充错?*/
     }
@@ -236,11 +327,19 @@ int can_init(const can_config_t *config, can_callback_t callback, void *arg, can
     if (HAL_CAN_ActivateNotification(hcan, CAN_IT_RX_FIFO0_MSG_PENDING | 
                                            CAN_IT_ERROR | 
                                            CAN_IT_BUSOFF | 
-                                           CAN_IT_LAST_ERROR_CODE) != HAL_OK) {
+                                           CAN_IT_LAST_ERROR_CODE |
+                                           CAN_IT_RX_FIFO0_OVERRUN) != HAL_OK) {
         HAL_CAN_DeInit(hcan);
         return -1;
     }
     
+#if (CURRENT_RTOS != RTOS_NONE)
+    if (rtos_sem_create(&can_dev->rx_sem, 0, 1) != 0) {
+        HAL_CAN_DeInit(hcan);
+        return -1;
+    }
+#endif
+    
     /* 标记为已初始?*/
     can_dev->initialized = true;
     can_dev->status = CAN_STATUS_IDLE;
@@ -265,6 +364,10 @@ int can_deinit(can_handle_t handle) {
     HAL_CAN_Stop(&can_dev->hcan);
     HAL_CAN_DeInit(&can_dev->hcan);
     
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_sem_delete(can_dev->rx_sem);
+#endif
+    
     /* 清除设备数据 */
     can_dev->initialized = false;
     
@@ -448,67 +551,41 @@ int can_transmit(can_handle_t handle, const can_message_t *msg, uint32_t timeout
 }
 
 /**
- * @brief 接收CAN消息
+ * @brief 批量接收CAN消息
  */
-int can_receive(can_handle_t handle, can_message_t *msg, uint32_t timeout_ms) {
+int can_receive_batch(can_handle_t handle, can_message_t *msgs, uint32_t max_count, uint32_t timeout_ms) {
     stm32_can_t *can_dev = (stm32_can_t *)handle;
     
-    if (can_dev == NULL || !can_dev->initialized || msg == NULL) {
+    if (can_dev == NULL || !can_dev->initialized || msgs == NULL || max_count == 0) {
         return -1;
     }
     
-    /* 如果有挂起的消息，直接返?*/
-    if (can_dev->rx_pending) {
-        memcpy(msg, &can_dev->rx_msg, sizeof(can_message_t));
-        can_dev->rx_pending = false;
-        return 0;
-    }
+    uint32_t start_time = HAL_GetTick();
+    uint32_t count;
     
-    /* 如果没有挂起的消息，检查是否有消息可接?*/
-    if (HAL_CAN_GetRxFifoFillLevel(&can_dev->hcan, CAN_RX_FIFO0) > 0) {
-        CAN_RxHeaderTypeDef rx_header;
-        uint8_t data[8];
-        
-        if (HAL_CAN_GetRxMessage(&can_dev->hcan, CAN_RX_FIFO0, &rx_header, data) != HAL_OK) {
-            can_dev->stats.error_count++;
-            return -1;
-        }
-        
-        /* 填充接收消息结构 */
-        msg->id = rx_header.IDE == CAN_ID_STD ? rx_header.StdId : rx_header.ExtId;
-        msg->id_type = rx_header.IDE == CAN_ID_STD ? CAN_ID_STANDARD : CAN_ID_EXTENDED;
-        msg->frame_type = rx_header.RTR == CAN_RTR_DATA ? CAN_FRAME_DATA : CAN_FRAME_REMOTE;
-        msg->dlc = rx_header.DLC;
-        memcpy(msg->data, data, msg->dlc);
-        msg->timestamp = can_dev->timestamp++;
+    /* 队列为空时等待接收中断通知，不再轮询 */
+    while ((count = stm32_can_rx_pop(can_dev, msgs, max_count)) == 0) {
+        uint32_t elapsed = HAL_GetTick() - start_time;
         
-        /* 更新统计信息 */
-        can_dev->stats.rx_count++;
-        
-        return 0;
-    }
-    
-    /* 如果没有消息，根据超时设置等?*/
-    if (timeout_ms == 0) {
-        return -1; /* 无消息且不等?*/
-    }
-    
-    /* 等待消息 */
-    uint32_t start_time = HAL_GetTick();
-    while (!can_dev->rx_pending) {
-        if (timeout_ms != UINT32_MAX && (HAL_GetTick() - start_time > timeout_ms)) {
-            return -1; /* 超时 */
+        if (timeout_ms == 0 || (timeout_ms != UINT32_MAX && elapsed >= timeout_ms)) {
+            return 0; /* 超时 */
         }
         
-        /* 让出CPU时间 */
-        HAL_Delay(1);
+#if (CURRENT_RTOS != RTOS_NONE)
+        rtos_sem_take(can_dev->rx_sem, timeout_ms == UINT32_MAX ? UINT32_MAX : timeout_ms - elapsed);
+#else
+        __WFI();
+#endif
     }
     
-    /* 返回接收到的消息 */
-    memcpy(msg, &can_dev->rx_msg, sizeof(can_message_t));
-    can_dev->rx_pending = false;
-    
-    return 0;
+    return (int)count;
+}
+
+/**
+ * @brief 接收CAN消息
+ */
+int can_receive(can_handle_t handle, can_message_t *msg, uint32_t timeout_ms) {
+    return can_receive_batch(handle, msg, 1, timeout_ms) == 1 ? 0 : -1;
 }
 
 /**
@@ -642,6 +719,21 @@ int can_set_rx_callback(can_handle_t handle, can_callback_t callback, void *arg)
     return 0;
 }
 
+/**
+ * @brief 挂接CAN软件过滤器
+ */
+int can_set_soft_filter(can_handle_t handle, can_soft_filter_t *filter) {
+    stm32_can_t *can_dev = (stm32_can_t *)handle;
+    
+    if (can_dev == NULL || !can_dev->initialized) {
+        return -1;
+    }
+    
+    __atomic_store_n(&can_dev->soft_filter, filter, __ATOMIC_RELEASE);
+    
+    return 0;
+}
+
 /**
  * @brief 获取CAN设备状?
  */
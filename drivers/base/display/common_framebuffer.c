@@ -0,0 +1,844 @@
+/**
+ * @file common_framebuffer.c
+ * @brief 帧缓冲与二维光栅实现（平台无关）
+ *
+ * 所有绘制先与裁剪区域求交，之后按行处理：8位和16位格式的填充把像素重复成
+ * 32位字后按字写入，复制使用memmove；单色格式的行首行尾按位掩码处理，中间
+ * 整字节按字填充，位偏移相同的复制直接按字节块复制。字形缓存保存已按像素格式
+ * 渲染好的字形，命中时只需逐行复制。
+ */
+
+#include "base/framebuffer_api.h"
+#include <string.h>
+
+/* 单色行复制方式 */
+typedef enum {
+    FB_MONO_COPY = 0,       /* 复制源位 */
+    FB_MONO_INVERT,         /* 复制源位取反 */
+    FB_MONO_SET,            /* 源位为1处置位 */
+    FB_MONO_CLEAR           /* 源位为1处清零 */
+} fb_mono_op_t;
+
+/* 行起始地址 */
+static uint8_t *fb_row(const framebuffer_t *fb, int32_t y)
+{
+    return fb->pixels + (uint32_t)y * fb->stride;
+}
+
+/* 每像素字节数，单色格式不使用 */
+static uint8_t fb_pixel_size(const framebuffer_t *fb)
+{
+    return (fb->config.format == FRAMEBUFFER_FORMAT_RGB565) ? 2 : 1;
+}
+
+/* 把颜色转换为内存中的像素字节 */
+static void fb_pixel_bytes(const framebuffer_t *fb, uint32_t color, uint8_t *bytes)
+{
+    if (fb->config.format == FRAMEBUFFER_FORMAT_RGB565) {
+        uint16_t value = (uint16_t)color;
+        memcpy(bytes, &value, sizeof(value));
+    } else {
+        bytes[0] = (uint8_t)color;
+    }
+}
+
+/**
+ * @brief 重复写入像素
+ *
+ * 起始处逐字节写到4字节边界，之后每次写入两个32位字
+ *
+ * @param dst 目标地址
+ * @param length 写入字节数，为pixel_size的整数倍
+ * @param pixel 像素字节
+ * @param pixel_size 每像素字节数
+ */
+static void fb_fill_pattern(uint8_t *dst, uint32_t length, const uint8_t *pixel, uint8_t pixel_size)
+{
+    uint32_t i = 0;
+
+    while (i < length && ((uintptr_t)(dst + i) & 3) != 0) {
+        dst[i] = pixel[i % pixel_size];
+        i++;
+    }
+
+    if (length - i >= 4) {
+        uint32_t *word_dst = (uint32_t *)(void *)(dst + i);
+        uint8_t bytes[4];
+        uint32_t word;
+
+        for (uint8_t j = 0; j < 4; j++) {
+            bytes[j] = pixel[(i + j) % pixel_size];
+        }
+        memcpy(&word, bytes, sizeof(word));
+
+        for (; length - i >= 8; i += 8) {
+            word_dst[0] = word;
+            word_dst[1] = word;
+            word_dst += 2;
+        }
+        if (length - i >= 4) {
+            *word_dst = word;
+            i += 4;
+        }
+    }
+
+    while (i < length) {
+        dst[i] = pixel[i % pixel_size];
+        i++;
+    }
+}
+
+/* 按掩码置位或清零 */
+static void fb_mono_apply(uint8_t *byte, uint8_t mask, bool on)
+{
+    if (on) {
+        *byte |= mask;
+    } else {
+        *byte &= (uint8_t)~mask;
+    }
+}
+
+/* 填充单色行中[x0, x1)范围 */
+static void fb_mono_span(uint8_t *row, int32_t x0, int32_t x1, bool on)
+{
+    int32_t first = x0 / 8;
+    int32_t last = (x1 - 1) / 8;
+    uint8_t head = (uint8_t)(0xFF << (x0 % 8));
+    uint8_t tail = (uint8_t)(0xFF >> (7 - (x1 - 1) % 8));
+
+    if (first == last) {
+        fb_mono_apply(&row[first], head & tail, on);
+        return;
+    }
+
+    fb_mono_apply(&row[first], head, on);
+    fb_mono_apply(&row[last], tail, on);
+
+    if (last - first > 1) {
+        uint8_t value = on ? 0xFF : 0x00;
+        fb_fill_pattern(&row[first + 1], (uint32_t)(last - first - 1), &value, 1);
+    }
+}
+
+/* 读取从bit开始的count位(不超过8位)，只访问包含这些位的字节 */
+static uint8_t fb_mono_read(const uint8_t *row, uint32_t bit, uint8_t count)
+{
+    uint8_t shift = bit % 8;
+    uint32_t value = row[bit / 8] >> shift;
+
+    if (shift + count > 8) {
+        value |= (uint32_t)row[bit / 8 + 1] << (8 - shift);
+    }
+
+    return (uint8_t)value;
+}
+
+/* 按方式写入目标字节中掩码对应的位 */
+static void fb_mono_write(uint8_t *byte, uint8_t bits, uint8_t mask, fb_mono_op_t op)
+{
+    switch (op) {
+        case FB_MONO_COPY:
+            *byte = (uint8_t)((*byte & ~mask) | (bits & mask));
+            break;
+        case FB_MONO_INVERT:
+            *byte = (uint8_t)((*byte & ~mask) | (~bits & mask));
+            break;
+        case FB_MONO_SET:
+            *byte |= (uint8_t)(bits & mask);
+            break;
+        default:
+            *byte &= (uint8_t)~(bits & mask);
+            break;
+    }
+}
+
+/* 写入目标行第index个字节中[lo, hi)位对应的源位 */
+static void fb_mono_copy_byte(uint8_t *dst, int32_t dx, const uint8_t *src, int32_t sx,
+                              int32_t index, int32_t lo, int32_t hi, fb_mono_op_t op)
+{
+    uint8_t count = (uint8_t)(hi - lo);
+    uint32_t src_bit = (uint32_t)(sx + (index * 8 + lo - dx));
+    uint8_t bits = (uint8_t)(fb_mono_read(src, src_bit, count) << lo);
+    uint8_t mask = (uint8_t)(((1U << count) - 1) << lo);
+
+    fb_mono_write(&dst[index], bits, mask, op);
+}
+
+/**
+ * @brief 单色行之间复制width位
+ *
+ * 位偏移相同的复制中间部分直接按字节块复制；同一行内向右移动时从右向左
+ * 处理，保证源位在被覆盖前读取
+ */
+static void fb_mono_copy(uint8_t *dst, int32_t dx, const uint8_t *src, int32_t sx, int32_t width, fb_mono_op_t op)
+{
+    int32_t first = dx / 8;
+    int32_t last = (dx + width - 1) / 8;
+    bool same_row = (dst == src);
+
+    if (op == FB_MONO_COPY && !same_row && (dx % 8) == (sx % 8) && width >= 16) {
+        int32_t head = (8 - dx % 8) % 8;
+        int32_t middle = (width - head) / 8;
+
+        if (head > 0) {
+            fb_mono_copy_byte(dst, dx, src, sx, first, dx % 8, 8, op);
+        }
+        memcpy(&dst[(dx + head) / 8], &src[(sx + head) / 8], (size_t)middle);
+        if (head + middle * 8 < width) {
+            fb_mono_copy_byte(dst, dx, src, sx, last, 0, (dx + width - 1) % 8 + 1, op);
+        }
+        return;
+    }
+
+    for (int32_t n = 0; n <= last - first; n++) {
+        int32_t index = (same_row && dx > sx) ? last - n : first + n;
+        int32_t lo = (index == first) ? dx % 8 : 0;
+        int32_t hi = (index == last) ? (dx + width - 1) % 8 + 1 : 8;
+
+        fb_mono_copy_byte(dst, dx, src, sx, index, lo, hi, op);
+    }
+}
+
+/* 写入像素，坐标已裁剪 */
+static void fb_put(framebuffer_t *fb, int32_t x, int32_t y, uint32_t color)
+{
+    uint8_t *row = fb_row(fb, y);
+
+    switch (fb->config.format) {
+        case FRAMEBUFFER_FORMAT_MONO:
+            fb_mono_apply(&row[x / 8], (uint8_t)(1 << (x % 8)), color != 0);
+            break;
+        case FRAMEBUFFER_FORMAT_GRAY8:
+            row[x] = (uint8_t)color;
+            break;
+        default: {
+            uint16_t value = (uint16_t)color;
+            memcpy(&row[x * 2], &value, sizeof(value));
+            break;
+        }
+    }
+}
+
+/* 把[x0, x1) x [y0, y1)并入脏矩形 */
+static void fb_mark(framebuffer_t *fb, int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+    if (fb->dirty_x1 <= fb->dirty_x0) {
+        fb->dirty_x0 = (int16_t)x0;
+        fb->dirty_y0 = (int16_t)y0;
+        fb->dirty_x1 = (int16_t)x1;
+        fb->dirty_y1 = (int16_t)y1;
+        return;
+    }
+
+    if (x0 < fb->dirty_x0) {
+        fb->dirty_x0 = (int16_t)x0;
+    }
+    if (y0 < fb->dirty_y0) {
+        fb->dirty_y0 = (int16_t)y0;
+    }
+    if (x1 > fb->dirty_x1) {
+        fb->dirty_x1 = (int16_t)x1;
+    }
+    if (y1 > fb->dirty_y1) {
+        fb->dirty_y1 = (int16_t)y1;
+    }
+}
+
+/**
+ * @brief 矩形与裁剪区域求交
+ *
+ * @return bool 交集非空时返回true，交集写入x0/y0/x1/y1(右下不含)
+ */
+static bool fb_clip(const framebuffer_t *fb, int32_t x, int32_t y, int32_t width, int32_t height,
+                    int32_t *x0, int32_t *y0, int32_t *x1, int32_t *y1)
+{
+    *x0 = (x > fb->clip_x0) ? x : fb->clip_x0;
+    *y0 = (y > fb->clip_y0) ? y : fb->clip_y0;
+    *x1 = (x + width < fb->clip_x1) ? x + width : fb->clip_x1;
+    *y1 = (y + height < fb->clip_y1) ? y + height : fb->clip_y1;
+
+    return *x0 < *x1 && *y0 < *y1;
+}
+
+/* 填充已裁剪的矩形 */
+static void fb_fill_clipped(framebuffer_t *fb, int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color)
+{
+    if (fb->config.format == FRAMEBUFFER_FORMAT_MONO) {
+        for (int32_t y = y0; y < y1; y++) {
+            fb_mono_span(fb_row(fb, y), x0, x1, color != 0);
+        }
+    } else {
+        uint8_t pixel[2];
+        uint8_t size = fb_pixel_size(fb);
+
+        fb_pixel_bytes(fb, color, pixel);
+        for (int32_t y = y0; y < y1; y++) {
+            fb_fill_pattern(fb_row(fb, y) + x0 * size, (uint32_t)(x1 - x0) * size, pixel, size);
+        }
+    }
+
+    fb_mark(fb, x0, y0, x1, y1);
+}
+
+int framebuffer_init(framebuffer_t *fb, const framebuffer_config_t *config)
+{
+    if (fb == NULL || config == NULL || config->memory == NULL ||
+        config->width == 0 || config->height == 0 ||
+        config->width > INT16_MAX || config->height > INT16_MAX ||
+        config->format > FRAMEBUFFER_FORMAT_RGB565 || ((uintptr_t)config->memory & 3) != 0) {
+        return FRAMEBUFFER_INVALID_PARAM;
+    }
+
+    if (config->memory_size < FRAMEBUFFER_SIZE(config->width, config->height, config->format)) {
+        return FRAMEBUFFER_NO_MEMORY;
+    }
+
+    memset(fb, 0, sizeof(*fb));
+    fb->config = *config;
+    fb->pixels = (uint8_t *)config->memory;
+    fb->stride = FRAMEBUFFER_STRIDE(config->width, config->format);
+    fb->clip_x1 = (int16_t)config->width;
+    fb->clip_y1 = (int16_t)config->height;
+
+    if (config->glyph_cache != NULL && config->glyph_slot_size > 0) {
+        uint32_t slots = config->glyph_cache_size / config->glyph_slot_size;
+        fb->glyph_count = (uint16_t)((slots < CONFIG_FRAMEBUFFER_GLYPH_ENTRIES) ? slots : CONFIG_FRAMEBUFFER_GLYPH_ENTRIES);
+    }
+
+    fb->initialized = true;
+    return FRAMEBUFFER_OK;
+}
+
+int framebuffer_set_clip(framebuffer_t *fb, const framebuffer_rect_t *rect)
+{
+    if (fb == NULL || !fb->initialized) {
+        return FRAMEBUFFER_INVALID_PARAM;
+    }
+
+    fb->clip_x0 = 0;
+    fb->clip_y0 = 0;
+    fb->clip_x1 = (int16_t)fb->config.width;
+    fb->clip_y1 = (int16_t)fb->config.height;
+
+    if (rect != NULL) {
+        int32_t x0, y0, x1, y1;
+
+        if (!fb_clip(fb, rect->x, rect->y, rect->width, rect->height, &x0, &y0, &x1, &y1)) {
+            x1 = x0;
+            y1 = y0;
+        }
+        fb->clip_x0 = (int16_t)x0;
+        fb->clip_y0 = (int16_t)y0;
+        fb->clip_x1 = (int16_t)x1;
+        fb->clip_y1 = (int16_t)y1;
+    }
+
+    return FRAMEBUFFER_OK;
+}
+
+int framebuffer_fill(framebuffer_t *fb, uint32_t color)
+{
+    if (fb == NULL || !fb->initialized) {
+        return FRAMEBUFFER_INVALID_PARAM;
+    }
+
+    if (fb->clip_x0 < fb->clip_x1 && fb->clip_y0 < fb->clip_y1) {
+        fb_fill_clipped(fb, fb->clip_x0, fb->clip_y0, fb->clip_x1, fb->clip_y1, color);
+    }
+
+    return FRAMEBUFFER_OK;
+}
+
+int framebuffer_fill_rect(framebuffer_t *fb, int16_t x, int16_t y, uint16_t width, uint16_t height, uint32_t color)
+{
+    int32_t x0, y0, x1, y1;
+
+    if (fb == NULL || !fb->initialized) {
+        return FRAMEBUFFER_INVALID_PARAM;
+    }
+
+    if (fb_clip(fb, x, y, width, height, &x0, &y0, &x1, &y1)) {
+        fb_fill_clipped(fb, x0, y0, x1, y1, color);
+    }
+
+    return FRAMEBUFFER_OK;
+}
+
+int framebuffer_set_pixel(framebuffer_t *fb, int16_t x, int16_t y, uint32_t color)
+{
+    if (fb == NULL || !fb->initialized) {
+        return FRAMEBUFFER_INVALID_PARAM;
+    }
+
+    if (x >= fb->clip_x0 && x < fb->clip_x1 && y >= fb->clip_y0 && y < fb->clip_y1) {
+        fb_put(fb, x, y, color);
+        fb_mark(fb, x, y, x + 1, y + 1);
+    }
+
+    return FRAMEBUFFER_OK;
+}
+
+int framebuffer_get_pixel(const framebuffer_t *fb, int16_t x, int16_t y, uint32_t *color)
+{
+    const uint8_t *row;
+
+    if (fb == NULL || !fb->initialized || color == NULL ||
+        x < 0 || y < 0 || x >= fb->config.width || y >= fb->config.height) {
+        return FRAMEBUFFER_INVALID_PARAM;
+    }
+
+    row = fb_row(fb, y);
+    switch (fb->config.format) {
+        case FRAMEBUFFER_FORMAT_MONO:
+            *color = (row[x / 8] >> (x % 8)) & 1;
+            break;
+        case FRAMEBUFFER_FORMAT_GRAY8:
+            *color = row[x];
+            break;
+        default: {
+            uint16_t value;
+            memcpy(&value, &row[x * 2], sizeof(value));
+            *color = value;
+            break;
+        }
+    }
+
+    return FRAMEBUFFER_OK;
+}
+
+int framebuffer_draw_line(framebuffer_t *fb, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint32_t color)
+{
+    int32_t dx, dy, sx, sy, err;
+    int32_t x, y;
+    int32_t bx0, by0, bx1, by1;
+
+    if (fb == NULL || !fb->initialized) {
+        return FRAMEBUFFER_INVALID_PARAM;
+    }
+
+    /* 水平线和竖直线按矩形填充 */
+    if (y0 == y1 || x0 == x1) {
+        int32_t left = (x0 < x1) ? x0 : x1;
+        int32_t top = (y0 < y1) ? y0 : y1;
+        int32_t width = ((x0 < x1) ? x1 - x0 : x0 - x1) + 1;
+        int32_t height = ((y0 < y1) ? y1 - y0 : y0 - y1) + 1;
+
+        if (fb_clip(fb, left, top, width, height, &bx0, &by0, &bx1, &by1)) {
+            fb_fill_clipped(fb, bx0, by0, bx1, by1, color);
+        }
+        return FRAMEBUFFER_OK;
+    }
+
+    /* 外接矩形完全在裁剪区域外时不绘制 */
+    if (!fb_clip(fb, (x0 < x1) ? x0 : x1, (y0 < y1) ? y0 : y1,
+                 ((x0 < x1) ? x1 - x0 : x0 - x1) + 1, ((y0 < y1) ? y1 - y0 : y0 - y1) + 1,
+                 &bx0, &by0, &bx1, &by1)) {
+        return FRAMEBUFFER_OK;
+    }
+
+    dx = (x1 > x0) ? x1 - x0 : x0 - x1;
+    dy = (y1 > y0) ? y0 - y1 : y1 - y0;
+    sx = (x0 < x1) ? 1 : -1;
+    sy = (y0 < y1) ? 1 : -1;
+    err = dx + dy;
+    x = x0;
+    y = y0;
+
+    for (;;) {
+        int32_t e2;
+
+        if (x >= bx0 && x < bx1 && y >= by0 && y < by1) {
+            fb_put(fb, x, y, color);
+        }
+        if (x == x1 && y == y1) {
+            break;
+        }
+
+        e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y += sy;
+        }
+    }
+
+    fb_mark(fb, bx0, by0, bx1, by1);
+    return FRAMEBUFFER_OK;
+}
+
+int framebuffer_draw_rect(framebuffer_t *fb, int16_t x, int16_t y, uint16_t width, uint16_t height, uint32_t color)
+{
+    if (fb == NULL || !fb->initialized) {
+        return FRAMEBUFFER_INVALID_PARAM;
+    }
+
+    if (width == 0 || height == 0) {
+        return FRAMEBUFFER_OK;
+    }
+
+    framebuffer_fill_rect(fb, x, y, width, 1, color);
+    framebuffer_fill_rect(fb, x, (int16_t)(y + height - 1), width, 1, color);
+    if (height > 2) {
+        framebuffer_fill_rect(fb, x, (int16_t)(y + 1), 1, (uint16_t)(height - 2), color);
+        framebuffer_fill_rect(fb, (int16_t)(x + width - 1), (int16_t)(y + 1), 1, (uint16_t)(height - 2), color);
+    }
+
+    return FRAMEBUFFER_OK;
+}
+
+int framebuffer_blit(framebuffer_t *fb, int16_t x, int16_t y,
+                     const framebuffer_t *src, const framebuffer_rect_t *src_rect)
+{
+    framebuffer_rect_t area;
+    int32_t x0, y0, x1, y1;
+    int32_t sx, sy, rows;
+    bool bottom_up;
+
+    if (fb == NULL || !fb->initialized || src == NULL || !src->initialized) {
+        return FRAMEBUFFER_INVALID_PARAM;
+    }
+
+    if (fb->config.format != src->config.format) {
+        return FRAMEBUFFER_NOT_SUPPORTED;
+    }
+
+    if (src_rect != NULL) {
+        area = *src_rect;
+    } else {
+        area.x = 0;
+        area.y = 0;
+        area.width = src->config.width;
+        area.height = src->config.height;
+    }
+
+    /* 源区域限制在源帧缓冲内，目标位置随之平移 */
+    if (area.x < 0) {
+        if (-area.x >= area.width) {
+            return FRAMEBUFFER_OK;
+        }
+        x = (int16_t)(x - area.x);
+        area.width = (uint16_t)(area.width + area.x);
+        area.x = 0;
+    }
+    if (area.y < 0) {
+        if (-area.y >= area.height) {
+            return FRAMEBUFFER_OK;
+        }
+        y = (int16_t)(y - area.y);
+        area.height = (uint16_t)(area.height + area.y);
+        area.y = 0;
+    }
+    if (area.x >= src->config.width || area.y >= src->config.height) {
+        return FRAMEBUFFER_OK;
+    }
+    if (area.x + area.width > src->config.width) {
+        area.width = (uint16_t)(src->config.width - area.x);
+    }
+    if (area.y + area.height > src->config.height) {
+        area.height = (uint16_t)(src->config.height - area.y);
+    }
+
+    if (!fb_clip(fb, x, y, area.width, area.height, &x0, &y0, &x1, &y1)) {
+        return FRAMEBUFFER_OK;
+    }
+
+    sx = area.x + (x0 - x);
+    sy = area.y + (y0 - y);
+    rows = y1 - y0;
+
+    /* 同一帧缓冲内向下移动时从最后一行开始复制 */
+    bottom_up = (src == fb && y0 > sy);
+
+    for (int32_t n = 0; n < rows; n++) {
+        int32_t r = bottom_up ? rows - 1 - n : n;
+        uint8_t *dst_row = fb_row(fb, y0 + r);
+        const uint8_t *src_row = fb_row(src, sy + r);
+
+        if (fb->config.format == FRAMEBUFFER_FORMAT_MONO) {
+            fb_mono_copy(dst_row, x0, src_row, sx, x1 - x0, FB_MONO_COPY);
+        } else {
+            uint8_t size = fb_pixel_size(fb);
+            memmove(dst_row + x0 * size, src_row + sx * size, (size_t)(x1 - x0) * size);
+        }
+    }
+
+    fb_mark(fb, x0, y0, x1, y1);
+    return FRAMEBUFFER_OK;
+}
+
+/* 绘制已裁剪的单色位图，(bx, by)为裁剪区域左上角在位图中的位置 */
+static void fb_bitmap_clipped(framebuffer_t *fb, int32_t x0, int32_t y0, int32_t x1, int32_t y1,
+                              const uint8_t *bitmap, uint32_t bytes_per_row, int32_t bx, int32_t by,
+                              uint32_t color, uint32_t bg_color)
+{
+    bool transparent = (bg_color == FRAMEBUFFER_TRANSPARENT);
+
+    if (fb->config.format == FRAMEBUFFER_FORMAT_MONO) {
+        bool fg_on = (color != 0);
+        bool bg_on = !transparent && bg_color != 0;
+        fb_mono_op_t op;
+
+        /* 前景与背景相同时位图内容无关，直接填充 */
+        if (!transparent && fg_on == bg_on) {
+            fb_fill_clipped(fb, x0, y0, x1, y1, color);
+            return;
+        }
+
+        if (transparent) {
+            op = fg_on ? FB_MONO_SET : FB_MONO_CLEAR;
+        } else {
+            op = fg_on ? FB_MONO_COPY : FB_MONO_INVERT;
+        }
+
+        for (int32_t y = y0; y < y1; y++) {
+            fb_mono_copy(fb_row(fb, y), x0, &bitmap[(uint32_t)(by + y - y0) * bytes_per_row], bx, x1 - x0, op);
+        }
+    } else {
+        uint8_t fg[2];
+        uint8_t bg[2];
+        uint8_t size = fb_pixel_size(fb);
+
+        fb_pixel_bytes(fb, color, fg);
+        fb_pixel_bytes(fb, bg_color, bg);
+
+        for (int32_t y = y0; y < y1; y++) {
+            const uint8_t *src = &bitmap[(uint32_t)(by + y - y0) * bytes_per_row];
+            uint8_t *dst = fb_row(fb, y) + x0 * size;
+
+            for (int32_t i = 0; i < x1 - x0; i++, dst += size) {
+                int32_t bit = bx + i;
+
+                if ((src[bit / 8] >> (bit % 8)) & 1) {
+                    memcpy(dst, fg, size);
+                } else if (!transparent) {
+                    memcpy(dst, bg, size);
+                }
+            }
+        }
+    }
+
+    fb_mark(fb, x0, y0, x1, y1);
+}
+
+int framebuffer_draw_bitmap(framebuffer_t *fb, int16_t x, int16_t y, uint16_t width, uint16_t height,
+                            const uint8_t *bitmap, uint32_t color, uint32_t bg_color)
+{
+    int32_t x0, y0, x1, y1;
+
+    if (fb == NULL || !fb->initialized || bitmap == NULL) {
+        return FRAMEBUFFER_INVALID_PARAM;
+    }
+
+    if (fb_clip(fb, x, y, width, height, &x0, &y0, &x1, &y1)) {
+        fb_bitmap_clipped(fb, x0, y0, x1, y1, bitmap, (width + 7) / 8, x0 - x, y0 - y, color, bg_color);
+    }
+
+    return FRAMEBUFFER_OK;
+}
+
+/**
+ * @brief 查找或渲染缓存字形
+ *
+ * @return uint8_t* 按像素格式渲染好的字形，每行width个像素紧密排列
+ */
+static const uint8_t *fb_glyph_lookup(framebuffer_t *fb, const framebuffer_font_t *font, uint8_t ch,
+                                      const uint8_t *glyph, uint32_t color, uint32_t bg_color)
+{
+    uint16_t victim = 0;
+    uint8_t size = fb_pixel_size(fb);
+    uint32_t bytes_per_row = (font->width + 7) / 8;
+    uint8_t fg[2];
+    uint8_t bg[2];
+    uint8_t *slot;
+
+    fb->glyph_clock++;
+
+    for (uint16_t i = 0; i < fb->glyph_count; i++) {
+        framebuffer_glyph_t *entry = &fb->glyphs[i];
+
+        if (entry->font == font && entry->ch == ch && entry->color == color && entry->bg_color == bg_color) {
+            entry->last_used = fb->glyph_clock;
+            fb->stats.glyph_hits++;
+            return (const uint8_t *)fb->config.glyph_cache + (uint32_t)i * fb->config.glyph_slot_size;
+        }
+
+        /* 优先复用空闲项，否则淘汰最久未用的项 */
+        if (fb->glyphs[victim].font != NULL &&
+            (entry->font == NULL || entry->last_used < fb->glyphs[victim].last_used)) {
+            victim = i;
+        }
+    }
+
+    fb->stats.glyph_misses++;
+
+    slot = (uint8_t *)fb->config.glyph_cache + (uint32_t)victim * fb->config.glyph_slot_size;
+    fb_pixel_bytes(fb, color, fg);
+    fb_pixel_bytes(fb, bg_color, bg);
+
+    for (uint32_t row = 0; row < font->height; row++) {
+        const uint8_t *src = &glyph[row * bytes_per_row];
+        uint8_t *dst = &slot[row * font->width * size];
+
+        for (uint32_t col = 0; col < font->width; col++) {
+            memcpy(&dst[col * size], ((src[col / 8] >> (col % 8)) & 1) ? fg : bg, size);
+        }
+    }
+
+    fb->glyphs[victim].font = font;
+    fb->glyphs[victim].ch = ch;
+    fb->glyphs[victim].color = color;
+    fb->glyphs[victim].bg_color = bg_color;
+    fb->glyphs[victim].last_used = fb->glyph_clock;
+
+    return slot;
+}
+
+int framebuffer_draw_char(framebuffer_t *fb, int16_t x, int16_t y, const framebuffer_font_t *font,
+                          char ch, uint32_t color, uint32_t bg_color)
+{
+    uint8_t code = (uint8_t)ch;
+    uint32_t bytes_per_row;
+    const uint8_t *glyph;
+    int32_t x0, y0, x1, y1;
+
+    if (fb == NULL || !fb->initialized || font == NULL || font->data == NULL) {
+        return FRAMEBUFFER_INVALID_PARAM;
+    }
+
+    if (code < font->first || code > font->last) {
+        return FRAMEBUFFER_INVALID_PARAM;
+    }
+
+    if (!fb_clip(fb, x, y, font->width, font->height, &x0, &y0, &x1, &y1)) {
+        return FRAMEBUFFER_OK;
+    }
+
+    bytes_per_row = (font->width + 7) / 8;
+    glyph = &font->data[(uint32_t)(code - font->first) * font->height * bytes_per_row];
+
+    /* 渲染好的字形放得进缓存项时逐行复制 */
+    if (fb->config.format != FRAMEBUFFER_FORMAT_MONO && bg_color != FRAMEBUFFER_TRANSPARENT &&
+        fb->glyph_count > 0 &&
+        (uint32_t)font->width * font->height * fb_pixel_size(fb) <= fb->config.glyph_slot_size) {
+        uint8_t size = fb_pixel_size(fb);
+        uint32_t glyph_stride = (uint32_t)font->width * size;
+        const uint8_t *cached = fb_glyph_lookup(fb, font, code, glyph, color, bg_color);
+
+        for (int32_t row = y0; row < y1; row++) {
+            memcpy(fb_row(fb, row) + x0 * size,
+                   &cached[(uint32_t)(row - y) * glyph_stride + (uint32_t)(x0 - x) * size],
+                   (size_t)(x1 - x0) * size);
+        }
+        fb_mark(fb, x0, y0, x1, y1);
+        return FRAMEBUFFER_OK;
+    }
+
+    fb_bitmap_clipped(fb, x0, y0, x1, y1, glyph, bytes_per_row, x0 - x, y0 - y, color, bg_color);
+    return FRAMEBUFFER_OK;
+}
+
+int framebuffer_draw_string(framebuffer_t *fb, int16_t x, int16_t y, const framebuffer_font_t *font,
+                            const char *str, uint32_t color, uint32_t bg_color)
+{
+    int32_t cursor_x = x;
+    int32_t cursor_y = y;
+
+    if (fb == NULL || !fb->initialized || font == NULL || str == NULL) {
+        return FRAMEBUFFER_INVALID_PARAM;
+    }
+
+    for (; *str != '\0'; str++) {
+        uint8_t code = (uint8_t)*str;
+
+        if (*str == '\n') {
+            cursor_x = x;
+            cursor_y += font->height + font->spacing;
+            continue;
+        }
+
+        /* 超出裁剪区域右边界后的字符不再绘制 */
+        if (cursor_x < fb->clip_x1 && cursor_y < fb->clip_y1) {
+            if (code >= font->first && code <= font->last) {
+                framebuffer_draw_char(fb, (int16_t)cursor_x, (int16_t)cursor_y, font, *str, color, bg_color);
+            } else if (bg_color != FRAMEBUFFER_TRANSPARENT) {
+                framebuffer_fill_rect(fb, (int16_t)cursor_x, (int16_t)cursor_y, font->width, font->height, bg_color);
+            }
+        }
+
+        cursor_x += font->width + font->spacing;
+    }
+
+    return FRAMEBUFFER_OK;
+}
+
+void framebuffer_invalidate(framebuffer_t *fb)
+{
+    if (fb == NULL || !fb->initialized) {
+        return;
+    }
+
+    fb_mark(fb, 0, 0, fb->config.width, fb->config.height);
+}
+
+int framebuffer_flush(framebuffer_t *fb)
+{
+    framebuffer_rect_t area;
+    int32_t x0, x1;
+    const uint8_t *data;
+
+    if (fb == NULL || !fb->initialized) {
+        return FRAMEBUFFER_INVALID_PARAM;
+    }
+
+    if (fb->config.flush == NULL) {
+        return FRAMEBUFFER_NOT_SUPPORTED;
+    }
+
+    if (fb->dirty_x1 <= fb->dirty_x0) {
+        return FRAMEBUFFER_OK;
+    }
+
+    x0 = fb->dirty_x0;
+    x1 = fb->dirty_x1;
+
+    /* 单色格式按字节对齐，使每行数据从整字节开始 */
+    if (fb->config.format == FRAMEBUFFER_FORMAT_MONO) {
+        x0 &= ~7;
+        x1 = (x1 + 7) & ~7;
+        if (x1 > fb->config.width) {
+            x1 = fb->config.width;
+        }
+        data = fb_row(fb, fb->dirty_y0) + x0 / 8;
+    } else {
+        data = fb_row(fb, fb->dirty_y0) + x0 * fb_pixel_size(fb);
+    }
+
+    area.x = (int16_t)x0;
+    area.y = fb->dirty_y0;
+    area.width = (uint16_t)(x1 - x0);
+    area.height = (uint16_t)(fb->dirty_y1 - fb->dirty_y0);
+
+    if (fb->config.flush(fb->config.flush_context, &area, data, fb->stride) != 0) {
+        return FRAMEBUFFER_FLUSH_ERROR;
+    }
+
+    fb->stats.flushes++;
+    fb->stats.flushed_pixels += (uint32_t)area.width * area.height;
+    fb->dirty_x0 = 0;
+    fb->dirty_x1 = 0;
+
+    return FRAMEBUFFER_OK;
+}
+
+int framebuffer_get_stats(const framebuffer_t *fb, framebuffer_stats_t *stats)
+{
+    if (fb == NULL || stats == NULL) {
+        return FRAMEBUFFER_INVALID_PARAM;
+    }
+
+    *stats = fb->stats;
+    return FRAMEBUFFER_OK;
+}
@@ -0,0 +1,421 @@
+/**
+ * @file common_tm1681.c
+ * @brief TM1681帧缓冲与刷新实现（平台无关）
+ *
+ * 每个选通帧先复制到暂存区再交给传输层，暂存区按顺序分配，用满时等待传输层
+ * 完成后从头复用。异步传输层因此可以在后台发送，而显示缓冲区随时可以被修改。
+ * 影子副本在帧排队时即更新，发送失败的字节保留脏标记，下次刷新重新发送。
+ * 等待传输完成失败时，自上次等待成功后排队的字节可能没有写入控制器，这些字节
+ * 重新标记为脏并记入重发位图，下次刷新不论影子副本是否一致都重新发送。
+ */
+
+#include "base/tm1681_api.h"
+#include <string.h>
+
+/* 暂存区用满时等待传输完成的超时时间(毫秒) */
+#define TM1681_WAIT_TIMEOUT_MS      100
+
+/* 清除所有脏标记 */
+static void tm1681_clear_dirty(tm1681_frame_t *frame)
+{
+    memset(frame->dirty_map, 0, sizeof(frame->dirty_map));
+    memset(frame->resend_map, 0, sizeof(frame->resend_map));
+    frame->dirty_first = frame->size;
+    frame->dirty_last = 0;
+}
+
+/* 清除排队记录，已排队的帧全部完成 */
+static void tm1681_clear_queued(tm1681_frame_t *frame)
+{
+    memset(frame->queued_map, 0, sizeof(frame->queued_map));
+    frame->queued_first = frame->size;
+    frame->queued_last = 0;
+}
+
+/* 标记[first, last]范围内的字节为脏 */
+static void tm1681_mark_dirty(tm1681_frame_t *frame, uint16_t first, uint16_t last)
+{
+    for (uint16_t i = first; i <= last; i++) {
+        frame->dirty_map[i / 32] |= 1UL << (i % 32);
+    }
+
+    if (first < frame->dirty_first) {
+        frame->dirty_first = first;
+    }
+    if (last > frame->dirty_last) {
+        frame->dirty_last = last;
+    }
+}
+
+/* 标记矩形区域覆盖的列为脏，区域已限制在屏幕范围内 */
+static void tm1681_mark_rect(tm1681_frame_t *frame, uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+    if (width == 0 || height == 0) {
+        return;
+    }
+
+    for (uint16_t page = y / 8; page <= (y + height - 1) / 8; page++) {
+        uint16_t base = page * frame->width;
+        tm1681_mark_dirty(frame, base + x, base + x + width - 1);
+    }
+}
+
+/* 判断字节是否需要写入控制器 */
+static bool tm1681_byte_changed(const tm1681_frame_t *frame, uint16_t index)
+{
+    uint32_t mask = 1UL << (index % 32);
+
+    if ((frame->dirty_map[index / 32] & mask) == 0) {
+        return false;
+    }
+
+    return frame->buffer[index] != frame->shadow[index] || (frame->resend_map[index / 32] & mask) != 0;
+}
+
+/* 传输失败后把已排队的字节重新标记为脏，并要求下次刷新重新发送 */
+static void tm1681_requeue(tm1681_frame_t *frame)
+{
+    if (frame->queued_first > frame->queued_last) {
+        return;
+    }
+
+    for (uint16_t i = 0; i < TM1681_RAM_SIZE / 32; i++) {
+        frame->dirty_map[i] |= frame->queued_map[i];
+        frame->resend_map[i] |= frame->queued_map[i];
+    }
+
+    if (frame->queued_first < frame->dirty_first) {
+        frame->dirty_first = frame->queued_first;
+    }
+    if (frame->queued_last > frame->dirty_last) {
+        frame->dirty_last = frame->queued_last;
+    }
+
+    tm1681_clear_queued(frame);
+}
+
+/* 写入缓冲区中的像素，不检查坐标也不标记脏 */
+static void tm1681_put_pixel(tm1681_frame_t *frame, uint16_t x, uint16_t y, bool on)
+{
+    uint16_t index = x + (y / 8) * frame->width;
+    uint8_t mask = (uint8_t)(1 << (y % 8));
+
+    if (on) {
+        frame->buffer[index] |= mask;
+    } else {
+        frame->buffer[index] &= (uint8_t)~mask;
+    }
+}
+
+/* 等待传输层完成并复用暂存区，失败时暂存区仍被占用 */
+static int tm1681_wait(tm1681_frame_t *frame, uint32_t timeout_ms)
+{
+    if (frame->transport.wait != NULL && frame->staging_used > 0) {
+        int result = frame->transport.wait(frame->transport.context, timeout_ms);
+
+        if (result != 0) {
+            tm1681_requeue(frame);
+            return (result == TM1681_IO_ERROR) ? TM1681_IO_ERROR : TM1681_TIMEOUT;
+        }
+    }
+
+    frame->staging_used = 0;
+    tm1681_clear_queued(frame);
+    return TM1681_OK;
+}
+
+/**
+ * @brief 在暂存区中分配一个选通帧
+ *
+ * @param data 帧缓冲输出
+ * @return int 0表示成功，等待传输失败时返回等待的错误码
+ */
+static int tm1681_stage(tm1681_frame_t *frame, uint16_t length, uint8_t **data)
+{
+    if (frame->staging_used + length > TM1681_STAGING_SIZE) {
+        int result;
+
+        if (frame->transport.wait != NULL) {
+            frame->stats.waits++;
+        }
+        result = tm1681_wait(frame, TM1681_WAIT_TIMEOUT_MS);
+        if (result != TM1681_OK) {
+            return result;
+        }
+    }
+
+    *data = &frame->staging[frame->staging_used];
+    frame->staging_used += length;
+    return TM1681_OK;
+}
+
+/* 发送暂存区中的选通帧 */
+static int tm1681_send(tm1681_frame_t *frame, const uint8_t *data, uint16_t length)
+{
+    if (frame->transport.write(frame->transport.context, data, length) != 0) {
+        return TM1681_IO_ERROR;
+    }
+
+    frame->stats.frames++;
+    frame->stats.bytes += length;
+    return TM1681_OK;
+}
+
+/* 以地址自动增加方式把[start, start + length)写入控制器 */
+static int tm1681_send_burst(tm1681_frame_t *frame, uint16_t start, const uint8_t *source, uint16_t length)
+{
+    uint8_t *data;
+    int result;
+
+    result = tm1681_stage(frame, length + 1, &data);
+    if (result != TM1681_OK) {
+        return result;
+    }
+
+    data[0] = (uint8_t)(TM1681_CMD_ADDRESS_MODE | start);
+    memcpy(&data[1], source, length);
+
+    if (tm1681_send(frame, data, length + 1) != TM1681_OK) {
+        return TM1681_IO_ERROR;
+    }
+
+    memcpy(&frame->shadow[start], source, length);
+    for (uint16_t i = start; i < start + length; i++) {
+        frame->queued_map[i / 32] |= 1UL << (i % 32);
+    }
+    if (start < frame->queued_first) {
+        frame->queued_first = start;
+    }
+    if (start + length - 1 > frame->queued_last) {
+        frame->queued_last = start + length - 1;
+    }
+    frame->stats.data_bytes += length;
+    return TM1681_OK;
+}
+
+int tm1681_frame_init(tm1681_frame_t *frame, uint16_t width, uint16_t height,
+                      const tm1681_transport_t *transport)
+{
+    uint32_t size;
+    int result;
+
+    if (frame == NULL || transport == NULL || transport->write == NULL || width == 0 || height == 0) {
+        return TM1681_INVALID_PARAM;
+    }
+
+    size = (uint32_t)width * ((height + 7) / 8);
+    if (size > TM1681_RAM_SIZE) {
+        return TM1681_INVALID_PARAM;
+    }
+
+    memset(frame, 0, sizeof(*frame));
+    frame->transport = *transport;
+    frame->width = width;
+    frame->height = height;
+    frame->size = (uint16_t)size;
+    tm1681_clear_dirty(frame);
+    tm1681_clear_queued(frame);
+    frame->initialized = true;
+
+    /* 所有显示数据都以地址自动增加方式写入，数据模式只需设置一次 */
+    result = tm1681_frame_command(frame, TM1681_CMD_DATA_MODE | TM1681_ADDR_AUTO_INC);
+    if (result == TM1681_OK) {
+        result = tm1681_send_burst(frame, 0, frame->buffer, frame->size);
+    }
+
+    if (result != TM1681_OK) {
+        frame->initialized = false;
+    }
+
+    return result;
+}
+
+int tm1681_frame_deinit(tm1681_frame_t *frame)
+{
+    int result;
+
+    if (frame == NULL || !frame->initialized) {
+        return TM1681_INVALID_PARAM;
+    }
+
+    result = tm1681_wait(frame, TM1681_WAIT_TIMEOUT_MS);
+    frame->initialized = false;
+
+    return result;
+}
+
+int tm1681_frame_command(tm1681_frame_t *frame, uint8_t command)
+{
+    uint8_t *data;
+    int result;
+
+    if (frame == NULL || !frame->initialized) {
+        return TM1681_INVALID_PARAM;
+    }
+
+    result = tm1681_stage(frame, 1, &data);
+    if (result != TM1681_OK) {
+        return result;
+    }
+
+    data[0] = command;
+    return tm1681_send(frame, data, 1);
+}
+
+void tm1681_frame_clear(tm1681_frame_t *frame)
+{
+    if (frame == NULL || !frame->initialized) {
+        return;
+    }
+
+    memset(frame->buffer, 0, frame->size);
+    tm1681_mark_dirty(frame, 0, frame->size - 1);
+}
+
+int tm1681_frame_set_pixel(tm1681_frame_t *frame, uint16_t x, uint16_t y, bool on)
+{
+    uint16_t index;
+    uint8_t old_data;
+
+    if (frame == NULL || !frame->initialized || x >= frame->width || y >= frame->height) {
+        return TM1681_INVALID_PARAM;
+    }
+
+    index = x + (y / 8) * frame->width;
+    old_data = frame->buffer[index];
+
+    tm1681_put_pixel(frame, x, y, on);
+    if (frame->buffer[index] != old_data) {
+        tm1681_mark_dirty(frame, index, index);
+    }
+
+    return TM1681_OK;
+}
+
+int tm1681_frame_get_pixel(const tm1681_frame_t *frame, uint16_t x, uint16_t y, bool *on)
+{
+    if (frame == NULL || !frame->initialized || on == NULL || x >= frame->width || y >= frame->height) {
+        return TM1681_INVALID_PARAM;
+    }
+
+    *on = (frame->buffer[x + (y / 8) * frame->width] & (1 << (y % 8))) != 0;
+    return TM1681_OK;
+}
+
+int tm1681_frame_set_area(tm1681_frame_t *frame, uint16_t x, uint16_t y,
+                          uint16_t width, uint16_t height, const uint8_t *data)
+{
+    if (frame == NULL || !frame->initialized || data == NULL) {
+        return TM1681_INVALID_PARAM;
+    }
+
+    if (x >= frame->width || y >= frame->height ||
+        x + width > frame->width || y + height > frame->height) {
+        return TM1681_INVALID_PARAM;
+    }
+
+    for (uint16_t j = 0; j < height; j++) {
+        for (uint16_t i = 0; i < width; i++) {
+            uint32_t src_bit = (uint32_t)j * width + i;
+            tm1681_put_pixel(frame, x + i, y + j, (data[src_bit / 8] & (1 << (src_bit % 8))) != 0);
+        }
+    }
+    tm1681_mark_rect(frame, x, y, width, height);
+
+    return TM1681_OK;
+}
+
+int tm1681_frame_draw_bitmap(tm1681_frame_t *frame, uint16_t x, uint16_t y,
+                             uint16_t width, uint16_t height, const uint8_t *bitmap)
+{
+    uint16_t bytes_per_row = (width + 7) / 8;
+    uint16_t draw_width;
+    uint16_t draw_height;
+
+    if (frame == NULL || !frame->initialized || bitmap == NULL) {
+        return TM1681_INVALID_PARAM;
+    }
+
+    if (x >= frame->width || y >= frame->height) {
+        return TM1681_INVALID_PARAM;
+    }
+
+    /* 裁剪到屏幕范围 */
+    draw_width = (x + width > frame->width) ? frame->width - x : width;
+    draw_height = (y + height > frame->height) ? frame->height - y : height;
+
+    for (uint16_t row = 0; row < draw_height; row++) {
+        const uint8_t *src = &bitmap[row * bytes_per_row];
+        for (uint16_t col = 0; col < draw_width; col++) {
+            tm1681_put_pixel(frame, x + col, y + row, (src[col / 8] & (1 << (col % 8))) != 0);
+        }
+    }
+    tm1681_mark_rect(frame, x, y, draw_width, draw_height);
+
+    return TM1681_OK;
+}
+
+int tm1681_frame_refresh(tm1681_frame_t *frame)
+{
+    uint16_t index;
+
+    if (frame == NULL || !frame->initialized) {
+        return TM1681_INVALID_PARAM;
+    }
+
+    frame->stats.refreshes++;
+
+    index = frame->dirty_first;
+    while (index <= frame->dirty_last) {
+        uint16_t start;
+        uint16_t end;
+        uint16_t gap = 0;
+        int result;
+
+        if (!tm1681_byte_changed(frame, index)) {
+            index++;
+            continue;
+        }
+
+        /* 向后扩展突发范围，直到连续的未变字节超过合并间隔 */
+        start = index;
+        end = index;
+        for (index = start + 1; index <= frame->dirty_last && gap <= frame->transport.merge_gap; index++) {
+            if (tm1681_byte_changed(frame, index)) {
+                end = index;
+                gap = 0;
+            } else {
+                gap++;
+            }
+        }
+
+        result = tm1681_send_burst(frame, start, &frame->buffer[start], end - start + 1);
+        if (result != TM1681_OK) {
+            /* 已发送的字节与影子副本一致，其余字节保留脏标记 */
+            return result;
+        }
+        index = end + 1;
+    }
+
+    tm1681_clear_dirty(frame);
+    return TM1681_OK;
+}
+
+int tm1681_frame_sync(tm1681_frame_t *frame, uint32_t timeout_ms)
+{
+    if (frame == NULL || !frame->initialized) {
+        return TM1681_INVALID_PARAM;
+    }
+
+    return tm1681_wait(frame, timeout_ms);
+}
+
+int tm1681_frame_get_stats(const tm1681_frame_t *frame, tm1681_stats_t *stats)
+{
+    if (frame == NULL || stats == NULL) {
+        return TM1681_INVALID_PARAM;
+    }
+
+    *stats = frame->stats;
+    return TM1681_OK;
+}
@@ -0,0 +1,191 @@
+/**
+ * @file host_tm1681.c
+ * @brief 主机平台TM1681模拟传输层实现
+ *
+ * 该文件模拟TM1681控制器的串行接口，供主机构建和单元测试使用。同步模式下
+ * 每个选通帧在发送时立即执行；异步模式下只记录帧的地址和长度，与DMA传输
+ * 一样在完成前读取调用者的缓冲区，直到wait时才执行。
+ */
+
+#include "base/host_tm1681_api.h"
+#include <string.h>
+
+/* 异步模式下可同时排队的帧数 */
+#define HOST_TM1681_QUEUE_DEPTH     TM1681_STAGING_SIZE
+
+/* 排队的选通帧 */
+typedef struct {
+    const uint8_t *data;                /* 帧数据 */
+    uint16_t length;                    /* 帧长度 */
+} host_tm1681_frame_t;
+
+static uint8_t g_ram[TM1681_RAM_SIZE];
+static host_tm1681_frame_t g_queue[HOST_TM1681_QUEUE_DEPTH];
+static uint32_t g_queued;
+static bool g_async;
+static uint32_t g_error_countdown;
+static int g_wait_error;
+static host_tm1681_stats_t g_stats;
+
+/* 执行一个选通帧 */
+static void host_tm1681_execute(const uint8_t *data, uint16_t length)
+{
+    uint8_t command = data[0];
+
+    g_stats.frames++;
+    g_stats.bytes += length;
+
+    if ((command & 0xC0) == TM1681_CMD_ADDRESS_MODE) {
+        uint8_t address = command & (TM1681_RAM_SIZE - 1);
+
+        for (uint16_t i = 1; i < length; i++) {
+            g_ram[address] = data[i];
+            g_stats.data_bytes++;
+            if ((g_stats.data_mode & TM1681_ADDR_FIXED) == 0) {
+                address = (address + 1) & (TM1681_RAM_SIZE - 1);
+            }
+        }
+        return;
+    }
+
+    if ((command & 0xC0) == TM1681_CMD_DATA_MODE) {
+        g_stats.data_mode = command;
+    }
+    g_stats.last_command = command;
+    g_stats.commands++;
+
+    if (length > 1) {
+        g_stats.protocol_errors++;
+    }
+}
+
+static int host_tm1681_write(void *context, const uint8_t *data, uint16_t length)
+{
+    (void)context;
+
+    if (data == NULL || length == 0) {
+        return TM1681_IO_ERROR;
+    }
+
+    if (g_error_countdown > 0 && --g_error_countdown == 0) {
+        return TM1681_IO_ERROR;
+    }
+
+    if (!g_async) {
+        host_tm1681_execute(data, length);
+        return TM1681_OK;
+    }
+
+    if (g_queued >= HOST_TM1681_QUEUE_DEPTH) {
+        return TM1681_IO_ERROR;
+    }
+
+    g_queue[g_queued].data = data;
+    g_queue[g_queued].length = length;
+    g_queued++;
+    if (g_queued > g_stats.max_queued) {
+        g_stats.max_queued = g_queued;
+    }
+
+    return TM1681_OK;
+}
+
+static int host_tm1681_wait(void *context, uint32_t timeout_ms)
+{
+    int error = g_wait_error;
+
+    (void)context;
+    (void)timeout_ms;
+
+    if (error != TM1681_OK) {
+        /* 超时时帧仍在队列中，之后的wait照常执行；其他错误丢弃排队的帧 */
+        g_wait_error = TM1681_OK;
+        if (error != TM1681_TIMEOUT) {
+            g_queued = 0;
+        }
+        return error;
+    }
+
+    for (uint32_t i = 0; i < g_queued; i++) {
+        host_tm1681_execute(g_queue[i].data, g_queue[i].length);
+    }
+    g_queued = 0;
+
+    return TM1681_OK;
+}
+
+/**
+ * @brief 获取模拟传输层
+ */
+void host_tm1681_get_transport(tm1681_transport_t *transport, uint16_t merge_gap)
+{
+    if (transport == NULL) {
+        return;
+    }
+
+    transport->write = host_tm1681_write;
+    transport->wait = host_tm1681_wait;
+    transport->context = NULL;
+    transport->merge_gap = merge_gap;
+}
+
+/**
+ * @brief 复位模拟器
+ */
+void host_tm1681_reset(void)
+{
+    memset(g_ram, 0xFF, sizeof(g_ram));
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_queued = 0;
+    g_async = false;
+    g_error_countdown = 0;
+    g_wait_error = TM1681_OK;
+}
+
+/**
+ * @brief 设置异步模式
+ */
+void host_tm1681_set_async(bool async)
+{
+    if (!async) {
+        host_tm1681_wait(NULL, 0);
+    }
+    g_async = async;
+}
+
+/**
+ * @brief 获取控制器显示RAM
+ */
+const uint8_t *host_tm1681_get_ram(void)
+{
+    return g_ram;
+}
+
+/**
+ * @brief 获取统计信息
+ */
+int host_tm1681_get_stats(host_tm1681_stats_t *stats)
+{
+    if (stats == NULL) {
+        return TM1681_INVALID_PARAM;
+    }
+
+    *stats = g_stats;
+    return TM1681_OK;
+}
+
+/**
+ * @brief 注入传输错误
+ */
+void host_tm1681_inject_error(uint32_t countdown)
+{
+    g_error_countdown = countdown;
+}
+
+/**
+ * @brief 注入等待错误
+ */
+void host_tm1681_inject_wait_error(int error)
+{
+    g_wait_error = error;
+}
@@ -7,6 +7,8 @@
 
 #include "base/display_api.h"
 #include "base/gpio_api.h"
+#include "base/spi_api.h"
+#include "base/tm1681_api.h"
 #include "base/timer_api.h"
 #include "common/error_api.h"
 #include <string.h>
@@ -30,649 +32,265 @@
 #define TM1681_CMD_COM_16_PMOS     0x2C /* 16COM驱动，PMOS模式 */
 #define TM1681_CMD_PWM_CONTROL     0xA0 /* PWM亮度控制，后?-F亮度级别 */
 
-/* 数据命令 */
-#define TM1681_CMD_DATA_MODE       0x40 /* 数据模式命令 */
-#define TM1681_CMD_ADDRESS_MODE    0xC0 /* 地址模式命令 */
-
 /* 数据模式设置 */
 #define TM1681_DATA_WRITE          0x00 /* 写数据模?*/
 #define TM1681_DATA_READ           0x02 /* 读数据模?*/
-#define TM1681_ADDR_AUTO_INC       0x00 /* 地址自动增加 */
-#define TM1681_ADDR_FIXED          0x04 /* 固定地址 */
 
 /* LED点阵配置 */
 #define TM1681_MAX_GRIDS           8    /* 最大网格数 */
 #define TM1681_GRID_POINTS         8    /* 每个网格的点?*/
 #define TM1681_DELAY_US            10   /* 基本延时(us) */
 #define TM1681_START_ADDR          0xC0 /* 起始地址命令 */
+#define TM1681_BURST_MERGE_GAP     2    /* GPIO传输时脏字节间隔不超过该值合并为一次突发写入 */
+#define TM1681_SPI_QUEUE_DEPTH     4    /* 可同时提交的SPI事务数 */
+#define TM1681_SPI_TIMEOUT_MS      100  /* 等待SPI事务完成的超时时间(ms) */
+
+/* SPI传输依赖spi_transaction_submit，目前只有STM32的SPI驱动实现 */
+#if defined(CONFIG_TM1681_SPI_ENABLED) && CONFIG_TM1681_SPI_ENABLED
+#define TM1681_SPI_TRANSPORT       1
+#else
+#define TM1681_SPI_TRANSPORT       0
+#endif
 
 /* 亮度级别 (0-15) */
 #define TM1681_MIN_BRIGHTNESS      0
 #define TM1681_MAX_BRIGHTNESS      15
 
-/* TM1681设备结构?*/
+/* TM1681设备结构体 */
 typedef struct {
     display_config_t config;        /* 显示配置 */
     tm1681_config_t tm1681_config;  /* TM1681配置 */
-    gpio_handle_t data_pin;         /* 数据引脚 */
-    gpio_handle_t clock_pin;        /* 时钟引脚 */
-    gpio_handle_t stb_pin;          /* STB引脚 */
-    uint8_t intensity;              /* 亮度级别(0-15) */
-    uint8_t *display_buffer;        /* 显示缓冲?*/
-    bool initialized;               /* 初始化标?*/
-    gpio_handle_t data_pin;         /* 数据引脚句柄 */
-    gpio_handle_t clock_pin;        /* 时钟引脚句柄 */
+    gpio_handle_t data_pin;         /* 数据引脚句柄，GPIO传输时使用 */
+    gpio_handle_t clock_pin;        /* 时钟引脚句柄，GPIO传输时使用 */
     gpio_handle_t stb_pin;          /* STB引脚句柄 */
-    uint8_t *display_buffer;        /* 显示缓冲?*/
-    uint16_t buffer_size;           /* 缓冲区大?*/
-    bool initialized;               /* 初始化标?*/
+    tm1681_frame_t frame;           /* 帧缓冲 */
+#if TM1681_SPI_TRANSPORT
+    spi_handle_t spi;               /* SPI句柄，SPI传输时使用 */
+    spi_segment_t spi_segments[TM1681_SPI_QUEUE_DEPTH];         /* SPI事务分段 */
+    spi_transaction_t spi_transactions[TM1681_SPI_QUEUE_DEPTH]; /* 已提交的SPI事务 */
+    uint8_t spi_pending;            /* 已提交未确认完成的SPI事务数 */
+    int spi_error;                  /* 发送时等待队列失败的错误码，由下一次等待报告 */
+#endif
+    bool initialized;               /* 初始化标志 */
 } tm1681_device_t;
 
-/* 静态设备实?*/
+/* 全局设备实例 */
 static tm1681_device_t g_tm1681_device;
 
-/**
- * @brief 微秒级延?
- * 
- * @param us 延时时间(微秒)
- */
+/* 延时函数 */
 static void tm1681_delay_us(uint32_t us)
 {
-    /* 使用循环延时，实际项目中应使用定时器或系统延时函?*/
-    volatile uint32_t i;
-    for (i = 0; i < us * 10; i++) {
-        __asm("NOP");
+    for (uint32_t i = 0; i < us * 10; i++) {
+        __NOP();
     }
 }
 
-/**
- * @brief 开始TM1681通信
- */
-static void tm1681_start(tm1681_device_t *dev)
+/* 开始传?*/
+static void tm1681_start(tm1681_device_t *device)
 {
-    /* STB高电?*/
-    gpio_write(dev->stb_pin, GPIO_LEVEL_HIGH);
+    gpio_write(device->stb_pin, GPIO_LEVEL_HIGH);
     tm1681_delay_us(TM1681_DELAY_US);
-    /* 时钟高电?*/
-    gpio_write(dev->clock_pin, GPIO_LEVEL_HIGH);
+    gpio_write(device->clock_pin, GPIO_LEVEL_HIGH);
     tm1681_delay_us(TM1681_DELAY_US);
-    /* STB拉低开始通信 */
-    gpio_write(dev->stb_pin, GPIO_LEVEL_LOW);
+    gpio_write(device->stb_pin, GPIO_LEVEL_LOW);
     tm1681_delay_us(TM1681_DELAY_US);
 }
 
-/**
- * @brief 结束TM1681通信
- */
-static void tm1681_stop(tm1681_device_t *dev)
+/* 结束传输 */
+static void tm1681_stop(tm1681_device_t *device)
 {
-    /* 时钟低电?*/
-    gpio_write(dev->clock_pin, GPIO_LEVEL_LOW);
+    gpio_write(device->clock_pin, GPIO_LEVEL_LOW);
     tm1681_delay_us(TM1681_DELAY_US);
-    /* STB拉高结束通信 */
-    gpio_write(dev->stb_pin, GPIO_LEVEL_HIGH);
+    gpio_write(device->stb_pin, GPIO_LEVEL_LOW);
+    tm1681_delay_us(TM1681_DELAY_US);
+    gpio_write(device->clock_pin, GPIO_LEVEL_HIGH);
+    tm1681_delay_us(TM1681_DELAY_US);
+    gpio_write(device->stb_pin, GPIO_LEVEL_HIGH);
     tm1681_delay_us(TM1681_DELAY_US);
 }
 
-/**
- * @brief 向TM1681发送一个字?
- * 
- * @param dev 设备实例
- * @param data 要发送的数据
- */
-static void tm1681_write_byte(tm1681_device_t *dev, uint8_t data)
+/* 写一个字?*/
+static void tm1681_write_byte(tm1681_device_t *device, uint8_t data)
 {
-    uint8_t i;
-    
-    for (i = 0; i < 8; i++) {
-        /* 时钟低电?*/
-        gpio_write(dev->clock_pin, GPIO_LEVEL_LOW);
+    for (uint8_t i = 0; i < 8; i++) {
+        gpio_write(device->clock_pin, GPIO_LEVEL_LOW);
         tm1681_delay_us(TM1681_DELAY_US);
         
-        /* 设置数据?*/
-        if (data & 0x01) {
-            gpio_write(dev->data_pin, GPIO_LEVEL_HIGH);
-        } else {
-            gpio_write(dev->data_pin, GPIO_LEVEL_LOW);
-        }
-        
-        /* 数据右移 */
-        data >>= 1;
+        /* 先写LSB (最低位) */
+        gpio_write(device->data_pin, (data & 0x01) ? GPIO_LEVEL_HIGH : GPIO_LEVEL_LOW);
         tm1681_delay_us(TM1681_DELAY_US);
         
-        /* 时钟高电平，数据锁存 */
-        gpio_write(dev->clock_pin, GPIO_LEVEL_HIGH);
+        gpio_write(device->clock_pin, GPIO_LEVEL_HIGH);
         tm1681_delay_us(TM1681_DELAY_US);
+        
+        data >>= 1;
     }
 }
 
-/**
- * @brief 发送命令到TM1681
- * 
- * @param dev 设备实例
- * @param cmd 命令
- */
-static void tm1681_send_command(tm1681_device_t *dev, uint8_t cmd)
+/* GPIO传输层：发送一个选通帧 */
+static int tm1681_gpio_write(void *context, const uint8_t *data, uint16_t length)
 {
-    tm1681_start(dev);
-    tm1681_write_byte(dev, cmd);
-    tm1681_stop(dev);
-}
+    tm1681_device_t *device = (tm1681_device_t *)context;
 
-/**
- * @brief 设置显示亮度
- * 
- * @param dev 设备实例
- * @param intensity 亮度级别(0-15)
- */
-static void tm1681_set_brightness(tm1681_device_t *dev, uint8_t intensity)
-{
-    /* 限制亮度范围 */
-    if (intensity > TM1681_MAX_BRIGHTNESS) {
-        intensity = TM1681_MAX_BRIGHTNESS;
+    tm1681_start(device);
+    for (uint16_t i = 0; i < length; i++) {
+        tm1681_write_byte(device, data[i]);
     }
-    
-    /* 发送PWM控制命令 */
-    tm1681_send_command(dev, TM1681_CMD_PWM_CONTROL | intensity);
-    
-    /* 保存亮度设置 */
-    dev->intensity = intensity;
-}
+    tm1681_stop(device);
 
-/**
- * @brief 初始化TM1681硬件
- * 
- * @param dev 设备实例
- * @return int 0表示成功，非0表示失败
- */
-static int tm1681_hardware_init(tm1681_device_t *dev)
-{
-    gpio_config_t gpio_config;
-    
-    /* 配置数据引脚 */
-    memset(&gpio_config, 0, sizeof(gpio_config));
-    gpio_config.mode = GPIO_MODE_OUTPUT_PP;
-    gpio_config.pull = GPIO_PULL_NONE;
-    gpio_config.speed = GPIO_SPEED_HIGH;
-    
-    /* 初始化数据引?*/
-    if (gpio_init(dev->tm1681_config.data_pin, &gpio_config, &dev->data_pin) != 0) {
-        return ERROR_DRIVER_INIT_FAILED;
-    }
-    
-    /* 初始化时钟引?*/
-    if (gpio_init(dev->tm1681_config.clock_pin, &gpio_config, &dev->clock_pin) != 0) {
-        gpio_deinit(dev->data_pin);
-        return ERROR_DRIVER_INIT_FAILED;
-    }
-    
-    /* 初始化STB引脚 */
-    if (gpio_init(dev->tm1681_config.stb_pin, &gpio_config, &dev->stb_pin) != 0) {
-        gpio_deinit(dev->data_pin);
-        gpio_deinit(dev->clock_pin);
-        return ERROR_DRIVER_INIT_FAILED;
-    }
-    
-    /* 设置初始电平 */
-    gpio_write(dev->data_pin, GPIO_LEVEL_HIGH);
-    gpio_write(dev->clock_pin, GPIO_LEVEL_HIGH);
-    gpio_write(dev->stb_pin, GPIO_LEVEL_HIGH);
-    
-    /* 初始化TM1681 */
-    tm1681_send_command(dev, TM1681_CMD_SYS_DIS);       /* 关闭系统振荡?*/
-    tm1681_send_command(dev, TM1681_CMD_COM_8_NMOS);    /* 设置?COM, NMOS模式 */
-    tm1681_send_command(dev, TM1681_CMD_SYS_EN);        /* 开启系统振荡器 */
-    tm1681_send_command(dev, TM1681_CMD_LED_ON);        /* 开启LED显示 */
-    tm1681_send_command(dev, TM1681_CMD_BLINK_OFF);     /* 关闭闪烁 */
-    
-    /* 设置亮度 */
-    uint8_t intensity = (dev->tm1681_config.intensity * TM1681_MAX_BRIGHTNESS) / 7;
-    tm1681_set_brightness(dev, intensity);
-    
-    return DRIVER_OK;
+    return TM1681_OK;
 }
 
-/**
- * @brief 设置TM1681显示数据
- * 
- * @param dev 设备实例
- * @param address 起始地址
- * @param data 数据缓冲?
- * @param len 数据长度
- */
-/**
- * @brief 初始化显示设?
- * 
- * @param config 显示配置参数
- * @param handle 显示设备句柄指针
- * @return int 0表示成功，非0表示失败
- */
-int display_init(const display_config_t *config, display_handle_t *handle)
+#if TM1681_SPI_TRANSPORT
+/* SPI传输层：事务开始和结束时控制STB */
+static void tm1681_spi_stb(bool active, void *cs_arg)
 {
-    tm1681_device_t *dev = &g_tm1681_device;
-    int ret;
-    
-    /* 参数检?*/
-    if (config == NULL || handle == NULL) {
-        return ERROR_INVALID_PARAM;
-    }
-    
-    /* 检查显示类?*/
-    if (config->type != DISPLAY_TYPE_LED_MATRIX) {
-        return ERROR_NOT_SUPPORTED;
-    }
-    
-    /* 检查驱动配?*/
-    if (config->driver_config == NULL) {
-        return ERROR_INVALID_PARAM;
-    }
-    
-    /* 复制配置 */
-    memcpy(&dev->config, config, sizeof(display_config_t));
-    memcpy(&dev->tm1681_config, config->driver_config, sizeof(tm1681_config_t));
-    
-    /* 分配显示缓冲?*/
-    uint16_t buffer_size = dev->config.width * dev->config.height / 8;
-    if (buffer_size == 0) {
-        buffer_size = 1;
-    }
-    
-    dev->display_buffer = (uint8_t *)malloc(buffer_size);
-    if (dev->display_buffer == NULL) {
-        return ERROR_MEMORY_ALLOC_FAILED;
-    }
-    
-    /* 清空显示缓冲?*/
-    memset(dev->display_buffer, 0, buffer_size);
-    
-    /* 初始化TM1681硬件 */
-    ret = tm1681_hardware_init(dev);
-    if (ret != DRIVER_OK) {
-        free(dev->display_buffer);
-        dev->display_buffer = NULL;
-        return ret;
-    }
-    
-    /* 设置初始化标?*/
-    dev->initialized = true;
-    
-    /* 返回设备句柄 */
-    *handle = (display_handle_t)dev;
-    
-    return DRIVER_OK;
-}
+    tm1681_device_t *device = (tm1681_device_t *)cs_arg;
 
-/**
- * @brief 去初始化显示设备
- * 
- * @param handle 显示设备句柄
- * @return int 0表示成功，非0表示失败
- */
-int display_deinit(display_handle_t handle)
-{
-    tm1681_device_t *dev = (tm1681_device_t *)handle;
-    
-    /* 参数检?*/
-    if (dev == NULL || !dev->initialized) {
-        return ERROR_INVALID_PARAM;
-    }
-    
-    /* 关闭显示 */
-    tm1681_send_command(dev, TM1681_CMD_LED_OFF);
-    tm1681_send_command(dev, TM1681_CMD_SYS_DIS);
-    
-    /* 释放GPIO资源 */
-    gpio_deinit(dev->data_pin);
-    gpio_deinit(dev->clock_pin);
-    gpio_deinit(dev->stb_pin);
-    
-    /* 释放显示缓冲?*/
-    if (dev->display_buffer != NULL) {
-        free(dev->display_buffer);
-        dev->display_buffer = NULL;
-    }
-    
-    /* 清除初始化标?*/
-    dev->initialized = false;
-    
-    return DRIVER_OK;
+    gpio_write(device->stb_pin, active ? GPIO_LEVEL_LOW : GPIO_LEVEL_HIGH);
 }
 
-/**
- * @brief 清除显示内容
- * 
- * @param handle 显示设备句柄
- * @return int 0表示成功，非0表示失败
- */
-int display_clear(display_handle_t handle)
+/* SPI传输层：等待已提交的事务全部完成 */
+static int tm1681_spi_wait(void *context, uint32_t timeout_ms)
 {
-    tm1681_device_t *dev = (tm1681_device_t *)handle;
-    
-    /* 参数检?*/
-    if (dev == NULL || !dev->initialized) {
-        return ERROR_INVALID_PARAM;
-    }
-    
-    /* 清空显示缓冲?*/
-    uint16_t buffer_size = dev->config.width * dev->config.height / 8;
-    if (buffer_size == 0) {
-        buffer_size = 1;
-    }
-    memset(dev->display_buffer, 0, buffer_size);
-    
-    /* 清除TM1681显示数据 */
-    uint8_t clear_data[16] = {0};
-    for (uint8_t addr = 0; addr < 16; addr += 2) {
-        tm1681_set_display_data(dev, addr, clear_data, 2);
-    }
-    
-    return DRIVER_OK;
-}
+    tm1681_device_t *device = (tm1681_device_t *)context;
+    int result = device->spi_error;
 
-/**
- * @brief 刷新显示
- * 
- * @param handle 显示设备句柄
- * @return int 0表示成功，非0表示失败
- */
-int display_refresh(display_handle_t handle)
-{
-    tm1681_device_t *dev = (tm1681_device_t *)handle;
-    
-    /* 参数检?*/
-    if (dev == NULL || !dev->initialized) {
-        return ERROR_INVALID_PARAM;
-    }
-    
-    /* 计算每行所需字节?*/
-    uint8_t bytes_per_row = (dev->config.width + 7) / 8;
-    
-    /* 将显示缓冲区数据写入TM1681 */
-    for (uint8_t row = 0; row < dev->config.height; row++) {
-        tm1681_set_display_data(dev, row * 2, &dev->display_buffer[row * bytes_per_row], bytes_per_row);
-    }
-    
-    return DRIVER_OK;
-}
+    /* 事务按提交顺序执行，逐个等待即可 */
+    for (uint8_t i = 0; i < device->spi_pending; i++) {
+        spi_transaction_t *transaction = &device->spi_transactions[i];
+        uint32_t waited_us = 0;
 
-/**
- * @brief 设置像素?
- * 
- * @param handle 显示设备句柄
- * @param x X坐标
- * @param y Y坐标
- * @param value 像素?
- * @return int 0表示成功，非0表示失败
- */
-int display_set_pixel(display_handle_t handle, uint16_t x, uint16_t y, uint32_t value)
-{
-    tm1681_device_t *dev = (tm1681_device_t *)handle;
-    
-    /* 参数检?*/
-    if (dev == NULL || !dev->initialized) {
-        return ERROR_INVALID_PARAM;
-    }
-    
-    /* 检查坐标是否超出范?*/
-    if (x >= dev->config.width || y >= dev->config.height) {
-        return ERROR_INVALID_PARAM;
-    }
-    
-    /* 计算像素所在字节和?*/
-    uint16_t byte_index = (y * ((dev->config.width + 7) / 8)) + (x / 8);
-    uint8_t bit_index = x % 8;
-    
-    /* 设置或清除像?*/
-    if (value) {
-        dev->display_buffer[byte_index] |= (1 << bit_index);
-    } else {
-        dev->display_buffer[byte_index] &= ~(1 << bit_index);
-    }
-    
-    return DRIVER_OK;
-}
+        while (transaction->state != SPI_TRANSACTION_DONE) {
+            if (waited_us >= timeout_ms * 1000) {
+                return TM1681_TIMEOUT;
+            }
+            tm1681_delay_us(TM1681_DELAY_US);
+            waited_us += TM1681_DELAY_US;
+        }
 
-/**
- * @brief 获取像素?
- * 
- * @param handle 显示设备句柄
- * @param x X坐标
- * @param y Y坐标
- * @param value 像素值指?
- * @return int 0表示成功，非0表示失败
- */
-int display_get_pixel(display_handle_t handle, uint16_t x, uint16_t y, uint32_t *value)
-{
-    tm1681_device_t *dev = (tm1681_device_t *)handle;
-    
-    /* 参数检?*/
-    if (dev == NULL || !dev->initialized || value == NULL) {
-        return ERROR_INVALID_PARAM;
-    }
-    
-    /* 检查坐标是否超出范?*/
-    if (x >= dev->config.width || y >= dev->config.height) {
-        return ERROR_INVALID_PARAM;
+        if (transaction->result != 0) {
+            result = TM1681_IO_ERROR;
+        }
     }
-    
-    /* 计算像素所在字节和?*/
-    uint16_t byte_index = (y * ((dev->config.width + 7) / 8)) + (x / 8);
-    uint8_t bit_index = x % 8;
-    
-    /* 获取像素?*/
-    *value = (dev->display_buffer[byte_index] & (1 << bit_index)) ? 1 : 0;
-    
-    return DRIVER_OK;
-}
 
-/**
- * @brief 设置亮度
- * 
- * @param handle 显示设备句柄
- * @param brightness 亮度?0-100)
- * @return int 0表示成功，非0表示失败
- */
-int display_set_brightness(display_handle_t handle, uint8_t brightness)
-{
-    tm1681_device_t *dev = (tm1681_device_t *)handle;
-    
-    /* 参数检?*/
-    if (dev == NULL || !dev->initialized) {
-        return ERROR_INVALID_PARAM;
-    }
-    
-    /* 限制亮度范围 */
-    if (brightness > 100) {
-        brightness = 100;
-    }
-    
-    /* 映射亮度值到TM1681亮度级别(0-15) */
-    uint8_t intensity = (brightness * TM1681_MAX_BRIGHTNESS) / 100;
-    
-    /* 设置亮度 */
-    tm1681_set_brightness(dev, intensity);
-    
-    return DRIVER_OK;
+    device->spi_pending = 0;
+    device->spi_error = TM1681_OK;
+    return result;
 }
 
-/**
- * @brief 绘制位图
- * 
- * @param handle 显示设备句柄
- * @param x 起始X坐标
- * @param y 起始Y坐标
- * @param width 位图宽度
- * @param height 位图高度
- * @param bitmap 位图数据
- * @return int 0表示成功，非0表示失败
- */
-int display_draw_bitmap(display_handle_t handle, uint16_t x, uint16_t y, 
-                        uint16_t width, uint16_t height, const uint8_t *bitmap)
+/* SPI传输层：把一个选通帧作为一个DMA事务提交 */
+static int tm1681_spi_write(void *context, const uint8_t *data, uint16_t length)
 {
-    tm1681_device_t *dev = (tm1681_device_t *)handle;
-    
-    /* 参数检?*/
-    if (dev == NULL || !dev->initialized || bitmap == NULL) {
-        return ERROR_INVALID_PARAM;
-    }
-    
-    /* 检查坐标和尺寸是否有效 */
-    if (x >= dev->config.width || y >= dev->config.height) {
-        return ERROR_INVALID_PARAM;
-    }
-    
-    /* 限制位图尺寸 */
-    if (x + width > dev->config.width) {
-        width = dev->config.width - x;
-    }
-    if (y + height > dev->config.height) {
-        height = dev->config.height - y;
-    }
-    
-    /* 计算位图每行字节?*/
-    uint8_t bitmap_bytes_per_row = (width + 7) / 8;
-    
-    /* 绘制位图 */
-    for (uint16_t row = 0; row < height; row++) {
-        for (uint16_t col = 0; col < width; col++) {
-            uint16_t bitmap_byte_index = row * bitmap_bytes_per_row + col / 8;
-            uint8_t bitmap_bit_index = col % 8;
-            uint8_t pixel_value = (bitmap[bitmap_byte_index] & (1 << bitmap_bit_index)) ? 1 : 0;
-            
-            display_set_pixel(handle, x + col, y + row, pixel_value);
+    tm1681_device_t *device = (tm1681_device_t *)context;
+    spi_transaction_t *transaction;
+    spi_segment_t *segment;
+
+    if (device->spi_pending >= TM1681_SPI_QUEUE_DEPTH) {
+        int result = tm1681_spi_wait(device, TM1681_SPI_TIMEOUT_MS);
+        if (result != TM1681_OK) {
+            /* 失败的是之前排队的帧，由帧缓冲的下一次等待报告并重发 */
+            device->spi_error = result;
+            return result;
         }
     }
-    
-    return DRIVER_OK;
-}
 
-/* 全局设备实例 */
-static tm1681_device_t g_tm1681_device;
+    segment = &device->spi_segments[device->spi_pending];
+    segment->tx_data = data;
+    segment->rx_data = NULL;
+    segment->len = length;
 
-/* 延时函数 */
-static void tm1681_delay_us(uint32_t us)
-{
-    for (uint32_t i = 0; i < us * 10; i++) {
-        __NOP();
-    }
-}
+    transaction = &device->spi_transactions[device->spi_pending];
+    memset(transaction, 0, sizeof(*transaction));
+    transaction->segments = segment;
+    transaction->segment_count = 1;
+    transaction->mode = SPI_MODE_3;
+    transaction->clock_hz = 0;
+    transaction->cs_control = tm1681_spi_stb;
+    transaction->cs_arg = device;
 
-/* 开始传?*/
-static void tm1681_start(tm1681_device_t *device)
-{
-    gpio_write(device->stb_pin, GPIO_LEVEL_HIGH);
-    tm1681_delay_us(TM1681_DELAY_US);
-    gpio_write(device->clock_pin, GPIO_LEVEL_HIGH);
-    tm1681_delay_us(TM1681_DELAY_US);
-    gpio_write(device->stb_pin, GPIO_LEVEL_LOW);
-    tm1681_delay_us(TM1681_DELAY_US);
-}
+    if (spi_transaction_submit(device->spi, transaction) != 0) {
+        return TM1681_IO_ERROR;
+    }
 
-/* 结束传输 */
-static void tm1681_stop(tm1681_device_t *device)
-{
-    gpio_write(device->clock_pin, GPIO_LEVEL_LOW);
-    tm1681_delay_us(TM1681_DELAY_US);
-    gpio_write(device->stb_pin, GPIO_LEVEL_LOW);
-    tm1681_delay_us(TM1681_DELAY_US);
-    gpio_write(device->clock_pin, GPIO_LEVEL_HIGH);
-    tm1681_delay_us(TM1681_DELAY_US);
-    gpio_write(device->stb_pin, GPIO_LEVEL_HIGH);
-    tm1681_delay_us(TM1681_DELAY_US);
+    device->spi_pending++;
+    return TM1681_OK;
 }
+#endif /* TM1681_SPI_TRANSPORT */
 
-/* 写一个字?*/
-static void tm1681_write_byte(tm1681_device_t *device, uint8_t data)
+/* 转换帧缓冲错误码 */
+static int tm1681_result(int result)
 {
-    for (uint8_t i = 0; i < 8; i++) {
-        gpio_write(device->clock_pin, GPIO_LEVEL_LOW);
-        tm1681_delay_us(TM1681_DELAY_US);
-        
-        /* 先写LSB (最低位) */
-        gpio_write(device->data_pin, (data & 0x01) ? GPIO_LEVEL_HIGH : GPIO_LEVEL_LOW);
-        tm1681_delay_us(TM1681_DELAY_US);
-        
-        gpio_write(device->clock_pin, GPIO_LEVEL_HIGH);
-        tm1681_delay_us(TM1681_DELAY_US);
-        
-        data >>= 1;
+    if (result == TM1681_OK) {
+        return DRIVER_OK;
     }
-}
 
-/* 写命?*/
-static void tm1681_write_cmd(tm1681_device_t *device, uint8_t cmd)
-{
-    tm1681_start(device);
-    tm1681_write_byte(device, cmd);
-    tm1681_stop(device);
+    return (result == TM1681_INVALID_PARAM) ? DRIVER_ERROR_INVALID_PARAMETER : DRIVER_ERROR_PERIPHERAL;
 }
 
-/* 写数?*/
-static void tm1681_write_data(tm1681_device_t *device, uint8_t addr, uint8_t data)
+/* 释放引脚 */
+static void tm1681_release_pins(tm1681_device_t *device)
 {
-    tm1681_write_cmd(device, TM1681_CMD_ADDRESS_MODE | addr);
-    tm1681_write_byte(device, data);
+    gpio_deinit(device->stb_pin);
+    if (device->tm1681_config.transport == TM1681_TRANSPORT_GPIO) {
+        gpio_deinit(device->data_pin);
+        gpio_deinit(device->clock_pin);
+    }
 }
 
 /**
- * @brief 初始化显示设?
- * 
+ * @brief 初始化显示设备
+ *
+ * tm1681_config_t.transport为TM1681_TRANSPORT_SPI时，数据和时钟由调用者按
+ * 模式3、低位在前初始化的SPI总线发出，驱动只控制STB引脚；刷新时整帧作为
+ * DMA事务提交后即返回。SPI传输需要CONFIG_TM1681_SPI_ENABLED(目前仅STM32)，
+ * 未启用时返回DRIVER_ERROR_UNSUPPORTED
+ *
  * @param config 显示配置参数
  * @param handle 显示设备句柄指针
  * @return int 0表示成功，非0表示失败
  */
 int display_init(const display_config_t *config, display_handle_t *handle)
 {
-    /* 检查参数有效?*/
+    tm1681_transport_t transport;
+    int result;
+
+    /* 检查参数有效性 */
     if (config == NULL || handle == NULL || config->driver_config == NULL) {
         return DRIVER_ERROR_INVALID_PARAMETER;
     }
-    
-    /* 检查显示类?*/
+
+    /* 检查显示类型 */
     if (config->type != DISPLAY_TYPE_LED_MATRIX) {
         return DRIVER_ERROR_UNSUPPORTED;
     }
-    
-    /* 检查是否已初始?*/
+
+    /* 检查是否已初始化 */
     if (g_tm1681_device.initialized) {
         return DRIVER_ERROR_ALREADY_INITIALIZED;
     }
-    
+
+    /* 控制器RAM按列存放，每列每8行一个字节 */
+    if ((uint32_t)config->width * ((config->height + 7) / 8) > TM1681_RAM_SIZE) {
+        return DRIVER_ERROR_INVALID_PARAMETER;
+    }
+
     /* 保存配置 */
     memcpy(&g_tm1681_device.config, config, sizeof(display_config_t));
     memcpy(&g_tm1681_device.tm1681_config, config->driver_config, sizeof(tm1681_config_t));
-    
-    /* 分配显示缓冲?*/
-    g_tm1681_device.buffer_size = config->width * ((config->height + 7) / 8);
-    g_tm1681_device.display_buffer = (uint8_t *)malloc(g_tm1681_device.buffer_size);
-    if (g_tm1681_device.display_buffer == NULL) {
-        return DRIVER_ERROR_OUT_OF_MEMORY;
+
+    tm1681_config_t *tm_config = &g_tm1681_device.tm1681_config;
+
+    if (tm_config->transport == TM1681_TRANSPORT_SPI) {
+#if TM1681_SPI_TRANSPORT
+        if (tm_config->spi_handle == NULL) {
+            return DRIVER_ERROR_INVALID_PARAMETER;
+        }
+#else
+        return DRIVER_ERROR_UNSUPPORTED;
+#endif
     }
-    
-    /* 清空显示缓冲?*/
-    memset(g_tm1681_device.display_buffer, 0, g_tm1681_device.buffer_size);
-    
-    /* 初始化GPIO引脚 */
-    tm1681_config_t *tm_config = (tm1681_config_t *)config->driver_config;
-    
-    /* 数据引脚配置 */
-    gpio_config_t data_pin_config = {
-        .port = GPIO_PORT_A + (tm_config->data_pin / 16),
-        .pin = tm_config->data_pin % 16,
-        .mode = GPIO_MODE_OUTPUT_PP,
-        .pull = GPIO_PULL_NONE,
-        .speed = GPIO_SPEED_HIGH
-    };
-    
-    /* 时钟引脚配置 */
-    gpio_config_t clock_pin_config = {
-        .port = GPIO_PORT_A + (tm_config->clock_pin / 16),
-        .pin = tm_config->clock_pin % 16,
-        .mode = GPIO_MODE_OUTPUT_PP,
-        .pull = GPIO_PULL_NONE,
-        .speed = GPIO_SPEED_HIGH
-    };
-    
+
     /* STB引脚配置 */
     gpio_config_t stb_pin_config = {
         .port = GPIO_PORT_A + (tm_config->stb_pin / 16),
@@ -681,33 +299,69 @@ int display_init(const display_config_t *config, display_handle_t *handle)
         .pull = GPIO_PULL_NONE,
         .speed = GPIO_SPEED_HIGH
     };
-    
-    /* 初始化GPIO引脚 */
-    if (gpio_init(&data_pin_config, &g_tm1681_device.data_pin) != DRIVER_OK) {
-        free(g_tm1681_device.display_buffer);
-        return DRIVER_ERROR_PERIPHERAL;
-    }
-    
-    if (gpio_init(&clock_pin_config, &g_tm1681_device.clock_pin) != DRIVER_OK) {
-        gpio_deinit(g_tm1681_device.data_pin);
-        free(g_tm1681_device.display_buffer);
-        return DRIVER_ERROR_PERIPHERAL;
-    }
-    
+
     if (gpio_init(&stb_pin_config, &g_tm1681_device.stb_pin) != DRIVER_OK) {
-        gpio_deinit(g_tm1681_device.data_pin);
-        gpio_deinit(g_tm1681_device.clock_pin);
-        free(g_tm1681_device.display_buffer);
         return DRIVER_ERROR_PERIPHERAL;
     }
-    
-    /* 设置初始电平 */
-    gpio_write(g_tm1681_device.data_pin, GPIO_LEVEL_LOW);
-    gpio_write(g_tm1681_device.clock_pin, GPIO_LEVEL_LOW);
     gpio_write(g_tm1681_device.stb_pin, GPIO_LEVEL_HIGH);
-    
-    /* 初始化TM1681 */
-    
+
+#if TM1681_SPI_TRANSPORT
+    if (tm_config->transport == TM1681_TRANSPORT_SPI) {
+        /* 数据和时钟由SPI外设发出，整帧合并为一次突发写入 */
+        g_tm1681_device.spi = (spi_handle_t)tm_config->spi_handle;
+        g_tm1681_device.spi_pending = 0;
+        g_tm1681_device.spi_error = TM1681_OK;
+        transport.write = tm1681_spi_write;
+        transport.wait = tm1681_spi_wait;
+        transport.merge_gap = TM1681_MERGE_ALL;
+    } else
+#endif
+    {
+        /* 数据引脚配置 */
+        gpio_config_t data_pin_config = {
+            .port = GPIO_PORT_A + (tm_config->data_pin / 16),
+            .pin = tm_config->data_pin % 16,
+            .mode = GPIO_MODE_OUTPUT_PP,
+            .pull = GPIO_PULL_NONE,
+            .speed = GPIO_SPEED_HIGH
+        };
+
+        /* 时钟引脚配置 */
+        gpio_config_t clock_pin_config = {
+            .port = GPIO_PORT_A + (tm_config->clk_pin / 16),
+            .pin = tm_config->clk_pin % 16,
+            .mode = GPIO_MODE_OUTPUT_PP,
+            .pull = GPIO_PULL_NONE,
+            .speed = GPIO_SPEED_HIGH
+        };
+
+        if (gpio_init(&data_pin_config, &g_tm1681_device.data_pin) != DRIVER_OK) {
+            gpio_deinit(g_tm1681_device.stb_pin);
+            return DRIVER_ERROR_PERIPHERAL;
+        }
+
+        if (gpio_init(&clock_pin_config, &g_tm1681_device.clock_pin) != DRIVER_OK) {
+            gpio_deinit(g_tm1681_device.stb_pin);
+            gpio_deinit(g_tm1681_device.data_pin);
+            return DRIVER_ERROR_PERIPHERAL;
+        }
+
+        gpio_write(g_tm1681_device.data_pin, GPIO_LEVEL_LOW);
+        gpio_write(g_tm1681_device.clock_pin, GPIO_LEVEL_LOW);
+
+        transport.write = tm1681_gpio_write;
+        transport.wait = NULL;
+        transport.merge_gap = TM1681_BURST_MERGE_GAP;
+    }
+    transport.context = &g_tm1681_device;
+
+    /* 设置数据模式并清空显示RAM */
+    result = tm1681_frame_init(&g_tm1681_device.frame, config->width, config->height, &transport);
+    if (result != TM1681_OK) {
+        tm1681_release_pins(&g_tm1681_device);
+        return tm1681_result(result);
+    }
+
     /* 选择显示模式 */
     uint8_t display_mode = TM1681_DISPLAY_7_GRIDS;
     if (config->width <= 4) {
@@ -717,246 +371,200 @@ int display_init(const display_config_t *config, display_handle_t *handle)
     } else if (config->width <= 6) {
         display_mode = TM1681_DISPLAY_6_GRIDS;
     }
-    
-    /* 发送初始化命令 */
-    tm1681_write_cmd(&g_tm1681_device, TM1681_CMD_DISPLAY_MODE | display_mode | TM1681_DATA_NORMAL);
-    tm1681_write_cmd(&g_tm1681_device, TM1681_CMD_DATA_MODE | TM1681_ADDR_AUTO_INC);
-    
-    /* 设置亮度 */
-    uint8_t brightness = tm_config->intensity & TM1681_BRIGHTNESS_MASK;
-    tm1681_write_cmd(&g_tm1681_device, TM1681_CMD_DISPLAY_CTRL | TM1681_DISPLAY_ON | brightness);
-    
-    /* 清空显示 */
-    for (uint8_t i = 0; i < 16; i++) {
-        tm1681_write_data(&g_tm1681_device, i, 0x00);
+
+    /* 设置显示模式和亮度 */
+    uint8_t brightness = tm_config->brightness_levels & TM1681_BRIGHTNESS_MASK;
+    result = tm1681_frame_command(&g_tm1681_device.frame, TM1681_CMD_DISPLAY_MODE | display_mode | TM1681_DATA_NORMAL);
+    if (result == TM1681_OK) {
+        result = tm1681_frame_command(&g_tm1681_device.frame, TM1681_CMD_DISPLAY_CTRL | TM1681_DISPLAY_ON | brightness);
     }
-    
-    /* 标记为已初始?*/
+    if (result != TM1681_OK) {
+        tm1681_frame_deinit(&g_tm1681_device.frame);
+        tm1681_release_pins(&g_tm1681_device);
+        return tm1681_result(result);
+    }
+
+    /* 标记为已初始化 */
     g_tm1681_device.initialized = true;
-    
+
     /* 返回句柄 */
     *handle = (display_handle_t)&g_tm1681_device;
-    
+
     return DRIVER_OK;
 }
 
 /**
  * @brief 去初始化显示设备
- * 
+ *
  * @param handle 显示设备句柄
  * @return int 0表示成功，非0表示失败
  */
 int display_deinit(display_handle_t handle)
 {
     tm1681_device_t *device = (tm1681_device_t *)handle;
-    
-    /* 检查参数有效?*/
+
+    /* 检查参数有效性 */
     if (device != &g_tm1681_device || !device->initialized) {
         return DRIVER_ERROR_INVALID_PARAMETER;
     }
-    
-    /* 关闭显示 */
-    tm1681_write_cmd(device, TM1681_CMD_DISPLAY_CTRL | TM1681_DISPLAY_OFF);
-    
+
+    /* 关闭显示并等待传输完成 */
+    tm1681_frame_command(&device->frame, TM1681_CMD_DISPLAY_CTRL | TM1681_DISPLAY_OFF);
+    tm1681_frame_deinit(&device->frame);
+
     /* 释放资源 */
-    gpio_deinit(device->data_pin);
-    gpio_deinit(device->clock_pin);
-    gpio_deinit(device->stb_pin);
-    
-    /* 释放显示缓冲?*/
-    if (device->display_buffer != NULL) {
-        free(device->display_buffer);
-        device->display_buffer = NULL;
-    }
-    
-    /* 清除初始化标?*/
+    tm1681_release_pins(device);
+
+    /* 清除初始化标志 */
     device->initialized = false;
-    
+
     return DRIVER_OK;
 }
 
 /**
  * @brief 清除显示内容
- * 
+ *
+ * 只清空显示缓冲区，下次display_refresh时写入原来点亮的列。先清除再重绘的
+ * 帧中内容未变的列不会被写入控制器
+ *
  * @param handle 显示设备句柄
  * @return int 0表示成功，非0表示失败
  */
 int display_clear(display_handle_t handle)
 {
     tm1681_device_t *device = (tm1681_device_t *)handle;
-    
-    /* 检查参数有效?*/
+
+    /* 检查参数有效性 */
     if (device != &g_tm1681_device || !device->initialized) {
         return DRIVER_ERROR_INVALID_PARAMETER;
     }
-    
-    /* 清空缓冲?*/
-    memset(device->display_buffer, 0, device->buffer_size);
-    
-    /* 清空显示 */
-    tm1681_write_cmd(device, TM1681_CMD_DATA_MODE | TM1681_ADDR_AUTO_INC);
-    tm1681_start(device);
-    tm1681_write_byte(device, TM1681_CMD_ADDRESS_MODE);
-    
-    for (uint8_t i = 0; i < 16; i++) {
-        tm1681_write_byte(device, 0x00);
-    }
-    
-    tm1681_stop(device);
-    
+
+    tm1681_frame_clear(&device->frame);
+
     return DRIVER_OK;
 }
 
 /**
- * @brief 设置像素?
- * 
+ * @brief 设置像素值
+ *
  * @param handle 显示设备句柄
  * @param x X坐标
  * @param y Y坐标
- * @param value 像素?
+ * @param value 像素值
  * @return int 0表示成功，非0表示失败
  */
 int display_set_pixel(display_handle_t handle, uint16_t x, uint16_t y, uint32_t value)
 {
     tm1681_device_t *device = (tm1681_device_t *)handle;
-    
-    /* 检查参数有效?*/
+
+    /* 检查参数有效性 */
     if (device != &g_tm1681_device || !device->initialized) {
         return DRIVER_ERROR_INVALID_PARAMETER;
     }
-    
-    /* 检查坐标是否在范围?*/
-    if (x >= device->config.width || y >= device->config.height) {
-        return DRIVER_ERROR_INVALID_PARAMETER;
-    }
-    
-    /* 计算缓冲区位?*/
-    uint16_t byte_idx = x + (y / 8) * device->config.width;
-    uint8_t bit_idx = y % 8;
-    
-    /* 设置或清除像?*/
-    if (value) {
-        device->display_buffer[byte_idx] |= (1 << bit_idx);
-    } else {
-        device->display_buffer[byte_idx] &= ~(1 << bit_idx);
-    }
-    
-    return DRIVER_OK;
+
+    return tm1681_result(tm1681_frame_set_pixel(&device->frame, x, y, value != 0));
 }
 
 /**
- * @brief 获取像素?
- * 
+ * @brief 获取像素值
+ *
  * @param handle 显示设备句柄
  * @param x X坐标
  * @param y Y坐标
- * @param value 像素值指?
+ * @param value 像素值指针
  * @return int 0表示成功，非0表示失败
  */
 int display_get_pixel(display_handle_t handle, uint16_t x, uint16_t y, uint32_t *value)
 {
     tm1681_device_t *device = (tm1681_device_t *)handle;
-    
-    /* 检查参数有效?*/
+    bool on;
+
+    /* 检查参数有效性 */
     if (device != &g_tm1681_device || !device->initialized || value == NULL) {
         return DRIVER_ERROR_INVALID_PARAMETER;
     }
-    
-    /* 检查坐标是否在范围?*/
-    if (x >= device->config.width || y >= device->config.height) {
+
+    if (tm1681_frame_get_pixel(&device->frame, x, y, &on) != TM1681_OK) {
         return DRIVER_ERROR_INVALID_PARAMETER;
     }
-    
-    /* 计算缓冲区位?*/
-    uint16_t byte_idx = x + (y / 8) * device->config.width;
-    uint8_t bit_idx = y % 8;
-    
-    /* 获取像素?*/
-    *value = (device->display_buffer[byte_idx] & (1 << bit_idx)) ? 1 : 0;
-    
+
+    *value = on ? 1 : 0;
+
     return DRIVER_OK;
 }
 
 /**
  * @brief 设置显示区域数据
- * 
+ *
+ * 数据按行连续存放，每字节低位在前，行与行之间不补齐
+ *
  * @param handle 显示设备句柄
  * @param x X起始坐标
  * @param y Y起始坐标
  * @param width 宽度
  * @param height 高度
- * @param data 数据缓冲?
+ * @param data 数据缓冲区
  * @return int 0表示成功，非0表示失败
  */
-int display_set_area(display_handle_t handle, uint16_t x, uint16_t y, 
+int display_set_area(display_handle_t handle, uint16_t x, uint16_t y,
                      uint16_t width, uint16_t height, const uint8_t *data)
 {
     tm1681_device_t *device = (tm1681_device_t *)handle;
-    
-    /* 检查参数有效?*/
-    if (device != &g_tm1681_device || !device->initialized || data == NULL) {
+
+    /* 检查参数有效性 */
+    if (device != &g_tm1681_device || !device->initialized) {
         return DRIVER_ERROR_INVALID_PARAMETER;
     }
-    
-    /* 检查坐标和尺寸是否在范围内 */
-    if (x >= device->config.width || y >= device->config.height ||
-        x + width > device->config.width || y + height > device->config.height) {
+
+    return tm1681_result(tm1681_frame_set_area(&device->frame, x, y, width, height, data));
+}
+
+/**
+ * @brief 绘制位图
+ *
+ * 位图按行存放，每行补齐到整字节，低位在前；超出屏幕的部分被裁剪
+ *
+ * @param handle 显示设备句柄
+ * @param x 起始X坐标
+ * @param y 起始Y坐标
+ * @param width 位图宽度
+ * @param height 位图高度
+ * @param bitmap 位图数据
+ * @return int 0表示成功，非0表示失败
+ */
+int display_draw_bitmap(display_handle_t handle, uint16_t x, uint16_t y,
+                        uint16_t width, uint16_t height, const uint8_t *bitmap)
+{
+    tm1681_device_t *device = (tm1681_device_t *)handle;
+
+    /* 检查参数有效性 */
+    if (device != &g_tm1681_device || !device->initialized) {
         return DRIVER_ERROR_INVALID_PARAMETER;
     }
-    
-    /* 逐像素设置区?*/
-    for (uint16_t j = 0; j < height; j++) {
-        for (uint16_t i = 0; i < width; i++) {
-            uint16_t src_byte_idx = i + j * width / 8;
-            uint8_t src_bit_idx = (j * width + i) % 8;
-            
-            uint32_t pixel_value = (data[src_byte_idx] & (1 << src_bit_idx)) ? 1 : 0;
-            display_set_pixel(handle, x + i, y + j, pixel_value);
-        }
-    }
-    
-    return DRIVER_OK;
+
+    return tm1681_result(tm1681_frame_draw_bitmap(&device->frame, x, y, width, height, bitmap));
 }
 
 /**
  * @brief 刷新显示内容
- * 
+ *
+ * 只写入与控制器RAM内容不同的字节。GPIO传输下相邻的待写字节合并为一次
+ * 突发写入，间隔不超过TM1681_BURST_MERGE_GAP的未变字节一并写入；SPI传输
+ * 下全部待写字节合并为一个DMA事务，函数在事务提交后返回
+ *
  * @param handle 显示设备句柄
  * @return int 0表示成功，非0表示失败
  */
 int display_refresh(display_handle_t handle)
 {
     tm1681_device_t *device = (tm1681_device_t *)handle;
-    
-    /* 检查参数有效?*/
+
+    /* 检查参数有效性 */
     if (device != &g_tm1681_device || !device->initialized) {
         return DRIVER_ERROR_INVALID_PARAMETER;
     }
-    
-    /* 设置自动地址增加模式 */
-    tm1681_write_cmd(device, TM1681_CMD_DATA_MODE | TM1681_ADDR_AUTO_INC);
-    
-    /* 写入显示数据 */
-    for (uint8_t grid = 0; grid < device->config.width; grid++) {
-        /* 设置地址 */
-        tm1681_write_cmd(device, TM1681_CMD_ADDRESS_MODE | grid);
-        
-        /* 计算该列的数?*/
-        uint8_t column_data = 0;
-        for (uint8_t row = 0; row < device->config.height; row++) {
-            uint16_t byte_idx = grid + (row / 8) * device->config.width;
-            uint8_t bit_idx = row % 8;
-            
-            if (device->display_buffer[byte_idx] & (1 << bit_idx)) {
-                column_data |= (1 << row);
-            }
-        }
-        
-        /* 写入数据 */
-        tm1681_write_byte(device, column_data);
-    }
-    
-    return DRIVER_OK;
+
+    return tm1681_result(tm1681_frame_refresh(&device->frame));
 }
 
 /**
@@ -979,9 +587,8 @@ int display_set_brightness(display_handle_t handle, uint8_t brightness)
     uint8_t tm1681_brightness = (brightness * 7) / 100;
     
     /* 设置亮度 */
-    tm1681_write_cmd(device, TM1681_CMD_DISPLAY_CTRL | TM1681_DISPLAY_ON | tm1681_brightness);
-    
-    return DRIVER_OK;
+    return tm1681_result(tm1681_frame_command(&device->frame,
+                                              TM1681_CMD_DISPLAY_CTRL | TM1681_DISPLAY_ON | tm1681_brightness));
 }
 
 /**
@@ -1084,9 +691,7 @@ int display_sleep(display_handle_t handle)
     }
     
     /* 关闭显示 */
-    tm1681_write_cmd(device, TM1681_CMD_DISPLAY_CTRL | TM1681_DISPLAY_OFF);
-    
-    return DRIVER_OK;
+    return tm1681_result(tm1681_frame_command(&device->frame, TM1681_CMD_DISPLAY_CTRL | TM1681_DISPLAY_OFF));
 }
 
 /**
@@ -1105,10 +710,9 @@ int display_wakeup(display_handle_t handle)
     }
     
     /* 打开显示 */
-    uint8_t brightness = device->tm1681_config.intensity & TM1681_BRIGHTNESS_MASK;
-    tm1681_write_cmd(device, TM1681_CMD_DISPLAY_CTRL | TM1681_DISPLAY_ON | brightness);
-    
-    return DRIVER_OK;
+    uint8_t brightness = device->tm1681_config.brightness_levels & TM1681_BRIGHTNESS_MASK;
+    return tm1681_result(tm1681_frame_command(&device->frame,
+                                              TM1681_CMD_DISPLAY_CTRL | TM1681_DISPLAY_ON | brightness));
 }
 
 /**
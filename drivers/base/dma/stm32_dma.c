@@ -10,6 +10,10 @@
 #include "stm32f4xx_hal.h"
 #include <string.h>
 
+#if (CURRENT_RTOS != RTOS_NONE)
+#include "common/rtos_api.h"
+#endif
+
 /* DMA通道最大数?*/
 #define STM32_DMA_MAX_CHANNELS 16
 
@@ -20,6 +24,27 @@
 #define STM32_DMA1_BASE DMA1
 #define STM32_DMA2_BASE DMA2
 
+/* 小于该长度的内存拷贝直接由CPU完成，DMA启动与中断开销高于拷贝本身 */
+#ifndef CONFIG_DMA_MEMCPY_MIN_SIZE
+#define CONFIG_DMA_MEMCPY_MIN_SIZE      256
+#endif
+
+/* 异步内存拷贝队列深度 */
+#ifndef CONFIG_DMA_MEMCPY_QUEUE_SIZE
+#define CONFIG_DMA_MEMCPY_QUEUE_SIZE    8
+#endif
+
+/* 内存拷贝数据流中断优先级 */
+#ifndef CONFIG_DMA_MEMCPY_IRQ_PRIORITY
+#define CONFIG_DMA_MEMCPY_IRQ_PRIORITY  10
+#endif
+
+/* 单次传输最大数据项数（NDTR为16位） */
+#define STM32_DMA_MAX_ITEMS             65535U
+
+/* 仅DMA2支持内存到内存传输 */
+#define STM32_DMA2_STREAM_MASK          0xFF00U
+
 /* STM32 DMA设备结构?*/
 typedef struct {
     DMA_HandleTypeDef hdma;             /* HAL DMA句柄 */
@@ -34,6 +59,43 @@ typedef struct {
 /* DMA设备数组 */
 static stm32_dma_device_t g_dma_devices[STM32_DMA_MAX_CHANNELS];
 
+/* 各数据流中断号，与通道号一一对应 */
+static const IRQn_Type g_dma_stream_irqs[STM32_DMA_MAX_CHANNELS] = {
+    DMA1_Stream0_IRQn, DMA1_Stream1_IRQn, DMA1_Stream2_IRQn, DMA1_Stream3_IRQn,
+    DMA1_Stream4_IRQn, DMA1_Stream5_IRQn, DMA1_Stream6_IRQn, DMA1_Stream7_IRQn,
+    DMA2_Stream0_IRQn, DMA2_Stream1_IRQn, DMA2_Stream2_IRQn, DMA2_Stream3_IRQn,
+    DMA2_Stream4_IRQn, DMA2_Stream5_IRQn, DMA2_Stream6_IRQn, DMA2_Stream7_IRQn
+};
+
+/* 异步内存拷贝请求 */
+typedef struct {
+    uint8_t *dst;                       /* 目标地址 */
+    const uint8_t *src;                 /* 源地址 */
+    uint32_t length;                    /* 长度 */
+    dma_callback_t callback;            /* 完成回调 */
+    void *user_data;                    /* 回调参数 */
+} dma_memcpy_request_t;
+
+/* 内存拷贝引擎 */
+typedef struct {
+    dma_handle_t handle;                /* 专用数据流句柄，由dma_memcpy_init分配 */
+    dma_memcpy_request_t queue[CONFIG_DMA_MEMCPY_QUEUE_SIZE]; /* 请求队列，队头为正在执行的请求 */
+    volatile uint32_t head;             /* 队头 */
+    volatile uint32_t count;            /* 队列中的请求数 */
+    uint32_t offset;                    /* 队头请求已提交的字节数 */
+    uint32_t chunk;                     /* 当前分块字节数 */
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_sem_t done_sem;                /* 阻塞拷贝完成通知 */
+    rtos_mutex_t sync_mutex;            /* 串行化阻塞拷贝的等待者 */
+#endif
+} dma_memcpy_engine_t;
+
+static dma_memcpy_engine_t g_dma_memcpy;
+
+/* 已占用数据流位图及各数据流服务的外设请求标识，在中断锁保护下修改 */
+static uint32_t g_dma_claimed;
+static uint32_t g_dma_request_ids[STM32_DMA_MAX_CHANNELS];
+
 /* 获取DMA控制器和?*/
 static DMA_Stream_TypeDef *get_dma_stream(uint32_t dma_channel)
 {
@@ -101,6 +163,8 @@ static uint32_t convert_mode(dma_mode_t mode)
             return DMA_NORMAL;
         case DMA_MODE_CIRCULAR:
             return DMA_CIRCULAR;
+        case DMA_MODE_PERIPH_FLOW:
+            return DMA_PFCTRL;
         default:
             return DMA_NORMAL;
     }
@@ -123,14 +187,44 @@ static uint32_t convert_priority(dma_priority_t priority)
     }
 }
 
+/* 关闭中断并返回之前的中断状态 */
+static inline uint32_t dma_irq_lock(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+/* 恢复中断状态 */
+static inline void dma_irq_unlock(uint32_t primask)
+{
+    __set_PRIMASK(primask);
+}
+
 /* DMA中断处理函数 */
 static void dma_irq_handler(stm32_dma_device_t *dev)
 {
+    /* 检查半传输标志，仅在使能半传输中断时处理 */
+    if (__HAL_DMA_GET_IT_SOURCE(&dev->hdma, DMA_IT_HT) &&
+        __HAL_DMA_GET_FLAG(&dev->hdma, __HAL_DMA_GET_HT_FLAG_INDEX(&dev->hdma))) {
+        __HAL_DMA_CLEAR_FLAG(&dev->hdma, __HAL_DMA_GET_HT_FLAG_INDEX(&dev->hdma));
+        
+        if (dev->callback) {
+            dev->callback(dev->arg, DMA_STATUS_HALF);
+        }
+    }
+    
     /* 检查传输完成标?*/
     if (__HAL_DMA_GET_FLAG(&dev->hdma, __HAL_DMA_GET_TC_FLAG_INDEX(&dev->hdma))) {
         /* 清除标志 */
         __HAL_DMA_CLEAR_FLAG(&dev->hdma, __HAL_DMA_GET_TC_FLAG_INDEX(&dev->hdma));
         
+        /* 非循环模式下传输结束，恢复HAL句柄状态以便再次启动 */
+        if (dev->config.mode != DMA_MODE_CIRCULAR) {
+            dev->hdma.State = HAL_DMA_STATE_READY;
+            __HAL_UNLOCK(&dev->hdma);
+        }
+        
         /* 更新状?*/
         dev->status = DMA_STATUS_COMPLETE;
         
@@ -155,40 +249,22 @@ static void dma_irq_handler(stm32_dma_device_t *dev)
     }
 }
 
-/**
- * @brief 初始化DMA
- * 
- * @param dma_channel DMA通道
- * @param config DMA配置参数
- * @param callback DMA传输完成回调函数
- * @param arg 传递给回调函数的参?
- * @param handle DMA句柄指针
- * @return int 0表示成功，非0表示失败
- */
-int dma_init(uint32_t dma_channel, const dma_config_t *config, 
-             dma_callback_t callback, void *arg, dma_handle_t *handle)
+/* 释放数据流占用 */
+static void dma_release_claim(uint32_t dma_channel)
 {
-    stm32_dma_device_t *dev;
+    uint32_t primask = dma_irq_lock();
+    g_dma_claimed &= ~(1U << dma_channel);
+    g_dma_request_ids[dma_channel] = DMA_REQUEST_ID_NONE;
+    dma_irq_unlock(primask);
+}
+
+/* 配置数据流硬件，调用者已占用该数据流 */
+static int dma_stream_setup(uint32_t dma_channel, const dma_config_t *config,
+                            dma_callback_t callback, void *arg, dma_handle_t *handle)
+{
+    stm32_dma_device_t *dev = &g_dma_devices[dma_channel];
     DMA_HandleTypeDef *hdma;
     
-    /* 参数检?*/
-    if (config == NULL || handle == NULL) {
-        return ERROR_INVALID_PARAM;
-    }
-    
-    /* 检查通道有效?*/
-    if (dma_channel >= STM32_DMA_MAX_CHANNELS) {
-        return ERROR_INVALID_PARAM;
-    }
-    
-    /* 获取DMA设备 */
-    dev = &g_dma_devices[dma_channel];
-    
-    /* 检查是否已初始?*/
-    if (dev->initialized) {
-        return ERROR_ALREADY_INITIALIZED;
-    }
-    
     /* 初始化DMA设备 */
     memset(dev, 0, sizeof(stm32_dma_device_t));
     dev->channel = dma_channel;
@@ -250,6 +326,49 @@ int dma_init(uint32_t dma_channel, const dma_config_t *config,
     return DRIVER_OK;
 }
 
+/**
+ * @brief 初始化DMA
+ * 
+ * @param dma_channel DMA通道
+ * @param config DMA配置参数
+ * @param callback DMA传输完成回调函数
+ * @param arg 传递给回调函数的参?
+ * @param handle DMA句柄指针
+ * @return int 0表示成功，非0表示失败
+ */
+int dma_init(uint32_t dma_channel, const dma_config_t *config, 
+             dma_callback_t callback, void *arg, dma_handle_t *handle)
+{
+    uint32_t primask;
+    int ret;
+    
+    /* 参数检?*/
+    if (config == NULL || handle == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    /* 检查通道有效?*/
+    if (dma_channel >= STM32_DMA_MAX_CHANNELS) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    /* 占用数据流 */
+    primask = dma_irq_lock();
+    if (g_dma_claimed & (1U << dma_channel)) {
+        dma_irq_unlock(primask);
+        return ERROR_ALREADY_INITIALIZED;
+    }
+    g_dma_claimed |= (1U << dma_channel);
+    dma_irq_unlock(primask);
+    
+    ret = dma_stream_setup(dma_channel, config, callback, arg, handle);
+    if (ret != DRIVER_OK) {
+        dma_release_claim(dma_channel);
+    }
+    
+    return ret;
+}
+
 /**
  * @brief 去初始化DMA
  * 
@@ -279,6 +398,9 @@ int dma_deinit(dma_handle_t handle)
     /* 清除初始化标?*/
     dev->initialized = false;
     
+    /* 释放数据流占用 */
+    dma_release_claim(dev->channel);
+    
     return DRIVER_OK;
 }
 
@@ -469,6 +591,146 @@ int dma_set_data_size(dma_handle_t handle, uint32_t data_size)
     return DRIVER_OK;
 }
 
+/**
+ * @brief 设置DMA内存地址是否自增
+ * 
+ * 用于同一数据流在缓冲区与固定地址（如填充字节）之间切换，仅在数据流停止时有效
+ * 
+ * @param handle DMA句柄
+ * @param enable 是否自增
+ * @return int 0表示成功，非0表示失败
+ */
+int dma_set_memory_increment(dma_handle_t handle, bool enable)
+{
+    stm32_dma_device_t *dev = (stm32_dma_device_t *)handle;
+    
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    if (dev->hdma.Instance->CR & DMA_SxCR_EN) {
+        return ERROR_BUSY;
+    }
+    
+    dev->hdma.Init.MemInc = enable ? DMA_MINC_ENABLE : DMA_MINC_DISABLE;
+    if (enable) {
+        SET_BIT(dev->hdma.Instance->CR, DMA_SxCR_MINC);
+    } else {
+        CLEAR_BIT(dev->hdma.Instance->CR, DMA_SxCR_MINC);
+    }
+    
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 使能或禁用DMA半传输中断
+ * 
+ * @param handle DMA句柄
+ * @param enable 是否使能
+ * @return int 0表示成功，非0表示失败
+ */
+int dma_set_half_transfer_interrupt(dma_handle_t handle, bool enable)
+{
+    stm32_dma_device_t *dev = (stm32_dma_device_t *)handle;
+    
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    if (enable) {
+        __HAL_DMA_CLEAR_FLAG(&dev->hdma, __HAL_DMA_GET_HT_FLAG_INDEX(&dev->hdma));
+        __HAL_DMA_ENABLE_IT(&dev->hdma, DMA_IT_HT);
+    } else {
+        __HAL_DMA_DISABLE_IT(&dev->hdma, DMA_IT_HT);
+    }
+    
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 设置DMA数据流的中断优先级并使能其中断线
+ * 
+ * @param handle DMA句柄
+ * @param priority 中断抢占优先级
+ * @return int 0表示成功，非0表示失败
+ */
+int dma_enable_irq(dma_handle_t handle, uint32_t priority)
+{
+    stm32_dma_device_t *dev = (stm32_dma_device_t *)handle;
+    
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    HAL_NVIC_SetPriority(g_dma_stream_irqs[dev->channel], priority, 0);
+    HAL_NVIC_EnableIRQ(g_dma_stream_irqs[dev->channel]);
+    
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 设置DMA数据流的请求通道
+ * 
+ * @param handle DMA句柄
+ * @param request 请求通道（DMA_CHANNEL_0 ~ DMA_CHANNEL_7）
+ * @return int 0表示成功，非0表示失败
+ */
+int dma_set_request_line(dma_handle_t handle, uint32_t request)
+{
+    stm32_dma_device_t *dev = (stm32_dma_device_t *)handle;
+    
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    if (dev->hdma.Instance->CR & DMA_SxCR_EN) {
+        return ERROR_BUSY;
+    }
+    
+    dev->hdma.Init.Channel = request;
+    MODIFY_REG(dev->hdma.Instance->CR, DMA_SxCR_CHSEL, request);
+    
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 使能或禁用DMA数据流的FIFO突发传输
+ * 
+ * @param handle DMA句柄
+ * @param enable 是否使能
+ * @return int 0表示成功，非0表示失败
+ */
+int dma_set_fifo_burst(dma_handle_t handle, bool enable)
+{
+    stm32_dma_device_t *dev = (stm32_dma_device_t *)handle;
+    
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    if (dev->hdma.Instance->CR & DMA_SxCR_EN) {
+        return ERROR_BUSY;
+    }
+    
+    /* FIFO满阈值为16字节，可容纳任意数据宽度的4拍突发 */
+    if (enable) {
+        dev->hdma.Init.FIFOMode = DMA_FIFOMODE_ENABLE;
+        dev->hdma.Init.FIFOThreshold = DMA_FIFO_THRESHOLD_FULL;
+        dev->hdma.Init.MemBurst = DMA_MBURST_INC4;
+        dev->hdma.Init.PeriphBurst = DMA_PBURST_INC4;
+        dev->hdma.Instance->FCR = DMA_SxFCR_DMDIS | DMA_FIFO_THRESHOLD_FULL;
+    } else {
+        dev->hdma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+        dev->hdma.Init.MemBurst = DMA_MBURST_SINGLE;
+        dev->hdma.Init.PeriphBurst = DMA_PBURST_SINGLE;
+        CLEAR_BIT(dev->hdma.Instance->FCR, DMA_SxFCR_DMDIS);
+    }
+    MODIFY_REG(dev->hdma.Instance->CR, DMA_SxCR_MBURST | DMA_SxCR_PBURST,
+               dev->hdma.Init.MemBurst | dev->hdma.Init.PeriphBurst);
+    
+    return DRIVER_OK;
+}
+
 /**
  * @brief 使能DMA中断
  * 
@@ -517,6 +779,453 @@ int dma_disable_interrupt(dma_handle_t handle)
     return DRIVER_OK;
 }
 
+/**
+ * @brief 按优先级分配空闲DMA数据流并初始化
+ * 
+ * 同一软件优先级下数据流号越小仲裁优先级越高，因此高优先级请求从候选集中
+ * 编号最小的空闲数据流开始查找，低优先级请求从编号最大的开始查找，
+ * 将低编号数据流留给对延迟敏感的外设。
+ * 
+ * @param stream_mask 候选数据流位图，bit n对应通道号n，0表示任意数据流
+ * @param request_id 外设请求标识，同一标识同时只能被一个数据流占用，内存到内存传输使用DMA_REQUEST_ID_NONE
+ * @param config DMA配置参数
+ * @param callback DMA传输完成回调函数
+ * @param arg 传递给回调函数的参数
+ * @param handle DMA句柄指针
+ * @return int 0表示成功，非0表示失败
+ */
+int dma_alloc(uint32_t stream_mask, uint32_t request_id, const dma_config_t *config,
+              dma_callback_t callback, void *arg, dma_handle_t *handle)
+{
+    uint32_t primask;
+    int channel = -1;
+    int ret;
+    
+    if (config == NULL || handle == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    if (stream_mask == 0) {
+        stream_mask = (1U << STM32_DMA_MAX_CHANNELS) - 1;
+    }
+    
+    if (config->direction == DMA_DIR_MEM_TO_MEM) {
+        stream_mask &= STM32_DMA2_STREAM_MASK;
+    }
+    
+    primask = dma_irq_lock();
+    
+    /* 请求线冲突检查：同一外设请求不能由两个数据流同时服务 */
+    if (request_id != DMA_REQUEST_ID_NONE) {
+        for (uint32_t i = 0; i < STM32_DMA_MAX_CHANNELS; i++) {
+            if ((g_dma_claimed & (1U << i)) && g_dma_request_ids[i] == request_id) {
+                dma_irq_unlock(primask);
+                return ERROR_BUSY;
+            }
+        }
+    }
+    
+    for (uint32_t n = 0; n < STM32_DMA_MAX_CHANNELS; n++) {
+        uint32_t i = (config->priority >= DMA_PRIORITY_HIGH) ? n : (STM32_DMA_MAX_CHANNELS - 1 - n);
+        
+        if ((stream_mask & (1U << i)) && !(g_dma_claimed & (1U << i))) {
+            channel = (int)i;
+            g_dma_claimed |= (1U << i);
+            g_dma_request_ids[i] = request_id;
+            break;
+        }
+    }
+    
+    dma_irq_unlock(primask);
+    
+    if (channel < 0) {
+        return ERROR_BUSY;
+    }
+    
+    ret = dma_stream_setup((uint32_t)channel, config, callback, arg, handle);
+    if (ret != DRIVER_OK) {
+        dma_release_claim((uint32_t)channel);
+    }
+    
+    return ret;
+}
+
+/**
+ * @brief 获取可用的DMA数据流
+ * 
+ * @param channel 获取到的通道号
+ * @return int 0表示成功，非0表示失败
+ */
+int dma_get_available_channel(uint8_t *channel)
+{
+    if (channel == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    for (uint32_t i = 0; i < STM32_DMA_MAX_CHANNELS; i++) {
+        if (!(g_dma_claimed & (1U << i))) {
+            *channel = (uint8_t)i;
+            return DRIVER_OK;
+        }
+    }
+    
+    return ERROR_BUSY;
+}
+
+/* 判断地址区间能否由DMA访问，CCM RAM只连接到CPU数据总线 */
+static bool dma_memcpy_accessible(const void *addr, uint32_t length)
+{
+#ifdef CCMDATARAM_BASE
+    uint32_t start = (uint32_t)addr;
+    uint32_t end = start + length - 1;
+    
+    if (end >= CCMDATARAM_BASE && start <= CCMDATARAM_END) {
+        return false;
+    }
+#else
+    (void)addr;
+    (void)length;
+#endif
+    return true;
+}
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+/* D-Cache行大小，F7为32字节 */
+#define DMA_DCACHE_LINE_SIZE            32U
+
+/* 将源缓冲区所在的D-Cache行写回内存，传输开始前调用 */
+static void dma_dcache_clean(const void *data, uint32_t len)
+{
+    uint32_t addr = (uint32_t)data & ~(DMA_DCACHE_LINE_SIZE - 1U);
+    
+    SCB_CleanDCache_by_Addr((uint32_t *)addr, (int32_t)((uint32_t)data + len - addr));
+}
+
+/* 作废目标缓冲区的D-Cache行，传输开始前和完成后各调用一次，目标须按缓存行对齐 */
+static void dma_dcache_invalidate(void *data, uint32_t len)
+{
+    SCB_InvalidateDCache_by_Addr((uint32_t *)data, (int32_t)len);
+}
+#endif
+
+/*
+ * 判断目标区间能否由DMA写入而不破坏D-Cache一致性。作废缓存行会丢弃同一行中
+ * 其他数据的修改，带D-Cache的内核上目标地址和长度须按缓存行对齐
+ */
+static bool dma_memcpy_cache_aligned(const void *dst, uint32_t length)
+{
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    return (((uint32_t)dst | length) & (DMA_DCACHE_LINE_SIZE - 1U)) == 0;
+#else
+    (void)dst;
+    (void)length;
+    return true;
+#endif
+}
+
+/* 设置内存拷贝数据流的数据宽度，源与目标宽度相同 */
+static void dma_memcpy_set_width(stm32_dma_device_t *dev, uint32_t width)
+{
+    MODIFY_REG(dev->hdma.Instance->CR, DMA_SxCR_PSIZE | DMA_SxCR_MSIZE,
+               width | (width << (DMA_SxCR_MSIZE_Pos - DMA_SxCR_PSIZE_Pos)));
+}
+
+/* 启动队头请求的下一个分块 */
+static int dma_memcpy_start_chunk(void)
+{
+    stm32_dma_device_t *dev = (stm32_dma_device_t *)g_dma_memcpy.handle;
+    dma_memcpy_request_t *req = &g_dma_memcpy.queue[g_dma_memcpy.head];
+    uint32_t src = (uint32_t)(req->src + g_dma_memcpy.offset);
+    uint32_t dst = (uint32_t)(req->dst + g_dma_memcpy.offset);
+    uint32_t remaining = req->length - g_dma_memcpy.offset;
+    uint32_t shift = 0;
+    
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    /* 请求的第一个分块启动前写回源数据，并作废目标中可能被逐出的缓存行 */
+    if (g_dma_memcpy.offset == 0) {
+        dma_dcache_clean(req->src, req->length);
+        dma_dcache_invalidate(req->dst, req->length);
+    }
+#endif
+    
+    /* 源和目标按字对齐时主体按32位传输，不足一个字的尾部由完成中断中的CPU拷贝补齐 */
+    if (((src | dst) & 3U) == 0) {
+        shift = 2;
+    } else if (((src | dst) & 1U) == 0) {
+        shift = 1;
+    }
+    
+    g_dma_memcpy.chunk = remaining & ~((1U << shift) - 1U);
+    if ((g_dma_memcpy.chunk >> shift) > STM32_DMA_MAX_ITEMS) {
+        g_dma_memcpy.chunk = STM32_DMA_MAX_ITEMS << shift;
+    }
+    
+    dma_memcpy_set_width(dev, shift == 2 ? DMA_PDATAALIGN_WORD :
+                              shift == 1 ? DMA_PDATAALIGN_HALFWORD : DMA_PDATAALIGN_BYTE);
+    dma_set_src_address(g_dma_memcpy.handle, src);
+    dma_set_dst_address(g_dma_memcpy.handle, dst);
+    dma_set_data_size(g_dma_memcpy.handle, g_dma_memcpy.chunk >> shift);
+    dma_enable_interrupt(g_dma_memcpy.handle);
+    
+    return dma_start(g_dma_memcpy.handle);
+}
+
+/* 结束队头请求并启动下一个请求 */
+static void dma_memcpy_finish(dma_status_t status)
+{
+    dma_memcpy_request_t req;
+    uint32_t primask;
+    
+    do {
+        req = g_dma_memcpy.queue[g_dma_memcpy.head];
+        
+        primask = dma_irq_lock();
+        g_dma_memcpy.head = (g_dma_memcpy.head + 1) % CONFIG_DMA_MEMCPY_QUEUE_SIZE;
+        g_dma_memcpy.count--;
+        g_dma_memcpy.offset = 0;
+        dma_irq_unlock(primask);
+        
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+        /* 丢弃传输期间预取的旧数据，回调中读到的是DMA写入的内容 */
+        dma_dcache_invalidate(req.dst, req.length);
+#endif
+        
+        if (req.callback != NULL) {
+            req.callback(req.user_data, status);
+        }
+        
+        if (g_dma_memcpy.count == 0) {
+            return;
+        }
+        
+        /* 后续请求启动失败时逐个以错误结束，避免队列停滞 */
+        status = (dma_memcpy_start_chunk() == DRIVER_OK) ? DMA_STATUS_BUSY : DMA_STATUS_ERROR;
+    } while (status == DMA_STATUS_ERROR);
+}
+
+/* 内存拷贝数据流完成回调，在中断上下文中调用 */
+static void dma_memcpy_irq_callback(void *arg, dma_status_t status)
+{
+    (void)arg;
+    
+    if (g_dma_memcpy.count == 0) {
+        return;
+    }
+    
+    if (status == DMA_STATUS_COMPLETE) {
+        dma_memcpy_request_t *req = &g_dma_memcpy.queue[g_dma_memcpy.head];
+        uint32_t remaining;
+        
+        g_dma_memcpy.offset += g_dma_memcpy.chunk;
+        remaining = req->length - g_dma_memcpy.offset;
+        
+        /* 主体按字或半字传输后剩余的尾部不足一个数据项，直接拷贝 */
+        if (remaining != 0 && remaining < 4U) {
+            memcpy(req->dst + g_dma_memcpy.offset, req->src + g_dma_memcpy.offset, remaining);
+            g_dma_memcpy.offset = req->length;
+        }
+        
+        if (g_dma_memcpy.offset < req->length) {
+            if (dma_memcpy_start_chunk() == DRIVER_OK) {
+                return;
+            }
+            status = DMA_STATUS_ERROR;
+        }
+    }
+    
+    dma_memcpy_finish(status);
+}
+
+/**
+ * @brief 初始化DMA内存拷贝引擎
+ * 
+ * 分配内存拷贝专用数据流；使用RTOS时同时创建阻塞拷贝的同步对象，
+ * 需在rtos_init之后调用。未初始化时dma_memcpy/dma_memcpy_async由CPU完成拷贝
+ * 
+ * @return int 0表示成功，非0表示失败
+ */
+int dma_memcpy_init(void)
+{
+    dma_handle_t handle;
+    stm32_dma_device_t *dev;
+    dma_config_t config;
+    int ret;
+    
+    if (g_dma_memcpy.handle != NULL) {
+        return ERROR_ALREADY_EXISTS;
+    }
+    
+#if (CURRENT_RTOS != RTOS_NONE)
+    if (rtos_sem_create(&g_dma_memcpy.done_sem, 0, 1) != 0) {
+        return ERROR_MEMORY;
+    }
+    
+    if (rtos_mutex_create(&g_dma_memcpy.sync_mutex) != 0) {
+        rtos_sem_delete(g_dma_memcpy.done_sem);
+        return ERROR_MEMORY;
+    }
+#endif
+    
+    memset(&config, 0, sizeof(config));
+    config.direction = DMA_DIR_MEM_TO_MEM;
+    config.mode = DMA_MODE_NORMAL;
+    config.priority = DMA_PRIORITY_LOW;     /* 让位于外设数据流 */
+    config.src_width = DMA_DATA_WIDTH_32BIT;
+    config.dst_width = DMA_DATA_WIDTH_32BIT;
+    config.src_inc = true;
+    config.dst_inc = true;
+    
+    ret = dma_alloc(STM32_DMA2_STREAM_MASK, DMA_REQUEST_ID_NONE, &config,
+                    dma_memcpy_irq_callback, NULL, &handle);
+    if (ret != DRIVER_OK) {
+#if (CURRENT_RTOS != RTOS_NONE)
+        rtos_mutex_delete(g_dma_memcpy.sync_mutex);
+        rtos_sem_delete(g_dma_memcpy.done_sem);
+#endif
+        return ret;
+    }
+    
+    /* 内存到内存传输不支持直接模式，必须启用FIFO */
+    dev = (stm32_dma_device_t *)handle;
+    dev->hdma.Init.FIFOMode = DMA_FIFOMODE_ENABLE;
+    dev->hdma.Instance->FCR = DMA_SxFCR_DMDIS | DMA_FIFO_THRESHOLD_FULL;
+    
+    dma_enable_irq(handle, CONFIG_DMA_MEMCPY_IRQ_PRIORITY);
+    
+    /* 数据流配置完成后再发布句柄 */
+    __atomic_store_n(&g_dma_memcpy.handle, handle, __ATOMIC_RELEASE);
+    
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 执行DMA内存拷贝(非阻塞)
+ * 
+ * 小于CONFIG_DMA_MEMCPY_MIN_SIZE的拷贝、DMA无法访问的地址区间、带D-Cache的
+ * 内核上未按32字节对齐的目标区间，以及引擎未初始化时由CPU立即完成，回调在
+ * 返回前被调用。其余请求按提交顺序由专用数据流执行，回调在中断上下文中调用。
+ * 
+ * @param dst_addr 目标地址
+ * @param src_addr 源地址
+ * @param length 长度(字节)
+ * @param callback 完成回调，可为NULL
+ * @param user_data 回调参数
+ * @return int 0表示成功，非0表示失败
+ */
+int dma_memcpy_async(void *dst_addr, const void *src_addr, uint32_t length,
+                     dma_callback_t callback, void *user_data)
+{
+    dma_memcpy_request_t *req;
+    uint32_t primask;
+    bool start;
+    
+    if (dst_addr == NULL || src_addr == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    if (length < CONFIG_DMA_MEMCPY_MIN_SIZE ||
+        !dma_memcpy_accessible(dst_addr, length) || !dma_memcpy_accessible(src_addr, length) ||
+        !dma_memcpy_cache_aligned(dst_addr, length) ||
+        __atomic_load_n(&g_dma_memcpy.handle, __ATOMIC_ACQUIRE) == NULL) {
+        memcpy(dst_addr, src_addr, length);
+        if (callback != NULL) {
+            callback(user_data, DMA_STATUS_COMPLETE);
+        }
+        return DRIVER_OK;
+    }
+    
+    primask = dma_irq_lock();
+    
+    if (g_dma_memcpy.count >= CONFIG_DMA_MEMCPY_QUEUE_SIZE) {
+        dma_irq_unlock(primask);
+        return ERROR_BUSY;
+    }
+    
+    req = &g_dma_memcpy.queue[(g_dma_memcpy.head + g_dma_memcpy.count) % CONFIG_DMA_MEMCPY_QUEUE_SIZE];
+    req->dst = (uint8_t *)dst_addr;
+    req->src = (const uint8_t *)src_addr;
+    req->length = length;
+    req->callback = callback;
+    req->user_data = user_data;
+    start = (g_dma_memcpy.count == 0);
+    g_dma_memcpy.count++;
+    
+    dma_irq_unlock(primask);
+    
+    /* 引擎空闲时由提交者启动，否则由上一个请求的完成中断接续 */
+    if (start && dma_memcpy_start_chunk() != DRIVER_OK) {
+        dma_memcpy_finish(DMA_STATUS_ERROR);
+    }
+    
+    return DRIVER_OK;
+}
+
+/* 阻塞拷贝的完成通知 */
+static void dma_memcpy_sync_callback(void *arg, dma_status_t status)
+{
+    *(volatile dma_status_t *)arg = status;
+    
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_sem_give(g_dma_memcpy.done_sem);
+#endif
+}
+
+/**
+ * @brief 执行DMA内存拷贝(阻塞)
+ * 
+ * 使用RTOS时调用线程阻塞在完成信号量上，裸机时CPU处于WFI睡眠。
+ * 引擎正忙时直接由CPU拷贝，不在队列后排队等待
+ * 
+ * @param dst_addr 目标地址
+ * @param src_addr 源地址
+ * @param length 长度(字节)
+ * @return int 0表示成功，非0表示失败
+ */
+int dma_memcpy(void *dst_addr, const void *src_addr, uint32_t length)
+{
+    volatile dma_status_t status = DMA_STATUS_BUSY;
+    
+    if (dst_addr == NULL || src_addr == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+#if (CURRENT_RTOS != RTOS_NONE)
+    /* 完成信号量只有一个接收者，已有阻塞拷贝在途时由CPU完成 */
+    if (__atomic_load_n(&g_dma_memcpy.handle, __ATOMIC_ACQUIRE) == NULL ||
+        rtos_mutex_lock(g_dma_memcpy.sync_mutex, 0) != 0) {
+        memcpy(dst_addr, src_addr, length);
+        return DRIVER_OK;
+    }
+#endif
+    
+    if (g_dma_memcpy.count != 0 ||
+        dma_memcpy_async(dst_addr, src_addr, length, dma_memcpy_sync_callback, (void *)&status) != DRIVER_OK) {
+        memcpy(dst_addr, src_addr, length);
+#if (CURRENT_RTOS != RTOS_NONE)
+        rtos_mutex_unlock(g_dma_memcpy.sync_mutex);
+#endif
+        return DRIVER_OK;
+    }
+    
+#if (CURRENT_RTOS != RTOS_NONE)
+    while (status == DMA_STATUS_BUSY) {
+        rtos_sem_take(g_dma_memcpy.done_sem, UINT32_MAX);
+    }
+    rtos_mutex_unlock(g_dma_memcpy.sync_mutex);
+#else
+    while (status == DMA_STATUS_BUSY) {
+        __WFI();
+    }
+#endif
+    
+    /* DMA传输错误时由CPU重新拷贝，保证调用返回时数据已就绪 */
+    if (status != DMA_STATUS_COMPLETE) {
+        memcpy(dst_addr, src_addr, length);
+    }
+    
+    return DRIVER_OK;
+}
+
 /**
  * @brief DMA1 Stream0中断处理函数
  */
@@ -0,0 +1,641 @@
+/**
+ * @file common_block_cache.c
+ * @brief 块设备扇区缓存实现（平台无关）
+ *
+ * 内存布局：缓存块数据位于内存起始处，其后依次为暂存区、缓存项和哈希桶。
+ * 哈希按块号低位取桶，顺序块均匀分布。LRU为双向链表，无效项总在链表尾部
+ * 附近被优先复用。淘汰到脏块时一次写回全部脏块，使写回总能按连续块合并；
+ * 读取填充缓存前先保证将被复用的缓存项都是干净的，因此暂存区不会在填充
+ * 过程中被写回占用。
+ */
+
+#include "base/block_cache_api.h"
+#include <string.h>
+
+#define BC_FLAG_VALID           0x01    /* 缓存项有效 */
+#define BC_FLAG_DIRTY           0x02    /* 缓存项已修改未写回 */
+#define BC_FLAG_READAHEAD       0x04    /* 预读载入，尚未被读取 */
+
+#if (CURRENT_RTOS != RTOS_NONE)
+#define BC_LOCK(cache)          rtos_mutex_lock((cache)->mutex, UINT32_MAX)
+#define BC_UNLOCK(cache)        rtos_mutex_unlock((cache)->mutex)
+#else
+#define BC_LOCK(cache)          ((void)0)
+#define BC_UNLOCK(cache)        ((void)0)
+#endif
+
+/* 缓存项数据地址 */
+static uint8_t *bc_data(const block_cache_t *cache, uint16_t index) {
+    return cache->data + (uint32_t)index * cache->config.device.block_size;
+}
+
+/**
+ * @brief 查找缓存块
+ *
+ * @return uint16_t 缓存项索引，未缓存时返回BLOCK_CACHE_NONE
+ */
+static uint16_t bc_lookup(const block_cache_t *cache, uint32_t block) {
+    uint16_t index = cache->buckets[block & cache->bucket_mask];
+
+    while (index != BLOCK_CACHE_NONE && cache->entries[index].block != block) {
+        index = cache->entries[index].hash_next;
+    }
+
+    return index;
+}
+
+/* 从哈希链中移除 */
+static void bc_hash_remove(block_cache_t *cache, uint16_t index) {
+    uint16_t *link = &cache->buckets[cache->entries[index].block & cache->bucket_mask];
+
+    while (*link != BLOCK_CACHE_NONE) {
+        if (*link == index) {
+            *link = cache->entries[index].hash_next;
+            return;
+        }
+        link = &cache->entries[*link].hash_next;
+    }
+}
+
+/* 加入哈希链 */
+static void bc_hash_insert(block_cache_t *cache, uint16_t index) {
+    uint16_t *bucket = &cache->buckets[cache->entries[index].block & cache->bucket_mask];
+
+    cache->entries[index].hash_next = *bucket;
+    *bucket = index;
+}
+
+/* 从LRU链表中摘下 */
+static void bc_lru_unlink(block_cache_t *cache, uint16_t index) {
+    block_cache_entry_t *entry = &cache->entries[index];
+
+    if (entry->lru_prev != BLOCK_CACHE_NONE) {
+        cache->entries[entry->lru_prev].lru_next = entry->lru_next;
+    } else {
+        cache->lru_head = entry->lru_next;
+    }
+
+    if (entry->lru_next != BLOCK_CACHE_NONE) {
+        cache->entries[entry->lru_next].lru_prev = entry->lru_prev;
+    } else {
+        cache->lru_tail = entry->lru_prev;
+    }
+}
+
+/* 移到LRU链表头部 */
+static void bc_touch(block_cache_t *cache, uint16_t index) {
+    block_cache_entry_t *entry = &cache->entries[index];
+
+    if (cache->lru_head == index) {
+        return;
+    }
+
+    bc_lru_unlink(cache, index);
+    entry->lru_prev = BLOCK_CACHE_NONE;
+    entry->lru_next = cache->lru_head;
+    cache->entries[cache->lru_head].lru_prev = index;
+    cache->lru_head = index;
+}
+
+/* 设备读取 */
+static int bc_device_read(block_cache_t *cache, uint32_t block, void *buffer, uint32_t count) {
+    cache->stats.device_reads++;
+
+    if (cache->config.device.read(cache->config.device.context, block, buffer, count) != 0) {
+        return BLOCK_CACHE_IO_ERROR;
+    }
+
+    return BLOCK_CACHE_OK;
+}
+
+/* 设备写入 */
+static int bc_device_write(block_cache_t *cache, uint32_t block, const void *buffer, uint32_t count) {
+    cache->stats.device_writes++;
+
+    if (cache->config.device.write(cache->config.device.context, block, buffer, count) != 0) {
+        return BLOCK_CACHE_IO_ERROR;
+    }
+
+    return BLOCK_CACHE_OK;
+}
+
+/**
+ * @brief 写回从指定脏块开始的连续脏块
+ *
+ * 有暂存区时把连续的脏块收集到暂存区后一次写入
+ */
+static int bc_writeback_run(block_cache_t *cache, uint16_t index) {
+    uint32_t block_size = cache->config.device.block_size;
+    uint32_t block = cache->entries[index].block;
+    uint32_t count = 1;
+    const uint8_t *source = bc_data(cache, index);
+    int ret;
+
+    if (cache->config.batch_blocks > 1) {
+        memcpy(cache->staging, source, block_size);
+        while (count < cache->config.batch_blocks && block + count < cache->config.device.block_count) {
+            uint16_t next = bc_lookup(cache, block + count);
+            if (next == BLOCK_CACHE_NONE || (cache->entries[next].flags & BC_FLAG_DIRTY) == 0) {
+                break;
+            }
+            memcpy(cache->staging + count * block_size, bc_data(cache, next), block_size);
+            count++;
+        }
+        source = cache->staging;
+    }
+
+    ret = bc_device_write(cache, block, source, count);
+    if (ret != BLOCK_CACHE_OK) {
+        return ret;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint16_t written = (i == 0) ? index : bc_lookup(cache, block + i);
+        cache->entries[written].flags &= (uint8_t)~BC_FLAG_DIRTY;
+    }
+    cache->dirty_count -= (uint16_t)count;
+    cache->stats.writebacks += count;
+
+    return BLOCK_CACHE_OK;
+}
+
+/**
+ * @brief 写回全部脏块
+ *
+ * 每一遍只从连续脏块的起点开始写回，起点的前一块不是脏块
+ */
+static int bc_writeback_all(block_cache_t *cache) {
+    int ret;
+
+    while (cache->dirty_count > 0) {
+        for (uint16_t i = 0; i < cache->entry_count; i++) {
+            block_cache_entry_t *entry = &cache->entries[i];
+
+            if ((entry->flags & BC_FLAG_DIRTY) == 0) {
+                continue;
+            }
+
+            if (entry->block > 0) {
+                uint16_t prev = bc_lookup(cache, entry->block - 1);
+                if (prev != BLOCK_CACHE_NONE && (cache->entries[prev].flags & BC_FLAG_DIRTY) != 0) {
+                    continue;
+                }
+            }
+
+            ret = bc_writeback_run(cache, i);
+            if (ret != BLOCK_CACHE_OK) {
+                return ret;
+            }
+        }
+    }
+
+    return BLOCK_CACHE_OK;
+}
+
+/**
+ * @brief 保证LRU尾部将被复用的count个缓存项都是干净的
+ */
+static int bc_reserve(block_cache_t *cache, uint32_t count) {
+    uint16_t index = cache->lru_tail;
+
+    for (uint32_t i = 0; i < count && index != BLOCK_CACHE_NONE; i++) {
+        if ((cache->entries[index].flags & BC_FLAG_DIRTY) != 0) {
+            return bc_writeback_all(cache);
+        }
+        index = cache->entries[index].lru_prev;
+    }
+
+    return BLOCK_CACHE_OK;
+}
+
+/**
+ * @brief 复用LRU尾部的缓存项存放指定块
+ *
+ * @param cache 缓存对象
+ * @param block 块号，调用者保证尚未缓存
+ * @param index 缓存项索引输出
+ * @return int 0表示成功，非0表示写回失败
+ */
+static int bc_alloc(block_cache_t *cache, uint32_t block, uint16_t *index) {
+    uint16_t victim = cache->lru_tail;
+    block_cache_entry_t *entry = &cache->entries[victim];
+    int ret;
+
+    if ((entry->flags & BC_FLAG_DIRTY) != 0) {
+        ret = bc_writeback_all(cache);
+        if (ret != BLOCK_CACHE_OK) {
+            return ret;
+        }
+    }
+
+    if ((entry->flags & BC_FLAG_VALID) != 0) {
+        bc_hash_remove(cache, victim);
+        cache->stats.evictions++;
+    }
+
+    entry->block = block;
+    entry->flags = BC_FLAG_VALID;
+    bc_hash_insert(cache, victim);
+    bc_touch(cache, victim);
+    *index = victim;
+
+    return BLOCK_CACHE_OK;
+}
+
+/**
+ * @brief 把刚从设备读出的连续块放入缓存
+ *
+ * 调用前已由bc_reserve保证复用的缓存项都是干净的
+ */
+static void bc_insert_range(block_cache_t *cache, uint32_t block, const uint8_t *source,
+                            uint32_t count, uint8_t flags) {
+    uint32_t block_size = cache->config.device.block_size;
+    uint16_t index;
+
+    for (uint32_t i = 0; i < count; i++) {
+        (void)bc_alloc(cache, block + i, &index);
+        cache->entries[index].flags |= flags;
+        memcpy(bc_data(cache, index), source + i * block_size, block_size);
+    }
+}
+
+/**
+ * @brief 读取一段连续的未命中块并放入缓存，顺带预读其后的块
+ *
+ * 预读块与未命中块能一起放入暂存区时用一次设备读取完成
+ */
+static int bc_fill(block_cache_t *cache, uint32_t block, uint32_t count, uint8_t *buffer, uint32_t readahead) {
+    uint32_t block_size = cache->config.device.block_size;
+    uint32_t end = block + count;
+    uint32_t limit = cache->config.device.block_count - end;
+    int ret;
+
+    /* 预读不越过设备末尾，遇到已缓存的块停止，且不挤出本次读取的块 */
+    if (readahead > limit) {
+        readahead = limit;
+    }
+    if (readahead > (uint32_t)cache->entry_count - count) {
+        readahead = (uint32_t)cache->entry_count - count;
+    }
+    for (uint32_t i = 0; i < readahead; i++) {
+        if (bc_lookup(cache, end + i) != BLOCK_CACHE_NONE) {
+            readahead = i;
+            break;
+        }
+    }
+
+    ret = bc_reserve(cache, count + readahead);
+    if (ret != BLOCK_CACHE_OK) {
+        return ret;
+    }
+
+    if (readahead > 0 && count + readahead <= cache->config.batch_blocks) {
+        ret = bc_device_read(cache, block, cache->staging, count + readahead);
+        if (ret != BLOCK_CACHE_OK) {
+            return ret;
+        }
+        memcpy(buffer, cache->staging, count * block_size);
+        bc_insert_range(cache, block, cache->staging, count, 0);
+        bc_insert_range(cache, end, cache->staging + count * block_size, readahead, BC_FLAG_READAHEAD);
+    } else {
+        ret = bc_device_read(cache, block, buffer, count);
+        if (ret != BLOCK_CACHE_OK) {
+            return ret;
+        }
+        bc_insert_range(cache, block, buffer, count, 0);
+
+        if (readahead > cache->config.batch_blocks) {
+            readahead = cache->config.batch_blocks;
+        }
+        if (readahead > 0) {
+            ret = bc_device_read(cache, end, cache->staging, readahead);
+            if (ret != BLOCK_CACHE_OK) {
+                return ret;
+            }
+            bc_insert_range(cache, end, cache->staging, readahead, BC_FLAG_READAHEAD);
+        }
+    }
+
+    cache->stats.misses += count;
+    cache->stats.readahead_blocks += readahead;
+
+    return BLOCK_CACHE_OK;
+}
+
+/* 检查块范围 */
+static bool bc_range_valid(const block_cache_t *cache, uint32_t block, uint32_t count) {
+    uint32_t total = cache->config.device.block_count;
+
+    return block < total && count <= total - block;
+}
+
+/**
+ * @brief 初始化块缓存
+ */
+int block_cache_init(block_cache_t *cache, const block_cache_config_t *config) {
+    const block_cache_device_t *device;
+    uint32_t staging_size;
+    uint32_t entry_cost;
+    uint32_t count;
+    uint32_t buckets = 1;
+
+    if (cache == NULL || config == NULL || config->memory == NULL ||
+        ((uintptr_t)config->memory % 4) != 0) {
+        return BLOCK_CACHE_INVALID_PARAM;
+    }
+
+    device = &config->device;
+    if (device->read == NULL || device->block_size == 0 || (device->block_size % 4) != 0 ||
+        device->block_count == 0) {
+        return BLOCK_CACHE_INVALID_PARAM;
+    }
+
+    /* 每个缓存项占用块数据、缓存项和最多两个哈希桶 */
+    staging_size = (uint32_t)config->batch_blocks * device->block_size;
+    if (staging_size >= config->memory_size) {
+        return BLOCK_CACHE_NO_MEMORY;
+    }
+    entry_cost = device->block_size + sizeof(block_cache_entry_t) + 2 * sizeof(uint16_t);
+    count = (config->memory_size - staging_size) / entry_cost;
+    if (count < 2) {
+        return BLOCK_CACHE_NO_MEMORY;
+    }
+    if (count > BLOCK_CACHE_NONE - 1) {
+        count = BLOCK_CACHE_NONE - 1;
+    }
+    while (buckets < count) {
+        buckets <<= 1;
+    }
+
+    memset(cache, 0, sizeof(block_cache_t));
+    cache->config = *config;
+    cache->entry_count = (uint16_t)count;
+    cache->bucket_mask = (uint16_t)(buckets - 1);
+    cache->data = (uint8_t *)config->memory;
+    cache->staging = cache->data + count * device->block_size;
+    cache->entries = (block_cache_entry_t *)(void *)(cache->staging + staging_size);
+    cache->buckets = (uint16_t *)(void *)(cache->entries + count);
+
+    /* 经过缓存的单次读写不超过缓存块数，避免挤出本次请求自身的块 */
+    if (config->bypass_blocks == 0) {
+        cache->bypass_blocks = (uint16_t)(count / 2);
+    } else if (config->bypass_blocks > count) {
+        cache->bypass_blocks = (uint16_t)count;
+    } else {
+        cache->bypass_blocks = config->bypass_blocks;
+    }
+
+    for (uint32_t i = 0; i < buckets; i++) {
+        cache->buckets[i] = BLOCK_CACHE_NONE;
+    }
+
+    for (uint16_t i = 0; i < count; i++) {
+        cache->entries[i].flags = 0;
+        cache->entries[i].hash_next = BLOCK_CACHE_NONE;
+        cache->entries[i].lru_prev = (i == 0) ? BLOCK_CACHE_NONE : (uint16_t)(i - 1);
+        cache->entries[i].lru_next = (i == count - 1) ? BLOCK_CACHE_NONE : (uint16_t)(i + 1);
+    }
+    cache->lru_head = 0;
+    cache->lru_tail = (uint16_t)(count - 1);
+    cache->next_sequential = UINT32_MAX;
+
+#if (CURRENT_RTOS != RTOS_NONE)
+    if (rtos_mutex_create(&cache->mutex) != 0) {
+        return BLOCK_CACHE_NO_MEMORY;
+    }
+#endif
+
+    cache->initialized = true;
+
+    return BLOCK_CACHE_OK;
+}
+
+/**
+ * @brief 写回所有脏块并释放缓存
+ */
+int block_cache_deinit(block_cache_t *cache) {
+    int ret;
+
+    if (cache == NULL || !cache->initialized) {
+        return BLOCK_CACHE_INVALID_PARAM;
+    }
+
+    ret = block_cache_flush(cache);
+
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_mutex_delete(cache->mutex);
+#endif
+
+    cache->initialized = false;
+
+    return ret;
+}
+
+/**
+ * @brief 读取块
+ */
+int block_cache_read(block_cache_t *cache, uint32_t block, void *buffer, uint32_t count) {
+    uint32_t block_size;
+    uint8_t *output = (uint8_t *)buffer;
+    uint32_t readahead = 0;
+    int ret = BLOCK_CACHE_OK;
+
+    if (cache == NULL || !cache->initialized || buffer == NULL || !bc_range_valid(cache, block, count)) {
+        return BLOCK_CACHE_INVALID_PARAM;
+    }
+
+    BC_LOCK(cache);
+
+    block_size = cache->config.device.block_size;
+
+    /* 紧接上次读取时视为顺序读取，预读窗口逐次加倍 */
+    if (block == cache->next_sequential && cache->config.batch_blocks > 0) {
+        readahead = (cache->readahead > 0) ? (uint32_t)cache->readahead * 2 : count;
+        if (readahead > cache->config.batch_blocks) {
+            readahead = cache->config.batch_blocks;
+        }
+    }
+    cache->readahead = (uint16_t)readahead;
+    cache->next_sequential = block + count;
+
+    if (count >= cache->bypass_blocks) {
+        /* 大块读取直接访问设备，再用较新的脏块覆盖 */
+        ret = bc_device_read(cache, block, output, count);
+        if (ret == BLOCK_CACHE_OK) {
+            for (uint32_t i = 0; i < count; i++) {
+                uint16_t index = bc_lookup(cache, block + i);
+                if (index != BLOCK_CACHE_NONE && (cache->entries[index].flags & BC_FLAG_DIRTY) != 0) {
+                    memcpy(output + i * block_size, bc_data(cache, index), block_size);
+                }
+            }
+            cache->stats.bypass_blocks += count;
+        }
+
+        BC_UNLOCK(cache);
+        return ret;
+    }
+
+    for (uint32_t i = 0; i < count && ret == BLOCK_CACHE_OK; ) {
+        uint16_t index = bc_lookup(cache, block + i);
+        uint32_t run = 1;
+
+        if (index != BLOCK_CACHE_NONE) {
+            block_cache_entry_t *entry = &cache->entries[index];
+
+            if ((entry->flags & BC_FLAG_READAHEAD) != 0) {
+                entry->flags &= (uint8_t)~BC_FLAG_READAHEAD;
+                cache->stats.readahead_hits++;
+            }
+            memcpy(output + i * block_size, bc_data(cache, index), block_size);
+            bc_touch(cache, index);
+            cache->stats.hits++;
+            i++;
+            continue;
+        }
+
+        /* 连续的未命中块一次读取，只在请求末尾预读 */
+        while (i + run < count && bc_lookup(cache, block + i + run) == BLOCK_CACHE_NONE) {
+            run++;
+        }
+
+        ret = bc_fill(cache, block + i, run, output + i * block_size, (i + run == count) ? readahead : 0);
+        i += run;
+    }
+
+    BC_UNLOCK(cache);
+
+    return ret;
+}
+
+/**
+ * @brief 写入块
+ */
+int block_cache_write(block_cache_t *cache, uint32_t block, const void *buffer, uint32_t count) {
+    uint32_t block_size;
+    const uint8_t *input = (const uint8_t *)buffer;
+    int ret = BLOCK_CACHE_OK;
+
+    if (cache == NULL || !cache->initialized || buffer == NULL || !bc_range_valid(cache, block, count)) {
+        return BLOCK_CACHE_INVALID_PARAM;
+    }
+
+    if (cache->config.device.write == NULL) {
+        return BLOCK_CACHE_READ_ONLY;
+    }
+
+    BC_LOCK(cache);
+
+    block_size = cache->config.device.block_size;
+
+    if (count >= cache->bypass_blocks) {
+        /* 大块写入直接写设备，已缓存的副本更新为新数据并成为干净块 */
+        ret = bc_device_write(cache, block, input, count);
+        if (ret == BLOCK_CACHE_OK) {
+            for (uint32_t i = 0; i < count; i++) {
+                uint16_t index = bc_lookup(cache, block + i);
+                if (index == BLOCK_CACHE_NONE) {
+                    continue;
+                }
+                memcpy(bc_data(cache, index), input + i * block_size, block_size);
+                if ((cache->entries[index].flags & BC_FLAG_DIRTY) != 0) {
+                    cache->entries[index].flags &= (uint8_t)~BC_FLAG_DIRTY;
+                    cache->dirty_count--;
+                }
+            }
+            cache->stats.bypass_blocks += count;
+        }
+
+        BC_UNLOCK(cache);
+        return ret;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint16_t index = bc_lookup(cache, block + i);
+        block_cache_entry_t *entry;
+
+        if (index == BLOCK_CACHE_NONE) {
+            ret = bc_alloc(cache, block + i, &index);
+            if (ret != BLOCK_CACHE_OK) {
+                break;
+            }
+        } else {
+            bc_touch(cache, index);
+        }
+
+        entry = &cache->entries[index];
+        memcpy(bc_data(cache, index), input + i * block_size, block_size);
+        if ((entry->flags & BC_FLAG_DIRTY) == 0) {
+            entry->flags |= BC_FLAG_DIRTY;
+            cache->dirty_count++;
+        }
+        entry->flags &= (uint8_t)~BC_FLAG_READAHEAD;
+    }
+
+    BC_UNLOCK(cache);
+
+    return ret;
+}
+
+/**
+ * @brief 写回所有脏块并等待落盘
+ */
+int block_cache_flush(block_cache_t *cache) {
+    int ret;
+
+    if (cache == NULL || !cache->initialized) {
+        return BLOCK_CACHE_INVALID_PARAM;
+    }
+
+    BC_LOCK(cache);
+
+    ret = bc_writeback_all(cache);
+    if (ret == BLOCK_CACHE_OK && cache->config.device.sync != NULL &&
+        cache->config.device.sync(cache->config.device.context) != 0) {
+        ret = BLOCK_CACHE_IO_ERROR;
+    }
+
+    BC_UNLOCK(cache);
+
+    return ret;
+}
+
+/**
+ * @brief 丢弃所有缓存块
+ */
+int block_cache_invalidate(block_cache_t *cache) {
+    if (cache == NULL || !cache->initialized) {
+        return BLOCK_CACHE_INVALID_PARAM;
+    }
+
+    BC_LOCK(cache);
+
+    for (uint32_t i = 0; i <= cache->bucket_mask; i++) {
+        cache->buckets[i] = BLOCK_CACHE_NONE;
+    }
+    for (uint16_t i = 0; i < cache->entry_count; i++) {
+        cache->entries[i].flags = 0;
+        cache->entries[i].hash_next = BLOCK_CACHE_NONE;
+    }
+    cache->dirty_count = 0;
+    cache->readahead = 0;
+    cache->next_sequential = UINT32_MAX;
+
+    BC_UNLOCK(cache);
+
+    return BLOCK_CACHE_OK;
+}
+
+/**
+ * @brief 获取统计信息
+ */
+int block_cache_get_stats(block_cache_t *cache, block_cache_stats_t *stats) {
+    if (cache == NULL || !cache->initialized || stats == NULL) {
+        return BLOCK_CACHE_INVALID_PARAM;
+    }
+
+    BC_LOCK(cache);
+    *stats = cache->stats;
+    BC_UNLOCK(cache);
+
+    return BLOCK_CACHE_OK;
+}
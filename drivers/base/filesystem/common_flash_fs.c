@@ -0,0 +1,2619 @@
+/**
+ * @file common_flash_fs.c
+ * @brief Flash写时复制文件系统实现（平台无关）
+ *
+ * 块0和块1组成锚点块对，只记录超级块；超级块指向保存全部目录项的元数据
+ * 块对。块对中的每个块是一个追加日志：块首为修订号，之后是若干次提交，每次
+ * 提交由若干标签和一个CRC标签组成。标签为32位{类型:8, 编号:12, 长度:12}，
+ * 数据按4字节对齐。挂载时取两块中修订号较新且至少有一次完整提交的块，CRC
+ * 不符的提交及其之后的内容被忽略。日志写满时把有效目录项压缩写入另一块并
+ * 递增修订号；修订号每到block_cycles的倍数时，元数据块对迁移到新分配的
+ * 两块，新位置作为一次提交写入锚点。
+ *
+ * 文件数据使用CTZ跳表：文件第n块(n>0)开头保存ctz(n)+1个指针，第i个指针
+ * 指向第n-2^i块，从末块出发按对数步数定位任意偏移。写入总是写到新块，整块
+ * 前缀在新旧版本之间共享，未满的尾块复制后续写；在文件末尾追加且尾块剩余
+ * 空间仍为擦除状态时直接续写。新的头块和大小在fs_flush或fs_close时作为一次
+ * 提交写入元数据。不超过缓存大小的文件内联在元数据中。
+ *
+ * 分配器在前瞻窗口内用位图记录已用块，窗口耗尽后遍历所有块链表重建下一个
+ * 窗口，从挂载时的伪随机起点在整个分区上循环分配，使各块磨损均衡。
+ */
+
+#include "base/flash_fs_api.h"
+#include <string.h>
+
+#define FFS_MAGIC               0x53464346UL    /* "FCFS" */
+#define FFS_VERSION             1
+#define FFS_ERASED_WORD         0xFFFFFFFFUL
+#define FFS_BLOCK_NONE          0xFFFFFFFFUL
+#define FFS_ID_NONE             0xFFF
+#define FFS_ROOT_ID             0
+#define FFS_MIN_BLOCK_SIZE      512
+#define FFS_MIN_BLOCK_COUNT     6
+#define FFS_FILE_MAX            0x7FFFFFFFUL
+
+/* 标签类型 */
+#define FFS_TAG_SUPER           0x01    /* 超级块 */
+#define FFS_TAG_NAME            0x10    /* 目录项名称与父目录 */
+#define FFS_TAG_CTZ             0x20    /* CTZ跳表头块与文件大小 */
+#define FFS_TAG_INLINE          0x21    /* 内联文件数据 */
+#define FFS_TAG_DELETE          0x30    /* 删除目录项 */
+#define FFS_TAG_CRC             0x7F    /* 提交结束，数据为CRC32 */
+
+#define FFS_TAG(type, id, len)  (((uint32_t)(type) << 24) | ((uint32_t)(id) << 12) | (uint32_t)(len))
+#define FFS_TAG_TYPE(tag)       ((uint8_t)((tag) >> 24))
+#define FFS_TAG_ID(tag)         ((uint16_t)(((tag) >> 12) & 0xFFF))
+#define FFS_TAG_LEN(tag)        ((uint16_t)((tag) & 0xFFF))
+
+#define FFS_ALIGN4(x)           (((x) + 3U) & ~3U)
+#define FFS_MIN(a, b)           ((a) < (b) ? (a) : (b))
+
+/* 目录项类型 */
+#define FFS_TYPE_NONE           0
+#define FFS_TYPE_FILE           1
+#define FFS_TYPE_DIR            2
+
+/* 目录项标志 */
+#define FFS_ENTRY_INLINE        0x01    /* 数据内联在元数据中 */
+
+/* 文件状态标志 */
+#define FFS_FILE_WRITING        0x01    /* 写入会话进行中，block/off为写入位置 */
+#define FFS_FILE_READING        0x02    /* block/off为读取位置 */
+#define FFS_FILE_DIRTY          0x04    /* 头块或大小尚未提交 */
+#define FFS_FILE_INLINE         0x08    /* 数据内联在缓存中 */
+#define FFS_FILE_ERRED          0x10    /* 写入失败，不再提交 */
+
+#if (CURRENT_RTOS != RTOS_NONE)
+#define FFS_LOCK(fs)            rtos_mutex_lock((fs)->mutex, UINT32_MAX)
+#define FFS_UNLOCK(fs)          rtos_mutex_unlock((fs)->mutex)
+#else
+#define FFS_LOCK(fs)            ((void)(fs))
+#define FFS_UNLOCK(fs)          ((void)(fs))
+#endif
+
+/* 超级块 */
+typedef struct {
+    uint32_t magic;             /* 魔数 */
+    uint32_t version;           /* 格式版本 */
+    uint32_t block_size;        /* 块大小 */
+    uint32_t block_count;       /* 块数量 */
+    uint32_t meta[2];           /* 元数据块对 */
+} ffs_super_t;
+
+/* 名称标签头，其后为名称 */
+typedef struct {
+    uint16_t parent;            /* 父目录编号 */
+    uint8_t type;               /* 目录项类型 */
+    uint8_t name_len;           /* 名称长度 */
+} ffs_name_t;
+
+/* CTZ标签数据 */
+typedef struct {
+    uint32_t head;              /* 头块 */
+    uint32_t size;              /* 文件大小 */
+} ffs_ctz_t;
+
+/* 待提交的标签 */
+typedef struct {
+    uint8_t type;               /* 标签类型 */
+    uint16_t id;                /* 目录项编号 */
+    uint16_t len;               /* 数据长度 */
+    const void *data;           /* 数据 */
+} ffs_attr_t;
+
+/* 目录项索引 */
+typedef struct {
+    uint32_t head;              /* CTZ头块，内联文件为数据在元数据块内的偏移 */
+    uint32_t size;              /* 文件大小 */
+    uint32_t name_off;          /* 名称在元数据块内的偏移 */
+    uint32_t hash;              /* 名称哈希 */
+    uint16_t parent;            /* 父目录编号 */
+    uint8_t type;               /* 目录项类型 */
+    uint8_t flags;              /* 目录项标志 */
+    uint8_t name_len;           /* 名称长度 */
+} ffs_entry_t;
+
+/* 日志块对 */
+typedef struct {
+    uint32_t blocks[2];         /* 两个块 */
+    uint32_t rev;               /* 当前块修订号 */
+    uint32_t end;               /* 最后一次完整提交的结束偏移 */
+    uint8_t active;             /* 当前块 */
+    bool needs_compact;         /* 日志末尾有残留数据，下次提交前必须压缩 */
+} ffs_pair_t;
+
+/* 提交写入位置 */
+typedef struct {
+    uint32_t block;             /* 块号 */
+    uint32_t off;               /* 块内偏移 */
+    uint32_t crc;               /* 本次提交的CRC */
+} ffs_commit_t;
+
+struct ffs;
+
+/* 打开的文件 */
+typedef struct {
+    struct ffs *fs;                             /* 所属文件系统 */
+    bool used;                                  /* 是否使用中 */
+    uint16_t id;                                /* 目录项编号 */
+    uint8_t mode;                               /* 打开模式 */
+    uint8_t flags;                              /* 状态标志 */
+    uint32_t head;                              /* 当前版本头块 */
+    uint32_t size;                              /* 当前版本大小 */
+    uint32_t pos;                               /* 读写位置 */
+    uint32_t block;                             /* 读写位置所在块 */
+    uint32_t off;                               /* 读写位置块内偏移 */
+    uint32_t cache_block;                       /* 缓存对应的块 */
+    uint32_t cache_off;                         /* 缓存对应的块内偏移 */
+    uint32_t cache_len;                         /* 缓存中待编程的字节数 */
+    uint8_t cache[CONFIG_FLASH_FS_CACHE_SIZE];  /* 编程缓存，内联文件的数据 */
+} ffs_file_t;
+
+/* 打开的目录 */
+typedef struct {
+    struct ffs *fs;             /* 所属文件系统 */
+    bool used;                  /* 是否使用中 */
+    uint16_t id;                /* 目录编号 */
+    uint16_t next;              /* 下一个待检查的目录项编号 */
+} ffs_dir_t;
+
+/* 文件系统 */
+typedef struct ffs {
+    flash_fs_config_t config;                               /* 分区配置 */
+    char path[64];                                          /* 挂载路径 */
+    fs_type_t type;                                         /* 文件系统类型 */
+    uint32_t sector_size;                                   /* Flash扇区大小 */
+    ffs_super_t super;                                      /* 超级块 */
+    ffs_pair_t anchor;                                      /* 锚点块对 */
+    ffs_pair_t meta;                                        /* 元数据块对 */
+    ffs_entry_t entries[CONFIG_FLASH_FS_MAX_ENTRIES];       /* 目录项索引 */
+    uint32_t lookahead[CONFIG_FLASH_FS_LOOKAHEAD / 32];     /* 前瞻窗口位图 */
+    uint32_t la_start;                                      /* 窗口起始块 */
+    uint32_t la_size;                                       /* 窗口块数 */
+    uint32_t la_off;                                        /* 窗口内下一个检查位置 */
+    uint32_t la_seen;                                       /* 上次成功分配后检查过的已用块数 */
+    uint32_t pending[2];                                    /* 已分配尚未被引用的块 */
+    uint8_t buffer[CONFIG_FLASH_FS_CACHE_SIZE];             /* 读取与复制缓冲区 */
+    ffs_file_t files[CONFIG_FLASH_FS_MAX_OPEN_FILES];       /* 打开的文件 */
+    ffs_dir_t dirs[CONFIG_FLASH_FS_MAX_OPEN_DIRS];          /* 打开的目录 */
+    flash_fs_stats_t stats;                                 /* 统计信息 */
+    bool mounted;                                           /* 是否已挂载 */
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_mutex_t mutex;                                     /* 互斥锁 */
+#endif
+} ffs_t;
+
+/* 块遍历回调 */
+typedef void (*ffs_block_visit_t)(ffs_t *fs, uint32_t block, void *arg);
+
+/* 标签重放回调 */
+typedef int (*ffs_tag_visit_t)(ffs_t *fs, uint32_t tag, uint32_t data_off);
+
+/* 文件系统实例 */
+static ffs_t g_ffs_mounts[CONFIG_FLASH_FS_MAX_MOUNTS];
+
+/* 补零写入使用的数据 */
+static const uint8_t g_ffs_zeros[16] = {0};
+
+/**
+ * @brief 计算CRC32(IEEE 802.3)，使用半字节查找表
+ */
+static uint32_t ffs_crc32(uint32_t crc, const void *data, uint32_t len) {
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc = table[(crc ^ bytes[i]) & 0x0F] ^ (crc >> 4);
+        crc = table[(crc ^ (bytes[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+
+    return ~crc;
+}
+
+/**
+ * @brief 计算名称哈希(FNV-1a)
+ */
+static uint32_t ffs_hash(const char *name, uint32_t len) {
+    uint32_t hash = 2166136261UL;
+
+    for (uint32_t i = 0; i < len; i++) {
+        hash = (hash ^ (uint8_t)name[i]) * 16777619UL;
+    }
+
+    return hash;
+}
+
+/* 末尾0的个数，x不为0 */
+static uint32_t ffs_ctz(uint32_t x) {
+    uint32_t n = 0;
+
+    while ((x & 1) == 0) {
+        x >>= 1;
+        n++;
+    }
+
+    return n;
+}
+
+/* 置位数 */
+static uint32_t ffs_popc(uint32_t x) {
+    uint32_t n = 0;
+
+    while (x != 0) {
+        x &= x - 1;
+        n++;
+    }
+
+    return n;
+}
+
+/* 不小于x的最小2的幂的指数 */
+static uint32_t ffs_npw2(uint32_t x) {
+    uint32_t n = 0;
+
+    while (n < 32 && (1UL << n) < x) {
+        n++;
+    }
+
+    return n;
+}
+
+/* 块地址 */
+static uint32_t ffs_block_address(const ffs_t *fs, uint32_t block, uint32_t off) {
+    return fs->config.base_address + block * fs->config.block_size + off;
+}
+
+/**
+ * @brief 读取块内数据
+ *
+ * 打开文件编程缓存中尚未写入的数据覆盖读取结果，使分配器遍历能读到其他文件
+ * 新块中还在缓存里的跳表指针
+ */
+static int ffs_bd_read(ffs_t *fs, uint32_t block, uint32_t off, void *data, uint32_t len) {
+    if (block >= fs->config.block_count || off + len > fs->config.block_size) {
+        return ERROR_CRC;
+    }
+
+    if (flash_read(fs->config.flash, ffs_block_address(fs, block, off), data, len) != 0) {
+        return ERROR_IO;
+    }
+
+    for (uint8_t i = 0; i < CONFIG_FLASH_FS_MAX_OPEN_FILES; i++) {
+        const ffs_file_t *file = &fs->files[i];
+        uint32_t start;
+        uint32_t end;
+
+        if (!file->used || file->cache_len == 0 || file->cache_block != block) {
+            continue;
+        }
+        start = (off > file->cache_off) ? off : file->cache_off;
+        end = FFS_MIN(off + len, file->cache_off + file->cache_len);
+        if (start < end) {
+            memcpy((uint8_t *)data + (start - off), file->cache + (start - file->cache_off), end - start);
+        }
+    }
+
+    return ERROR_NONE;
+}
+
+/* 编程块内数据，偏移和长度按4字节对齐 */
+static int ffs_bd_prog(ffs_t *fs, uint32_t block, uint32_t off, const void *data, uint32_t len) {
+    if (flash_write(fs->config.flash, ffs_block_address(fs, block, off), data, len) != 0) {
+        return ERROR_IO;
+    }
+
+    return ERROR_NONE;
+}
+
+/* 擦除块 */
+static int ffs_bd_erase(ffs_t *fs, uint32_t block) {
+    for (uint32_t off = 0; off < fs->config.block_size; off += fs->sector_size) {
+        if (flash_erase_sector(fs->config.flash, ffs_block_address(fs, block, off)) != 0) {
+            return ERROR_IO;
+        }
+    }
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 检查块内从off开始到块末尾是否都是擦除状态
+ */
+static bool ffs_bd_erased_from(ffs_t *fs, uint32_t block, uint32_t off) {
+    while (off < fs->config.block_size) {
+        uint32_t len = FFS_MIN(fs->config.block_size - off, (uint32_t)sizeof(fs->buffer));
+
+        if (ffs_bd_read(fs, block, off, fs->buffer, len) != ERROR_NONE) {
+            return false;
+        }
+        for (uint32_t i = 0; i < len; i++) {
+            if (fs->buffer[i] != 0xFF) {
+                return false;
+            }
+        }
+        off += len;
+    }
+
+    return true;
+}
+
+/*===========================================================================*/
+/* 日志块对                                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief 编程提交数据并累计CRC，长度不足4字节的部分以0xFF填充
+ */
+static int ffs_commit_prog(ffs_t *fs, ffs_commit_t *commit, const void *data, uint32_t len) {
+    const uint8_t *src = (const uint8_t *)data;
+    uint32_t whole = len & ~3U;
+    int ret;
+
+    if (commit->off + FFS_ALIGN4(len) > fs->config.block_size) {
+        return ERROR_FULL;
+    }
+
+    if (whole > 0) {
+        ret = ffs_bd_prog(fs, commit->block, commit->off, src, whole);
+        if (ret != ERROR_NONE) {
+            return ret;
+        }
+        commit->crc = ffs_crc32(commit->crc, src, whole);
+        commit->off += whole;
+    }
+
+    if (len > whole) {
+        uint8_t word[4] = {0xFF, 0xFF, 0xFF, 0xFF};
+
+        memcpy(word, src + whole, len - whole);
+        ret = ffs_bd_prog(fs, commit->block, commit->off, word, sizeof(word));
+        if (ret != ERROR_NONE) {
+            return ret;
+        }
+        commit->crc = ffs_crc32(commit->crc, word, sizeof(word));
+        commit->off += sizeof(word);
+    }
+
+    return ERROR_NONE;
+}
+
+/* 编程一个标签及其数据 */
+static int ffs_commit_attr(ffs_t *fs, ffs_commit_t *commit, uint8_t type, uint16_t id,
+                           const void *data, uint16_t len) {
+    uint32_t tag = FFS_TAG(type, id, len);
+    int ret;
+
+    ret = ffs_commit_prog(fs, commit, &tag, sizeof(tag));
+    if (ret == ERROR_NONE && len > 0) {
+        ret = ffs_commit_prog(fs, commit, data, len);
+    }
+
+    return ret;
+}
+
+/* 编程CRC标签结束本次提交，CRC覆盖提交起点到CRC标签 */
+static int ffs_commit_crc(ffs_t *fs, ffs_commit_t *commit) {
+    uint32_t tag = FFS_TAG(FFS_TAG_CRC, FFS_ID_NONE, 4);
+    uint32_t crc;
+    int ret;
+
+    ret = ffs_commit_prog(fs, commit, &tag, sizeof(tag));
+    if (ret != ERROR_NONE) {
+        return ret;
+    }
+
+    crc = commit->crc;
+    ret = ffs_commit_prog(fs, commit, &crc, sizeof(crc));
+    commit->crc = 0;
+
+    return ret;
+}
+
+/* 标签集合占用的日志空间 */
+static uint32_t ffs_attrs_size(const ffs_attr_t *attrs, uint32_t count) {
+    uint32_t size = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        size += 4 + FFS_ALIGN4(attrs[i].len);
+    }
+
+    return size;
+}
+
+/**
+ * @brief 校验块中的提交
+ *
+ * 第一次提交的CRC从修订号开始计算，之后每次提交从上一次提交结束处开始
+ *
+ * @param fs 文件系统
+ * @param block 块号
+ * @param rev 修订号输出
+ * @param end 最后一次完整提交的结束偏移输出，没有完整提交时为0
+ * @return int 0表示成功，非0表示读取失败
+ */
+static int ffs_block_validate(ffs_t *fs, uint32_t block, uint32_t *rev, uint32_t *end) {
+    uint32_t off = 4;
+    uint32_t crc;
+    uint32_t tag;
+    int ret;
+
+    *end = 0;
+    ret = ffs_bd_read(fs, block, 0, rev, sizeof(uint32_t));
+    if (ret != ERROR_NONE || *rev == FFS_ERASED_WORD) {
+        return ret;
+    }
+    crc = ffs_crc32(0, rev, sizeof(uint32_t));
+
+    while (off + 8 <= fs->config.block_size) {
+        uint32_t size;
+
+        ret = ffs_bd_read(fs, block, off, &tag, sizeof(tag));
+        if (ret != ERROR_NONE) {
+            return ret;
+        }
+        if (tag == FFS_ERASED_WORD) {
+            break;
+        }
+
+        crc = ffs_crc32(crc, &tag, sizeof(tag));
+        size = FFS_ALIGN4(FFS_TAG_LEN(tag));
+
+        if (FFS_TAG_TYPE(tag) == FFS_TAG_CRC) {
+            uint32_t value;
+
+            if (FFS_TAG_LEN(tag) != 4) {
+                break;
+            }
+            ret = ffs_bd_read(fs, block, off + 4, &value, sizeof(value));
+            if (ret != ERROR_NONE) {
+                return ret;
+            }
+            if (value != crc) {
+                break;
+            }
+            off += 8;
+            *end = off;
+            crc = 0;
+            continue;
+        }
+
+        if (off + 4 + size > fs->config.block_size) {
+            break;
+        }
+
+        for (uint32_t i = 0; i < size; ) {
+            uint32_t len = FFS_MIN(size - i, (uint32_t)sizeof(fs->buffer));
+
+            ret = ffs_bd_read(fs, block, off + 4 + i, fs->buffer, len);
+            if (ret != ERROR_NONE) {
+                return ret;
+            }
+            crc = ffs_crc32(crc, fs->buffer, len);
+            i += len;
+        }
+        off += 4 + size;
+    }
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 读取块对，选择修订号较新且有完整提交的块
+ */
+static int ffs_pair_fetch(ffs_t *fs, ffs_pair_t *pair, uint32_t block0, uint32_t block1) {
+    uint32_t rev[2];
+    uint32_t end[2];
+    uint8_t active;
+    int ret;
+
+    pair->blocks[0] = block0;
+    pair->blocks[1] = block1;
+
+    for (uint8_t i = 0; i < 2; i++) {
+        ret = ffs_block_validate(fs, pair->blocks[i], &rev[i], &end[i]);
+        if (ret != ERROR_NONE) {
+            return ret;
+        }
+    }
+
+    if (end[0] == 0 && end[1] == 0) {
+        return ERROR_CRC;
+    }
+
+    if (end[0] == 0) {
+        active = 1;
+    } else if (end[1] == 0) {
+        active = 0;
+    } else {
+        active = ((int32_t)(rev[1] - rev[0]) > 0) ? 1 : 0;
+    }
+
+    pair->active = active;
+    pair->rev = rev[active];
+    pair->end = end[active];
+    pair->needs_compact = !ffs_bd_erased_from(fs, pair->blocks[active], pair->end);
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 按顺序重放块对当前块中[from, end)范围内的标签
+ */
+static int ffs_pair_replay(ffs_t *fs, const ffs_pair_t *pair, uint32_t from, ffs_tag_visit_t visit) {
+    uint32_t block = pair->blocks[pair->active];
+    uint32_t off = from;
+    uint32_t tag;
+    int ret;
+
+    while (off < pair->end) {
+        ret = ffs_bd_read(fs, block, off, &tag, sizeof(tag));
+        if (ret != ERROR_NONE) {
+            return ret;
+        }
+
+        if (FFS_TAG_TYPE(tag) != FFS_TAG_CRC) {
+            ret = visit(fs, tag, off + 4);
+            if (ret != ERROR_NONE) {
+                return ret;
+            }
+        }
+        off += 4 + FFS_ALIGN4(FFS_TAG_LEN(tag));
+    }
+
+    return ERROR_NONE;
+}
+
+/* 重放锚点标签 */
+static int ffs_visit_super(ffs_t *fs, uint32_t tag, uint32_t data_off) {
+    if (FFS_TAG_TYPE(tag) != FFS_TAG_SUPER || FFS_TAG_LEN(tag) != sizeof(ffs_super_t)) {
+        return ERROR_NONE;
+    }
+
+    return ffs_bd_read(fs, fs->anchor.blocks[fs->anchor.active], data_off, &fs->super, sizeof(ffs_super_t));
+}
+
+/* 重放元数据标签，更新目录项索引 */
+static int ffs_visit_meta(ffs_t *fs, uint32_t tag, uint32_t data_off) {
+    uint32_t block = fs->meta.blocks[fs->meta.active];
+    uint16_t id = FFS_TAG_ID(tag);
+    uint16_t len = FFS_TAG_LEN(tag);
+    ffs_entry_t *entry;
+    int ret;
+
+    if (id == FFS_ROOT_ID || id >= CONFIG_FLASH_FS_MAX_ENTRIES) {
+        return ERROR_CRC;
+    }
+    entry = &fs->entries[id];
+
+    switch (FFS_TAG_TYPE(tag)) {
+        case FFS_TAG_NAME: {
+            ffs_name_t name;
+
+            ret = ffs_bd_read(fs, block, data_off, &name, sizeof(name));
+            if (ret != ERROR_NONE) {
+                return ret;
+            }
+            if (name.name_len == 0 || name.name_len > CONFIG_FLASH_FS_NAME_MAX ||
+                len != sizeof(name) + name.name_len || name.parent >= CONFIG_FLASH_FS_MAX_ENTRIES ||
+                (name.type != FFS_TYPE_FILE && name.type != FFS_TYPE_DIR)) {
+                return ERROR_CRC;
+            }
+
+            ret = ffs_bd_read(fs, block, data_off + sizeof(name), fs->buffer, name.name_len);
+            if (ret != ERROR_NONE) {
+                return ret;
+            }
+
+            /* 新建的目录项是空的内联文件 */
+            if (entry->type == FFS_TYPE_NONE) {
+                entry->head = 0;
+                entry->size = 0;
+                entry->flags = FFS_ENTRY_INLINE;
+            }
+            entry->type = name.type;
+            entry->parent = name.parent;
+            entry->name_len = name.name_len;
+            entry->name_off = data_off + sizeof(name);
+            entry->hash = ffs_hash((const char *)fs->buffer, name.name_len);
+            break;
+        }
+
+        case FFS_TAG_CTZ: {
+            ffs_ctz_t ctz;
+
+            if (len != sizeof(ctz)) {
+                return ERROR_CRC;
+            }
+            ret = ffs_bd_read(fs, block, data_off, &ctz, sizeof(ctz));
+            if (ret != ERROR_NONE) {
+                return ret;
+            }
+            entry->head = ctz.head;
+            entry->size = ctz.size;
+            entry->flags &= (uint8_t)~FFS_ENTRY_INLINE;
+            break;
+        }
+
+        case FFS_TAG_INLINE:
+            entry->head = data_off;
+            entry->size = len;
+            entry->flags |= FFS_ENTRY_INLINE;
+            break;
+
+        case FFS_TAG_DELETE:
+            memset(entry, 0, sizeof(ffs_entry_t));
+            break;
+
+        default:
+            break;
+    }
+
+    return ERROR_NONE;
+}
+
+/* 清空目录项索引并重放元数据 */
+static int ffs_meta_rebuild(ffs_t *fs) {
+    memset(fs->entries, 0, sizeof(fs->entries));
+    fs->entries[FFS_ROOT_ID].type = FFS_TYPE_DIR;
+    fs->entries[FFS_ROOT_ID].parent = FFS_ROOT_ID;
+
+    return ffs_pair_replay(fs, &fs->meta, 4, ffs_visit_meta);
+}
+
+static int ffs_alloc(ffs_t *fs, uint32_t *block);
+static int ffs_pair_commit(ffs_t *fs, ffs_pair_t *pair, const ffs_attr_t *attrs, uint32_t count);
+
+/* 把一个目录项的当前状态写入压缩后的日志 */
+static int ffs_compact_entry(ffs_t *fs, ffs_commit_t *commit, uint16_t id) {
+    const ffs_entry_t *entry = &fs->entries[id];
+    uint32_t block = fs->meta.blocks[fs->meta.active];
+    uint8_t record[sizeof(ffs_name_t) + CONFIG_FLASH_FS_NAME_MAX];
+    ffs_name_t name;
+    int ret;
+
+    name.parent = entry->parent;
+    name.type = entry->type;
+    name.name_len = entry->name_len;
+    memcpy(record, &name, sizeof(name));
+    ret = ffs_bd_read(fs, block, entry->name_off, record + sizeof(name), entry->name_len);
+    if (ret == ERROR_NONE) {
+        ret = ffs_commit_attr(fs, commit, FFS_TAG_NAME, id, record, (uint16_t)(sizeof(name) + entry->name_len));
+    }
+    if (ret != ERROR_NONE || entry->type != FFS_TYPE_FILE) {
+        return ret;
+    }
+
+    if ((entry->flags & FFS_ENTRY_INLINE) == 0) {
+        ffs_ctz_t ctz = {entry->head, entry->size};
+        return ffs_commit_attr(fs, commit, FFS_TAG_CTZ, id, &ctz, sizeof(ctz));
+    }
+
+    if (entry->size == 0) {
+        return ERROR_NONE;
+    }
+
+    ret = ffs_bd_read(fs, block, entry->head, fs->buffer, entry->size);
+    if (ret == ERROR_NONE) {
+        ret = ffs_commit_attr(fs, commit, FFS_TAG_INLINE, id, fs->buffer, (uint16_t)entry->size);
+    }
+
+    return ret;
+}
+
+/* 压缩后日志的大小 */
+static uint32_t ffs_compact_size(const ffs_t *fs, const ffs_pair_t *pair, const ffs_attr_t *attrs, uint32_t count) {
+    uint32_t size = 4 + ffs_attrs_size(attrs, count) + 8;
+
+    if (pair != &fs->meta) {
+        return size;
+    }
+
+    for (uint16_t id = 1; id < CONFIG_FLASH_FS_MAX_ENTRIES; id++) {
+        const ffs_entry_t *entry = &fs->entries[id];
+
+        if (entry->type == FFS_TYPE_NONE) {
+            continue;
+        }
+        size += 4 + FFS_ALIGN4(sizeof(ffs_name_t) + entry->name_len);
+        if (entry->type == FFS_TYPE_FILE) {
+            if ((entry->flags & FFS_ENTRY_INLINE) == 0) {
+                size += 4 + sizeof(ffs_ctz_t);
+            } else if (entry->size > 0) {
+                size += 4 + FFS_ALIGN4(entry->size);
+            }
+        }
+    }
+
+    return size;
+}
+
+/**
+ * @brief 压缩块对
+ *
+ * 把有效内容和本次要提交的标签作为一次提交写入另一块，修订号加一。元数据
+ * 块对按block_cycles迁移时写入新分配的块，并在锚点中提交新位置；锚点提交
+ * 之前掉电，原块对保持有效
+ */
+static int ffs_pair_compact(ffs_t *fs, ffs_pair_t *pair, const ffs_attr_t *attrs, uint32_t count) {
+    bool is_meta = (pair == &fs->meta);
+    uint32_t rev = pair->rev + 1;
+    uint32_t target[2];
+    bool relocate = false;
+    ffs_commit_t commit;
+    int ret;
+
+    if (ffs_compact_size(fs, pair, attrs, count) > fs->config.block_size) {
+        return ERROR_FULL;
+    }
+
+    target[0] = pair->blocks[pair->active ^ 1];
+    target[1] = pair->blocks[pair->active];
+
+    /* 迁移到新块，空间不足时留在原块对 */
+    if (is_meta && fs->config.block_cycles > 0 && (rev % fs->config.block_cycles) == 0) {
+        if (ffs_alloc(fs, &fs->pending[0]) == ERROR_NONE) {
+            if (ffs_alloc(fs, &fs->pending[1]) == ERROR_NONE) {
+                target[0] = fs->pending[0];
+                target[1] = fs->pending[1];
+                relocate = true;
+            }
+        }
+        if (!relocate) {
+            fs->pending[0] = FFS_BLOCK_NONE;
+            fs->pending[1] = FFS_BLOCK_NONE;
+        }
+    }
+
+    if (!relocate) {
+        ret = ffs_bd_erase(fs, target[0]);
+        if (ret != ERROR_NONE) {
+            return ret;
+        }
+    }
+
+    commit.block = target[0];
+    commit.off = 0;
+    commit.crc = 0;
+    ret = ffs_commit_prog(fs, &commit, &rev, sizeof(rev));
+
+    if (is_meta) {
+        for (uint16_t id = 1; id < CONFIG_FLASH_FS_MAX_ENTRIES && ret == ERROR_NONE; id++) {
+            if (fs->entries[id].type != FFS_TYPE_NONE) {
+                ret = ffs_compact_entry(fs, &commit, id);
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < count && ret == ERROR_NONE; i++) {
+        ret = ffs_commit_attr(fs, &commit, attrs[i].type, attrs[i].id, attrs[i].data, attrs[i].len);
+    }
+
+    if (ret == ERROR_NONE) {
+        ret = ffs_commit_crc(fs, &commit);
+    }
+
+    if (ret == ERROR_NONE && relocate) {
+        ffs_super_t super = fs->super;
+        ffs_attr_t attr = {FFS_TAG_SUPER, FFS_ID_NONE, sizeof(ffs_super_t), &super};
+
+        super.meta[0] = target[0];
+        super.meta[1] = target[1];
+        ret = ffs_pair_commit(fs, &fs->anchor, &attr, 1);
+        if (ret == ERROR_NONE) {
+            fs->stats.relocations++;
+        }
+    }
+
+    fs->pending[0] = FFS_BLOCK_NONE;
+    fs->pending[1] = FFS_BLOCK_NONE;
+
+    if (ret != ERROR_NONE) {
+        return ret;
+    }
+
+    pair->blocks[0] = target[0];
+    pair->blocks[1] = target[1];
+    pair->active = 0;
+    pair->rev = rev;
+    pair->end = commit.off;
+    pair->needs_compact = false;
+    fs->stats.compactions++;
+    fs->stats.commits++;
+
+    if (is_meta) {
+        return ffs_meta_rebuild(fs);
+    }
+
+    return ffs_pair_replay(fs, pair, 4, ffs_visit_super);
+}
+
+/**
+ * @brief 向块对提交一组标签
+ *
+ * 日志剩余空间足够时追加在末尾，否则压缩。一次提交中的标签要么全部生效，
+ * 要么全部不生效
+ */
+static int ffs_pair_commit(ffs_t *fs, ffs_pair_t *pair, const ffs_attr_t *attrs, uint32_t count) {
+    uint32_t size = ffs_attrs_size(attrs, count) + 8;
+    int ret;
+
+    if (!pair->needs_compact && pair->end + size <= fs->config.block_size) {
+        ffs_commit_t commit = {pair->blocks[pair->active], pair->end, 0};
+
+        ret = ERROR_NONE;
+        for (uint32_t i = 0; i < count && ret == ERROR_NONE; i++) {
+            ret = ffs_commit_attr(fs, &commit, attrs[i].type, attrs[i].id, attrs[i].data, attrs[i].len);
+        }
+        if (ret == ERROR_NONE) {
+            ret = ffs_commit_crc(fs, &commit);
+        }
+
+        if (ret == ERROR_NONE) {
+            uint32_t from = pair->end;
+
+            pair->end = commit.off;
+            fs->stats.commits++;
+            return ffs_pair_replay(fs, pair, from, (pair == &fs->meta) ? ffs_visit_meta : ffs_visit_super);
+        }
+
+        /* 写入失败的提交留下了残留数据，改为压缩 */
+        pair->needs_compact = true;
+    }
+
+    return ffs_pair_compact(fs, pair, attrs, count);
+}
+
+/*===========================================================================*/
+/* CTZ跳表与块分配                                                           */
+/*===========================================================================*/
+
+/**
+ * @brief 把文件偏移换算为块序号和块内偏移
+ *
+ * @param fs 文件系统
+ * @param off 输入文件偏移，输出块内偏移
+ * @return uint32_t 块序号
+ */
+static uint32_t ffs_ctz_index(const ffs_t *fs, uint32_t *off) {
+    uint32_t size = *off;
+    uint32_t b = fs->config.block_size - 2 * 4;
+    uint32_t i = size / b;
+
+    if (i == 0) {
+        return 0;
+    }
+
+    i = (size - 4 * (ffs_popc(i - 1) + 2)) / b;
+    *off = size - b * i - 4 * ffs_popc(i);
+
+    return i;
+}
+
+/**
+ * @brief 从末块出发沿跳表查找文件偏移所在的块
+ */
+static int ffs_ctz_find(ffs_t *fs, uint32_t head, uint32_t size, uint32_t pos,
+                        uint32_t *block, uint32_t *off) {
+    uint32_t last = size - 1;
+    uint32_t current = ffs_ctz_index(fs, &last);
+    uint32_t target = ffs_ctz_index(fs, &pos);
+    int ret;
+
+    while (current > target) {
+        uint32_t skip = FFS_MIN(ffs_npw2(current - target + 1) - 1, ffs_ctz(current));
+
+        ret = ffs_bd_read(fs, head, 4 * skip, &head, sizeof(head));
+        if (ret != ERROR_NONE) {
+            return ret;
+        }
+        current -= 1UL << skip;
+    }
+
+    if (head >= fs->config.block_count) {
+        return ERROR_CRC;
+    }
+
+    *block = head;
+    *off = pos;
+
+    return ERROR_NONE;
+}
+
+/* 遍历跳表中的所有块 */
+static int ffs_ctz_traverse(ffs_t *fs, uint32_t head, uint32_t size, ffs_block_visit_t visit, void *arg) {
+    uint32_t last;
+    uint32_t index;
+    int ret;
+
+    if (size == 0) {
+        return ERROR_NONE;
+    }
+
+    last = size - 1;
+    index = ffs_ctz_index(fs, &last);
+
+    for (;;) {
+        if (head >= fs->config.block_count) {
+            return ERROR_CRC;
+        }
+        visit(fs, head, arg);
+        if (index == 0) {
+            return ERROR_NONE;
+        }
+
+        ret = ffs_bd_read(fs, head, 0, &head, sizeof(head));
+        if (ret != ERROR_NONE) {
+            return ret;
+        }
+        index--;
+    }
+}
+
+/**
+ * @brief 遍历所有在用的块
+ *
+ * 包括锚点和元数据块对、已提交的文件、打开文件尚未提交的新版本和正在写入的
+ * 块链表，以及分配后尚未被引用的块
+ */
+static int ffs_traverse(ffs_t *fs, ffs_block_visit_t visit, void *arg) {
+    int ret;
+
+    for (uint8_t i = 0; i < 2; i++) {
+        visit(fs, fs->anchor.blocks[i], arg);
+        visit(fs, fs->meta.blocks[i], arg);
+        if (fs->pending[i] != FFS_BLOCK_NONE) {
+            visit(fs, fs->pending[i], arg);
+        }
+    }
+
+    for (uint16_t id = 1; id < CONFIG_FLASH_FS_MAX_ENTRIES; id++) {
+        const ffs_entry_t *entry = &fs->entries[id];
+
+        if (entry->type == FFS_TYPE_FILE && (entry->flags & FFS_ENTRY_INLINE) == 0) {
+            ret = ffs_ctz_traverse(fs, entry->head, entry->size, visit, arg);
+            if (ret != ERROR_NONE) {
+                return ret;
+            }
+        }
+    }
+
+    for (uint8_t i = 0; i < CONFIG_FLASH_FS_MAX_OPEN_FILES; i++) {
+        const ffs_file_t *file = &fs->files[i];
+
+        if (!file->used || (file->flags & FFS_FILE_INLINE) != 0) {
+            continue;
+        }
+
+        if ((file->flags & FFS_FILE_DIRTY) != 0) {
+            ret = ffs_ctz_traverse(fs, file->head, file->size, visit, arg);
+            if (ret != ERROR_NONE) {
+                return ret;
+            }
+        }
+
+        if ((file->flags & FFS_FILE_WRITING) != 0) {
+            ret = ffs_ctz_traverse(fs, file->block, file->pos, visit, arg);
+            if (ret != ERROR_NONE) {
+                return ret;
+            }
+        }
+    }
+
+    return ERROR_NONE;
+}
+
+/* 在前瞻窗口位图中标记在用块 */
+static void ffs_lookahead_mark(ffs_t *fs, uint32_t block, void *arg) {
+    uint32_t off = (block + fs->config.block_count - fs->la_start) % fs->config.block_count;
+
+    (void)arg;
+    if (off < fs->la_size) {
+        fs->lookahead[off / 32] |= 1UL << (off % 32);
+    }
+}
+
+/* 把前瞻窗口移到指定起点并重建位图 */
+static int ffs_lookahead_fill(ffs_t *fs, uint32_t start) {
+    fs->la_start = start % fs->config.block_count;
+    fs->la_size = FFS_MIN((uint32_t)CONFIG_FLASH_FS_LOOKAHEAD, fs->config.block_count);
+    fs->la_off = 0;
+    memset(fs->lookahead, 0, sizeof(fs->lookahead));
+
+    return ffs_traverse(fs, ffs_lookahead_mark, NULL);
+}
+
+/**
+ * @brief 分配并擦除一个空闲块
+ *
+ * 自上次成功分配后检查过整个分区仍没有空闲块时返回ERROR_FULL
+ */
+static int ffs_alloc(ffs_t *fs, uint32_t *block) {
+    int ret;
+
+    for (;;) {
+        while (fs->la_off < fs->la_size) {
+            uint32_t off = fs->la_off++;
+            uint32_t mask = 1UL << (off % 32);
+
+            if ((fs->lookahead[off / 32] & mask) == 0) {
+                fs->lookahead[off / 32] |= mask;
+                fs->la_seen = 0;
+                *block = (fs->la_start + off) % fs->config.block_count;
+                return ffs_bd_erase(fs, *block);
+            }
+            fs->la_seen++;
+        }
+
+        if (fs->la_seen >= fs->config.block_count) {
+            return ERROR_FULL;
+        }
+
+        /* 新窗口从上次分配的块之后开始，窗口末尾被跳过的块下一轮最先检查 */
+        if (fs->la_seen < fs->la_size) {
+            ret = ffs_lookahead_fill(fs, fs->la_start + fs->la_size - fs->la_seen);
+        } else {
+            ret = ffs_lookahead_fill(fs, fs->la_start + fs->la_size);
+        }
+        if (ret != ERROR_NONE) {
+            return ret;
+        }
+    }
+}
+
+/**
+ * @brief 按窗口统计在用块数
+ *
+ * 借用前瞻窗口位图，统计后分配器从原起点重新建立窗口
+ */
+static int ffs_count_used(ffs_t *fs, uint32_t *used) {
+    uint32_t start = fs->la_start;
+    uint32_t count = 0;
+    int ret = ERROR_NONE;
+
+    for (uint32_t base = 0; base < fs->config.block_count && ret == ERROR_NONE; base += CONFIG_FLASH_FS_LOOKAHEAD) {
+        fs->la_start = base;
+        fs->la_size = FFS_MIN((uint32_t)CONFIG_FLASH_FS_LOOKAHEAD, fs->config.block_count - base);
+        memset(fs->lookahead, 0, sizeof(fs->lookahead));
+        ret = ffs_traverse(fs, ffs_lookahead_mark, NULL);
+        for (uint32_t i = 0; i < CONFIG_FLASH_FS_LOOKAHEAD / 32; i++) {
+            count += ffs_popc(fs->lookahead[i]);
+        }
+    }
+
+    fs->la_start = start;
+    fs->la_size = 0;
+    fs->la_off = 0;
+    fs->la_seen = 0;
+    *used = count;
+
+    return ret;
+}
+
+/*===========================================================================*/
+/* 目录项                                                                    */
+/*===========================================================================*/
+
+/* 比较目录项名称 */
+static bool ffs_name_equals(ffs_t *fs, uint16_t id, const char *name, uint32_t len, uint32_t hash) {
+    const ffs_entry_t *entry = &fs->entries[id];
+
+    if (entry->name_len != len || entry->hash != hash) {
+        return false;
+    }
+
+    if (ffs_bd_read(fs, fs->meta.blocks[fs->meta.active], entry->name_off, fs->buffer, len) != ERROR_NONE) {
+        return false;
+    }
+
+    return memcmp(fs->buffer, name, len) == 0;
+}
+
+/* 在目录中查找子项 */
+static uint16_t ffs_find_child(ffs_t *fs, uint16_t dir, const char *name, uint32_t len) {
+    uint32_t hash = ffs_hash(name, len);
+
+    for (uint16_t id = 1; id < CONFIG_FLASH_FS_MAX_ENTRIES; id++) {
+        const ffs_entry_t *entry = &fs->entries[id];
+
+        if (entry->type != FFS_TYPE_NONE && entry->parent == dir && ffs_name_equals(fs, id, name, len, hash)) {
+            return id;
+        }
+    }
+
+    return FFS_ID_NONE;
+}
+
+/* 判断目录是否有子项 */
+static bool ffs_dir_has_children(const ffs_t *fs, uint16_t dir) {
+    for (uint16_t id = 1; id < CONFIG_FLASH_FS_MAX_ENTRIES; id++) {
+        if (fs->entries[id].type != FFS_TYPE_NONE && fs->entries[id].parent == dir) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief 解析路径
+ *
+ * 路径可以带挂载路径前缀，各级以'/'分隔。最后一级不存在时id为FFS_ID_NONE，
+ * parent和name仍指向其父目录和名称，供创建使用
+ *
+ * @return int 0表示成功，中间目录不存在时返回ERROR_NOT_FOUND
+ */
+static int ffs_lookup(ffs_t *fs, const char *path, uint16_t *id, uint16_t *parent,
+                      const char **name, uint32_t *name_len) {
+    size_t prefix = strlen(fs->path);
+    uint16_t current = FFS_ROOT_ID;
+
+    if (prefix > 1 && strncmp(path, fs->path, prefix) == 0 && (path[prefix] == '/' || path[prefix] == '\0')) {
+        path += prefix;
+    }
+
+    *id = FFS_ROOT_ID;
+    *parent = FFS_ID_NONE;
+    *name = NULL;
+    *name_len = 0;
+
+    for (;;) {
+        const char *rest;
+        uint32_t len;
+        uint16_t child;
+
+        while (*path == '/') {
+            path++;
+        }
+        if (*path == '\0') {
+            return ERROR_NONE;
+        }
+
+        len = (uint32_t)strcspn(path, "/");
+        if (len > CONFIG_FLASH_FS_NAME_MAX || (len == 1 && path[0] == '.') ||
+            (len == 2 && path[0] == '.' && path[1] == '.')) {
+            return ERROR_INVALID_PARAM;
+        }
+
+        if (fs->entries[current].type != FFS_TYPE_DIR) {
+            return ERROR_NOT_FOUND;
+        }
+
+        child = ffs_find_child(fs, current, path, len);
+        rest = path + len;
+        while (*rest == '/') {
+            rest++;
+        }
+
+        if (*rest == '\0') {
+            *id = child;
+            *parent = current;
+            *name = path;
+            *name_len = len;
+            return ERROR_NONE;
+        }
+
+        if (child == FFS_ID_NONE) {
+            return ERROR_NOT_FOUND;
+        }
+        current = child;
+        path = rest;
+    }
+}
+
+/* 组装名称标签数据 */
+static uint16_t ffs_name_record(uint8_t *record, uint16_t parent, uint8_t type, const char *name, uint32_t len) {
+    ffs_name_t header;
+
+    header.parent = parent;
+    header.type = type;
+    header.name_len = (uint8_t)len;
+    memcpy(record, &header, sizeof(header));
+    memcpy(record + sizeof(header), name, len);
+
+    return (uint16_t)(sizeof(header) + len);
+}
+
+/* 新建目录项 */
+static int ffs_create(ffs_t *fs, uint16_t parent, const char *name, uint32_t len, uint8_t type, uint16_t *id) {
+    uint8_t record[sizeof(ffs_name_t) + CONFIG_FLASH_FS_NAME_MAX];
+    ffs_attr_t attr;
+    uint16_t free_id = FFS_ID_NONE;
+    int ret;
+
+    for (uint16_t i = 1; i < CONFIG_FLASH_FS_MAX_ENTRIES; i++) {
+        if (fs->entries[i].type == FFS_TYPE_NONE) {
+            free_id = i;
+            break;
+        }
+    }
+    if (free_id == FFS_ID_NONE) {
+        return ERROR_FULL;
+    }
+
+    attr.type = FFS_TAG_NAME;
+    attr.id = free_id;
+    attr.len = ffs_name_record(record, parent, type, name, len);
+    attr.data = record;
+
+    ret = ffs_pair_commit(fs, &fs->meta, &attr, 1);
+    if (ret == ERROR_NONE) {
+        *id = free_id;
+    }
+
+    return ret;
+}
+
+/* 判断目录项是否被打开 */
+static bool ffs_is_open(const ffs_t *fs, uint16_t id) {
+    for (uint8_t i = 0; i < CONFIG_FLASH_FS_MAX_OPEN_FILES; i++) {
+        if (fs->files[i].used && fs->files[i].id == id) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* 读取目录项信息 */
+static int ffs_fill_info(ffs_t *fs, uint16_t id, fs_file_info_t *info) {
+    const ffs_entry_t *entry = &fs->entries[id];
+    int ret = ERROR_NONE;
+
+    memset(info, 0, sizeof(fs_file_info_t));
+    if (id == FFS_ROOT_ID) {
+        info->name[0] = '/';
+    } else {
+        ret = ffs_bd_read(fs, fs->meta.blocks[fs->meta.active], entry->name_off, fs->buffer, entry->name_len);
+        memcpy(info->name, fs->buffer, entry->name_len);
+    }
+    info->size = (entry->type == FFS_TYPE_FILE) ? entry->size : 0;
+    info->is_directory = (entry->type == FFS_TYPE_DIR);
+
+    return ret;
+}
+
+/*===========================================================================*/
+/* 文件读写                                                                  */
+/*===========================================================================*/
+
+/* 文件当前大小，写入会话中包括已写入但未结束会话的数据 */
+static uint32_t ffs_file_size(const ffs_file_t *file) {
+    if ((file->flags & FFS_FILE_WRITING) != 0 && file->pos > file->size) {
+        return file->pos;
+    }
+
+    return file->size;
+}
+
+/* 编程缓存中的数据，不足一个字的部分以0xFF填充 */
+static int ffs_file_cache_flush(ffs_file_t *file) {
+    int ret;
+
+    if (file->cache_len == 0) {
+        return ERROR_NONE;
+    }
+
+    ret = ffs_bd_prog(file->fs, file->cache_block, file->cache_off, file->cache, FFS_ALIGN4(file->cache_len));
+    file->cache_len = 0;
+
+    return ret;
+}
+
+/**
+ * @brief 经缓存编程文件数据
+ *
+ * 缓存只合并同一块内连续的写入，起点总是字对齐
+ */
+static int ffs_file_prog(ffs_file_t *file, uint32_t block, uint32_t off, const void *data, uint32_t len) {
+    const uint8_t *src = (const uint8_t *)data;
+    int ret;
+
+    while (len > 0) {
+        uint32_t n;
+
+        if (file->cache_len > 0 && (block != file->cache_block || off != file->cache_off + file->cache_len)) {
+            ret = ffs_file_cache_flush(file);
+            if (ret != ERROR_NONE) {
+                return ret;
+            }
+        }
+
+        if (file->cache_len == 0) {
+            file->cache_block = block;
+            file->cache_off = off;
+            memset(file->cache, 0xFF, sizeof(file->cache));
+        }
+
+        n = FFS_MIN(len, (uint32_t)sizeof(file->cache) - file->cache_len);
+        memcpy(file->cache + file->cache_len, src, n);
+        file->cache_len += n;
+        off += n;
+        src += n;
+        len -= n;
+
+        if (file->cache_len == sizeof(file->cache)) {
+            ret = ffs_file_cache_flush(file);
+            if (ret != ERROR_NONE) {
+                return ret;
+            }
+        }
+    }
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 为跳表追加写入位置
+ *
+ * 在文件末尾追加且尾块剩余空间为擦除状态时直接续写；尾块未满时复制到新块；
+ * 尾块已满时分配新块并写入跳表指针
+ *
+ * @param file 文件
+ * @param head 写入位置前一字节所在的块
+ * @param size 写入位置
+ * @param block 新写入位置所在块输出
+ * @param off 新写入位置块内偏移输出
+ * @return int 0表示成功，非0表示失败
+ */
+static int ffs_ctz_extend(ffs_file_t *file, uint32_t head, uint32_t size, uint32_t *block, uint32_t *off) {
+    ffs_t *fs = file->fs;
+    uint32_t block_size = fs->config.block_size;
+    uint32_t nblock;
+    uint32_t noff = 0;
+    uint32_t index = 0;
+    int ret;
+
+    if (size > 0) {
+        noff = size - 1;
+        index = ffs_ctz_index(fs, &noff);
+        noff += 1;
+
+        if (noff != block_size && size == file->size && (noff % 4) == 0 && ffs_bd_erased_from(fs, head, noff)) {
+            *block = head;
+            *off = noff;
+            fs->stats.inplace_appends++;
+            return ERROR_NONE;
+        }
+    }
+
+    /* 分配前编程缓存，使遍历能读到上一块的跳表指针 */
+    ret = ffs_file_cache_flush(file);
+    if (ret == ERROR_NONE) {
+        ret = ffs_alloc(fs, &nblock);
+    }
+    if (ret != ERROR_NONE) {
+        return ret;
+    }
+
+    if (size == 0) {
+        *block = nblock;
+        *off = 0;
+        return ERROR_NONE;
+    }
+
+    if (noff != block_size) {
+        for (uint32_t i = 0; i < noff; ) {
+            uint32_t n = FFS_MIN(noff - i, (uint32_t)sizeof(fs->buffer));
+
+            ret = ffs_bd_read(fs, head, i, fs->buffer, n);
+            if (ret == ERROR_NONE) {
+                ret = ffs_file_prog(file, nblock, i, fs->buffer, n);
+            }
+            if (ret != ERROR_NONE) {
+                return ret;
+            }
+            i += n;
+        }
+
+        *block = nblock;
+        *off = noff;
+        return ERROR_NONE;
+    }
+
+    index += 1;
+    {
+        uint32_t skips = ffs_ctz(index) + 1;
+        uint32_t nhead = head;
+
+        for (uint32_t i = 0; i < skips; i++) {
+            ret = ffs_file_prog(file, nblock, 4 * i, &nhead, sizeof(nhead));
+            if (ret == ERROR_NONE && i != skips - 1) {
+                ret = ffs_bd_read(fs, nhead, 4 * i, &nhead, sizeof(nhead));
+            }
+            if (ret != ERROR_NONE) {
+                return ret;
+            }
+        }
+
+        *block = nblock;
+        *off = 4 * skips;
+    }
+
+    return ERROR_NONE;
+}
+
+/* 在写入会话中写入数据 */
+static int ffs_file_flushedwrite(ffs_file_t *file, const uint8_t *data, uint32_t size) {
+    ffs_t *fs = file->fs;
+    int ret;
+
+    while (size > 0) {
+        uint32_t n;
+
+        if ((file->flags & FFS_FILE_WRITING) == 0 || file->off == fs->config.block_size) {
+            if ((file->flags & FFS_FILE_WRITING) == 0) {
+                file->block = FFS_BLOCK_NONE;
+                if (file->pos > 0) {
+                    ret = ffs_ctz_find(fs, file->head, file->size, file->pos - 1, &file->block, &file->off);
+                    if (ret != ERROR_NONE) {
+                        return ret;
+                    }
+                }
+            }
+
+            ret = ffs_ctz_extend(file, file->block, file->pos, &file->block, &file->off);
+            if (ret != ERROR_NONE) {
+                return ret;
+            }
+            file->flags |= FFS_FILE_WRITING;
+        }
+
+        n = FFS_MIN(size, fs->config.block_size - file->off);
+        ret = ffs_file_prog(file, file->block, file->off, data, n);
+        if (ret != ERROR_NONE) {
+            return ret;
+        }
+
+        file->pos += n;
+        file->off += n;
+        data += n;
+        size -= n;
+    }
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 结束写入会话
+ *
+ * 把写入位置之后的原有数据复制到新版本，新版本成为文件当前版本，等待提交
+ */
+static int ffs_file_flush(ffs_file_t *file) {
+    ffs_t *fs = file->fs;
+    uint32_t pos = file->pos;
+    uint32_t block = FFS_BLOCK_NONE;
+    uint32_t off = 0;
+    int ret;
+
+    file->flags &= (uint8_t)~FFS_FILE_READING;
+    if ((file->flags & FFS_FILE_WRITING) == 0) {
+        return ERROR_NONE;
+    }
+
+    while (file->pos < file->size) {
+        uint8_t chunk[32];
+        uint32_t n;
+
+        if (block == FFS_BLOCK_NONE || off == fs->config.block_size) {
+            ret = ffs_ctz_find(fs, file->head, file->size, file->pos, &block, &off);
+            if (ret != ERROR_NONE) {
+                return ret;
+            }
+        }
+
+        n = FFS_MIN((uint32_t)sizeof(chunk), file->size - file->pos);
+        n = FFS_MIN(n, fs->config.block_size - off);
+        ret = ffs_bd_read(fs, block, off, chunk, n);
+        if (ret == ERROR_NONE) {
+            ret = ffs_file_flushedwrite(file, chunk, n);
+        }
+        if (ret != ERROR_NONE) {
+            return ret;
+        }
+        off += n;
+    }
+
+    ret = ffs_file_cache_flush(file);
+    if (ret != ERROR_NONE) {
+        return ret;
+    }
+
+    file->head = file->block;
+    file->size = file->pos;
+    file->pos = pos;
+    file->flags &= (uint8_t)~FFS_FILE_WRITING;
+    file->flags |= FFS_FILE_DIRTY;
+
+    return ERROR_NONE;
+}
+
+/* 内联文件超出缓存大小时转为跳表存储 */
+static int ffs_file_outline(ffs_file_t *file) {
+    ffs_t *fs = file->fs;
+    uint32_t block;
+    int ret;
+
+    if (file->size == 0) {
+        block = FFS_BLOCK_NONE;
+    } else {
+        /* 分配时文件仍为内联，遍历不会访问尚未写入的块 */
+        ret = ffs_alloc(fs, &block);
+        if (ret != ERROR_NONE) {
+            return ret;
+        }
+        memset(file->cache + file->size, 0xFF, sizeof(file->cache) - file->size);
+        ret = ffs_bd_prog(fs, block, 0, file->cache, FFS_ALIGN4(file->size));
+        if (ret != ERROR_NONE) {
+            return ret;
+        }
+    }
+
+    file->head = block;
+    file->cache_len = 0;
+    file->flags &= (uint8_t)~FFS_FILE_INLINE;
+    file->flags |= FFS_FILE_DIRTY;
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 结束写入会话并把文件新版本作为一次提交写入元数据
+ *
+ * 提交成功后同一文件的其他打开句柄切换到新版本
+ */
+static int ffs_file_sync(ffs_file_t *file) {
+    ffs_t *fs = file->fs;
+    ffs_attr_t attr;
+    ffs_ctz_t ctz;
+    int ret;
+
+    if ((file->flags & FFS_FILE_ERRED) != 0) {
+        return ERROR_IO;
+    }
+
+    ret = ffs_file_flush(file);
+    if (ret != ERROR_NONE) {
+        file->flags |= FFS_FILE_ERRED;
+        return ret;
+    }
+
+    if ((file->flags & FFS_FILE_DIRTY) == 0) {
+        return ERROR_NONE;
+    }
+
+    attr.id = file->id;
+    if ((file->flags & FFS_FILE_INLINE) != 0) {
+        attr.type = FFS_TAG_INLINE;
+        attr.len = (uint16_t)file->size;
+        attr.data = file->cache;
+    } else {
+        ctz.head = file->head;
+        ctz.size = file->size;
+        attr.type = FFS_TAG_CTZ;
+        attr.len = sizeof(ctz);
+        attr.data = &ctz;
+    }
+
+    ret = ffs_pair_commit(fs, &fs->meta, &attr, 1);
+    if (ret != ERROR_NONE) {
+        return ret;
+    }
+    file->flags &= (uint8_t)~FFS_FILE_DIRTY;
+
+    for (uint8_t i = 0; i < CONFIG_FLASH_FS_MAX_OPEN_FILES; i++) {
+        ffs_file_t *other = &fs->files[i];
+
+        if (other == file || !other->used || other->id != file->id) {
+            continue;
+        }
+        other->head = file->head;
+        other->size = file->size;
+        other->flags = (uint8_t)((other->flags & ~(FFS_FILE_INLINE | FFS_FILE_READING)) |
+                                 (file->flags & FFS_FILE_INLINE));
+        if ((file->flags & FFS_FILE_INLINE) != 0) {
+            memcpy(other->cache, file->cache, file->size);
+        }
+    }
+
+    return ERROR_NONE;
+}
+
+/* 从目录项载入文件当前版本 */
+static int ffs_file_load(ffs_t *fs, ffs_file_t *file, uint16_t id) {
+    const ffs_entry_t *entry = &fs->entries[id];
+
+    file->head = entry->head;
+    file->size = entry->size;
+    file->flags = 0;
+    file->cache_len = 0;
+
+    if ((entry->flags & FFS_ENTRY_INLINE) == 0) {
+        return ERROR_NONE;
+    }
+
+    file->flags |= FFS_FILE_INLINE;
+    if (entry->size > sizeof(file->cache)) {
+        return ERROR_CRC;
+    }
+
+    return ffs_bd_read(fs, fs->meta.blocks[fs->meta.active], entry->head, file->cache, entry->size);
+}
+
+/*===========================================================================*/
+/* 挂载与格式化                                                              */
+/*===========================================================================*/
+
+/* 句柄转换为已挂载的文件系统 */
+static ffs_t *ffs_from_handle(fs_handle_t handle) {
+    for (uint8_t i = 0; i < CONFIG_FLASH_FS_MAX_MOUNTS; i++) {
+        if (handle == (fs_handle_t)&g_ffs_mounts[i] && g_ffs_mounts[i].mounted) {
+            return &g_ffs_mounts[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* 句柄转换为打开的文件 */
+static ffs_file_t *ffs_file_from_handle(fs_file_handle_t handle) {
+    for (uint8_t i = 0; i < CONFIG_FLASH_FS_MAX_MOUNTS; i++) {
+        for (uint8_t j = 0; j < CONFIG_FLASH_FS_MAX_OPEN_FILES; j++) {
+            ffs_file_t *file = &g_ffs_mounts[i].files[j];
+            if (handle == (fs_file_handle_t)file && file->used) {
+                return file;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/* 句柄转换为打开的目录 */
+static ffs_dir_t *ffs_dir_from_handle(fs_dir_handle_t handle) {
+    for (uint8_t i = 0; i < CONFIG_FLASH_FS_MAX_MOUNTS; i++) {
+        for (uint8_t j = 0; j < CONFIG_FLASH_FS_MAX_OPEN_DIRS; j++) {
+            ffs_dir_t *dir = &g_ffs_mounts[i].dirs[j];
+            if (handle == (fs_dir_handle_t)dir && dir->used) {
+                return dir;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 读取超级块和元数据，重建目录项索引
+ *
+ * @return int 0表示成功，分区未格式化时返回ERROR_CRC
+ */
+static int ffs_load(ffs_t *fs) {
+    const ffs_super_t *super = &fs->super;
+    int ret;
+
+    fs->pending[0] = FFS_BLOCK_NONE;
+    fs->pending[1] = FFS_BLOCK_NONE;
+    memset(&fs->super, 0, sizeof(fs->super));
+
+    ret = ffs_pair_fetch(fs, &fs->anchor, 0, 1);
+    if (ret == ERROR_NONE) {
+        ret = ffs_pair_replay(fs, &fs->anchor, 4, ffs_visit_super);
+    }
+    if (ret != ERROR_NONE) {
+        return ret;
+    }
+
+    if (super->magic != FFS_MAGIC || super->version != FFS_VERSION ||
+        super->block_size != fs->config.block_size || super->block_count != fs->config.block_count ||
+        super->meta[0] < 2 || super->meta[0] >= fs->config.block_count ||
+        super->meta[1] < 2 || super->meta[1] >= fs->config.block_count || super->meta[0] == super->meta[1]) {
+        return ERROR_CRC;
+    }
+
+    ret = ffs_pair_fetch(fs, &fs->meta, super->meta[0], super->meta[1]);
+    if (ret == ERROR_NONE) {
+        ret = ffs_meta_rebuild(fs);
+    }
+    if (ret != ERROR_NONE) {
+        return ret;
+    }
+
+    /* 分配起点随修订号变化，各块轮流被使用 */
+    fs->la_start = (fs->meta.rev * 2654435761UL + fs->anchor.rev) % fs->config.block_count;
+    fs->la_size = 0;
+    fs->la_off = 0;
+    fs->la_seen = 0;
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 格式化分区
+ *
+ * 先擦除锚点使旧文件系统失效，写好空的元数据块后再写入超级块
+ */
+static int ffs_format_device(ffs_t *fs) {
+    ffs_super_t super;
+    ffs_attr_t attr = {FFS_TAG_SUPER, FFS_ID_NONE, sizeof(ffs_super_t), &super};
+    ffs_commit_t commit;
+    uint32_t rev = 1;
+    int ret = ERROR_NONE;
+
+    for (uint32_t block = 0; block < 4 && ret == ERROR_NONE; block++) {
+        ret = ffs_bd_erase(fs, block);
+    }
+
+    commit.block = 2;
+    commit.off = 0;
+    commit.crc = 0;
+    if (ret == ERROR_NONE) {
+        ret = ffs_commit_prog(fs, &commit, &rev, sizeof(rev));
+    }
+    if (ret == ERROR_NONE) {
+        ret = ffs_commit_crc(fs, &commit);
+    }
+
+    super.magic = FFS_MAGIC;
+    super.version = FFS_VERSION;
+    super.block_size = fs->config.block_size;
+    super.block_count = fs->config.block_count;
+    super.meta[0] = 2;
+    super.meta[1] = 3;
+
+    commit.block = 0;
+    commit.off = 0;
+    commit.crc = 0;
+    if (ret == ERROR_NONE) {
+        ret = ffs_commit_prog(fs, &commit, &rev, sizeof(rev));
+    }
+    if (ret == ERROR_NONE) {
+        ret = ffs_commit_attr(fs, &commit, attr.type, attr.id, attr.data, attr.len);
+    }
+    if (ret == ERROR_NONE) {
+        ret = ffs_commit_crc(fs, &commit);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief 初始化文件系统模块
+ */
+int fs_init(void) {
+    memset(g_ffs_mounts, 0, sizeof(g_ffs_mounts));
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 反初始化文件系统模块，卸载所有文件系统
+ */
+int fs_deinit(void) {
+    for (uint8_t i = 0; i < CONFIG_FLASH_FS_MAX_MOUNTS; i++) {
+        if (g_ffs_mounts[i].mounted) {
+            fs_unmount((fs_handle_t)&g_ffs_mounts[i]);
+        }
+    }
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 挂载文件系统
+ */
+int fs_mount(const fs_mount_config_t *config, fs_handle_t *handle) {
+    const flash_fs_config_t *fs_config;
+    uint32_t sector_size = 0;
+    ffs_t *fs = NULL;
+    int ret;
+
+    if (config == NULL || handle == NULL || config->fs_config == NULL ||
+        (config->type != FS_TYPE_LITTLEFS && config->type != FS_TYPE_CUSTOM)) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    fs_config = (const flash_fs_config_t *)config->fs_config;
+    if (flash_get_info(fs_config->flash, NULL, &sector_size, NULL) != 0 || sector_size == 0 ||
+        fs_config->block_size < FFS_MIN_BLOCK_SIZE || (fs_config->block_size % sector_size) != 0 ||
+        fs_config->block_count < FFS_MIN_BLOCK_COUNT || (fs_config->base_address % fs_config->block_size) != 0) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    for (uint8_t i = 0; i < CONFIG_FLASH_FS_MAX_MOUNTS; i++) {
+        if (!g_ffs_mounts[i].mounted) {
+            fs = &g_ffs_mounts[i];
+            break;
+        }
+    }
+    if (fs == NULL) {
+        return ERROR_FULL;
+    }
+
+    memset(fs, 0, sizeof(ffs_t));
+    fs->config = *fs_config;
+    fs->type = config->type;
+    fs->sector_size = sector_size;
+    strncpy(fs->path, config->path, sizeof(fs->path) - 1);
+
+    ret = ffs_load(fs);
+    if (ret == ERROR_CRC && config->format_if_empty) {
+        ret = ffs_format_device(fs);
+        if (ret == ERROR_NONE) {
+            ret = ffs_load(fs);
+        }
+    }
+    if (ret != ERROR_NONE) {
+        return ret;
+    }
+
+#if (CURRENT_RTOS != RTOS_NONE)
+    if (rtos_mutex_create(&fs->mutex) != 0) {
+        return ERROR_MEMORY;
+    }
+#endif
+
+    fs->mounted = true;
+    *handle = (fs_handle_t)fs;
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 卸载文件系统，仍打开的文件被同步并关闭
+ */
+int fs_unmount(fs_handle_t handle) {
+    ffs_t *fs = ffs_from_handle(handle);
+    int ret = ERROR_NONE;
+
+    if (fs == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    FFS_LOCK(fs);
+    for (uint8_t i = 0; i < CONFIG_FLASH_FS_MAX_OPEN_FILES; i++) {
+        ffs_file_t *file = &fs->files[i];
+
+        if (file->used && (file->mode & FS_MODE_WRITE) != 0) {
+            int sync = ffs_file_sync(file);
+            if (ret == ERROR_NONE) {
+                ret = sync;
+            }
+        }
+        file->used = false;
+    }
+    for (uint8_t i = 0; i < CONFIG_FLASH_FS_MAX_OPEN_DIRS; i++) {
+        fs->dirs[i].used = false;
+    }
+    fs->mounted = false;
+    FFS_UNLOCK(fs);
+
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_mutex_delete(fs->mutex);
+#endif
+
+    return ret;
+}
+
+/**
+ * @brief 获取文件系统信息
+ */
+int fs_get_info(fs_handle_t handle, fs_info_t *info) {
+    ffs_t *fs = ffs_from_handle(handle);
+    uint32_t used = 0;
+    int ret;
+
+    if (fs == NULL || info == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    FFS_LOCK(fs);
+    ret = ffs_count_used(fs, &used);
+    FFS_UNLOCK(fs);
+
+    memset(info, 0, sizeof(fs_info_t));
+    info->total_size = fs->config.block_count * fs->config.block_size;
+    info->used_size = used * fs->config.block_size;
+    info->free_size = info->total_size - info->used_size;
+    info->block_size = fs->config.block_size;
+    info->max_filename_len = CONFIG_FLASH_FS_NAME_MAX;
+    info->type = fs->type;
+    strncpy(info->label, "flashfs", sizeof(info->label) - 1);
+
+    return ret;
+}
+
+/**
+ * @brief 格式化文件系统，要求没有打开的文件和目录
+ */
+int fs_format(fs_handle_t handle) {
+    ffs_t *fs = ffs_from_handle(handle);
+    int ret;
+
+    if (fs == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    FFS_LOCK(fs);
+    for (uint8_t i = 0; i < CONFIG_FLASH_FS_MAX_OPEN_FILES; i++) {
+        if (fs->files[i].used) {
+            FFS_UNLOCK(fs);
+            return ERROR_BUSY;
+        }
+    }
+    for (uint8_t i = 0; i < CONFIG_FLASH_FS_MAX_OPEN_DIRS; i++) {
+        if (fs->dirs[i].used) {
+            FFS_UNLOCK(fs);
+            return ERROR_BUSY;
+        }
+    }
+
+    ret = ffs_format_device(fs);
+    if (ret == ERROR_NONE) {
+        memset(&fs->stats, 0, sizeof(fs->stats));
+        ret = ffs_load(fs);
+    }
+    FFS_UNLOCK(fs);
+
+    return ret;
+}
+
+/*===========================================================================*/
+/* 文件操作                                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief 打开文件
+ *
+ * 新建文件的目录项立即提交；FS_MODE_TRUNCATE清空的内容在同步时才提交。
+ * 同一文件只能有一个以写模式打开的句柄
+ */
+int fs_open(fs_handle_t handle, const char *path, uint8_t mode, fs_file_handle_t *file) {
+    ffs_t *fs = ffs_from_handle(handle);
+    ffs_file_t *slot = NULL;
+    const char *name;
+    uint32_t name_len;
+    uint16_t parent;
+    uint16_t id;
+    int ret;
+
+    if (fs == NULL || path == NULL || file == NULL || (mode & (FS_MODE_READ | FS_MODE_WRITE)) == 0 ||
+        ((mode & (FS_MODE_CREATE | FS_MODE_TRUNCATE | FS_MODE_APPEND)) != 0 && (mode & FS_MODE_WRITE) == 0)) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    FFS_LOCK(fs);
+
+    for (uint8_t i = 0; i < CONFIG_FLASH_FS_MAX_OPEN_FILES; i++) {
+        if (!fs->files[i].used) {
+            slot = &fs->files[i];
+            break;
+        }
+    }
+
+    ret = ffs_lookup(fs, path, &id, &parent, &name, &name_len);
+    if (ret == ERROR_NONE && slot == NULL) {
+        ret = ERROR_FULL;
+    }
+
+    if (ret == ERROR_NONE && id == FFS_ID_NONE) {
+        if ((mode & FS_MODE_CREATE) == 0) {
+            ret = ERROR_NOT_FOUND;
+        } else {
+            ret = ffs_create(fs, parent, name, name_len, FFS_TYPE_FILE, &id);
+        }
+    } else if (ret == ERROR_NONE) {
+        if (fs->entries[id].type != FFS_TYPE_FILE) {
+            ret = ERROR_PERMISSION;
+        } else if ((mode & FS_MODE_WRITE) != 0) {
+            for (uint8_t i = 0; i < CONFIG_FLASH_FS_MAX_OPEN_FILES; i++) {
+                if (fs->files[i].used && fs->files[i].id == id && (fs->files[i].mode & FS_MODE_WRITE) != 0) {
+                    ret = ERROR_BUSY;
+                }
+            }
+        }
+    }
+
+    if (ret == ERROR_NONE) {
+        memset(slot, 0, sizeof(ffs_file_t));
+        slot->fs = fs;
+        slot->id = id;
+        slot->mode = mode;
+        slot->block = FFS_BLOCK_NONE;
+        ret = ffs_file_load(fs, slot, id);
+    }
+
+    if (ret == ERROR_NONE) {
+        if ((mode & FS_MODE_TRUNCATE) != 0 && (slot->size > 0 || (slot->flags & FFS_FILE_INLINE) == 0)) {
+            slot->head = 0;
+            slot->size = 0;
+            slot->flags = FFS_FILE_INLINE | FFS_FILE_DIRTY;
+        }
+        slot->used = true;
+        *file = (fs_file_handle_t)slot;
+    }
+
+    FFS_UNLOCK(fs);
+
+    return ret;
+}
+
+/**
+ * @brief 关闭文件，写模式打开的文件先同步
+ */
+int fs_close(fs_file_handle_t file) {
+    ffs_file_t *f = ffs_file_from_handle(file);
+    int ret = ERROR_NONE;
+
+    if (f == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    FFS_LOCK(f->fs);
+    if ((f->mode & FS_MODE_WRITE) != 0) {
+        ret = ffs_file_sync(f);
+    }
+    f->used = false;
+    FFS_UNLOCK(f->fs);
+
+    return ret;
+}
+
+/**
+ * @brief 读取文件
+ */
+int fs_read(fs_file_handle_t file, void *buffer, uint32_t size, uint32_t *bytes_read) {
+    ffs_file_t *f = ffs_file_from_handle(file);
+    uint8_t *data = (uint8_t *)buffer;
+    uint32_t total = 0;
+    ffs_t *fs;
+    int ret;
+
+    if (f == NULL || (buffer == NULL && size > 0)) {
+        return ERROR_INVALID_PARAM;
+    }
+    if ((f->mode & FS_MODE_READ) == 0) {
+        return ERROR_PERMISSION;
+    }
+
+    fs = f->fs;
+    FFS_LOCK(fs);
+
+    ret = ffs_file_flush(f);
+    if (ret != ERROR_NONE) {
+        f->flags |= FFS_FILE_ERRED;
+    } else if (f->pos < f->size) {
+        total = FFS_MIN(size, f->size - f->pos);
+
+        if ((f->flags & FFS_FILE_INLINE) != 0) {
+            memcpy(data, f->cache + f->pos, total);
+            f->pos += total;
+        } else {
+            uint32_t remaining = total;
+
+            while (remaining > 0 && ret == ERROR_NONE) {
+                uint32_t n;
+
+                if ((f->flags & FFS_FILE_READING) == 0 || f->off == fs->config.block_size) {
+                    ret = ffs_ctz_find(fs, f->head, f->size, f->pos, &f->block, &f->off);
+                    if (ret != ERROR_NONE) {
+                        break;
+                    }
+                    f->flags |= FFS_FILE_READING;
+                }
+
+                n = FFS_MIN(remaining, fs->config.block_size - f->off);
+                ret = ffs_bd_read(fs, f->block, f->off, data, n);
+                f->pos += n;
+                f->off += n;
+                data += n;
+                remaining -= n;
+            }
+        }
+    }
+
+    FFS_UNLOCK(fs);
+
+    if (bytes_read != NULL) {
+        *bytes_read = (ret == ERROR_NONE) ? total : 0;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief 写入文件
+ *
+ * 写入位置超出文件末尾时中间补零
+ */
+int fs_write(fs_file_handle_t file, const void *buffer, uint32_t size, uint32_t *bytes_written) {
+    ffs_file_t *f = ffs_file_from_handle(file);
+    const uint8_t *data = (const uint8_t *)buffer;
+    uint32_t requested = size;
+    ffs_t *fs;
+    int ret = ERROR_NONE;
+
+    if (bytes_written != NULL) {
+        *bytes_written = 0;
+    }
+    if (f == NULL || (buffer == NULL && size > 0)) {
+        return ERROR_INVALID_PARAM;
+    }
+    if ((f->mode & FS_MODE_WRITE) == 0) {
+        return ERROR_PERMISSION;
+    }
+    if ((f->flags & FFS_FILE_ERRED) != 0) {
+        return ERROR_IO;
+    }
+
+    fs = f->fs;
+    FFS_LOCK(fs);
+
+    f->flags &= (uint8_t)~FFS_FILE_READING;
+    if ((f->mode & FS_MODE_APPEND) != 0) {
+        f->pos = ffs_file_size(f);
+    }
+
+    if (size > FFS_FILE_MAX - f->pos) {
+        ret = ERROR_OVERFLOW;
+    } else if ((f->flags & FFS_FILE_INLINE) != 0) {
+        if (f->pos + size <= sizeof(f->cache)) {
+            if (f->pos > f->size) {
+                memset(f->cache + f->size, 0, f->pos - f->size);
+            }
+            memcpy(f->cache + f->pos, data, size);
+            f->pos += size;
+            if (f->pos > f->size) {
+                f->size = f->pos;
+            }
+            f->flags |= FFS_FILE_DIRTY;
+            size = 0;
+        } else {
+            ret = ffs_file_outline(f);
+        }
+    }
+
+    if (ret == ERROR_NONE && size > 0) {
+        /* 写入位置超出文件末尾时先补零 */
+        if ((f->flags & FFS_FILE_WRITING) == 0 && f->pos > f->size) {
+            uint32_t target = f->pos;
+
+            f->pos = f->size;
+            while (f->pos < target && ret == ERROR_NONE) {
+                ret = ffs_file_flushedwrite(f, g_ffs_zeros, FFS_MIN((uint32_t)sizeof(g_ffs_zeros), target - f->pos));
+            }
+        }
+
+        if (ret == ERROR_NONE) {
+            ret = ffs_file_flushedwrite(f, data, size);
+        }
+    }
+
+    if (ret != ERROR_NONE) {
+        f->flags |= FFS_FILE_ERRED;
+    } else if (bytes_written != NULL) {
+        *bytes_written = requested;
+    }
+
+    FFS_UNLOCK(fs);
+
+    return ret;
+}
+
+/**
+ * @brief 设置文件位置，写入会话先结束
+ */
+int fs_seek(fs_file_handle_t file, int32_t offset, fs_seek_mode_t mode) {
+    ffs_file_t *f = ffs_file_from_handle(file);
+    uint32_t base;
+    int ret;
+
+    if (f == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    FFS_LOCK(f->fs);
+
+    ret = ffs_file_flush(f);
+    if (ret != ERROR_NONE) {
+        f->flags |= FFS_FILE_ERRED;
+        FFS_UNLOCK(f->fs);
+        return ret;
+    }
+
+    switch (mode) {
+        case FS_SEEK_SET:
+            base = 0;
+            break;
+        case FS_SEEK_CUR:
+            base = f->pos;
+            break;
+        case FS_SEEK_END:
+            base = f->size;
+            break;
+        default:
+            FFS_UNLOCK(f->fs);
+            return ERROR_INVALID_PARAM;
+    }
+
+    if ((offset < 0 && (uint32_t)(-(int64_t)offset) > base) ||
+        (offset > 0 && (uint32_t)offset > FFS_FILE_MAX - base)) {
+        ret = ERROR_INVALID_PARAM;
+    } else {
+        f->pos = (uint32_t)((int64_t)base + offset);
+    }
+
+    FFS_UNLOCK(f->fs);
+
+    return ret;
+}
+
+/**
+ * @brief 获取文件当前位置
+ */
+int fs_tell(fs_file_handle_t file, uint32_t *position) {
+    ffs_file_t *f = ffs_file_from_handle(file);
+
+    if (f == NULL || position == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    *position = f->pos;
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 同步文件，返回时新内容已作为一次提交写入
+ */
+int fs_flush(fs_file_handle_t file) {
+    ffs_file_t *f = ffs_file_from_handle(file);
+    int ret = ERROR_NONE;
+
+    if (f == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if ((f->mode & FS_MODE_WRITE) != 0) {
+        FFS_LOCK(f->fs);
+        ret = ffs_file_sync(f);
+        FFS_UNLOCK(f->fs);
+    }
+
+    return ret;
+}
+
+/*===========================================================================*/
+/* 目录操作                                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief 获取文件信息
+ */
+int fs_stat(fs_handle_t handle, const char *path, fs_file_info_t *info) {
+    ffs_t *fs = ffs_from_handle(handle);
+    const char *name;
+    uint32_t name_len;
+    uint16_t parent;
+    uint16_t id;
+    int ret;
+
+    if (fs == NULL || path == NULL || info == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    FFS_LOCK(fs);
+    ret = ffs_lookup(fs, path, &id, &parent, &name, &name_len);
+    if (ret == ERROR_NONE && id == FFS_ID_NONE) {
+        ret = ERROR_NOT_FOUND;
+    }
+    if (ret == ERROR_NONE) {
+        ret = ffs_fill_info(fs, id, info);
+    }
+    FFS_UNLOCK(fs);
+
+    return ret;
+}
+
+/* 删除目录项，dir_only为true时只删除目录 */
+static int ffs_remove(ffs_t *fs, const char *path, bool dir_only) {
+    ffs_attr_t attr = {FFS_TAG_DELETE, 0, 0, NULL};
+    const char *name;
+    uint32_t name_len;
+    uint16_t parent;
+    uint16_t id;
+    int ret;
+
+    FFS_LOCK(fs);
+    ret = ffs_lookup(fs, path, &id, &parent, &name, &name_len);
+    if (ret == ERROR_NONE) {
+        if (id == FFS_ID_NONE) {
+            ret = ERROR_NOT_FOUND;
+        } else if (id == FFS_ROOT_ID) {
+            ret = ERROR_PERMISSION;
+        } else if (dir_only && fs->entries[id].type != FFS_TYPE_DIR) {
+            ret = ERROR_INVALID_PARAM;
+        } else if (fs->entries[id].type == FFS_TYPE_DIR && ffs_dir_has_children(fs, id)) {
+            ret = ERROR_BUSY;
+        } else if (ffs_is_open(fs, id)) {
+            ret = ERROR_BUSY;
+        }
+    }
+
+    if (ret == ERROR_NONE) {
+        attr.id = id;
+        ret = ffs_pair_commit(fs, &fs->meta, &attr, 1);
+    }
+    FFS_UNLOCK(fs);
+
+    return ret;
+}
+
+/**
+ * @brief 删除文件或空目录
+ */
+int fs_remove(fs_handle_t handle, const char *path) {
+    ffs_t *fs = ffs_from_handle(handle);
+
+    if (fs == NULL || path == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    return ffs_remove(fs, path, false);
+}
+
+/**
+ * @brief 重命名文件或目录
+ *
+ * 目标已存在时被替换。删除目标和修改名称在同一次提交中完成，任意时刻掉电
+ * 后目标路径要么是原内容，要么是新内容
+ */
+int fs_rename(fs_handle_t handle, const char *old_path, const char *new_path) {
+    ffs_t *fs = ffs_from_handle(handle);
+    uint8_t record[sizeof(ffs_name_t) + CONFIG_FLASH_FS_NAME_MAX];
+    ffs_attr_t attrs[2];
+    uint32_t count = 0;
+    const char *name;
+    uint32_t name_len;
+    uint16_t parent;
+    uint16_t old_id;
+    uint16_t new_id;
+    int ret;
+
+    if (fs == NULL || old_path == NULL || new_path == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    FFS_LOCK(fs);
+
+    ret = ffs_lookup(fs, old_path, &old_id, &parent, &name, &name_len);
+    if (ret == ERROR_NONE && (old_id == FFS_ID_NONE || old_id == FFS_ROOT_ID)) {
+        ret = (old_id == FFS_ID_NONE) ? ERROR_NOT_FOUND : ERROR_PERMISSION;
+    }
+    if (ret == ERROR_NONE) {
+        ret = ffs_lookup(fs, new_path, &new_id, &parent, &name, &name_len);
+    }
+    if (ret == ERROR_NONE && new_id == FFS_ROOT_ID) {
+        ret = ERROR_PERMISSION;
+    }
+
+    if (ret == ERROR_NONE && new_id == old_id) {
+        FFS_UNLOCK(fs);
+        return ERROR_NONE;
+    }
+
+    /* 目录不能移动到自己的子目录中 */
+    for (uint16_t dir = parent; ret == ERROR_NONE && dir != FFS_ROOT_ID; dir = fs->entries[dir].parent) {
+        if (dir == old_id) {
+            ret = ERROR_INVALID_PARAM;
+        }
+    }
+
+    if (ret == ERROR_NONE && new_id != FFS_ID_NONE) {
+        const ffs_entry_t *target = &fs->entries[new_id];
+
+        if (target->type != fs->entries[old_id].type) {
+            ret = ERROR_ALREADY_EXISTS;
+        } else if (target->type == FFS_TYPE_DIR && ffs_dir_has_children(fs, new_id)) {
+            ret = ERROR_BUSY;
+        } else if (ffs_is_open(fs, new_id)) {
+            ret = ERROR_BUSY;
+        } else {
+            attrs[count].type = FFS_TAG_DELETE;
+            attrs[count].id = new_id;
+            attrs[count].len = 0;
+            attrs[count].data = NULL;
+            count++;
+        }
+    }
+
+    if (ret == ERROR_NONE) {
+        attrs[count].type = FFS_TAG_NAME;
+        attrs[count].id = old_id;
+        attrs[count].len = ffs_name_record(record, parent, fs->entries[old_id].type, name, name_len);
+        attrs[count].data = record;
+        count++;
+        ret = ffs_pair_commit(fs, &fs->meta, attrs, count);
+    }
+
+    FFS_UNLOCK(fs);
+
+    return ret;
+}
+
+/**
+ * @brief 创建目录
+ */
+int fs_mkdir(fs_handle_t handle, const char *path) {
+    ffs_t *fs = ffs_from_handle(handle);
+    const char *name;
+    uint32_t name_len;
+    uint16_t parent;
+    uint16_t id;
+    int ret;
+
+    if (fs == NULL || path == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    FFS_LOCK(fs);
+    ret = ffs_lookup(fs, path, &id, &parent, &name, &name_len);
+    if (ret == ERROR_NONE && id != FFS_ID_NONE) {
+        ret = ERROR_ALREADY_EXISTS;
+    }
+    if (ret == ERROR_NONE) {
+        ret = ffs_create(fs, parent, name, name_len, FFS_TYPE_DIR, &id);
+    }
+    FFS_UNLOCK(fs);
+
+    return ret;
+}
+
+/**
+ * @brief 删除空目录
+ */
+int fs_rmdir(fs_handle_t handle, const char *path) {
+    ffs_t *fs = ffs_from_handle(handle);
+
+    if (fs == NULL || path == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    return ffs_remove(fs, path, true);
+}
+
+/**
+ * @brief 打开目录
+ */
+int fs_opendir(fs_handle_t handle, const char *path, fs_dir_handle_t *dir) {
+    ffs_t *fs = ffs_from_handle(handle);
+    ffs_dir_t *slot = NULL;
+    const char *name;
+    uint32_t name_len;
+    uint16_t parent;
+    uint16_t id;
+    int ret;
+
+    if (fs == NULL || path == NULL || dir == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    FFS_LOCK(fs);
+    ret = ffs_lookup(fs, path, &id, &parent, &name, &name_len);
+    if (ret == ERROR_NONE && id == FFS_ID_NONE) {
+        ret = ERROR_NOT_FOUND;
+    } else if (ret == ERROR_NONE && fs->entries[id].type != FFS_TYPE_DIR) {
+        ret = ERROR_INVALID_PARAM;
+    }
+
+    for (uint8_t i = 0; ret == ERROR_NONE && i < CONFIG_FLASH_FS_MAX_OPEN_DIRS; i++) {
+        if (!fs->dirs[i].used) {
+            slot = &fs->dirs[i];
+            break;
+        }
+    }
+    if (ret == ERROR_NONE && slot == NULL) {
+        ret = ERROR_FULL;
+    }
+
+    if (ret == ERROR_NONE) {
+        slot->fs = fs;
+        slot->id = id;
+        slot->next = 1;
+        slot->used = true;
+        *dir = (fs_dir_handle_t)slot;
+    }
+    FFS_UNLOCK(fs);
+
+    return ret;
+}
+
+/**
+ * @brief 关闭目录
+ */
+int fs_closedir(fs_dir_handle_t dir) {
+    ffs_dir_t *d = ffs_dir_from_handle(dir);
+
+    if (d == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    d->used = false;
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 读取目录项，按目录项编号顺序返回
+ */
+int fs_readdir(fs_dir_handle_t dir, fs_file_info_t *info) {
+    ffs_dir_t *d = ffs_dir_from_handle(dir);
+    int ret = 1;
+
+    if (d == NULL || info == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    FFS_LOCK(d->fs);
+    while (d->next < CONFIG_FLASH_FS_MAX_ENTRIES) {
+        uint16_t id = d->next++;
+        const ffs_entry_t *entry = &d->fs->entries[id];
+
+        if (entry->type != FFS_TYPE_NONE && entry->parent == d->id) {
+            ret = ffs_fill_info(d->fs, id, info);
+            break;
+        }
+    }
+    FFS_UNLOCK(d->fs);
+
+    return ret;
+}
+
+/**
+ * @brief 重置目录读取位置
+ */
+int fs_rewinddir(fs_dir_handle_t dir) {
+    ffs_dir_t *d = ffs_dir_from_handle(dir);
+
+    if (d == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    d->next = 1;
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 获取文件系统统计信息
+ */
+int flash_fs_get_stats(fs_handle_t handle, flash_fs_stats_t *stats) {
+    ffs_t *fs = ffs_from_handle(handle);
+    uint32_t used = 0;
+    int ret;
+
+    if (fs == NULL || stats == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    FFS_LOCK(fs);
+    ret = ffs_count_used(fs, &used);
+    *stats = fs->stats;
+    stats->block_count = fs->config.block_count;
+    stats->used_blocks = used;
+    stats->entries = 0;
+    for (uint16_t id = 1; id < CONFIG_FLASH_FS_MAX_ENTRIES; id++) {
+        if (fs->entries[id].type != FFS_TYPE_NONE) {
+            stats->entries++;
+        }
+    }
+    stats->meta_revision = fs->meta.rev;
+    stats->meta_used = fs->meta.end;
+    FFS_UNLOCK(fs);
+
+    return ret;
+}
@@ -0,0 +1,860 @@
+/**
+ * @file common_flash_kv.c
+ * @brief Flash日志结构键值存储实现（平台无关）
+ *
+ * 扇区布局：16字节扇区头{magic, 擦除次数, 启用顺序, ~擦除次数}之后是连续
+ * 追加的记录。擦除后立即写入除启用顺序外的扇区头，扇区成为空闲扇区；
+ * 启用为写入扇区时再单独编程启用顺序字。记录为8字节记录头{键长, 类型,
+ * 值长, CRC32}加键和值，按4字节对齐，CRC覆盖记录头前4字节、键和值。
+ */
+
+#include "base/flash_kv_api.h"
+#include <string.h>
+
+#define KV_SECTOR_MAGIC         0x4B56534DUL    /* "MSVK" */
+#define KV_SECTOR_HEADER_SIZE   16
+#define KV_SEQ_OFFSET           8
+#define KV_ERASED_WORD          0xFFFFFFFFUL
+
+#define KV_RECORD_VALUE         0x5A            /* 键值记录 */
+#define KV_RECORD_DELETE        0xA5            /* 删除记录 */
+
+#define KV_ADDR_NONE            0xFFFFFFFFUL
+#define KV_SECTOR_NONE          0xFFFF
+#define KV_INDEX_MASK           (CONFIG_FLASH_KV_INDEX_SIZE - 1)
+
+#define KV_ALIGN4(x)            (((x) + 3U) & ~3U)
+
+#if (CURRENT_RTOS != RTOS_NONE)
+#define KV_LOCK(kv)             rtos_mutex_lock((kv)->mutex, UINT32_MAX)
+#define KV_UNLOCK(kv)           rtos_mutex_unlock((kv)->mutex)
+#else
+#define KV_LOCK(kv)             ((void)0)
+#define KV_UNLOCK(kv)           ((void)0)
+#endif
+
+/* 记录头 */
+typedef struct {
+    uint8_t key_len;            /* 键长度 */
+    uint8_t type;               /* 记录类型 */
+    uint16_t value_len;         /* 值长度 */
+    uint32_t crc;               /* CRC32 */
+} kv_record_header_t;
+
+/* 回收单步结果 */
+#define KV_GC_PROGRESS          0   /* 还有记录待迁移 */
+#define KV_GC_DONE              1   /* 扇区已擦除 */
+
+/**
+ * @brief 计算CRC32(IEEE 802.3)，使用半字节查找表
+ */
+static uint32_t kv_crc32(uint32_t crc, const uint8_t *data, uint32_t len) {
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc = table[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+        crc = table[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+
+    return ~crc;
+}
+
+/**
+ * @brief 计算键哈希(FNV-1a)
+ */
+static uint32_t kv_hash(const uint8_t *key, uint32_t len) {
+    uint32_t hash = 2166136261UL;
+
+    for (uint32_t i = 0; i < len; i++) {
+        hash = (hash ^ key[i]) * 16777619UL;
+    }
+
+    return hash;
+}
+
+/* 扇区起始地址 */
+static uint32_t kv_sector_address(const flash_kv_t *kv, uint16_t sector) {
+    return kv->config.base_address + (uint32_t)sector * kv->config.sector_size;
+}
+
+/* 记录总长度 */
+static uint32_t kv_record_size(const kv_record_header_t *header) {
+    return KV_ALIGN4(FLASH_KV_RECORD_HEADER_SIZE + header->key_len + header->value_len);
+}
+
+/**
+ * @brief 读取并检查记录头
+ *
+ * @return int FLASH_KV_OK表示记录头合法，FLASH_KV_NOT_FOUND表示已到日志末尾
+ */
+static int kv_read_header(flash_kv_t *kv, uint32_t address, uint32_t limit, kv_record_header_t *header) {
+    if (address + FLASH_KV_RECORD_HEADER_SIZE > limit) {
+        return FLASH_KV_NOT_FOUND;
+    }
+
+    if (flash_read(kv->config.flash, address, header, sizeof(kv_record_header_t)) != 0) {
+        return FLASH_KV_IO_ERROR;
+    }
+
+    uint32_t first;
+    memcpy(&first, header, sizeof(first));
+    if (first == KV_ERASED_WORD) {
+        return FLASH_KV_NOT_FOUND;
+    }
+
+    if (header->key_len == 0 || header->key_len > CONFIG_FLASH_KV_MAX_KEY_LEN ||
+        header->value_len > CONFIG_FLASH_KV_MAX_VALUE_LEN ||
+        (header->type != KV_RECORD_VALUE && header->type != KV_RECORD_DELETE) ||
+        address + kv_record_size(header) > limit) {
+        return FLASH_KV_INVALID_PARAM;
+    }
+
+    return FLASH_KV_OK;
+}
+
+/**
+ * @brief 把整条记录读入缓冲区并校验CRC
+ */
+static int kv_load_record(flash_kv_t *kv, uint32_t address, const kv_record_header_t *header) {
+    uint32_t size = kv_record_size(header);
+    uint32_t crc;
+
+    if (flash_read(kv->config.flash, address, kv->buffer, size) != 0) {
+        return FLASH_KV_IO_ERROR;
+    }
+
+    crc = kv_crc32(0, kv->buffer, 4);
+    crc = kv_crc32(crc, &kv->buffer[FLASH_KV_RECORD_HEADER_SIZE], header->key_len + header->value_len);
+
+    return (crc == header->crc) ? FLASH_KV_OK : FLASH_KV_INVALID_PARAM;
+}
+
+/**
+ * @brief 比较记录的键
+ */
+static bool kv_key_matches(flash_kv_t *kv, uint32_t address, const uint8_t *key, uint8_t key_len) {
+    kv_record_header_t header;
+    uint8_t stored[CONFIG_FLASH_KV_MAX_KEY_LEN];
+
+    if (flash_read(kv->config.flash, address, &header, sizeof(header)) != 0 || header.key_len != key_len) {
+        return false;
+    }
+
+    if (flash_read(kv->config.flash, address + FLASH_KV_RECORD_HEADER_SIZE, stored, key_len) != 0) {
+        return false;
+    }
+
+    return memcmp(stored, key, key_len) == 0;
+}
+
+/**
+ * @brief 在索引中查找键
+ *
+ * @return uint32_t 索引槽位，不存在时返回可插入的空槽位并置found为false
+ */
+static uint32_t kv_index_find(flash_kv_t *kv, const uint8_t *key, uint8_t key_len, uint32_t hash, bool *found) {
+    uint32_t slot = hash & KV_INDEX_MASK;
+
+    while (kv->index[slot].address != KV_ADDR_NONE) {
+        if (kv->index[slot].hash == hash && kv_key_matches(kv, kv->index[slot].address, key, key_len)) {
+            *found = true;
+            return slot;
+        }
+        slot = (slot + 1) & KV_INDEX_MASK;
+    }
+
+    *found = false;
+    return slot;
+}
+
+/**
+ * @brief 从索引中移除槽位，后移簇内元素保持线性探测连续
+ */
+static void kv_index_remove(flash_kv_t *kv, uint32_t slot) {
+    uint32_t next = slot;
+
+    kv->index[slot].address = KV_ADDR_NONE;
+    kv->key_count--;
+
+    for (;;) {
+        next = (next + 1) & KV_INDEX_MASK;
+        if (kv->index[next].address == KV_ADDR_NONE) {
+            return;
+        }
+
+        /* 元素的理想位置不在(slot, next]区间内时移动到空槽位 */
+        uint32_t ideal = kv->index[next].hash & KV_INDEX_MASK;
+        if (((next - ideal) & KV_INDEX_MASK) >= ((next - slot) & KV_INDEX_MASK)) {
+            kv->index[slot] = kv->index[next];
+            kv->index[next].address = KV_ADDR_NONE;
+            slot = next;
+        }
+    }
+}
+
+/**
+ * @brief 按记录更新索引
+ */
+static int kv_index_apply(flash_kv_t *kv, uint32_t address, const kv_record_header_t *header, const uint8_t *key) {
+    uint32_t hash = kv_hash(key, header->key_len);
+    bool found;
+    uint32_t slot = kv_index_find(kv, key, header->key_len, hash, &found);
+
+    if (header->type == KV_RECORD_DELETE) {
+        if (found) {
+            kv_index_remove(kv, slot);
+        }
+        return FLASH_KV_OK;
+    }
+
+    if (!found) {
+        if (kv->key_count >= CONFIG_FLASH_KV_MAX_KEYS) {
+            return FLASH_KV_NO_SPACE;
+        }
+        kv->index[slot].hash = hash;
+        kv->key_count++;
+    }
+    kv->index[slot].address = address;
+
+    return FLASH_KV_OK;
+}
+
+/**
+ * @brief 擦除扇区并写入空闲扇区头
+ */
+static int kv_erase_sector(flash_kv_t *kv, uint16_t sector, uint32_t erase_count) {
+    uint32_t header[4] = {KV_SECTOR_MAGIC, erase_count, KV_ERASED_WORD, ~erase_count};
+    uint32_t address = kv_sector_address(kv, sector);
+
+    if (flash_erase_sector(kv->config.flash, address) != 0 ||
+        flash_write(kv->config.flash, address, header, sizeof(header)) != 0) {
+        return FLASH_KV_IO_ERROR;
+    }
+
+    kv->sectors[sector].erase_count = erase_count;
+    kv->sectors[sector].seq = KV_ERASED_WORD;
+    kv->sectors[sector].write_offset = KV_SECTOR_HEADER_SIZE;
+    kv->free_count++;
+    kv->stats.erases++;
+
+    return FLASH_KV_OK;
+}
+
+/**
+ * @brief 启用擦除次数最少的空闲扇区作为写入扇区
+ */
+static int kv_open_sector(flash_kv_t *kv) {
+    uint16_t best = KV_SECTOR_NONE;
+
+    for (uint16_t i = 0; i < kv->config.sector_count; i++) {
+        if (kv->sectors[i].seq == KV_ERASED_WORD &&
+            (best == KV_SECTOR_NONE || kv->sectors[i].erase_count < kv->sectors[best].erase_count)) {
+            best = i;
+        }
+    }
+
+    if (best == KV_SECTOR_NONE) {
+        return FLASH_KV_NO_SPACE;
+    }
+
+    uint32_t seq = kv->next_seq;
+    if (flash_write(kv->config.flash, kv_sector_address(kv, best) + KV_SEQ_OFFSET, &seq, sizeof(seq)) != 0) {
+        return FLASH_KV_IO_ERROR;
+    }
+
+    kv->next_seq++;
+    kv->sectors[best].seq = seq;
+    kv->free_count--;
+    kv->head = best;
+
+    return FLASH_KV_OK;
+}
+
+/**
+ * @brief 在写入扇区末尾追加缓冲区中的记录
+ *
+ * 写入扇区放不下时启用新扇区，调用者需保证有可用的空闲扇区
+ */
+static int kv_append(flash_kv_t *kv, uint32_t size, uint32_t *address) {
+    flash_kv_sector_t *head = &kv->sectors[kv->head];
+    int ret;
+
+    if (head->write_offset + size > kv->config.sector_size) {
+        ret = kv_open_sector(kv);
+        if (ret != FLASH_KV_OK) {
+            return ret;
+        }
+        head = &kv->sectors[kv->head];
+    }
+
+    *address = kv_sector_address(kv, kv->head) + head->write_offset;
+    if (flash_write(kv->config.flash, *address, kv->buffer, size) != 0) {
+        /* 可能写入了部分数据，放弃该扇区剩余空间 */
+        head->write_offset = kv->config.sector_size;
+        return FLASH_KV_IO_ERROR;
+    }
+    head->write_offset += size;
+
+    return FLASH_KV_OK;
+}
+
+/**
+ * @brief 选择最旧的扇区作为回收对象
+ *
+ * 只回收最旧的扇区，比它更旧的记录都已不存在，删除记录可以直接丢弃
+ *
+ * @param forced 只有写入扇区在使用时是否回收写入扇区本身
+ */
+static uint16_t kv_pick_victim(const flash_kv_t *kv, bool forced) {
+    uint16_t oldest = KV_SECTOR_NONE;
+    uint16_t active = 0;
+
+    for (uint16_t i = 0; i < kv->config.sector_count; i++) {
+        if (kv->sectors[i].seq == KV_ERASED_WORD) {
+            continue;
+        }
+        active++;
+        if (oldest == KV_SECTOR_NONE || kv->sectors[i].seq < kv->sectors[oldest].seq) {
+            oldest = i;
+        }
+    }
+
+    if (oldest == kv->head && (active > 1 || !forced)) {
+        return KV_SECTOR_NONE;
+    }
+
+    return oldest;
+}
+
+/**
+ * @brief 回收一步：迁移最多limit条有效记录，扇区迁移完毕后擦除
+ *
+ * 最后一个空闲扇区只留给强制回收使用。强制回收一旦开始就把回收扇区迁移
+ * 完毕，有效数据不超过一个扇区，因此总能放进写入扇区余量加一个新扇区
+ *
+ * @param forced 空间不足时由写入触发，可以使用最后一个空闲扇区
+ * @return int KV_GC_PROGRESS、KV_GC_DONE或负数错误码
+ */
+static int kv_gc_run(flash_kv_t *kv, uint32_t limit, bool forced) {
+    kv_record_header_t header;
+    int ret;
+
+    if (kv->gc_sector == KV_SECTOR_NONE) {
+        kv->gc_sector = kv_pick_victim(kv, forced);
+        if (kv->gc_sector == KV_SECTOR_NONE) {
+            return FLASH_KV_NO_SPACE;
+        }
+        kv->gc_offset = KV_SECTOR_HEADER_SIZE;
+
+        /* 回收写入扇区本身时先封存，迁移的记录写入新扇区 */
+        if (kv->gc_sector == kv->head) {
+            kv->sectors[kv->head].write_offset = kv->config.sector_size;
+        }
+    }
+
+    uint32_t base = kv_sector_address(kv, kv->gc_sector);
+    uint32_t limit_address = base + kv->config.sector_size;
+
+    while (limit > 0) {
+        uint32_t address = base + kv->gc_offset;
+
+        ret = kv_read_header(kv, address, limit_address, &header);
+        if (ret == FLASH_KV_IO_ERROR) {
+            return ret;
+        }
+        if (ret != FLASH_KV_OK || kv_load_record(kv, address, &header) != FLASH_KV_OK) {
+            /* 日志末尾或损坏记录之后没有有效数据 */
+            break;
+        }
+
+        /* 只迁移索引仍指向的键值记录 */
+        if (header.type == KV_RECORD_VALUE) {
+            bool found;
+            const uint8_t *key = &kv->buffer[FLASH_KV_RECORD_HEADER_SIZE];
+            uint32_t slot = kv_index_find(kv, key, header.key_len, kv_hash(key, header.key_len), &found);
+
+            if (found && kv->index[slot].address == address) {
+                uint32_t new_address;
+                uint32_t size = kv_record_size(&header);
+
+                if (!forced && kv->free_count <= 1 &&
+                    kv->sectors[kv->head].write_offset + size > kv->config.sector_size) {
+                    return KV_GC_PROGRESS;
+                }
+
+                ret = kv_append(kv, size, &new_address);
+                if (ret != FLASH_KV_OK) {
+                    return ret;
+                }
+                kv->index[slot].address = new_address;
+                kv->stats.gc_copies++;
+                limit--;
+            }
+        }
+
+        kv->gc_offset += kv_record_size(&header);
+    }
+
+    if (limit == 0) {
+        return KV_GC_PROGRESS;
+    }
+
+    ret = kv_erase_sector(kv, kv->gc_sector, kv->sectors[kv->gc_sector].erase_count + 1);
+    kv->gc_sector = KV_SECTOR_NONE;
+
+    return (ret == FLASH_KV_OK) ? KV_GC_DONE : ret;
+}
+
+/**
+ * @brief 为用户记录准备空间
+ *
+ * 保留一个空闲扇区供回收迁移使用，空闲扇区不足时先完成回收
+ */
+static int kv_make_room(flash_kv_t *kv, uint32_t size) {
+    for (uint32_t attempt = 0; attempt <= kv->config.sector_count; attempt++) {
+        if (kv->sectors[kv->head].write_offset + size <= kv->config.sector_size) {
+            return FLASH_KV_OK;
+        }
+
+        if (kv->free_count > 1) {
+            return kv_open_sector(kv);
+        }
+
+        int ret = kv_gc_run(kv, UINT32_MAX, true);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    return FLASH_KV_NO_SPACE;
+}
+
+/**
+ * @brief 在缓冲区中构造记录并追加
+ */
+static int kv_write_record(flash_kv_t *kv, uint8_t type, const char *key, uint8_t key_len,
+                           const void *value, uint16_t len, uint32_t *address) {
+    kv_record_header_t header;
+    uint32_t size;
+    int ret;
+
+    header.key_len = key_len;
+    header.type = type;
+    header.value_len = len;
+    size = kv_record_size(&header);
+
+    ret = kv_make_room(kv, size);
+    if (ret != FLASH_KV_OK) {
+        return ret;
+    }
+
+    /* 回收会使用缓冲区，空间准备好后再构造记录 */
+    memset(kv->buffer, 0xFF, size);
+    memcpy(kv->buffer, &header, 4);
+    memcpy(&kv->buffer[FLASH_KV_RECORD_HEADER_SIZE], key, key_len);
+    if (len > 0) {
+        memcpy(&kv->buffer[FLASH_KV_RECORD_HEADER_SIZE + key_len], value, len);
+    }
+    header.crc = kv_crc32(0, kv->buffer, 4);
+    header.crc = kv_crc32(header.crc, &kv->buffer[FLASH_KV_RECORD_HEADER_SIZE], key_len + len);
+    memcpy(&kv->buffer[4], &header.crc, 4);
+
+    return kv_append(kv, size, address);
+}
+
+/**
+ * @brief 增量回收，空闲扇区较多时不执行
+ */
+static int kv_gc_incremental(flash_kv_t *kv) {
+    if (kv->free_count > CONFIG_FLASH_KV_GC_THRESHOLD && kv->gc_sector == KV_SECTOR_NONE) {
+        return FLASH_KV_OK;
+    }
+
+    int ret = kv_gc_run(kv, CONFIG_FLASH_KV_GC_STEP, false);
+
+    return (ret == FLASH_KV_NO_SPACE || ret >= 0) ? FLASH_KV_OK : ret;
+}
+
+/**
+ * @brief 扫描扇区内的记录并重建索引
+ */
+static void kv_replay_sector(flash_kv_t *kv, uint16_t sector) {
+    uint32_t base = kv_sector_address(kv, sector);
+    uint32_t limit = base + kv->config.sector_size;
+    uint32_t offset = KV_SECTOR_HEADER_SIZE;
+    kv_record_header_t header;
+    int ret;
+
+    for (;;) {
+        ret = kv_read_header(kv, base + offset, limit, &header);
+        if (ret == FLASH_KV_NOT_FOUND) {
+            break;
+        }
+        if (ret != FLASH_KV_OK || kv_load_record(kv, base + offset, &header) != FLASH_KV_OK) {
+            /* 掉电中断的写入，封存扇区剩余空间 */
+            kv->stats.corrupt_records++;
+            offset = kv->config.sector_size;
+            break;
+        }
+
+        if (kv_index_apply(kv, base + offset, &header, &kv->buffer[FLASH_KV_RECORD_HEADER_SIZE]) != FLASH_KV_OK) {
+            kv->stats.corrupt_records++;
+        }
+        offset += kv_record_size(&header);
+    }
+
+    kv->sectors[sector].write_offset = offset;
+}
+
+/**
+ * @brief 检查区域配置：扇区数、扇区大小能否容纳最大记录以及字对齐
+ */
+static bool kv_config_valid(const flash_kv_config_t *config) {
+    return config->sector_count >= 2 &&
+           config->sector_count <= CONFIG_FLASH_KV_MAX_SECTORS &&
+           config->sector_size >= KV_SECTOR_HEADER_SIZE + FLASH_KV_RECORD_MAX_SIZE &&
+           (config->sector_size % 4) == 0 && (config->base_address % 4) == 0;
+}
+
+/**
+ * @brief 挂载键值存储
+ */
+int flash_kv_mount(flash_kv_t *kv, const flash_kv_config_t *config) {
+    uint32_t header[4];
+    uint32_t max_erase = 0;
+    uint32_t last_seq = 0;
+    bool valid[CONFIG_FLASH_KV_MAX_SECTORS];
+    int ret;
+
+    if (kv == NULL || config == NULL || !kv_config_valid(config)) {
+        return FLASH_KV_INVALID_PARAM;
+    }
+
+    memset(kv, 0, sizeof(flash_kv_t));
+    kv->config = *config;
+    kv->head = KV_SECTOR_NONE;
+    kv->gc_sector = KV_SECTOR_NONE;
+    kv->next_seq = 1;
+    for (uint32_t i = 0; i < CONFIG_FLASH_KV_INDEX_SIZE; i++) {
+        kv->index[i].address = KV_ADDR_NONE;
+    }
+
+    /* 读取扇区头 */
+    for (uint16_t i = 0; i < config->sector_count; i++) {
+        if (flash_read(config->flash, kv_sector_address(kv, i), header, sizeof(header)) != 0) {
+            return FLASH_KV_IO_ERROR;
+        }
+
+        valid[i] = (header[0] == KV_SECTOR_MAGIC && header[3] == ~header[1]);
+        if (!valid[i]) {
+            continue;
+        }
+
+        kv->sectors[i].erase_count = header[1];
+        kv->sectors[i].seq = header[2];
+        kv->sectors[i].write_offset = KV_SECTOR_HEADER_SIZE;
+        if (header[1] > max_erase) {
+            max_erase = header[1];
+        }
+        if (header[2] == KV_ERASED_WORD) {
+            kv->free_count++;
+        } else if (header[2] >= kv->next_seq) {
+            kv->next_seq = header[2] + 1;
+        }
+    }
+
+    /* 未格式化或擦除中途掉电的扇区，擦除次数按已知最大值估计 */
+    for (uint16_t i = 0; i < config->sector_count; i++) {
+        if (!valid[i]) {
+            ret = kv_erase_sector(kv, i, max_erase);
+            if (ret != FLASH_KV_OK) {
+                return ret;
+            }
+        }
+    }
+
+    /* 按启用顺序重放所有扇区 */
+    for (;;) {
+        uint16_t next = KV_SECTOR_NONE;
+
+        for (uint16_t i = 0; i < config->sector_count; i++) {
+            uint32_t seq = kv->sectors[i].seq;
+            if (seq != KV_ERASED_WORD && seq > last_seq &&
+                (next == KV_SECTOR_NONE || seq < kv->sectors[next].seq)) {
+                next = i;
+            }
+        }
+
+        if (next == KV_SECTOR_NONE) {
+            break;
+        }
+
+        kv_replay_sector(kv, next);
+        last_seq = kv->sectors[next].seq;
+        kv->head = next;
+    }
+
+    if (kv->head == KV_SECTOR_NONE) {
+        ret = kv_open_sector(kv);
+        if (ret != FLASH_KV_OK) {
+            return ret;
+        }
+    }
+
+#if (CURRENT_RTOS != RTOS_NONE)
+    if (rtos_mutex_create(&kv->mutex) != 0) {
+        return FLASH_KV_NO_SPACE;
+    }
+#endif
+
+    kv->mounted = true;
+
+    return FLASH_KV_OK;
+}
+
+/**
+ * @brief 卸载键值存储
+ */
+int flash_kv_unmount(flash_kv_t *kv) {
+    if (kv == NULL || !kv->mounted) {
+        return FLASH_KV_INVALID_PARAM;
+    }
+
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_mutex_delete(kv->mutex);
+#endif
+
+    kv->mounted = false;
+
+    return FLASH_KV_OK;
+}
+
+/**
+ * @brief 擦除区域内全部数据并重新挂载
+ */
+int flash_kv_format(flash_kv_t *kv, const flash_kv_config_t *config) {
+    uint32_t erase_count;
+
+    /* 与挂载相同的配置检查，通过后才访问对象和擦除扇区 */
+    if (kv == NULL || config == NULL || !kv_config_valid(config)) {
+        return FLASH_KV_INVALID_PARAM;
+    }
+
+    if (kv->mounted) {
+        flash_kv_unmount(kv);
+    }
+
+    /* 保留擦除次数，未格式化的扇区从0开始 */
+    for (uint16_t i = 0; i < config->sector_count; i++) {
+        uint32_t header[4];
+        uint32_t address = config->base_address + (uint32_t)i * config->sector_size;
+
+        if (flash_read(config->flash, address, header, sizeof(header)) != 0) {
+            return FLASH_KV_IO_ERROR;
+        }
+        erase_count = (header[0] == KV_SECTOR_MAGIC && header[3] == ~header[1]) ? header[1] + 1 : 0;
+        header[0] = KV_SECTOR_MAGIC;
+        header[1] = erase_count;
+        header[2] = KV_ERASED_WORD;
+        header[3] = ~erase_count;
+
+        if (flash_erase_sector(config->flash, address) != 0 ||
+            flash_write(config->flash, address, header, sizeof(header)) != 0) {
+            return FLASH_KV_IO_ERROR;
+        }
+    }
+
+    return flash_kv_mount(kv, config);
+}
+
+/**
+ * @brief 写入键值
+ */
+int flash_kv_set(flash_kv_t *kv, const char *key, const void *value, uint16_t len) {
+    size_t key_len;
+    uint32_t address;
+    uint32_t hash;
+    uint32_t slot;
+    bool found;
+    int ret;
+
+    if (kv == NULL || !kv->mounted || key == NULL || (value == NULL && len > 0) ||
+        len > CONFIG_FLASH_KV_MAX_VALUE_LEN) {
+        return FLASH_KV_INVALID_PARAM;
+    }
+
+    key_len = strlen(key);
+    if (key_len == 0 || key_len > CONFIG_FLASH_KV_MAX_KEY_LEN) {
+        return FLASH_KV_INVALID_PARAM;
+    }
+
+    KV_LOCK(kv);
+
+    hash = kv_hash((const uint8_t *)key, (uint32_t)key_len);
+    kv_index_find(kv, (const uint8_t *)key, (uint8_t)key_len, hash, &found);
+    if (!found && kv->key_count >= CONFIG_FLASH_KV_MAX_KEYS) {
+        KV_UNLOCK(kv);
+        return FLASH_KV_NO_SPACE;
+    }
+
+    ret = kv_write_record(kv, KV_RECORD_VALUE, key, (uint8_t)key_len, value, len, &address);
+    if (ret == FLASH_KV_OK) {
+        /* 回收可能移动了索引，写入后重新查找槽位 */
+        slot = kv_index_find(kv, (const uint8_t *)key, (uint8_t)key_len, hash, &found);
+        if (!found) {
+            kv->index[slot].hash = hash;
+            kv->key_count++;
+        }
+        kv->index[slot].address = address;
+
+        ret = kv_gc_incremental(kv);
+    }
+
+    KV_UNLOCK(kv);
+
+    return ret;
+}
+
+/**
+ * @brief 读取键值
+ */
+int flash_kv_get(flash_kv_t *kv, const char *key, void *value, uint16_t size) {
+    kv_record_header_t header;
+    size_t key_len;
+    uint32_t address;
+    uint32_t slot;
+    bool found;
+    int ret;
+
+    if (kv == NULL || !kv->mounted || key == NULL || (value == NULL && size > 0)) {
+        return FLASH_KV_INVALID_PARAM;
+    }
+
+    key_len = strlen(key);
+    if (key_len == 0 || key_len > CONFIG_FLASH_KV_MAX_KEY_LEN) {
+        return FLASH_KV_INVALID_PARAM;
+    }
+
+    KV_LOCK(kv);
+
+    slot = kv_index_find(kv, (const uint8_t *)key, (uint8_t)key_len,
+                         kv_hash((const uint8_t *)key, (uint32_t)key_len), &found);
+    if (!found) {
+        KV_UNLOCK(kv);
+        return FLASH_KV_NOT_FOUND;
+    }
+
+    address = kv->index[slot].address;
+    if (flash_read(kv->config.flash, address, &header, sizeof(header)) != 0) {
+        KV_UNLOCK(kv);
+        return FLASH_KV_IO_ERROR;
+    }
+
+    ret = header.value_len;
+    if (size > header.value_len) {
+        size = header.value_len;
+    }
+    if (size > 0 && flash_read(kv->config.flash, address + FLASH_KV_RECORD_HEADER_SIZE + key_len,
+                               value, size) != 0) {
+        ret = FLASH_KV_IO_ERROR;
+    }
+
+    KV_UNLOCK(kv);
+
+    return ret;
+}
+
+/**
+ * @brief 删除键
+ */
+int flash_kv_delete(flash_kv_t *kv, const char *key) {
+    size_t key_len;
+    uint32_t address;
+    uint32_t hash;
+    uint32_t slot;
+    bool found;
+    int ret;
+
+    if (kv == NULL || !kv->mounted || key == NULL) {
+        return FLASH_KV_INVALID_PARAM;
+    }
+
+    key_len = strlen(key);
+    if (key_len == 0 || key_len > CONFIG_FLASH_KV_MAX_KEY_LEN) {
+        return FLASH_KV_INVALID_PARAM;
+    }
+
+    KV_LOCK(kv);
+
+    hash = kv_hash((const uint8_t *)key, (uint32_t)key_len);
+    kv_index_find(kv, (const uint8_t *)key, (uint8_t)key_len, hash, &found);
+    if (!found) {
+        KV_UNLOCK(kv);
+        return FLASH_KV_NOT_FOUND;
+    }
+
+    ret = kv_write_record(kv, KV_RECORD_DELETE, key, (uint8_t)key_len, NULL, 0, &address);
+    if (ret == FLASH_KV_OK) {
+        slot = kv_index_find(kv, (const uint8_t *)key, (uint8_t)key_len, hash, &found);
+        if (found) {
+            kv_index_remove(kv, slot);
+        }
+
+        ret = kv_gc_incremental(kv);
+    }
+
+    KV_UNLOCK(kv);
+
+    return ret;
+}
+
+/**
+ * @brief 执行一步增量回收
+ */
+int flash_kv_gc_step(flash_kv_t *kv) {
+    int ret;
+
+    if (kv == NULL || !kv->mounted) {
+        return FLASH_KV_INVALID_PARAM;
+    }
+
+    KV_LOCK(kv);
+    ret = kv_gc_run(kv, CONFIG_FLASH_KV_GC_STEP, false);
+    KV_UNLOCK(kv);
+
+    return (ret == FLASH_KV_NO_SPACE || ret >= 0) ? FLASH_KV_OK : ret;
+}
+
+/**
+ * @brief 获取统计信息
+ */
+int flash_kv_get_stats(flash_kv_t *kv, flash_kv_stats_t *stats) {
+    if (kv == NULL || !kv->mounted || stats == NULL) {
+        return FLASH_KV_INVALID_PARAM;
+    }
+
+    KV_LOCK(kv);
+
+    *stats = kv->stats;
+    stats->keys = kv->key_count;
+    stats->free_sectors = kv->free_count;
+    stats->min_erase_count = UINT32_MAX;
+    stats->max_erase_count = 0;
+    for (uint16_t i = 0; i < kv->config.sector_count; i++) {
+        uint32_t count = kv->sectors[i].erase_count;
+        if (count < stats->min_erase_count) {
+            stats->min_erase_count = count;
+        }
+        if (count > stats->max_erase_count) {
+            stats->max_erase_count = count;
+        }
+    }
+
+    KV_UNLOCK(kv);
+
+    return FLASH_KV_OK;
+}
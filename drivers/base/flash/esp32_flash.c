@@ -15,6 +15,7 @@
 #define FLASH_BASE_ADDRESS     0x00000000UL
 #define FLASH_SECTOR_SIZE      4096            /* 4KB */
 #define FLASH_BLOCK_SIZE       65536           /* 64KB */
+#define FLASH_PAGE_SIZE        256             /* SPI Flash编程页 */
 #define FLASH_TIMEOUT          5000
 
 /* ESP32 Flash设备结构?*/
@@ -23,6 +24,10 @@ typedef struct {
     void *arg;                        /* 回调参数 */
     volatile flash_status_t status;   /* 操作状?*/
     bool initialized;                 /* 初始化标?*/
+    bool stream_active;               /* 顺序写入会话进行中 */
+    uint32_t stream_address;          /* 暂存数据的起始地址 */
+    uint16_t stream_len;              /* 暂存的字节数 */
+    uint8_t stream_buf[FLASH_PAGE_SIZE]; /* 暂存到页边界的数据 */
 } esp32_flash_device_t;
 
 /* Flash设备 */
@@ -184,6 +189,121 @@ int flash_write(flash_handle_t handle, uint32_t address, const void *data, uint3
     return DRIVER_OK;
 }
 
+/**
+ * @brief 开始顺序写入会话
+ *
+ * spi_flash_write本身按页编程，会话只把零散的小块数据暂存到页边界后再写入，
+ * 使每次SPI事务都编程整页
+ *
+ * @param handle Flash设备句柄
+ * @param address 起始地址，不需要对齐
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_write_begin(flash_handle_t handle, uint32_t address)
+{
+    esp32_flash_device_t *dev = (esp32_flash_device_t *)handle;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if (dev->stream_active) {
+        return ERROR_BUSY;
+    }
+
+    dev->stream_address = address;
+    dev->stream_len = 0;
+    dev->stream_active = true;
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 在顺序写入会话中追加数据
+ *
+ * @param handle Flash设备句柄
+ * @param data 数据
+ * @param size 数据大小(字节)
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_write_stream(flash_handle_t handle, const void *data, uint32_t size)
+{
+    esp32_flash_device_t *dev = (esp32_flash_device_t *)handle;
+    const uint8_t *src = (const uint8_t *)data;
+    int ret;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || !dev->stream_active || (data == NULL && size > 0)) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    while (size > 0) {
+        uint32_t end = dev->stream_address + dev->stream_len;
+        uint32_t room = FLASH_PAGE_SIZE - (end % FLASH_PAGE_SIZE);
+
+        /* 暂存区为空且数据覆盖整页时直接从调用者的缓冲区写入 */
+        if (dev->stream_len == 0 && size >= room) {
+            uint32_t len = room + (size - room) / FLASH_PAGE_SIZE * FLASH_PAGE_SIZE;
+
+            ret = flash_write(handle, dev->stream_address, src, len);
+            if (ret != DRIVER_OK) {
+                return ret;
+            }
+            dev->stream_address += len;
+            src += len;
+            size -= len;
+            continue;
+        }
+
+        if (room > size) {
+            room = size;
+        }
+        memcpy(&dev->stream_buf[dev->stream_len], src, room);
+        dev->stream_len += (uint16_t)room;
+        src += room;
+        size -= room;
+
+        /* 暂存到页边界后写入 */
+        if ((dev->stream_address + dev->stream_len) % FLASH_PAGE_SIZE == 0) {
+            ret = flash_write(handle, dev->stream_address, dev->stream_buf, dev->stream_len);
+            if (ret != DRIVER_OK) {
+                return ret;
+            }
+            dev->stream_address += dev->stream_len;
+            dev->stream_len = 0;
+        }
+    }
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 结束顺序写入会话，写入暂存的剩余数据
+ *
+ * @param handle Flash设备句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_write_end(flash_handle_t handle)
+{
+    esp32_flash_device_t *dev = (esp32_flash_device_t *)handle;
+    int ret = DRIVER_OK;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || !dev->stream_active) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if (dev->stream_len > 0) {
+        ret = flash_write(handle, dev->stream_address, dev->stream_buf, dev->stream_len);
+    }
+
+    dev->stream_active = false;
+    dev->stream_len = 0;
+
+    return ret;
+}
+
 /**
  * @brief 擦除Flash扇区
  * 
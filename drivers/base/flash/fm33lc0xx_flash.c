@@ -23,6 +23,11 @@ typedef struct {
     void *arg;                        /* 回调参数 */
     volatile flash_status_t status;   /* 操作状?*/
     bool initialized;                 /* 初始化标?*/
+    bool stream_active;               /* 顺序写入会话进行中，期间Flash保持解锁 */
+    uint32_t stream_page;             /* 暂存页的起始地址 */
+    uint16_t stream_start;            /* 暂存页中第一个有效字节的偏移 */
+    uint16_t stream_len;              /* 暂存页中有效数据的结束偏移 */
+    uint32_t stream_buf[FLASH_PAGE_SIZE / 4]; /* 暂存页，无效部分为0xFF */
 } fm33lc0xx_flash_device_t;
 
 /* Flash设备 */
@@ -169,7 +174,9 @@ int flash_write(flash_handle_t handle, uint32_t address, const void *data, uint3
             flash_status = FL_FLASH_Program_Byte(addr + i, src[i]);
             if (flash_status != FL_PASS) {
                 /* 锁定Flash */
-                FL_FLASH_Lock();
+                if (!dev->stream_active) {
+                    FL_FLASH_Lock();
+                }
                 
                 /* 更新状?*/
                 dev->status = FLASH_STATUS_ERROR;
@@ -191,7 +198,9 @@ int flash_write(flash_handle_t handle, uint32_t address, const void *data, uint3
             
             if (timeout == 0) {
                 /* 锁定Flash */
-                FL_FLASH_Lock();
+                if (!dev->stream_active) {
+                    FL_FLASH_Lock();
+                }
                 
                 /* 更新状?*/
                 dev->status = FLASH_STATUS_TIMEOUT;
@@ -212,7 +221,9 @@ int flash_write(flash_handle_t handle, uint32_t address, const void *data, uint3
     }
     
     /* 锁定Flash */
-    FL_FLASH_Lock();
+    if (!dev->stream_active) {
+        FL_FLASH_Lock();
+    }
     
     /* 更新状?*/
     dev->status = FLASH_STATUS_COMPLETE;
@@ -225,6 +236,202 @@ int flash_write(flash_handle_t handle, uint32_t address, const void *data, uint3
     return DRIVER_OK;
 }
 
+/**
+ * @brief 等待Flash空闲
+ *
+ * @return int 0表示成功，非0表示超时
+ */
+static int flash_wait_idle(void)
+{
+    uint32_t timeout = FLASH_TIMEOUT;
+
+    while (FL_FLASH_GetFlag(FL_FLASH_FLAG_BUSY) == SET) {
+        if (--timeout == 0) {
+            return ERROR_TIMEOUT;
+        }
+    }
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 编程暂存页
+ *
+ * 整页有效时使用页编程一次写入，否则只按字编程有效部分覆盖的字，
+ * 字内有效范围以外的字节为0xFF，不改变Flash原有内容
+ *
+ * @param dev Flash设备
+ * @return int 0表示成功，非0表示失败
+ */
+static int flash_stream_flush(fm33lc0xx_flash_device_t *dev)
+{
+    uint32_t first = dev->stream_start / 4;
+    uint32_t last = (dev->stream_len + 3) / 4;
+    int ret = DRIVER_OK;
+
+    if (dev->stream_start == 0 && dev->stream_len == FLASH_PAGE_SIZE) {
+        if (FL_FLASH_Program_Page(dev->stream_page / FLASH_PAGE_SIZE, dev->stream_buf) != FL_PASS) {
+            return ERROR_HARDWARE;
+        }
+        ret = flash_wait_idle();
+    } else {
+        for (uint32_t i = first; i < last && ret == DRIVER_OK; i++) {
+            if (FL_FLASH_Program_Word(dev->stream_page + i * 4, dev->stream_buf[i]) != FL_PASS) {
+                return ERROR_HARDWARE;
+            }
+            ret = flash_wait_idle();
+        }
+    }
+
+    /* 开始下一页 */
+    dev->stream_page += FLASH_PAGE_SIZE;
+    dev->stream_start = 0;
+    dev->stream_len = 0;
+    memset(dev->stream_buf, 0xFF, sizeof(dev->stream_buf));
+
+    return ret;
+}
+
+/**
+ * @brief 结束会话中的出错处理
+ */
+static int flash_stream_fail(fm33lc0xx_flash_device_t *dev, int ret)
+{
+    dev->status = (ret == ERROR_TIMEOUT) ? FLASH_STATUS_TIMEOUT : FLASH_STATUS_ERROR;
+
+    if (dev->callback) {
+        dev->callback(dev->arg, dev->status);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief 开始顺序写入会话
+ *
+ * 会话期间Flash保持解锁，数据暂存到整页后用页编程写入，替代逐字节编程
+ *
+ * @param handle Flash设备句柄
+ * @param address 起始地址，不需要对齐
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_write_begin(flash_handle_t handle, uint32_t address)
+{
+    fm33lc0xx_flash_device_t *dev = (fm33lc0xx_flash_device_t *)handle;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if (address < FLASH_BASE_ADDRESS || address >= (FLASH_BASE_ADDRESS + FLASH_TOTAL_SIZE)) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if (dev->stream_active) {
+        return ERROR_BUSY;
+    }
+
+    dev->stream_page = address & ~(uint32_t)(FLASH_PAGE_SIZE - 1);
+    dev->stream_start = (uint16_t)(address - dev->stream_page);
+    dev->stream_len = dev->stream_start;
+    memset(dev->stream_buf, 0xFF, sizeof(dev->stream_buf));
+
+    dev->stream_active = true;
+    dev->status = FLASH_STATUS_BUSY;
+
+    FL_FLASH_Unlock();
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 在顺序写入会话中追加数据
+ *
+ * @param handle Flash设备句柄
+ * @param data 数据
+ * @param size 数据大小(字节)
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_write_stream(flash_handle_t handle, const void *data, uint32_t size)
+{
+    fm33lc0xx_flash_device_t *dev = (fm33lc0xx_flash_device_t *)handle;
+    const uint8_t *src = (const uint8_t *)data;
+    int ret;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || !dev->stream_active || (data == NULL && size > 0)) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if (dev->stream_page + dev->stream_len + size > (FLASH_BASE_ADDRESS + FLASH_TOTAL_SIZE)) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    while (size > 0) {
+        uint32_t len = FLASH_PAGE_SIZE - dev->stream_len;
+
+        if (len > size) {
+            len = size;
+        }
+
+        memcpy((uint8_t *)dev->stream_buf + dev->stream_len, src, len);
+        dev->stream_len += (uint16_t)len;
+        src += len;
+        size -= len;
+
+        if (dev->stream_len == FLASH_PAGE_SIZE) {
+            ret = flash_stream_flush(dev);
+            if (ret != DRIVER_OK) {
+                return flash_stream_fail(dev, ret);
+            }
+        }
+    }
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 结束顺序写入会话
+ *
+ * 编程暂存的不完整页并重新锁定Flash
+ *
+ * @param handle Flash设备句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_write_end(flash_handle_t handle)
+{
+    fm33lc0xx_flash_device_t *dev = (fm33lc0xx_flash_device_t *)handle;
+    int ret = DRIVER_OK;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || !dev->stream_active) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if (dev->stream_len > dev->stream_start) {
+        ret = flash_stream_flush(dev);
+    }
+
+    FL_FLASH_Lock();
+
+    dev->stream_active = false;
+
+    if (ret != DRIVER_OK) {
+        return flash_stream_fail(dev, ret);
+    }
+
+    if (dev->status != FLASH_STATUS_ERROR && dev->status != FLASH_STATUS_TIMEOUT) {
+        dev->status = FLASH_STATUS_COMPLETE;
+
+        if (dev->callback) {
+            dev->callback(dev->arg, FLASH_STATUS_COMPLETE);
+        }
+    }
+
+    return DRIVER_OK;
+}
+
 /**
  * @brief 擦除Flash扇区
  * 
@@ -268,7 +475,9 @@ int flash_erase_sector(flash_handle_t handle, uint32_t sector_address)
     
     if (flash_status != FL_PASS) {
         /* 锁定Flash */
-        FL_FLASH_Lock();
+        if (!dev->stream_active) {
+            FL_FLASH_Lock();
+        }
         
         /* 更新状?*/
         dev->status = FLASH_STATUS_ERROR;
@@ -289,7 +498,9 @@ int flash_erase_sector(flash_handle_t handle, uint32_t sector_address)
     } while (status == SET && timeout > 0);
     
     /* 锁定Flash */
-    FL_FLASH_Lock();
+    if (!dev->stream_active) {
+        FL_FLASH_Lock();
+    }
     
     if (timeout == 0) {
         /* 更新状?*/
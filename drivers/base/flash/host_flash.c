@@ -0,0 +1,928 @@
+/**
+ * @file host_flash.c
+ * @brief 主机平台Flash模拟驱动实现
+ *
+ * 该文件模拟NOR Flash，供未选择目标平台的主机构建和单元测试使用。擦除后为
+ * 全0xFF，编程只能把位从1清为0，并按时序模型累计耗时、记录各扇区擦除次数，
+ * 可注入掉电。存储默认位于内存，也可以通过host_flash_open_file映射到文件，
+ * 文件末尾的页脚保存各扇区擦除次数，重新映射后磨损状态得以延续。
+ */
+
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L
+#define HOST_FLASH_HAS_MMAP     1
+#else
+#define HOST_FLASH_HAS_MMAP     0
+#endif
+
+#include "base/host_flash_api.h"
+#include "common/error_api.h"
+#include <string.h>
+
+#if HOST_FLASH_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/* 模拟Flash扇区大小 */
+#ifndef CONFIG_HOST_FLASH_SECTOR_SIZE
+#define CONFIG_HOST_FLASH_SECTOR_SIZE   (4 * 1024)
+#endif
+
+/* 模拟Flash扇区数量 */
+#ifndef CONFIG_HOST_FLASH_SECTOR_COUNT
+#define CONFIG_HOST_FLASH_SECTOR_COUNT  16
+#endif
+
+/* 模拟Flash基础地址 */
+#ifndef CONFIG_HOST_FLASH_BASE_ADDRESS
+#define CONFIG_HOST_FLASH_BASE_ADDRESS  0x00000000UL
+#endif
+
+/* 为1时拒绝需要把0写为1的编程，为0时按位与写入 */
+#ifndef CONFIG_HOST_FLASH_STRICT
+#define CONFIG_HOST_FLASH_STRICT        1
+#endif
+
+/* 扇区擦写寿命，超过后擦除失败 */
+#ifndef CONFIG_HOST_FLASH_ENDURANCE
+#define CONFIG_HOST_FLASH_ENDURANCE     100000UL
+#endif
+
+/* 默认时序，取常见SPI NOR Flash的典型值 */
+#ifndef CONFIG_HOST_FLASH_READ_NS_PER_BYTE
+#define CONFIG_HOST_FLASH_READ_NS_PER_BYTE      20
+#endif
+
+#ifndef CONFIG_HOST_FLASH_PROGRAM_NS_PER_WORD
+#define CONFIG_HOST_FLASH_PROGRAM_NS_PER_WORD   11000
+#endif
+
+#ifndef CONFIG_HOST_FLASH_ERASE_US_PER_SECTOR
+#define CONFIG_HOST_FLASH_ERASE_US_PER_SECTOR   45000
+#endif
+
+#define HOST_FLASH_TOTAL_SIZE   (CONFIG_HOST_FLASH_SECTOR_SIZE * CONFIG_HOST_FLASH_SECTOR_COUNT)
+
+/* 文件页脚标识"HFEC" */
+#define HOST_FLASH_FOOTER_MAGIC 0x43454648UL
+
+/* 映射文件页脚，紧跟在存储内容之后 */
+typedef struct {
+    uint32_t magic;                                         /* 页脚标识 */
+    uint32_t sector_count;                                  /* 扇区数量，与配置不符时视为无效 */
+    uint32_t erase_counts[CONFIG_HOST_FLASH_SECTOR_COUNT];  /* 各扇区擦除次数 */
+} host_flash_footer_t;
+
+#define HOST_FLASH_FILE_SIZE    (HOST_FLASH_TOTAL_SIZE + sizeof(host_flash_footer_t))
+
+/* 主机Flash设备结构体 */
+typedef struct {
+    flash_callback_t callback;        /* 回调函数 */
+    void *arg;                        /* 回调参数 */
+    volatile flash_status_t status;   /* 操作状态 */
+    bool initialized;                 /* 初始化标志 */
+    bool locked;                      /* 锁定标志，与STM32一致，写入和擦除时自动解锁 */
+    uint32_t protection;              /* 各扇区写保护位 */
+    bool stream_active;               /* 顺序写入会话进行中 */
+    uint32_t stream_address;          /* 暂存字的地址 */
+    uint8_t stream_len;               /* 暂存字中已写入的字节数 */
+    uint8_t stream_buf[4];            /* 暂存的不完整字 */
+} host_flash_device_t;
+
+/* Flash设备 */
+static host_flash_device_t g_flash_device;
+
+/* 内存存储 */
+static uint8_t g_flash_ram[HOST_FLASH_TOTAL_SIZE];
+
+/* 当前使用的存储，指向内存存储或文件映射 */
+static uint8_t *g_flash_memory = g_flash_ram;
+
+/* 是否映射到文件 */
+static bool g_flash_mapped = false;
+
+/* 内存存储是否已经过首次擦除 */
+static bool g_flash_formatted = false;
+
+/* 内存存储的各扇区擦除次数 */
+static uint32_t g_erase_ram[CONFIG_HOST_FLASH_SECTOR_COUNT];
+
+/* 当前使用的擦除次数，映射到文件时指向文件页脚 */
+static uint32_t *g_erase_counts = g_erase_ram;
+
+/* 时序模型 */
+static host_flash_timing_t g_timing = {
+    CONFIG_HOST_FLASH_READ_NS_PER_BYTE,
+    CONFIG_HOST_FLASH_PROGRAM_NS_PER_WORD,
+    CONFIG_HOST_FLASH_ERASE_US_PER_SECTOR,
+    false
+};
+
+/* 统计信息 */
+static host_flash_stats_t g_stats;
+
+/* 掉电倒计数，0表示未注入 */
+static uint32_t g_power_countdown = 0;
+
+/* 是否处于掉电状态 */
+static bool g_powered_off = false;
+
+/* 检查地址范围，低于基础地址时偏移回绕为大数同样判为越界 */
+static bool is_range_valid(uint32_t address, uint32_t size)
+{
+    uint32_t offset = address - CONFIG_HOST_FLASH_BASE_ADDRESS;
+
+    return size <= HOST_FLASH_TOTAL_SIZE && offset <= HOST_FLASH_TOTAL_SIZE - size;
+}
+
+/* 获取地址所在的扇区号 */
+static uint32_t get_sector_from_address(uint32_t address)
+{
+    return (address - CONFIG_HOST_FLASH_BASE_ADDRESS) / CONFIG_HOST_FLASH_SECTOR_SIZE;
+}
+
+/* 检查范围内是否有受保护的扇区 */
+static bool is_range_protected(const host_flash_device_t *dev, uint32_t address, uint32_t size)
+{
+    if (size == 0) {
+        return false;
+    }
+
+    for (uint32_t sector = get_sector_from_address(address);
+         sector <= get_sector_from_address(address + size - 1); sector++) {
+        if (sector < 32 && (dev->protection & (1UL << sector)) != 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* 结束一次操作并通知 */
+static int finish_operation(host_flash_device_t *dev, flash_status_t status)
+{
+    dev->status = status;
+
+    if (dev->callback) {
+        dev->callback(dev->arg, status);
+    }
+
+    return (status == FLASH_STATUS_COMPLETE) ? DRIVER_OK : ERROR_IO;
+}
+
+/* 按时序模型计时，启用实时模式时实际延时 */
+static void consume_time(uint64_t ns)
+{
+    g_stats.elapsed_ns += ns;
+
+#if HOST_FLASH_HAS_MMAP
+    if (g_timing.realtime && ns > 0) {
+        struct timespec ts;
+
+        ts.tv_sec = (time_t)(ns / 1000000000ULL);
+        ts.tv_nsec = (long)(ns % 1000000000ULL);
+        nanosleep(&ts, NULL);
+    }
+#endif
+}
+
+/* 对一个编程字或擦除扇区推进掉电倒计数，返回true表示该操作中途掉电 */
+static bool power_loss_tick(void)
+{
+    if (g_power_countdown == 0) {
+        return false;
+    }
+
+    if (--g_power_countdown != 0) {
+        return false;
+    }
+
+    g_powered_off = true;
+    g_stats.power_losses++;
+
+    return true;
+}
+
+/**
+ * @brief 初始化Flash设备
+ *
+ * 内存存储在进程内首次初始化时擦除，之后的去初始化和再次初始化保留内容，
+ * 用于模拟重新上电；重新上电同时清除掉电状态
+ *
+ * @param callback Flash操作完成回调函数
+ * @param arg 传递给回调函数的参数
+ * @param handle Flash设备句柄指针
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_init(flash_callback_t callback, void *arg, flash_handle_t *handle)
+{
+    /* 参数检查 */
+    if (handle == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    /* 检查是否已初始化 */
+    if (g_flash_device.initialized) {
+        return ERROR_BUSY;
+    }
+
+    if (!g_flash_mapped && !g_flash_formatted) {
+        memset(g_flash_ram, 0xFF, sizeof(g_flash_ram));
+        g_flash_formatted = true;
+    }
+
+    g_powered_off = false;
+
+    /* 初始化Flash设备 */
+    memset(&g_flash_device, 0, sizeof(host_flash_device_t));
+    g_flash_device.callback = callback;
+    g_flash_device.arg = arg;
+    g_flash_device.status = FLASH_STATUS_IDLE;
+    g_flash_device.initialized = true;
+
+    /* 返回句柄 */
+    *handle = (flash_handle_t)&g_flash_device;
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 去初始化Flash设备
+ *
+ * @param handle Flash设备句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_deinit(flash_handle_t handle)
+{
+    host_flash_device_t *dev = (host_flash_device_t *)handle;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    /* 清除初始化标志 */
+    dev->initialized = false;
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 读取Flash数据
+ *
+ * @param handle Flash设备句柄
+ * @param address 起始地址
+ * @param data 数据缓冲区
+ * @param size 数据大小(字节)
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_read(flash_handle_t handle, uint32_t address, void *data, uint32_t size)
+{
+    host_flash_device_t *dev = (host_flash_device_t *)handle;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || data == NULL || !is_range_valid(address, size)) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if (g_powered_off) {
+        return ERROR_IO;
+    }
+
+    memcpy(data, &g_flash_memory[address - CONFIG_HOST_FLASH_BASE_ADDRESS], size);
+
+    g_stats.read_bytes += size;
+    consume_time((uint64_t)size * g_timing.read_ns_per_byte);
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 写入Flash数据
+ *
+ * 与NOR Flash一致，编程只能把位从1清为0。严格模式下需要把0写为1的写入
+ * 整体被拒绝，不修改任何内容
+ *
+ * @param handle Flash设备句柄
+ * @param address 起始地址
+ * @param data 数据缓冲区
+ * @param size 数据大小(字节)
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_write(flash_handle_t handle, uint32_t address, const void *data, uint32_t size)
+{
+    host_flash_device_t *dev = (host_flash_device_t *)handle;
+    const uint8_t *src = (const uint8_t *)data;
+    uint8_t *dst;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || data == NULL || !is_range_valid(address, size)) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    /* 与STM32一致，按字对齐编程 */
+    if ((address & 0x3) != 0 || (size % 4) != 0) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if (g_powered_off || is_range_protected(dev, address, size)) {
+        return finish_operation(dev, FLASH_STATUS_ERROR);
+    }
+
+    dst = &g_flash_memory[address - CONFIG_HOST_FLASH_BASE_ADDRESS];
+
+#if CONFIG_HOST_FLASH_STRICT
+    for (uint32_t i = 0; i < size; i++) {
+        if ((dst[i] & src[i]) != src[i]) {
+            g_stats.violations++;
+            return finish_operation(dev, FLASH_STATUS_ERROR);
+        }
+    }
+#endif
+
+    dev->status = FLASH_STATUS_BUSY;
+
+    for (uint32_t i = 0; i < size; i += 4) {
+        g_stats.program_words++;
+        consume_time(g_timing.program_ns_per_word);
+
+        if (power_loss_tick()) {
+            /* 编程中途掉电，只有低半字被编程 */
+            dst[i] &= src[i];
+            dst[i + 1] &= src[i + 1];
+            return finish_operation(dev, FLASH_STATUS_ERROR);
+        }
+
+        dst[i] &= src[i];
+        dst[i + 1] &= src[i + 1];
+        dst[i + 2] &= src[i + 2];
+        dst[i + 3] &= src[i + 3];
+    }
+
+    return finish_operation(dev, FLASH_STATUS_COMPLETE);
+}
+
+/**
+ * @brief 开始顺序写入会话
+ *
+ * 起始地址不对齐时，字内之前的字节以0xFF填充，编程后保持原内容
+ *
+ * @param handle Flash设备句柄
+ * @param address 起始地址
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_write_begin(flash_handle_t handle, uint32_t address)
+{
+    host_flash_device_t *dev = (host_flash_device_t *)handle;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || !is_range_valid(address, 1)) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if (dev->stream_active) {
+        return ERROR_BUSY;
+    }
+
+    dev->stream_address = address & ~0x3UL;
+    dev->stream_len = (uint8_t)(address & 0x3);
+    memset(dev->stream_buf, 0xFF, sizeof(dev->stream_buf));
+    dev->stream_active = true;
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 在顺序写入会话中追加数据
+ *
+ * @param handle Flash设备句柄
+ * @param data 数据
+ * @param size 数据大小(字节)
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_write_stream(flash_handle_t handle, const void *data, uint32_t size)
+{
+    host_flash_device_t *dev = (host_flash_device_t *)handle;
+    const uint8_t *src = (const uint8_t *)data;
+    uint32_t bulk;
+    int ret;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || !dev->stream_active || (data == NULL && size > 0)) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    /* 先补齐暂存的字 */
+    while (dev->stream_len > 0 && size > 0) {
+        dev->stream_buf[dev->stream_len++] = *src++;
+        size--;
+
+        if (dev->stream_len == 4) {
+            ret = flash_write(handle, dev->stream_address, dev->stream_buf, 4);
+            if (ret != DRIVER_OK) {
+                return ret;
+            }
+            dev->stream_address += 4;
+            dev->stream_len = 0;
+            memset(dev->stream_buf, 0xFF, sizeof(dev->stream_buf));
+        }
+    }
+
+    /* 完整的字直接编程 */
+    bulk = size & ~0x3UL;
+    if (bulk > 0) {
+        ret = flash_write(handle, dev->stream_address, src, bulk);
+        if (ret != DRIVER_OK) {
+            return ret;
+        }
+        dev->stream_address += bulk;
+        src += bulk;
+        size -= bulk;
+    }
+
+    /* 剩余字节暂存 */
+    memcpy(dev->stream_buf, src, size);
+    dev->stream_len = (uint8_t)size;
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 结束顺序写入会话
+ *
+ * 暂存的不完整字以0xFF补齐后编程
+ *
+ * @param handle Flash设备句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_write_end(flash_handle_t handle)
+{
+    host_flash_device_t *dev = (host_flash_device_t *)handle;
+    int ret = DRIVER_OK;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || !dev->stream_active) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if (dev->stream_len > 0) {
+        ret = flash_write(handle, dev->stream_address, dev->stream_buf, 4);
+    }
+
+    dev->stream_active = false;
+    dev->stream_len = 0;
+
+    return ret;
+}
+
+/**
+ * @brief 擦除Flash扇区
+ *
+ * @param handle Flash设备句柄
+ * @param sector_address 扇区内任意地址
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_erase_sector(flash_handle_t handle, uint32_t sector_address)
+{
+    host_flash_device_t *dev = (host_flash_device_t *)handle;
+    uint32_t sector;
+    uint8_t *start;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || !is_range_valid(sector_address, 1)) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if (g_powered_off || is_range_protected(dev, sector_address, 1)) {
+        return finish_operation(dev, FLASH_STATUS_ERROR);
+    }
+
+    sector = get_sector_from_address(sector_address);
+    start = &g_flash_memory[sector * CONFIG_HOST_FLASH_SECTOR_SIZE];
+
+    if (g_erase_counts[sector] >= CONFIG_HOST_FLASH_ENDURANCE) {
+        g_stats.worn_out++;
+        return finish_operation(dev, FLASH_STATUS_ERROR);
+    }
+
+    dev->status = FLASH_STATUS_BUSY;
+
+    g_erase_counts[sector]++;
+    if (g_erase_counts[sector] > g_stats.max_erase_count) {
+        g_stats.max_erase_count = g_erase_counts[sector];
+    }
+    g_stats.erase_ops++;
+    consume_time((uint64_t)g_timing.erase_us_per_sector * 1000);
+
+    if (power_loss_tick()) {
+        /* 擦除中途掉电，只有前半个扇区被擦除 */
+        memset(start, 0xFF, CONFIG_HOST_FLASH_SECTOR_SIZE / 2);
+        return finish_operation(dev, FLASH_STATUS_ERROR);
+    }
+
+    memset(start, 0xFF, CONFIG_HOST_FLASH_SECTOR_SIZE);
+
+    return finish_operation(dev, FLASH_STATUS_COMPLETE);
+}
+
+/**
+ * @brief 擦除Flash块
+ *
+ * @param handle Flash设备句柄
+ * @param block_address 块地址
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_erase_block(flash_handle_t handle, uint32_t block_address)
+{
+    /* 模拟器不区分扇区和块，使用扇区擦除 */
+    return flash_erase_sector(handle, block_address);
+}
+
+/**
+ * @brief 获取Flash状态
+ *
+ * @param handle Flash设备句柄
+ * @param status Flash状态指针
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_get_status(flash_handle_t handle, flash_status_t *status)
+{
+    host_flash_device_t *dev = (host_flash_device_t *)handle;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || status == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    *status = dev->status;
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 获取Flash扇区大小
+ *
+ * @param handle Flash设备句柄
+ * @param sector_size 扇区大小指针
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_get_sector_size(flash_handle_t handle, uint32_t *sector_size)
+{
+    host_flash_device_t *dev = (host_flash_device_t *)handle;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || sector_size == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    *sector_size = CONFIG_HOST_FLASH_SECTOR_SIZE;
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 获取Flash块大小
+ *
+ * @param handle Flash设备句柄
+ * @param block_size 块大小指针
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_get_block_size(flash_handle_t handle, uint32_t *block_size)
+{
+    return flash_get_sector_size(handle, block_size);
+}
+
+/**
+ * @brief 获取Flash总大小
+ *
+ * @param handle Flash设备句柄
+ * @param total_size Flash总大小指针
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_get_total_size(flash_handle_t handle, uint32_t *total_size)
+{
+    host_flash_device_t *dev = (host_flash_device_t *)handle;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || total_size == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    *total_size = HOST_FLASH_TOTAL_SIZE;
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 获取Flash信息
+ *
+ * @param handle Flash设备句柄
+ * @param size Flash大小(字节)
+ * @param sector_size 扇区大小(字节)
+ * @param sector_count 扇区数量
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_get_info(flash_handle_t handle, uint32_t *size, uint32_t *sector_size, uint32_t *sector_count)
+{
+    host_flash_device_t *dev = (host_flash_device_t *)handle;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if (size != NULL) {
+        *size = HOST_FLASH_TOTAL_SIZE;
+    }
+    if (sector_size != NULL) {
+        *sector_size = CONFIG_HOST_FLASH_SECTOR_SIZE;
+    }
+    if (sector_count != NULL) {
+        *sector_count = CONFIG_HOST_FLASH_SECTOR_COUNT;
+    }
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 设置Flash保护
+ *
+ * @param handle Flash设备句柄
+ * @param start_address 起始地址
+ * @param end_address 结束地址
+ * @param enable 是否启用保护
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_set_protection(flash_handle_t handle, uint32_t start_address, uint32_t end_address, bool enable)
+{
+    host_flash_device_t *dev = (host_flash_device_t *)handle;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || start_address > end_address ||
+        !is_range_valid(start_address, end_address - start_address + 1)) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    for (uint32_t sector = get_sector_from_address(start_address);
+         sector <= get_sector_from_address(end_address) && sector < 32; sector++) {
+        if (enable) {
+            dev->protection |= (1UL << sector);
+        } else {
+            dev->protection &= ~(1UL << sector);
+        }
+    }
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 获取Flash保护状态
+ *
+ * @param handle Flash设备句柄
+ * @param address 地址
+ * @param is_protected 保护状态指针
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_get_protection(flash_handle_t handle, uint32_t address, bool *is_protected)
+{
+    host_flash_device_t *dev = (host_flash_device_t *)handle;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || is_protected == NULL || !is_range_valid(address, 1)) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    *is_protected = is_range_protected(dev, address, 1);
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 锁定Flash
+ *
+ * @param handle Flash设备句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_lock(flash_handle_t handle)
+{
+    host_flash_device_t *dev = (host_flash_device_t *)handle;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    dev->locked = true;
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 解锁Flash
+ *
+ * @param handle Flash设备句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_unlock(flash_handle_t handle)
+{
+    host_flash_device_t *dev = (host_flash_device_t *)handle;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    dev->locked = false;
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 把模拟存储映射到文件
+ */
+int host_flash_open_file(const char *path)
+{
+#if HOST_FLASH_HAS_MMAP
+    struct stat st;
+    uint8_t *map;
+    host_flash_footer_t *footer;
+    off_t old_size;
+    int fd;
+
+    if (path == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if (g_flash_device.initialized || g_flash_mapped) {
+        return ERROR_BUSY;
+    }
+
+    fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return ERROR_IO;
+    }
+
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return ERROR_IO;
+    }
+
+    old_size = st.st_size;
+    if (old_size != (off_t)HOST_FLASH_FILE_SIZE && ftruncate(fd, HOST_FLASH_FILE_SIZE) != 0) {
+        close(fd);
+        return ERROR_IO;
+    }
+
+    map = (uint8_t *)mmap(NULL, HOST_FLASH_FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == (uint8_t *)MAP_FAILED) {
+        return ERROR_IO;
+    }
+
+    /* 新增的部分视为已擦除 */
+    if (old_size < (off_t)HOST_FLASH_TOTAL_SIZE) {
+        memset(&map[old_size], 0xFF, HOST_FLASH_TOTAL_SIZE - (uint32_t)old_size);
+    }
+
+    /* 页脚无效(新文件、旧格式或扇区数量改变)时擦除次数从零开始 */
+    footer = (host_flash_footer_t *)&map[HOST_FLASH_TOTAL_SIZE];
+    if (old_size != (off_t)HOST_FLASH_FILE_SIZE || footer->magic != HOST_FLASH_FOOTER_MAGIC ||
+        footer->sector_count != CONFIG_HOST_FLASH_SECTOR_COUNT) {
+        memset(footer, 0, sizeof(host_flash_footer_t));
+        footer->magic = HOST_FLASH_FOOTER_MAGIC;
+        footer->sector_count = CONFIG_HOST_FLASH_SECTOR_COUNT;
+    }
+
+    g_flash_memory = map;
+    g_flash_mapped = true;
+    g_erase_counts = footer->erase_counts;
+
+    g_stats.max_erase_count = 0;
+    for (uint32_t i = 0; i < CONFIG_HOST_FLASH_SECTOR_COUNT; i++) {
+        if (g_erase_counts[i] > g_stats.max_erase_count) {
+            g_stats.max_erase_count = g_erase_counts[i];
+        }
+    }
+
+    return DRIVER_OK;
+#else
+    (void)path;
+    return ERROR_NOT_SUPPORTED;
+#endif
+}
+
+/**
+ * @brief 解除文件映射并恢复为内存存储
+ */
+int host_flash_close_file(void)
+{
+#if HOST_FLASH_HAS_MMAP
+    if (g_flash_device.initialized) {
+        return ERROR_BUSY;
+    }
+
+    if (!g_flash_mapped) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    /* 擦除次数在内存存储中继续可查 */
+    memcpy(g_erase_ram, g_erase_counts, sizeof(g_erase_ram));
+
+    msync(g_flash_memory, HOST_FLASH_FILE_SIZE, MS_SYNC);
+    munmap(g_flash_memory, HOST_FLASH_FILE_SIZE);
+
+    g_flash_memory = g_flash_ram;
+    g_erase_counts = g_erase_ram;
+    g_flash_mapped = false;
+
+    return DRIVER_OK;
+#else
+    return ERROR_NOT_SUPPORTED;
+#endif
+}
+
+/**
+ * @brief 擦除整个模拟存储并清零擦除次数和统计信息
+ */
+void host_flash_format(void)
+{
+    memset(g_flash_memory, 0xFF, HOST_FLASH_TOTAL_SIZE);
+    if (!g_flash_mapped) {
+        g_flash_formatted = true;
+    }
+
+    memset(g_erase_counts, 0, CONFIG_HOST_FLASH_SECTOR_COUNT * sizeof(uint32_t));
+    memset(&g_stats, 0, sizeof(g_stats));
+}
+
+/**
+ * @brief 设置时序模型
+ */
+void host_flash_set_timing(const host_flash_timing_t *timing)
+{
+    if (timing == NULL) {
+        g_timing.read_ns_per_byte = CONFIG_HOST_FLASH_READ_NS_PER_BYTE;
+        g_timing.program_ns_per_word = CONFIG_HOST_FLASH_PROGRAM_NS_PER_WORD;
+        g_timing.erase_us_per_sector = CONFIG_HOST_FLASH_ERASE_US_PER_SECTOR;
+        g_timing.realtime = false;
+    } else {
+        g_timing = *timing;
+    }
+}
+
+/**
+ * @brief 获取统计信息
+ */
+int host_flash_get_stats(host_flash_stats_t *stats)
+{
+    if (stats == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    *stats = g_stats;
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 清零统计信息，擦除次数保留
+ */
+void host_flash_reset_stats(void)
+{
+    uint32_t max_erase_count = g_stats.max_erase_count;
+
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_stats.max_erase_count = max_erase_count;
+}
+
+/**
+ * @brief 获取扇区擦除次数
+ */
+uint32_t host_flash_get_erase_count(uint32_t sector)
+{
+    if (sector >= CONFIG_HOST_FLASH_SECTOR_COUNT) {
+        return 0;
+    }
+
+    return g_erase_counts[sector];
+}
+
+/**
+ * @brief 注入掉电
+ */
+void host_flash_inject_power_loss(uint32_t countdown)
+{
+    g_power_countdown = countdown;
+}
+
+/**
+ * @brief 判断模拟器是否处于掉电状态
+ */
+bool host_flash_is_powered_off(void)
+{
+    return g_powered_off;
+}
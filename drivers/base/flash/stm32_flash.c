@@ -36,6 +36,24 @@
 /* STM32 Flash扇区数量 */
 #define FLASH_SECTOR_COUNT     12
 
+/* 是否提供外部VPP(8~9V)，提供时使用64位并行编程和电压范围4 */
+#ifndef CONFIG_STM32_FLASH_VPP_ENABLED
+#define CONFIG_STM32_FLASH_VPP_ENABLED   0
+#endif
+
+#if CONFIG_STM32_FLASH_VPP_ENABLED
+#define FLASH_PROGRAM_UNIT     8
+#define FLASH_PROGRAM_PSIZE    FLASH_PSIZE_DOUBLE_WORD
+#define FLASH_VOLTAGE_RANGE    FLASH_VOLTAGE_RANGE_4
+#else
+#define FLASH_PROGRAM_UNIT     4
+#define FLASH_PROGRAM_PSIZE    FLASH_PSIZE_WORD
+#define FLASH_VOLTAGE_RANGE    FLASH_VOLTAGE_RANGE_3
+#endif
+
+/* 编程错误标志 */
+#define FLASH_PROGRAM_ERRORS   (FLASH_SR_PGSERR | FLASH_SR_PGPERR | FLASH_SR_PGAERR | FLASH_SR_WRPERR)
+
 /* 扇区信息结构?*/
 typedef struct {
     uint32_t start_address;
@@ -65,6 +83,10 @@ typedef struct {
     void *arg;                        /* 回调参数 */
     volatile flash_status_t status;   /* 操作状?*/
     bool initialized;                 /* 初始化标?*/
+    bool stream_active;               /* 顺序写入会话进行中，期间Flash保持解锁 */
+    uint32_t stream_address;          /* 暂存编程单元的起始地址 */
+    uint8_t stream_len;               /* 暂存编程单元中的有效字节数 */
+    uint8_t stream_buf[FLASH_PROGRAM_UNIT]; /* 暂存的不完整编程单元 */
 } stm32_flash_device_t;
 
 /* Flash设备 */
@@ -84,11 +106,136 @@ static int get_sector_from_address(uint32_t address, uint8_t *sector)
     return ERROR_INVALID_PARAM;
 }
 
-/* 地址对齐检?*/
-static bool is_address_aligned(uint32_t address)
+/* 等待当前操作结束并检查编程错误 */
+static int flash_wait_idle(void)
+{
+    uint32_t tickstart = HAL_GetTick();
+    uint32_t errors;
+
+    while ((FLASH->SR & FLASH_SR_BSY) != 0) {
+        if ((HAL_GetTick() - tickstart) > FLASH_TIMEOUT) {
+            return ERROR_TIMEOUT;
+        }
+    }
+
+    errors = FLASH->SR & FLASH_PROGRAM_ERRORS;
+    if (errors != 0) {
+        FLASH->SR = errors;
+        return ERROR_IO;
+    }
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 连续编程完整的编程单元
+ *
+ * 整段只设置一次并行宽度和PG位，单元之间只等待BSY，省去HAL_FLASH_Program
+ * 每次调用的加锁、状态检查和寄存器重配置。调用前Flash必须已解锁
+ *
+ * @param address 目标地址，按编程单元对齐
+ * @param src 源数据，可以不对齐
+ * @param count 编程单元数量
+ * @return int 0表示成功，非0表示失败
+ */
+static int flash_program_units(uint32_t address, const uint8_t *src, uint32_t count)
+{
+    uint32_t word;
+    int ret = flash_wait_idle();
+
+    if (ret != DRIVER_OK || count == 0) {
+        return ret;
+    }
+
+    FLASH->CR &= ~FLASH_CR_PSIZE;
+    FLASH->CR |= FLASH_PROGRAM_PSIZE;
+    FLASH->CR |= FLASH_CR_PG;
+
+    for (uint32_t i = 0; i < count; i++) {
+        for (uint32_t j = 0; j < FLASH_PROGRAM_UNIT; j += 4) {
+            memcpy(&word, &src[j], sizeof(word));
+            *(__IO uint32_t *)(address + j) = word;
+            __ISB();
+        }
+
+        ret = flash_wait_idle();
+        if (ret != DRIVER_OK) {
+            break;
+        }
+
+        address += FLASH_PROGRAM_UNIT;
+        src += FLASH_PROGRAM_UNIT;
+    }
+
+    FLASH->CR &= ~FLASH_CR_PG;
+
+    return ret;
+}
+
+/**
+ * @brief 读改写编程一个不完整的编程单元
+ *
+ * 单元内不写入的字节用Flash中的现有内容补齐，已擦除的字节保持0xFF，
+ * 已编程的字节以相同的值重写
+ *
+ * @param unit_address 编程单元地址
+ * @param offset 新数据在单元内的偏移
+ * @param src 新数据
+ * @param len 新数据长度
+ * @return int 0表示成功，非0表示失败
+ */
+static int flash_program_partial(uint32_t unit_address, uint32_t offset, const uint8_t *src, uint32_t len)
+{
+    uint8_t unit[FLASH_PROGRAM_UNIT];
+
+    memcpy(unit, (const void *)unit_address, FLASH_PROGRAM_UNIT);
+    memcpy(&unit[offset], src, len);
+
+    return flash_program_units(unit_address, unit, 1);
+}
+
+/**
+ * @brief 编程任意地址和长度的数据
+ *
+ * 不对齐的首尾部分读改写，中间部分按编程单元连续编程。调用前Flash必须已解锁
+ *
+ * @param address 起始地址
+ * @param src 源数据
+ * @param size 数据长度
+ * @return int 0表示成功，非0表示失败
+ */
+static int flash_program(uint32_t address, const uint8_t *src, uint32_t size)
 {
-    /* STM32F4地址需要按4字节对齐 */
-    return ((address & 0x3) == 0);
+    uint32_t head = address & (FLASH_PROGRAM_UNIT - 1);
+    uint32_t count;
+    int ret = DRIVER_OK;
+
+    if (head != 0 && size > 0) {
+        uint32_t len = FLASH_PROGRAM_UNIT - head;
+
+        if (len > size) {
+            len = size;
+        }
+
+        ret = flash_program_partial(address - head, head, src, len);
+        address += len;
+        src += len;
+        size -= len;
+    }
+
+    count = size / FLASH_PROGRAM_UNIT;
+    if (ret == DRIVER_OK && count > 0) {
+        ret = flash_program_units(address, src, count);
+        address += count * FLASH_PROGRAM_UNIT;
+        src += count * FLASH_PROGRAM_UNIT;
+        size -= count * FLASH_PROGRAM_UNIT;
+    }
+
+    if (ret == DRIVER_OK && size > 0) {
+        ret = flash_program_partial(address, 0, src, size);
+    }
+
+    return ret;
 }
 
 /**
@@ -189,73 +336,205 @@ int flash_read(flash_handle_t handle, uint32_t address, void *data, uint32_t siz
 
 /**
  * @brief 写入Flash数据
- * 
+ *
+ * 地址和长度不需要对齐，不完整的首尾编程单元读改写，中间部分连续编程。
+ * 顺序写入会话进行中时不再重复解锁和加锁
+ *
  * @param handle Flash设备句柄
  * @param address 起始地址
- * @param data 数据缓冲?
+ * @param data 数据缓冲区
  * @param size 数据大小(字节)
  * @return int 0表示成功，非0表示失败
  */
 int flash_write(flash_handle_t handle, uint32_t address, const void *data, uint32_t size)
 {
     stm32_flash_device_t *dev = (stm32_flash_device_t *)handle;
-    uint32_t *src = (uint32_t *)data;
     uint32_t end_address = address + size;
-    HAL_StatusTypeDef hal_status;
-    
-    /* 参数检?*/
+    int ret;
+
+    /* 参数检查 */
     if (dev == NULL || !dev->initialized || data == NULL) {
         return ERROR_INVALID_PARAM;
     }
-    
-    /* 地址范围检?*/
+
+    /* 地址范围检查 */
     if (address < FLASH_BASE_ADDRESS || end_address > (FLASH_BASE_ADDRESS + FLASH_TOTAL_SIZE)) {
         return ERROR_INVALID_PARAM;
     }
-    
-    /* 地址对齐检?*/
-    if (!is_address_aligned(address) || (size % 4) != 0) {
+
+    /* 更新状态 */
+    dev->status = FLASH_STATUS_BUSY;
+
+    if (!dev->stream_active) {
+        HAL_FLASH_Unlock();
+    }
+
+    ret = flash_program(address, (const uint8_t *)data, size);
+
+    if (!dev->stream_active) {
+        HAL_FLASH_Lock();
+    }
+
+    /* 更新状态 */
+    dev->status = (ret == DRIVER_OK) ? FLASH_STATUS_COMPLETE : FLASH_STATUS_ERROR;
+
+    /* 调用回调函数 */
+    if (dev->callback) {
+        dev->callback(dev->arg, dev->status);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief 开始顺序写入会话
+ *
+ * 会话期间Flash保持解锁，数据按编程单元暂存后连续编程
+ *
+ * @param handle Flash设备句柄
+ * @param address 起始地址，不需要对齐
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_write_begin(flash_handle_t handle, uint32_t address)
+{
+    stm32_flash_device_t *dev = (stm32_flash_device_t *)handle;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized) {
         return ERROR_INVALID_PARAM;
     }
-    
-    /* 更新状?*/
+
+    if (address < FLASH_BASE_ADDRESS || address >= (FLASH_BASE_ADDRESS + FLASH_TOTAL_SIZE)) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if (dev->stream_active) {
+        return ERROR_BUSY;
+    }
+
+    /* 起始地址不对齐时，单元内之前的字节用Flash现有内容填充 */
+    dev->stream_address = address & ~(uint32_t)(FLASH_PROGRAM_UNIT - 1);
+    dev->stream_len = (uint8_t)(address - dev->stream_address);
+    memcpy(dev->stream_buf, (const void *)dev->stream_address, dev->stream_len);
+
+    dev->stream_active = true;
     dev->status = FLASH_STATUS_BUSY;
-    
-    /* 解锁Flash */
+
     HAL_FLASH_Unlock();
-    
-    /* 写入数据 */
-    for (uint32_t i = 0; i < size / 4; i++) {
-        hal_status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address + (i * 4), src[i]);
-        
-        if (hal_status != HAL_OK) {
-            /* 锁定Flash */
-            HAL_FLASH_Lock();
-            
-            /* 更新状?*/
-            dev->status = FLASH_STATUS_ERROR;
-            
-            /* 调用回调函数 */
-            if (dev->callback) {
-                dev->callback(dev->arg, FLASH_STATUS_ERROR);
-            }
-            
-            return ERROR_DRIVER_WRITE_FAILED;
+
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 在顺序写入会话中追加数据
+ *
+ * @param handle Flash设备句柄
+ * @param data 数据
+ * @param size 数据大小(字节)
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_write_stream(flash_handle_t handle, const void *data, uint32_t size)
+{
+    stm32_flash_device_t *dev = (stm32_flash_device_t *)handle;
+    const uint8_t *src = (const uint8_t *)data;
+    uint32_t count;
+    int ret = DRIVER_OK;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || !dev->stream_active || (data == NULL && size > 0)) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if (dev->stream_address + dev->stream_len + size > (FLASH_BASE_ADDRESS + FLASH_TOTAL_SIZE)) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    /* 先补齐暂存的编程单元 */
+    if (dev->stream_len > 0) {
+        uint32_t len = FLASH_PROGRAM_UNIT - dev->stream_len;
+
+        if (len > size) {
+            len = size;
+        }
+
+        memcpy(&dev->stream_buf[dev->stream_len], src, len);
+        dev->stream_len += (uint8_t)len;
+        src += len;
+        size -= len;
+
+        if (dev->stream_len < FLASH_PROGRAM_UNIT) {
+            return DRIVER_OK;
+        }
+
+        ret = flash_program_units(dev->stream_address, dev->stream_buf, 1);
+        dev->stream_address += FLASH_PROGRAM_UNIT;
+        dev->stream_len = 0;
+    }
+
+    /* 完整的编程单元直接从调用者的缓冲区编程 */
+    count = size / FLASH_PROGRAM_UNIT;
+    if (ret == DRIVER_OK && count > 0) {
+        ret = flash_program_units(dev->stream_address, src, count);
+        dev->stream_address += count * FLASH_PROGRAM_UNIT;
+        src += count * FLASH_PROGRAM_UNIT;
+        size -= count * FLASH_PROGRAM_UNIT;
+    }
+
+    /* 剩余不足一个单元的数据暂存 */
+    if (ret == DRIVER_OK && size > 0) {
+        memcpy(dev->stream_buf, src, size);
+        dev->stream_len = (uint8_t)size;
+    }
+
+    if (ret != DRIVER_OK) {
+        dev->status = FLASH_STATUS_ERROR;
+
+        if (dev->callback) {
+            dev->callback(dev->arg, FLASH_STATUS_ERROR);
         }
     }
-    
-    /* 锁定Flash */
+
+    return ret;
+}
+
+/**
+ * @brief 结束顺序写入会话
+ *
+ * 编程暂存的不完整单元并重新锁定Flash
+ *
+ * @param handle Flash设备句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_write_end(flash_handle_t handle)
+{
+    stm32_flash_device_t *dev = (stm32_flash_device_t *)handle;
+    int ret = DRIVER_OK;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || !dev->stream_active) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    if (dev->stream_len > 0) {
+        ret = flash_program_partial(dev->stream_address, 0, dev->stream_buf, dev->stream_len);
+    }
+
     HAL_FLASH_Lock();
-    
-    /* 更新状?*/
-    dev->status = FLASH_STATUS_COMPLETE;
-    
+
+    dev->stream_active = false;
+    dev->stream_len = 0;
+
+    /* 更新状态 */
+    if (dev->status != FLASH_STATUS_ERROR) {
+        dev->status = (ret == DRIVER_OK) ? FLASH_STATUS_COMPLETE : FLASH_STATUS_ERROR;
+    }
+
     /* 调用回调函数 */
     if (dev->callback) {
-        dev->callback(dev->arg, FLASH_STATUS_COMPLETE);
+        dev->callback(dev->arg, dev->status);
     }
-    
-    return DRIVER_OK;
+
+    return ret;
 }
 
 /**
@@ -298,12 +577,14 @@ int flash_erase_sector(flash_handle_t handle, uint32_t sector_address)
     erase_init.TypeErase = FLASH_TYPEERASE_SECTORS;
     erase_init.Sector = sector;
     erase_init.NbSectors = 1;
-    erase_init.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+    erase_init.VoltageRange = FLASH_VOLTAGE_RANGE;
     
     hal_status = HAL_FLASHEx_Erase(&erase_init, &sector_error);
     
-    /* 锁定Flash */
-    HAL_FLASH_Lock();
+    /* 锁定Flash，顺序写入会话进行中时保持解锁 */
+    if (!dev->stream_active) {
+        HAL_FLASH_Lock();
+    }
     
     if (hal_status != HAL_OK) {
         /* 更新状?*/
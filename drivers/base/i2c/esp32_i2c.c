@@ -2,23 +2,49 @@
  * @file esp32_i2c.c
  * @brief ESP32平台I2C驱动实现
  *
- * 该文件实现了ESP32平台的I2C驱动接口
+ * 该文件实现了ESP32平台的I2C驱动接口。异步事务由每条总线的工作任务
+ * 依次执行，一个事务的全部分段编成一条命令链交给硬件命令队列执行，
+ * 提交者无需等待总线
  */
 
 #include "base/i2c_api.h"
 #include "common/error_api.h"
 #include "driver/i2c.h"
 #include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 #include <string.h>
 
 /* 日志标签 */
 static const char *TAG = "ESP32_I2C";
 
+/* 事务工作任务栈大小和优先级 */
+#ifndef CONFIG_I2C_TASK_STACK_SIZE
+#define CONFIG_I2C_TASK_STACK_SIZE      2048
+#endif
+
+#ifndef CONFIG_I2C_TASK_PRIORITY
+#define CONFIG_I2C_TASK_PRIORITY        10
+#endif
+
+/* 单个事务的总线超时（毫秒） */
+#ifndef CONFIG_I2C_TRANSACTION_TIMEOUT_MS
+#define CONFIG_I2C_TRANSACTION_TIMEOUT_MS 100
+#endif
+
 /* I2C设备句柄结构?*/
 typedef struct {
     i2c_port_t port;        /* ESP32 I2C端口?*/
     i2c_config_t config;    /* I2C配置参数 */
     bool initialized;       /* 初始化标?*/
+    portMUX_TYPE queue_mux;         /* 事务队列临界区 */
+    i2c_transaction_t *queue_head;  /* 事务队列头 */
+    i2c_transaction_t *queue_tail;  /* 事务队列尾 */
+    TaskHandle_t worker_task;       /* 事务工作任务 */
+    volatile bool worker_exit;      /* 通知工作任务退出，置位后拒绝新事务 */
+    SemaphoreHandle_t done_sem;     /* 事务完成通知 */
+    SemaphoreHandle_t sync_mutex;   /* 阻塞等待者互斥锁 */
 } esp32_i2c_handle_t;
 
 /* I2C设备句柄数组 */
@@ -46,6 +72,325 @@ static uint32_t convert_speed(i2c_speed_t speed)
     }
 }
 
+/**
+ * @brief 向命令链写入设备地址
+ * 
+ * @param esp32_handle I2C设备句柄
+ * @param cmd 命令链
+ * @param dev_addr 设备地址
+ * @param read 是否为读操作
+ */
+static void i2c_cmd_write_address(esp32_i2c_handle_t *esp32_handle, i2c_cmd_handle_t cmd,
+                                  uint16_t dev_addr, bool read)
+{
+    if (esp32_handle->config.addr_10bit) {
+        /* 10位地址模式，读操作需重复起始后再发送高位地址 */
+        i2c_master_write_byte(cmd, (dev_addr >> 7) | 0xF0, true);
+        i2c_master_write_byte(cmd, dev_addr & 0xFF, true);
+        if (read) {
+            i2c_master_start(cmd);
+            i2c_master_write_byte(cmd, ((dev_addr >> 7) | 0xF0) | 0x01, true);
+        }
+    } else {
+        i2c_master_write_byte(cmd, (dev_addr << 1) | (read ? I2C_MASTER_READ : I2C_MASTER_WRITE), true);
+    }
+}
+
+/**
+ * @brief 判断分段是否紧接前一分段连续传输
+ */
+static bool i2c_segment_continues(const i2c_segment_t *prev, const i2c_segment_t *segment)
+{
+    return !(prev->flags & I2C_FLAG_STOP) && prev->dir == segment->dir && prev->dev_addr == segment->dev_addr;
+}
+
+/**
+ * @brief 将事务的全部分段编成一条命令链并执行
+ * 
+ * @param esp32_handle I2C设备句柄
+ * @param transaction 事务
+ * @return int 0表示成功，非0表示失败
+ */
+static int i2c_transaction_run(esp32_i2c_handle_t *esp32_handle, const i2c_transaction_t *transaction)
+{
+    i2c_cmd_handle_t cmd;
+    esp_err_t ret;
+    
+    cmd = i2c_cmd_link_create();
+    if (cmd == NULL) {
+        return ERROR_NO_MEMORY;
+    }
+    
+    for (uint32_t i = 0; i < transaction->segment_count; i++) {
+        const i2c_segment_t *segment = &transaction->segments[i];
+        bool last = (segment->flags & I2C_FLAG_STOP) || i + 1 == transaction->segment_count;
+        
+        if (i == 0 || !i2c_segment_continues(segment - 1, segment)) {
+            i2c_master_start(cmd);
+            i2c_cmd_write_address(esp32_handle, cmd, segment->dev_addr, segment->dir == I2C_SEGMENT_READ);
+        }
+        
+        if (segment->dir == I2C_SEGMENT_WRITE) {
+            /* 零长度写分段只发送地址，用于设备探测 */
+            if (segment->len > 0) {
+                i2c_master_write(cmd, segment->data, segment->len, true);
+            }
+        } else if (!last && i2c_segment_continues(segment, segment + 1)) {
+            /* 后续分段继续读取，最后一个字节也需应答 */
+            i2c_master_read(cmd, segment->data, segment->len, I2C_MASTER_ACK);
+        } else {
+            i2c_master_read(cmd, segment->data, segment->len, I2C_MASTER_LAST_NACK);
+        }
+        
+        if (last) {
+            i2c_master_stop(cmd);
+        }
+    }
+    
+    ret = i2c_master_cmd_begin(esp32_handle->port, cmd, pdMS_TO_TICKS(CONFIG_I2C_TRANSACTION_TIMEOUT_MS));
+    i2c_cmd_link_delete(cmd);
+    
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "I2C transaction failed: %d", ret);
+        return (ret == ESP_ERR_TIMEOUT) ? ERROR_TIMEOUT : ERROR_HARDWARE;
+    }
+    
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 从队列头取出一个事务并标记为执行中
+ * 
+ * @param esp32_handle I2C设备句柄
+ * @return i2c_transaction_t* 事务，队列为空时返回NULL
+ */
+static i2c_transaction_t *i2c_transaction_dequeue(esp32_i2c_handle_t *esp32_handle)
+{
+    i2c_transaction_t *transaction;
+    
+    portENTER_CRITICAL(&esp32_handle->queue_mux);
+    transaction = esp32_handle->queue_head;
+    if (transaction != NULL) {
+        esp32_handle->queue_head = transaction->next;
+        if (esp32_handle->queue_head == NULL) {
+            esp32_handle->queue_tail = NULL;
+        }
+        transaction->next = NULL;
+        transaction->state = I2C_TRANSACTION_ACTIVE;
+    }
+    portEXIT_CRITICAL(&esp32_handle->queue_mux);
+    
+    return transaction;
+}
+
+/**
+ * @brief 摘除排队中的事务
+ * 
+ * @param esp32_handle I2C设备句柄
+ * @param transaction 事务
+ * @param result 写入事务的结果
+ * @return bool true表示已摘除，false表示事务已在执行或已完成
+ */
+static bool i2c_transaction_cancel(esp32_i2c_handle_t *esp32_handle, i2c_transaction_t *transaction, int result)
+{
+    bool removed = false;
+    
+    portENTER_CRITICAL(&esp32_handle->queue_mux);
+    
+    if (transaction->state == I2C_TRANSACTION_QUEUED) {
+        i2c_transaction_t **link = &esp32_handle->queue_head;
+        i2c_transaction_t *prev = NULL;
+        
+        while (*link != NULL && *link != transaction) {
+            prev = *link;
+            link = &(*link)->next;
+        }
+        
+        if (*link == transaction) {
+            *link = transaction->next;
+            if (esp32_handle->queue_tail == transaction) {
+                esp32_handle->queue_tail = prev;
+            }
+        }
+        
+        transaction->next = NULL;
+        transaction->result = result;
+        transaction->state = I2C_TRANSACTION_DONE;
+        removed = true;
+    }
+    
+    portEXIT_CRITICAL(&esp32_handle->queue_mux);
+    
+    return removed;
+}
+
+/**
+ * @brief I2C事务工作任务，依次执行队列中的事务
+ * 
+ * @param arg I2C设备句柄
+ */
+static void i2c_worker_task(void *arg)
+{
+    esp32_i2c_handle_t *esp32_handle = (esp32_i2c_handle_t *)arg;
+    i2c_transaction_t *transaction;
+    
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        
+        while ((transaction = i2c_transaction_dequeue(esp32_handle)) != NULL) {
+            /* 退出时执行中的命令链已在本任务内完成并释放，剩余事务以错误结束 */
+            int result = esp32_handle->worker_exit ? ERROR_NOT_INITIALIZED
+                                                   : i2c_transaction_run(esp32_handle, transaction);
+            
+            transaction->result = result;
+            
+            if (transaction->callback != NULL) {
+                transaction->callback(transaction, result, transaction->user_data);
+            }
+            
+            /* 回调返回后才标记完成，阻塞等待者随后即可复用事务对象 */
+            transaction->state = I2C_TRANSACTION_DONE;
+            xSemaphoreGive(esp32_handle->done_sem);
+        }
+        
+        if (esp32_handle->worker_exit) {
+            break;
+        }
+    }
+    
+    esp32_handle->worker_task = NULL;
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief 校验事务分段
+ * 
+ * @param transaction 事务
+ * @return int 0表示成功，非0表示失败
+ */
+static int i2c_transaction_validate(const i2c_transaction_t *transaction)
+{
+    if (transaction == NULL || transaction->segments == NULL || transaction->segment_count == 0) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    for (uint32_t i = 0; i < transaction->segment_count; i++) {
+        if (transaction->segments[i].data == NULL || transaction->segments[i].len == 0) {
+            return ERROR_INVALID_PARAM;
+        }
+    }
+    
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 将事务追加到总线队列尾部并唤醒工作任务
+ * 
+ * @param esp32_handle I2C设备句柄
+ * @param transaction 事务
+ * @return int 0表示成功，非0表示失败
+ */
+static int i2c_transaction_enqueue(esp32_i2c_handle_t *esp32_handle, i2c_transaction_t *transaction)
+{
+    if (transaction->state == I2C_TRANSACTION_QUEUED || transaction->state == I2C_TRANSACTION_ACTIVE) {
+        return ERROR_BUSY;
+    }
+    
+    transaction->next = NULL;
+    transaction->result = ERROR_NONE;
+    
+    portENTER_CRITICAL(&esp32_handle->queue_mux);
+    if (esp32_handle->worker_exit) {
+        portEXIT_CRITICAL(&esp32_handle->queue_mux);
+        return ERROR_NOT_INITIALIZED;
+    }
+    transaction->state = I2C_TRANSACTION_QUEUED;
+    if (esp32_handle->queue_tail != NULL) {
+        esp32_handle->queue_tail->next = transaction;
+    } else {
+        esp32_handle->queue_head = transaction;
+    }
+    esp32_handle->queue_tail = transaction;
+    portEXIT_CRITICAL(&esp32_handle->queue_mux);
+    
+    xTaskNotifyGive(esp32_handle->worker_task);
+    
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 提交事务并阻塞等待其完成
+ * 
+ * @param esp32_handle I2C设备句柄
+ * @param transaction 事务
+ * @param timeout_ms 超时时间（毫秒）
+ * @return int 0表示成功，非0表示失败
+ */
+static int i2c_transaction_wait(esp32_i2c_handle_t *esp32_handle, i2c_transaction_t *transaction, uint32_t timeout_ms)
+{
+    TickType_t start_tick = xTaskGetTickCount();
+    TickType_t timeout_ticks = pdMS_TO_TICKS(timeout_ms);
+    int ret;
+    
+    /* 阻塞等待者串行化，保证完成通知只有一个接收者 */
+    xSemaphoreTake(esp32_handle->sync_mutex, portMAX_DELAY);
+    
+    ret = i2c_transaction_enqueue(esp32_handle, transaction);
+    
+    if (ret == ERROR_NONE) {
+        while (transaction->state != I2C_TRANSACTION_DONE) {
+            TickType_t elapsed = xTaskGetTickCount() - start_tick;
+            
+            if (timeout_ms != UINT32_MAX && elapsed >= timeout_ticks) {
+                if (i2c_transaction_cancel(esp32_handle, transaction, ERROR_TIMEOUT)) {
+                    break;
+                }
+                
+                /* 执行中的命令链无法中止，其在总线超时内必然结束 */
+                xSemaphoreTake(esp32_handle->done_sem, portMAX_DELAY);
+                continue;
+            }
+            
+            xSemaphoreTake(esp32_handle->done_sem, timeout_ms == UINT32_MAX ? portMAX_DELAY : timeout_ticks - elapsed);
+        }
+        
+        ret = transaction->result;
+    }
+    
+    xSemaphoreGive(esp32_handle->sync_mutex);
+    
+    return ret;
+}
+
+/**
+ * @brief 经事务队列只发送设备地址，探测设备是否应答
+ * 
+ * 与其他任务的事务排队串行执行，不会在其事务中途插入起始位
+ * 
+ * @param esp32_handle I2C设备句柄
+ * @param dev_addr 设备地址
+ * @param timeout_ms 超时时间（毫秒）
+ * @return int 0表示设备应答，非0表示失败
+ */
+static int i2c_probe(esp32_i2c_handle_t *esp32_handle, uint16_t dev_addr, uint32_t timeout_ms)
+{
+    static uint8_t dummy;
+    i2c_segment_t segment = {
+        .dev_addr = dev_addr,
+        .dir = I2C_SEGMENT_WRITE,
+        .data = &dummy,
+        .len = 0,
+        .flags = I2C_FLAG_STOP,
+    };
+    i2c_transaction_t transaction = {
+        .segments = &segment,
+        .segment_count = 1,
+    };
+    
+    /* 零长度分段绕过公开接口的长度校验，仅供探测使用 */
+    return i2c_transaction_wait(esp32_handle, &transaction, timeout_ms);
+}
+
 /**
  * @brief 初始化I2C总线
  * 
@@ -110,8 +455,30 @@ int i2c_init(const i2c_config_t *config, i2c_handle_t *handle)
     
     /* 更新句柄信息 */
     esp32_handle->port = config->channel;
-    esp32_handle->initialized = true;
     memcpy(&esp32_handle->config, config, sizeof(i2c_config_t));
+    portMUX_INITIALIZE(&esp32_handle->queue_mux);
+    esp32_handle->queue_head = NULL;
+    esp32_handle->queue_tail = NULL;
+    esp32_handle->worker_exit = false;
+    
+    /* 创建事务工作任务 */
+    esp32_handle->done_sem = xSemaphoreCreateBinary();
+    esp32_handle->sync_mutex = xSemaphoreCreateMutex();
+    if (esp32_handle->done_sem == NULL || esp32_handle->sync_mutex == NULL ||
+        xTaskCreate(i2c_worker_task, "i2c_worker", CONFIG_I2C_TASK_STACK_SIZE, esp32_handle,
+                    CONFIG_I2C_TASK_PRIORITY, &esp32_handle->worker_task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create I2C worker task");
+        if (esp32_handle->done_sem != NULL) {
+            vSemaphoreDelete(esp32_handle->done_sem);
+        }
+        if (esp32_handle->sync_mutex != NULL) {
+            vSemaphoreDelete(esp32_handle->sync_mutex);
+        }
+        i2c_driver_delete(config->channel);
+        return ERROR_NO_MEMORY;
+    }
+    
+    esp32_handle->initialized = true;
     
     /* 返回句柄 */
     *handle = (i2c_handle_t)esp32_handle;
@@ -140,6 +507,24 @@ int i2c_deinit(i2c_handle_t handle)
         return ERROR_INVALID_PARAM;
     }
     
+    /* 通知工作任务退出：执行中的事务照常完成，排队中的事务以错误结束并回调 */
+    portENTER_CRITICAL(&esp32_handle->queue_mux);
+    esp32_handle->worker_exit = true;
+    portEXIT_CRITICAL(&esp32_handle->queue_mux);
+    
+    xTaskNotifyGive(esp32_handle->worker_task);
+    while (esp32_handle->worker_task != NULL) {
+        vTaskDelay(1);
+    }
+    
+    /* 等待阻塞等待者取走完成通知后再删除信号量 */
+    xSemaphoreTake(esp32_handle->sync_mutex, portMAX_DELAY);
+    esp32_handle->initialized = false;
+    xSemaphoreGive(esp32_handle->sync_mutex);
+    
+    vSemaphoreDelete(esp32_handle->done_sem);
+    vSemaphoreDelete(esp32_handle->sync_mutex);
+    
     /* 卸载I2C驱动 */
     ret = i2c_driver_delete(esp32_handle->port);
     if (ret != ESP_OK) {
@@ -466,50 +851,31 @@ int i2c_mem_read(i2c_handle_t handle, uint16_t dev_addr, uint16_t mem_addr,
 int i2c_is_device_ready(i2c_handle_t handle, uint16_t dev_addr, uint32_t retries, uint32_t timeout_ms)
 {
     esp32_i2c_handle_t *esp32_handle = (esp32_i2c_handle_t *)handle;
-    i2c_cmd_handle_t cmd;
-    esp_err_t ret;
     uint32_t retry_count = 0;
+    int ret;
     
-    /* 参数检?*/
+    /* 参数检查 */
     if (handle == NULL) {
         return ERROR_INVALID_PARAM;
     }
     
-    /* 检查句柄是否有?*/
+    /* 检查句柄是否有效 */
     if (!esp32_handle->initialized) {
         return ERROR_INVALID_PARAM;
     }
     
     /* 重试循环 */
     while (retry_count <= retries) {
-        /* 创建I2C命令链接 */
-        cmd = i2c_cmd_link_create();
-        if (cmd == NULL) {
-            return ERROR_NO_MEMORY;
-        }
-        
-        /* 发送起始位和设备地址 */
-        i2c_master_start(cmd);
+        ret = i2c_probe(esp32_handle, dev_addr, timeout_ms);
         
-        if (esp32_handle->config.addr_10bit) {
-            /* 10位地址模式 */
-            i2c_master_write_byte(cmd, (dev_addr >> 7) | 0xF0, true);
-            i2c_master_write_byte(cmd, dev_addr & 0xFF, true);
-        } else {
-            /* 7位地址模式 */
-            i2c_master_write_byte(cmd, (dev_addr << 1) | I2C_MASTER_WRITE, true);
+        /* 如果成功，设备存在 */
+        if (ret == ERROR_NONE) {
+            return ERROR_NONE;
         }
         
-        /* 发送停止位 */
-        i2c_master_stop(cmd);
-        
-        /* 执行I2C传输 */
-        ret = i2c_master_cmd_begin(esp32_handle->port, cmd, timeout_ms / portTICK_PERIOD_MS);
-        i2c_cmd_link_delete(cmd);
-        
-        /* 如果成功，设备存?*/
-        if (ret == ESP_OK) {
-            return ERROR_NONE;
+        /* 驱动正在关闭，不再重试 */
+        if (ret == ERROR_NOT_INITIALIZED) {
+            return ret;
         }
         
         retry_count++;
@@ -519,3 +885,96 @@ int i2c_is_device_ready(i2c_handle_t handle, uint16_t dev_addr, uint32_t retries
     return ERROR_TIMEOUT;
 }
 
+/**
+ * @brief 扫描I2C总线上的设备
+ * 
+ * 依次探测全部7位普通地址(0x08~0x77)，探测经事务队列执行，不会打断
+ * 其他任务正在进行的事务
+ * 
+ * @param handle I2C设备句柄
+ * @param addr_list 地址列表缓冲区
+ * @param list_size 列表大小
+ * @param found_count 找到的设备数量
+ * @return int 0表示成功，非0表示失败
+ */
+int i2c_scan_devices(i2c_handle_t handle, uint16_t *addr_list, uint8_t list_size, uint8_t *found_count)
+{
+    esp32_i2c_handle_t *esp32_handle = (esp32_i2c_handle_t *)handle;
+    uint8_t count = 0;
+    
+    /* 参数检查 */
+    if (handle == NULL || addr_list == NULL || found_count == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    if (!esp32_handle->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    for (uint16_t addr = 0x08; addr <= 0x77 && count < list_size; addr++) {
+        int ret = i2c_probe(esp32_handle, addr, CONFIG_I2C_TRANSACTION_TIMEOUT_MS);
+        
+        if (ret == ERROR_NOT_INITIALIZED) {
+            *found_count = count;
+            return ret;
+        }
+        
+        if (ret == ERROR_NONE) {
+            addr_list[count++] = addr;
+        }
+    }
+    
+    *found_count = count;
+    
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 提交I2C事务(非阻塞)
+ * 
+ * @param handle I2C设备句柄
+ * @param transaction 事务
+ * @return int 0表示成功，非0表示失败
+ */
+int i2c_transaction_submit(i2c_handle_t handle, i2c_transaction_t *transaction)
+{
+    esp32_i2c_handle_t *esp32_handle = (esp32_i2c_handle_t *)handle;
+    int ret;
+    
+    /* 参数检查 */
+    if (handle == NULL || !esp32_handle->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    ret = i2c_transaction_validate(transaction);
+    if (ret != ERROR_NONE) {
+        return ret;
+    }
+    
+    return i2c_transaction_enqueue(esp32_handle, transaction);
+}
+
+/**
+ * @brief 执行I2C事务(阻塞)
+ * 
+ * @param handle I2C设备句柄
+ * @param transaction 事务
+ * @param timeout_ms 超时时间（毫秒）
+ * @return int 0表示成功，非0表示失败
+ */
+int i2c_transaction_execute(i2c_handle_t handle, i2c_transaction_t *transaction, uint32_t timeout_ms)
+{
+    esp32_i2c_handle_t *esp32_handle = (esp32_i2c_handle_t *)handle;
+    int ret;
+    
+    if (handle == NULL || !esp32_handle->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    ret = i2c_transaction_validate(transaction);
+    if (ret != ERROR_NONE) {
+        return ret;
+    }
+    
+    return i2c_transaction_wait(esp32_handle, transaction, timeout_ms);
+}
@@ -2,23 +2,48 @@
  * @file stm32_i2c.c
  * @brief STM32 I2C驱动实现
  *
- * 该文件实现了STM32平台的I2C接口，符合i2c_api.h中定义的统一接口
+ * 该文件实现了STM32平台的I2C接口，符合i2c_api.h中定义的统一接口。
+ * 所有传输都经过每条总线的事务队列，分段由中断驱动的顺序传输完成并在
+ * 完成中断中衔接，阻塞接口只是提交事务后等待完成
  */
 
 #include "base/i2c_api.h"
+#include "common/error_api.h"
 #include "stm32_platform.h"
 #include "stm32f4xx_hal.h"
+#include <string.h>
+
+#if (CURRENT_RTOS != RTOS_NONE)
+#include "common/rtos_api.h"
+#endif
+
+/* I2C中断优先级 */
+#ifndef CONFIG_I2C_IRQ_PRIORITY
+#define CONFIG_I2C_IRQ_PRIORITY     7
+#endif
 
 /* I2C设备结构?*/
 typedef struct {
     I2C_HandleTypeDef hi2c;          /**< HAL I2C句柄 */
     i2c_channel_t channel;           /**< I2C通道 */
     bool initialized;                /**< 初始化标?*/
+    i2c_transaction_t *queue_head;   /**< 事务队列头 */
+    i2c_transaction_t *queue_tail;   /**< 事务队列尾 */
+    i2c_transaction_t *volatile active; /**< 正在执行的事务 */
+    uint32_t segment_index;          /**< 当前分段索引 */
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_sem_t done_sem;             /**< 事务完成通知 */
+    rtos_mutex_t sync_mutex;         /**< 阻塞等待者互斥锁 */
+#endif
 } stm32_i2c_t;
 
 /* I2C设备实例 */
 static stm32_i2c_t stm32_i2c_devices[I2C_CHANNEL_MAX];
 
+/* I2C事件与错误中断号 */
+static const IRQn_Type i2c_ev_irqs[I2C_CHANNEL_MAX] = { I2C1_EV_IRQn, I2C2_EV_IRQn, I2C3_EV_IRQn };
+static const IRQn_Type i2c_er_irqs[I2C_CHANNEL_MAX] = { I2C1_ER_IRQn, I2C2_ER_IRQn, I2C3_ER_IRQn };
+
 /**
  * @brief 获取STM32 I2C外设
  * 
@@ -106,6 +131,223 @@ static int init_i2c_gpio(i2c_channel_t channel)
     return DRIVER_OK;
 }
 
+/**
+ * @brief 关中断，返回原中断状态
+ */
+static inline uint32_t i2c_irq_lock(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+/**
+ * @brief 恢复中断状态
+ */
+static inline void i2c_irq_unlock(uint32_t primask)
+{
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 启动当前事务的当前分段
+ * 
+ * 按与前一分段的关系选择顺序传输选项：首个分段或前一分段带停止位时产生
+ * 起始位，设备地址改变时产生重复起始位，方向改变时HAL自动产生重复起始位
+ * 
+ * @param stm32_i2c I2C设备
+ * @return int 0表示成功，非0表示失败
+ */
+static int i2c_segment_start(stm32_i2c_t *stm32_i2c)
+{
+    const i2c_transaction_t *transaction = stm32_i2c->active;
+    const i2c_segment_t *segment = &transaction->segments[stm32_i2c->segment_index];
+    const i2c_segment_t *prev = (stm32_i2c->segment_index > 0) ? segment - 1 : NULL;
+    bool last = (segment->flags & I2C_FLAG_STOP) || stm32_i2c->segment_index + 1 == transaction->segment_count;
+    uint16_t address = segment->dev_addr;
+    uint32_t options;
+    HAL_StatusTypeDef status;
+    
+    if (prev == NULL || (prev->flags & I2C_FLAG_STOP)) {
+        options = last ? I2C_FIRST_AND_LAST_FRAME : I2C_FIRST_FRAME;
+    } else if (prev->dev_addr != segment->dev_addr && prev->dir == segment->dir) {
+        options = last ? I2C_OTHER_AND_LAST_FRAME : I2C_OTHER_FRAME;
+    } else {
+        options = last ? I2C_LAST_FRAME : I2C_NEXT_FRAME;
+    }
+    
+    /* HAL使用左移后的7位地址 */
+    if (stm32_i2c->hi2c.Init.AddressingMode == I2C_ADDRESSINGMODE_7BIT) {
+        address = (uint16_t)(address << 1);
+    }
+    
+    if (segment->dir == I2C_SEGMENT_WRITE) {
+        status = HAL_I2C_Master_Seq_Transmit_IT(&stm32_i2c->hi2c, address, segment->data, segment->len, options);
+    } else {
+        status = HAL_I2C_Master_Seq_Receive_IT(&stm32_i2c->hi2c, address, segment->data, segment->len, options);
+    }
+    
+    return (status == HAL_OK) ? DRIVER_OK : DRIVER_ERROR;
+}
+
+static void i2c_transaction_start_next(stm32_i2c_t *stm32_i2c);
+
+/**
+ * @brief 结束当前事务并启动队列中的下一个事务
+ * 
+ * @param stm32_i2c I2C设备
+ * @param result 事务结果
+ */
+static void i2c_transaction_complete(stm32_i2c_t *stm32_i2c, int result)
+{
+    i2c_transaction_t *transaction = stm32_i2c->active;
+    
+    stm32_i2c->active = NULL;
+    transaction->result = result;
+    
+    if (transaction->callback != NULL) {
+        transaction->callback(transaction, result, transaction->user_data);
+    }
+    
+    /* 回调返回后才标记完成，阻塞等待者随后即可复用事务对象 */
+    transaction->state = I2C_TRANSACTION_DONE;
+    
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_sem_give(stm32_i2c->done_sem);
+#endif
+    
+    i2c_transaction_start_next(stm32_i2c);
+}
+
+/**
+ * @brief 总线空闲时从队列取出下一个事务并启动
+ */
+static void i2c_transaction_start_next(stm32_i2c_t *stm32_i2c)
+{
+    i2c_transaction_t *transaction = NULL;
+    uint32_t primask = i2c_irq_lock();
+    
+    if (stm32_i2c->active == NULL && stm32_i2c->queue_head != NULL) {
+        transaction = stm32_i2c->queue_head;
+        stm32_i2c->queue_head = transaction->next;
+        if (stm32_i2c->queue_head == NULL) {
+            stm32_i2c->queue_tail = NULL;
+        }
+        transaction->next = NULL;
+        transaction->state = I2C_TRANSACTION_ACTIVE;
+        stm32_i2c->active = transaction;
+        stm32_i2c->segment_index = 0;
+    }
+    
+    i2c_irq_unlock(primask);
+    
+    if (transaction == NULL) {
+        return;
+    }
+    
+    if (i2c_segment_start(stm32_i2c) != DRIVER_OK) {
+        i2c_transaction_complete(stm32_i2c, ERROR_HARDWARE);
+    }
+}
+
+/**
+ * @brief 分段结束，衔接下一分段或结束事务
+ * 
+ * @param stm32_i2c I2C设备
+ * @param result 分段结果
+ */
+static void i2c_segment_done(stm32_i2c_t *stm32_i2c, int result)
+{
+    if (stm32_i2c->active == NULL) {
+        return;
+    }
+    
+    if (result == DRIVER_OK && ++stm32_i2c->segment_index < stm32_i2c->active->segment_count) {
+        if (i2c_segment_start(stm32_i2c) == DRIVER_OK) {
+            return;
+        }
+        result = ERROR_HARDWARE;
+    }
+    
+    i2c_transaction_complete(stm32_i2c, result);
+}
+
+/**
+ * @brief 取消事务
+ * 
+ * 排队中的事务直接摘除，执行中的事务关闭中断并发送停止位后按失败结束
+ * 
+ * @param stm32_i2c I2C设备
+ * @param transaction 事务
+ * @param result 写入事务的结果
+ */
+static void i2c_transaction_cancel(stm32_i2c_t *stm32_i2c, i2c_transaction_t *transaction, int result)
+{
+    uint32_t primask = i2c_irq_lock();
+    
+    if (transaction->state == I2C_TRANSACTION_QUEUED) {
+        i2c_transaction_t **link = &stm32_i2c->queue_head;
+        i2c_transaction_t *prev = NULL;
+        
+        while (*link != NULL && *link != transaction) {
+            prev = *link;
+            link = &(*link)->next;
+        }
+        
+        if (*link == transaction) {
+            *link = transaction->next;
+            if (stm32_i2c->queue_tail == transaction) {
+                stm32_i2c->queue_tail = prev;
+            }
+        }
+        
+        transaction->next = NULL;
+        transaction->result = result;
+        transaction->state = I2C_TRANSACTION_DONE;
+        i2c_irq_unlock(primask);
+        return;
+    }
+    
+    if (transaction->state == I2C_TRANSACTION_ACTIVE && stm32_i2c->active == transaction) {
+        I2C_HandleTypeDef *hi2c = &stm32_i2c->hi2c;
+        
+        __HAL_I2C_DISABLE_IT(hi2c, I2C_IT_EVT | I2C_IT_BUF | I2C_IT_ERR);
+        SET_BIT(hi2c->Instance->CR1, I2C_CR1_STOP);
+        hi2c->State = HAL_I2C_STATE_READY;
+        hi2c->PreviousState = I2C_STATE_NONE;
+        hi2c->Mode = HAL_I2C_MODE_NONE;
+        i2c_irq_unlock(primask);
+        i2c_transaction_complete(stm32_i2c, result);
+        return;
+    }
+    
+    i2c_irq_unlock(primask);
+}
+
+/**
+ * @brief HAL主机发送完成回调
+ */
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    i2c_segment_done((stm32_i2c_t *)hi2c, DRIVER_OK);
+}
+
+/**
+ * @brief HAL主机接收完成回调
+ */
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    i2c_segment_done((stm32_i2c_t *)hi2c, DRIVER_OK);
+}
+
+/**
+ * @brief HAL错误回调，NACK和总线错误均使事务失败
+ */
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    i2c_segment_done((stm32_i2c_t *)hi2c, ERROR_HARDWARE);
+}
+
 /**
  * @brief 初始化I2C总线
  * 
@@ -181,6 +423,28 @@ int i2c_init(const i2c_config_t *config, i2c_handle_t *handle)
         return DRIVER_ERROR;
     }
     
+    stm32_i2c->queue_head = NULL;
+    stm32_i2c->queue_tail = NULL;
+    stm32_i2c->active = NULL;
+    
+#if (CURRENT_RTOS != RTOS_NONE)
+    if (rtos_sem_create(&stm32_i2c->done_sem, 0, 1) != 0) {
+        HAL_I2C_DeInit(&stm32_i2c->hi2c);
+        return ERROR_MEMORY;
+    }
+    
+    if (rtos_mutex_create(&stm32_i2c->sync_mutex) != 0) {
+        rtos_sem_delete(stm32_i2c->done_sem);
+        HAL_I2C_DeInit(&stm32_i2c->hi2c);
+        return ERROR_MEMORY;
+    }
+#endif
+    
+    HAL_NVIC_SetPriority(i2c_ev_irqs[config->channel], CONFIG_I2C_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(i2c_ev_irqs[config->channel]);
+    HAL_NVIC_SetPriority(i2c_er_irqs[config->channel], CONFIG_I2C_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(i2c_er_irqs[config->channel]);
+    
     /* 设置结构体字?*/
     stm32_i2c->channel = config->channel;
     stm32_i2c->initialized = true;
@@ -205,17 +469,166 @@ int i2c_deinit(i2c_handle_t handle)
         return DRIVER_INVALID_PARAM;
     }
     
+    /* 先停止执行：拒绝新提交并摘下队列，中止正在执行的事务后不再衔接 */
+    uint32_t primask = i2c_irq_lock();
+    i2c_transaction_t *pending = stm32_i2c->queue_head;
+    stm32_i2c->initialized = false;
+    stm32_i2c->queue_head = NULL;
+    stm32_i2c->queue_tail = NULL;
+    i2c_irq_unlock(primask);
+    
+    if (stm32_i2c->active != NULL) {
+        i2c_transaction_cancel(stm32_i2c, stm32_i2c->active, ERROR_NOT_INITIALIZED);
+    }
+    
+    HAL_NVIC_DisableIRQ(i2c_ev_irqs[stm32_i2c->channel]);
+    HAL_NVIC_DisableIRQ(i2c_er_irqs[stm32_i2c->channel]);
+    
+    /* 排队中的事务以失败结束，完成回调照常调用，并唤醒阻塞等待者 */
+    while (pending != NULL) {
+        i2c_transaction_t *next = pending->next;
+        pending->next = NULL;
+        pending->result = ERROR_NOT_INITIALIZED;
+        if (pending->callback != NULL) {
+            pending->callback(pending, ERROR_NOT_INITIALIZED, pending->user_data);
+        }
+        pending->state = I2C_TRANSACTION_DONE;
+#if (CURRENT_RTOS != RTOS_NONE)
+        rtos_sem_give(stm32_i2c->done_sem);
+#endif
+        pending = next;
+    }
+    
+#if (CURRENT_RTOS != RTOS_NONE)
+    /* 阻塞等待者看到事务完成后释放互斥锁，之后才能删除同步对象 */
+    rtos_mutex_lock(stm32_i2c->sync_mutex, UINT32_MAX);
+    rtos_mutex_unlock(stm32_i2c->sync_mutex);
+    rtos_mutex_delete(stm32_i2c->sync_mutex);
+    rtos_sem_delete(stm32_i2c->done_sem);
+#endif
+    
     /* 去初始化I2C */
     if (HAL_I2C_DeInit(&stm32_i2c->hi2c) != HAL_OK) {
         return DRIVER_ERROR;
     }
     
-    /* 重置结构体字?*/
-    stm32_i2c->initialized = false;
+    return DRIVER_OK;
+}
+
+/**
+ * @brief 提交I2C事务(非阻塞)
+ * 
+ * @param handle I2C设备句柄
+ * @param transaction 事务
+ * @return int 0表示成功，非0表示失败
+ */
+int i2c_transaction_submit(i2c_handle_t handle, i2c_transaction_t *transaction)
+{
+    stm32_i2c_t *stm32_i2c = (stm32_i2c_t *)handle;
+    uint32_t primask;
+    
+    if (stm32_i2c == NULL || !stm32_i2c->initialized || transaction == NULL ||
+        transaction->segments == NULL || transaction->segment_count == 0) {
+        return DRIVER_INVALID_PARAM;
+    }
+    
+    if (transaction->state == I2C_TRANSACTION_QUEUED || transaction->state == I2C_TRANSACTION_ACTIVE) {
+        return ERROR_BUSY;
+    }
+    
+    for (uint32_t i = 0; i < transaction->segment_count; i++) {
+        if (transaction->segments[i].data == NULL || transaction->segments[i].len == 0) {
+            return DRIVER_INVALID_PARAM;
+        }
+    }
+    
+    transaction->next = NULL;
+    transaction->result = ERROR_NONE;
+    transaction->state = I2C_TRANSACTION_QUEUED;
+    
+    /* 追加到总线队列尾部 */
+    primask = i2c_irq_lock();
+    if (stm32_i2c->queue_tail != NULL) {
+        stm32_i2c->queue_tail->next = transaction;
+    } else {
+        stm32_i2c->queue_head = transaction;
+    }
+    stm32_i2c->queue_tail = transaction;
+    i2c_irq_unlock(primask);
+    
+    /* 总线空闲时立即启动 */
+    i2c_transaction_start_next(stm32_i2c);
     
     return DRIVER_OK;
 }
 
+/**
+ * @brief 执行I2C事务(阻塞)
+ * 
+ * @param handle I2C设备句柄
+ * @param transaction 事务
+ * @param timeout_ms 超时时间（毫秒）
+ * @return int 0表示成功，非0表示失败
+ */
+int i2c_transaction_execute(i2c_handle_t handle, i2c_transaction_t *transaction, uint32_t timeout_ms)
+{
+    stm32_i2c_t *stm32_i2c = (stm32_i2c_t *)handle;
+    int ret;
+    
+    if (stm32_i2c == NULL || !stm32_i2c->initialized) {
+        return DRIVER_INVALID_PARAM;
+    }
+    
+#if (CURRENT_RTOS != RTOS_NONE)
+    /* 阻塞等待者串行化，保证完成通知只有一个接收者 */
+    rtos_mutex_lock(stm32_i2c->sync_mutex, UINT32_MAX);
+#endif
+    
+    ret = i2c_transaction_submit(handle, transaction);
+    
+    if (ret == DRIVER_OK) {
+        uint32_t start_time = HAL_GetTick();
+        
+        while (transaction->state != I2C_TRANSACTION_DONE) {
+            uint32_t elapsed = HAL_GetTick() - start_time;
+            
+            if (timeout_ms != UINT32_MAX && elapsed >= timeout_ms) {
+                i2c_transaction_cancel(stm32_i2c, transaction, ERROR_TIMEOUT);
+                break;
+            }
+            
+#if (CURRENT_RTOS != RTOS_NONE)
+            rtos_sem_take(stm32_i2c->done_sem, timeout_ms == UINT32_MAX ? UINT32_MAX : timeout_ms - elapsed);
+#else
+            __WFI();
+#endif
+        }
+        
+        ret = transaction->result;
+    }
+    
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_mutex_unlock(stm32_i2c->sync_mutex);
+#endif
+    
+    return ret;
+}
+
+/**
+ * @brief 以单个事务执行若干分段，供阻塞接口使用
+ */
+static int i2c_execute_segments(stm32_i2c_t *stm32_i2c, const i2c_segment_t *segments,
+                                uint32_t count, uint32_t timeout_ms)
+{
+    i2c_transaction_t transaction;
+    
+    memset(&transaction, 0, sizeof(transaction));
+    transaction.segments = segments;
+    transaction.segment_count = count;
+    
+    return i2c_transaction_execute(stm32_i2c, &transaction, timeout_ms);
+}
+
 /**
  * @brief I2C主机发送数?
  * 
@@ -231,9 +644,10 @@ int i2c_master_transmit(i2c_handle_t handle, uint16_t dev_addr, const uint8_t *d
                       uint32_t len, uint32_t flags, uint32_t timeout_ms)
 {
     stm32_i2c_t *stm32_i2c = (stm32_i2c_t *)handle;
-    HAL_StatusTypeDef status;
+    i2c_segment_t segment;
+    int ret;
     
-    if (stm32_i2c == NULL || !stm32_i2c->initialized || data == NULL || len == 0) {
+    if (stm32_i2c == NULL || !stm32_i2c->initialized || data == NULL || len == 0 || len > 0xFFFF) {
         return DRIVER_INVALID_PARAM;
     }
     
@@ -244,14 +658,15 @@ int i2c_master_transmit(i2c_handle_t handle, uint16_t dev_addr, const uint8_t *d
         stm32_i2c->hi2c.Init.AddressingMode = I2C_ADDRESSINGMODE_7BIT;
     }
     
-    /* 发送数?*/
-    status = HAL_I2C_Master_Transmit(&stm32_i2c->hi2c, dev_addr, (uint8_t *)data, len, timeout_ms);
+    segment.dev_addr = dev_addr;
+    segment.dir = I2C_SEGMENT_WRITE;
+    segment.data = (uint8_t *)data;
+    segment.len = (uint16_t)len;
+    segment.flags = I2C_FLAG_STOP;
     
-    if (status != HAL_OK) {
-        return DRIVER_ERROR;
-    }
+    ret = i2c_execute_segments(stm32_i2c, &segment, 1, timeout_ms);
     
-    return len;
+    return (ret == ERROR_NONE) ? (int)len : ret;
 }
 
 /**
@@ -269,9 +684,10 @@ int i2c_master_receive(i2c_handle_t handle, uint16_t dev_addr, uint8_t *data,
                      uint32_t len, uint32_t flags, uint32_t timeout_ms)
 {
     stm32_i2c_t *stm32_i2c = (stm32_i2c_t *)handle;
-    HAL_StatusTypeDef status;
+    i2c_segment_t segment;
+    int ret;
     
-    if (stm32_i2c == NULL || !stm32_i2c->initialized || data == NULL || len == 0) {
+    if (stm32_i2c == NULL || !stm32_i2c->initialized || data == NULL || len == 0 || len > 0xFFFF) {
         return DRIVER_INVALID_PARAM;
     }
     
@@ -282,14 +698,15 @@ int i2c_master_receive(i2c_handle_t handle, uint16_t dev_addr, uint8_t *data,
         stm32_i2c->hi2c.Init.AddressingMode = I2C_ADDRESSINGMODE_7BIT;
     }
     
-    /* 接收数据 */
-    status = HAL_I2C_Master_Receive(&stm32_i2c->hi2c, dev_addr, data, len, timeout_ms);
+    segment.dev_addr = dev_addr;
+    segment.dir = I2C_SEGMENT_READ;
+    segment.data = data;
+    segment.len = (uint16_t)len;
+    segment.flags = I2C_FLAG_STOP;
     
-    if (status != HAL_OK) {
-        return DRIVER_ERROR;
-    }
+    ret = i2c_execute_segments(stm32_i2c, &segment, 1, timeout_ms);
     
-    return len;
+    return (ret == ERROR_NONE) ? (int)len : ret;
 }
 
 /**
@@ -308,30 +725,35 @@ int i2c_mem_write(i2c_handle_t handle, uint16_t dev_addr, uint16_t mem_addr,
                 uint8_t mem_addr_size, const uint8_t *data, uint32_t len, uint32_t timeout_ms)
 {
     stm32_i2c_t *stm32_i2c = (stm32_i2c_t *)handle;
-    HAL_StatusTypeDef status;
-    uint16_t size;
+    i2c_segment_t segments[2];
+    uint8_t reg[2];
+    int ret;
     
-    if (stm32_i2c == NULL || !stm32_i2c->initialized || data == NULL || len == 0) {
+    if (stm32_i2c == NULL || !stm32_i2c->initialized || data == NULL || len == 0 || len > 0xFFFF ||
+        (mem_addr_size != 1 && mem_addr_size != 2)) {
         return DRIVER_INVALID_PARAM;
     }
     
-    /* 转换地址大小 */
-    if (mem_addr_size == 1) {
-        size = I2C_MEMADD_SIZE_8BIT;
-    } else if (mem_addr_size == 2) {
-        size = I2C_MEMADD_SIZE_16BIT;
-    } else {
-        return DRIVER_INVALID_PARAM;
-    }
+    /* 内存地址高字节在前 */
+    reg[0] = (uint8_t)(mem_addr >> 8);
+    reg[1] = (uint8_t)mem_addr;
     
-    /* 写入内存 */
-    status = HAL_I2C_Mem_Write(&stm32_i2c->hi2c, dev_addr, mem_addr, size, (uint8_t *)data, len, timeout_ms);
+    /* 寄存器地址与数据连续写入，中间不产生重复起始 */
+    segments[0].dev_addr = dev_addr;
+    segments[0].dir = I2C_SEGMENT_WRITE;
+    segments[0].data = &reg[2 - mem_addr_size];
+    segments[0].len = mem_addr_size;
+    segments[0].flags = I2C_FLAG_NONE;
     
-    if (status != HAL_OK) {
-        return DRIVER_ERROR;
-    }
+    segments[1].dev_addr = dev_addr;
+    segments[1].dir = I2C_SEGMENT_WRITE;
+    segments[1].data = (uint8_t *)data;
+    segments[1].len = (uint16_t)len;
+    segments[1].flags = I2C_FLAG_STOP;
+    
+    ret = i2c_execute_segments(stm32_i2c, segments, 2, timeout_ms);
     
-    return len;
+    return (ret == ERROR_NONE) ? (int)len : ret;
 }
 
 /**
@@ -350,30 +772,35 @@ int i2c_mem_read(i2c_handle_t handle, uint16_t dev_addr, uint16_t mem_addr,
                uint8_t mem_addr_size, uint8_t *data, uint32_t len, uint32_t timeout_ms)
 {
     stm32_i2c_t *stm32_i2c = (stm32_i2c_t *)handle;
-    HAL_StatusTypeDef status;
-    uint16_t size;
+    i2c_segment_t segments[2];
+    uint8_t reg[2];
+    int ret;
     
-    if (stm32_i2c == NULL || !stm32_i2c->initialized || data == NULL || len == 0) {
+    if (stm32_i2c == NULL || !stm32_i2c->initialized || data == NULL || len == 0 || len > 0xFFFF ||
+        (mem_addr_size != 1 && mem_addr_size != 2)) {
         return DRIVER_INVALID_PARAM;
     }
     
-    /* 转换地址大小 */
-    if (mem_addr_size == 1) {
-        size = I2C_MEMADD_SIZE_8BIT;
-    } else if (mem_addr_size == 2) {
-        size = I2C_MEMADD_SIZE_16BIT;
-    } else {
-        return DRIVER_INVALID_PARAM;
-    }
+    /* 内存地址高字节在前 */
+    reg[0] = (uint8_t)(mem_addr >> 8);
+    reg[1] = (uint8_t)mem_addr;
     
-    /* 读取内存 */
-    status = HAL_I2C_Mem_Read(&stm32_i2c->hi2c, dev_addr, mem_addr, size, data, len, timeout_ms);
+    /* 写寄存器地址后以重复起始位连续读出 */
+    segments[0].dev_addr = dev_addr;
+    segments[0].dir = I2C_SEGMENT_WRITE;
+    segments[0].data = &reg[2 - mem_addr_size];
+    segments[0].len = mem_addr_size;
+    segments[0].flags = I2C_FLAG_NONE;
     
-    if (status != HAL_OK) {
-        return DRIVER_ERROR;
-    }
+    segments[1].dev_addr = dev_addr;
+    segments[1].dir = I2C_SEGMENT_READ;
+    segments[1].data = data;
+    segments[1].len = (uint16_t)len;
+    segments[1].flags = I2C_FLAG_STOP;
+    
+    ret = i2c_execute_segments(stm32_i2c, segments, 2, timeout_ms);
     
-    return len;
+    return (ret == ERROR_NONE) ? (int)len : ret;
 }
 
 /**
@@ -394,6 +821,11 @@ int i2c_is_device_ready(i2c_handle_t handle, uint16_t dev_addr, uint32_t retries
         return DRIVER_INVALID_PARAM;
     }
     
+    /* HAL使用左移后的7位地址 */
+    if (stm32_i2c->hi2c.Init.AddressingMode == I2C_ADDRESSINGMODE_7BIT) {
+        dev_addr = (uint16_t)(dev_addr << 1);
+    }
+    
     /* 检测设备是否就?*/
     status = HAL_I2C_IsDeviceReady(&stm32_i2c->hi2c, dev_addr, retries, timeout_ms);
     
@@ -404,3 +836,50 @@ int i2c_is_device_ready(i2c_handle_t handle, uint16_t dev_addr, uint32_t retries
     return DRIVER_OK;
 }
 
+/**
+ * @brief I2C1事件中断处理函数
+ */
+void I2C1_EV_IRQHandler(void)
+{
+    HAL_I2C_EV_IRQHandler(&stm32_i2c_devices[I2C_CHANNEL_0].hi2c);
+}
+
+/**
+ * @brief I2C1错误中断处理函数
+ */
+void I2C1_ER_IRQHandler(void)
+{
+    HAL_I2C_ER_IRQHandler(&stm32_i2c_devices[I2C_CHANNEL_0].hi2c);
+}
+
+/**
+ * @brief I2C2事件中断处理函数
+ */
+void I2C2_EV_IRQHandler(void)
+{
+    HAL_I2C_EV_IRQHandler(&stm32_i2c_devices[I2C_CHANNEL_1].hi2c);
+}
+
+/**
+ * @brief I2C2错误中断处理函数
+ */
+void I2C2_ER_IRQHandler(void)
+{
+    HAL_I2C_ER_IRQHandler(&stm32_i2c_devices[I2C_CHANNEL_1].hi2c);
+}
+
+/**
+ * @brief I2C3事件中断处理函数
+ */
+void I2C3_EV_IRQHandler(void)
+{
+    HAL_I2C_EV_IRQHandler(&stm32_i2c_devices[I2C_CHANNEL_2].hi2c);
+}
+
+/**
+ * @brief I2C3错误中断处理函数
+ */
+void I2C3_ER_IRQHandler(void)
+{
+    HAL_I2C_ER_IRQHandler(&stm32_i2c_devices[I2C_CHANNEL_2].hi2c);
+}
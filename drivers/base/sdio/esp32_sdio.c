@@ -645,3 +645,88 @@ int sdio_execute_command(sdio_handle_t handle, uint8_t cmd, uint32_t arg, uint32
     return DRIVER_OK;
 }
 
+
+/**
+ * @brief 提交SDIO块请求
+ * 
+ * sdmmc驱动内部已使用DMA和多块命令且只提供阻塞接口，请求在提交时同步执行，
+ * 回调在返回前调用
+ * 
+ * @param handle SDIO设备句柄
+ * @param request 块请求
+ * @return int 0表示成功，非0表示失败
+ */
+int sdio_request_submit(sdio_handle_t handle, sdio_request_t *request)
+{
+    int result;
+    
+    /* 参数检查 */
+    if (request == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    if (request->state == SDIO_REQUEST_QUEUED || request->state == SDIO_REQUEST_ACTIVE) {
+        return ERROR_BUSY;
+    }
+    
+    request->next = NULL;
+    request->state = SDIO_REQUEST_ACTIVE;
+    
+    if (request->write) {
+        result = sdio_write_blocks(handle, request->block_addr, request->data, request->block_count);
+    } else {
+        result = sdio_read_blocks(handle, request->block_addr, request->data, request->block_count);
+    }
+    
+    /* 参数错误时请求未被接受 */
+    if (result == ERROR_INVALID_PARAM) {
+        request->state = SDIO_REQUEST_IDLE;
+        return result;
+    }
+    
+    request->result = result;
+    if (request->callback != NULL) {
+        request->callback(request, result, request->user_data);
+    }
+    request->state = SDIO_REQUEST_DONE;
+    
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 执行SDIO块请求(阻塞)
+ * 
+ * @param handle SDIO设备句柄
+ * @param request 块请求
+ * @param timeout_ms 超时时间（毫秒），由sdmmc驱动自身的命令超时保证
+ * @return int 0表示成功，非0表示失败
+ */
+int sdio_request_execute(sdio_handle_t handle, sdio_request_t *request, uint32_t timeout_ms)
+{
+    int ret = sdio_request_submit(handle, request);
+    
+    if (ret != ERROR_NONE) {
+        return ret;
+    }
+    
+    return request->result;
+}
+
+/**
+ * @brief 推进SDIO请求队列
+ * 
+ * 请求同步执行，没有需要推进的状态
+ * 
+ * @param handle SDIO设备句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int sdio_poll(sdio_handle_t handle)
+{
+    esp32_sdio_device_t *dev = (esp32_sdio_device_t *)handle;
+    
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    return DRIVER_OK;
+}
@@ -6,13 +6,66 @@
  */
 
 #include "base/sdio_api.h"
+#include "base/dma_api.h"
 #include "common/error_api.h"
 #include "stm32f4xx_hal.h"
 #include <string.h>
 
+#if (CURRENT_RTOS != RTOS_NONE)
+#include "common/rtos_api.h"
+#endif
+
+#if defined(CONFIG_TIMER_WHEEL_ENABLED) && CONFIG_TIMER_WHEEL_ENABLED
+#include "common/timer_wheel.h"
+#endif
+
 /* STM32 SDIO超时时间 (ms) */
 #define SDIO_TIMEOUT          5000
 
+/* SD卡数据块大小 */
+#define SDIO_BLOCK_SIZE       512U
+
+/* 单次多块传输的最大块数，超过的请求分块传输（DMA计数寄存器为16位，不超过511） */
+#ifndef CONFIG_SDIO_MAX_TRANSFER_BLOCKS
+#define CONFIG_SDIO_MAX_TRANSFER_BLOCKS  128
+#endif
+
+/* 弹性缓冲区块数，用于非对齐缓冲区以及内存不连续的请求合并 */
+#ifndef CONFIG_SDIO_BOUNCE_BLOCKS
+#define CONFIG_SDIO_BOUNCE_BLOCKS        8
+#endif
+
+/* SDIO及其DMA数据流中断优先级 */
+#ifndef CONFIG_SDIO_IRQ_PRIORITY
+#define CONFIG_SDIO_IRQ_PRIORITY         5
+#endif
+
+/* 写入后查询卡编程状态的周期 (ms) */
+#ifndef CONFIG_SDIO_BUSY_POLL_MS
+#define CONFIG_SDIO_BUSY_POLL_MS         1
+#endif
+
+/* SDIO DMA数据流：DMA2 Stream3接收，DMA2 Stream6发送，均为通道4 */
+#define SDIO_DMA_RX_STREAM    11U
+#define SDIO_DMA_TX_STREAM    14U
+
+/* 数据阶段中断与错误标志 */
+#define SDIO_DATA_IT          (SDIO_IT_DATAEND | SDIO_IT_DCRCFAIL | SDIO_IT_DTIMEOUT | \
+                               SDIO_IT_RXOVERR | SDIO_IT_TXUNDERR | SDIO_IT_STBITERR)
+#define SDIO_DATA_ERROR_FLAGS (SDIO_FLAG_DCRCFAIL | SDIO_FLAG_DTIMEOUT | SDIO_FLAG_RXOVERR | \
+                               SDIO_FLAG_TXUNDERR | SDIO_FLAG_STBITERR)
+
+/* 数据阶段等待的完成事件，数据结束与DMA完成都到达后传输才结束 */
+#define SDIO_EVENT_DATAEND    0x01U
+#define SDIO_EVENT_DMA        0x02U
+
+/* SDIO传输阶段 */
+typedef enum {
+    SDIO_XFER_IDLE = 0,             /* 总线空闲 */
+    SDIO_XFER_DATA,                 /* 数据传输中 */
+    SDIO_XFER_PROGRAMMING           /* 写入结束，等待卡完成编程 */
+} sdio_xfer_phase_t;
+
 /* STM32 SDIO设备结构?*/
 typedef struct {
     SD_HandleTypeDef hsd;           /* HAL SD句柄 */
@@ -22,6 +75,28 @@ typedef struct {
     void *arg;                      /* 回调参数 */
     volatile sdio_status_t status;  /* 操作状?*/
     bool initialized;               /* 初始化标?*/
+    dma_handle_t dma_rx;            /* 接收DMA句柄 */
+    dma_handle_t dma_tx;            /* 发送DMA句柄 */
+    sdio_request_t *queue_head;     /* 请求队列头 */
+    sdio_request_t *queue_tail;     /* 请求队列尾 */
+    sdio_request_t *active;         /* 当前传输包含的请求链 */
+    uint32_t active_offset;         /* 分块传输时首个请求已完成的块数 */
+    uint32_t xfer_blocks;           /* 当前传输块数 */
+    bool xfer_write;                /* 当前传输为写入 */
+    bool xfer_bounce;               /* 当前传输经弹性缓冲区 */
+    volatile sdio_xfer_phase_t phase; /* 传输阶段 */
+    volatile uint32_t xfer_pending; /* 数据阶段尚未到达的完成事件 */
+    volatile int xfer_result;       /* 数据阶段结果 */
+    volatile bool cmd_claimed;      /* 命令通道被状态查询或中止占用 */
+    uint32_t busy_start;            /* 开始等待卡编程完成的时刻 */
+#if defined(CONFIG_TIMER_WHEEL_ENABLED) && CONFIG_TIMER_WHEEL_ENABLED
+    timer_wheel_timer_t busy_timer; /* 卡编程状态查询定时器 */
+#endif
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_sem_t done_sem;            /* 请求完成通知 */
+    rtos_mutex_t sync_mutex;        /* 串行化阻塞等待者 */
+#endif
+    uint32_t bounce[CONFIG_SDIO_BOUNCE_BLOCKS * SDIO_BLOCK_SIZE / 4U]; /* 弹性缓冲区 */
 } stm32_sdio_device_t;
 
 /* SDIO设备 */
@@ -83,6 +158,689 @@ static void update_card_info(stm32_sdio_device_t *dev)
     dev->card_info.manufacturing_date[1] = 0;
 }
 
+/**
+ * @brief 关闭中断并返回之前的中断状态
+ */
+static inline uint32_t sdio_irq_lock(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+/**
+ * @brief 恢复中断状态
+ */
+static inline void sdio_irq_unlock(uint32_t primask)
+{
+    __set_PRIMASK(primask);
+}
+
+/* 判断缓冲区能否由DMA直接访问：需4字节对齐，且CCM RAM只连接到CPU数据总线 */
+static bool sdio_dma_capable(const void *data, uint32_t block_count)
+{
+    uint32_t start = (uint32_t)data;
+    
+    if (start & 3U) {
+        return false;
+    }
+    
+#ifdef CCMDATARAM_BASE
+    uint32_t end = start + block_count * SDIO_BLOCK_SIZE - 1U;
+    
+    if (end >= CCMDATARAM_BASE && start <= CCMDATARAM_END) {
+        return false;
+    }
+#else
+    (void)block_count;
+#endif
+    return true;
+}
+
+/* 等待不带数据的命令响应，检查R1中的错误位 */
+static uint32_t sdio_wait_cmd_resp(SDIO_TypeDef *sdio)
+{
+    uint32_t count = SDMMC_CMDTIMEOUT * (SystemCoreClock / 8U / 1000U);
+    
+    do {
+        if (count-- == 0U) {
+            return SDMMC_ERROR_TIMEOUT;
+        }
+    } while (!__SDIO_GET_FLAG(sdio, SDIO_FLAG_CCRCFAIL | SDIO_FLAG_CMDREND | SDIO_FLAG_CTIMEOUT) ||
+             __SDIO_GET_FLAG(sdio, SDIO_FLAG_CMDACT));
+    
+    if (__SDIO_GET_FLAG(sdio, SDIO_FLAG_CTIMEOUT)) {
+        __SDIO_CLEAR_FLAG(sdio, SDIO_FLAG_CTIMEOUT);
+        return SDMMC_ERROR_CMD_RSP_TIMEOUT;
+    }
+    
+    if (__SDIO_GET_FLAG(sdio, SDIO_FLAG_CCRCFAIL)) {
+        __SDIO_CLEAR_FLAG(sdio, SDIO_FLAG_CCRCFAIL);
+        return SDMMC_ERROR_CMD_CRC_FAIL;
+    }
+    
+    __SDIO_CLEAR_FLAG(sdio, SDIO_STATIC_FLAGS);
+    
+    if (SDIO_GetResponse(sdio, SDIO_RESP1) & SDMMC_OCR_ERRORBITS) {
+        return SDMMC_ERROR_GENERAL_UNKNOWN_ERR;
+    }
+    
+    return SDMMC_ERROR_NONE;
+}
+
+/* 发送ACMD23(SET_WR_BLK_ERASE_COUNT)，告知卡下一次多块写入的块数 */
+static uint32_t sdio_send_acmd23(stm32_sdio_device_t *dev, uint32_t block_count)
+{
+    SDIO_CmdInitTypeDef cmd;
+    uint32_t errorstate;
+    
+    errorstate = SDMMC_CmdAppCommand(dev->hsd.Instance, (uint32_t)dev->hsd.SdCard.RelCardAdd << 16U);
+    if (errorstate != SDMMC_ERROR_NONE) {
+        return errorstate;
+    }
+    
+    cmd.Argument = block_count & 0x7FFFFFU;
+    cmd.CmdIndex = SDMMC_CMD_SD_APP_SET_WR_BLK_ERASE_COUNT;
+    cmd.Response = SDIO_RESPONSE_SHORT;
+    cmd.WaitForInterrupt = SDIO_WAIT_NO;
+    cmd.CPSM = SDIO_CPSM_ENABLE;
+    (void)SDIO_SendCommand(dev->hsd.Instance, &cmd);
+    
+    return sdio_wait_cmd_resp(dev->hsd.Instance);
+}
+
+/* 通过CMD13查询卡是否已回到传输状态 */
+static int sdio_card_ready(stm32_sdio_device_t *dev, bool *ready)
+{
+    uint32_t card_state;
+    
+    if (SDMMC_CmdSendStatus(dev->hsd.Instance, (uint32_t)dev->hsd.SdCard.RelCardAdd << 16U) != SDMMC_ERROR_NONE) {
+        return ERROR_IO;
+    }
+    
+    card_state = (SDIO_GetResponse(dev->hsd.Instance, SDIO_RESP1) >> 9U) & 0x0FU;
+    *ready = (card_state == HAL_SD_CARD_TRANSFER);
+    
+    return ERROR_NONE;
+}
+
+/* 在请求缓冲区与弹性缓冲区之间复制当前传输的数据 */
+static void sdio_bounce_copy(stm32_sdio_device_t *dev, bool to_bounce)
+{
+    uint8_t *bounce = (uint8_t *)dev->bounce;
+    uint32_t offset = dev->active_offset * SDIO_BLOCK_SIZE;
+    uint32_t remaining = dev->xfer_blocks * SDIO_BLOCK_SIZE;
+    
+    for (sdio_request_t *req = dev->active; req != NULL && remaining > 0U; req = req->next) {
+        uint32_t len = req->block_count * SDIO_BLOCK_SIZE - offset;
+        
+        if (len > remaining) {
+            len = remaining;
+        }
+        
+        if (to_bounce) {
+            memcpy(bounce, (const uint8_t *)req->data + offset, len);
+        } else {
+            memcpy((uint8_t *)req->data + offset, bounce, len);
+        }
+        
+        bounce += len;
+        remaining -= len;
+        offset = 0;
+    }
+}
+
+/* 计算分块传输中下一块的块数 */
+static uint32_t sdio_chunk_blocks(const stm32_sdio_device_t *dev, const sdio_request_t *req)
+{
+    uint32_t remaining = req->block_count - dev->active_offset;
+    uint32_t limit = dev->xfer_bounce ? CONFIG_SDIO_BOUNCE_BLOCKS : CONFIG_SDIO_MAX_TRANSFER_BLOCKS;
+    
+    return (remaining > limit) ? limit : remaining;
+}
+
+/**
+ * @brief 启动当前传输的DMA数据阶段
+ * 
+ * 读取先配置数据通道再发送CMD17/CMD18；写入先发送CMD24/CMD25再配置数据通道，
+ * 多块写入前发送ACMD23预擦除
+ * 
+ * @param dev SDIO设备
+ * @return int 0表示成功，非0表示失败
+ */
+static int sdio_xfer_launch(stm32_sdio_device_t *dev)
+{
+    SDIO_TypeDef *sdio = dev->hsd.Instance;
+    SDIO_DataInitTypeDef data_config;
+    dma_handle_t dma = dev->xfer_write ? dev->dma_tx : dev->dma_rx;
+    uint32_t block_addr = dev->active->block_addr + dev->active_offset;
+    uint32_t mem;
+    uint32_t errorstate;
+    
+    /* SDSC卡使用字节地址 */
+    if (dev->hsd.SdCard.CardType != CARD_SDHC_SDXC) {
+        block_addr *= SDIO_BLOCK_SIZE;
+    }
+    
+    if (dev->xfer_bounce) {
+        mem = (uint32_t)dev->bounce;
+        if (dev->xfer_write) {
+            sdio_bounce_copy(dev, true);
+        }
+    } else {
+        mem = (uint32_t)((uint8_t *)dev->active->data + dev->active_offset * SDIO_BLOCK_SIZE);
+    }
+    
+    sdio->DCTRL = 0U;
+    __HAL_SD_CLEAR_FLAG(&dev->hsd, SDIO_STATIC_FLAGS);
+    dev->xfer_pending = SDIO_EVENT_DATAEND | SDIO_EVENT_DMA;
+    dev->xfer_result = ERROR_NONE;
+    
+    /* 预擦除只是性能提示，卡不支持时照常写入 */
+    if (dev->xfer_write && dev->xfer_blocks > 1U) {
+        (void)sdio_send_acmd23(dev, dev->xfer_blocks);
+    }
+    
+    if (dev->xfer_write) {
+        dma_set_src_address(dma, mem);
+        dma_set_dst_address(dma, (uint32_t)&sdio->FIFO);
+    } else {
+        dma_set_src_address(dma, (uint32_t)&sdio->FIFO);
+        dma_set_dst_address(dma, mem);
+    }
+    dma_set_data_size(dma, dev->xfer_blocks * SDIO_BLOCK_SIZE / 4U);
+    dma_enable_interrupt(dma);
+    
+    if (dma_start(dma) != DRIVER_OK) {
+        return ERROR_HARDWARE;
+    }
+    
+    __HAL_SD_ENABLE_IT(&dev->hsd, SDIO_DATA_IT);
+    __HAL_SD_DMA_ENABLE(&dev->hsd);
+    
+    data_config.DataTimeOut = SDMMC_DATATIMEOUT;
+    data_config.DataLength = dev->xfer_blocks * SDIO_BLOCK_SIZE;
+    data_config.DataBlockSize = SDIO_DATABLOCK_SIZE_512B;
+    data_config.TransferMode = SDIO_TRANSFER_MODE_BLOCK;
+    data_config.DPSM = SDIO_DPSM_ENABLE;
+    
+    if (dev->xfer_write) {
+        errorstate = (dev->xfer_blocks > 1U) ? SDMMC_CmdWriteMultiBlock(sdio, block_addr)
+                                             : SDMMC_CmdWriteSingleBlock(sdio, block_addr);
+        if (errorstate == SDMMC_ERROR_NONE) {
+            data_config.TransferDir = SDIO_TRANSFER_DIR_TO_CARD;
+            (void)SDIO_ConfigData(sdio, &data_config);
+        }
+    } else {
+        data_config.TransferDir = SDIO_TRANSFER_DIR_TO_SDIO;
+        (void)SDIO_ConfigData(sdio, &data_config);
+        errorstate = (dev->xfer_blocks > 1U) ? SDMMC_CmdReadMultiBlock(sdio, block_addr)
+                                             : SDMMC_CmdReadSingleBlock(sdio, block_addr);
+    }
+    
+    if (errorstate != SDMMC_ERROR_NONE) {
+        __HAL_SD_DISABLE_IT(&dev->hsd, SDIO_DATA_IT);
+        __HAL_SD_DMA_DISABLE(&dev->hsd);
+        sdio->DCTRL = 0U;
+        dma_stop(dma);
+        __HAL_SD_CLEAR_FLAG(&dev->hsd, SDIO_STATIC_FLAGS);
+        return ERROR_IO;
+    }
+    
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 结束当前传输的数据阶段
+ * 
+ * 多块传输以及出错的传输发送CMD12停止
+ * 
+ * @param dev SDIO设备
+ * @param result 数据阶段结果
+ * @return int 结束后的结果
+ */
+static int sdio_xfer_stop(stm32_sdio_device_t *dev, int result)
+{
+    __HAL_SD_DISABLE_IT(&dev->hsd, SDIO_DATA_IT);
+    __HAL_SD_DMA_DISABLE(&dev->hsd);
+    
+    if (result != ERROR_NONE) {
+        dev->hsd.Instance->DCTRL = 0U;
+        dma_stop(dev->xfer_write ? dev->dma_tx : dev->dma_rx);
+    }
+    
+    if (dev->xfer_blocks > 1U || result != ERROR_NONE) {
+        if (SDMMC_CmdStopTransfer(dev->hsd.Instance) != SDMMC_ERROR_NONE && result == ERROR_NONE) {
+            result = ERROR_IO;
+        }
+    }
+    
+    __HAL_SD_CLEAR_FLAG(&dev->hsd, SDIO_STATIC_FLAGS);
+    
+    return result;
+}
+
+/* 启动卡编程状态查询定时器 */
+static void sdio_busy_timer_start(stm32_sdio_device_t *dev)
+{
+#if defined(CONFIG_TIMER_WHEEL_ENABLED) && CONFIG_TIMER_WHEEL_ENABLED
+    timer_wheel_start(&dev->busy_timer, CONFIG_SDIO_BUSY_POLL_MS, CONFIG_SDIO_BUSY_POLL_MS);
+#else
+    (void)dev;
+#endif
+}
+
+/* 停止卡编程状态查询定时器 */
+static void sdio_busy_timer_stop(stm32_sdio_device_t *dev)
+{
+#if defined(CONFIG_TIMER_WHEEL_ENABLED) && CONFIG_TIMER_WHEEL_ENABLED
+    timer_wheel_stop(&dev->busy_timer);
+#else
+    (void)dev;
+#endif
+}
+
+/**
+ * @brief 通知请求链中的所有请求完成
+ * 
+ * @param dev SDIO设备
+ * @param run 请求链
+ * @param result 执行结果
+ */
+static void sdio_run_notify(stm32_sdio_device_t *dev, sdio_request_t *run, int result)
+{
+    while (run != NULL) {
+        sdio_request_t *next = run->next;
+        
+        run->next = NULL;
+        run->result = result;
+        
+        if (run->callback != NULL) {
+            run->callback(run, result, run->user_data);
+        }
+        
+        /* 回调返回后才标记完成，阻塞等待者随后即可复用请求对象 */
+        run->state = SDIO_REQUEST_DONE;
+        run = next;
+    }
+    
+    dev->status = (result == ERROR_NONE) ? SDIO_STATUS_COMPLETE : SDIO_STATUS_ERROR;
+    if (dev->callback) {
+        dev->callback(dev->arg, dev->status);
+    }
+    
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_sem_give(dev->done_sem);
+#endif
+}
+
+/**
+ * @brief 从队列头部取出可合并的请求组成一次传输，调用者持有中断锁
+ * 
+ * 相邻、方向相同且块地址连续的请求合并。缓冲区在内存中首尾相接时由DMA
+ * 直接访问，否则在弹性缓冲区容量内经弹性缓冲区合并。超过单次传输上限
+ * 的请求单独分块传输
+ * 
+ * @param dev SDIO设备
+ */
+static void sdio_run_build(stm32_sdio_device_t *dev)
+{
+    sdio_request_t *first = dev->queue_head;
+    sdio_request_t *last = first;
+    sdio_request_t *next;
+    bool bounce = !sdio_dma_capable(first->data, first->block_count);
+    uint32_t limit = bounce ? CONFIG_SDIO_BOUNCE_BLOCKS : CONFIG_SDIO_MAX_TRANSFER_BLOCKS;
+    uint32_t blocks = first->block_count;
+    
+    if (blocks > limit) {
+        blocks = limit;
+    } else {
+        while ((next = last->next) != NULL && next->write == first->write &&
+               next->block_addr == last->block_addr + last->block_count &&
+               blocks + next->block_count <= CONFIG_SDIO_MAX_TRANSFER_BLOCKS) {
+            bool contiguous = !bounce &&
+                              (uint8_t *)next->data == (uint8_t *)last->data + last->block_count * SDIO_BLOCK_SIZE &&
+                              sdio_dma_capable(next->data, next->block_count);
+            
+            if (!contiguous) {
+                if (blocks + next->block_count > CONFIG_SDIO_BOUNCE_BLOCKS) {
+                    break;
+                }
+                bounce = true;
+            }
+            
+            blocks += next->block_count;
+            last = next;
+        }
+    }
+    
+    dev->queue_head = last->next;
+    if (dev->queue_head == NULL) {
+        dev->queue_tail = NULL;
+    }
+    last->next = NULL;
+    
+    for (sdio_request_t *req = first; req != NULL; req = req->next) {
+        req->state = SDIO_REQUEST_ACTIVE;
+    }
+    
+    dev->active = first;
+    dev->active_offset = 0;
+    dev->xfer_blocks = blocks;
+    dev->xfer_write = first->write;
+    dev->xfer_bounce = bounce;
+    dev->status = SDIO_STATUS_BUSY;
+}
+
+static void sdio_start_next(stm32_sdio_device_t *dev);
+
+/**
+ * @brief 当前传输结束后完成请求链，分块传输的请求继续下一块
+ * 
+ * @param dev SDIO设备
+ * @param result 传输结果
+ */
+static void sdio_run_complete(stm32_sdio_device_t *dev, int result)
+{
+    sdio_request_t *run;
+    uint32_t primask;
+    
+    if (result == ERROR_NONE && dev->xfer_bounce && !dev->xfer_write && dev->active != NULL) {
+        sdio_bounce_copy(dev, false);
+    }
+    
+    primask = sdio_irq_lock();
+    run = dev->active;
+    
+    /* 已被取消的传输由取消者完成 */
+    if (run == NULL) {
+        sdio_irq_unlock(primask);
+        return;
+    }
+    
+    if (result == ERROR_NONE && dev->active_offset + dev->xfer_blocks < run->block_count) {
+        dev->active_offset += dev->xfer_blocks;
+        dev->xfer_blocks = sdio_chunk_blocks(dev, run);
+        dev->phase = SDIO_XFER_DATA;
+        sdio_irq_unlock(primask);
+        
+        result = sdio_xfer_launch(dev);
+        if (result == ERROR_NONE) {
+            return;
+        }
+        
+        primask = sdio_irq_lock();
+        dev->phase = SDIO_XFER_IDLE;
+        run = dev->active;
+    }
+    
+    dev->active = NULL;
+    sdio_irq_unlock(primask);
+    
+    sdio_run_notify(dev, run, result);
+    sdio_start_next(dev);
+}
+
+/**
+ * @brief 总线空闲时从队列取出下一组请求并启动传输
+ */
+static void sdio_start_next(stm32_sdio_device_t *dev)
+{
+    uint32_t primask = sdio_irq_lock();
+    int result;
+    
+    if (dev->active != NULL || dev->phase != SDIO_XFER_IDLE || dev->queue_head == NULL) {
+        sdio_irq_unlock(primask);
+        return;
+    }
+    
+    sdio_run_build(dev);
+    dev->phase = SDIO_XFER_DATA;
+    sdio_irq_unlock(primask);
+    
+    result = sdio_xfer_launch(dev);
+    if (result != ERROR_NONE) {
+        primask = sdio_irq_lock();
+        dev->phase = SDIO_XFER_IDLE;
+        sdio_irq_unlock(primask);
+        sdio_run_complete(dev, result);
+    }
+}
+
+/**
+ * @brief 数据阶段事件，数据结束和DMA完成都到达或出错时结束数据阶段
+ * 
+ * @param dev SDIO设备
+ * @param events 到达的事件
+ * @param result 事件结果
+ */
+static void sdio_xfer_event(stm32_sdio_device_t *dev, uint32_t events, int result)
+{
+    uint32_t primask = sdio_irq_lock();
+    bool done;
+    
+    if (dev->phase != SDIO_XFER_DATA) {
+        sdio_irq_unlock(primask);
+        return;
+    }
+    
+    if (result != ERROR_NONE) {
+        dev->xfer_result = result;
+        dev->xfer_pending = 0U;
+    } else {
+        dev->xfer_pending &= ~events;
+    }
+    
+    done = (dev->xfer_pending == 0U);
+    if (done) {
+        dev->phase = dev->xfer_write ? SDIO_XFER_PROGRAMMING : SDIO_XFER_IDLE;
+        dev->busy_start = HAL_GetTick();
+    }
+    sdio_irq_unlock(primask);
+    
+    if (!done) {
+        return;
+    }
+    
+    result = sdio_xfer_stop(dev, dev->xfer_result);
+    
+    /* 写入数据后卡进入编程状态，完成通知推迟到卡回到传输状态 */
+    if (dev->xfer_write) {
+        dev->xfer_result = result;
+        sdio_busy_timer_start(dev);
+        return;
+    }
+    
+    sdio_run_complete(dev, result);
+}
+
+/**
+ * @brief 查询卡编程状态，编程完成后结束写请求并启动下一组请求
+ */
+static void sdio_busy_poll(stm32_sdio_device_t *dev)
+{
+    sdio_request_t *run;
+    uint32_t primask;
+    bool ready = false;
+    int result;
+    
+    primask = sdio_irq_lock();
+    if (dev->phase != SDIO_XFER_PROGRAMMING || dev->cmd_claimed) {
+        sdio_irq_unlock(primask);
+        return;
+    }
+    dev->cmd_claimed = true;
+    sdio_irq_unlock(primask);
+    
+    result = sdio_card_ready(dev, &ready);
+    if (result == ERROR_NONE && !ready) {
+        if (HAL_GetTick() - dev->busy_start < SDIO_TIMEOUT) {
+            dev->cmd_claimed = false;
+            return;
+        }
+        result = ERROR_TIMEOUT;
+    }
+    
+    sdio_busy_timer_stop(dev);
+    
+    primask = sdio_irq_lock();
+    dev->cmd_claimed = false;
+    dev->phase = SDIO_XFER_IDLE;
+    run = dev->active;
+    sdio_irq_unlock(primask);
+    
+    if (run != NULL) {
+        sdio_run_complete(dev, dev->xfer_result != ERROR_NONE ? dev->xfer_result : result);
+    } else {
+        sdio_start_next(dev);
+    }
+}
+
+#if defined(CONFIG_TIMER_WHEEL_ENABLED) && CONFIG_TIMER_WHEEL_ENABLED
+/* 卡编程状态查询定时器回调 */
+static void sdio_busy_timer_callback(timer_wheel_timer_t *timer, void *arg)
+{
+    (void)timer;
+    sdio_busy_poll((stm32_sdio_device_t *)arg);
+}
+#endif
+
+/**
+ * @brief 取消请求
+ * 
+ * 排队中的请求直接摘除；执行中的请求与其所在的合并传输一起中止并按失败结束
+ * 
+ * @param dev SDIO设备
+ * @param request 请求
+ * @param result 写入请求的结果
+ */
+static void sdio_request_cancel(stm32_sdio_device_t *dev, sdio_request_t *request, int result)
+{
+    sdio_xfer_phase_t phase;
+    sdio_request_t *run;
+    uint32_t primask = sdio_irq_lock();
+    
+    if (request->state == SDIO_REQUEST_QUEUED) {
+        sdio_request_t **link = &dev->queue_head;
+        sdio_request_t *prev = NULL;
+        
+        while (*link != NULL && *link != request) {
+            prev = *link;
+            link = &(*link)->next;
+        }
+        
+        if (*link == request) {
+            *link = request->next;
+            if (dev->queue_tail == request) {
+                dev->queue_tail = prev;
+            }
+        }
+        
+        request->next = NULL;
+        request->result = result;
+        request->state = SDIO_REQUEST_DONE;
+        sdio_irq_unlock(primask);
+        return;
+    }
+    
+    if (request->state != SDIO_REQUEST_ACTIVE || dev->active == NULL) {
+        sdio_irq_unlock(primask);
+        return;
+    }
+    
+    run = dev->active;
+    phase = dev->phase;
+    dev->active = NULL;
+    
+    /* 中止数据阶段，写入被中止时卡仍可能在编程，需等待其回到传输状态 */
+    if (phase == SDIO_XFER_DATA) {
+        dev->phase = dev->xfer_write ? SDIO_XFER_PROGRAMMING : SDIO_XFER_IDLE;
+        dev->busy_start = HAL_GetTick();
+        dev->cmd_claimed = true;
+    }
+    sdio_irq_unlock(primask);
+    
+    if (phase == SDIO_XFER_DATA) {
+        (void)sdio_xfer_stop(dev, result);
+        dev->cmd_claimed = false;
+        if (dev->xfer_write) {
+            sdio_busy_timer_start(dev);
+        }
+    }
+    
+    sdio_run_notify(dev, run, result);
+    sdio_start_next(dev);
+}
+
+/* SDIO DMA回调，接收和发送数据流共用 */
+static void sdio_dma_callback(void *arg, dma_status_t status)
+{
+    stm32_sdio_device_t *dev = (stm32_sdio_device_t *)arg;
+    
+    if (status == DMA_STATUS_COMPLETE) {
+        sdio_xfer_event(dev, SDIO_EVENT_DMA, ERROR_NONE);
+    } else if (status == DMA_STATUS_ERROR) {
+        sdio_xfer_event(dev, SDIO_EVENT_DATAEND | SDIO_EVENT_DMA, ERROR_HARDWARE);
+    }
+}
+
+/**
+ * @brief 分配并配置SDIO收发DMA数据流
+ * 
+ * @param dev SDIO设备
+ * @return int 0表示成功，非0表示失败
+ */
+static int sdio_dma_setup(stm32_sdio_device_t *dev)
+{
+    dma_config_t dma_config;
+    
+    /* SDIO作为流控制器，传输长度由数据长度寄存器决定 */
+    memset(&dma_config, 0, sizeof(dma_config));
+    dma_config.mode = DMA_MODE_PERIPH_FLOW;
+    dma_config.priority = DMA_PRIORITY_VERY_HIGH;
+    dma_config.src_width = DMA_DATA_WIDTH_32BIT;
+    dma_config.dst_width = DMA_DATA_WIDTH_32BIT;
+    dma_config.src_inc = false;   /* 外设FIFO地址固定 */
+    dma_config.dst_inc = true;    /* 内存地址自增 */
+    
+    dma_config.direction = DMA_DIR_PERIPH_TO_MEM;
+    if (dma_alloc(1U << SDIO_DMA_RX_STREAM, DMA_REQUEST_ID(DMA_REQUEST_SDIO_RX, 0), &dma_config,
+                  sdio_dma_callback, dev, &dev->dma_rx) != DRIVER_OK) {
+        return ERROR_BUSY;
+    }
+    
+    dma_config.direction = DMA_DIR_MEM_TO_PERIPH;
+    if (dma_alloc(1U << SDIO_DMA_TX_STREAM, DMA_REQUEST_ID(DMA_REQUEST_SDIO_TX, 0), &dma_config,
+                  sdio_dma_callback, dev, &dev->dma_tx) != DRIVER_OK) {
+        dma_deinit(dev->dma_rx);
+        return ERROR_BUSY;
+    }
+    
+    dma_set_request_line(dev->dma_rx, DMA_CHANNEL_4);
+    dma_set_request_line(dev->dma_tx, DMA_CHANNEL_4);
+    
+    /* SDIO FIFO按4字突发请求，数据流需启用FIFO并使用相同的突发长度 */
+    dma_set_fifo_burst(dev->dma_rx, true);
+    dma_set_fifo_burst(dev->dma_tx, true);
+    
+    dma_enable_irq(dev->dma_rx, CONFIG_SDIO_IRQ_PRIORITY);
+    dma_enable_irq(dev->dma_tx, CONFIG_SDIO_IRQ_PRIORITY);
+    HAL_NVIC_SetPriority(SDIO_IRQn, CONFIG_SDIO_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(SDIO_IRQn);
+    
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 释放SDIO的DMA数据流
+ */
+static void sdio_dma_release(stm32_sdio_device_t *dev)
+{
+    HAL_NVIC_DisableIRQ(SDIO_IRQn);
+    dma_deinit(dev->dma_rx);
+    dma_deinit(dev->dma_tx);
+}
+
 /**
  * @brief 初始化SDIO设备
  * 
@@ -107,7 +865,7 @@ int sdio_init(const sdio_config_t *config, sdio_callback_t callback, void *arg,
     
     /* 检查是否已初始?*/
     if (dev->initialized) {
-        return ERROR_ALREADY_INITIALIZED;
+        return ERROR_ALREADY_EXISTS;
     }
     
     /* 初始化SDIO设备 */
@@ -136,20 +894,45 @@ int sdio_init(const sdio_config_t *config, sdio_callback_t callback, void *arg,
     
     /* 初始化HAL SD */
     if (HAL_SD_Init(hsd) != HAL_OK) {
-        return ERROR_DRIVER_INIT_FAILED;
+        return ERROR_HARDWARE;
     }
     
     /* 设置总线宽度 */
     if (config->enable_4bit) {
         if (HAL_SD_ConfigWideBusOperation(hsd, SDIO_BUS_WIDE_4B) != HAL_OK) {
             HAL_SD_DeInit(hsd);
-            return ERROR_DRIVER_INIT_FAILED;
+            return ERROR_HARDWARE;
         }
     }
     
     /* 更新卡信?*/
     update_card_info(dev);
     
+    /* 分配收发DMA数据流 */
+    if (sdio_dma_setup(dev) != ERROR_NONE) {
+        HAL_SD_DeInit(hsd);
+        return ERROR_BUSY;
+    }
+    
+#if (CURRENT_RTOS != RTOS_NONE)
+    if (rtos_sem_create(&dev->done_sem, 0, 1) != 0) {
+        sdio_dma_release(dev);
+        HAL_SD_DeInit(hsd);
+        return ERROR_MEMORY;
+    }
+    
+    if (rtos_mutex_create(&dev->sync_mutex) != 0) {
+        rtos_sem_delete(dev->done_sem);
+        sdio_dma_release(dev);
+        HAL_SD_DeInit(hsd);
+        return ERROR_MEMORY;
+    }
+#endif
+    
+#if defined(CONFIG_TIMER_WHEEL_ENABLED) && CONFIG_TIMER_WHEEL_ENABLED
+    timer_wheel_timer_init(&dev->busy_timer, sdio_busy_timer_callback, dev);
+#endif
+    
     /* 设置初始化标?*/
     dev->initialized = true;
     
@@ -174,12 +957,40 @@ int sdio_deinit(sdio_handle_t handle)
         return ERROR_INVALID_PARAM;
     }
     
+    /* 先摘下队列再中止正在执行的传输，取消后不会再衔接排队中的请求 */
+    uint32_t primask = sdio_irq_lock();
+    sdio_request_t *pending = dev->queue_head;
+    dev->queue_head = NULL;
+    dev->queue_tail = NULL;
+    sdio_irq_unlock(primask);
+    
+    if (dev->active != NULL) {
+        sdio_request_cancel(dev, dev->active, ERROR_NOT_INITIALIZED);
+    }
+    
+    sdio_busy_timer_stop(dev);
+    dev->phase = SDIO_XFER_IDLE;
+    sdio_dma_release(dev);
+    
+    /* 排队中的请求以失败结束，完成回调照常调用，并唤醒阻塞等待者 */
+    if (pending != NULL) {
+        sdio_run_notify(dev, pending, ERROR_NOT_INITIALIZED);
+    }
+    
+#if (CURRENT_RTOS != RTOS_NONE)
+    /* 阻塞等待者看到请求完成后释放互斥锁，之后才能删除同步对象 */
+    rtos_mutex_lock(dev->sync_mutex, UINT32_MAX);
+    rtos_mutex_unlock(dev->sync_mutex);
+    rtos_mutex_delete(dev->sync_mutex);
+    rtos_sem_delete(dev->done_sem);
+#endif
+    
     /* 去初始化HAL SD */
     if (HAL_SD_DeInit(&dev->hsd) != HAL_OK) {
-        return ERROR_DRIVER_DEINIT_FAILED;
+        return ERROR_IO;
     }
     
-    /* 清除初始化标?*/
+    /* 清除初始化标志 */
     dev->initialized = false;
     
     return DRIVER_OK;
@@ -243,47 +1054,15 @@ int sdio_get_card_info(sdio_handle_t handle, sdio_card_info_t *card_info)
  */
 int sdio_read_blocks(sdio_handle_t handle, uint32_t block_addr, void *data, uint32_t block_count)
 {
-    stm32_sdio_device_t *dev = (stm32_sdio_device_t *)handle;
-    HAL_StatusTypeDef hal_status;
-    
-    /* 参数检?*/
-    if (dev == NULL || !dev->initialized || data == NULL || block_count == 0) {
-        return ERROR_INVALID_PARAM;
-    }
-    
-    /* 更新状?*/
-    dev->status = SDIO_STATUS_BUSY;
-    
-    /* 读取数据 */
-    hal_status = HAL_SD_ReadBlocks(&dev->hsd, data, block_addr, block_count, SDIO_TIMEOUT);
-    
-    if (hal_status != HAL_OK) {
-        /* 更新状?*/
-        dev->status = SDIO_STATUS_ERROR;
-        
-        /* 调用回调函数 */
-        if (dev->callback) {
-            dev->callback(dev->arg, SDIO_STATUS_ERROR);
-        }
-        
-        return ERROR_DRIVER_READ_FAILED;
-    }
+    sdio_request_t request;
     
-    /* 等待传输完成 */
-    hal_status = HAL_SD_GetCardState(&dev->hsd);
-    while (hal_status == HAL_SD_CARD_TRANSFER) {
-        hal_status = HAL_SD_GetCardState(&dev->hsd);
-    }
-    
-    /* 更新状?*/
-    dev->status = SDIO_STATUS_COMPLETE;
-    
-    /* 调用回调函数 */
-    if (dev->callback) {
-        dev->callback(dev->arg, SDIO_STATUS_COMPLETE);
-    }
+    memset(&request, 0, sizeof(request));
+    request.write = false;
+    request.block_addr = block_addr;
+    request.block_count = block_count;
+    request.data = data;
     
-    return DRIVER_OK;
+    return sdio_request_execute(handle, &request, SDIO_TIMEOUT);
 }
 
 /**
@@ -297,47 +1076,15 @@ int sdio_read_blocks(sdio_handle_t handle, uint32_t block_addr, void *data, uint
  */
 int sdio_write_blocks(sdio_handle_t handle, uint32_t block_addr, const void *data, uint32_t block_count)
 {
-    stm32_sdio_device_t *dev = (stm32_sdio_device_t *)handle;
-    HAL_StatusTypeDef hal_status;
-    
-    /* 参数检?*/
-    if (dev == NULL || !dev->initialized || data == NULL || block_count == 0) {
-        return ERROR_INVALID_PARAM;
-    }
-    
-    /* 更新状?*/
-    dev->status = SDIO_STATUS_BUSY;
-    
-    /* 写入数据 */
-    hal_status = HAL_SD_WriteBlocks(&dev->hsd, (uint8_t *)data, block_addr, block_count, SDIO_TIMEOUT);
-    
-    if (hal_status != HAL_OK) {
-        /* 更新状?*/
-        dev->status = SDIO_STATUS_ERROR;
-        
-        /* 调用回调函数 */
-        if (dev->callback) {
-            dev->callback(dev->arg, SDIO_STATUS_ERROR);
-        }
-        
-        return ERROR_DRIVER_WRITE_FAILED;
-    }
-    
-    /* 等待传输完成 */
-    hal_status = HAL_SD_GetCardState(&dev->hsd);
-    while (hal_status == HAL_SD_CARD_TRANSFER) {
-        hal_status = HAL_SD_GetCardState(&dev->hsd);
-    }
-    
-    /* 更新状?*/
-    dev->status = SDIO_STATUS_COMPLETE;
+    sdio_request_t request;
     
-    /* 调用回调函数 */
-    if (dev->callback) {
-        dev->callback(dev->arg, SDIO_STATUS_COMPLETE);
-    }
+    memset(&request, 0, sizeof(request));
+    request.write = true;
+    request.block_addr = block_addr;
+    request.block_count = block_count;
+    request.data = (void *)data;
     
-    return DRIVER_OK;
+    return sdio_request_execute(handle, &request, SDIO_TIMEOUT);
 }
 
 /**
@@ -358,6 +1105,11 @@ int sdio_erase_blocks(sdio_handle_t handle, uint32_t start_block, uint32_t end_b
         return ERROR_INVALID_PARAM;
     }
     
+    /* 擦除由HAL轮询完成，不能与队列中的传输交错 */
+    if (dev->active != NULL || dev->phase != SDIO_XFER_IDLE || dev->queue_head != NULL) {
+        return ERROR_BUSY;
+    }
+    
     /* 更新状?*/
     dev->status = SDIO_STATUS_BUSY;
     
@@ -373,7 +1125,7 @@ int sdio_erase_blocks(sdio_handle_t handle, uint32_t start_block, uint32_t end_b
             dev->callback(dev->arg, SDIO_STATUS_ERROR);
         }
         
-        return ERROR_DRIVER_ERASE_FAILED;
+        return ERROR_IO;
     }
     
     /* 更新状?*/
@@ -430,7 +1182,7 @@ int sdio_set_bus_width(sdio_handle_t handle, sdio_bus_width_t bus_width)
     hal_status = HAL_SD_ConfigWideBusOperation(&dev->hsd, convert_bus_width(bus_width));
     
     if (hal_status != HAL_OK) {
-        return ERROR_DRIVER_OPERATION_FAILED;
+        return ERROR_IO;
     }
     
     /* 更新配置 */
@@ -539,3 +1291,152 @@ int sdio_execute_command(sdio_handle_t handle, uint8_t cmd, uint32_t arg, uint32
     return ERROR_NOT_SUPPORTED;
 }
 
+/**
+ * @brief 提交SDIO块请求(非阻塞)
+ * 
+ * @param handle SDIO设备句柄
+ * @param request 块请求
+ * @return int 0表示成功，非0表示失败
+ */
+int sdio_request_submit(sdio_handle_t handle, sdio_request_t *request)
+{
+    stm32_sdio_device_t *dev = (stm32_sdio_device_t *)handle;
+    uint32_t primask;
+    
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || request == NULL || request->data == NULL ||
+        request->block_count == 0 || request->block_addr >= dev->card_info.block_count ||
+        request->block_count > dev->card_info.block_count - request->block_addr) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    if (request->state == SDIO_REQUEST_QUEUED || request->state == SDIO_REQUEST_ACTIVE) {
+        return ERROR_BUSY;
+    }
+    
+    request->next = NULL;
+    request->result = ERROR_NONE;
+    request->state = SDIO_REQUEST_QUEUED;
+    
+    /* 追加到队列尾部 */
+    primask = sdio_irq_lock();
+    if (dev->queue_tail != NULL) {
+        dev->queue_tail->next = request;
+    } else {
+        dev->queue_head = request;
+    }
+    dev->queue_tail = request;
+    sdio_irq_unlock(primask);
+    
+    /* 总线空闲时立即启动 */
+    sdio_start_next(dev);
+    
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 执行SDIO块请求(阻塞)
+ * 
+ * @param handle SDIO设备句柄
+ * @param request 块请求
+ * @param timeout_ms 超时时间（毫秒）
+ * @return int 0表示成功，非0表示失败
+ */
+int sdio_request_execute(sdio_handle_t handle, sdio_request_t *request, uint32_t timeout_ms)
+{
+    stm32_sdio_device_t *dev = (stm32_sdio_device_t *)handle;
+    int ret;
+    
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+#if (CURRENT_RTOS != RTOS_NONE)
+    /* 阻塞等待者串行化，保证完成通知只有一个接收者 */
+    rtos_mutex_lock(dev->sync_mutex, UINT32_MAX);
+#endif
+    
+    ret = sdio_request_submit(handle, request);
+    
+    if (ret == ERROR_NONE) {
+        uint32_t start_time = HAL_GetTick();
+        
+        while (request->state != SDIO_REQUEST_DONE) {
+            uint32_t elapsed = HAL_GetTick() - start_time;
+            
+            if (timeout_ms != UINT32_MAX && elapsed >= timeout_ms) {
+                sdio_request_cancel(dev, request, ERROR_TIMEOUT);
+                break;
+            }
+            
+            /* 卡处于编程状态时由等待者查询，不依赖时间轮 */
+            if (dev->phase == SDIO_XFER_PROGRAMMING) {
+                sdio_busy_poll(dev);
+                if (request->state == SDIO_REQUEST_DONE) {
+                    break;
+                }
+            }
+            
+#if (CURRENT_RTOS != RTOS_NONE)
+            if (dev->phase == SDIO_XFER_PROGRAMMING) {
+                rtos_sem_take(dev->done_sem, CONFIG_SDIO_BUSY_POLL_MS);
+            } else {
+                rtos_sem_take(dev->done_sem, timeout_ms == UINT32_MAX ? UINT32_MAX : timeout_ms - elapsed);
+            }
+#else
+            __WFI();
+#endif
+        }
+        
+        ret = request->result;
+    }
+    
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_mutex_unlock(dev->sync_mutex);
+#endif
+    
+    return ret;
+}
+
+/**
+ * @brief 推进SDIO请求队列
+ * 
+ * @param handle SDIO设备句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int sdio_poll(sdio_handle_t handle)
+{
+    stm32_sdio_device_t *dev = (stm32_sdio_device_t *)handle;
+    
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    sdio_busy_poll(dev);
+    
+    return DRIVER_OK;
+}
+
+/**
+ * @brief SDIO中断处理函数，处理数据阶段的结束与错误
+ */
+void SDIO_IRQHandler(void)
+{
+    stm32_sdio_device_t *dev = &g_sdio_device;
+    
+    if (!dev->initialized) {
+        return;
+    }
+    
+    if (__HAL_SD_GET_FLAG(&dev->hsd, SDIO_DATA_ERROR_FLAGS)) {
+        __HAL_SD_CLEAR_FLAG(&dev->hsd, SDIO_DATA_ERROR_FLAGS);
+        __HAL_SD_DISABLE_IT(&dev->hsd, SDIO_DATA_IT);
+        sdio_xfer_event(dev, SDIO_EVENT_DATAEND | SDIO_EVENT_DMA, ERROR_IO);
+        return;
+    }
+    
+    if (__HAL_SD_GET_FLAG(&dev->hsd, SDIO_FLAG_DATAEND)) {
+        __HAL_SD_CLEAR_FLAG(&dev->hsd, SDIO_FLAG_DATAEND);
+        sdio_xfer_event(dev, SDIO_EVENT_DATAEND, ERROR_NONE);
+    }
+}
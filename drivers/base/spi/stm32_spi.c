@@ -6,9 +6,16 @@
  */
 
 #include "base/spi_api.h"
+#include "base/dma_api.h"
 #include "base/platform_api.h"
 #include "common/error_api.h"
 #include "stm32_platform.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if (CURRENT_RTOS != RTOS_NONE)
+#include "common/rtos_api.h"
+#endif
 
 #if (STM32_CURRENT_SERIES == STM32_SERIES_F4)
 #include "stm32f4xx_hal.h"
@@ -22,6 +29,33 @@ static SPI_HandleTypeDef spi_handles[SPI_CHANNEL_MAX];
 /* SPI资源使用标志 */
 static bool spi_used[SPI_CHANNEL_MAX] = {false};
 
+/* SPI DMA中断优先级 */
+#ifndef CONFIG_SPI_DMA_IRQ_PRIORITY
+#define CONFIG_SPI_DMA_IRQ_PRIORITY     5
+#endif
+
+/* 单个分段最大长度（DMA计数寄存器为16位） */
+#define SPI_DMA_MAX_SEGMENT_LEN         65535U
+
+/* SPI DMA数据流映射 */
+typedef struct {
+    uint32_t tx_stream;               /* 发送数据流，0-7为DMA1 Stream0-7，8-15为DMA2 Stream0-7 */
+    uint32_t rx_stream;               /* 接收数据流 */
+    uint32_t request;                 /* DMA请求通道 */
+    IRQn_Type tx_irq;                 /* 发送数据流中断号 */
+    IRQn_Type rx_irq;                 /* 接收数据流中断号 */
+} stm32_spi_dma_map_t;
+
+/* 参考STM32F4 DMA请求映射表 */
+static const stm32_spi_dma_map_t spi_dma_map[SPI_CHANNEL_MAX] = {
+    [SPI_CHANNEL_0] = { 11, 8, DMA_CHANNEL_3, DMA2_Stream3_IRQn, DMA2_Stream0_IRQn },  /* SPI1 */
+    [SPI_CHANNEL_1] = { 4,  3, DMA_CHANNEL_0, DMA1_Stream4_IRQn, DMA1_Stream3_IRQn },  /* SPI2 */
+    [SPI_CHANNEL_2] = { 5,  0, DMA_CHANNEL_0, DMA1_Stream5_IRQn, DMA1_Stream0_IRQn }   /* SPI3 */
+};
+
+/* 只读分段的发送填充数据 */
+static const uint16_t spi_tx_fill = 0xFFFF;
+
 /* SPI内部结构?*/
 typedef struct {
     SPI_HandleTypeDef *hspi;          /* HAL SPI句柄 */
@@ -29,6 +63,22 @@ typedef struct {
     bool initialized;                  /* 初始化标?*/
     spi_event_callback_t callback;    /* 事件回调函数 */
     void *user_data;                  /* 用户数据 */
+    dma_handle_t dma_tx;              /* 发送DMA句柄 */
+    dma_handle_t dma_rx;              /* 接收DMA句柄 */
+    uint32_t bus_cr1;                 /* 初始化时的CR1配置 */
+    bool data_16bit;                  /* 16位数据帧 */
+    spi_transaction_t *queue_head;    /* 事务队列头 */
+    spi_transaction_t *queue_tail;    /* 事务队列尾 */
+    spi_transaction_t *active;        /* 正在执行的事务 */
+    volatile bool active_claimed;     /* 执行中的事务已被完成或取消路径占用 */
+    uint32_t segment_index;           /* 当前分段序号 */
+    uint16_t rx_discard;              /* 丢弃的接收数据落点 */
+    spi_transaction_t async_transaction; /* spi_transfer_async使用的内部事务 */
+    spi_segment_t async_segment;      /* 内部事务的分段 */
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_sem_t done_sem;              /* 事务完成通知 */
+    rtos_mutex_t sync_mutex;          /* 串行化阻塞等待者 */
+#endif
 } stm32_spi_t;
 
 /**
@@ -73,6 +123,435 @@ static uint32_t get_spi_prescaler(spi_speed_t speed)
     }
 }
 
+/**
+ * @brief 关闭中断并返回之前的中断状态
+ */
+static inline uint32_t spi_irq_lock(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+/**
+ * @brief 恢复中断状态
+ */
+static inline void spi_irq_unlock(uint32_t primask)
+{
+    __set_PRIMASK(primask);
+}
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+/* D-Cache行大小，F7为32字节 */
+#define SPI_DCACHE_LINE_SIZE            32U
+
+/**
+ * @brief 将缓冲区所在的D-Cache行写回内存，DMA发送前调用
+ */
+static void spi_dcache_clean(const void *data, uint32_t len)
+{
+    uint32_t addr = (uint32_t)data & ~(SPI_DCACHE_LINE_SIZE - 1U);
+    
+    SCB_CleanDCache_by_Addr((uint32_t *)addr, (int32_t)((uint32_t)data + len - addr));
+}
+
+/**
+ * @brief 写回并作废缓冲区所在的D-Cache行，DMA接收前调用
+ *
+ * 接收期间缓存中不会留下脏行，避免被逐出时覆盖DMA写入的数据
+ */
+static void spi_dcache_clean_invalidate(void *data, uint32_t len)
+{
+    uint32_t addr = (uint32_t)data & ~(SPI_DCACHE_LINE_SIZE - 1U);
+    
+    SCB_CleanInvalidateDCache_by_Addr((uint32_t *)addr, (int32_t)((uint32_t)data + len - addr));
+}
+
+/**
+ * @brief 作废接收缓冲区所在的D-Cache行，DMA接收完成后调用
+ *
+ * 按缓存行作废，接收缓冲区应按32字节对齐且长度为32的整数倍，
+ * 否则与其共享缓存行的数据在传输期间的修改会丢失
+ */
+static void spi_dcache_invalidate(void *data, uint32_t len)
+{
+    uint32_t addr = (uint32_t)data & ~(SPI_DCACHE_LINE_SIZE - 1U);
+    
+    SCB_InvalidateDCache_by_Addr((uint32_t *)addr, (int32_t)((uint32_t)data + len - addr));
+}
+#endif
+
+/**
+ * @brief 根据目标时钟频率计算CR1波特率位
+ * 
+ * @param channel SPI通道
+ * @param clock_hz 目标时钟频率
+ * @return uint32_t CR1中BR字段的值
+ */
+static uint32_t get_spi_prescaler_for_clock(spi_channel_t channel, uint32_t clock_hz)
+{
+    uint32_t pclk = (channel == SPI_CHANNEL_0) ? HAL_RCC_GetPCLK2Freq() : HAL_RCC_GetPCLK1Freq();
+    uint32_t br = 0;
+    
+    /* 分频系数为2^(br+1)，选择不超过目标频率的最高时钟 */
+    while (br < 7 && (pclk >> (br + 1)) > clock_hz) {
+        br++;
+    }
+    
+    return br << SPI_CR1_BR_Pos;
+}
+
+/**
+ * @brief 按事务要求切换总线模式与时钟
+ */
+static void spi_apply_transaction_config(stm32_spi_t *spi_dev, const spi_transaction_t *transaction)
+{
+    SPI_TypeDef *spi = spi_dev->hspi->Instance;
+    uint32_t cr1 = spi_dev->bus_cr1;
+    
+    if (transaction->clock_hz != 0) {
+        cr1 &= ~(SPI_CR1_CPOL | SPI_CR1_CPHA | SPI_CR1_BR);
+        cr1 |= get_spi_prescaler_for_clock(spi_dev->channel, transaction->clock_hz);
+        if (transaction->mode == SPI_MODE_2 || transaction->mode == SPI_MODE_3) {
+            cr1 |= SPI_CR1_CPOL;
+        }
+        if (transaction->mode == SPI_MODE_1 || transaction->mode == SPI_MODE_3) {
+            cr1 |= SPI_CR1_CPHA;
+        }
+    }
+    
+    /* 同一设备连续访问时配置不变，无需停止外设 */
+    if (spi->CR1 != (cr1 | SPI_CR1_SPE)) {
+        CLEAR_BIT(spi->CR1, SPI_CR1_SPE);
+        spi->CR1 = cr1;
+        SET_BIT(spi->CR1, SPI_CR1_SPE);
+    }
+}
+
+/**
+ * @brief 启动当前事务的当前分段
+ * 
+ * @param spi_dev SPI设备
+ * @return int 0表示成功，非0表示失败
+ */
+static int spi_dma_start_segment(stm32_spi_t *spi_dev)
+{
+    const spi_segment_t *segment = &spi_dev->active->segments[spi_dev->segment_index];
+    SPI_TypeDef *spi = spi_dev->hspi->Instance;
+    uint32_t dr = (uint32_t)&spi->DR;
+    uint32_t count = spi_dev->data_16bit ? segment->len / 2 : segment->len;
+    
+    CLEAR_BIT(spi->CR2, SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN);
+    __HAL_SPI_CLEAR_OVRFLAG(spi_dev->hspi);
+    
+    /* 发送流随上一分段接收完成而结束，先复位再重新装载 */
+    dma_stop(spi_dev->dma_tx);
+    
+    /* 未提供接收缓冲区时写入固定落点，未提供发送缓冲区时重复发送填充数据 */
+    dma_set_memory_increment(spi_dev->dma_rx, segment->rx_data != NULL);
+    dma_set_src_address(spi_dev->dma_rx, dr);
+    dma_set_dst_address(spi_dev->dma_rx, segment->rx_data != NULL ? (uint32_t)segment->rx_data : (uint32_t)&spi_dev->rx_discard);
+    dma_set_data_size(spi_dev->dma_rx, count);
+    
+    dma_set_memory_increment(spi_dev->dma_tx, segment->tx_data != NULL);
+    dma_set_src_address(spi_dev->dma_tx, segment->tx_data != NULL ? (uint32_t)segment->tx_data : (uint32_t)&spi_tx_fill);
+    dma_set_dst_address(spi_dev->dma_tx, dr);
+    dma_set_data_size(spi_dev->dma_tx, count);
+    
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    /* F7的D-Cache与DMA不一致，发送数据先写回，接收区域先清除脏行 */
+    if (segment->tx_data != NULL) {
+        spi_dcache_clean(segment->tx_data, segment->len);
+    }
+    if (segment->rx_data != NULL) {
+        spi_dcache_clean_invalidate(segment->rx_data, segment->len);
+    }
+#endif
+    
+    dma_enable_interrupt(spi_dev->dma_rx);
+    dma_enable_interrupt(spi_dev->dma_tx);
+    
+    /* 先启动接收流，避免首字节溢出 */
+    if (dma_start(spi_dev->dma_rx) != DRIVER_OK) {
+        return ERROR_HARDWARE;
+    }
+    
+    if (dma_start(spi_dev->dma_tx) != DRIVER_OK) {
+        dma_stop(spi_dev->dma_rx);
+        return ERROR_HARDWARE;
+    }
+    
+    SET_BIT(spi->CR2, SPI_CR2_RXDMAEN);
+    SET_BIT(spi->CR2, SPI_CR2_TXDMAEN);
+    
+    return ERROR_NONE;
+}
+
+static void spi_transaction_start_next(stm32_spi_t *spi_dev);
+
+/**
+ * @brief 占用执行中事务的完成权
+ *
+ * DMA中断与超时取消可能同时结束同一事务，只有占用成功的一方执行完成流程
+ * 
+ * @param spi_dev SPI设备
+ * @param transaction 事务
+ * @return bool true表示占用成功
+ */
+static bool spi_transaction_claim(stm32_spi_t *spi_dev, spi_transaction_t *transaction)
+{
+    bool claimed = false;
+    uint32_t primask = spi_irq_lock();
+    
+    if (transaction != NULL && spi_dev->active == transaction && !spi_dev->active_claimed) {
+        spi_dev->active_claimed = true;
+        claimed = true;
+    }
+    
+    spi_irq_unlock(primask);
+    
+    return claimed;
+}
+
+/**
+ * @brief 结束已占用的当前事务并启动队列中的下一个事务
+ * 
+ * @param spi_dev SPI设备
+ * @param result 事务结果
+ */
+static void spi_transaction_finish(stm32_spi_t *spi_dev, int result)
+{
+    spi_transaction_t *transaction = spi_dev->active;
+    
+    CLEAR_BIT(spi_dev->hspi->Instance->CR2, SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN);
+    
+    if (transaction->cs_control != NULL) {
+        transaction->cs_control(false, transaction->cs_arg);
+    }
+    
+    transaction->result = result;
+    spi_dev->active_claimed = false;
+    spi_dev->active = NULL;
+    
+    if (transaction->callback != NULL) {
+        transaction->callback(transaction, result, transaction->user_data);
+    }
+    
+    /* 回调返回后才标记完成，阻塞等待者随后即可复用事务对象 */
+    transaction->state = SPI_TRANSACTION_DONE;
+    
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_sem_give(spi_dev->done_sem);
+#endif
+    
+    spi_transaction_start_next(spi_dev);
+}
+
+/**
+ * @brief 结束当前事务，事务已被其他路径结束时直接返回
+ * 
+ * @param spi_dev SPI设备
+ * @param result 事务结果
+ */
+static void spi_transaction_complete(stm32_spi_t *spi_dev, int result)
+{
+    if (spi_transaction_claim(spi_dev, spi_dev->active)) {
+        spi_transaction_finish(spi_dev, result);
+    }
+}
+
+/**
+ * @brief 总线空闲时从队列取出下一个事务并启动
+ */
+static void spi_transaction_start_next(stm32_spi_t *spi_dev)
+{
+    spi_transaction_t *transaction = NULL;
+    uint32_t primask = spi_irq_lock();
+    
+    if (spi_dev->active == NULL && spi_dev->queue_head != NULL) {
+        transaction = spi_dev->queue_head;
+        spi_dev->queue_head = transaction->next;
+        if (spi_dev->queue_head == NULL) {
+            spi_dev->queue_tail = NULL;
+        }
+        transaction->next = NULL;
+        transaction->state = SPI_TRANSACTION_ACTIVE;
+        spi_dev->active = transaction;
+        spi_dev->segment_index = 0;
+    }
+    
+    spi_irq_unlock(primask);
+    
+    if (transaction == NULL) {
+        return;
+    }
+    
+    spi_apply_transaction_config(spi_dev, transaction);
+    
+    if (transaction->cs_control != NULL) {
+        transaction->cs_control(true, transaction->cs_arg);
+    }
+    
+    if (spi_dma_start_segment(spi_dev) != ERROR_NONE) {
+        spi_transaction_complete(spi_dev, ERROR_HARDWARE);
+    }
+}
+
+/**
+ * @brief 取消事务
+ * 
+ * 排队中的事务直接摘除，执行中的事务中止DMA后按失败结束
+ * 
+ * @param spi_dev SPI设备
+ * @param transaction 事务
+ * @param result 写入事务的结果
+ */
+static void spi_transaction_cancel(stm32_spi_t *spi_dev, spi_transaction_t *transaction, int result)
+{
+    uint32_t primask = spi_irq_lock();
+    
+    if (transaction->state == SPI_TRANSACTION_QUEUED) {
+        spi_transaction_t **link = &spi_dev->queue_head;
+        spi_transaction_t *prev = NULL;
+        
+        while (*link != NULL && *link != transaction) {
+            prev = *link;
+            link = &(*link)->next;
+        }
+        
+        if (*link == transaction) {
+            *link = transaction->next;
+            if (spi_dev->queue_tail == transaction) {
+                spi_dev->queue_tail = prev;
+            }
+        }
+        
+        transaction->next = NULL;
+        transaction->result = result;
+        transaction->state = SPI_TRANSACTION_DONE;
+        spi_irq_unlock(primask);
+        return;
+    }
+    
+    /* 占用与停止DMA在同一临界区内完成，之后到来的DMA中断不会再次结束该事务 */
+    if (transaction->state == SPI_TRANSACTION_ACTIVE && spi_transaction_claim(spi_dev, transaction)) {
+        dma_stop(spi_dev->dma_rx);
+        dma_stop(spi_dev->dma_tx);
+        spi_irq_unlock(primask);
+        spi_transaction_finish(spi_dev, result);
+        return;
+    }
+    
+    spi_irq_unlock(primask);
+}
+
+/**
+ * @brief 接收DMA回调，分段完成后衔接下一分段或结束事务
+ */
+static void spi_dma_rx_callback(void *arg, dma_status_t status)
+{
+    stm32_spi_t *spi_dev = (stm32_spi_t *)arg;
+    
+    /* 事务已被取消路径占用时不再衔接分段 */
+    if (spi_dev->active == NULL || spi_dev->active_claimed) {
+        return;
+    }
+    
+    if (status != DMA_STATUS_COMPLETE) {
+        dma_stop(spi_dev->dma_tx);
+        spi_transaction_complete(spi_dev, ERROR_HARDWARE);
+        return;
+    }
+    
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    if (spi_dev->active->segments[spi_dev->segment_index].rx_data != NULL) {
+        spi_dcache_invalidate(spi_dev->active->segments[spi_dev->segment_index].rx_data,
+                              spi_dev->active->segments[spi_dev->segment_index].len);
+    }
+#endif
+    
+    /* 同一事务的分段在中断中直接衔接，片选保持有效 */
+    if (++spi_dev->segment_index < spi_dev->active->segment_count) {
+        if (spi_dma_start_segment(spi_dev) != ERROR_NONE) {
+            spi_transaction_complete(spi_dev, ERROR_HARDWARE);
+        }
+        return;
+    }
+    
+    spi_transaction_complete(spi_dev, ERROR_NONE);
+}
+
+/**
+ * @brief 发送DMA回调，分段完成以接收完成为准，这里只处理错误
+ */
+static void spi_dma_tx_callback(void *arg, dma_status_t status)
+{
+    stm32_spi_t *spi_dev = (stm32_spi_t *)arg;
+    
+    if (status == DMA_STATUS_ERROR && spi_dev->active != NULL && !spi_dev->active_claimed) {
+        dma_stop(spi_dev->dma_rx);
+        spi_transaction_complete(spi_dev, ERROR_HARDWARE);
+    }
+}
+
+/**
+ * @brief 为SPI总线分配并配置收发DMA数据流
+ * 
+ * @param spi_dev SPI设备
+ * @return int 0表示成功，非0表示失败
+ */
+static int spi_dma_setup(stm32_spi_t *spi_dev)
+{
+    const stm32_spi_dma_map_t *map = &spi_dma_map[spi_dev->channel];
+    dma_config_t dma_config;
+    
+    memset(&dma_config, 0, sizeof(dma_config));
+    dma_config.mode = DMA_MODE_NORMAL;
+    dma_config.src_width = spi_dev->data_16bit ? DMA_DATA_WIDTH_16BIT : DMA_DATA_WIDTH_8BIT;
+    dma_config.dst_width = dma_config.src_width;
+    dma_config.src_inc = false;   /* 外设数据寄存器地址固定 */
+    dma_config.dst_inc = true;    /* 内存地址自增 */
+    
+    /* 接收流优先级高于发送流，避免接收溢出 */
+    dma_config.direction = DMA_DIR_PERIPH_TO_MEM;
+    dma_config.priority = DMA_PRIORITY_VERY_HIGH;
+    if (dma_alloc(1U << map->rx_stream, DMA_REQUEST_ID(DMA_REQUEST_SPI_RX, spi_dev->channel), &dma_config,
+                  spi_dma_rx_callback, spi_dev, &spi_dev->dma_rx) != DRIVER_OK) {
+        return ERROR_BUSY;
+    }
+    
+    dma_config.direction = DMA_DIR_MEM_TO_PERIPH;
+    dma_config.priority = DMA_PRIORITY_HIGH;
+    if (dma_alloc(1U << map->tx_stream, DMA_REQUEST_ID(DMA_REQUEST_SPI_TX, spi_dev->channel), &dma_config,
+                  spi_dma_tx_callback, spi_dev, &spi_dev->dma_tx) != DRIVER_OK) {
+        dma_deinit(spi_dev->dma_rx);
+        return ERROR_BUSY;
+    }
+    
+    dma_set_request_line(spi_dev->dma_rx, map->request);
+    dma_set_request_line(spi_dev->dma_tx, map->request);
+    
+    HAL_NVIC_SetPriority(map->rx_irq, CONFIG_SPI_DMA_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(map->rx_irq);
+    HAL_NVIC_SetPriority(map->tx_irq, CONFIG_SPI_DMA_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(map->tx_irq);
+    
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 释放SPI总线的DMA数据流
+ */
+static void spi_dma_release(stm32_spi_t *spi_dev)
+{
+    const stm32_spi_dma_map_t *map = &spi_dma_map[spi_dev->channel];
+    
+    HAL_NVIC_DisableIRQ(map->rx_irq);
+    HAL_NVIC_DisableIRQ(map->tx_irq);
+    dma_deinit(spi_dev->dma_rx);
+    dma_deinit(spi_dev->dma_tx);
+}
+
 /**
  * @brief SPI接口初始?
  * 
@@ -98,7 +577,7 @@ int spi_init(const spi_config_t *config, spi_handle_t *handle)
     
     /* 检查通道是否已被使用 */
     if (spi_used[config->channel]) {
-        return ERROR_RESOURCE_BUSY;
+        return ERROR_BUSY;
     }
     
     /* 获取SPI实例 */
@@ -110,10 +589,11 @@ int spi_init(const spi_config_t *config, spi_handle_t *handle)
     /* 分配内部结构?*/
     spi_dev = (stm32_spi_t *)malloc(sizeof(stm32_spi_t));
     if (spi_dev == NULL) {
-        return ERROR_NO_MEMORY;
+        return ERROR_MEMORY;
     }
     
     /* 初始化内部结构体 */
+    memset(spi_dev, 0, sizeof(stm32_spi_t));
     hspi = &spi_handles[config->channel];
     spi_dev->hspi = hspi;
     spi_dev->channel = config->channel;
@@ -167,6 +647,34 @@ int spi_init(const spi_config_t *config, spi_handle_t *handle)
         return ERROR_HARDWARE;
     }
     
+    /* 记录总线默认配置，事务未指定时钟时恢复为该配置 */
+    spi_dev->bus_cr1 = hspi->Instance->CR1 & ~SPI_CR1_SPE;
+    spi_dev->data_16bit = (hspi->Init.DataSize == SPI_DATASIZE_16BIT);
+    
+    /* 分配收发DMA数据流 */
+    if (spi_dma_setup(spi_dev) != ERROR_NONE) {
+        HAL_SPI_DeInit(hspi);
+        free(spi_dev);
+        return ERROR_BUSY;
+    }
+    
+#if (CURRENT_RTOS != RTOS_NONE)
+    if (rtos_sem_create(&spi_dev->done_sem, 0, 1) != 0) {
+        spi_dma_release(spi_dev);
+        HAL_SPI_DeInit(hspi);
+        free(spi_dev);
+        return ERROR_MEMORY;
+    }
+    
+    if (rtos_mutex_create(&spi_dev->sync_mutex) != 0) {
+        rtos_sem_delete(spi_dev->done_sem);
+        spi_dma_release(spi_dev);
+        HAL_SPI_DeInit(hspi);
+        free(spi_dev);
+        return ERROR_MEMORY;
+    }
+#endif
+    
     /* 更新使用标志 */
     spi_used[config->channel] = true;
     
@@ -191,6 +699,35 @@ int spi_deinit(spi_handle_t handle)
         return ERROR_INVALID_PARAM;
     }
     
+    /* 排队中的事务和正在执行的事务均以失败结束，完成回调照常调用 */
+    uint32_t primask = spi_irq_lock();
+    spi_transaction_t *pending = spi_dev->queue_head;
+    spi_dev->queue_head = NULL;
+    spi_dev->queue_tail = NULL;
+    spi_irq_unlock(primask);
+    
+    while (pending != NULL) {
+        spi_transaction_t *next = pending->next;
+        pending->next = NULL;
+        pending->result = ERROR_NOT_INITIALIZED;
+        if (pending->callback != NULL) {
+            pending->callback(pending, ERROR_NOT_INITIALIZED, pending->user_data);
+        }
+        pending->state = SPI_TRANSACTION_DONE;
+        pending = next;
+    }
+    
+    if (spi_dev->active != NULL) {
+        spi_transaction_cancel(spi_dev, spi_dev->active, ERROR_NOT_INITIALIZED);
+    }
+    
+    spi_dma_release(spi_dev);
+    
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_mutex_delete(spi_dev->sync_mutex);
+    rtos_sem_delete(spi_dev->done_sem);
+#endif
+    
     /* 去初始化SPI外设 */
     if (HAL_SPI_DeInit(spi_dev->hspi) != HAL_OK) {
         return ERROR_HARDWARE;
@@ -219,33 +756,130 @@ int spi_deinit(spi_handle_t handle)
 int spi_transfer(spi_handle_t handle, const void *tx_data, void *rx_data, uint32_t len, uint32_t timeout_ms)
 {
     stm32_spi_t *spi_dev = (stm32_spi_t *)handle;
-    HAL_StatusTypeDef status;
+    spi_segment_t segment;
+    spi_transaction_t transaction;
+    int ret;
     
-    /* 参数检?*/
+    /* 参数检查 */
     if (spi_dev == NULL || !spi_dev->initialized || (tx_data == NULL && rx_data == NULL) || len == 0) {
         return ERROR_INVALID_PARAM;
     }
     
-    /* 根据发送和接收缓冲区情况选择传输模式 */
-    if (tx_data != NULL && rx_data != NULL) {
-        /* 全双工传?*/
-        status = HAL_SPI_TransmitReceive(spi_dev->hspi, (uint8_t *)tx_data, (uint8_t *)rx_data, len, timeout_ms);
-    } else if (tx_data != NULL) {
-        /* 只发?*/
-        status = HAL_SPI_Transmit(spi_dev->hspi, (uint8_t *)tx_data, len, timeout_ms);
-    } else {
-        /* 只接?*/
-        status = HAL_SPI_Receive(spi_dev->hspi, (uint8_t *)rx_data, len, timeout_ms);
+    /* 作为单分段事务经总线队列由DMA完成，沿用总线默认配置 */
+    segment.tx_data = tx_data;
+    segment.rx_data = rx_data;
+    segment.len = len;
+    
+    memset(&transaction, 0, sizeof(transaction));
+    transaction.segments = &segment;
+    transaction.segment_count = 1;
+    
+    ret = spi_transaction_execute(handle, &transaction, timeout_ms);
+    
+    return (ret == ERROR_NONE) ? (int)len : ret;
+}
+
+/**
+ * @brief 提交SPI事务(非阻塞)
+ * 
+ * @param handle SPI设备句柄
+ * @param transaction 事务
+ * @return int 0表示成功，非0表示失败
+ */
+int spi_transaction_submit(spi_handle_t handle, spi_transaction_t *transaction)
+{
+    stm32_spi_t *spi_dev = (stm32_spi_t *)handle;
+    uint32_t primask;
+    
+    /* 参数检查 */
+    if (spi_dev == NULL || !spi_dev->initialized || transaction == NULL ||
+        transaction->segments == NULL || transaction->segment_count == 0) {
+        return ERROR_INVALID_PARAM;
     }
     
-    /* 检查传输状?*/
-    if (status == HAL_OK) {
-        return len;
-    } else if (status == HAL_TIMEOUT) {
-        return ERROR_TIMEOUT;
+    if (transaction->state == SPI_TRANSACTION_QUEUED || transaction->state == SPI_TRANSACTION_ACTIVE) {
+        return ERROR_BUSY;
+    }
+    
+    for (uint32_t i = 0; i < transaction->segment_count; i++) {
+        const spi_segment_t *segment = &transaction->segments[i];
+        
+        if (segment->len == 0 || segment->len > SPI_DMA_MAX_SEGMENT_LEN ||
+            (spi_dev->data_16bit && (segment->len & 1U))) {
+            return ERROR_INVALID_PARAM;
+        }
+    }
+    
+    transaction->next = NULL;
+    transaction->result = ERROR_NONE;
+    transaction->state = SPI_TRANSACTION_QUEUED;
+    
+    /* 追加到总线队列尾部 */
+    primask = spi_irq_lock();
+    if (spi_dev->queue_tail != NULL) {
+        spi_dev->queue_tail->next = transaction;
     } else {
-        return ERROR_HARDWARE;
+        spi_dev->queue_head = transaction;
+    }
+    spi_dev->queue_tail = transaction;
+    spi_irq_unlock(primask);
+    
+    /* 总线空闲时立即启动 */
+    spi_transaction_start_next(spi_dev);
+    
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 执行SPI事务(阻塞)
+ * 
+ * @param handle SPI设备句柄
+ * @param transaction 事务
+ * @param timeout_ms 超时时间（毫秒）
+ * @return int 0表示成功，非0表示失败
+ */
+int spi_transaction_execute(spi_handle_t handle, spi_transaction_t *transaction, uint32_t timeout_ms)
+{
+    stm32_spi_t *spi_dev = (stm32_spi_t *)handle;
+    int ret;
+    
+    if (spi_dev == NULL || !spi_dev->initialized) {
+        return ERROR_INVALID_PARAM;
     }
+    
+#if (CURRENT_RTOS != RTOS_NONE)
+    /* 阻塞等待者串行化，保证完成通知只有一个接收者 */
+    rtos_mutex_lock(spi_dev->sync_mutex, UINT32_MAX);
+#endif
+    
+    ret = spi_transaction_submit(handle, transaction);
+    
+    if (ret == ERROR_NONE) {
+        uint32_t start_time = HAL_GetTick();
+        
+        while (transaction->state != SPI_TRANSACTION_DONE) {
+            uint32_t elapsed = HAL_GetTick() - start_time;
+            
+            if (timeout_ms != UINT32_MAX && elapsed >= timeout_ms) {
+                spi_transaction_cancel(spi_dev, transaction, ERROR_TIMEOUT);
+                break;
+            }
+            
+#if (CURRENT_RTOS != RTOS_NONE)
+            rtos_sem_take(spi_dev->done_sem, timeout_ms == UINT32_MAX ? UINT32_MAX : timeout_ms - elapsed);
+#else
+            __WFI();
+#endif
+        }
+        
+        ret = transaction->result;
+    }
+    
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_mutex_unlock(spi_dev->sync_mutex);
+#endif
+    
+    return ret;
 }
 
 /**
@@ -272,6 +906,30 @@ int spi_register_event_callback(spi_handle_t handle, spi_event_callback_t callba
     return ERROR_NONE;
 }
 
+/**
+ * @brief 内部异步事务完成回调，转换为SPI事件通知用户
+ */
+static void spi_async_complete(spi_transaction_t *transaction, int result, void *user_data)
+{
+    stm32_spi_t *spi_dev = (stm32_spi_t *)user_data;
+    const spi_segment_t *segment = transaction->segments;
+    spi_event_t event;
+    
+    if (result != ERROR_NONE) {
+        event = SPI_EVENT_ERROR;
+    } else if (segment->rx_data == NULL) {
+        event = SPI_EVENT_TX_COMPLETE;
+    } else if (segment->tx_data == NULL) {
+        event = SPI_EVENT_RX_COMPLETE;
+    } else {
+        event = SPI_EVENT_TRANSFER_COMPLETE;
+    }
+    
+    if (spi_dev->callback != NULL) {
+        spi_dev->callback(spi_dev, event, spi_dev->user_data);
+    }
+}
+
 /**
  * @brief 启动异步传输
  * 
@@ -284,36 +942,35 @@ int spi_register_event_callback(spi_handle_t handle, spi_event_callback_t callba
 int spi_transfer_async(spi_handle_t handle, const void *tx_data, void *rx_data, uint32_t len)
 {
     stm32_spi_t *spi_dev = (stm32_spi_t *)handle;
-    HAL_StatusTypeDef status;
+    spi_transaction_t *transaction;
     
-    /* 参数检?*/
+    /* 参数检查 */
     if (spi_dev == NULL || !spi_dev->initialized || (tx_data == NULL && rx_data == NULL) || len == 0) {
         return ERROR_INVALID_PARAM;
     }
     
     /* 检查是否注册了回调函数 */
     if (spi_dev->callback == NULL) {
-        return ERROR_NOT_READY;
+        return ERROR_NOT_INITIALIZED;
     }
     
-    /* 根据发送和接收缓冲区情况选择传输模式 */
-    if (tx_data != NULL && rx_data != NULL) {
-        /* 全双工传?*/
-        status = HAL_SPI_TransmitReceive_IT(spi_dev->hspi, (uint8_t *)tx_data, (uint8_t *)rx_data, len);
-    } else if (tx_data != NULL) {
-        /* 只发?*/
-        status = HAL_SPI_Transmit_IT(spi_dev->hspi, (uint8_t *)tx_data, len);
-    } else {
-        /* 只接?*/
-        status = HAL_SPI_Receive_IT(spi_dev->hspi, (uint8_t *)rx_data, len);
+    /* 内部事务同一时间只能有一个在途，需要多个并发传输时使用spi_transaction_submit */
+    transaction = &spi_dev->async_transaction;
+    if (transaction->state == SPI_TRANSACTION_QUEUED || transaction->state == SPI_TRANSACTION_ACTIVE) {
+        return ERROR_BUSY;
     }
     
-    /* 检查传输状?*/
-    if (status == HAL_OK) {
-        return ERROR_NONE;
-    } else {
-        return ERROR_HARDWARE;
-    }
+    spi_dev->async_segment.tx_data = tx_data;
+    spi_dev->async_segment.rx_data = rx_data;
+    spi_dev->async_segment.len = len;
+    
+    memset(transaction, 0, sizeof(spi_transaction_t));
+    transaction->segments = &spi_dev->async_segment;
+    transaction->segment_count = 1;
+    transaction->callback = spi_async_complete;
+    transaction->user_data = spi_dev;
+    
+    return spi_transaction_submit(handle, transaction);
 }
 
 /**
@@ -337,79 +994,3 @@ int spi_set_cs(spi_handle_t handle, int state)
     
     return ERROR_NONE;
 }
-
-/**
- * @brief SPI中断处理函数（在HAL库的SPI IRQ回调中调用）
- */
-void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
-{
-    /* 查找对应的SPI设备 */
-    for (int i = 0; i < SPI_CHANNEL_MAX; i++) {
-        if (&spi_handles[i] == hspi) {
-            /* 遍历所有SPI设备，查找对应的句柄 */
-            stm32_spi_t *spi_dev = NULL;
-            /* 这里需要维护一个映射关系，此处简化处?*/
-            
-            /* 如果找到设备并且有回调函数，则调用回?*/
-            if (spi_dev != NULL && spi_dev->callback != NULL) {
-                spi_dev->callback(spi_dev, SPI_EVENT_TX_COMPLETE, spi_dev->user_data);
-            }
-            break;
-        }
-    }
-}
-
-void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi)
-{
-    /* 查找对应的SPI设备 */
-    for (int i = 0; i < SPI_CHANNEL_MAX; i++) {
-        if (&spi_handles[i] == hspi) {
-            /* 遍历所有SPI设备，查找对应的句柄 */
-            stm32_spi_t *spi_dev = NULL;
-            /* 这里需要维护一个映射关系，此处简化处?*/
-            
-            /* 如果找到设备并且有回调函数，则调用回?*/
-            if (spi_dev != NULL && spi_dev->callback != NULL) {
-                spi_dev->callback(spi_dev, SPI_EVENT_RX_COMPLETE, spi_dev->user_data);
-            }
-            break;
-        }
-    }
-}
-
-void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
-{
-    /* 查找对应的SPI设备 */
-    for (int i = 0; i < SPI_CHANNEL_MAX; i++) {
-        if (&spi_handles[i] == hspi) {
-            /* 遍历所有SPI设备，查找对应的句柄 */
-            stm32_spi_t *spi_dev = NULL;
-            /* 这里需要维护一个映射关系，此处简化处?*/
-            
-            /* 如果找到设备并且有回调函数，则调用回?*/
-            if (spi_dev != NULL && spi_dev->callback != NULL) {
-                spi_dev->callback(spi_dev, SPI_EVENT_TRANSFER_COMPLETE, spi_dev->user_data);
-            }
-            break;
-        }
-    }
-}
-
-void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
-{
-    /* 查找对应的SPI设备 */
-    for (int i = 0; i < SPI_CHANNEL_MAX; i++) {
-        if (&spi_handles[i] == hspi) {
-            /* 遍历所有SPI设备，查找对应的句柄 */
-            stm32_spi_t *spi_dev = NULL;
-            /* 这里需要维护一个映射关系，此处简化处?*/
-            
-            /* 如果找到设备并且有回调函数，则调用回?*/
-            if (spi_dev != NULL && spi_dev->callback != NULL) {
-                spi_dev->callback(spi_dev, SPI_EVENT_ERROR, spi_dev->user_data);
-            }
-            break;
-        }
-    }
-}
-
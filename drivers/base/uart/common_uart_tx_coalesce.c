@@ -0,0 +1,313 @@
+/**
+ * @file common_uart_tx_coalesce.c
+ * @brief UART发送合并缓冲区实现（平台无关）
+ */
+
+#include "base/uart_tx_coalesce_api.h"
+#include <string.h>
+
+#if defined(CONFIG_TIMER_WHEEL_ENABLED) && CONFIG_TIMER_WHEEL_ENABLED
+#define TX_COALESCE_USE_TIMER   1
+#else
+#define TX_COALESCE_USE_TIMER   0
+#endif
+
+#if TX_COALESCE_USE_TIMER
+/**
+ * @brief 超时刷新定时器回调
+ *
+ * 定时器在缓冲区首字节写入时启动，到期时该批数据可能已随阈值发出，
+ * 此时刷新的是更新的一批数据，只会提前发送，不会延误
+ */
+static void tx_flush_timer_callback(timer_wheel_timer_t *timer, void *arg) {
+    (void)timer;
+    uart_tx_coalesce_flush((uart_tx_coalesce_t *)arg);
+}
+#endif
+
+/**
+ * @brief 满足发送条件时交换缓冲区并启动发送
+ *
+ * 调用时必须持有锁，返回前释放锁；驱动的start在锁外调用
+ *
+ * @param tx 合并器对象
+ * @param key lock返回值
+ * @param force 忽略阈值和超时立即发送
+ */
+static void tx_kick_unlock(uart_tx_coalesce_t *tx, uint32_t key, bool force) {
+    uint8_t index = tx->fill_index;
+    uint32_t len = tx->fill[index];
+    bool due = force || tx->flush_pending || len >= tx->threshold ||
+               (tx->timeout_ms != 0 && len > 0 && (tx->ops->now_ms() - tx->first_ms) >= tx->timeout_ms);
+
+#if !TX_COALESCE_USE_TIMER
+    /*
+     * 没有定时器执行超时刷新，硬件空闲时立即发送；发送期间写入的数据在
+     * 完成时接续发出，仍能合并，且尾部不足阈值的数据不会滞留
+     */
+    if (tx->timeout_ms != 0) {
+        due = true;
+    }
+#endif
+
+    if (tx->busy || len == 0 || tx->writers[index] != 0 || !due) {
+        /* 暂时不能发送的刷新请求在发送完成或提交时接续 */
+        if (force && len > 0) {
+            tx->flush_pending = true;
+        }
+        tx->ops->unlock(tx->ctx, key);
+        return;
+    }
+
+    tx->busy = true;
+    tx->flush_pending = false;
+    tx->send_index = index;
+    tx->fill_index = index ^ 1;
+    tx->stats.transfers++;
+    tx->ops->unlock(tx->ctx, key);
+
+    if (tx->ops->start(tx->ctx, tx->buf[index], len) != 0) {
+        /* 启动失败时丢弃该批数据，避免发送停滞 */
+        uart_tx_coalesce_complete(tx);
+    }
+}
+
+/**
+ * @brief 初始化发送合并器
+ */
+int uart_tx_coalesce_init(uart_tx_coalesce_t *tx, const uart_tx_coalesce_ops_t *ops, void *ctx) {
+    if (tx == NULL || ops == NULL || ops->start == NULL || ops->lock == NULL ||
+        ops->unlock == NULL || ops->now_ms == NULL) {
+        return UART_TX_COALESCE_INVALID_PARAM;
+    }
+
+    memset(tx, 0, sizeof(uart_tx_coalesce_t));
+    tx->ops = ops;
+    tx->ctx = ctx;
+    tx->threshold = CONFIG_UART_TX_COALESCE_THRESHOLD;
+    tx->timeout_ms = CONFIG_UART_TX_COALESCE_TIMEOUT_MS;
+
+#if TX_COALESCE_USE_TIMER
+    timer_wheel_timer_init(&tx->flush_timer, tx_flush_timer_callback, tx);
+#endif
+
+    return UART_TX_COALESCE_OK;
+}
+
+/**
+ * @brief 去初始化发送合并器
+ */
+void uart_tx_coalesce_deinit(uart_tx_coalesce_t *tx) {
+    if (tx == NULL) {
+        return;
+    }
+
+#if TX_COALESCE_USE_TIMER
+    timer_wheel_stop(&tx->flush_timer);
+#endif
+
+    tx->fill[0] = 0;
+    tx->fill[1] = 0;
+    tx->writers[0] = 0;
+    tx->writers[1] = 0;
+    tx->busy = false;
+    tx->flush_pending = false;
+}
+
+/**
+ * @brief 设置刷新策略
+ */
+int uart_tx_coalesce_set_policy(uart_tx_coalesce_t *tx, uint32_t threshold, uint32_t timeout_ms) {
+    if (tx == NULL || threshold == 0) {
+        return UART_TX_COALESCE_INVALID_PARAM;
+    }
+
+    if (threshold > CONFIG_UART_TX_COALESCE_BUF_SIZE) {
+        threshold = CONFIG_UART_TX_COALESCE_BUF_SIZE;
+    }
+
+    uint32_t key = tx->ops->lock(tx->ctx);
+    tx->threshold = threshold;
+    tx->timeout_ms = timeout_ms;
+    tx->ops->unlock(tx->ctx, key);
+
+    return UART_TX_COALESCE_OK;
+}
+
+/**
+ * @brief 在填充缓冲区中预留连续空间
+ */
+int uart_tx_coalesce_reserve(uart_tx_coalesce_t *tx, uint32_t len, uint8_t **buffer) {
+    if (tx == NULL || buffer == NULL || len == 0 || len > CONFIG_UART_TX_COALESCE_BUF_SIZE) {
+        return UART_TX_COALESCE_INVALID_PARAM;
+    }
+
+    uint32_t key = tx->ops->lock(tx->ctx);
+    uint8_t index = tx->fill_index;
+
+    if (tx->fill[index] + len > CONFIG_UART_TX_COALESCE_BUF_SIZE) {
+        /* 填充缓冲区放不下，先把它交给硬件再使用另一个缓冲区 */
+        if (tx->busy || tx->writers[index] != 0) {
+            tx->stats.full++;
+            tx->ops->unlock(tx->ctx, key);
+            return UART_TX_COALESCE_FULL;
+        }
+
+        tx_kick_unlock(tx, key, true);
+
+        key = tx->ops->lock(tx->ctx);
+        index = tx->fill_index;
+        if (tx->fill[index] + len > CONFIG_UART_TX_COALESCE_BUF_SIZE) {
+            tx->stats.full++;
+            tx->ops->unlock(tx->ctx, key);
+            return UART_TX_COALESCE_FULL;
+        }
+    }
+
+    bool first = (tx->fill[index] == 0);
+    if (first) {
+        tx->first_ms = tx->ops->now_ms();
+    }
+
+    *buffer = &tx->buf[index][tx->fill[index]];
+    tx->fill[index] += len;
+    tx->writers[index]++;
+    tx->stats.bytes += len;
+    tx->ops->unlock(tx->ctx, key);
+
+#if TX_COALESCE_USE_TIMER
+    if (first && tx->timeout_ms != 0) {
+        timer_wheel_start(&tx->flush_timer, tx->timeout_ms, 0);
+    }
+#endif
+
+    return UART_TX_COALESCE_OK;
+}
+
+/**
+ * @brief 提交预留空间
+ */
+int uart_tx_coalesce_commit(uart_tx_coalesce_t *tx, uint8_t *buffer) {
+    if (tx == NULL || buffer == NULL) {
+        return UART_TX_COALESCE_INVALID_PARAM;
+    }
+
+    uint8_t index;
+    if (buffer >= tx->buf[0] && buffer < tx->buf[0] + CONFIG_UART_TX_COALESCE_BUF_SIZE) {
+        index = 0;
+    } else if (buffer >= tx->buf[1] && buffer < tx->buf[1] + CONFIG_UART_TX_COALESCE_BUF_SIZE) {
+        index = 1;
+    } else {
+        return UART_TX_COALESCE_INVALID_PARAM;
+    }
+
+    uint32_t key = tx->ops->lock(tx->ctx);
+
+    if (tx->writers[index] == 0) {
+        tx->ops->unlock(tx->ctx, key);
+        return UART_TX_COALESCE_INVALID_PARAM;
+    }
+
+    /* 有未提交预留的缓冲区不会被交换，这里的index必然是填充缓冲区 */
+    tx->writers[index]--;
+    tx->stats.writes++;
+    tx_kick_unlock(tx, key, false);
+
+    return UART_TX_COALESCE_OK;
+}
+
+/**
+ * @brief 复制数据到填充缓冲区
+ */
+int uart_tx_coalesce_write(uart_tx_coalesce_t *tx, const uint8_t *data, uint32_t len) {
+    uint32_t written = 0;
+
+    if (tx == NULL || data == NULL) {
+        return UART_TX_COALESCE_INVALID_PARAM;
+    }
+
+    while (written < len) {
+        uint32_t chunk = len - written;
+        uint8_t *buffer;
+
+        if (chunk > CONFIG_UART_TX_COALESCE_BUF_SIZE) {
+            chunk = CONFIG_UART_TX_COALESCE_BUF_SIZE;
+        }
+
+        /* 先填满填充缓冲区的剩余空间，避免未满即交换 */
+        uint32_t key = tx->ops->lock(tx->ctx);
+        uint32_t room = CONFIG_UART_TX_COALESCE_BUF_SIZE - tx->fill[tx->fill_index];
+        tx->ops->unlock(tx->ctx, key);
+
+        if (room > 0 && room < chunk) {
+            chunk = room;
+        }
+
+        if (uart_tx_coalesce_reserve(tx, chunk, &buffer) != UART_TX_COALESCE_OK) {
+            break;
+        }
+
+        memcpy(buffer, &data[written], chunk);
+        uart_tx_coalesce_commit(tx, buffer);
+        written += chunk;
+    }
+
+    return (int)written;
+}
+
+/**
+ * @brief 立即发送填充缓冲区中的数据
+ */
+int uart_tx_coalesce_flush(uart_tx_coalesce_t *tx) {
+    if (tx == NULL) {
+        return UART_TX_COALESCE_INVALID_PARAM;
+    }
+
+    tx_kick_unlock(tx, tx->ops->lock(tx->ctx), true);
+
+    return UART_TX_COALESCE_OK;
+}
+
+/**
+ * @brief 检查超时刷新
+ */
+void uart_tx_coalesce_poll(uart_tx_coalesce_t *tx) {
+    if (tx == NULL) {
+        return;
+    }
+
+    tx_kick_unlock(tx, tx->ops->lock(tx->ctx), false);
+}
+
+/**
+ * @brief 通知一次硬件发送结束
+ */
+void uart_tx_coalesce_complete(uart_tx_coalesce_t *tx) {
+    uint32_t key = tx->ops->lock(tx->ctx);
+
+    tx->fill[tx->send_index] = 0;
+    tx->busy = false;
+
+    /* 发送期间积累的数据达到阈值、超时或已请求刷新时立即接续 */
+    tx_kick_unlock(tx, key, false);
+}
+
+/**
+ * @brief 判断是否空闲
+ */
+bool uart_tx_coalesce_idle(const uart_tx_coalesce_t *tx) {
+    return !tx->busy && tx->fill[tx->fill_index] == 0;
+}
+
+/**
+ * @brief 获取统计信息
+ */
+int uart_tx_coalesce_get_stats(const uart_tx_coalesce_t *tx, uart_tx_coalesce_stats_t *stats) {
+    if (tx == NULL || stats == NULL) {
+        return UART_TX_COALESCE_INVALID_PARAM;
+    }
+
+    *stats = tx->stats;
+
+    return UART_TX_COALESCE_OK;
+}
@@ -2,10 +2,12 @@
  * @file esp32_uart.c
  * @brief ESP32平台UART驱动实现
  *
- * 该文件实现了ESP32平台的UART驱动接口
+ * 该文件实现了ESP32平台的UART驱动接口。ESP32的UART没有通用DMA，
+ * 发送合并器攒批后一次写入IDF驱动的发送环形缓冲区，由驱动中断搬入FIFO
  */
 
 #include "base/uart_api.h"
+#include "base/uart_tx_coalesce_api.h"
 #include "common/error_api.h"
 #include "driver/uart.h"
 #include "esp_log.h"
@@ -22,6 +24,17 @@ static const char *TAG = "ESP32_UART";
 #define UART_TX_BUF_SIZE 1024
 #define UART_QUEUE_SIZE  20
 
+#if (UART_RX_BUF_SIZE & (UART_RX_BUF_SIZE - 1)) != 0
+#error "UART_RX_BUF_SIZE must be a power of two"
+#endif
+
+#define UART_RX_BUF_MASK (UART_RX_BUF_SIZE - 1)
+
+/* 接收空闲超时（字符时间），线路空闲该时长后立即上报已收到的数据 */
+#ifndef CONFIG_UART_RX_IDLE_SYMBOLS
+#define CONFIG_UART_RX_IDLE_SYMBOLS 10
+#endif
+
 /* UART设备句柄结构?*/
 typedef struct {
     uart_port_t port;                  /* ESP32 UART端口?*/
@@ -31,6 +44,19 @@ typedef struct {
     uart_rx_callback_t rx_callback;    /* 接收回调函数 */
     void *user_data;                   /* 用户数据 */
     TaskHandle_t rx_task;              /* 接收任务句柄 */
+    uart_rx_span_callback_t span_callback; /* 接收数据段回调函数 */
+    void *span_user_data;              /* 数据段回调用户数据 */
+    volatile uint32_t rx_head;         /* 累计到达字节数，仅由接收任务推进 */
+    volatile uint32_t rx_tail;         /* 累计归还字节数，仅由使用者推进 */
+    volatile bool rx_deferred;         /* 环形缓冲区已满，数据留在驱动缓冲区中 */
+    uart_rx_stats_t rx_stats;          /* 接收统计信息 */
+    uint8_t rx_buf[UART_RX_BUF_SIZE];  /* 接收环形缓冲区 */
+    portMUX_TYPE tx_mux;               /* 发送合并器临界区 */
+    uart_tx_coalesce_t tx;             /* 发送合并器 */
+    TaskHandle_t tx_task;              /* 发送任务句柄 */
+    const uint8_t *tx_data;            /* 待写入驱动的合并缓冲区 */
+    uint32_t tx_len;                   /* 待写入长度 */
+    volatile bool tx_exit;             /* 通知发送任务退出 */
 } esp32_uart_handle_t;
 
 /* UART设备句柄数组 */
@@ -138,6 +164,93 @@ static uint32_t get_baudrate(const uart_config_t *config)
     }
 }
 
+/**
+ * @brief 获取未归还的接收字节数，同时处理被覆盖的数据
+ * 
+ * @param esp32_handle UART设备句柄
+ * @return uint32_t 未归还的字节数
+ */
+static uint32_t uart_rx_pending(esp32_uart_handle_t *esp32_handle)
+{
+    uint32_t head = __atomic_load_n(&esp32_handle->rx_head, __ATOMIC_ACQUIRE);
+    uint32_t pending = head - esp32_handle->rx_tail;
+    
+    /* 使用者落后超过一整圈，最旧的数据已被覆盖 */
+    if (pending > UART_RX_BUF_SIZE) {
+        esp32_handle->rx_stats.overrun += pending - UART_RX_BUF_SIZE;
+        esp32_handle->rx_tail = head - UART_RX_BUF_SIZE;
+        pending = UART_RX_BUF_SIZE;
+    }
+    
+    return pending;
+}
+
+/**
+ * @brief 发布一个新到达的数据段
+ * 
+ * @param esp32_handle UART设备句柄
+ * @param offset 数据段在环形缓冲区中的偏移
+ * @param length 数据段长度
+ */
+static void uart_rx_publish(esp32_uart_handle_t *esp32_handle, uint32_t offset, uint32_t length)
+{
+    esp32_handle->rx_stats.received += length;
+    __atomic_store_n(&esp32_handle->rx_head, esp32_handle->rx_head + length, __ATOMIC_RELEASE);
+    
+    if (esp32_handle->span_callback != NULL) {
+        esp32_handle->span_callback(esp32_handle->rx_buf, offset, length, esp32_handle->span_user_data);
+    } else if (esp32_handle->rx_callback != NULL) {
+        /* 旧接口直接引用环形缓冲区内的数据，回调返回即视为处理完毕 */
+        esp32_handle->rx_callback(&esp32_handle->rx_buf[offset], length, esp32_handle->user_data);
+        uart_rx_release((uart_handle_t)esp32_handle, length);
+    }
+}
+
+/**
+ * @brief 将驱动缓冲区中的数据读入接收环形缓冲区并发布
+ * 
+ * 最多读入环形缓冲区的空闲空间，不覆盖未归还的数据段；其余数据留在驱动
+ * 缓冲区中，由后续接收事件或uart_rx_release归还空间后继续读出
+ * 
+ * @param esp32_handle UART设备句柄
+ */
+static void uart_rx_drain(esp32_uart_handle_t *esp32_handle)
+{
+    size_t buffered_size = 0;
+    uint32_t space;
+    
+    /* 未注册回调时数据留在驱动缓冲区，由uart_receive读取 */
+    if (esp32_handle->span_callback == NULL && esp32_handle->rx_callback == NULL) {
+        return;
+    }
+    
+    uart_get_buffered_data_len(esp32_handle->port, &buffered_size);
+    
+    space = UART_RX_BUF_SIZE - (esp32_handle->rx_head - __atomic_load_n(&esp32_handle->rx_tail, __ATOMIC_ACQUIRE));
+    if (buffered_size > space) {
+        /* 空间归还后由uart_rx_release重新触发读取 */
+        __atomic_store_n(&esp32_handle->rx_deferred, true, __ATOMIC_RELEASE);
+        buffered_size = space;
+    }
+    
+    while (buffered_size > 0) {
+        uint32_t offset = esp32_handle->rx_head & UART_RX_BUF_MASK;
+        uint32_t chunk = UART_RX_BUF_SIZE - offset;
+        
+        if (chunk > buffered_size) {
+            chunk = buffered_size;
+        }
+        
+        int len = uart_read_bytes(esp32_handle->port, &esp32_handle->rx_buf[offset], chunk, 0);
+        if (len <= 0) {
+            break;
+        }
+        
+        uart_rx_publish(esp32_handle, offset, (uint32_t)len);
+        buffered_size -= (size_t)len;
+    }
+}
+
 /**
  * @brief UART接收任务
  * 
@@ -147,51 +260,21 @@ static void uart_rx_task(void *arg)
 {
     esp32_uart_handle_t *esp32_handle = (esp32_uart_handle_t *)arg;
     uart_event_t event;
-    uint8_t *data = NULL;
-    
-    /* 分配接收缓冲?*/
-    data = (uint8_t *)malloc(UART_RX_BUF_SIZE);
-    if (data == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate UART RX buffer");
-        vTaskDelete(NULL);
-        return;
-    }
     
     while (1) {
         /* 等待UART事件 */
         if (xQueueReceive(esp32_handle->uart_queue, (void *)&event, portMAX_DELAY)) {
             switch (event.type) {
                 case UART_DATA:
-                    /* 读取数据 */
-                    if (esp32_handle->rx_callback != NULL) {
-                        size_t buffered_size;
-                        int len = uart_read_bytes(esp32_handle->port, data, 
-                                                event.size, pdMS_TO_TICKS(100));
-                        
-                        if (len > 0) {
-                            /* 调用用户回调函数 */
-                            esp32_handle->rx_callback(data, len, esp32_handle->user_data);
-                        }
-                        
-                        /* 检查是否还有数?*/
-                        uart_get_buffered_data_len(esp32_handle->port, &buffered_size);
-                        if (buffered_size > 0) {
-                            /* 手动触发UART_DATA事件 */
-                            xQueueSend(esp32_handle->uart_queue, (void *)&event, 0);
-                        }
-                    }
+                case UART_BUFFER_FULL:
+                    uart_rx_drain(esp32_handle);
                     break;
                     
                 case UART_FIFO_OVF:
+                    /* 硬件FIFO中丢失的字节无法恢复，驱动缓冲区中的数据仍然有效，继续读出 */
                     ESP_LOGW(TAG, "UART FIFO overflow");
-                    uart_flush_input(esp32_handle->port);
-                    xQueueReset(esp32_handle->uart_queue);
-                    break;
-                    
-                case UART_BUFFER_FULL:
-                    ESP_LOGW(TAG, "UART buffer full");
-                    uart_flush_input(esp32_handle->port);
-                    xQueueReset(esp32_handle->uart_queue);
+                    esp32_handle->rx_stats.hw_errors++;
+                    uart_rx_drain(esp32_handle);
                     break;
                     
                 case UART_BREAK:
@@ -200,10 +283,12 @@ static void uart_rx_task(void *arg)
                     
                 case UART_PARITY_ERR:
                     ESP_LOGW(TAG, "UART parity error");
+                    esp32_handle->rx_stats.hw_errors++;
                     break;
                     
                 case UART_FRAME_ERR:
                     ESP_LOGW(TAG, "UART frame error");
+                    esp32_handle->rx_stats.hw_errors++;
                     break;
                     
                 default:
@@ -213,13 +298,104 @@ static void uart_rx_task(void *arg)
         }
     }
     
-    /* 释放缓冲?*/
-    free(data);
-    
     /* 删除任务 */
     vTaskDelete(NULL);
 }
 
+/**
+ * @brief 发送合并器临界区
+ */
+static uint32_t uart_tx_lock(void *ctx)
+{
+    esp32_uart_handle_t *esp32_handle = (esp32_uart_handle_t *)ctx;
+    
+    portENTER_CRITICAL(&esp32_handle->tx_mux);
+    
+    return 0;
+}
+
+static void uart_tx_unlock(void *ctx, uint32_t key)
+{
+    esp32_uart_handle_t *esp32_handle = (esp32_uart_handle_t *)ctx;
+    
+    (void)key;
+    portEXIT_CRITICAL(&esp32_handle->tx_mux);
+}
+
+static uint32_t uart_tx_now_ms(void)
+{
+    return (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+/**
+ * @brief UART发送任务
+ * 
+ * 将合并后的数据写入驱动发送环形缓冲区，驱动缓冲区满时在此阻塞。
+ * 超时刷新在时间轮定时器上下文中触发，不能在那里调用阻塞的uart_write_bytes
+ * 
+ * @param arg 任务参数
+ */
+static void uart_tx_task(void *arg)
+{
+    esp32_uart_handle_t *esp32_handle = (esp32_uart_handle_t *)arg;
+    
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        
+        if (esp32_handle->tx_exit) {
+            break;
+        }
+        
+        if (esp32_handle->tx_len > 0) {
+            const uint8_t *data = esp32_handle->tx_data;
+            uint32_t len = esp32_handle->tx_len;
+            
+            esp32_handle->tx_len = 0;
+            if (uart_write_bytes(esp32_handle->port, (const char *)data, len) < 0) {
+                ESP_LOGW(TAG, "UART write failed");
+            }
+            
+            /* 数据已复制到驱动缓冲区，释放合并缓冲区并接续下一批 */
+            uart_tx_coalesce_complete(&esp32_handle->tx);
+        }
+    }
+    
+    esp32_handle->tx_task = NULL;
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief 将合并后的数据交给发送任务
+ * 
+ * 可能在时间轮定时器或调用者上下文中调用，只记录数据并通知发送任务
+ * 
+ * @param ctx UART设备句柄
+ * @param data 发送缓冲区
+ * @param len 发送长度
+ * @return int 0表示成功，非0表示失败
+ */
+static int uart_tx_start(void *ctx, const uint8_t *data, uint32_t len)
+{
+    esp32_uart_handle_t *esp32_handle = (esp32_uart_handle_t *)ctx;
+    
+    if (!esp32_handle->initialized || esp32_handle->tx_task == NULL) {
+        return ERROR_NOT_INITIALIZED;
+    }
+    
+    esp32_handle->tx_data = data;
+    esp32_handle->tx_len = len;
+    xTaskNotifyGive(esp32_handle->tx_task);
+    
+    return ERROR_NONE;
+}
+
+static const uart_tx_coalesce_ops_t uart_tx_ops = {
+    .start = uart_tx_start,
+    .lock = uart_tx_lock,
+    .unlock = uart_tx_unlock,
+    .now_ms = uart_tx_now_ms
+};
+
 /**
  * @brief 初始化UART
  * 
@@ -298,20 +474,51 @@ int uart_init(const uart_config_t *config, uart_handle_t *handle)
         return ERROR_HARDWARE;
     }
     
-    /* 创建接收任务 */
+    /* 线路空闲时立即产生数据事件，相当于空闲线检测 */
+    uart_set_rx_timeout(config->channel, CONFIG_UART_RX_IDLE_SYMBOLS);
+    
     char task_name[32];
-    snprintf(task_name, sizeof(task_name), "uart_rx_task_%d", config->channel);
     
     /* 更新句柄信息 */
     esp32_handle->port = config->channel;
     esp32_handle->initialized = true;
     esp32_handle->rx_callback = NULL;
     esp32_handle->user_data = NULL;
+    esp32_handle->span_callback = NULL;
+    esp32_handle->span_user_data = NULL;
+    esp32_handle->rx_head = 0;
+    esp32_handle->rx_tail = 0;
+    esp32_handle->rx_deferred = false;
+    memset(&esp32_handle->rx_stats, 0, sizeof(esp32_handle->rx_stats));
+    portMUX_INITIALIZE(&esp32_handle->tx_mux);
+#if defined(CONFIG_TIMER_WHEEL_ENABLED) && CONFIG_TIMER_WHEEL_ENABLED
+    /* 发送合并的超时刷新由时间轮定时器执行，已初始化时直接返回 */
+    timer_wheel_init(0);
+#endif
+    uart_tx_coalesce_init(&esp32_handle->tx, &uart_tx_ops, esp32_handle);
+    esp32_handle->tx_len = 0;
+    esp32_handle->tx_exit = false;
+    
+    /* 创建发送任务 */
+    snprintf(task_name, sizeof(task_name), "uart_tx_task_%d", config->channel);
+    if (xTaskCreate(uart_tx_task, task_name, 2048, esp32_handle, 10, &esp32_handle->tx_task) != pdPASS) {
+        esp32_handle->tx_task = NULL;
+        uart_driver_delete(config->channel);
+        ESP_LOGE(TAG, "Failed to create UART TX task");
+        esp32_handle->initialized = false;
+        return ERROR_NO_MEMORY;
+    }
     
     /* 创建接收任务 */
+    snprintf(task_name, sizeof(task_name), "uart_rx_task_%d", config->channel);
     BaseType_t task_created = xTaskCreate(uart_rx_task, task_name, 2048, 
                                          esp32_handle, 10, &esp32_handle->rx_task);
     if (task_created != pdPASS) {
+        esp32_handle->tx_exit = true;
+        xTaskNotifyGive(esp32_handle->tx_task);
+        while (esp32_handle->tx_task != NULL) {
+            vTaskDelay(1);
+        }
         uart_driver_delete(config->channel);
         ESP_LOGE(TAG, "Failed to create UART RX task");
         esp32_handle->initialized = false;
@@ -351,6 +558,17 @@ int uart_deinit(uart_handle_t handle)
         esp32_handle->rx_task = NULL;
     }
     
+    /* 丢弃尚未写入驱动的合并数据，发送任务完成当前写入后退出 */
+    esp32_handle->initialized = false;
+    uart_tx_coalesce_deinit(&esp32_handle->tx);
+    if (esp32_handle->tx_task != NULL) {
+        esp32_handle->tx_exit = true;
+        xTaskNotifyGive(esp32_handle->tx_task);
+        while (esp32_handle->tx_task != NULL) {
+            vTaskDelay(1);
+        }
+    }
+    
     /* 卸载UART驱动 */
     ret = uart_driver_delete(esp32_handle->port);
     if (ret != ESP_OK) {
@@ -362,48 +580,174 @@ int uart_deinit(uart_handle_t handle)
     esp32_handle->initialized = false;
     esp32_handle->rx_callback = NULL;
     esp32_handle->user_data = NULL;
+    esp32_handle->span_callback = NULL;
+    esp32_handle->span_user_data = NULL;
     
     return ERROR_NONE;
 }
 
 /**
- * @brief UART发送数?
+ * @brief 合并写入UART发送缓冲区
  * 
  * @param handle UART设备句柄
- * @param data 数据缓冲?
+ * @param data 数据缓冲区
+ * @param len 数据长度
+ * @param timeout_ms 等待发送缓冲区空间的超时时间（毫秒）
+ * @return int 写入的字节数，负值表示错误
+ */
+int uart_write(uart_handle_t handle, const uint8_t *data, uint32_t len, uint32_t timeout_ms)
+{
+    esp32_uart_handle_t *esp32_handle = (esp32_uart_handle_t *)handle;
+    TickType_t start_tick = xTaskGetTickCount();
+    uint32_t written = 0;
+    
+    if (handle == NULL || data == NULL || !esp32_handle->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    while (1) {
+        written += (uint32_t)uart_tx_coalesce_write(&esp32_handle->tx, &data[written], len - written);
+        
+        /* 缓冲区只在其他任务写入驱动期间不可用，让出CPU后重试 */
+        if (written == len || (xTaskGetTickCount() - start_tick) >= pdMS_TO_TICKS(timeout_ms)) {
+            break;
+        }
+        
+        vTaskDelay(1);
+    }
+    
+    return (int)written;
+}
+
+/**
+ * @brief 在发送缓冲区中预留空间
+ * 
+ * @param handle UART设备句柄
+ * @param len 预留长度
+ * @param buffer 返回预留空间的地址
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_tx_reserve(uart_handle_t handle, uint32_t len, uint8_t **buffer)
+{
+    esp32_uart_handle_t *esp32_handle = (esp32_uart_handle_t *)handle;
+    
+    if (handle == NULL || !esp32_handle->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    switch (uart_tx_coalesce_reserve(&esp32_handle->tx, len, buffer)) {
+        case UART_TX_COALESCE_OK:
+            return ERROR_NONE;
+        case UART_TX_COALESCE_FULL:
+            return ERROR_BUSY;
+        default:
+            return ERROR_INVALID_PARAM;
+    }
+}
+
+/**
+ * @brief 提交预留的发送空间
+ * 
+ * @param handle UART设备句柄
+ * @param buffer uart_tx_reserve返回的地址
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_tx_commit(uart_handle_t handle, uint8_t *buffer)
+{
+    esp32_uart_handle_t *esp32_handle = (esp32_uart_handle_t *)handle;
+    
+    if (handle == NULL || !esp32_handle->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    return uart_tx_coalesce_commit(&esp32_handle->tx, buffer) == UART_TX_COALESCE_OK ? ERROR_NONE : ERROR_INVALID_PARAM;
+}
+
+/**
+ * @brief 立即发送已合并的数据
+ * 
+ * @param handle UART设备句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_tx_flush(uart_handle_t handle)
+{
+    esp32_uart_handle_t *esp32_handle = (esp32_uart_handle_t *)handle;
+    
+    if (handle == NULL || !esp32_handle->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    uart_tx_coalesce_flush(&esp32_handle->tx);
+    
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 设置发送合并策略
+ * 
+ * @param handle UART设备句柄
+ * @param threshold 刷新阈值（字节）
+ * @param timeout_ms 刷新超时（毫秒）
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_tx_set_policy(uart_handle_t handle, uint32_t threshold, uint32_t timeout_ms)
+{
+    esp32_uart_handle_t *esp32_handle = (esp32_uart_handle_t *)handle;
+    
+    if (handle == NULL || !esp32_handle->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    return uart_tx_coalesce_set_policy(&esp32_handle->tx, threshold, timeout_ms) == UART_TX_COALESCE_OK ?
+           ERROR_NONE : ERROR_INVALID_PARAM;
+}
+
+/**
+ * @brief UART发送数据
+ * 
+ * 经发送合并器写入并刷新，阻塞到数据全部发出
+ * 
+ * @param handle UART设备句柄
+ * @param data 数据缓冲区
  * @param len 数据长度
  * @param timeout_ms 超时时间（毫秒）
- * @return int 成功发送的字节数，负值表示错?
+ * @return int 成功发送的字节数，负值表示错误
  */
 int uart_transmit(uart_handle_t handle, const uint8_t *data, uint32_t len, uint32_t timeout_ms)
 {
     esp32_uart_handle_t *esp32_handle = (esp32_uart_handle_t *)handle;
-    int sent_len;
+    TickType_t start_tick = xTaskGetTickCount();
+    TickType_t timeout_ticks = pdMS_TO_TICKS(timeout_ms);
+    int written;
     
-    /* 参数检?*/
-    if (handle == NULL || data == NULL || len == 0) {
+    /* 参数检查 */
+    if (handle == NULL || data == NULL || len == 0 || !esp32_handle->initialized) {
         return ERROR_INVALID_PARAM;
     }
     
-    /* 检查句柄是否有?*/
-    if (!esp32_handle->initialized) {
-        return ERROR_INVALID_PARAM;
+    written = uart_write(handle, data, len, timeout_ms);
+    uart_tx_coalesce_flush(&esp32_handle->tx);
+    
+    /* 其他任务正在写入驱动时，本次数据在其完成后接续写入 */
+    while (!uart_tx_coalesce_idle(&esp32_handle->tx)) {
+        if ((xTaskGetTickCount() - start_tick) >= timeout_ticks) {
+            return ERROR_TIMEOUT;
+        }
+        vTaskDelay(1);
     }
     
-    /* 发送数?*/
-    sent_len = uart_write_bytes(esp32_handle->port, (const char *)data, len);
-    if (sent_len < 0) {
-        ESP_LOGE(TAG, "UART write failed");
-        return ERROR_HARDWARE;
+    if (written != (int)len) {
+        return ERROR_TIMEOUT;
     }
     
-    /* 等待发送完?*/
-    if (uart_wait_tx_done(esp32_handle->port, pdMS_TO_TICKS(timeout_ms)) != ESP_OK) {
+    /* 等待发送完成 */
+    TickType_t elapsed = xTaskGetTickCount() - start_tick;
+    if (uart_wait_tx_done(esp32_handle->port, elapsed < timeout_ticks ? timeout_ticks - elapsed : 0) != ESP_OK) {
         ESP_LOGE(TAG, "UART TX timeout");
         return ERROR_TIMEOUT;
     }
     
-    return sent_len;
+    return (int)len;
 }
 
 /**
@@ -469,6 +813,83 @@ int uart_register_rx_callback(uart_handle_t handle, uart_rx_callback_t callback,
     return ERROR_NONE;
 }
 
+/**
+ * @brief 注册UART接收数据段回调函数
+ * 
+ * @param handle UART设备句柄
+ * @param callback 回调函数，NULL表示注销
+ * @param user_data 用户数据
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_register_rx_span_callback(uart_handle_t handle, uart_rx_span_callback_t callback, void *user_data)
+{
+    esp32_uart_handle_t *esp32_handle = (esp32_uart_handle_t *)handle;
+    
+    if (handle == NULL || !esp32_handle->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    esp32_handle->span_callback = NULL;
+    esp32_handle->span_user_data = user_data;
+    __atomic_store_n(&esp32_handle->span_callback, callback, __ATOMIC_RELEASE);
+    
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 归还已处理的接收数据
+ * 
+ * @param handle UART设备句柄
+ * @param length 归还的字节数
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_rx_release(uart_handle_t handle, uint32_t length)
+{
+    esp32_uart_handle_t *esp32_handle = (esp32_uart_handle_t *)handle;
+    uint32_t pending;
+    
+    if (handle == NULL || !esp32_handle->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    pending = uart_rx_pending(esp32_handle);
+    if (length > pending) {
+        length = pending;
+    }
+    
+    __atomic_store_n(&esp32_handle->rx_tail, esp32_handle->rx_tail + length, __ATOMIC_RELEASE);
+    
+    /* 有数据因空间不足留在驱动缓冲区时，通知接收任务继续读出 */
+    if (length > 0 && __atomic_exchange_n(&esp32_handle->rx_deferred, false, __ATOMIC_ACQ_REL)) {
+        uart_event_t event = { .type = UART_DATA };
+        
+        xQueueSend(esp32_handle->uart_queue, &event, 0);
+    }
+    
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 获取UART接收统计信息
+ * 
+ * @param handle UART设备句柄
+ * @param stats 统计信息输出
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_get_rx_stats(uart_handle_t handle, uart_rx_stats_t *stats)
+{
+    esp32_uart_handle_t *esp32_handle = (esp32_uart_handle_t *)handle;
+    
+    if (handle == NULL || !esp32_handle->initialized || stats == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+    
+    uart_rx_pending(esp32_handle);
+    *stats = esp32_handle->rx_stats;
+    
+    return ERROR_NONE;
+}
+
 /**
  * @brief 获取UART接收缓冲区中可读取的数据长度
  * 
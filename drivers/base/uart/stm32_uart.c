@@ -0,0 +1,1144 @@
+/**
+ * @file stm32_uart.c
+ * @brief STM32平台UART驱动实现
+ *
+ * 接收采用循环DMA：DMA持续写入每个实例的环形缓冲区，空闲线、半传输和
+ * 传输完成中断根据DMA写位置发布新到达的数据段(offset, length)，
+ * 不产生逐字节中断，也不经过中间缓冲区复制。
+ *
+ * 发送采用双缓冲合并：小块写入追加到填充缓冲区，另一个缓冲区由DMA发送，
+ * 达到阈值、超时或显式刷新时交换，DMA完成中断中接续发送积累的数据
+ */
+
+#include "base/uart_api.h"
+#include "base/dma_api.h"
+#include "base/uart_tx_coalesce_api.h"
+#include "common/error_api.h"
+#include "stm32_platform.h"
+#include <string.h>
+
+#if (CURRENT_RTOS != RTOS_NONE)
+#include "common/rtos_api.h"
+#endif
+
+/* 私有定义 */
+#define STM32_UART_MAX_INSTANCES    4   /* USART1、USART2、USART3、UART4 */
+
+/* 接收DMA环形缓冲区大小，必须为2的幂 */
+#ifndef CONFIG_UART_RX_DMA_BUF_SIZE
+#define CONFIG_UART_RX_DMA_BUF_SIZE 1024
+#endif
+
+#if (CONFIG_UART_RX_DMA_BUF_SIZE & (CONFIG_UART_RX_DMA_BUF_SIZE - 1)) != 0
+#error "CONFIG_UART_RX_DMA_BUF_SIZE must be a power of two"
+#endif
+
+#define STM32_UART_RX_BUF_MASK      (CONFIG_UART_RX_DMA_BUF_SIZE - 1)
+
+/* D-Cache行大小，F7为32字节；接收缓冲区按缓存行对齐，作废时不会波及相邻字段 */
+#define STM32_UART_DCACHE_LINE_SIZE 32U
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U) && \
+    (CONFIG_UART_RX_DMA_BUF_SIZE < STM32_UART_DCACHE_LINE_SIZE)
+#error "CONFIG_UART_RX_DMA_BUF_SIZE must be at least one D-Cache line"
+#endif
+
+/* UART中断优先级 */
+#ifndef CONFIG_UART_IRQ_PRIORITY
+#define CONFIG_UART_IRQ_PRIORITY    6
+#endif
+
+/* UART硬件资源映射 */
+typedef struct {
+    USART_TypeDef *instance;    /* 外设实例 */
+    IRQn_Type irq;              /* 外设中断号 */
+    uint32_t rx_stream;         /* 接收DMA数据流，0-7为DMA1，8-15为DMA2 */
+    uint32_t tx_stream;         /* 发送DMA数据流 */
+    uint32_t request;           /* DMA请求通道 */
+} stm32_uart_hw_t;
+
+/* 参考STM32F4 DMA请求映射表 */
+static const stm32_uart_hw_t uart_hw[STM32_UART_MAX_INSTANCES] = {
+    [UART_CHANNEL_0] = { USART1, USART1_IRQn, 10, 15, DMA_CHANNEL_4 },   /* DMA2 Stream2/Stream7 */
+    [UART_CHANNEL_1] = { USART2, USART2_IRQn, 5,  6,  DMA_CHANNEL_4 },   /* DMA1 Stream5/Stream6 */
+    [UART_CHANNEL_2] = { USART3, USART3_IRQn, 1,  3,  DMA_CHANNEL_4 },   /* DMA1 Stream1/Stream3 */
+    [UART_CHANNEL_3] = { UART4,  UART4_IRQn,  2,  4,  DMA_CHANNEL_4 }    /* DMA1 Stream2/Stream4 */
+};
+
+/* STM32 UART设备数据结构 */
+typedef struct {
+    UART_HandleTypeDef huart;                   /* HAL UART句柄 */
+    uart_channel_t channel;                     /* UART通道 */
+    bool initialized;                           /* 初始化标志 */
+    uart_rx_callback_t rx_callback;             /* 接收回调函数 */
+    void *user_data;                            /* 接收回调用户数据 */
+    uart_rx_span_callback_t span_callback;      /* 接收数据段回调函数 */
+    void *span_user_data;                       /* 数据段回调用户数据 */
+    dma_handle_t dma_rx;                        /* 接收DMA句柄 */
+    uint32_t rx_dma_pos;                        /* 上次处理时的DMA写偏移 */
+    volatile uint32_t rx_head;                  /* 累计到达字节数，仅由中断推进 */
+    volatile uint32_t rx_tail;                  /* 累计归还字节数，仅由使用者推进 */
+    uint32_t rx_overrun_mark;                   /* 已计入覆盖统计的位置，在中断锁下修改 */
+    uart_rx_stats_t rx_stats;                   /* 接收统计信息 */
+    dma_handle_t dma_tx;                        /* 发送DMA句柄 */
+    uart_tx_coalesce_t tx;                      /* 发送合并器 */
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_sem_t rx_sem;                          /* 新数据到达通知 */
+    rtos_sem_t tx_sem;                          /* 发送完成通知 */
+#endif
+    uint8_t rx_buf[CONFIG_UART_RX_DMA_BUF_SIZE] __attribute__((aligned(STM32_UART_DCACHE_LINE_SIZE))); /* 接收DMA环形缓冲区 */
+} stm32_uart_t;
+
+/* UART设备实例 */
+static stm32_uart_t uart_instances[STM32_UART_MAX_INSTANCES];
+
+/**
+ * @brief 初始化UART GPIO及外设时钟
+ *
+ * @param channel UART通道
+ * @return int 0表示成功，非0表示失败
+ */
+static int init_uart_gpio(uart_channel_t channel)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+
+    switch (channel) {
+        case UART_CHANNEL_0:
+            /* USART1 GPIO Configuration: PA9(TX), PA10(RX) */
+            __HAL_RCC_GPIOA_CLK_ENABLE();
+            GPIO_InitStruct.Pin = GPIO_PIN_9 | GPIO_PIN_10;
+            GPIO_InitStruct.Alternate = GPIO_AF7_USART1;
+            HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+            __HAL_RCC_USART1_CLK_ENABLE();
+            break;
+
+        case UART_CHANNEL_1:
+            /* USART2 GPIO Configuration: PA2(TX), PA3(RX) */
+            __HAL_RCC_GPIOA_CLK_ENABLE();
+            GPIO_InitStruct.Pin = GPIO_PIN_2 | GPIO_PIN_3;
+            GPIO_InitStruct.Alternate = GPIO_AF7_USART2;
+            HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+            __HAL_RCC_USART2_CLK_ENABLE();
+            break;
+
+        case UART_CHANNEL_2:
+            /* USART3 GPIO Configuration: PB10(TX), PB11(RX) */
+            __HAL_RCC_GPIOB_CLK_ENABLE();
+            GPIO_InitStruct.Pin = GPIO_PIN_10 | GPIO_PIN_11;
+            GPIO_InitStruct.Alternate = GPIO_AF7_USART3;
+            HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+            __HAL_RCC_USART3_CLK_ENABLE();
+            break;
+
+        case UART_CHANNEL_3:
+            /* UART4 GPIO Configuration: PA0(TX), PA1(RX) */
+            __HAL_RCC_GPIOA_CLK_ENABLE();
+            GPIO_InitStruct.Pin = GPIO_PIN_0 | GPIO_PIN_1;
+            GPIO_InitStruct.Alternate = GPIO_AF8_UART4;
+            HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+            __HAL_RCC_UART4_CLK_ENABLE();
+            break;
+
+        default:
+            return ERROR_INVALID_PARAM;
+    }
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 将抽象校验位转换为CR1校验位配置
+ *
+ * HAL的UART_PARITY_*宏与抽象层枚举同名，这里按枚举值转换
+ *
+ * @param parity 抽象校验位
+ * @return uint32_t HAL校验位配置
+ */
+static uint32_t convert_parity(uart_parity_t parity)
+{
+    switch ((int)parity) {
+        case 1:     /* 奇校验 */
+            return USART_CR1_PCE | USART_CR1_PS;
+        case 2:     /* 偶校验 */
+            return USART_CR1_PCE;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief 将抽象流控转换为HAL流控
+ *
+ * @param flow_control 抽象流控
+ * @return uint32_t HAL流控
+ */
+static uint32_t convert_flow_control(uart_flow_control_t flow_control)
+{
+    switch (flow_control) {
+        case UART_FLOW_CONTROL_RTS:
+            return UART_HWCONTROL_RTS;
+        case UART_FLOW_CONTROL_CTS:
+            return UART_HWCONTROL_CTS;
+        case UART_FLOW_CONTROL_RTS_CTS:
+            return UART_HWCONTROL_RTS_CTS;
+        default:
+            return UART_HWCONTROL_NONE;
+    }
+}
+
+/**
+ * @brief 获取波特率
+ *
+ * @param config UART配置参数
+ * @return uint32_t 波特率
+ */
+static uint32_t get_baudrate(const uart_config_t *config)
+{
+    if (config->baudrate == UART_BAUDRATE_CUSTOM) {
+        return config->custom_baudrate;
+    } else {
+        return (uint32_t)config->baudrate;
+    }
+}
+
+/**
+ * @brief 关闭中断并返回之前的中断状态
+ */
+static inline uint32_t uart_irq_lock(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+/**
+ * @brief 恢复中断状态
+ */
+static inline void uart_irq_unlock(uint32_t primask)
+{
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 作废接收环形缓冲区中一段数据所在的D-Cache行
+ *
+ * 环形缓冲区只由DMA写入，缓存中没有脏行，作废只会丢弃DMA写入前缓存的旧数据
+ *
+ * @param dev UART设备
+ * @param offset 数据段偏移
+ * @param length 数据段长度，不跨越缓冲区末尾
+ */
+static inline void uart_rx_dcache_invalidate(stm32_uart_t *dev, uint32_t offset, uint32_t length)
+{
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    uint32_t start = offset & ~(STM32_UART_DCACHE_LINE_SIZE - 1U);
+
+    SCB_InvalidateDCache_by_Addr((uint32_t *)&dev->rx_buf[start], (int32_t)(offset + length - start));
+#else
+    (void)dev;
+    (void)offset;
+    (void)length;
+#endif
+}
+
+/**
+ * @brief 统计被DMA覆盖的未归还数据
+ *
+ * 位置tail之后、floor之前且尚未统计过的字节计入overrun，
+ * 接收中断和读取路径都可能发现同一段覆盖，按统计标记去重
+ *
+ * @param dev UART设备
+ * @param tail 使用者的归还位置
+ * @param floor 环形缓冲区中仍然有效的最早位置
+ */
+static void uart_rx_count_overrun(stm32_uart_t *dev, uint32_t tail, uint32_t floor)
+{
+    uint32_t primask = uart_irq_lock();
+    uint32_t from = tail;
+
+    if ((int32_t)(dev->rx_overrun_mark - from) > 0) {
+        from = dev->rx_overrun_mark;
+    }
+
+    if ((int32_t)(floor - from) > 0) {
+        dev->rx_stats.overrun += floor - from;
+        dev->rx_overrun_mark = floor;
+    }
+
+    uart_irq_unlock(primask);
+}
+
+/**
+ * @brief 获取DMA已写入的累计字节数，包括尚未发布的部分
+ *
+ * @param dev UART设备
+ * @return uint32_t 累计写入位置
+ */
+static uint32_t uart_rx_dma_written(stm32_uart_t *dev)
+{
+    uint32_t remaining = 0;
+    uint32_t primask = uart_irq_lock();
+    uint32_t written = dev->rx_head;
+
+    if (dma_get_remaining(dev->dma_rx, &remaining) == DRIVER_OK) {
+        written += ((CONFIG_UART_RX_DMA_BUF_SIZE - remaining) - dev->rx_dma_pos) & STM32_UART_RX_BUF_MASK;
+    }
+
+    uart_irq_unlock(primask);
+
+    return written;
+}
+
+/**
+ * @brief 发布一个新到达的数据段
+ *
+ * @param dev UART设备
+ * @param offset 数据段在环形缓冲区中的偏移
+ * @param length 数据段长度
+ */
+static void uart_rx_publish(stm32_uart_t *dev, uint32_t offset, uint32_t length)
+{
+    uart_rx_dcache_invalidate(dev, offset, length);
+
+    dev->rx_stats.received += length;
+    __atomic_store_n(&dev->rx_head, dev->rx_head + length, __ATOMIC_RELEASE);
+
+    if (dev->span_callback != NULL) {
+        dev->span_callback(dev->rx_buf, offset, length, dev->span_user_data);
+    } else if (dev->rx_callback != NULL) {
+        /* 旧接口直接引用环形缓冲区内的数据，回调返回即视为处理完毕 */
+        dev->rx_callback(&dev->rx_buf[offset], length, dev->user_data);
+        uart_rx_release((uart_handle_t)dev, length);
+    }
+}
+
+/**
+ * @brief 根据DMA写位置发布自上次处理以来到达的数据
+ *
+ * 在空闲线、半传输和传输完成中断中调用
+ *
+ * @param dev UART设备
+ */
+static void uart_rx_dma_update(stm32_uart_t *dev)
+{
+    uint32_t remaining = 0;
+    uint32_t pos;
+
+    if (dma_get_remaining(dev->dma_rx, &remaining) != DRIVER_OK) {
+        return;
+    }
+
+    /* 循环模式下计数到0后立即重装，读到0时按缓冲区末尾处理 */
+    pos = CONFIG_UART_RX_DMA_BUF_SIZE - remaining;
+    if (pos == dev->rx_dma_pos) {
+        return;
+    }
+
+    if (pos > dev->rx_dma_pos) {
+        uart_rx_publish(dev, dev->rx_dma_pos, pos - dev->rx_dma_pos);
+    } else {
+        /* DMA已回绕，分两段发布，保证每段在缓冲区内连续 */
+        uart_rx_publish(dev, dev->rx_dma_pos, CONFIG_UART_RX_DMA_BUF_SIZE - dev->rx_dma_pos);
+        if (pos > 0) {
+            uart_rx_publish(dev, 0, pos);
+        }
+    }
+
+    dev->rx_dma_pos = pos & STM32_UART_RX_BUF_MASK;
+
+    /*
+     * DMA循环写入无法暂停，半传输和传输完成中断之间最多写入半个缓冲区。
+     * 在这里比较写位置与归还位置，及时统计覆盖了未归还数据段的字节数
+     */
+    uart_rx_count_overrun(dev, __atomic_load_n(&dev->rx_tail, __ATOMIC_ACQUIRE),
+                          dev->rx_head - CONFIG_UART_RX_DMA_BUF_SIZE);
+
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_sem_give(dev->rx_sem);
+#endif
+}
+
+/**
+ * @brief 接收DMA回调，半传输和传输完成时发布数据
+ */
+static void uart_rx_dma_callback(void *arg, dma_status_t status)
+{
+    stm32_uart_t *dev = (stm32_uart_t *)arg;
+
+    if (status == DMA_STATUS_ERROR) {
+        dev->rx_stats.hw_errors++;
+        return;
+    }
+
+    uart_rx_dma_update(dev);
+}
+
+/**
+ * @brief UART中断处理，只处理空闲线和错误
+ *
+ * @param dev UART设备
+ */
+static void stm32_uart_irq_handler(stm32_uart_t *dev)
+{
+    USART_TypeDef *usart = dev->huart.Instance;
+    uint32_t sr = usart->SR;
+
+    if (!dev->initialized) {
+        return;
+    }
+
+    /* 先读SR再读DR清除空闲和错误标志 */
+    if (sr & (USART_SR_IDLE | USART_SR_ORE | USART_SR_FE | USART_SR_NE | USART_SR_PE)) {
+        (void)usart->DR;
+    }
+
+    if (sr & (USART_SR_ORE | USART_SR_FE | USART_SR_NE | USART_SR_PE)) {
+        dev->rx_stats.hw_errors++;
+    }
+
+    if (sr & USART_SR_IDLE) {
+        uart_rx_dma_update(dev);
+    }
+}
+
+/**
+ * @brief 启动循环DMA接收
+ *
+ * @param dev UART设备
+ * @return int 0表示成功，非0表示失败
+ */
+static int uart_rx_dma_start(stm32_uart_t *dev)
+{
+    const stm32_uart_hw_t *hw = &uart_hw[dev->channel];
+    USART_TypeDef *usart = dev->huart.Instance;
+    dma_config_t dma_config;
+
+    memset(&dma_config, 0, sizeof(dma_config));
+    dma_config.direction = DMA_DIR_PERIPH_TO_MEM;
+    dma_config.mode = DMA_MODE_CIRCULAR;
+    dma_config.priority = DMA_PRIORITY_VERY_HIGH;
+    dma_config.src_width = DMA_DATA_WIDTH_8BIT;
+    dma_config.dst_width = DMA_DATA_WIDTH_8BIT;
+    dma_config.src_inc = false;
+    dma_config.dst_inc = true;
+    dma_config.src_addr = (uint32_t)&usart->DR;
+    dma_config.dst_addr = (uint32_t)dev->rx_buf;
+    dma_config.data_size = CONFIG_UART_RX_DMA_BUF_SIZE;
+
+    if (dma_alloc(1U << hw->rx_stream, DMA_REQUEST_ID(DMA_REQUEST_UART_RX, dev->channel), &dma_config,
+                  uart_rx_dma_callback, dev, &dev->dma_rx) != DRIVER_OK) {
+        return ERROR_BUSY;
+    }
+
+    dma_set_request_line(dev->dma_rx, hw->request);
+    dma_enable_interrupt(dev->dma_rx);
+    dma_set_half_transfer_interrupt(dev->dma_rx, true);
+
+    if (dma_start(dev->dma_rx) != DRIVER_OK) {
+        dma_deinit(dev->dma_rx);
+        return ERROR_HARDWARE;
+    }
+
+    dma_enable_irq(dev->dma_rx, CONFIG_UART_IRQ_PRIORITY);
+
+    /* 清除残留标志后使能空闲线中断、错误中断和DMA接收请求 */
+    (void)usart->SR;
+    (void)usart->DR;
+    SET_BIT(usart->CR1, USART_CR1_IDLEIE);
+    SET_BIT(usart->CR3, USART_CR3_EIE | USART_CR3_DMAR);
+
+    HAL_NVIC_SetPriority(hw->irq, CONFIG_UART_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(hw->irq);
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 发送合并器临界区，与发送DMA完成中断互斥
+ */
+static uint32_t uart_tx_lock(void *ctx)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    (void)ctx;
+    __disable_irq();
+
+    return primask;
+}
+
+static void uart_tx_unlock(void *ctx, uint32_t key)
+{
+    (void)ctx;
+    __set_PRIMASK(key);
+}
+
+static uint32_t uart_tx_now_ms(void)
+{
+    return HAL_GetTick();
+}
+
+/**
+ * @brief 启动一次发送DMA
+ *
+ * @param ctx UART设备
+ * @param data 发送缓冲区
+ * @param len 发送长度
+ * @return int 0表示成功，非0表示失败
+ */
+static int uart_tx_dma_start(void *ctx, const uint8_t *data, uint32_t len)
+{
+    stm32_uart_t *dev = (stm32_uart_t *)ctx;
+
+    if (!dev->initialized) {
+        return ERROR_NOT_INITIALIZED;
+    }
+
+    dma_set_src_address(dev->dma_tx, (uint32_t)data);
+    dma_set_data_size(dev->dma_tx, len);
+    dma_enable_interrupt(dev->dma_tx);
+
+    if (dma_start(dev->dma_tx) != DRIVER_OK) {
+        return ERROR_HARDWARE;
+    }
+
+    return ERROR_NONE;
+}
+
+static const uart_tx_coalesce_ops_t uart_tx_ops = {
+    .start = uart_tx_dma_start,
+    .lock = uart_tx_lock,
+    .unlock = uart_tx_unlock,
+    .now_ms = uart_tx_now_ms
+};
+
+/**
+ * @brief 发送DMA回调，释放已发送的缓冲区并接续发送
+ */
+static void uart_tx_dma_callback(void *arg, dma_status_t status)
+{
+    stm32_uart_t *dev = (stm32_uart_t *)arg;
+
+    if (status == DMA_STATUS_HALF) {
+        return;
+    }
+
+    uart_tx_coalesce_complete(&dev->tx);
+
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_sem_give(dev->tx_sem);
+#endif
+}
+
+/**
+ * @brief 分配发送DMA并使能DMA发送请求
+ *
+ * @param dev UART设备
+ * @return int 0表示成功，非0表示失败
+ */
+static int uart_tx_dma_setup(stm32_uart_t *dev)
+{
+    const stm32_uart_hw_t *hw = &uart_hw[dev->channel];
+    USART_TypeDef *usart = dev->huart.Instance;
+    dma_config_t dma_config;
+
+    memset(&dma_config, 0, sizeof(dma_config));
+    dma_config.direction = DMA_DIR_MEM_TO_PERIPH;
+    dma_config.mode = DMA_MODE_NORMAL;
+    dma_config.priority = DMA_PRIORITY_MEDIUM;
+    dma_config.src_width = DMA_DATA_WIDTH_8BIT;
+    dma_config.dst_width = DMA_DATA_WIDTH_8BIT;
+    dma_config.src_inc = true;
+    dma_config.dst_inc = false;
+    dma_config.src_addr = (uint32_t)dev->tx.buf[0];
+    dma_config.dst_addr = (uint32_t)&usart->DR;
+    dma_config.data_size = 1;
+
+    if (dma_alloc(1U << hw->tx_stream, DMA_REQUEST_ID(DMA_REQUEST_UART_TX, dev->channel), &dma_config,
+                  uart_tx_dma_callback, dev, &dev->dma_tx) != DRIVER_OK) {
+        return ERROR_BUSY;
+    }
+
+    dma_set_request_line(dev->dma_tx, hw->request);
+    dma_enable_irq(dev->dma_tx, CONFIG_UART_IRQ_PRIORITY);
+
+    uart_tx_coalesce_init(&dev->tx, &uart_tx_ops, dev);
+    SET_BIT(usart->CR3, USART_CR3_DMAT);
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 等待发送进展
+ *
+ * @param dev UART设备
+ * @param start_time 开始时间
+ * @param timeout_ms 超时时间（毫秒）
+ * @return bool true表示已超时
+ */
+static bool uart_tx_wait(stm32_uart_t *dev, uint32_t start_time, uint32_t timeout_ms)
+{
+    uint32_t elapsed = HAL_GetTick() - start_time;
+
+    if (elapsed >= timeout_ms) {
+        return true;
+    }
+
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_sem_take(dev->tx_sem, timeout_ms == UINT32_MAX ? UINT32_MAX : timeout_ms - elapsed);
+#else
+    (void)dev;
+    __WFI();
+#endif
+
+    return false;
+}
+
+/**
+ * @brief 初始化UART
+ *
+ * @param config UART配置参数
+ * @param handle UART设备句柄指针
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_init(const uart_config_t *config, uart_handle_t *handle)
+{
+    stm32_uart_t *dev;
+    UART_HandleTypeDef *huart;
+    uint32_t parity;
+    int ret;
+
+    /* 参数检查 */
+    if (config == NULL || handle == NULL || config->channel >= STM32_UART_MAX_INSTANCES) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    dev = &uart_instances[config->channel];
+    if (dev->initialized) {
+        return ERROR_BUSY;
+    }
+
+    memset(dev, 0, sizeof(stm32_uart_t));
+    dev->channel = config->channel;
+
+    ret = init_uart_gpio(config->channel);
+    if (ret != ERROR_NONE) {
+        return ret;
+    }
+
+    /* 配置UART参数，带校验位时字长包含校验位 */
+    parity = convert_parity(config->parity);
+    huart = &dev->huart;
+    huart->Instance = uart_hw[config->channel].instance;
+    huart->Init.BaudRate = get_baudrate(config);
+    huart->Init.WordLength = (config->data_bits == UART_DATA_BITS_9 ||
+                              (config->data_bits == UART_DATA_BITS_8 && parity != 0)) ?
+                             UART_WORDLENGTH_9B : UART_WORDLENGTH_8B;
+    huart->Init.StopBits = (config->stop_bits == UART_STOP_BITS_2) ? UART_STOPBITS_2 : UART_STOPBITS_1;
+    huart->Init.Parity = parity;
+    huart->Init.Mode = UART_MODE_TX_RX;
+    huart->Init.HwFlowCtl = convert_flow_control(config->flow_control);
+    huart->Init.OverSampling = UART_OVERSAMPLING_16;
+
+    if (HAL_UART_Init(huart) != HAL_OK) {
+        return ERROR_HARDWARE;
+    }
+
+#if (CURRENT_RTOS != RTOS_NONE)
+    if (rtos_sem_create(&dev->rx_sem, 0, 1) != 0) {
+        HAL_UART_DeInit(huart);
+        return ERROR_MEMORY;
+    }
+
+    if (rtos_sem_create(&dev->tx_sem, 0, 1) != 0) {
+        rtos_sem_delete(dev->rx_sem);
+        HAL_UART_DeInit(huart);
+        return ERROR_MEMORY;
+    }
+#endif
+
+#if defined(CONFIG_TIMER_WHEEL_ENABLED) && CONFIG_TIMER_WHEEL_ENABLED
+    /* 发送合并的超时刷新由时间轮定时器执行，已初始化时直接返回 */
+    timer_wheel_init(0);
+#endif
+
+    /* 接收环形缓冲区在中断中发布数据前必须已标记为可用 */
+    dev->initialized = true;
+
+    ret = uart_tx_dma_setup(dev);
+    if (ret == ERROR_NONE) {
+        ret = uart_rx_dma_start(dev);
+        if (ret != ERROR_NONE) {
+            CLEAR_BIT(huart->Instance->CR3, USART_CR3_DMAT);
+            uart_tx_coalesce_deinit(&dev->tx);
+            dma_deinit(dev->dma_tx);
+        }
+    }
+
+    if (ret != ERROR_NONE) {
+        dev->initialized = false;
+#if (CURRENT_RTOS != RTOS_NONE)
+        rtos_sem_delete(dev->rx_sem);
+        rtos_sem_delete(dev->tx_sem);
+#endif
+        HAL_UART_DeInit(huart);
+        return ret;
+    }
+
+    *handle = (uart_handle_t)dev;
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 去初始化UART
+ *
+ * @param handle UART设备句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_deinit(uart_handle_t handle)
+{
+    stm32_uart_t *dev = (stm32_uart_t *)handle;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    HAL_NVIC_DisableIRQ(uart_hw[dev->channel].irq);
+    CLEAR_BIT(dev->huart.Instance->CR1, USART_CR1_IDLEIE);
+    CLEAR_BIT(dev->huart.Instance->CR3, USART_CR3_EIE | USART_CR3_DMAR | USART_CR3_DMAT);
+
+    dev->initialized = false;
+    dma_stop(dev->dma_tx);
+    uart_tx_coalesce_deinit(&dev->tx);
+    dma_deinit(dev->dma_tx);
+    dma_deinit(dev->dma_rx);
+
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_sem_delete(dev->rx_sem);
+    rtos_sem_delete(dev->tx_sem);
+#endif
+
+    if (HAL_UART_DeInit(&dev->huart) != HAL_OK) {
+        return ERROR_HARDWARE;
+    }
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 合并写入UART发送缓冲区
+ *
+ * @param handle UART设备句柄
+ * @param data 数据缓冲区
+ * @param len 数据长度
+ * @param timeout_ms 等待发送缓冲区空间的超时时间（毫秒）
+ * @return int 写入的字节数，负值表示错误
+ */
+int uart_write(uart_handle_t handle, const uint8_t *data, uint32_t len, uint32_t timeout_ms)
+{
+    stm32_uart_t *dev = (stm32_uart_t *)handle;
+    uint32_t start_time = HAL_GetTick();
+    uint32_t written = 0;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || data == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    while (1) {
+        written += (uint32_t)uart_tx_coalesce_write(&dev->tx, &data[written], len - written);
+
+        if (written == len || uart_tx_wait(dev, start_time, timeout_ms)) {
+            break;
+        }
+    }
+
+    return (int)written;
+}
+
+/**
+ * @brief 在发送缓冲区中预留空间
+ *
+ * @param handle UART设备句柄
+ * @param len 预留长度
+ * @param buffer 返回预留空间的地址
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_tx_reserve(uart_handle_t handle, uint32_t len, uint8_t **buffer)
+{
+    stm32_uart_t *dev = (stm32_uart_t *)handle;
+
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    switch (uart_tx_coalesce_reserve(&dev->tx, len, buffer)) {
+        case UART_TX_COALESCE_OK:
+            return ERROR_NONE;
+        case UART_TX_COALESCE_FULL:
+            return ERROR_BUSY;
+        default:
+            return ERROR_INVALID_PARAM;
+    }
+}
+
+/**
+ * @brief 提交预留的发送空间
+ *
+ * @param handle UART设备句柄
+ * @param buffer uart_tx_reserve返回的地址
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_tx_commit(uart_handle_t handle, uint8_t *buffer)
+{
+    stm32_uart_t *dev = (stm32_uart_t *)handle;
+
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    return uart_tx_coalesce_commit(&dev->tx, buffer) == UART_TX_COALESCE_OK ? ERROR_NONE : ERROR_INVALID_PARAM;
+}
+
+/**
+ * @brief 立即发送已合并的数据
+ *
+ * @param handle UART设备句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_tx_flush(uart_handle_t handle)
+{
+    stm32_uart_t *dev = (stm32_uart_t *)handle;
+
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    uart_tx_coalesce_flush(&dev->tx);
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 设置发送合并策略
+ *
+ * @param handle UART设备句柄
+ * @param threshold 刷新阈值（字节）
+ * @param timeout_ms 刷新超时（毫秒）
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_tx_set_policy(uart_handle_t handle, uint32_t threshold, uint32_t timeout_ms)
+{
+    stm32_uart_t *dev = (stm32_uart_t *)handle;
+
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    return uart_tx_coalesce_set_policy(&dev->tx, threshold, timeout_ms) == UART_TX_COALESCE_OK ?
+           ERROR_NONE : ERROR_INVALID_PARAM;
+}
+
+/**
+ * @brief UART发送数据
+ *
+ * 经发送合并器写入并刷新，阻塞到数据全部移出发送移位寄存器
+ *
+ * @param handle UART设备句柄
+ * @param data 数据缓冲区
+ * @param len 数据长度
+ * @param timeout_ms 超时时间（毫秒）
+ * @return int 成功发送的字节数，负值表示错误
+ */
+int uart_transmit(uart_handle_t handle, const uint8_t *data, uint32_t len, uint32_t timeout_ms)
+{
+    stm32_uart_t *dev = (stm32_uart_t *)handle;
+    uint32_t start_time = HAL_GetTick();
+    int written;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || data == NULL || len == 0) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    written = uart_write(handle, data, len, timeout_ms);
+    uart_tx_coalesce_flush(&dev->tx);
+
+    if (written != (int)len) {
+        return ERROR_TIMEOUT;
+    }
+
+    /* DMA完成只表示最后一个字节已写入数据寄存器，还需等待发送完成标志 */
+    while (!uart_tx_coalesce_idle(&dev->tx) || !(dev->huart.Instance->SR & USART_SR_TC)) {
+        if (uart_tx_coalesce_idle(&dev->tx)) {
+            if (HAL_GetTick() - start_time >= timeout_ms) {
+                return ERROR_TIMEOUT;
+            }
+        } else if (uart_tx_wait(dev, start_time, timeout_ms)) {
+            return ERROR_TIMEOUT;
+        }
+    }
+
+    return (int)len;
+}
+
+/**
+ * @brief 获取未归还的接收字节数，同时跳过被覆盖的数据
+ *
+ * 覆盖的字节数已在接收中断中统计
+ *
+ * @param dev UART设备
+ * @return uint32_t 可读取的字节数
+ */
+static uint32_t uart_rx_pending(stm32_uart_t *dev)
+{
+    uint32_t head = __atomic_load_n(&dev->rx_head, __ATOMIC_ACQUIRE);
+    uint32_t pending = head - dev->rx_tail;
+
+    /* 使用者落后超过一整圈，最旧的数据已被DMA覆盖 */
+    if (pending > CONFIG_UART_RX_DMA_BUF_SIZE) {
+        uart_rx_count_overrun(dev, dev->rx_tail, head - CONFIG_UART_RX_DMA_BUF_SIZE);
+        __atomic_store_n(&dev->rx_tail, head - CONFIG_UART_RX_DMA_BUF_SIZE, __ATOMIC_RELEASE);
+        pending = CONFIG_UART_RX_DMA_BUF_SIZE;
+    }
+
+    return pending;
+}
+
+/**
+ * @brief UART接收数据
+ *
+ * 从接收环形缓冲区复制数据，直到收满len字节或超时
+ *
+ * @param handle UART设备句柄
+ * @param data 数据缓冲区
+ * @param len 数据长度
+ * @param timeout_ms 超时时间（毫秒）
+ * @return int 成功接收的字节数，负值表示错误
+ */
+int uart_receive(uart_handle_t handle, uint8_t *data, uint32_t len, uint32_t timeout_ms)
+{
+    stm32_uart_t *dev = (stm32_uart_t *)handle;
+    uint32_t start_time = HAL_GetTick();
+    uint32_t received = 0;
+
+    /* 参数检查 */
+    if (dev == NULL || !dev->initialized || data == NULL || len == 0) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    while (1) {
+        uint32_t pending = uart_rx_pending(dev);
+
+        while (pending > 0 && received < len) {
+            uint32_t offset = dev->rx_tail & STM32_UART_RX_BUF_MASK;
+            uint32_t chunk = CONFIG_UART_RX_DMA_BUF_SIZE - offset;
+
+            if (chunk > pending) {
+                chunk = pending;
+            }
+            if (chunk > len - received) {
+                chunk = len - received;
+            }
+
+            /* 拷贝前作废该段缓存行，读取DMA写入内存的数据 */
+            uart_rx_dcache_invalidate(dev, offset, chunk);
+            memcpy(&data[received], &dev->rx_buf[offset], chunk);
+
+            /* 拷贝期间DMA可能已写入该段，校验写位置，跳过被覆盖的部分后重新拷贝 */
+            uint32_t floor = uart_rx_dma_written(dev) - CONFIG_UART_RX_DMA_BUF_SIZE;
+            if ((int32_t)(floor - dev->rx_tail) > 0) {
+                uart_rx_count_overrun(dev, dev->rx_tail, floor);
+                __atomic_store_n(&dev->rx_tail, floor, __ATOMIC_RELEASE);
+                pending = uart_rx_pending(dev);
+                continue;
+            }
+
+            __atomic_store_n(&dev->rx_tail, dev->rx_tail + chunk, __ATOMIC_RELEASE);
+            received += chunk;
+            pending -= chunk;
+        }
+
+        uint32_t elapsed = HAL_GetTick() - start_time;
+        if (received == len || elapsed >= timeout_ms) {
+            break;
+        }
+
+#if (CURRENT_RTOS != RTOS_NONE)
+        rtos_sem_take(dev->rx_sem, timeout_ms == UINT32_MAX ? UINT32_MAX : timeout_ms - elapsed);
+#else
+        __WFI();
+#endif
+    }
+
+    return (int)received;
+}
+
+/**
+ * @brief 注册UART接收回调函数（中断模式）
+ *
+ * 回调参数直接指向接收环形缓冲区，回调返回后数据即被归还
+ *
+ * @param handle UART设备句柄
+ * @param callback 回调函数
+ * @param user_data 用户数据
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_register_rx_callback(uart_handle_t handle, uart_rx_callback_t callback, void *user_data)
+{
+    stm32_uart_t *dev = (stm32_uart_t *)handle;
+
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    /* 先清除回调，避免中断看到新旧参数混合 */
+    dev->rx_callback = NULL;
+    dev->user_data = user_data;
+    __atomic_store_n(&dev->rx_callback, callback, __ATOMIC_RELEASE);
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 注册UART接收数据段回调函数
+ *
+ * @param handle UART设备句柄
+ * @param callback 回调函数，NULL表示注销
+ * @param user_data 用户数据
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_register_rx_span_callback(uart_handle_t handle, uart_rx_span_callback_t callback, void *user_data)
+{
+    stm32_uart_t *dev = (stm32_uart_t *)handle;
+
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    dev->span_callback = NULL;
+    dev->span_user_data = user_data;
+    __atomic_store_n(&dev->span_callback, callback, __ATOMIC_RELEASE);
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 归还已处理的接收数据
+ *
+ * @param handle UART设备句柄
+ * @param length 归还的字节数
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_rx_release(uart_handle_t handle, uint32_t length)
+{
+    stm32_uart_t *dev = (stm32_uart_t *)handle;
+    uint32_t pending;
+
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    pending = uart_rx_pending(dev);
+    if (length > pending) {
+        length = pending;
+    }
+
+    __atomic_store_n(&dev->rx_tail, dev->rx_tail + length, __ATOMIC_RELEASE);
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 获取UART接收统计信息
+ *
+ * @param handle UART设备句柄
+ * @param stats 统计信息输出
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_get_rx_stats(uart_handle_t handle, uart_rx_stats_t *stats)
+{
+    stm32_uart_t *dev = (stm32_uart_t *)handle;
+
+    if (dev == NULL || !dev->initialized || stats == NULL) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    uart_rx_pending(dev);
+    *stats = dev->rx_stats;
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief 获取UART接收缓冲区中可读取的数据长度
+ *
+ * @param handle UART设备句柄
+ * @return int 可读取的数据长度，负值表示错误
+ */
+int uart_get_rx_data_size(uart_handle_t handle)
+{
+    stm32_uart_t *dev = (stm32_uart_t *)handle;
+
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    return (int)uart_rx_pending(dev);
+}
+
+/**
+ * @brief 清空UART接收缓冲区
+ *
+ * @param handle UART设备句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_flush_rx_buffer(uart_handle_t handle)
+{
+    stm32_uart_t *dev = (stm32_uart_t *)handle;
+
+    if (dev == NULL || !dev->initialized) {
+        return ERROR_INVALID_PARAM;
+    }
+
+    __atomic_store_n(&dev->rx_tail, __atomic_load_n(&dev->rx_head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+
+    return ERROR_NONE;
+}
+
+/**
+ * @brief USART1中断处理函数
+ */
+void USART1_IRQHandler(void)
+{
+    stm32_uart_irq_handler(&uart_instances[UART_CHANNEL_0]);
+}
+
+/**
+ * @brief USART2中断处理函数
+ */
+void USART2_IRQHandler(void)
+{
+    stm32_uart_irq_handler(&uart_instances[UART_CHANNEL_1]);
+}
+
+/**
+ * @brief USART3中断处理函数
+ */
+void USART3_IRQHandler(void)
+{
+    stm32_uart_irq_handler(&uart_instances[UART_CHANNEL_2]);
+}
+
+/**
+ * @brief UART4中断处理函数
+ */
+void UART4_IRQHandler(void)
+{
+    stm32_uart_irq_handler(&uart_instances[UART_CHANNEL_3]);
+}
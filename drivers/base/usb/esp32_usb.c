@@ -687,6 +687,56 @@ int usb_get_status(usb_handle_t handle, usb_status_t *status) {
     return 0;
 }
 
+/* USB流函数，TinyUSB的CDC和厂商类自带收发FIFO，ESP32上暂不提供流接口 */
+
+/**
+ * @brief 在批量或中断端点上打开流
+ */
+int usb_stream_open(usb_handle_t handle, const usb_stream_config_t *config) {
+    /* ESP32 USB流暂不支持 */
+    return -1;
+}
+
+/**
+ * @brief 关闭流
+ */
+int usb_stream_close(usb_handle_t handle, uint8_t ep_addr) {
+    /* ESP32 USB流暂不支持 */
+    return -1;
+}
+
+/**
+ * @brief 写入IN流
+ */
+int usb_stream_write(usb_handle_t handle, uint8_t ep_addr, const void *data, uint32_t length) {
+    /* ESP32 USB流暂不支持 */
+    return -1;
+}
+
+/**
+ * @brief 发送IN流中未写满的缓冲区
+ */
+int usb_stream_flush(usb_handle_t handle, uint8_t ep_addr) {
+    /* ESP32 USB流暂不支持 */
+    return -1;
+}
+
+/**
+ * @brief 读取OUT流
+ */
+int usb_stream_read(usb_handle_t handle, uint8_t ep_addr, void *data, uint32_t length) {
+    /* ESP32 USB流暂不支持 */
+    return -1;
+}
+
+/**
+ * @brief 获取流中可用的字节数
+ */
+int usb_stream_available(usb_handle_t handle, uint8_t ep_addr, uint32_t *bytes) {
+    /* ESP32 USB流暂不支持 */
+    return -1;
+}
+
 /* USB主机模式函数 */
 
 /**
@@ -11,6 +11,26 @@
 #define STM32_USB_MAX_ENDPOINTS    8  /* STM32 USB最大端点数 */
 #define STM32_USB_MAX_INSTANCES    2  /* STM32 USB最大实例数?*/
 
+/* 排队的传输请求 */
+typedef struct {
+    usb_transfer_t transfer;        /* 传输副本 */
+    usb_callback_t callback;        /* 完成回调，为NULL时使用端点回调 */
+    void *callback_arg;             /* 回调函数参数 */
+    bool zlp;                       /* 以整包结束时补发零长度包 */
+} stm32_usb_request_t;
+
+/* 端点上的流，缓冲区按环形顺序交给传输队列 */
+typedef struct {
+    usb_stream_config_t config;     /* 流配置 */
+    uint32_t lengths[CONFIG_USB_EP_QUEUE_DEPTH]; /* OUT方向各缓冲区收到的字节数 */
+    uint8_t current;                /* IN方向正在填充、OUT方向正在读取的缓冲区 */
+    uint8_t pending;                /* 已交给传输队列的缓冲区数 */
+    uint8_t ready;                  /* OUT方向收到数据待读取的缓冲区数 */
+    uint32_t offset;                /* 当前缓冲区已填充或已读取的字节数 */
+    bool unterminated;              /* IN方向上次刷新后发送过整缓冲区 */
+    bool open;                      /* 是否已打开 */
+} stm32_usb_stream_t;
+
 /* USB端点数据结构 */
 typedef struct {
     uint8_t ep_addr;                /* 端点地址 */
@@ -19,8 +39,12 @@ typedef struct {
     usb_callback_t callback;        /* 端点回调函数 */
     void *callback_arg;             /* 回调函数参数 */
     bool active;                    /* 激活状?*/
-    uint8_t *buffer;                /* 数据缓冲?*/
-    uint32_t buffer_size;           /* 缓冲区大?*/
+    bool auto_zlp;                  /* usb_transfer提交的IN传输以整包结束时补发零长度包 */
+    bool zlp_pending;               /* 正在发送零长度包 */
+    stm32_usb_request_t queue[CONFIG_USB_EP_QUEUE_DEPTH]; /* 传输队列，队首正在传输 */
+    uint8_t queue_head;             /* 队首位置 */
+    uint8_t queue_count;            /* 排队的传输数 */
+    stm32_usb_stream_t stream;      /* 端点上的流 */
 } stm32_usb_endpoint_t;
 
 /* USB设备数据结构 */
@@ -77,6 +101,139 @@ static int get_endpoint_index(stm32_usb_t *usb_dev, uint8_t ep_addr) {
     return -1;
 }
 
+/**
+ * @brief 关闭中断并返回之前的中断状态
+ */
+static inline uint32_t usb_irq_lock(void) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+/**
+ * @brief 恢复中断状态
+ */
+static inline void usb_irq_unlock(uint32_t primask) {
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 启动队首传输
+ */
+static void usb_ep_start(stm32_usb_t *usb_dev, stm32_usb_endpoint_t *ep) {
+    usb_transfer_t *transfer = &ep->queue[ep->queue_head].transfer;
+    uint8_t ep_num = ep->ep_addr & 0x7F;
+    
+    if (ep->ep_addr & 0x80) {
+        HAL_PCD_EP_Transmit(&usb_dev->hpcd, ep_num, transfer->buffer, transfer->length);
+    } else {
+        HAL_PCD_EP_Receive(&usb_dev->hpcd, ep_num, transfer->buffer, transfer->length);
+    }
+}
+
+/**
+ * @brief 调用传输完成回调
+ */
+static void usb_ep_notify(stm32_usb_endpoint_t *ep, stm32_usb_request_t *request, usb_status_t status) {
+    if (request->callback != NULL) {
+        request->callback(request->callback_arg, status, &request->transfer);
+    } else if (ep->callback != NULL) {
+        ep->callback(ep->callback_arg, status, &request->transfer);
+    }
+}
+
+/**
+ * @brief 传输请求加入端点队列，端点空闲时立即启动
+ */
+static int usb_ep_enqueue(stm32_usb_t *usb_dev, stm32_usb_endpoint_t *ep, const usb_transfer_t *transfer,
+                          usb_callback_t callback, void *arg, bool zlp) {
+    uint32_t primask = usb_irq_lock();
+    
+    if (ep->queue_count >= CONFIG_USB_EP_QUEUE_DEPTH) {
+        usb_irq_unlock(primask);
+        return -1;
+    }
+    
+    stm32_usb_request_t *request = &ep->queue[(ep->queue_head + ep->queue_count) % CONFIG_USB_EP_QUEUE_DEPTH];
+    request->transfer = *transfer;
+    request->transfer.actual_length = 0;
+    request->callback = callback;
+    request->callback_arg = arg;
+    request->zlp = zlp;
+    ep->queue_count++;
+    
+    if (ep->queue_count == 1 && !ep->zlp_pending) {
+        usb_ep_start(usb_dev, ep);
+    }
+    
+    usb_irq_unlock(primask);
+    return 0;
+}
+
+/**
+ * @brief 端点传输完成处理
+ *
+ * 先启动下一个排队的传输(或需要时的零长度包)再调用回调，使端点在回调期间不空闲
+ */
+static void usb_ep_complete(stm32_usb_t *usb_dev, stm32_usb_endpoint_t *ep, uint32_t actual_length) {
+    /* 零长度包发送完成，继续发送期间排队的传输 */
+    if (ep->zlp_pending) {
+        ep->zlp_pending = false;
+        if (ep->queue_count > 0) {
+            usb_ep_start(usb_dev, ep);
+        }
+        return;
+    }
+    
+    if (ep->queue_count == 0) {
+        return;
+    }
+    
+    stm32_usb_request_t request = ep->queue[ep->queue_head];
+    request.transfer.actual_length = actual_length;
+    ep->queue_head = (ep->queue_head + 1) % CONFIG_USB_EP_QUEUE_DEPTH;
+    ep->queue_count--;
+    
+    if (request.zlp && request.transfer.length > 0 && request.transfer.length % ep->max_packet_size == 0) {
+        /* 整包结束时主机无法判断传输结束，补发零长度包 */
+        ep->zlp_pending = true;
+        HAL_PCD_EP_Transmit(&usb_dev->hpcd, ep->ep_addr & 0x7F, NULL, 0);
+    } else if (ep->queue_count > 0) {
+        usb_ep_start(usb_dev, ep);
+    }
+    
+    usb_ep_notify(ep, &request, USB_STATUS_COMPLETE);
+}
+
+/**
+ * @brief 取消端点上排队的全部传输
+ *
+ * 先中止端点上正在进行的传输(端点回复NAK并停止传输)，再清空FIFO，
+ * 避免只刷新FIFO时控制器仍按原传输继续收发
+ */
+static void usb_ep_cancel(stm32_usb_t *usb_dev, stm32_usb_endpoint_t *ep) {
+    stm32_usb_request_t requests[CONFIG_USB_EP_QUEUE_DEPTH];
+    uint8_t count;
+    
+    uint32_t primask = usb_irq_lock();
+    count = ep->queue_count;
+    for (uint8_t i = 0; i < count; i++) {
+        requests[i] = ep->queue[(ep->queue_head + i) % CONFIG_USB_EP_QUEUE_DEPTH];
+    }
+    ep->queue_count = 0;
+    ep->zlp_pending = false;
+    usb_irq_unlock(primask);
+    
+    /* 中止传输后刷新端点，刷新按地址的方向位选择发送或接收FIFO */
+    HAL_PCD_EP_Abort(&usb_dev->hpcd, ep->ep_addr);
+    HAL_PCD_EP_Flush(&usb_dev->hpcd, ep->ep_addr);
+    
+    for (uint8_t i = 0; i < count; i++) {
+        requests[i].transfer.actual_length = 0;
+        usb_ep_notify(ep, &requests[i], USB_STATUS_ERROR);
+    }
+}
+
 /**
  * @brief USB设置阶段回调
  */
@@ -102,18 +259,8 @@ static void HAL_PCD_DataOutStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
     
     /* 查找对应端点 */
     int ep_idx = get_endpoint_index(usb_dev, epnum);
-    if (ep_idx >= 0 && usb_dev->endpoints[ep_idx].callback != NULL) {
-        /* 构造传输结构体 */
-        usb_transfer_t transfer;
-        transfer.ep_addr = epnum;
-        transfer.buffer = usb_dev->endpoints[ep_idx].buffer;
-        transfer.length = usb_dev->endpoints[ep_idx].buffer_size;
-        transfer.actual_length = USBD_LL_GetRxDataSize(&usb_dev->husb, epnum);
-        transfer.type = USB_TRANSFER_DATA;
-        transfer.user_data = NULL;
-        
-        /* 调用回调函数 */
-        usb_dev->endpoints[ep_idx].callback(usb_dev->endpoints[ep_idx].callback_arg, USB_STATUS_COMPLETE, &transfer);
+    if (ep_idx >= 0) {
+        usb_ep_complete(usb_dev, &usb_dev->endpoints[ep_idx], USBD_LL_GetRxDataSize(&usb_dev->husb, epnum));
     }
 }
 
@@ -130,18 +277,8 @@ static void HAL_PCD_DataInStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
     
     /* 查找对应端点 */
     int ep_idx = get_endpoint_index(usb_dev, epnum | 0x80);
-    if (ep_idx >= 0 && usb_dev->endpoints[ep_idx].callback != NULL) {
-        /* 构造传输结构体 */
-        usb_transfer_t transfer;
-        transfer.ep_addr = epnum | 0x80;
-        transfer.buffer = usb_dev->endpoints[ep_idx].buffer;
-        transfer.length = usb_dev->endpoints[ep_idx].buffer_size;
-        transfer.actual_length = transfer.length - USBD_LL_GetTxDataSize(&usb_dev->husb, epnum);
-        transfer.type = USB_TRANSFER_DATA;
-        transfer.user_data = NULL;
-        
-        /* 调用回调函数 */
-        usb_dev->endpoints[ep_idx].callback(usb_dev->endpoints[ep_idx].callback_arg, USB_STATUS_COMPLETE, &transfer);
+    if (ep_idx >= 0) {
+        usb_ep_complete(usb_dev, &usb_dev->endpoints[ep_idx], hpcd->IN_ep[epnum].xfer_count);
     }
 }
 
@@ -405,6 +542,7 @@ int usb_init(const usb_config_t *config, usb_device_state_callback_t state_callb
             usb_dev->endpoints[ep_idx].type = ep_config->type;
             usb_dev->endpoints[ep_idx].max_packet_size = ep_config->max_packet_size;
             usb_dev->endpoints[ep_idx].active = true;
+            usb_dev->endpoints[ep_idx].auto_zlp = (ep_config->type == USB_ENDPOINT_BULK);
             
             /* 打开端点 */
             uint8_t ep_num = ep_config->ep_addr & 0x7F;
@@ -454,6 +592,18 @@ int usb_deinit(usb_handle_t handle) {
         return -1;
     }
     
+    /* 关闭流并取消各端点上排队的传输，停止外设前回调以错误状态完成 */
+    for (int i = 0; i < STM32_USB_MAX_ENDPOINTS; i++) {
+        stm32_usb_endpoint_t *ep = &usb_dev->endpoints[i];
+        
+        if (!ep->active) {
+            continue;
+        }
+        
+        ep->stream.open = false;
+        usb_ep_cancel(usb_dev, ep);
+    }
+    
     /* 停止USB外设 */
     HAL_PCD_Stop(&usb_dev->hpcd);
     HAL_PCD_DeInit(&usb_dev->hpcd);
@@ -638,23 +788,14 @@ int usb_transfer(usb_handle_t handle, usb_transfer_t *transfer, usb_callback_t c
         return -1;
     }
     
-    /* 保存回调函数和数?*/
-    usb_dev->endpoints[ep_idx].callback = callback;
-    usb_dev->endpoints[ep_idx].callback_arg = arg;
-    usb_dev->endpoints[ep_idx].buffer = transfer->buffer;
-    usb_dev->endpoints[ep_idx].buffer_size = transfer->length;
-    
-    /* 根据传输方向进行操作 */
-    uint8_t ep_num = transfer->ep_addr & 0x7F;
-    if (transfer->ep_addr & 0x80) {
-        /* IN传输 */
-        HAL_PCD_EP_Transmit(&usb_dev->hpcd, ep_num, transfer->buffer, transfer->length);
-    } else {
-        /* OUT传输 */
-        HAL_PCD_EP_Receive(&usb_dev->hpcd, ep_num, transfer->buffer, transfer->length);
+    /* 打开流的端点由流独占 */
+    if (usb_dev->endpoints[ep_idx].stream.open) {
+        return -1;
     }
     
-    return 0;
+    /* 加入端点传输队列 */
+    stm32_usb_endpoint_t *ep = &usb_dev->endpoints[ep_idx];
+    return usb_ep_enqueue(usb_dev, ep, transfer, callback, arg, (ep->ep_addr & 0x80) && ep->auto_zlp);
 }
 
 /**
@@ -673,9 +814,8 @@ int usb_cancel_transfer(usb_handle_t handle, uint8_t ep_addr) {
         return -1;
     }
     
-    /* 刷新端点 */
-    uint8_t ep_num = ep_addr & 0x7F;
-    HAL_PCD_EP_Flush(&usb_dev->hpcd, ep_num);
+    /* 丢弃排队的传输并刷新端点 */
+    usb_ep_cancel(usb_dev, &usb_dev->endpoints[ep_idx]);
     
     return 0;
 }
@@ -811,6 +951,294 @@ int usb_get_status(usb_handle_t handle, usb_status_t *status) {
     return 0;
 }
 
+/**
+ * @brief 获取打开了流的端点
+ */
+static stm32_usb_endpoint_t *get_stream_endpoint(usb_handle_t handle, uint8_t ep_addr, stm32_usb_t **usb_dev_out) {
+    stm32_usb_t *usb_dev = (stm32_usb_t *)handle;
+    
+    if (usb_dev == NULL || !usb_dev->initialized) {
+        return NULL;
+    }
+    
+    int ep_idx = get_endpoint_index(usb_dev, ep_addr);
+    if (ep_idx < 0 || !usb_dev->endpoints[ep_idx].stream.open) {
+        return NULL;
+    }
+    
+    *usb_dev_out = usb_dev;
+    return &usb_dev->endpoints[ep_idx];
+}
+
+/**
+ * @brief 流缓冲区完成回调，在中断上下文中调用
+ */
+static void usb_stream_complete(void *arg, usb_status_t status, usb_transfer_t *transfer) {
+    stm32_usb_endpoint_t *ep = (stm32_usb_endpoint_t *)arg;
+    stm32_usb_stream_t *stream = &ep->stream;
+    
+    if (!stream->open) {
+        return;
+    }
+    
+    /* OUT方向缓冲区按环形顺序完成，取消时记为空缓冲区，读取时重新投递 */
+    if (!(ep->ep_addr & 0x80)) {
+        stream->lengths[(stream->current + stream->ready) % stream->config.buffer_count] = transfer->actual_length;
+        stream->ready++;
+    }
+    stream->pending--;
+    
+    if (stream->config.callback != NULL) {
+        stream->config.callback(stream->config.arg, ep->ep_addr, status, transfer->actual_length);
+    }
+}
+
+/**
+ * @brief 把流缓冲区交给端点传输队列
+ *
+ * 调用者须关闭中断。zlp为true时该缓冲区结束一次传输
+ */
+static int usb_stream_submit(stm32_usb_t *usb_dev, stm32_usb_endpoint_t *ep, uint8_t index, uint32_t length, bool zlp) {
+    usb_transfer_t transfer;
+    
+    memset(&transfer, 0, sizeof(transfer));
+    transfer.ep_addr = ep->ep_addr;
+    transfer.buffer = ep->stream.config.buffers[index];
+    transfer.length = length;
+    transfer.type = USB_TRANSFER_DATA;
+    
+    ep->stream.pending++;
+    if (usb_ep_enqueue(usb_dev, ep, &transfer, usb_stream_complete, ep, zlp) != 0) {
+        ep->stream.pending--;
+        return -1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief 在批量或中断端点上打开流
+ */
+int usb_stream_open(usb_handle_t handle, const usb_stream_config_t *config) {
+    stm32_usb_t *usb_dev = (stm32_usb_t *)handle;
+    
+    if (usb_dev == NULL || !usb_dev->initialized || config == NULL ||
+        config->buffer_count == 0 || config->buffer_count > CONFIG_USB_EP_QUEUE_DEPTH) {
+        return -1;
+    }
+    
+    int ep_idx = get_endpoint_index(usb_dev, config->ep_addr);
+    if (ep_idx < 0) {
+        return -1;
+    }
+    
+    stm32_usb_endpoint_t *ep = &usb_dev->endpoints[ep_idx];
+    
+    /* 只支持批量和中断端点，端点上不能有其他传输 */
+    if ((ep->type != USB_ENDPOINT_BULK && ep->type != USB_ENDPOINT_INTERRUPT) ||
+        ep->stream.open || ep->queue_count > 0 || ep->zlp_pending) {
+        return -1;
+    }
+    
+    if (config->buffer_size == 0 || config->buffer_size % ep->max_packet_size != 0) {
+        return -1;
+    }
+    
+    for (uint8_t i = 0; i < config->buffer_count; i++) {
+        if (config->buffers[i] == NULL) {
+            return -1;
+        }
+    }
+    
+    memset(&ep->stream, 0, sizeof(ep->stream));
+    ep->stream.config = *config;
+    ep->stream.open = true;
+    
+    /* OUT方向预先投递全部缓冲区 */
+    if (!(ep->ep_addr & 0x80)) {
+        uint32_t primask = usb_irq_lock();
+        for (uint8_t i = 0; i < config->buffer_count; i++) {
+            usb_stream_submit(usb_dev, ep, i, config->buffer_size, false);
+        }
+        usb_irq_unlock(primask);
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief 关闭流
+ */
+int usb_stream_close(usb_handle_t handle, uint8_t ep_addr) {
+    stm32_usb_t *usb_dev;
+    stm32_usb_endpoint_t *ep = get_stream_endpoint(handle, ep_addr, &usb_dev);
+    
+    if (ep == NULL) {
+        return -1;
+    }
+    
+    /* 先标记关闭，取消时不再更新流状态 */
+    ep->stream.open = false;
+    usb_ep_cancel(usb_dev, ep);
+    
+    return 0;
+}
+
+/**
+ * @brief 写入IN流
+ */
+int usb_stream_write(usb_handle_t handle, uint8_t ep_addr, const void *data, uint32_t length) {
+    stm32_usb_t *usb_dev;
+    stm32_usb_endpoint_t *ep = get_stream_endpoint(handle, ep_addr, &usb_dev);
+    
+    if (ep == NULL || !(ep_addr & 0x80) || (data == NULL && length > 0)) {
+        return -1;
+    }
+    
+    stm32_usb_stream_t *stream = &ep->stream;
+    const uint8_t *src = (const uint8_t *)data;
+    uint32_t written = 0;
+    
+    while (written < length) {
+        uint32_t primask = usb_irq_lock();
+        bool full = (stream->pending >= stream->config.buffer_count);
+        usb_irq_unlock(primask);
+        
+        if (full) {
+            break;
+        }
+        
+        /* 正在填充的缓冲区不在传输队列中，复制时无需关中断 */
+        uint32_t chunk = stream->config.buffer_size - stream->offset;
+        if (chunk > length - written) {
+            chunk = length - written;
+        }
+        memcpy(stream->config.buffers[stream->current] + stream->offset, src + written, chunk);
+        stream->offset += chunk;
+        written += chunk;
+        
+        /* 缓冲区写满后立即发送，传输在刷新时才结束 */
+        if (stream->offset == stream->config.buffer_size) {
+            primask = usb_irq_lock();
+            usb_stream_submit(usb_dev, ep, stream->current, stream->offset, false);
+            stream->unterminated = true;
+            stream->current = (stream->current + 1) % stream->config.buffer_count;
+            stream->offset = 0;
+            usb_irq_unlock(primask);
+        }
+    }
+    
+    return (int)written;
+}
+
+/**
+ * @brief 发送IN流中未写满的缓冲区
+ */
+int usb_stream_flush(usb_handle_t handle, uint8_t ep_addr) {
+    stm32_usb_t *usb_dev;
+    stm32_usb_endpoint_t *ep = get_stream_endpoint(handle, ep_addr, &usb_dev);
+    
+    if (ep == NULL || !(ep_addr & 0x80)) {
+        return -1;
+    }
+    
+    stm32_usb_stream_t *stream = &ep->stream;
+    bool zlp = stream->config.auto_zlp && ep->type == USB_ENDPOINT_BULK;
+    
+    /* 没有未发送的数据，且上次刷新后的数据以整包结束时只需一个零长度包 */
+    if (stream->offset == 0 && !(zlp && stream->unterminated)) {
+        return 0;
+    }
+    
+    uint32_t primask = usb_irq_lock();
+    int result = -1;
+    
+    if (stream->pending < stream->config.buffer_count) {
+        result = usb_stream_submit(usb_dev, ep, stream->current, stream->offset, zlp);
+        stream->current = (stream->current + 1) % stream->config.buffer_count;
+        stream->offset = 0;
+        stream->unterminated = false;
+    }
+    
+    usb_irq_unlock(primask);
+    return result;
+}
+
+/**
+ * @brief 读取OUT流
+ */
+int usb_stream_read(usb_handle_t handle, uint8_t ep_addr, void *data, uint32_t length) {
+    stm32_usb_t *usb_dev;
+    stm32_usb_endpoint_t *ep = get_stream_endpoint(handle, ep_addr, &usb_dev);
+    
+    if (ep == NULL || (ep_addr & 0x80) || (data == NULL && length > 0)) {
+        return -1;
+    }
+    
+    stm32_usb_stream_t *stream = &ep->stream;
+    uint8_t *dst = (uint8_t *)data;
+    uint32_t total = 0;
+    
+    while (total < length) {
+        uint32_t primask = usb_irq_lock();
+        bool empty = (stream->ready == 0);
+        usb_irq_unlock(primask);
+        
+        if (empty) {
+            break;
+        }
+        
+        /* 已收到数据的缓冲区不在传输队列中，复制时无需关中断 */
+        uint32_t chunk = stream->lengths[stream->current] - stream->offset;
+        if (chunk > length - total) {
+            chunk = length - total;
+        }
+        memcpy(dst + total, stream->config.buffers[stream->current] + stream->offset, chunk);
+        stream->offset += chunk;
+        total += chunk;
+        
+        /* 读空后重新投递，排在已投递的缓冲区之后 */
+        if (stream->offset == stream->lengths[stream->current]) {
+            primask = usb_irq_lock();
+            stream->ready--;
+            usb_stream_submit(usb_dev, ep, stream->current, stream->config.buffer_size, false);
+            stream->current = (stream->current + 1) % stream->config.buffer_count;
+            stream->offset = 0;
+            usb_irq_unlock(primask);
+        }
+    }
+    
+    return (int)total;
+}
+
+/**
+ * @brief 获取流中可用的字节数
+ */
+int usb_stream_available(usb_handle_t handle, uint8_t ep_addr, uint32_t *bytes) {
+    stm32_usb_t *usb_dev;
+    stm32_usb_endpoint_t *ep = get_stream_endpoint(handle, ep_addr, &usb_dev);
+    
+    if (ep == NULL || bytes == NULL) {
+        return -1;
+    }
+    
+    stm32_usb_stream_t *stream = &ep->stream;
+    uint32_t primask = usb_irq_lock();
+    
+    if (ep_addr & 0x80) {
+        *bytes = (stream->config.buffer_count - stream->pending) * stream->config.buffer_size - stream->offset;
+    } else {
+        *bytes = 0;
+        for (uint8_t i = 0; i < stream->ready; i++) {
+            *bytes += stream->lengths[(stream->current + i) % stream->config.buffer_count];
+        }
+        *bytes -= stream->offset;
+    }
+    
+    usb_irq_unlock(primask);
+    return 0;
+}
+
 /* USB主机模式函数 */
 
 /**
@@ -0,0 +1,175 @@
+/**
+ * @file common_sensor_stream.c
+ * @brief 传感器批量采样流实现（平台无关）
+ */
+
+#include "feature/sensor_stream_api.h"
+#include <string.h>
+
+#define SENSOR_STREAM_MASK      (CONFIG_SENSOR_STREAM_DEPTH - 1)
+
+/* 周期估计平滑系数，新测量值占1/2^N */
+#define SENSOR_STREAM_PERIOD_SHIFT  3
+
+/**
+ * @brief 判断缓冲量是否刚达到水位
+ *
+ * 只在从水位以下跨越到水位及以上时通知一次，消费者未取走前不重复通知
+ */
+static bool stream_crossed(const sensor_stream_t *stream, uint32_t before, uint32_t after) {
+    uint32_t level = (stream->watermark == 0) ? 1 : stream->watermark;
+
+    return before < level && after >= level;
+}
+
+/**
+ * @brief 写入环形缓冲区，不更新head
+ *
+ * @return uint32_t 实际写入的样本数
+ */
+static uint32_t stream_write(sensor_stream_t *stream, uint32_t head, const sensor_sample_t *sample) {
+    if (head - __atomic_load_n(&stream->tail, __ATOMIC_ACQUIRE) >= CONFIG_SENSOR_STREAM_DEPTH) {
+        stream->stats.dropped++;
+        return 0;
+    }
+
+    stream->ring[head & SENSOR_STREAM_MASK] = *sample;
+    stream->stats.samples++;
+    return 1;
+}
+
+/**
+ * @brief 初始化采样流
+ */
+int sensor_stream_init(sensor_stream_t *stream, uint16_t watermark, uint32_t period_us) {
+    if (stream == NULL || watermark > CONFIG_SENSOR_STREAM_DEPTH) {
+        return SENSOR_STREAM_INVALID_PARAM;
+    }
+
+    memset(stream, 0, sizeof(sensor_stream_t));
+    stream->watermark = watermark;
+    stream->period_us = period_us;
+
+    return SENSOR_STREAM_OK;
+}
+
+/**
+ * @brief 清空采样流并重新开始周期估计
+ */
+void sensor_stream_reset(sensor_stream_t *stream, uint32_t period_us) {
+    if (stream == NULL) {
+        return;
+    }
+
+    __atomic_store_n(&stream->tail, __atomic_load_n(&stream->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+    stream->period_us = period_us;
+    stream->period_valid = false;
+}
+
+/**
+ * @brief 压入单个样本
+ */
+bool sensor_stream_push(sensor_stream_t *stream, const sensor_sample_t *sample) {
+    if (stream == NULL || sample == NULL) {
+        return false;
+    }
+
+    /* head只由生产者修改，读取自身的计数无需同步 */
+    uint32_t head = stream->head;
+    uint32_t before = head - __atomic_load_n(&stream->tail, __ATOMIC_ACQUIRE);
+
+    head += stream_write(stream, head, sample);
+    __atomic_store_n(&stream->head, head, __ATOMIC_RELEASE);
+
+    return stream_crossed(stream, before, head - __atomic_load_n(&stream->tail, __ATOMIC_ACQUIRE));
+}
+
+/**
+ * @brief 压入一次FIFO突发读出的样本并回推时间戳
+ */
+bool sensor_stream_push_fifo(sensor_stream_t *stream, sensor_sample_t *samples, uint32_t count,
+                             uint32_t irq_timestamp_us) {
+    if (stream == NULL || samples == NULL || count == 0) {
+        return false;
+    }
+
+    stream->stats.bursts++;
+
+    /* 两次中断之间产生的正是本次读出的样本，据此修正周期估计 */
+    if (stream->period_valid) {
+        uint32_t measured = (irq_timestamp_us - stream->last_irq_us) / count;
+
+        if (stream->period_us == 0) {
+            stream->period_us = measured;
+        } else {
+            int32_t error = (int32_t)(measured - stream->period_us);
+            stream->period_us = (uint32_t)((int32_t)stream->period_us + (error >> SENSOR_STREAM_PERIOD_SHIFT));
+        }
+    }
+    stream->last_irq_us = irq_timestamp_us;
+    stream->period_valid = true;
+
+    uint32_t head = stream->head;
+    uint32_t before = head - __atomic_load_n(&stream->tail, __ATOMIC_ACQUIRE);
+
+    for (uint32_t i = 0; i < count; i++) {
+        samples[i].timestamp_us = irq_timestamp_us - (count - 1 - i) * stream->period_us;
+        head += stream_write(stream, head, &samples[i]);
+    }
+
+    /* 整批写完后再发布，消费者不会看到时间戳未填好的样本 */
+    __atomic_store_n(&stream->head, head, __ATOMIC_RELEASE);
+
+    return stream_crossed(stream, before, head - __atomic_load_n(&stream->tail, __ATOMIC_ACQUIRE));
+}
+
+/**
+ * @brief 批量取出样本
+ */
+uint32_t sensor_stream_pop(sensor_stream_t *stream, sensor_sample_t *samples, uint32_t max_count) {
+    if (stream == NULL || samples == NULL) {
+        return 0;
+    }
+
+    /* 获取head之后再读样本，保证看到生产者发布前写入的内容 */
+    uint32_t tail = stream->tail;
+    uint32_t available = __atomic_load_n(&stream->head, __ATOMIC_ACQUIRE) - tail;
+    uint32_t count = (available < max_count) ? available : max_count;
+
+    /* 环形缓冲区最多分两段连续复制 */
+    uint32_t offset = tail & SENSOR_STREAM_MASK;
+    uint32_t first = CONFIG_SENSOR_STREAM_DEPTH - offset;
+    if (first > count) {
+        first = count;
+    }
+
+    memcpy(samples, &stream->ring[offset], first * sizeof(sensor_sample_t));
+    memcpy(&samples[first], &stream->ring[0], (count - first) * sizeof(sensor_sample_t));
+
+    /* 样本复制完成后才释放槽位给生产者 */
+    __atomic_store_n(&stream->tail, tail + count, __ATOMIC_RELEASE);
+
+    return count;
+}
+
+/**
+ * @brief 获取已缓冲的样本数
+ */
+uint32_t sensor_stream_count(const sensor_stream_t *stream) {
+    uint32_t tail = __atomic_load_n(&stream->tail, __ATOMIC_ACQUIRE);
+
+    return __atomic_load_n(&stream->head, __ATOMIC_ACQUIRE) - tail;
+}
+
+/**
+ * @brief 获取统计信息
+ */
+int sensor_stream_get_stats(const sensor_stream_t *stream, sensor_batch_stats_t *stats) {
+    if (stream == NULL || stats == NULL) {
+        return SENSOR_STREAM_INVALID_PARAM;
+    }
+
+    *stats = stream->stats;
+
+    return SENSOR_STREAM_OK;
+}
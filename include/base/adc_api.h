@@ -178,6 +178,70 @@ int adc_register_event_callback(driver_handle_t handle, adc_event_callback_t cal
  */
 uint32_t adc_convert_to_voltage(driver_handle_t handle, uint32_t adc_value);
 
+/* ADC扫描序列最大通道数 */
+#ifndef CONFIG_ADC_SCAN_MAX_CHANNELS
+#define CONFIG_ADC_SCAN_MAX_CHANNELS  8
+#endif
+
+/**
+ * @brief ADC数据块回调函数类型
+ *
+ * 每填满一个数据块调用一次。samples按帧交错排列，每帧依次为扫描序列中
+ * 各通道的原始值。数据块双缓冲，下一个数据块的回调返回后驱动即开始
+ * 覆盖本数据块，因此本数据块只在下一个数据块交付之前有效。回调可以把它
+ * 转交给处理任务而不复制，但处理任务须在一个数据块的时间内用完或复制
+ */
+typedef void (*adc_block_callback_t)(const uint16_t *samples, uint32_t frames, void *user_data);
+
+/* ADC流式采样配置 */
+typedef struct {
+    const adc_channel_id_t *channels;   /**< 扫描序列通道列表 */
+    uint8_t channel_count;              /**< 扫描序列通道数，不超过CONFIG_ADC_SCAN_MAX_CHANNELS */
+    uint32_t frame_rate_hz;             /**< 帧率(赫兹)，每帧对序列中每个通道各采样一次 */
+    uint32_t frames_per_block;          /**< 每个数据块的帧数 */
+    adc_block_callback_t callback;      /**< 数据块回调函数 */
+    void *user_data;                    /**< 用户数据 */
+} adc_stream_config_t;
+
+/* ADC流式采样统计信息 */
+typedef struct {
+    uint32_t blocks;                    /**< 交付的数据块数 */
+    uint32_t overruns;                  /**< 处理不及时而丢失数据的次数 */
+    uint32_t resyncs;                   /**< 扫描序列错位后重新对齐的次数 */
+} adc_stream_stats_t;
+
+/**
+ * @brief 启动定时器触发的DMA流式采样
+ *
+ * 采样由硬件定时器触发，结果经DMA写入双缓冲区，CPU只在每个数据块完成时
+ * 参与一次，适合10kHz以上的稳定采样。同一时间只能运行一个流，任一句柄
+ * 已启动流式采样或连续转换时返回ERROR_BUSY
+ *
+ * @param handle ADC句柄，提供分辨率和衰减等通道配置
+ * @param config 流式采样配置
+ * @return int 0表示成功，非0表示失败
+ */
+int adc_start_stream(driver_handle_t handle, const adc_stream_config_t *config);
+
+/**
+ * @brief 停止流式采样
+ *
+ * 返回后不会再调用数据块回调
+ *
+ * @param handle ADC句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int adc_stop_stream(driver_handle_t handle);
+
+/**
+ * @brief 获取流式采样统计信息
+ *
+ * @param handle ADC句柄
+ * @param stats 统计信息输出
+ * @return int 0表示成功，非0表示失败
+ */
+int adc_get_stream_stats(driver_handle_t handle, adc_stream_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,217 @@
+/**
+ * @file block_cache_api.h
+ * @brief 块设备扇区缓存接口定义
+ *
+ * 该头文件定义了位于文件系统实现与块设备驱动(sdio_api.h、flash_api.h)之间的
+ * 扇区缓存。缓存占用调用者提供的一块内存，内存大小即缓存预算；缓存块按LRU
+ * 淘汰。写入只修改缓存并标记为脏，在淘汰、block_cache_flush或卸载时写回，
+ * 块号连续的脏块合并为一次多块写入。检测到顺序读取时按逐步加倍的窗口预读
+ * 后续块。达到绕过阈值的大块读写直接访问设备，不冲刷缓存中的元数据块。
+ *
+ * 文件系统实现应在fs_flush和fs_close中调用block_cache_flush，保证返回时
+ * 数据已写入设备。
+ */
+
+#ifndef BLOCK_CACHE_API_H
+#define BLOCK_CACHE_API_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "common/error_api.h"
+
+#if (CURRENT_RTOS != RTOS_NONE)
+#include "common/rtos_api.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 错误码定义 */
+#define BLOCK_CACHE_OK              0   /**< 操作成功 */
+#define BLOCK_CACHE_INVALID_PARAM  -1   /**< 无效参数 */
+#define BLOCK_CACHE_NO_MEMORY      -2   /**< 内存预算不足以容纳两个缓存块 */
+#define BLOCK_CACHE_IO_ERROR       -3   /**< 设备读写失败 */
+#define BLOCK_CACHE_READ_ONLY      -4   /**< 设备不支持写入 */
+
+/* 无效缓存项索引 */
+#define BLOCK_CACHE_NONE            0xFFFF
+
+/**
+ * @brief 读取连续块
+ *
+ * @param context 设备上下文
+ * @param block 起始块号
+ * @param buffer 数据缓冲区
+ * @param count 块数
+ * @return int 0表示成功，非0表示失败
+ */
+typedef int (*block_cache_read_func_t)(void *context, uint32_t block, void *buffer, uint32_t count);
+
+/**
+ * @brief 写入连续块
+ *
+ * @param context 设备上下文
+ * @param block 起始块号
+ * @param buffer 数据缓冲区
+ * @param count 块数
+ * @return int 0表示成功，非0表示失败
+ */
+typedef int (*block_cache_write_func_t)(void *context, uint32_t block, const void *buffer, uint32_t count);
+
+/**
+ * @brief 等待已写入的数据落盘
+ *
+ * @param context 设备上下文
+ * @return int 0表示成功，非0表示失败
+ */
+typedef int (*block_cache_sync_func_t)(void *context);
+
+/**
+ * @brief 块设备描述
+ *
+ * SD卡可直接用sdio_read_blocks/sdio_write_blocks的薄包装实现读写函数；
+ * Flash由文件系统实现按页或扇区提供读写函数
+ */
+typedef struct {
+    block_cache_read_func_t read;       /**< 读取函数 */
+    block_cache_write_func_t write;     /**< 写入函数，NULL表示只读设备 */
+    block_cache_sync_func_t sync;       /**< 落盘函数，可为NULL */
+    void *context;                      /**< 设备上下文 */
+    uint32_t block_size;                /**< 块大小(字节)，4的倍数 */
+    uint32_t block_count;               /**< 设备块数量 */
+} block_cache_device_t;
+
+/* 缓存配置 */
+typedef struct {
+    block_cache_device_t device;        /**< 块设备 */
+    void *memory;                       /**< 缓存内存，4字节对齐，缓存块数据位于起始处可直接用于DMA */
+    uint32_t memory_size;               /**< 缓存内存大小(字节) */
+    uint16_t batch_blocks;              /**< 预读与写回合并的最大块数，0表示关闭预读和合并 */
+    uint16_t bypass_blocks;             /**< 单次读写达到该块数时绕过缓存，0表示缓存块数的一半 */
+} block_cache_config_t;
+
+/* 统计信息 */
+typedef struct {
+    uint32_t hits;                      /**< 命中块数 */
+    uint32_t misses;                    /**< 未命中块数 */
+    uint32_t readahead_blocks;          /**< 预读块数 */
+    uint32_t readahead_hits;            /**< 预读后被读取的块数 */
+    uint32_t bypass_blocks;             /**< 绕过缓存读写的块数 */
+    uint32_t writebacks;                /**< 写回的脏块数 */
+    uint32_t device_reads;              /**< 设备读操作次数 */
+    uint32_t device_writes;             /**< 设备写操作次数 */
+    uint32_t evictions;                 /**< 淘汰的有效块数 */
+} block_cache_stats_t;
+
+/* 缓存项 */
+typedef struct {
+    uint32_t block;                     /**< 块号 */
+    uint16_t lru_prev;                  /**< LRU链表中较新的一项 */
+    uint16_t lru_next;                  /**< LRU链表中较旧的一项 */
+    uint16_t hash_next;                 /**< 哈希链下一项 */
+    uint8_t flags;                      /**< 状态标志 */
+    uint8_t reserved;                   /**< 保留 */
+} block_cache_entry_t;
+
+/**
+ * @brief 块缓存对象
+ *
+ * 由调用者分配，字段由缓存内部维护
+ */
+typedef struct {
+    block_cache_config_t config;        /**< 缓存配置 */
+    uint8_t *data;                      /**< 缓存块数据 */
+    uint8_t *staging;                   /**< 预读与写回合并的暂存区 */
+    block_cache_entry_t *entries;       /**< 缓存项 */
+    uint16_t *buckets;                  /**< 哈希桶 */
+    uint16_t entry_count;               /**< 缓存块数 */
+    uint16_t bucket_mask;               /**< 哈希桶掩码 */
+    uint16_t lru_head;                  /**< 最近使用的缓存项 */
+    uint16_t lru_tail;                  /**< 最久未使用的缓存项 */
+    uint16_t dirty_count;               /**< 脏块数 */
+    uint16_t bypass_blocks;             /**< 绕过阈值 */
+    uint16_t readahead;                 /**< 当前预读窗口 */
+    uint32_t next_sequential;           /**< 上次读取的结束块号，用于顺序读取检测 */
+    block_cache_stats_t stats;          /**< 统计信息 */
+    bool initialized;                   /**< 是否已初始化 */
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_mutex_t mutex;                 /**< 互斥锁 */
+#endif
+} block_cache_t;
+
+/**
+ * @brief 初始化块缓存
+ *
+ * 在配置的内存中划分缓存块、暂存区、缓存项和哈希桶
+ *
+ * @param cache 缓存对象
+ * @param config 缓存配置
+ * @return int 0表示成功，非0表示失败
+ */
+int block_cache_init(block_cache_t *cache, const block_cache_config_t *config);
+
+/**
+ * @brief 写回所有脏块并释放缓存
+ *
+ * @param cache 缓存对象
+ * @return int 0表示成功，非0表示写回失败(缓存仍被释放)
+ */
+int block_cache_deinit(block_cache_t *cache);
+
+/**
+ * @brief 读取块
+ *
+ * @param cache 缓存对象
+ * @param block 起始块号
+ * @param buffer 数据缓冲区
+ * @param count 块数
+ * @return int 0表示成功，非0表示失败
+ */
+int block_cache_read(block_cache_t *cache, uint32_t block, void *buffer, uint32_t count);
+
+/**
+ * @brief 写入块
+ *
+ * 数据写入缓存后即返回，设备上的内容在写回后才更新
+ *
+ * @param cache 缓存对象
+ * @param block 起始块号
+ * @param buffer 数据缓冲区
+ * @param count 块数
+ * @return int 0表示成功，非0表示失败
+ */
+int block_cache_write(block_cache_t *cache, uint32_t block, const void *buffer, uint32_t count);
+
+/**
+ * @brief 写回所有脏块并等待落盘
+ *
+ * @param cache 缓存对象
+ * @return int 0表示成功，非0表示失败
+ */
+int block_cache_flush(block_cache_t *cache);
+
+/**
+ * @brief 丢弃所有缓存块，包括未写回的脏块
+ *
+ * 用于介质更换或设备被旁路修改之后
+ *
+ * @param cache 缓存对象
+ * @return int 0表示成功，非0表示失败
+ */
+int block_cache_invalidate(block_cache_t *cache);
+
+/**
+ * @brief 获取统计信息
+ *
+ * @param cache 缓存对象
+ * @param stats 统计信息输出
+ * @return int 0表示成功，非0表示失败
+ */
+int block_cache_get_stats(block_cache_t *cache, block_cache_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLOCK_CACHE_API_H */
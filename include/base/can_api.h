@@ -75,7 +75,7 @@ typedef struct {
     can_frame_type_t frame_type; /**< 帧类型 (数据或远程) */
     uint8_t dlc;             /**< 数据长度码 (0-8) */
     uint8_t data[8];         /**< 数据字段 */
-    uint32_t timestamp;      /**< 时间戳 */
+    uint32_t timestamp;      /**< 接收时间戳(微秒) */
 } can_message_t;
 
 /* CAN总线统计信息 */
@@ -161,6 +161,19 @@ api_status_t can_send(uint8_t controller, const can_message_t *message, uint32_t
  */
 api_status_t can_receive(uint8_t controller, can_message_t *message, uint32_t timeout_ms);
 
+/**
+ * @brief 批量接收CAN消息
+ *
+ * 一次调用取出接收队列中已有的多帧消息，队列为空时等待至少一帧到达
+ *
+ * @param handle CAN设备句柄
+ * @param messages 消息输出数组
+ * @param max_count 数组容量
+ * @param timeout_ms 超时时间(毫秒)，0表示不等待，UINT32_MAX表示永久等待
+ * @return int 实际接收的帧数，超时返回0，参数错误返回-1
+ */
+int can_receive_batch(driver_handle_t handle, can_message_t *messages, uint32_t max_count, uint32_t timeout_ms);
+
 /**
  * @brief 注册CAN接收回调函数
  *
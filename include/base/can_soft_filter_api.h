@@ -0,0 +1,217 @@
+/**
+ * @file can_soft_filter_api.h
+ * @brief CAN软件验收过滤器接口定义
+ *
+ * 该头文件定义了运行在CAN接收路径上的第二级软件过滤器。硬件过滤器组数量
+ * 有限时，可将硬件过滤器设置为全接收，由软件过滤器完成按ID的精确筛选与
+ * 分发：标准帧通过2048项直接索引表O(1)查找，扩展帧通过哈希表精确匹配，
+ * 并支持范围规则和掩码规则。每条规则携带路由掩码，决定帧进入驱动接收队列
+ * 还是分发给不同的订阅者，未命中的帧在复制和回调之前即被丢弃。
+ */
+
+#ifndef CAN_SOFT_FILTER_API_H
+#define CAN_SOFT_FILTER_API_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "base/can_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 扩展帧精确匹配哈希表容量，必须为2的幂 */
+#ifndef CONFIG_CAN_SOFT_FILTER_EXT_HASH_SIZE
+#define CONFIG_CAN_SOFT_FILTER_EXT_HASH_SIZE    128
+#endif
+
+/* 扩展帧范围/掩码规则最大数量 */
+#ifndef CONFIG_CAN_SOFT_FILTER_EXT_RULES
+#define CONFIG_CAN_SOFT_FILTER_EXT_RULES        16
+#endif
+
+/* 标准帧ID数量 */
+#define CAN_SOFT_FILTER_STD_IDS         2048
+
+/* 路由数量，路由0固定为驱动接收队列 */
+#define CAN_SOFT_FILTER_MAX_ROUTES      8
+
+/* 路由掩码 */
+#define CAN_SOFT_FILTER_ROUTE(n)        ((uint8_t)(1U << (n)))
+#define CAN_SOFT_FILTER_ROUTE_QUEUE     CAN_SOFT_FILTER_ROUTE(0)
+
+/* 错误码定义 */
+#define CAN_SOFT_FILTER_OK              0   /**< 操作成功 */
+#define CAN_SOFT_FILTER_INVALID_PARAM  -1   /**< 无效参数 */
+#define CAN_SOFT_FILTER_NO_SPACE       -2   /**< 规则表已满 */
+
+/* 订阅者处理函数类型，在接收中断或接收任务上下文中调用 */
+typedef void (*can_soft_filter_handler_t)(const can_message_t *message, void *arg);
+
+/* 扩展帧规则类型 */
+typedef enum {
+    CAN_SOFT_FILTER_RULE_RANGE,     /**< ID位于[id, id_end]范围内 */
+    CAN_SOFT_FILTER_RULE_MASK       /**< (ID & mask) == (id & mask) */
+} can_soft_filter_rule_type_t;
+
+/* 扩展帧规则 */
+typedef struct {
+    can_soft_filter_rule_type_t type;   /**< 规则类型 */
+    uint32_t id;                        /**< 起始ID或匹配码 */
+    uint32_t id_end;                    /**< 结束ID或掩码 */
+    uint8_t routes;                     /**< 路由掩码 */
+} can_soft_filter_rule_t;
+
+/* 扩展帧哈希表项 */
+typedef struct {
+    uint32_t id;                        /**< 扩展帧ID，空闲或删除搬移中为保留值 */
+    uint8_t routes;                     /**< 路由掩码 */
+} can_soft_filter_ext_entry_t;
+
+/* 订阅者 */
+typedef struct {
+    can_soft_filter_handler_t handler;  /**< 处理函数 */
+    void *arg;                          /**< 处理函数参数 */
+} can_soft_filter_subscriber_t;
+
+/* 过滤器统计信息 */
+typedef struct {
+    uint32_t accepted;                  /**< 接收的帧数 */
+    uint32_t dropped;                   /**< 丢弃的帧数 */
+} can_soft_filter_stats_t;
+
+/**
+ * @brief 软件过滤器对象
+ *
+ * 由调用者静态分配，通过驱动的can_set_soft_filter接口挂接到CAN实例
+ */
+typedef struct {
+    uint8_t std_routes[CAN_SOFT_FILTER_STD_IDS];                            /**< 标准帧路由表 */
+    can_soft_filter_ext_entry_t ext_table[CONFIG_CAN_SOFT_FILTER_EXT_HASH_SIZE]; /**< 扩展帧哈希表 */
+    uint32_t ext_count;                                                     /**< 哈希表有效项数 */
+    can_soft_filter_rule_t ext_rules[CONFIG_CAN_SOFT_FILTER_EXT_RULES];     /**< 扩展帧规则 */
+    volatile uint32_t ext_rule_count;                                       /**< 扩展帧规则数 */
+    can_soft_filter_subscriber_t subscribers[CAN_SOFT_FILTER_MAX_ROUTES];   /**< 订阅者表 */
+    can_soft_filter_stats_t stats;                                          /**< 统计信息 */
+} can_soft_filter_t;
+
+/**
+ * @brief 初始化软件过滤器，初始状态丢弃所有帧
+ *
+ * @param filter 过滤器对象
+ * @return int 0表示成功，非0表示失败
+ */
+int can_soft_filter_init(can_soft_filter_t *filter);
+
+/**
+ * @brief 注册订阅者
+ *
+ * @param filter 过滤器对象
+ * @param route 路由号，范围[1, CAN_SOFT_FILTER_MAX_ROUTES)
+ * @param handler 处理函数，NULL表示注销
+ * @param arg 处理函数参数
+ * @return int 0表示成功，非0表示失败
+ */
+int can_soft_filter_subscribe(can_soft_filter_t *filter, uint8_t route,
+                              can_soft_filter_handler_t handler, void *arg);
+
+/**
+ * @brief 设置标准帧ID范围的路由
+ *
+ * @param filter 过滤器对象
+ * @param id_start 起始ID
+ * @param id_end 结束ID（含）
+ * @param routes 路由掩码，0表示丢弃
+ * @return int 0表示成功，非0表示失败
+ */
+int can_soft_filter_set_std_range(can_soft_filter_t *filter, uint32_t id_start,
+                                  uint32_t id_end, uint8_t routes);
+
+/**
+ * @brief 按掩码设置标准帧路由，所有满足(ID & mask) == (id & mask)的ID生效
+ *
+ * @param filter 过滤器对象
+ * @param id 匹配码
+ * @param mask 掩码
+ * @param routes 路由掩码，0表示丢弃
+ * @return int 0表示成功，非0表示失败
+ */
+int can_soft_filter_set_std_mask(can_soft_filter_t *filter, uint32_t id,
+                                 uint32_t mask, uint8_t routes);
+
+/**
+ * @brief 设置单个扩展帧ID的路由
+ *
+ * @param filter 过滤器对象
+ * @param id 扩展帧ID
+ * @param routes 路由掩码，0表示删除该ID
+ * @return int 0表示成功，非0表示失败
+ */
+int can_soft_filter_set_ext(can_soft_filter_t *filter, uint32_t id, uint8_t routes);
+
+/**
+ * @brief 添加扩展帧范围或掩码规则
+ *
+ * @param filter 过滤器对象
+ * @param rule 规则
+ * @return int 0表示成功，非0表示失败
+ */
+int can_soft_filter_add_ext_rule(can_soft_filter_t *filter, const can_soft_filter_rule_t *rule);
+
+/**
+ * @brief 清除所有过滤规则，订阅者保持不变
+ *
+ * 应在过滤器未挂接或CAN停止时调用
+ *
+ * @param filter 过滤器对象
+ * @return int 0表示成功，非0表示失败
+ */
+int can_soft_filter_clear(can_soft_filter_t *filter);
+
+/**
+ * @brief 查找帧ID对应的路由掩码
+ *
+ * @param filter 过滤器对象
+ * @param id 帧ID
+ * @param id_type ID类型
+ * @return uint8_t 路由掩码，0表示丢弃
+ */
+uint8_t can_soft_filter_match(can_soft_filter_t *filter, uint32_t id, can_id_type_t id_type);
+
+/**
+ * @brief 将消息分发给路由掩码中的订阅者
+ *
+ * 路由0（驱动接收队列）由驱动自行处理，此处忽略
+ *
+ * @param filter 过滤器对象
+ * @param routes 路由掩码
+ * @param message 消息
+ */
+void can_soft_filter_dispatch(const can_soft_filter_t *filter, uint8_t routes, const can_message_t *message);
+
+/**
+ * @brief 获取过滤器统计信息
+ *
+ * @param filter 过滤器对象
+ * @param stats 统计信息输出
+ * @return int 0表示成功，非0表示失败
+ */
+int can_soft_filter_get_stats(const can_soft_filter_t *filter, can_soft_filter_stats_t *stats);
+
+/**
+ * @brief 为CAN设备挂接软件过滤器
+ *
+ * 挂接后接收路径先查询过滤器，未命中的帧直接丢弃，命中的帧按路由掩码
+ * 进入驱动接收队列（路由0）或分发给订阅者
+ *
+ * @param handle CAN设备句柄
+ * @param filter 过滤器对象，NULL表示取消挂接并接收所有帧
+ * @return int 0表示成功，非0表示失败
+ */
+int can_set_soft_filter(driver_handle_t handle, can_soft_filter_t *filter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAN_SOFT_FILTER_API_H */
@@ -54,6 +54,12 @@ typedef struct {
     void *driver_config;               /**< 驱动特定配置 */
 } display_config_t;
 
+/* TM1681传输方式 */
+typedef enum {
+    TM1681_TRANSPORT_GPIO = 0,          /**< GPIO模拟时序 */
+    TM1681_TRANSPORT_SPI                /**< SPI+DMA，STB由GPIO控制，需CONFIG_TM1681_SPI_ENABLED(仅STM32) */
+} tm1681_transport_type_t;
+
 /* TM1681点阵配置参数(用于driver_config) */
 typedef struct {
     uint8_t data_pin;                   /**< 数据引脚 */
@@ -62,6 +68,8 @@ typedef struct {
     uint8_t grid_num;                   /**< 网格数量 */
     uint8_t segments_per_grid;          /**< 每网格段数 */
     uint8_t brightness_levels;          /**< 亮度级别 */
+    tm1681_transport_type_t transport;  /**< 传输方式 */
+    void *spi_handle;                   /**< SPI传输使用的已初始化SPI句柄，模式3、低位在前 */
 } tm1681_config_t;
 
 /* 点坐标 */
@@ -29,7 +29,8 @@ typedef enum {
 /* DMA传输模式 */
 typedef enum {
     DMA_MODE_NORMAL,      /**< 普通模式 */
-    DMA_MODE_CIRCULAR     /**< 循环模式 */
+    DMA_MODE_CIRCULAR,    /**< 循环模式 */
+    DMA_MODE_PERIPH_FLOW  /**< 外设流控模式，传输长度由外设决定 */
 } dma_mode_t;
 
 /* DMA传输优先级 */
@@ -53,7 +54,8 @@ typedef enum {
     DMA_STATUS_BUSY,        /**< 忙状态 */
     DMA_STATUS_COMPLETE,    /**< 传输完成 */
     DMA_STATUS_ERROR,       /**< 传输错误 */
-    DMA_STATUS_ABORT        /**< 传输中止 */
+    DMA_STATUS_ABORT,       /**< 传输中止 */
+    DMA_STATUS_HALF         /**< 传输过半 */
 } dma_status_t;
 
 /* DMA传输事件类型 */
@@ -75,9 +77,15 @@ typedef enum {
     DMA_REQUEST_ADC,         /**< ADC请求 */
     DMA_REQUEST_DAC,         /**< DAC请求 */
     DMA_REQUEST_TIMER,       /**< 定时器请求 */
+    DMA_REQUEST_SDIO_TX,     /**< SDIO发送请求 */
+    DMA_REQUEST_SDIO_RX,     /**< SDIO接收请求 */
     DMA_REQUEST_CUSTOM       /**< 自定义请求 */
 } dma_request_t;
 
+/* 外设请求标识，由请求类型和外设实例组成，用于分配数据流时检查请求线冲突 */
+#define DMA_REQUEST_ID(request, instance)  ((((uint32_t)(request) + 1U) << 8) | ((uint32_t)(instance) & 0xFFU))
+#define DMA_REQUEST_ID_NONE                0U
+
 /* DMA配置 */
 typedef struct {
     dma_direction_t direction;   /**< 传输方向 */
@@ -173,31 +181,113 @@ api_status_t dma_update_memory_address(uint8_t channel, void *address, bool is_s
  * @brief 获取可用的DMA通道
  *
  * @param channel 获取到的通道号
- * @return api_status_t 操作状态
+ * @return int 0表示成功，非0表示失败
+ */
+int dma_get_available_channel(uint8_t *channel);
+
+/**
+ * @brief 按优先级分配空闲DMA通道并初始化
+ *
+ * 在候选通道中选择空闲通道，高优先级请求优先获得仲裁优先级高的通道。
+ * 同一外设请求标识同时只能被一个通道占用，冲突时返回失败。
+ * 通过dma_deinit释放
+ *
+ * @param stream_mask 候选通道位图，bit n对应通道号n，0表示任意通道
+ * @param request_id 外设请求标识(DMA_REQUEST_ID)，内存到内存传输使用DMA_REQUEST_ID_NONE
+ * @param config DMA配置参数
+ * @param callback 传输完成回调
+ * @param arg 回调参数
+ * @param handle 返回的DMA句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int dma_alloc(uint32_t stream_mask, uint32_t request_id, const dma_config_t *config,
+              dma_callback_t callback, void *arg, driver_handle_t *handle);
+
+/**
+ * @brief 初始化DMA内存拷贝引擎
+ *
+ * 分配内存拷贝专用通道并创建同步对象，使用RTOS时需在rtos_init之后调用一次；
+ * 未初始化时dma_memcpy/dma_memcpy_async由CPU完成拷贝
+ *
+ * @return int 0表示成功，非0表示失败
  */
-api_status_t dma_get_available_channel(uint8_t *channel);
+int dma_memcpy_init(void);
 
 /**
  * @brief 执行DMA内存拷贝(阻塞)
  *
+ * 小块拷贝、带D-Cache的平台上未按缓存行对齐的目标以及引擎忙时由CPU直接完成
+ *
  * @param dst_addr 目标地址
  * @param src_addr 源地址
  * @param length 长度
- * @return api_status_t 操作状态
+ * @return int 0表示成功，非0表示失败
  */
-api_status_t dma_memcpy(void *dst_addr, const void *src_addr, uint32_t length);
+int dma_memcpy(void *dst_addr, const void *src_addr, uint32_t length);
 
 /**
  * @brief 执行DMA内存拷贝(非阻塞)
  *
+ * 请求按提交顺序执行；小于平台阈值的拷贝以及带D-Cache的平台上未按缓存行
+ * 对齐的目标由CPU立即完成，回调在返回前调用
+ *
  * @param dst_addr 目标地址
  * @param src_addr 源地址
  * @param length 长度
  * @param callback 完成回调
  * @param user_data 用户数据
- * @return api_status_t 操作状态
+ * @return int 0表示成功，非0表示失败
+ */
+int dma_memcpy_async(void *dst_addr, const void *src_addr, uint32_t length, dma_callback_t callback, void *user_data);
+
+/**
+ * @brief 设置DMA内存地址是否自增
+ *
+ * @param handle DMA句柄
+ * @param enable 是否自增
+ * @return int 0表示成功，非0表示失败
+ */
+int dma_set_memory_increment(driver_handle_t handle, bool enable);
+
+/**
+ * @brief 使能或禁用DMA半传输中断
+ *
+ * 使能后回调在传输过半时以DMA_STATUS_HALF调用，主要用于循环模式
+ *
+ * @param handle DMA句柄
+ * @param enable 是否使能
+ * @return int 0表示成功，非0表示失败
+ */
+int dma_set_half_transfer_interrupt(driver_handle_t handle, bool enable);
+
+/**
+ * @brief 设置DMA数据流的中断优先级并使能其中断线
+ *
+ * @param handle DMA句柄
+ * @param priority 中断抢占优先级
+ * @return int 0表示成功，非0表示失败
+ */
+int dma_enable_irq(driver_handle_t handle, uint32_t priority);
+
+/**
+ * @brief 设置DMA数据流的请求通道
+ *
+ * @param handle DMA句柄
+ * @param request 平台相关的请求通道编号
+ * @return int 0表示成功，非0表示失败
+ */
+int dma_set_request_line(driver_handle_t handle, uint32_t request);
+
+/**
+ * @brief 使能或禁用DMA数据流的FIFO突发传输
+ *
+ * 使能后数据流经FIFO缓冲，以4拍突发访问内存和外设；禁用时为直接模式
+ *
+ * @param handle DMA句柄
+ * @param enable 是否使能
+ * @return int 0表示成功，非0表示失败
  */
-api_status_t dma_memcpy_async(void *dst_addr, const void *src_addr, uint32_t length, dma_callback_t callback, void *user_data);
+int dma_set_fifo_burst(driver_handle_t handle, bool enable);
 
 #ifdef __cplusplus
 }
@@ -73,6 +73,36 @@ api_status_t flash_read(flash_handle_t handle, uint32_t addr, void *data, uint32
  */
 api_status_t flash_write(flash_handle_t handle, uint32_t addr, const void *data, uint32_t len);
 
+/**
+ * @brief 开始顺序写入会话
+ *
+ * 会话期间Flash保持解锁，追加的数据按器件编程宽度暂存后连续编程，
+ * 适合OTA镜像等大块顺序写入
+ * 
+ * @param handle Flash设备句柄
+ * @param addr 起始地址，不需要对齐
+ * @return api_status_t 操作状态
+ */
+api_status_t flash_write_begin(flash_handle_t handle, uint32_t addr);
+
+/**
+ * @brief 在顺序写入会话中追加数据
+ * 
+ * @param handle Flash设备句柄
+ * @param data 数据缓冲区
+ * @param len 数据长度，不需要对齐
+ * @return api_status_t 操作状态
+ */
+api_status_t flash_write_stream(flash_handle_t handle, const void *data, uint32_t len);
+
+/**
+ * @brief 结束顺序写入会话，编程暂存的剩余数据并重新锁定Flash
+ * 
+ * @param handle Flash设备句柄
+ * @return api_status_t 操作状态
+ */
+api_status_t flash_write_end(flash_handle_t handle);
+
 /**
  * @brief 擦除Flash扇区
  * 
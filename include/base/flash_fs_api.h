@@ -0,0 +1,118 @@
+/**
+ * @file flash_fs_api.h
+ * @brief Flash写时复制文件系统配置接口定义
+ *
+ * 该头文件定义了直接运行在flash_api.h之上的filesystem_api.h实现的配置。
+ * 文件系统参照LittleFS的结构：目录项保存在追加写入、带CRC的元数据日志中，
+ * 每次元数据修改是一次原子提交；文件数据按写时复制写入新块，在fs_flush或
+ * fs_close时随一次提交生效，任意时刻掉电后挂载得到的都是最后一次完整提交的
+ * 状态，挂载只读取超级块和元数据块，不扫描整个分区。RAM占用由下面的配置项
+ * 在编译期确定，与文件数量和文件大小无关。
+ *
+ * 挂载时fs_mount_config_t.type为FS_TYPE_LITTLEFS或FS_TYPE_CUSTOM，
+ * fs_config指向flash_fs_config_t。
+ */
+
+#ifndef FLASH_FS_API_H
+#define FLASH_FS_API_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "base/flash_api.h"
+#include "base/filesystem_api.h"
+
+#if (CURRENT_RTOS != RTOS_NONE)
+#include "common/rtos_api.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 可同时挂载的文件系统数量 */
+#ifndef CONFIG_FLASH_FS_MAX_MOUNTS
+#define CONFIG_FLASH_FS_MAX_MOUNTS      1
+#endif
+
+/* 每个文件系统的目录项数量上限，包括根目录 */
+#ifndef CONFIG_FLASH_FS_MAX_ENTRIES
+#define CONFIG_FLASH_FS_MAX_ENTRIES     64
+#endif
+
+/* 每个文件系统可同时打开的文件数量 */
+#ifndef CONFIG_FLASH_FS_MAX_OPEN_FILES
+#define CONFIG_FLASH_FS_MAX_OPEN_FILES  4
+#endif
+
+/* 每个文件系统可同时打开的目录数量 */
+#ifndef CONFIG_FLASH_FS_MAX_OPEN_DIRS
+#define CONFIG_FLASH_FS_MAX_OPEN_DIRS   2
+#endif
+
+/* 文件名最大长度(字节) */
+#ifndef CONFIG_FLASH_FS_NAME_MAX
+#define CONFIG_FLASH_FS_NAME_MAX        32
+#endif
+
+/* 每个打开文件的编程缓存大小(字节)，不超过该大小的文件内联在元数据中 */
+#ifndef CONFIG_FLASH_FS_CACHE_SIZE
+#define CONFIG_FLASH_FS_CACHE_SIZE      64
+#endif
+
+/* 分配器前瞻窗口的块数，必须为32的倍数 */
+#ifndef CONFIG_FLASH_FS_LOOKAHEAD
+#define CONFIG_FLASH_FS_LOOKAHEAD       128
+#endif
+
+#if CONFIG_FLASH_FS_MAX_ENTRIES < 2 || CONFIG_FLASH_FS_MAX_ENTRIES > 4095
+#error "CONFIG_FLASH_FS_MAX_ENTRIES must be between 2 and 4095"
+#endif
+
+#if (CONFIG_FLASH_FS_CACHE_SIZE % 4) != 0 || CONFIG_FLASH_FS_CACHE_SIZE < CONFIG_FLASH_FS_NAME_MAX + 4
+#error "CONFIG_FLASH_FS_CACHE_SIZE must be a multiple of 4 and hold a name record"
+#endif
+
+#if CONFIG_FLASH_FS_NAME_MAX > 255
+#error "CONFIG_FLASH_FS_NAME_MAX must not exceed 255"
+#endif
+
+#if (CONFIG_FLASH_FS_LOOKAHEAD % 32) != 0 || CONFIG_FLASH_FS_LOOKAHEAD == 0
+#error "CONFIG_FLASH_FS_LOOKAHEAD must be a non-zero multiple of 32"
+#endif
+
+/* 分区配置 */
+typedef struct {
+    flash_handle_t flash;           /**< Flash设备句柄 */
+    uint32_t base_address;          /**< 分区起始地址，按块对齐 */
+    uint32_t block_size;            /**< 块大小，Flash扇区大小的整数倍，至少512字节 */
+    uint32_t block_count;           /**< 块数量，至少6块 */
+    uint32_t block_cycles;          /**< 元数据块对每压缩该次数迁移到新块，0表示不迁移 */
+} flash_fs_config_t;
+
+/* 统计信息 */
+typedef struct {
+    uint32_t block_count;           /**< 块总数 */
+    uint32_t used_blocks;           /**< 已用块数，包括超级块和元数据块 */
+    uint32_t entries;               /**< 文件与目录数量 */
+    uint32_t meta_revision;         /**< 元数据块对修订号 */
+    uint32_t meta_used;             /**< 元数据日志已用字节数 */
+    uint32_t commits;               /**< 本次挂载后的元数据提交次数 */
+    uint32_t compactions;           /**< 本次挂载后的元数据压缩次数 */
+    uint32_t relocations;           /**< 本次挂载后的元数据块对迁移次数 */
+    uint32_t inplace_appends;       /**< 直接续写尾块剩余空间的次数 */
+} flash_fs_stats_t;
+
+/**
+ * @brief 获取文件系统统计信息
+ *
+ * @param handle 文件系统句柄
+ * @param stats 统计信息输出
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_fs_get_stats(fs_handle_t handle, flash_fs_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FLASH_FS_API_H */
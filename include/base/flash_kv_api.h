@@ -0,0 +1,224 @@
+/**
+ * @file flash_kv_api.h
+ * @brief Flash日志结构键值存储接口定义
+ *
+ * 该头文件定义了基于flash_api.h的日志结构键值存储。每次写入只在当前写入
+ * 扇区末尾追加一条带CRC的小记录，不擦除也不重写扇区；挂载时顺序扫描所有
+ * 扇区在RAM中重建哈希索引。扇区写满后按写入顺序循环使用，最旧的扇区中
+ * 仍有效的记录被逐步迁移到写入端后擦除，所有扇区的擦除次数保持均衡。
+ * 写入中途掉电只会丢失正在写入的记录。
+ */
+
+#ifndef FLASH_KV_API_H
+#define FLASH_KV_API_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "base/flash_api.h"
+#include "common/error_api.h"
+
+#if (CURRENT_RTOS != RTOS_NONE)
+#include "common/rtos_api.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 最大键数量 */
+#ifndef CONFIG_FLASH_KV_MAX_KEYS
+#define CONFIG_FLASH_KV_MAX_KEYS        128
+#endif
+
+/* 哈希索引槽位数，必须为2的幂且大于最大键数量 */
+#ifndef CONFIG_FLASH_KV_INDEX_SIZE
+#define CONFIG_FLASH_KV_INDEX_SIZE      256
+#endif
+
+/* 键最大长度(字节) */
+#ifndef CONFIG_FLASH_KV_MAX_KEY_LEN
+#define CONFIG_FLASH_KV_MAX_KEY_LEN     32
+#endif
+
+/* 值最大长度(字节) */
+#ifndef CONFIG_FLASH_KV_MAX_VALUE_LEN
+#define CONFIG_FLASH_KV_MAX_VALUE_LEN   256
+#endif
+
+/* 最大扇区数量 */
+#ifndef CONFIG_FLASH_KV_MAX_SECTORS
+#define CONFIG_FLASH_KV_MAX_SECTORS     16
+#endif
+
+/* 空闲扇区不多于该值时，每次写入顺带迁移的记录数 */
+#ifndef CONFIG_FLASH_KV_GC_STEP
+#define CONFIG_FLASH_KV_GC_STEP         4
+#endif
+
+/* 启动增量回收的空闲扇区数 */
+#ifndef CONFIG_FLASH_KV_GC_THRESHOLD
+#define CONFIG_FLASH_KV_GC_THRESHOLD    2
+#endif
+
+#if (CONFIG_FLASH_KV_INDEX_SIZE & (CONFIG_FLASH_KV_INDEX_SIZE - 1)) != 0 || \
+    CONFIG_FLASH_KV_INDEX_SIZE <= CONFIG_FLASH_KV_MAX_KEYS
+#error "CONFIG_FLASH_KV_INDEX_SIZE must be a power of two larger than CONFIG_FLASH_KV_MAX_KEYS"
+#endif
+
+/* 记录头大小 */
+#define FLASH_KV_RECORD_HEADER_SIZE     8
+
+/* 单条记录最大长度，按4字节对齐 */
+#define FLASH_KV_RECORD_MAX_SIZE \
+    ((FLASH_KV_RECORD_HEADER_SIZE + CONFIG_FLASH_KV_MAX_KEY_LEN + CONFIG_FLASH_KV_MAX_VALUE_LEN + 3) & ~3U)
+
+/* 错误码定义 */
+#define FLASH_KV_OK              0   /**< 操作成功 */
+#define FLASH_KV_INVALID_PARAM  -1   /**< 无效参数 */
+#define FLASH_KV_NOT_FOUND      -2   /**< 键不存在 */
+#define FLASH_KV_NO_SPACE       -3   /**< 存储空间或索引已满 */
+#define FLASH_KV_IO_ERROR       -4   /**< Flash读写失败 */
+
+/* 存储区域配置 */
+typedef struct {
+    flash_handle_t flash;           /**< Flash设备句柄 */
+    uint32_t base_address;          /**< 区域起始地址，按扇区对齐 */
+    uint32_t sector_size;           /**< 扇区大小，区域内各扇区必须等大 */
+    uint16_t sector_count;          /**< 扇区数量，至少2个 */
+} flash_kv_config_t;
+
+/* 哈希索引项 */
+typedef struct {
+    uint32_t hash;                  /**< 键哈希 */
+    uint32_t address;               /**< 最新记录地址 */
+} flash_kv_index_entry_t;
+
+/* 扇区状态 */
+typedef struct {
+    uint32_t erase_count;           /**< 擦除次数 */
+    uint32_t seq;                   /**< 启用顺序，空闲扇区为0xFFFFFFFF */
+    uint32_t write_offset;          /**< 下一条记录的偏移 */
+} flash_kv_sector_t;
+
+/* 统计信息 */
+typedef struct {
+    uint32_t keys;                  /**< 键数量 */
+    uint32_t free_sectors;          /**< 空闲扇区数 */
+    uint32_t gc_copies;             /**< 回收时迁移的记录数 */
+    uint32_t erases;                /**< 本次挂载后的擦除次数 */
+    uint32_t min_erase_count;       /**< 最小扇区擦除次数 */
+    uint32_t max_erase_count;       /**< 最大扇区擦除次数 */
+    uint32_t corrupt_records;       /**< 挂载时发现的损坏记录数 */
+} flash_kv_stats_t;
+
+/**
+ * @brief 键值存储对象
+ *
+ * 由调用者分配，字段由存储内部维护
+ */
+typedef struct {
+    flash_kv_config_t config;                                   /**< 区域配置 */
+    flash_kv_sector_t sectors[CONFIG_FLASH_KV_MAX_SECTORS];     /**< 扇区状态 */
+    flash_kv_index_entry_t index[CONFIG_FLASH_KV_INDEX_SIZE];   /**< 哈希索引 */
+    uint32_t key_count;                                         /**< 键数量 */
+    uint32_t free_count;                                        /**< 空闲扇区数 */
+    uint32_t next_seq;                                          /**< 下一个扇区启用顺序 */
+    uint16_t head;                                              /**< 当前写入扇区 */
+    uint16_t gc_sector;                                         /**< 正在回收的扇区 */
+    uint32_t gc_offset;                                         /**< 回收进度 */
+    uint8_t buffer[FLASH_KV_RECORD_MAX_SIZE];                   /**< 记录缓冲区 */
+    flash_kv_stats_t stats;                                     /**< 统计信息 */
+    bool mounted;                                               /**< 是否已挂载 */
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_mutex_t mutex;                                         /**< 互斥锁 */
+#endif
+} flash_kv_t;
+
+/**
+ * @brief 挂载键值存储
+ *
+ * 扫描区域内所有扇区重建索引。未格式化或擦除中途掉电的扇区被擦除后加入
+ * 空闲扇区，因此首次挂载空白区域即完成格式化
+ *
+ * @param kv 键值存储对象
+ * @param config 区域配置
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_kv_mount(flash_kv_t *kv, const flash_kv_config_t *config);
+
+/**
+ * @brief 卸载键值存储
+ *
+ * @param kv 键值存储对象
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_kv_unmount(flash_kv_t *kv);
+
+/**
+ * @brief 擦除区域内全部数据并重新挂载
+ *
+ * 配置不合法时不擦除任何扇区。kv须为清零或经过挂载/卸载的对象，已挂载时先卸载
+ *
+ * @param kv 键值存储对象
+ * @param config 区域配置
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_kv_format(flash_kv_t *kv, const flash_kv_config_t *config);
+
+/**
+ * @brief 写入键值
+ *
+ * 追加一条新记录，旧记录成为待回收空间
+ *
+ * @param kv 键值存储对象
+ * @param key 以0结尾的键，长度不超过CONFIG_FLASH_KV_MAX_KEY_LEN
+ * @param value 值
+ * @param len 值长度，不超过CONFIG_FLASH_KV_MAX_VALUE_LEN
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_kv_set(flash_kv_t *kv, const char *key, const void *value, uint16_t len);
+
+/**
+ * @brief 读取键值
+ *
+ * @param kv 键值存储对象
+ * @param key 键
+ * @param value 值输出缓冲区，值较长时只复制前size字节
+ * @param size 缓冲区大小
+ * @return int 值的实际长度，负值表示错误
+ */
+int flash_kv_get(flash_kv_t *kv, const char *key, void *value, uint16_t size);
+
+/**
+ * @brief 删除键
+ *
+ * @param kv 键值存储对象
+ * @param key 键
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_kv_delete(flash_kv_t *kv, const char *key);
+
+/**
+ * @brief 执行一步增量回收
+ *
+ * 写入时已自动进行，空闲时调用可以提前准备空闲扇区，缩短之后写入的耗时
+ *
+ * @param kv 键值存储对象
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_kv_gc_step(flash_kv_t *kv);
+
+/**
+ * @brief 获取统计信息
+ *
+ * @param kv 键值存储对象
+ * @param stats 统计信息输出
+ * @return int 0表示成功，非0表示失败
+ */
+int flash_kv_get_stats(flash_kv_t *kv, flash_kv_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FLASH_KV_API_H */
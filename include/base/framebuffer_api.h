@@ -0,0 +1,344 @@
+/**
+ * @file framebuffer_api.h
+ * @brief 帧缓冲与二维光栅接口定义
+ *
+ * 该头文件定义了与显示设备无关的帧缓冲。绘制在调用者提供的内存中完成，
+ * 只做一次裁剪，之后按行以32位字填充和复制，不再逐像素经过驱动句柄和边界
+ * 检查；绘制过的区域合并为一个脏矩形，由framebuffer_flush一次交给显示驱动。
+ *
+ * 像素格式：
+ * - FRAMEBUFFER_FORMAT_MONO：每像素1位，行内低位在前，与display_draw_bitmap
+ *   的位图格式相同
+ * - FRAMEBUFFER_FORMAT_GRAY8：每像素1字节
+ * - FRAMEBUFFER_FORMAT_RGB565：每像素2字节，按CPU字节序存放
+ *
+ * 每行长度按4字节对齐，内存也须4字节对齐。
+ */
+
+#ifndef FRAMEBUFFER_API_H
+#define FRAMEBUFFER_API_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 错误码定义 */
+#define FRAMEBUFFER_OK              0   /**< 操作成功 */
+#define FRAMEBUFFER_INVALID_PARAM  -1   /**< 无效参数 */
+#define FRAMEBUFFER_NO_MEMORY      -2   /**< 内存不足以容纳帧缓冲 */
+#define FRAMEBUFFER_FLUSH_ERROR    -3   /**< 刷新回调失败 */
+#define FRAMEBUFFER_NOT_SUPPORTED  -4   /**< 格式不匹配或不支持 */
+
+/* 透明背景色，用于位图和字符绘制 */
+#define FRAMEBUFFER_TRANSPARENT     0xFFFFFFFFUL
+
+/* 字形缓存项数量上限 */
+#ifndef CONFIG_FRAMEBUFFER_GLYPH_ENTRIES
+#define CONFIG_FRAMEBUFFER_GLYPH_ENTRIES    16
+#endif
+
+/* 像素格式 */
+typedef enum {
+    FRAMEBUFFER_FORMAT_MONO = 0,        /**< 1位单色 */
+    FRAMEBUFFER_FORMAT_GRAY8,           /**< 8位灰度 */
+    FRAMEBUFFER_FORMAT_RGB565           /**< 16位RGB565 */
+} framebuffer_format_t;
+
+/* 每个像素的位数 */
+#define FRAMEBUFFER_BPP(format) \
+    ((format) == FRAMEBUFFER_FORMAT_MONO ? 1 : ((format) == FRAMEBUFFER_FORMAT_GRAY8 ? 8 : 16))
+
+/* 行长度(字节)，按4字节对齐 */
+#define FRAMEBUFFER_STRIDE(width, format) \
+    (((((uint32_t)(width) * FRAMEBUFFER_BPP(format) + 7) / 8) + 3) & ~3UL)
+
+/* 帧缓冲所需内存大小(字节) */
+#define FRAMEBUFFER_SIZE(width, height, format) \
+    (FRAMEBUFFER_STRIDE(width, format) * (uint32_t)(height))
+
+/* 矩形区域 */
+typedef struct {
+    int16_t x;                          /**< 左上角X坐标 */
+    int16_t y;                          /**< 左上角Y坐标 */
+    uint16_t width;                     /**< 宽度 */
+    uint16_t height;                    /**< 高度 */
+} framebuffer_rect_t;
+
+/**
+ * @brief 点阵字体
+ *
+ * 字形按字符编码连续存放，每个字形height行，每行补齐到整字节，低位在前
+ */
+typedef struct {
+    uint8_t width;                      /**< 字符宽度 */
+    uint8_t height;                     /**< 字符高度 */
+    uint8_t spacing;                    /**< 字符间距 */
+    uint8_t first;                      /**< 第一个字符的编码 */
+    uint8_t last;                       /**< 最后一个字符的编码 */
+    const uint8_t *data;                /**< 字形数据 */
+} framebuffer_font_t;
+
+/**
+ * @brief 把区域内容写入显示设备
+ *
+ * data指向区域左上角像素所在的字节，相邻行相隔stride字节。单色格式下区域的
+ * X坐标和宽度按8像素对齐(宽度在右边界处截断)，每行可直接作为display_draw_bitmap
+ * 的位图行；其他格式可逐行交给display_draw_image
+ *
+ * @param context 回调上下文
+ * @param area 区域
+ * @param data 区域数据
+ * @param stride 行长度(字节)
+ * @return int 0表示成功，非0表示失败
+ */
+typedef int (*framebuffer_flush_func_t)(void *context, const framebuffer_rect_t *area,
+                                        const void *data, uint32_t stride);
+
+/* 帧缓冲配置 */
+typedef struct {
+    uint16_t width;                     /**< 宽度(像素) */
+    uint16_t height;                    /**< 高度(像素) */
+    framebuffer_format_t format;        /**< 像素格式 */
+    void *memory;                       /**< 像素内存，4字节对齐 */
+    uint32_t memory_size;               /**< 像素内存大小，不小于FRAMEBUFFER_SIZE */
+    void *glyph_cache;                  /**< 字形缓存内存，4字节对齐，NULL表示不缓存 */
+    uint32_t glyph_cache_size;          /**< 字形缓存内存大小(字节) */
+    uint16_t glyph_slot_size;           /**< 每个缓存字形的最大字节数 */
+    framebuffer_flush_func_t flush;     /**< 刷新回调，可为NULL */
+    void *flush_context;                /**< 刷新回调上下文 */
+} framebuffer_config_t;
+
+/* 统计信息 */
+typedef struct {
+    uint32_t glyph_hits;                /**< 字形缓存命中次数 */
+    uint32_t glyph_misses;              /**< 字形缓存未命中次数 */
+    uint32_t flushes;                   /**< 刷新回调次数 */
+    uint32_t flushed_pixels;            /**< 刷新的像素数 */
+} framebuffer_stats_t;
+
+/* 字形缓存项 */
+typedef struct {
+    const framebuffer_font_t *font;     /**< 字体，NULL表示空闲 */
+    uint32_t color;                     /**< 前景色 */
+    uint32_t bg_color;                  /**< 背景色 */
+    uint32_t last_used;                 /**< 最近使用时间戳 */
+    uint8_t ch;                         /**< 字符编码 */
+} framebuffer_glyph_t;
+
+/**
+ * @brief 帧缓冲对象
+ *
+ * 由调用者分配，字段由帧缓冲内部维护
+ */
+typedef struct {
+    framebuffer_config_t config;        /**< 配置 */
+    uint8_t *pixels;                    /**< 像素数据 */
+    uint32_t stride;                    /**< 行长度(字节) */
+    int16_t clip_x0;                    /**< 裁剪区域左边界 */
+    int16_t clip_y0;                    /**< 裁剪区域上边界 */
+    int16_t clip_x1;                    /**< 裁剪区域右边界(不含) */
+    int16_t clip_y1;                    /**< 裁剪区域下边界(不含) */
+    int16_t dirty_x0;                   /**< 脏矩形左边界 */
+    int16_t dirty_y0;                   /**< 脏矩形上边界 */
+    int16_t dirty_x1;                   /**< 脏矩形右边界(不含)，不大于dirty_x0表示没有脏区域 */
+    int16_t dirty_y1;                   /**< 脏矩形下边界(不含) */
+    framebuffer_glyph_t glyphs[CONFIG_FRAMEBUFFER_GLYPH_ENTRIES]; /**< 字形缓存项 */
+    uint16_t glyph_count;               /**< 可用的字形缓存项数 */
+    uint32_t glyph_clock;               /**< 字形缓存时间戳 */
+    framebuffer_stats_t stats;          /**< 统计信息 */
+    bool initialized;                   /**< 是否已初始化 */
+} framebuffer_t;
+
+/**
+ * @brief 初始化帧缓冲
+ *
+ * 像素内容不被清除，裁剪区域为整个帧缓冲
+ *
+ * @param fb 帧缓冲对象
+ * @param config 配置
+ * @return int 0表示成功，非0表示失败
+ */
+int framebuffer_init(framebuffer_t *fb, const framebuffer_config_t *config);
+
+/**
+ * @brief 设置裁剪区域
+ *
+ * @param fb 帧缓冲对象
+ * @param rect 裁剪区域，NULL表示整个帧缓冲
+ * @return int 0表示成功，非0表示失败
+ */
+int framebuffer_set_clip(framebuffer_t *fb, const framebuffer_rect_t *rect);
+
+/**
+ * @brief 用颜色填充裁剪区域
+ *
+ * @param fb 帧缓冲对象
+ * @param color 颜色
+ * @return int 0表示成功，非0表示失败
+ */
+int framebuffer_fill(framebuffer_t *fb, uint32_t color);
+
+/**
+ * @brief 填充矩形
+ *
+ * @param fb 帧缓冲对象
+ * @param x 左上角X坐标
+ * @param y 左上角Y坐标
+ * @param width 宽度
+ * @param height 高度
+ * @param color 颜色
+ * @return int 0表示成功，非0表示失败
+ */
+int framebuffer_fill_rect(framebuffer_t *fb, int16_t x, int16_t y, uint16_t width, uint16_t height, uint32_t color);
+
+/**
+ * @brief 设置像素
+ *
+ * @param fb 帧缓冲对象
+ * @param x X坐标
+ * @param y Y坐标
+ * @param color 颜色
+ * @return int 0表示成功(包括被裁剪)，非0表示失败
+ */
+int framebuffer_set_pixel(framebuffer_t *fb, int16_t x, int16_t y, uint32_t color);
+
+/**
+ * @brief 读取像素
+ *
+ * @param fb 帧缓冲对象
+ * @param x X坐标
+ * @param y Y坐标
+ * @param color 颜色输出，单色格式为0或1
+ * @return int 0表示成功，非0表示坐标超出范围
+ */
+int framebuffer_get_pixel(const framebuffer_t *fb, int16_t x, int16_t y, uint32_t *color);
+
+/**
+ * @brief 画线
+ *
+ * 水平线和竖直线按矩形填充，其余按Bresenham算法绘制
+ *
+ * @param fb 帧缓冲对象
+ * @param x0 起点X坐标
+ * @param y0 起点Y坐标
+ * @param x1 终点X坐标
+ * @param y1 终点Y坐标
+ * @param color 颜色
+ * @return int 0表示成功，非0表示失败
+ */
+int framebuffer_draw_line(framebuffer_t *fb, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint32_t color);
+
+/**
+ * @brief 画矩形边框
+ *
+ * @param fb 帧缓冲对象
+ * @param x 左上角X坐标
+ * @param y 左上角Y坐标
+ * @param width 宽度
+ * @param height 高度
+ * @param color 颜色
+ * @return int 0表示成功，非0表示失败
+ */
+int framebuffer_draw_rect(framebuffer_t *fb, int16_t x, int16_t y, uint16_t width, uint16_t height, uint32_t color);
+
+/**
+ * @brief 复制另一个帧缓冲的区域
+ *
+ * 两个帧缓冲格式必须相同，允许是同一个帧缓冲
+ *
+ * @param fb 目标帧缓冲
+ * @param x 目标X坐标
+ * @param y 目标Y坐标
+ * @param src 源帧缓冲
+ * @param src_rect 源区域，NULL表示整个源帧缓冲
+ * @return int 0表示成功，非0表示失败
+ */
+int framebuffer_blit(framebuffer_t *fb, int16_t x, int16_t y,
+                     const framebuffer_t *src, const framebuffer_rect_t *src_rect);
+
+/**
+ * @brief 绘制单色位图
+ *
+ * 位图按行存放，每行补齐到整字节，低位在前。置位像素画前景色，其余画背景色
+ *
+ * @param fb 帧缓冲对象
+ * @param x 左上角X坐标
+ * @param y 左上角Y坐标
+ * @param width 位图宽度
+ * @param height 位图高度
+ * @param bitmap 位图数据
+ * @param color 前景色
+ * @param bg_color 背景色，FRAMEBUFFER_TRANSPARENT表示不绘制
+ * @return int 0表示成功，非0表示失败
+ */
+int framebuffer_draw_bitmap(framebuffer_t *fb, int16_t x, int16_t y, uint16_t width, uint16_t height,
+                            const uint8_t *bitmap, uint32_t color, uint32_t bg_color);
+
+/**
+ * @brief 绘制字符
+ *
+ * 非单色格式下不透明字符按像素格式渲染后存入字形缓存，再次绘制时逐行复制
+ *
+ * @param fb 帧缓冲对象
+ * @param x 左上角X坐标
+ * @param y 左上角Y坐标
+ * @param font 字体
+ * @param ch 字符
+ * @param color 前景色
+ * @param bg_color 背景色，FRAMEBUFFER_TRANSPARENT表示不绘制
+ * @return int 0表示成功，非0表示失败
+ */
+int framebuffer_draw_char(framebuffer_t *fb, int16_t x, int16_t y, const framebuffer_font_t *font,
+                          char ch, uint32_t color, uint32_t bg_color);
+
+/**
+ * @brief 绘制字符串
+ *
+ * 遇到'\n'时换到下一行
+ *
+ * @param fb 帧缓冲对象
+ * @param x 左上角X坐标
+ * @param y 左上角Y坐标
+ * @param font 字体
+ * @param str 字符串
+ * @param color 前景色
+ * @param bg_color 背景色，FRAMEBUFFER_TRANSPARENT表示不绘制
+ * @return int 0表示成功，非0表示失败
+ */
+int framebuffer_draw_string(framebuffer_t *fb, int16_t x, int16_t y, const framebuffer_font_t *font,
+                            const char *str, uint32_t color, uint32_t bg_color);
+
+/**
+ * @brief 标记整个帧缓冲为脏
+ *
+ * @param fb 帧缓冲对象
+ */
+void framebuffer_invalidate(framebuffer_t *fb);
+
+/**
+ * @brief 把脏矩形交给刷新回调
+ *
+ * 没有脏区域时不调用回调
+ *
+ * @param fb 帧缓冲对象
+ * @return int 0表示成功，非0表示失败(脏区域保留)
+ */
+int framebuffer_flush(framebuffer_t *fb);
+
+/**
+ * @brief 获取统计信息
+ *
+ * @param fb 帧缓冲对象
+ * @param stats 统计信息输出
+ * @return int 0表示成功，非0表示失败
+ */
+int framebuffer_get_stats(const framebuffer_t *fb, framebuffer_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FRAMEBUFFER_API_H */
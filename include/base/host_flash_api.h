@@ -0,0 +1,119 @@
+/**
+ * @file host_flash_api.h
+ * @brief 主机平台Flash模拟器控制接口定义
+ *
+ * 主机构建中flash_api.h由NOR Flash模拟器实现。模拟器只允许编程把位从1清为0，
+ * 按扇区擦除并要求字对齐；按时序模型累计每次读、编程和擦除的耗时，记录每个
+ * 扇区的擦除次数，并可在任意一次编程或擦除中途注入掉电。存储默认位于内存，
+ * 也可以映射到文件，使内容在进程之间保留。该头文件提供这些模型的控制与观测
+ * 接口，供存储相关代码在主机上做性能测试和掉电测试。
+ */
+
+#ifndef HOST_FLASH_API_H
+#define HOST_FLASH_API_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "base/flash_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 时序模型 */
+typedef struct {
+    uint32_t read_ns_per_byte;          /**< 每字节读取时间(纳秒) */
+    uint32_t program_ns_per_word;       /**< 每32位字编程时间(纳秒) */
+    uint32_t erase_us_per_sector;       /**< 每扇区擦除时间(微秒) */
+    bool realtime;                      /**< true时按模型时间实际延时 */
+} host_flash_timing_t;
+
+/* 模拟器统计信息 */
+typedef struct {
+    uint64_t elapsed_ns;                /**< 按时序模型累计的忙时间(纳秒) */
+    uint32_t read_bytes;                /**< 读取字节数 */
+    uint32_t program_words;             /**< 编程的字数 */
+    uint32_t erase_ops;                 /**< 擦除扇区次数 */
+    uint32_t violations;                /**< 因需要把0写为1而被拒绝的编程次数 */
+    uint32_t worn_out;                  /**< 因超过擦写寿命而失败的擦除次数 */
+    uint32_t power_losses;              /**< 注入的掉电次数 */
+    uint32_t max_erase_count;           /**< 各扇区擦除次数的最大值 */
+} host_flash_stats_t;
+
+/**
+ * @brief 把模拟存储映射到文件
+ *
+ * 文件不存在时创建并填充为全0xFF，已存在时保留其内容。各扇区擦除次数保存
+ * 在文件末尾的页脚中，重新映射时恢复；旧格式文件或扇区数量改变时从零开始。
+ * 只能在Flash未初始化时调用
+ *
+ * @param path 文件路径
+ * @return int 0表示成功，非0表示失败
+ */
+int host_flash_open_file(const char *path);
+
+/**
+ * @brief 解除文件映射并恢复为内存存储
+ *
+ * 只能在Flash未初始化时调用
+ *
+ * @return int 0表示成功，非0表示失败
+ */
+int host_flash_close_file(void);
+
+/**
+ * @brief 擦除整个模拟存储并清零擦除次数和统计信息
+ */
+void host_flash_format(void);
+
+/**
+ * @brief 设置时序模型
+ *
+ * @param timing 时序参数，NULL表示恢复默认值
+ */
+void host_flash_set_timing(const host_flash_timing_t *timing);
+
+/**
+ * @brief 获取统计信息
+ *
+ * @param stats 统计信息输出
+ * @return int 0表示成功，非0表示失败
+ */
+int host_flash_get_stats(host_flash_stats_t *stats);
+
+/**
+ * @brief 清零统计信息，擦除次数保留
+ */
+void host_flash_reset_stats(void);
+
+/**
+ * @brief 获取扇区擦除次数
+ *
+ * @param sector 扇区号
+ * @return uint32_t 擦除次数，扇区号无效时返回0
+ */
+uint32_t host_flash_get_erase_count(uint32_t sector);
+
+/**
+ * @brief 注入掉电
+ *
+ * 从调用起第countdown个编程字或擦除扇区执行到一半时掉电：编程字只有低半字
+ * 被编程，擦除的扇区只有前半部分被擦除。之后所有读写和擦除返回错误，直到
+ * flash_deinit后重新flash_init模拟重新上电
+ *
+ * @param countdown 掉电发生在第几个操作，0表示取消
+ */
+void host_flash_inject_power_loss(uint32_t countdown);
+
+/**
+ * @brief 判断模拟器是否处于掉电状态
+ *
+ * @return bool true表示已掉电，等待重新上电
+ */
+bool host_flash_is_powered_off(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_FLASH_API_H */
@@ -0,0 +1,93 @@
+/**
+ * @file host_tm1681_api.h
+ * @brief 主机平台TM1681模拟传输层接口定义
+ *
+ * 主机构建中提供一个模拟TM1681控制器的传输层：按选通帧解析数据模式、地址
+ * 和控制命令，维护控制器显示RAM并统计收到的帧和字节。异步模式下帧只入队，
+ * 在传输层的wait中才按顺序执行，用于检查帧数据在传输完成前没有被改写。
+ */
+
+#ifndef HOST_TM1681_API_H
+#define HOST_TM1681_API_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "base/tm1681_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 模拟器统计信息 */
+typedef struct {
+    uint32_t frames;                    /**< 执行的选通帧数 */
+    uint32_t bytes;                     /**< 收到的字节数，包括命令 */
+    uint32_t data_bytes;                /**< 写入显示RAM的字节数 */
+    uint32_t commands;                  /**< 地址命令以外的命令数 */
+    uint32_t protocol_errors;           /**< 命令帧后跟随多余数据的次数 */
+    uint32_t max_queued;                /**< 异步模式下同时排队的最大帧数 */
+    uint8_t data_mode;                  /**< 最近一次数据模式命令 */
+    uint8_t last_command;               /**< 最近一次地址命令以外的命令 */
+} host_tm1681_stats_t;
+
+/**
+ * @brief 获取模拟传输层
+ *
+ * @param transport 传输层输出
+ * @param merge_gap 合并间隔
+ */
+void host_tm1681_get_transport(tm1681_transport_t *transport, uint16_t merge_gap);
+
+/**
+ * @brief 复位模拟器
+ *
+ * 丢弃排队的帧，显示RAM填充为0xFF以便检查初始化，统计信息清零并恢复同步模式
+ */
+void host_tm1681_reset(void);
+
+/**
+ * @brief 设置异步模式
+ *
+ * @param async true时帧在wait中才执行
+ */
+void host_tm1681_set_async(bool async);
+
+/**
+ * @brief 获取控制器显示RAM
+ *
+ * @return const uint8_t* TM1681_RAM_SIZE字节的显示RAM
+ */
+const uint8_t *host_tm1681_get_ram(void);
+
+/**
+ * @brief 获取统计信息
+ *
+ * @param stats 统计信息输出
+ * @return int 0表示成功，非0表示失败
+ */
+int host_tm1681_get_stats(host_tm1681_stats_t *stats);
+
+/**
+ * @brief 注入传输错误
+ *
+ * 从调用起第countdown次发送返回错误，帧被丢弃
+ *
+ * @param countdown 出错的发送序号，0表示取消
+ */
+void host_tm1681_inject_error(uint32_t countdown);
+
+/**
+ * @brief 注入等待错误
+ *
+ * 下一次wait返回error。TM1681_TIMEOUT时排队的帧保留在队列中，由之后的wait
+ * 执行；其他错误码时排队的帧被丢弃，与传输失败一样没有写入显示RAM
+ *
+ * @param error 等待返回的错误码，TM1681_OK表示取消
+ */
+void host_tm1681_inject_wait_error(int error);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_TM1681_API_H */
@@ -53,6 +53,58 @@ typedef enum {
 /* I2C设备句柄 */
 typedef driver_handle_t i2c_handle_t;
 
+/* I2C传输分段方向 */
+typedef enum {
+    I2C_SEGMENT_WRITE = 0,   /**< 主机写 */
+    I2C_SEGMENT_READ         /**< 主机读 */
+} i2c_segment_dir_t;
+
+/**
+ * @brief I2C传输分段
+ *
+ * 分段以起始位(首个分段或前一分段带停止位)或重复起始位(方向或设备地址
+ * 改变)开始；与前一分段方向和地址都相同且前一分段未带停止位时，数据紧接
+ * 前一分段连续传输。事务的最后一个分段总是以停止位结束
+ */
+typedef struct {
+    uint16_t dev_addr;       /**< 设备地址(7位) */
+    i2c_segment_dir_t dir;   /**< 传输方向 */
+    uint8_t *data;           /**< 数据缓冲区，写分段时只读 */
+    uint16_t len;            /**< 数据长度，不能为0 */
+    uint8_t flags;           /**< 传输标志，仅I2C_FLAG_STOP有效 */
+} i2c_segment_t;
+
+/* I2C事务状态 */
+typedef enum {
+    I2C_TRANSACTION_IDLE = 0,      /**< 未提交 */
+    I2C_TRANSACTION_QUEUED,        /**< 已入队等待执行 */
+    I2C_TRANSACTION_ACTIVE,        /**< 正在执行 */
+    I2C_TRANSACTION_DONE           /**< 已完成(成功或失败) */
+} i2c_transaction_state_t;
+
+struct i2c_transaction;
+
+/* I2C事务完成回调函数类型，在中断或驱动任务上下文中调用 */
+typedef void (*i2c_transaction_callback_t)(struct i2c_transaction *transaction, int result, void *user_data);
+
+/**
+ * @brief I2C事务
+ *
+ * 由调用者分配，提交后直到完成前不得修改。一个事务可以包含多个设备的
+ * 寄存器突发读写(写寄存器地址、重复起始、连续读)，同一总线上的事务按
+ * 提交顺序依次执行，分段之间在中断中衔接，等待期间不占用CPU
+ */
+typedef struct i2c_transaction {
+    const i2c_segment_t *segments;         /**< 分段描述符数组 */
+    uint32_t segment_count;                /**< 分段数量 */
+    i2c_transaction_callback_t callback;   /**< 完成回调，可为NULL */
+    void *user_data;                       /**< 回调用户数据 */
+    /* 以下字段由驱动维护 */
+    struct i2c_transaction *next;          /**< 队列后继 */
+    volatile i2c_transaction_state_t state; /**< 事务状态 */
+    volatile int result;                   /**< 执行结果，0表示成功 */
+} i2c_transaction_t;
+
 /**
  * @brief 初始化I2C总线
  * 
@@ -65,6 +117,8 @@ api_status_t i2c_init(const i2c_config_t *config, i2c_handle_t *handle);
 /**
  * @brief 反初始化I2C总线
  * 
+ * 正在执行和排队中的事务以ERROR_NOT_INITIALIZED结束，完成回调照常调用
+ * 
  * @param handle I2C设备句柄
  * @return api_status_t 操作状态
  */
@@ -159,6 +213,29 @@ api_status_t i2c_is_device_ready(i2c_handle_t handle, uint16_t dev_addr, uint32_
  */
 api_status_t i2c_scan_devices(i2c_handle_t handle, uint16_t *addr_list, uint8_t list_size, uint8_t *found_count);
 
+/**
+ * @brief 提交I2C事务(非阻塞)
+ *
+ * 事务进入总线队列尾部，总线空闲时立即开始，完成后调用事务回调
+ *
+ * @param handle I2C设备句柄
+ * @param transaction 事务
+ * @return int 0表示成功，非0表示失败
+ */
+int i2c_transaction_submit(i2c_handle_t handle, i2c_transaction_t *transaction);
+
+/**
+ * @brief 执行I2C事务(阻塞)
+ *
+ * 提交事务并等待其完成，超时后取消该事务
+ *
+ * @param handle I2C设备句柄
+ * @param transaction 事务
+ * @param timeout_ms 超时时间(毫秒)，UINT32_MAX表示永久等待
+ * @return int 0表示成功，非0表示失败
+ */
+int i2c_transaction_execute(i2c_handle_t handle, i2c_transaction_t *transaction, uint32_t timeout_ms);
+
 #ifdef __cplusplus
 }
 #endif
@@ -84,6 +84,39 @@ typedef void (*sdio_callback_t)(void *arg, sdio_status_t status);
 /* SDIO设备句柄 */
 typedef driver_handle_t sdio_handle_t;
 
+/* SDIO块请求状态 */
+typedef enum {
+    SDIO_REQUEST_IDLE = 0,                /**< 未提交 */
+    SDIO_REQUEST_QUEUED,                  /**< 已入队等待执行 */
+    SDIO_REQUEST_ACTIVE,                  /**< 正在执行 */
+    SDIO_REQUEST_DONE                     /**< 已完成(成功或失败) */
+} sdio_request_state_t;
+
+struct sdio_request;
+
+/* SDIO块请求完成回调函数类型，在中断上下文中调用 */
+typedef void (*sdio_request_callback_t)(struct sdio_request *request, int result, void *user_data);
+
+/**
+ * @brief SDIO块请求
+ *
+ * 由调用者分配，提交后直到完成前不得修改。请求按提交顺序执行，队列中
+ * 相邻、方向相同且块地址连续的请求合并为一次多块传输(CMD18/CMD25)，
+ * 合并传输中的请求一起完成。写请求在卡完成编程后才完成
+ */
+typedef struct sdio_request {
+    bool write;                           /**< true表示写入，false表示读取 */
+    uint32_t block_addr;                  /**< 起始块地址 */
+    uint32_t block_count;                 /**< 块数量 */
+    void *data;                           /**< 数据缓冲区，4字节对齐时由DMA直接访问 */
+    sdio_request_callback_t callback;     /**< 完成回调，可为NULL */
+    void *user_data;                      /**< 回调用户数据 */
+    /* 以下字段由驱动维护 */
+    struct sdio_request *next;            /**< 队列后继 */
+    volatile sdio_request_state_t state;  /**< 请求状态 */
+    volatile int result;                  /**< 执行结果，0表示成功 */
+} sdio_request_t;
+
 /**
  * @brief 初始化SDIO设备
  * 
@@ -143,6 +176,41 @@ api_status_t sdio_read_blocks(sdio_handle_t handle, uint32_t block_addr, void *d
  */
 api_status_t sdio_write_blocks(sdio_handle_t handle, uint32_t block_addr, const void *data, uint32_t block_count);
 
+/**
+ * @brief 提交SDIO块请求(非阻塞)
+ *
+ * 请求进入队列尾部，总线空闲时立即开始，数据由DMA传输。多块写入前
+ * 通过ACMD23告知卡待写入的块数，使卡可以预先擦除目标区域
+ *
+ * @param handle SDIO设备句柄
+ * @param request 块请求
+ * @return int 0表示成功，非0表示失败
+ */
+int sdio_request_submit(sdio_handle_t handle, sdio_request_t *request);
+
+/**
+ * @brief 执行SDIO块请求(阻塞)
+ *
+ * 提交请求并等待其完成，超时后取消该请求及与其合并传输的请求
+ *
+ * @param handle SDIO设备句柄
+ * @param request 块请求
+ * @param timeout_ms 超时时间(毫秒)，UINT32_MAX表示永久等待
+ * @return int 0表示成功，非0表示失败
+ */
+int sdio_request_execute(sdio_handle_t handle, sdio_request_t *request, uint32_t timeout_ms);
+
+/**
+ * @brief 推进SDIO请求队列
+ *
+ * 写入后查询卡是否已完成编程，完成时结束写请求并启动下一个请求。
+ * 未启用时间轮时，使用sdio_request_submit的裸机应用需在主循环中周期调用
+ *
+ * @param handle SDIO设备句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int sdio_poll(sdio_handle_t handle);
+
 /**
  * @brief 擦除SD卡数据
  * 
@@ -67,6 +67,51 @@ typedef struct {
 /* SPI设备句柄 */
 typedef driver_handle_t spi_handle_t;
 
+/* SPI传输分段（分散-聚集描述符） */
+typedef struct {
+    const void *tx_data;           /**< 发送缓冲区，NULL表示发送0xFF填充 */
+    void *rx_data;                 /**< 接收缓冲区，NULL表示丢弃接收数据 */
+    uint32_t len;                  /**< 分段长度(字节)，不超过65535 */
+} spi_segment_t;
+
+/* SPI事务状态 */
+typedef enum {
+    SPI_TRANSACTION_IDLE = 0,      /**< 未提交 */
+    SPI_TRANSACTION_QUEUED,        /**< 已入队等待执行 */
+    SPI_TRANSACTION_ACTIVE,        /**< 正在执行 */
+    SPI_TRANSACTION_DONE           /**< 已完成(成功或失败) */
+} spi_transaction_state_t;
+
+struct spi_transaction;
+
+/* 片选控制函数类型，active为true时选中设备 */
+typedef void (*spi_cs_func_t)(bool active, void *cs_arg);
+
+/* SPI事务完成回调函数类型，在中断上下文中调用 */
+typedef void (*spi_transaction_callback_t)(struct spi_transaction *transaction, int result, void *user_data);
+
+/**
+ * @brief SPI事务
+ *
+ * 由调用者分配，提交后直到完成前不得修改。同一总线上的事务按提交顺序
+ * 依次执行，每个事务开始前切换到自身的模式与时钟，并在整个分段链期间
+ * 保持片选有效
+ */
+typedef struct spi_transaction {
+    const spi_segment_t *segments;         /**< 分段描述符数组 */
+    uint32_t segment_count;                /**< 分段数量 */
+    spi_mode_t mode;                       /**< 事务使用的SPI模式 */
+    uint32_t clock_hz;                     /**< 事务使用的时钟频率(Hz)，0表示沿用总线初始化时的模式与时钟 */
+    spi_cs_func_t cs_control;              /**< 片选控制函数，NULL表示不控制片选 */
+    void *cs_arg;                          /**< 片选控制函数参数 */
+    spi_transaction_callback_t callback;   /**< 完成回调，可为NULL */
+    void *user_data;                       /**< 回调用户数据 */
+    /* 以下字段由驱动维护 */
+    struct spi_transaction *next;          /**< 队列后继 */
+    volatile spi_transaction_state_t state; /**< 事务状态 */
+    volatile int result;                   /**< 执行结果，0表示成功 */
+} spi_transaction_t;
+
 /**
  * @brief 初始化SPI总线
  * 
@@ -154,6 +199,30 @@ api_status_t spi_set_mode(spi_handle_t handle, spi_mode_t mode);
  */
 api_status_t spi_set_data_width(spi_handle_t handle, spi_data_width_t data_width);
 
+/**
+ * @brief 提交SPI事务(非阻塞)
+ *
+ * 事务进入总线队列尾部，总线空闲时立即开始。所有分段由DMA依次完成，
+ * 分段之间在DMA完成中断中衔接，不需要CPU逐字节参与
+ *
+ * @param handle SPI设备句柄
+ * @param transaction 事务
+ * @return int 0表示成功，非0表示失败
+ */
+int spi_transaction_submit(spi_handle_t handle, spi_transaction_t *transaction);
+
+/**
+ * @brief 执行SPI事务(阻塞)
+ *
+ * 提交事务并等待其完成，超时后取消该事务
+ *
+ * @param handle SPI设备句柄
+ * @param transaction 事务
+ * @param timeout_ms 超时时间(毫秒)，UINT32_MAX表示永久等待
+ * @return int 0表示成功，非0表示失败
+ */
+int spi_transaction_execute(spi_handle_t handle, spi_transaction_t *transaction, uint32_t timeout_ms);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,243 @@
+/**
+ * @file tm1681_api.h
+ * @brief TM1681帧缓冲与传输层接口定义
+ *
+ * 该头文件定义了TM1681显示驱动中与总线无关的部分：按控制器RAM布局存放的
+ * 帧缓冲、控制器RAM影子副本和脏字节位图，以及把刷新内容发送到控制器的
+ * 传输层。传输层以选通帧为单位工作，一帧对应STB一次拉低期间发送的全部字节，
+ * 可以是GPIO模拟时序、SPI+DMA或主机模拟器。
+ *
+ * 异步传输层的write只需把帧排队，帧数据在暂存区中保持有效，直到下一次
+ * 调用传输层的wait返回。刷新因此在帧排队后即返回，调用者可以立即绘制下一帧。
+ */
+
+#ifndef TM1681_API_H
+#define TM1681_API_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 错误码定义 */
+#define TM1681_OK                   0   /**< 操作成功 */
+#define TM1681_INVALID_PARAM       -1   /**< 无效参数 */
+#define TM1681_IO_ERROR            -2   /**< 传输失败 */
+#define TM1681_TIMEOUT             -3   /**< 等待传输完成超时 */
+
+/* 控制器显示RAM大小(字节)，地址命令中有6位地址 */
+#define TM1681_RAM_SIZE             64
+
+/* 数据命令 */
+#define TM1681_CMD_DATA_MODE        0x40    /**< 数据模式命令 */
+#define TM1681_CMD_ADDRESS_MODE     0xC0    /**< 地址命令，低6位为起始地址 */
+#define TM1681_ADDR_AUTO_INC        0x00    /**< 地址自动增加 */
+#define TM1681_ADDR_FIXED           0x04    /**< 固定地址 */
+
+/* 暂存区大小，可容纳最坏情况下一次刷新的全部选通帧以及若干命令 */
+#define TM1681_STAGING_SIZE         (TM1681_RAM_SIZE * 2)
+
+/* 合并间隔，不合并未变字节 */
+#define TM1681_MERGE_NONE           0
+
+/* 合并间隔，每次刷新把全部待写字节合并为一次突发写入 */
+#define TM1681_MERGE_ALL            0xFFFF
+
+/**
+ * @brief 发送一个选通帧
+ *
+ * 拉低STB，按低位在前发送全部字节后拉高STB。异步实现可以只把帧排队后返回，
+ * 数据在wait返回前保持有效
+ *
+ * @param context 传输层上下文
+ * @param data 帧数据，第一个字节为命令
+ * @param length 帧长度(字节)
+ * @return int 0表示成功，非0表示失败
+ */
+typedef int (*tm1681_write_func_t)(void *context, const uint8_t *data, uint16_t length);
+
+/**
+ * @brief 等待已发送的选通帧全部完成
+ *
+ * @param context 传输层上下文
+ * @param timeout_ms 超时时间(毫秒)
+ * @return int 0表示成功，TM1681_IO_ERROR表示有帧发送失败，其他非0值按超时处理
+ */
+typedef int (*tm1681_wait_func_t)(void *context, uint32_t timeout_ms);
+
+/* 传输层描述 */
+typedef struct {
+    tm1681_write_func_t write;          /**< 发送函数 */
+    tm1681_wait_func_t wait;            /**< 等待函数，NULL表示write返回时帧已发送完成 */
+    void *context;                      /**< 传输层上下文 */
+    uint16_t merge_gap;                 /**< 未变字节间隔不超过该值时合并为一次突发写入 */
+} tm1681_transport_t;
+
+/* 统计信息 */
+typedef struct {
+    uint32_t refreshes;                 /**< 刷新次数 */
+    uint32_t frames;                    /**< 发送的选通帧数 */
+    uint32_t bytes;                     /**< 发送的字节数，包括命令 */
+    uint32_t data_bytes;                /**< 写入显示RAM的字节数 */
+    uint32_t waits;                     /**< 因暂存区仍被占用而等待传输的次数 */
+} tm1681_stats_t;
+
+/**
+ * @brief TM1681帧对象
+ *
+ * 由调用者分配，字段由帧缓冲内部维护。缓冲区每字节对应一列中的8行，
+ * 下标x + (y / 8) * width即控制器RAM地址
+ */
+typedef struct {
+    tm1681_transport_t transport;               /**< 传输层 */
+    uint16_t width;                             /**< 宽度(像素) */
+    uint16_t height;                            /**< 高度(像素) */
+    uint16_t size;                              /**< 使用的RAM字节数 */
+    uint16_t dirty_first;                       /**< 第一个脏字节 */
+    uint16_t dirty_last;                        /**< 最后一个脏字节，小于dirty_first表示没有脏字节 */
+    uint16_t staging_used;                      /**< 暂存区中已排队的字节数 */
+    uint16_t queued_first;                      /**< 上次等待成功后排队的第一个数据字节 */
+    uint16_t queued_last;                       /**< 上次等待成功后排队的最后一个数据字节 */
+    uint32_t dirty_map[TM1681_RAM_SIZE / 32];   /**< 脏字节位图 */
+    uint32_t queued_map[TM1681_RAM_SIZE / 32];  /**< 上次等待成功后排队的字节位图 */
+    uint32_t resend_map[TM1681_RAM_SIZE / 32];  /**< 传输失败需要重发的字节位图 */
+    uint8_t buffer[TM1681_RAM_SIZE];            /**< 显示缓冲区 */
+    uint8_t shadow[TM1681_RAM_SIZE];            /**< 控制器RAM当前内容的副本 */
+    uint8_t staging[TM1681_STAGING_SIZE];       /**< 选通帧暂存区 */
+    tm1681_stats_t stats;                       /**< 统计信息 */
+    bool initialized;                           /**< 是否已初始化 */
+} tm1681_frame_t;
+
+/**
+ * @brief 初始化帧对象
+ *
+ * 设置自动增加地址的数据模式并把使用的RAM全部写为0，之后影子副本与控制器
+ * 内容一致。显示模式和亮度等控制命令由调用者通过tm1681_frame_command发送
+ *
+ * @param frame 帧对象
+ * @param width 宽度(像素)
+ * @param height 高度(像素)
+ * @param transport 传输层
+ * @return int 0表示成功，非0表示失败
+ */
+int tm1681_frame_init(tm1681_frame_t *frame, uint16_t width, uint16_t height,
+                      const tm1681_transport_t *transport);
+
+/**
+ * @brief 等待传输完成并释放帧对象
+ *
+ * @param frame 帧对象
+ * @return int 0表示成功，非0表示失败
+ */
+int tm1681_frame_deinit(tm1681_frame_t *frame);
+
+/**
+ * @brief 发送单字节命令
+ *
+ * @param frame 帧对象
+ * @param command 命令
+ * @return int 0表示成功，非0表示失败
+ */
+int tm1681_frame_command(tm1681_frame_t *frame, uint8_t command);
+
+/**
+ * @brief 清空显示缓冲区
+ *
+ * 在下次刷新时生效
+ *
+ * @param frame 帧对象
+ */
+void tm1681_frame_clear(tm1681_frame_t *frame);
+
+/**
+ * @brief 设置像素
+ *
+ * @param frame 帧对象
+ * @param x X坐标
+ * @param y Y坐标
+ * @param on 是否点亮
+ * @return int 0表示成功，非0表示坐标超出范围
+ */
+int tm1681_frame_set_pixel(tm1681_frame_t *frame, uint16_t x, uint16_t y, bool on);
+
+/**
+ * @brief 读取像素
+ *
+ * @param frame 帧对象
+ * @param x X坐标
+ * @param y Y坐标
+ * @param on 像素状态输出
+ * @return int 0表示成功，非0表示坐标超出范围
+ */
+int tm1681_frame_get_pixel(const tm1681_frame_t *frame, uint16_t x, uint16_t y, bool *on);
+
+/**
+ * @brief 写入矩形区域
+ *
+ * 数据按行连续存放，每字节低位在前，行与行之间不补齐
+ *
+ * @param frame 帧对象
+ * @param x X起始坐标
+ * @param y Y起始坐标
+ * @param width 宽度
+ * @param height 高度
+ * @param data 数据
+ * @return int 0表示成功，非0表示区域超出范围
+ */
+int tm1681_frame_set_area(tm1681_frame_t *frame, uint16_t x, uint16_t y,
+                          uint16_t width, uint16_t height, const uint8_t *data);
+
+/**
+ * @brief 绘制位图
+ *
+ * 位图按行存放，每行补齐到整字节，低位在前；超出屏幕的部分被裁剪
+ *
+ * @param frame 帧对象
+ * @param x X起始坐标
+ * @param y Y起始坐标
+ * @param width 位图宽度
+ * @param height 位图高度
+ * @param bitmap 位图数据
+ * @return int 0表示成功，非0表示起点超出范围
+ */
+int tm1681_frame_draw_bitmap(tm1681_frame_t *frame, uint16_t x, uint16_t y,
+                             uint16_t width, uint16_t height, const uint8_t *bitmap);
+
+/**
+ * @brief 刷新显示
+ *
+ * 等待上一次刷新的帧发送完成，再把与控制器内容不同的脏字节按传输层的合并
+ * 间隔组成突发写入帧交给传输层。异步传输层下函数在帧排队后返回
+ *
+ * @param frame 帧对象
+ * @return int 0表示成功，非0表示失败
+ */
+int tm1681_frame_refresh(tm1681_frame_t *frame);
+
+/**
+ * @brief 等待已排队的帧全部发送完成
+ *
+ * 失败时自上次等待成功后排队的字节重新标记为脏，下次刷新重新发送
+ *
+ * @param frame 帧对象
+ * @param timeout_ms 超时时间(毫秒)
+ * @return int 0表示成功，非0表示失败
+ */
+int tm1681_frame_sync(tm1681_frame_t *frame, uint32_t timeout_ms);
+
+/**
+ * @brief 获取统计信息
+ *
+ * @param frame 帧对象
+ * @param stats 统计信息输出
+ * @return int 0表示成功，非0表示失败
+ */
+int tm1681_frame_get_stats(const tm1681_frame_t *frame, tm1681_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TM1681_API_H */
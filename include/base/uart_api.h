@@ -159,6 +159,107 @@ int uart_receive(driver_handle_t handle, uint8_t *data, uint32_t size, uint32_t
  */
 int uart_register_event_callback(driver_handle_t handle, uart_event_callback_t callback, void *user_data);
 
+/**
+ * @brief UART接收数据段回调函数类型
+ *
+ * 数据位于驱动的接收环形缓冲区buffer[offset, offset + length)，不跨越缓冲区
+ * 末尾。回调在中断或驱动接收任务上下文中调用，使用者处理完毕后通过
+ * uart_rx_release归还空间。由驱动任务搬运数据的平台（ESP32）在空间不足时
+ * 暂停读出；DMA循环接收的平台（STM32）无法暂停，未归还的数据在环形缓冲区
+ * 回绕后被覆盖，覆盖的字节数计入统计信息的overrun
+ */
+typedef void (*uart_rx_span_callback_t)(const uint8_t *buffer, uint32_t offset, uint32_t length, void *user_data);
+
+/* UART接收统计信息 */
+typedef struct {
+    uint32_t received;          /**< 接收的字节数 */
+    uint32_t overrun;           /**< 未及时归还而被覆盖的字节数 */
+    uint32_t hw_errors;         /**< 硬件溢出、帧错误、噪声和校验错误次数 */
+} uart_rx_stats_t;
+
+/**
+ * @brief 注册UART接收数据段回调函数
+ *
+ * 注册后接收数据不再复制，每当空闲线、半满或满事件发生时发布新到达的数据段
+ *
+ * @param handle UART句柄
+ * @param callback 回调函数，NULL表示注销
+ * @param user_data 用户数据
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_register_rx_span_callback(driver_handle_t handle, uart_rx_span_callback_t callback, void *user_data);
+
+/**
+ * @brief 归还已处理的接收数据
+ *
+ * @param handle UART句柄
+ * @param length 按到达顺序归还的字节数
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_rx_release(driver_handle_t handle, uint32_t length);
+
+/**
+ * @brief 获取UART接收统计信息
+ *
+ * @param handle UART句柄
+ * @param stats 统计信息输出
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_get_rx_stats(driver_handle_t handle, uart_rx_stats_t *stats);
+
+/**
+ * @brief 合并写入UART发送缓冲区
+ *
+ * 数据追加到双缓冲发送区后立即返回，由驱动按刷新阈值和超时合并后通过DMA
+ * 发出。发送区已满时最多等待timeout_ms
+ *
+ * @param handle UART句柄
+ * @param data 数据
+ * @param len 数据长度
+ * @param timeout_ms 等待发送区空间的超时时间（毫秒），0表示不等待
+ * @return int 写入的字节数，负值表示错误
+ */
+int uart_write(driver_handle_t handle, const uint8_t *data, uint32_t len, uint32_t timeout_ms);
+
+/**
+ * @brief 在发送缓冲区中预留空间
+ *
+ * 调用者直接在预留空间中构造数据，完成后调用uart_tx_commit，避免一次复制
+ *
+ * @param handle UART句柄
+ * @param len 预留长度
+ * @param buffer 返回预留空间的地址
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_tx_reserve(driver_handle_t handle, uint32_t len, uint8_t **buffer);
+
+/**
+ * @brief 提交预留的发送空间
+ *
+ * @param handle UART句柄
+ * @param buffer uart_tx_reserve返回的地址
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_tx_commit(driver_handle_t handle, uint8_t *buffer);
+
+/**
+ * @brief 立即发送已合并的数据
+ *
+ * @param handle UART句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_tx_flush(driver_handle_t handle);
+
+/**
+ * @brief 设置发送合并策略
+ *
+ * @param handle UART句柄
+ * @param threshold 合并数据达到该字节数时立即发送，1表示不合并
+ * @param timeout_ms 数据最长滞留时间（毫秒），0表示仅按阈值和显式刷新
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_tx_set_policy(driver_handle_t handle, uint32_t threshold, uint32_t timeout_ms);
+
 #ifdef __cplusplus
 }
 #endif
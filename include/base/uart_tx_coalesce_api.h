@@ -0,0 +1,209 @@
+/**
+ * @file uart_tx_coalesce_api.h
+ * @brief UART发送合并缓冲区接口定义
+ *
+ * 该头文件定义了平台无关的双缓冲(乒乓)发送合并器。写入者把小块数据追加到
+ * 正在填充的缓冲区，或通过预留/提交接口直接在缓冲区内构造数据；另一个
+ * 缓冲区交由驱动异步发送(通常为DMA)。填充量达到阈值、超过超时时间或显式
+ * 刷新时交换缓冲区，发送完成中断中若已有待发数据则立即接续，使零散写入
+ * 也能接近线速输出，写入者无需逐次等待发送完成。
+ *
+ * 启用时间轮(CONFIG_TIMER_WHEEL_ENABLED)时超时刷新由时间轮定时器执行，
+ * 时间轮由UART驱动初始化；裸机下需周期调用timer_wheel_process。未启用时间轮
+ * 时超时不再计时，硬件空闲即发送，发送期间写入的数据在完成中断中接续发出。
+ */
+
+#ifndef UART_TX_COALESCE_API_H
+#define UART_TX_COALESCE_API_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(CONFIG_TIMER_WHEEL_ENABLED) && CONFIG_TIMER_WHEEL_ENABLED
+#include "common/timer_wheel.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 单个发送缓冲区大小 */
+#ifndef CONFIG_UART_TX_COALESCE_BUF_SIZE
+#define CONFIG_UART_TX_COALESCE_BUF_SIZE    512
+#endif
+
+/* 默认刷新阈值(字节) */
+#ifndef CONFIG_UART_TX_COALESCE_THRESHOLD
+#define CONFIG_UART_TX_COALESCE_THRESHOLD   64
+#endif
+
+/* 默认刷新超时(毫秒) */
+#ifndef CONFIG_UART_TX_COALESCE_TIMEOUT_MS
+#define CONFIG_UART_TX_COALESCE_TIMEOUT_MS  2
+#endif
+
+/* 错误码定义 */
+#define UART_TX_COALESCE_OK              0   /**< 操作成功 */
+#define UART_TX_COALESCE_INVALID_PARAM  -1   /**< 无效参数 */
+#define UART_TX_COALESCE_FULL           -2   /**< 两个缓冲区都不可用 */
+
+/* 驱动提供的操作 */
+typedef struct {
+    /**
+     * 启动一次异步发送，数据在完成前保持不变。发送结束(包括失败)后驱动
+     * 必须调用uart_tx_coalesce_complete，可以在本函数返回前调用
+     */
+    int (*start)(void *ctx, const uint8_t *data, uint32_t len);
+    /** 进入临界区，需与发送完成中断互斥，返回值传给unlock */
+    uint32_t (*lock)(void *ctx);
+    /** 退出临界区 */
+    void (*unlock)(void *ctx, uint32_t key);
+    /** 获取毫秒时间 */
+    uint32_t (*now_ms)(void);
+} uart_tx_coalesce_ops_t;
+
+/* 发送合并统计信息 */
+typedef struct {
+    uint32_t bytes;                 /**< 提交的字节数 */
+    uint32_t writes;                /**< 提交次数 */
+    uint32_t transfers;             /**< 启动的硬件发送次数 */
+    uint32_t full;                  /**< 因缓冲区不可用而拒绝的次数 */
+} uart_tx_coalesce_stats_t;
+
+/**
+ * @brief 发送合并器对象
+ *
+ * 由驱动嵌入到设备结构体中，字段由合并器内部维护
+ */
+typedef struct {
+    uint8_t buf[2][CONFIG_UART_TX_COALESCE_BUF_SIZE];   /**< 乒乓缓冲区 */
+    uint32_t fill[2];                                   /**< 各缓冲区已预留字节数 */
+    uint32_t writers[2];                                /**< 各缓冲区未提交的预留数 */
+    uint8_t fill_index;                                 /**< 正在填充的缓冲区 */
+    uint8_t send_index;                                 /**< 正在发送的缓冲区 */
+    volatile bool busy;                                 /**< 发送进行中 */
+    bool flush_pending;                                 /**< 已请求刷新 */
+    uint32_t first_ms;                                  /**< 填充缓冲区首字节写入时间 */
+    uint32_t threshold;                                 /**< 刷新阈值 */
+    uint32_t timeout_ms;                                /**< 刷新超时 */
+    const uart_tx_coalesce_ops_t *ops;                  /**< 驱动操作 */
+    void *ctx;                                          /**< 驱动上下文 */
+    uart_tx_coalesce_stats_t stats;                     /**< 统计信息 */
+#if defined(CONFIG_TIMER_WHEEL_ENABLED) && CONFIG_TIMER_WHEEL_ENABLED
+    timer_wheel_timer_t flush_timer;                    /**< 超时刷新定时器 */
+#endif
+} uart_tx_coalesce_t;
+
+/**
+ * @brief 初始化发送合并器
+ *
+ * @param tx 合并器对象
+ * @param ops 驱动操作
+ * @param ctx 驱动上下文
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_tx_coalesce_init(uart_tx_coalesce_t *tx, const uart_tx_coalesce_ops_t *ops, void *ctx);
+
+/**
+ * @brief 去初始化发送合并器，停止超时刷新定时器
+ *
+ * 驱动应先停止硬件发送再调用，未发送的数据被丢弃
+ *
+ * @param tx 合并器对象
+ */
+void uart_tx_coalesce_deinit(uart_tx_coalesce_t *tx);
+
+/**
+ * @brief 设置刷新策略
+ *
+ * @param tx 合并器对象
+ * @param threshold 填充量达到该值时立即发送，1表示不合并
+ * @param timeout_ms 首字节写入后超过该时间仍未发送则刷新，0表示仅按阈值和显式刷新
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_tx_coalesce_set_policy(uart_tx_coalesce_t *tx, uint32_t threshold, uint32_t timeout_ms);
+
+/**
+ * @brief 在填充缓冲区中预留连续空间
+ *
+ * 调用者直接在返回的空间中构造数据，完成后调用uart_tx_coalesce_commit。
+ * 预留未提交前该缓冲区不会被发送。启用时间轮时会启动超时定时器，
+ * 需在线程上下文调用
+ *
+ * @param tx 合并器对象
+ * @param len 预留长度，不超过CONFIG_UART_TX_COALESCE_BUF_SIZE
+ * @param buffer 返回预留空间的地址
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_tx_coalesce_reserve(uart_tx_coalesce_t *tx, uint32_t len, uint8_t **buffer);
+
+/**
+ * @brief 提交预留空间
+ *
+ * @param tx 合并器对象
+ * @param buffer uart_tx_coalesce_reserve返回的地址
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_tx_coalesce_commit(uart_tx_coalesce_t *tx, uint8_t *buffer);
+
+/**
+ * @brief 复制数据到填充缓冲区
+ *
+ * @param tx 合并器对象
+ * @param data 数据
+ * @param len 长度
+ * @return int 接受的字节数，缓冲区不足时可能小于len
+ */
+int uart_tx_coalesce_write(uart_tx_coalesce_t *tx, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief 立即发送填充缓冲区中的数据
+ *
+ * 发送进行中时在其完成后接续发送
+ *
+ * @param tx 合并器对象
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_tx_coalesce_flush(uart_tx_coalesce_t *tx);
+
+/**
+ * @brief 检查超时刷新
+ *
+ * 按阈值和超时检查填充缓冲区，需要时立即发送。驱动不依赖该函数刷新，
+ * 可由应用在周期任务中调用
+ *
+ * @param tx 合并器对象
+ */
+void uart_tx_coalesce_poll(uart_tx_coalesce_t *tx);
+
+/**
+ * @brief 通知一次硬件发送结束
+ *
+ * 由驱动在发送完成中断或start返回前调用
+ *
+ * @param tx 合并器对象
+ */
+void uart_tx_coalesce_complete(uart_tx_coalesce_t *tx);
+
+/**
+ * @brief 判断是否所有数据都已交给硬件并发送完毕
+ *
+ * @param tx 合并器对象
+ * @return bool true表示空闲
+ */
+bool uart_tx_coalesce_idle(const uart_tx_coalesce_t *tx);
+
+/**
+ * @brief 获取统计信息
+ *
+ * @param tx 合并器对象
+ * @param stats 统计信息输出
+ * @return int 0表示成功，非0表示失败
+ */
+int uart_tx_coalesce_get_stats(const uart_tx_coalesce_t *tx, uart_tx_coalesce_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UART_TX_COALESCE_API_H */
@@ -2,7 +2,8 @@
  * @file usb_api.h
  * @brief USB接口抽象层定义
  *
- * 该头文件定义了USB设备的统一抽象接口，提供了USB配置、数据传输和状态管理功能
+ * 该头文件定义了USB设备的统一抽象接口，提供了USB配置、数据传输和状态管理功能。
+ * 操作状态、设备句柄和端点上的流接口定义在usb_stream_api.h中
  */
 
 #ifndef USB_API_H
@@ -13,20 +14,12 @@
 #include "common/driver_api.h"
 #include "common/project_config.h"
 #include "common/error_handling.h"
+#include "base/usb_stream_api.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-/* USB操作状态 */
-typedef enum {
-    USB_STATUS_IDLE,        /**< 空闲状态 */
-    USB_STATUS_BUSY,        /**< 忙状态 */
-    USB_STATUS_COMPLETE,    /**< 操作完成 */
-    USB_STATUS_ERROR,       /**< 操作错误 */
-    USB_STATUS_TIMEOUT      /**< 操作超时 */
-} usb_status_t;
-
 /* USB端点类型 */
 typedef enum {
     USB_ENDPOINT_CONTROL,   /**< 控制端点 */
@@ -128,9 +121,6 @@ typedef void (*usb_callback_t)(usb_transfer_t *transfer);
 /* USB事件回调函数类型 */
 typedef void (*usb_event_callback_t)(usb_device_state_t state, void *user_data);
 
-/* USB设备句柄 */
-typedef driver_handle_t usb_handle_t;
-
 /**
  * @brief 初始化USB设备
  * 
@@ -230,6 +220,9 @@ api_status_t usb_receive_data(usb_handle_t handle, uint8_t endpoint_num, void *d
 /**
  * @brief 提交USB传输请求
  * 
+ * 请求在端点的传输队列中排队，最多CONFIG_USB_EP_QUEUE_DEPTH个。前一个传输完成时
+ * 下一个立即开始，批量IN传输以整包结束时自动补发零长度包
+ * 
  * @param handle USB设备句柄
  * @param transfer 传输请求
  * @param callback 完成回调函数
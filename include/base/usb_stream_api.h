@@ -0,0 +1,137 @@
+/**
+ * @file usb_stream_api.h
+ * @brief USB端点流接口定义
+ *
+ * 该头文件定义了USB操作状态、设备句柄和端点上的流接口，由usb_api.h包含。
+ * 流接口只依赖这些类型，不依赖驱动层通用定义。STM32 USB驱动的主机测试用桩
+ * 头文件代替usb_api.h时同样包含该文件，测试的流声明与驱动实际实现的接口一致。
+ */
+
+#ifndef USB_STREAM_API_H
+#define USB_STREAM_API_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* USB操作状态 */
+typedef enum {
+    USB_STATUS_IDLE,        /**< 空闲状态 */
+    USB_STATUS_BUSY,        /**< 忙状态 */
+    USB_STATUS_COMPLETE,    /**< 操作完成 */
+    USB_STATUS_ERROR,       /**< 操作错误 */
+    USB_STATUS_TIMEOUT      /**< 操作超时 */
+} usb_status_t;
+
+/* USB设备句柄，与driver_handle_t相同 */
+typedef void *usb_handle_t;
+
+/* 每个端点可排队的传输数，也是一个流的缓冲区数量上限 */
+#ifndef CONFIG_USB_EP_QUEUE_DEPTH
+#define CONFIG_USB_EP_QUEUE_DEPTH   4
+#endif
+
+/**
+ * @brief USB流回调函数类型
+ *
+ * 在中断上下文中调用。IN方向表示一个缓冲区已发送完毕，可以继续写入；
+ * OUT方向表示一个缓冲区收到了数据，可以读取
+ *
+ * @param arg 回调参数
+ * @param ep_addr 端点地址
+ * @param status 传输状态，端点被取消时为USB_STATUS_ERROR
+ * @param length 本次完成的字节数
+ */
+typedef void (*usb_stream_callback_t)(void *arg, uint8_t ep_addr, usb_status_t status, uint32_t length);
+
+/* USB流配置 */
+typedef struct {
+    uint8_t ep_addr;                    /**< 端点地址，最高位为1表示IN方向 */
+    uint8_t *buffers[CONFIG_USB_EP_QUEUE_DEPTH]; /**< 缓冲区，由调用者提供 */
+    uint8_t buffer_count;               /**< 缓冲区数量，2为乒乓缓冲 */
+    uint32_t buffer_size;               /**< 每个缓冲区大小，须为端点最大包大小的整数倍 */
+    bool auto_zlp;                      /**< 批量IN方向刷新时数据以整包结束则补发零长度包 */
+    usb_stream_callback_t callback;     /**< 缓冲区完成回调，可为NULL */
+    void *arg;                          /**< 回调参数 */
+} usb_stream_config_t;
+
+/**
+ * @brief 在批量或中断端点上打开流
+ *
+ * 流独占端点，所有缓冲区轮流交给端点的传输队列，使前一个缓冲区完成时下一个
+ * 已经在排队，端点不会因等待提交而空闲。OUT方向打开时即投递全部缓冲区
+ *
+ * @param handle USB设备句柄
+ * @param config 流配置
+ * @return int 0表示成功，非0表示失败
+ */
+int usb_stream_open(usb_handle_t handle, const usb_stream_config_t *config);
+
+/**
+ * @brief 关闭流
+ *
+ * 取消端点上排队的传输，未发送的数据被丢弃
+ *
+ * @param handle USB设备句柄
+ * @param ep_addr 端点地址
+ * @return int 0表示成功，非0表示失败
+ */
+int usb_stream_close(usb_handle_t handle, uint8_t ep_addr);
+
+/**
+ * @brief 写入IN流
+ *
+ * 数据复制到正在填充的缓冲区，缓冲区写满后立即排队发送。没有空闲缓冲区时
+ * 返回已写入的字节数，不等待
+ *
+ * @param handle USB设备句柄
+ * @param ep_addr 端点地址
+ * @param data 数据
+ * @param length 数据长度
+ * @return int 写入的字节数，负值表示错误
+ */
+int usb_stream_write(usb_handle_t handle, uint8_t ep_addr, const void *data, uint32_t length);
+
+/**
+ * @brief 发送IN流中未写满的缓冲区
+ *
+ * 结束一次传输：写满的缓冲区之间不插入零长度包，刷新时数据以整包结束才补发。
+ * 没有空闲缓冲区时返回失败，可在流回调后重试
+ *
+ * @param handle USB设备句柄
+ * @param ep_addr 端点地址
+ * @return int 0表示成功，非0表示失败
+ */
+int usb_stream_flush(usb_handle_t handle, uint8_t ep_addr);
+
+/**
+ * @brief 读取OUT流
+ *
+ * 按接收顺序复制已收到的数据，读空的缓冲区立即重新投递
+ *
+ * @param handle USB设备句柄
+ * @param ep_addr 端点地址
+ * @param data 数据缓冲区
+ * @param length 缓冲区长度
+ * @return int 读取的字节数，负值表示错误
+ */
+int usb_stream_read(usb_handle_t handle, uint8_t ep_addr, void *data, uint32_t length);
+
+/**
+ * @brief 获取流中可用的字节数
+ *
+ * @param handle USB设备句柄
+ * @param ep_addr 端点地址
+ * @param bytes IN方向为可写入的字节数，OUT方向为可读取的字节数
+ * @return int 0表示成功，非0表示失败
+ */
+int usb_stream_available(usb_handle_t handle, uint8_t ep_addr, uint32_t *bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_STREAM_API_H */
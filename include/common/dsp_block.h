@@ -0,0 +1,206 @@
+/**
+ * @file dsp_block.h
+ * @brief 块处理数字信号处理接口定义
+ *
+ * 该头文件定义了按样本数组处理的定点滤波模块，包括滑动平均、中值、IIR
+ * 双二阶级联、抽取和原始值到工程单位的转换。每次调用处理一整块样本，
+ * 滤波器状态保存在调用者提供的对象中，块与块之间连续。定义
+ * CONFIG_DSP_USE_CMSIS时双二阶滤波使用CMSIS-DSP实现，否则使用结果一致的
+ * 可移植C实现。
+ */
+
+#ifndef DSP_BLOCK_H
+#define DSP_BLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(CONFIG_DSP_USE_CMSIS) && CONFIG_DSP_USE_CMSIS
+#include "arm_math.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 滑动平均最大窗口 */
+#ifndef CONFIG_DSP_MOVING_AVERAGE_MAX_WINDOW
+#define CONFIG_DSP_MOVING_AVERAGE_MAX_WINDOW    64
+#endif
+
+/* 中值滤波最大窗口 */
+#ifndef CONFIG_DSP_MEDIAN_MAX_WINDOW
+#define CONFIG_DSP_MEDIAN_MAX_WINDOW            15
+#endif
+
+/* 双二阶滤波最大级数 */
+#ifndef CONFIG_DSP_BIQUAD_MAX_STAGES
+#define CONFIG_DSP_BIQUAD_MAX_STAGES            4
+#endif
+
+/* 错误码定义 */
+#define DSP_OK              0   /**< 操作成功 */
+#define DSP_INVALID_PARAM  -1   /**< 无效参数 */
+
+/* 滑动平均滤波器 */
+typedef struct {
+    int16_t history[CONFIG_DSP_MOVING_AVERAGE_MAX_WINDOW];  /**< 窗口内样本 */
+    int32_t sum;                                            /**< 窗口内样本和 */
+    uint16_t window;                                        /**< 窗口长度 */
+    uint16_t index;                                         /**< 最旧样本位置 */
+    uint16_t filled;                                        /**< 已填充样本数 */
+} dsp_moving_average_t;
+
+/* 中值滤波器 */
+typedef struct {
+    int16_t history[CONFIG_DSP_MEDIAN_MAX_WINDOW];  /**< 按到达顺序的窗口样本 */
+    int16_t sorted[CONFIG_DSP_MEDIAN_MAX_WINDOW];   /**< 排序后的窗口样本 */
+    uint8_t window;                                 /**< 窗口长度 */
+    uint8_t index;                                  /**< 最旧样本位置 */
+    uint8_t filled;                                 /**< 已填充样本数 */
+} dsp_median_t;
+
+/**
+ * @brief 双二阶级联滤波器(直接I型，Q15)
+ *
+ * 系数与状态的内存布局与CMSIS-DSP的arm_biquad_cascade_df1_q15一致
+ */
+typedef struct {
+    int16_t coeffs[CONFIG_DSP_BIQUAD_MAX_STAGES * 6];   /**< 每级{b0, 0, b1, b2, -a1, -a2} */
+    int16_t state[CONFIG_DSP_BIQUAD_MAX_STAGES * 4];    /**< 每级{x[n-1], x[n-2], y[n-1], y[n-2]} */
+    uint8_t stages;                                     /**< 级数 */
+    int8_t post_shift;                                  /**< 系数缩放位数 */
+#if defined(CONFIG_DSP_USE_CMSIS) && CONFIG_DSP_USE_CMSIS
+    arm_biquad_casd_df1_inst_q15 instance;              /**< CMSIS-DSP实例 */
+#endif
+} dsp_biquad_t;
+
+/* 抽取器 */
+typedef struct {
+    int32_t sum;                /**< 当前组累加值 */
+    uint16_t factor;            /**< 抽取倍数 */
+    uint16_t phase;             /**< 当前组已累加样本数 */
+} dsp_decimator_t;
+
+/**
+ * @brief 初始化滑动平均滤波器
+ *
+ * @param filter 滤波器对象
+ * @param window 窗口长度，不超过CONFIG_DSP_MOVING_AVERAGE_MAX_WINDOW
+ * @return int 0表示成功，非0表示失败
+ */
+int dsp_moving_average_init(dsp_moving_average_t *filter, uint16_t window);
+
+/**
+ * @brief 滑动平均滤波
+ *
+ * 窗口未填满前输出已有样本的平均值。in与out可以相同
+ *
+ * @param filter 滤波器对象
+ * @param in 输入样本
+ * @param out 输出样本
+ * @param count 样本数
+ */
+void dsp_moving_average_process(dsp_moving_average_t *filter, const int16_t *in, int16_t *out, uint32_t count);
+
+/**
+ * @brief 初始化中值滤波器
+ *
+ * @param filter 滤波器对象
+ * @param window 窗口长度，不超过CONFIG_DSP_MEDIAN_MAX_WINDOW，建议为奇数
+ * @return int 0表示成功，非0表示失败
+ */
+int dsp_median_init(dsp_median_t *filter, uint8_t window);
+
+/**
+ * @brief 中值滤波
+ *
+ * 维护排序窗口，每个样本的代价与窗口长度成正比。in与out可以相同
+ *
+ * @param filter 滤波器对象
+ * @param in 输入样本
+ * @param out 输出样本
+ * @param count 样本数
+ */
+void dsp_median_process(dsp_median_t *filter, const int16_t *in, int16_t *out, uint32_t count);
+
+/**
+ * @brief 初始化双二阶级联滤波器
+ *
+ * 传递函数 H(z) = (b0 + b1*z^-1 + b2*z^-2) / (1 + a1*z^-1 + a2*z^-2)，
+ * 系数为Q15格式并整体右移post_shift位，使绝对值大于1的系数也能表示
+ *
+ * @param filter 滤波器对象
+ * @param coeffs 每级{b0, b1, b2, a1, a2}
+ * @param stages 级数，不超过CONFIG_DSP_BIQUAD_MAX_STAGES
+ * @param post_shift 系数缩放位数，通常为1
+ * @return int 0表示成功，非0表示失败
+ */
+int dsp_biquad_init(dsp_biquad_t *filter, const int16_t *coeffs, uint8_t stages, int8_t post_shift);
+
+/**
+ * @brief 双二阶级联滤波
+ *
+ * 使用64位累加，输出饱和到16位。in与out可以相同
+ *
+ * @param filter 滤波器对象
+ * @param in 输入样本
+ * @param out 输出样本
+ * @param count 样本数
+ */
+void dsp_biquad_process(dsp_biquad_t *filter, const int16_t *in, int16_t *out, uint32_t count);
+
+/**
+ * @brief 初始化抽取器
+ *
+ * @param decimator 抽取器对象
+ * @param factor 抽取倍数
+ * @return int 0表示成功，非0表示失败
+ */
+int dsp_decimator_init(dsp_decimator_t *decimator, uint16_t factor);
+
+/**
+ * @brief 抽取
+ *
+ * 每factor个输入求平均输出一个样本，不足一组的样本留到下一块。
+ * 需要更陡的抗混叠特性时先经过双二阶低通。out可以与in相同
+ *
+ * @param decimator 抽取器对象
+ * @param in 输入样本
+ * @param count 输入样本数
+ * @param out 输出样本，容量至少为count / factor + 1
+ * @return uint32_t 输出样本数
+ */
+uint32_t dsp_decimator_process(dsp_decimator_t *decimator, const int16_t *in, uint32_t count, int16_t *out);
+
+/**
+ * @brief 原始值转换为定点工程单位
+ *
+ * out = ((raw * gain_q16) >> 16) + offset，例如把ADC原始值转换为毫伏
+ *
+ * @param raw 原始值
+ * @param out 输出值
+ * @param count 样本数
+ * @param gain_q16 Q16格式的增益
+ * @param offset 偏移
+ */
+void dsp_convert_q16(const uint16_t *raw, int32_t *out, uint32_t count, int32_t gain_q16, int32_t offset);
+
+/**
+ * @brief 原始值转换为浮点工程单位
+ *
+ * out = raw * gain + offset
+ *
+ * @param raw 原始值
+ * @param out 输出值
+ * @param count 样本数
+ * @param gain 增益
+ * @param offset 偏移
+ */
+void dsp_convert_f32(const uint16_t *raw, float *out, uint32_t count, float gain, float offset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSP_BLOCK_H */
@@ -54,9 +54,47 @@
 #define ERROR_OK                 0x00000000  /**< 无错误 */
 #define ERROR_GENERAL            0x0F0F0002  /**< 一般错误 */
 
+/* 延迟分发队列深度，必须为2的幂 */
+#ifndef CONFIG_ERROR_QUEUE_SIZE
+#define CONFIG_ERROR_QUEUE_SIZE  32
+#endif
+
+/* 最近出现的不同错误的历史记录数量 */
+#ifndef CONFIG_ERROR_HISTORY_SIZE
+#define CONFIG_ERROR_HISTORY_SIZE  10
+#endif
+
+/* 重复错误聚合窗口（毫秒），窗口内同一位置的同一错误只输出一次 */
+#ifndef CONFIG_ERROR_AGGREGATE_WINDOW_MS
+#define CONFIG_ERROR_AGGREGATE_WINDOW_MS  1000
+#endif
+
+/* 每个模块默认每秒允许输出的错误数与突发数量，速率为0表示不限速 */
+#ifndef CONFIG_ERROR_RATE_LIMIT
+#define CONFIG_ERROR_RATE_LIMIT  10
+#endif
+#ifndef CONFIG_ERROR_RATE_BURST
+#define CONFIG_ERROR_RATE_BURST  20
+#endif
+
+/* 错误历史条目，同一错误码、文件和行号聚合为一条 */
+typedef struct {
+    uint32_t code;              /**< 错误码 */
+    const char *file;           /**< 文件名 */
+    uint32_t line;              /**< 行号 */
+    uint32_t count;             /**< 累计出现次数 */
+    uint32_t suppressed;        /**< 当前窗口内被折叠或限速的次数 */
+    uint32_t first_timestamp;   /**< 首次出现时间（毫秒） */
+    uint32_t last_timestamp;    /**< 最近出现时间（毫秒） */
+    uint32_t window_start;      /**< 当前聚合窗口起始时间（毫秒） */
+} error_history_entry_t;
+
 /* 错误回调函数类型 */
 typedef void (*error_callback_t)(uint32_t error_code, const char *file, uint32_t line, void *user_data);
 
+/* 致命错误钩子类型，在关中断后于报告上下文中调用，只能执行中断安全的操作 */
+typedef void (*error_panic_hook_t)(uint32_t error_code, const char *file, uint32_t line);
+
 /**
  * @brief 错误处理初始化
  * 
@@ -91,6 +129,9 @@ int error_unregister_callback(error_callback_t callback);
 /**
  * @brief 报告错误
  * 
+ * 可在任意上下文（包括中断）中调用，日志和回调由分发上下文延迟执行。
+ * 致命错误在线程上下文中立即输出日志，然后关中断、调用致命错误钩子并停机，不再返回
+ * 
  * @param error_code 错误码
  * @param file 文件名
  * @param line 行号
@@ -98,6 +139,72 @@ int error_unregister_callback(error_callback_t callback);
  */
 int error_report(uint32_t error_code, const char *file, uint32_t line);
 
+/**
+ * @brief 处理队列中的错误记录
+ * 
+ * 输出日志并调用注册的回调函数。RTOS环境下由内部分发线程调用，
+ * 裸机环境下需在主循环中周期调用
+ * 
+ * @return uint32_t 本次处理的记录数
+ */
+uint32_t error_process(void);
+
+/**
+ * @brief 设置致命错误钩子
+ * 
+ * 钩子可能在中断上下文中执行，可用于保存现场到保留内存或触发复位，
+ * 不得输出日志或调用RTOS阻塞接口
+ * 
+ * @param hook 钩子函数，NULL表示不调用
+ */
+void error_set_panic_hook(error_panic_hook_t hook);
+
+/**
+ * @brief 获取因队列满而丢弃的错误记录数
+ * 
+ * @return uint32_t 丢弃的记录数
+ */
+uint32_t error_get_dropped_count(void);
+
+/**
+ * @brief 设置重复错误聚合窗口
+ * 
+ * @param window_ms 窗口长度（毫秒），0表示不聚合
+ * @return int 0表示成功，非0表示失败
+ */
+int error_set_aggregation_window(uint32_t window_ms);
+
+/**
+ * @brief 设置模块的错误输出限速
+ * 
+ * 限速只作用于日志和回调，错误统计始终准确
+ * 
+ * @param module 模块标识，0表示所有模块
+ * @param rate 每秒允许输出的错误数，0表示不限速
+ * @param burst 允许的突发数量
+ * @return int 0表示成功，非0表示失败
+ */
+int error_set_rate_limit(uint32_t module, uint32_t rate, uint32_t burst);
+
+/**
+ * @brief 获取被限速丢弃的错误记录数
+ * 
+ * @param module 模块标识，0表示所有模块
+ * @return uint32_t 被限速的记录数
+ */
+uint32_t error_get_rate_limited_count(uint32_t module);
+
+/**
+ * @brief 获取最近出现的不同错误
+ * 
+ * 历史满时淘汰最久未出现的错误
+ * 
+ * @param entries 输出数组，按最近出现的顺序排列
+ * @param max_entries 数组容量
+ * @return uint32_t 实际输出的条目数
+ */
+uint32_t error_get_aggregate_history(error_history_entry_t *entries, uint32_t max_entries);
+
 /**
  * @brief 获取错误描述
  * 
@@ -0,0 +1,131 @@
+/**
+ * @file mutex_profile.h
+ * @brief RTOS互斥锁性能剖析接口定义
+ *
+ * 定义CONFIG_RTOS_MUTEX_PROFILING=1后，rtos_api.h会将所有rtos_mutex_*调用
+ * 重定向到本文件声明的带统计封装，无需修改调用点。每个互斥锁记录获取次数、
+ * 竞争次数、最大等待时间、最大持有时间以及持有者线程名称，便于定位
+ * 串行化各线程的全局锁。未开启时不产生任何开销。
+ */
+
+#ifndef MUTEX_PROFILE_H
+#define MUTEX_PROFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "rtos_api.h"
+
+/* 最大可剖析的互斥锁数量，超出的互斥锁照常工作但不统计 */
+#ifndef CONFIG_RTOS_MUTEX_PROFILE_MAX
+#define CONFIG_RTOS_MUTEX_PROFILE_MAX   32
+#endif
+
+/* 互斥锁统计信息 */
+typedef struct {
+    rtos_mutex_t mutex;             /**< 互斥锁句柄 */
+    const char *name;               /**< 名称，未设置时为创建处的文件名 */
+    uint32_t line;                  /**< 创建处的行号 */
+    bool deleted;                   /**< 是否已删除 */
+    uint32_t acquisitions;          /**< 成功获取次数 */
+    uint32_t contentions;           /**< 获取时已被其他线程持有的次数 */
+    uint32_t timeouts;              /**< 获取超时次数 */
+    uint32_t max_wait_us;           /**< 最大等待时间（微秒） */
+    uint64_t total_wait_us;         /**< 累计等待时间（微秒） */
+    uint32_t max_hold_us;           /**< 最大持有时间（微秒） */
+    uint64_t total_hold_us;         /**< 累计持有时间（微秒） */
+    const char *owner;              /**< 当前持有者线程名称，NULL表示空闲 */
+    const char *max_hold_owner;     /**< 最长一次持有的线程名称 */
+    const char *last_blocker;       /**< 最近一次竞争时的持有者线程名称 */
+} rtos_mutex_profile_info_t;
+
+/**
+ * @brief 初始化互斥锁剖析
+ *
+ * 由rtos_init调用，之前创建的互斥锁不参与统计
+ *
+ * @return int 0表示成功，非0表示失败
+ */
+int rtos_mutex_profile_init(void);
+
+/**
+ * @brief 创建互斥锁并登记剖析记录
+ *
+ * @param mutex 互斥锁句柄指针
+ * @param file 创建处文件名
+ * @param line 创建处行号
+ * @return int 0表示成功，非0表示失败
+ */
+int rtos_mutex_profile_create(rtos_mutex_t *mutex, const char *file, uint32_t line);
+
+/**
+ * @brief 删除互斥锁，保留其统计信息
+ *
+ * 剖析表满时，已删除互斥锁的记录会被新创建的互斥锁回收
+ *
+ * @param mutex 互斥锁句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int rtos_mutex_profile_delete(rtos_mutex_t mutex);
+
+/**
+ * @brief 获取互斥锁并记录等待与竞争
+ *
+ * @param mutex 互斥锁句柄
+ * @param timeout_ms 超时时间（毫秒），0表示不等待，UINT32_MAX表示永久等待
+ * @return int 0表示成功，非0表示失败
+ */
+int rtos_mutex_profile_lock(rtos_mutex_t mutex, uint32_t timeout_ms);
+
+/**
+ * @brief 释放互斥锁并记录持有时间
+ *
+ * @param mutex 互斥锁句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int rtos_mutex_profile_unlock(rtos_mutex_t mutex);
+
+/**
+ * @brief 设置互斥锁的显示名称
+ *
+ * @param mutex 互斥锁句柄
+ * @param name 名称，需在整个运行期间有效
+ * @return int 0表示成功，非0表示失败
+ */
+int rtos_mutex_profile_set_name(rtos_mutex_t mutex, const char *name);
+
+/**
+ * @brief 获取已登记的互斥锁数量
+ *
+ * @return uint32_t 互斥锁数量
+ */
+uint32_t rtos_mutex_profile_get_count(void);
+
+/**
+ * @brief 获取指定序号的互斥锁统计信息
+ *
+ * @param index 序号，范围[0, rtos_mutex_profile_get_count())
+ * @param info 统计信息输出
+ * @return int 0表示成功，非0表示失败
+ */
+int rtos_mutex_profile_get_info(uint32_t index, rtos_mutex_profile_info_t *info);
+
+/**
+ * @brief 清零所有互斥锁的统计计数
+ */
+void rtos_mutex_profile_reset(void);
+
+/**
+ * @brief 以表格形式打印所有互斥锁统计信息
+ */
+void rtos_mutex_profile_dump(void);
+
+/**
+ * @brief 以JSON格式输出所有互斥锁统计信息
+ *
+ * @param buffer 输出缓冲区
+ * @param size 缓冲区大小
+ * @return int 写入的字节数（不含结尾'\0'），缓冲区不足返回-1
+ */
+int rtos_mutex_profile_to_json(char *buffer, uint32_t size);
+
+#endif /* MUTEX_PROFILE_H */
@@ -110,6 +110,14 @@ void rtos_thread_sleep_ms(uint32_t ms);
  */
 rtos_thread_t rtos_thread_get_current(void);
 
+/**
+ * @brief 获取线程名称
+ * 
+ * @param thread 线程句柄，NULL表示当前线程
+ * @return const char* 线程名称，失败返回NULL
+ */
+const char *rtos_thread_get_name(rtos_thread_t thread);
+
 /**
  * @brief 创建信号量
  * 
@@ -140,6 +148,8 @@ int rtos_sem_take(rtos_sem_t sem, uint32_t timeout_ms);
 /**
  * @brief 释放信号量
  * 
+ * 可在中断上下文中调用
+ * 
  * @param sem 信号量句柄
  * @return int 0表示成功，非0表示失败
  */
@@ -347,4 +357,13 @@ void* rtos_malloc(uint32_t size);
  */
 void rtos_free(void *ptr);
 
+/* 互斥锁性能剖析：开启后将互斥锁接口重定向到带统计的封装，RTOS适配层自身不重定向 */
+#if defined(CONFIG_RTOS_MUTEX_PROFILING) && CONFIG_RTOS_MUTEX_PROFILING && !defined(RTOS_MUTEX_PROFILE_NO_REDIRECT)
+#include "mutex_profile.h"
+#define rtos_mutex_create(mutex)            rtos_mutex_profile_create((mutex), __FILE__, __LINE__)
+#define rtos_mutex_delete(mutex)            rtos_mutex_profile_delete(mutex)
+#define rtos_mutex_lock(mutex, timeout_ms)  rtos_mutex_profile_lock((mutex), (timeout_ms))
+#define rtos_mutex_unlock(mutex)            rtos_mutex_profile_unlock(mutex)
+#endif
+
 #endif /* RTOS_API_H */
@@ -0,0 +1,157 @@
+/**
+ * @file timer_wheel.h
+ * @brief 分层时间轮软件定时器接口定义
+ *
+ * 该头文件定义了基于分层时间轮的软件定时器服务。所有软件定时器共享一个
+ * 内核定时器，定时器对象由调用者提供存储，启动、停止、重置均为O(1)操作，
+ * 不进行任何动态内存分配，同一tick内到期的定时器批量回调。
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* 时间轮层数与每层槽位数 */
+#define TIMER_WHEEL_LEVELS      4
+#define TIMER_WHEEL_SLOT_BITS   6
+#define TIMER_WHEEL_SLOTS       (1U << TIMER_WHEEL_SLOT_BITS)
+
+/* 默认tick周期（毫秒） */
+#ifndef CONFIG_TIMER_WHEEL_TICK_MS
+#define CONFIG_TIMER_WHEEL_TICK_MS  1
+#endif
+
+/* 单个定时器可表示的最大超时tick数 */
+#define TIMER_WHEEL_MAX_TICKS   ((1UL << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOT_BITS)) - 1)
+
+/* 错误码定义 */
+#define TIMER_WHEEL_OK              0   /**< 操作成功 */
+#define TIMER_WHEEL_ERROR          -1   /**< 一般错误 */
+#define TIMER_WHEEL_INVALID_PARAM  -2   /**< 无效参数 */
+#define TIMER_WHEEL_NOT_INIT       -3   /**< 时间轮未初始化 */
+
+struct timer_wheel_timer;
+
+/* 软件定时器回调函数类型 */
+typedef void (*timer_wheel_func_t)(struct timer_wheel_timer *timer, void *arg);
+
+/* 软件定时器状态 */
+typedef enum {
+    TIMER_WHEEL_STATE_IDLE = 0,     /**< 未启动 */
+    TIMER_WHEEL_STATE_PENDING,      /**< 已挂入时间轮等待到期 */
+    TIMER_WHEEL_STATE_EXPIRED       /**< 已到期，等待批量回调 */
+} timer_wheel_state_t;
+
+/**
+ * @brief 软件定时器对象
+ *
+ * 由调用者静态分配或嵌入到自身结构体中，字段由时间轮内部维护，
+ * 使用前必须调用timer_wheel_timer_init初始化
+ */
+typedef struct timer_wheel_timer {
+    struct timer_wheel_timer *next;     /**< 槽位链表后继 */
+    struct timer_wheel_timer *prev;     /**< 槽位链表前驱 */
+    uint32_t expires;                   /**< 到期tick（绝对值） */
+    uint32_t timeout;                   /**< 首次超时tick数，用于重置 */
+    uint32_t period;                    /**< 周期tick数，0表示单次 */
+    timer_wheel_func_t callback;        /**< 回调函数 */
+    void *arg;                          /**< 回调参数 */
+    timer_wheel_state_t state;          /**< 定时器状态 */
+} timer_wheel_timer_t;
+
+/* 时间轮统计信息 */
+typedef struct {
+    uint32_t active_timers;     /**< 当前挂起的定时器数量 */
+    uint32_t total_expired;     /**< 累计到期次数 */
+    uint32_t max_batch;         /**< 单次处理的最大到期批量 */
+    uint32_t cascades;          /**< 累计层间迁移次数 */
+} timer_wheel_stats_t;
+
+/**
+ * @brief 初始化时间轮
+ *
+ * 在RTOS环境下创建一个周期为tick_ms的内核定时器驱动时间轮；
+ * 裸机环境下需由系统tick中断周期调用timer_wheel_process
+ *
+ * @param tick_ms 时间轮tick周期（毫秒），0表示使用CONFIG_TIMER_WHEEL_TICK_MS
+ * @return int 0表示成功，非0表示失败
+ */
+int timer_wheel_init(uint32_t tick_ms);
+
+/**
+ * @brief 去初始化时间轮
+ *
+ * 停止内核定时器，所有挂起的软件定时器被摘除并回到空闲状态
+ *
+ * @return int 0表示成功，非0表示失败
+ */
+int timer_wheel_deinit(void);
+
+/**
+ * @brief 初始化软件定时器对象
+ *
+ * @param timer 定时器对象
+ * @param callback 回调函数
+ * @param arg 回调参数
+ * @return int 0表示成功，非0表示失败
+ */
+int timer_wheel_timer_init(timer_wheel_timer_t *timer, timer_wheel_func_t callback, void *arg);
+
+/**
+ * @brief 启动软件定时器
+ *
+ * 若定时器已启动则以新的超时时间重新启动
+ *
+ * @param timer 定时器对象
+ * @param timeout_ms 首次超时时间（毫秒）
+ * @param period_ms 周期（毫秒），0表示单次定时器
+ * @return int 0表示成功，非0表示失败
+ */
+int timer_wheel_start(timer_wheel_timer_t *timer, uint32_t timeout_ms, uint32_t period_ms);
+
+/**
+ * @brief 停止软件定时器
+ *
+ * @param timer 定时器对象
+ * @return int 0表示成功，非0表示失败
+ */
+int timer_wheel_stop(timer_wheel_timer_t *timer);
+
+/**
+ * @brief 重置软件定时器
+ *
+ * 以最近一次启动时的超时时间从当前时刻重新计时
+ *
+ * @param timer 定时器对象
+ * @return int 0表示成功，非0表示失败
+ */
+int timer_wheel_reset(timer_wheel_timer_t *timer);
+
+/**
+ * @brief 查询软件定时器是否处于运行状态
+ *
+ * @param timer 定时器对象
+ * @return bool true表示已启动且尚未到期
+ */
+bool timer_wheel_is_active(const timer_wheel_timer_t *timer);
+
+/**
+ * @brief 推进时间轮并批量执行到期回调
+ *
+ * RTOS环境下由内部内核定时器调用，并根据系统时间补齐延迟的tick；
+ * 裸机环境或定义了CONFIG_TIMER_WHEEL_MANUAL_TICK时每次调用推进一个tick。
+ * 超时为n个tick的定时器在启动后的第n次推进中到期
+ */
+void timer_wheel_process(void);
+
+/**
+ * @brief 获取时间轮统计信息
+ *
+ * @param stats 统计信息输出
+ * @return int 0表示成功，非0表示失败
+ */
+int timer_wheel_get_stats(timer_wheel_stats_t *stats);
+
+#endif /* TIMER_WHEEL_H */
@@ -11,6 +11,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 /* 定义颜色代码 - 用于终端输出 */
@@ -51,6 +52,45 @@
         ut_assert_not_null_impl(pointer, #pointer, __FILE__, __LINE__); \
     } while (0)
 
+/* 性能测试配置 */
+#ifndef UT_BENCH_MAX_SAMPLES
+#define UT_BENCH_MAX_SAMPLES     256     /* 单个性能测试的最大采样次数 */
+#endif
+#ifndef UT_BENCH_MAX_RESULTS
+#define UT_BENCH_MAX_RESULTS     32      /* 保存的性能测试结果数量 */
+#endif
+#ifndef UT_BENCH_WARMUP_SAMPLES
+#define UT_BENCH_WARMUP_SAMPLES  4       /* 预热采样次数 */
+#endif
+#ifndef UT_BENCH_MIN_SAMPLE_NS
+#define UT_BENCH_MIN_SAMPLE_NS   100000  /* 单次采样的最短时长，不足时自动增加批量 */
+#endif
+
+/**
+ * @brief 性能测试宏
+ *
+ * 循环体为被测代码。先预热并自动确定每次采样的批量迭代次数，
+ * 使单次采样时长不低于UT_BENCH_MIN_SAMPLE_NS，再采样reps次，
+ * 结束后打印并保存单次迭代的最小值、中位数和P99耗时。
+ *
+ * 用法:
+ *     UT_BENCH("mem_alloc_64", 100) {
+ *         mem_free(mem_alloc(64));
+ *     }
+ */
+#define UT_BENCH(name, reps) \
+    for (ut_bench_state_t ut_bench_state_ = ut_bench_begin(name, reps, 0); \
+         ut_bench_next(&ut_bench_state_); )
+
+/**
+ * @brief 带吞吐量统计的性能测试宏
+ *
+ * @param bytes 每次迭代处理的字节数
+ */
+#define UT_BENCH_BYTES(name, reps, bytes) \
+    for (ut_bench_state_t ut_bench_state_ = ut_bench_begin(name, reps, bytes); \
+         ut_bench_next(&ut_bench_state_); )
+
 /* 测试案例函数类型 */
 typedef void (*ut_test_func_t)(void);
 
@@ -71,6 +111,31 @@ typedef struct {
     void (*case_teardown)(void);    /* 测试案例清理函数 */
 } ut_test_suite_t;
 
+/* 性能测试运行状态，由UT_BENCH宏使用 */
+typedef struct {
+    const char *name;               /* 性能测试名称 */
+    uint32_t reps;                  /* 采样次数 */
+    uint32_t bytes;                 /* 每次迭代处理的字节数 */
+    uint32_t batch;                 /* 每次采样的迭代次数 */
+    uint32_t iter;                  /* 当前采样已执行的迭代次数 */
+    uint32_t warmup;                /* 已完成的预热采样次数 */
+    uint32_t count;                 /* 已完成的采样次数 */
+    uint64_t start_ns;              /* 当前采样起始时间 */
+} ut_bench_state_t;
+
+/* 性能测试结果，时间均为单次迭代耗时（纳秒） */
+typedef struct {
+    const char *name;               /* 性能测试名称 */
+    uint32_t samples;               /* 采样次数 */
+    uint32_t batch;                 /* 每次采样的迭代次数 */
+    uint32_t bytes;                 /* 每次迭代处理的字节数 */
+    uint64_t min_ns;                /* 最小值 */
+    uint64_t median_ns;             /* 中位数 */
+    uint64_t p99_ns;                /* P99 */
+    uint64_t max_ns;                /* 最大值 */
+    uint64_t mean_ns;               /* 平均值 */
+} ut_bench_result_t;
+
 /* 测试统计信息 */
 typedef struct {
     unsigned int total_suites;      /* 总测试套件数 */
@@ -187,6 +252,67 @@ void ut_assert_null_impl(const void *pointer, const char *pointer_str,
 void ut_assert_not_null_impl(const void *pointer, const char *pointer_str, 
                             const char *file, int line);
 
+/**
+ * @brief 开始一个性能测试，由UT_BENCH宏调用
+ * 
+ * @param name 性能测试名称
+ * @param reps 采样次数，超过UT_BENCH_MAX_SAMPLES时截断
+ * @param bytes 每次迭代处理的字节数，0表示不统计吞吐量
+ * @return ut_bench_state_t 运行状态
+ */
+ut_bench_state_t ut_bench_begin(const char *name, uint32_t reps, uint32_t bytes);
+
+/**
+ * @brief 推进性能测试，由UT_BENCH宏调用
+ * 
+ * @param state 运行状态
+ * @return bool true表示继续执行循环体，false表示测试结束
+ */
+bool ut_bench_next(ut_bench_state_t *state);
+
+/**
+ * @brief 获取当前时间（纳秒）
+ * 
+ * 主机上使用单调时钟，目标板上使用platform_get_time_us
+ * 
+ * @return uint64_t 当前时间
+ */
+uint64_t ut_bench_time_ns(void);
+
+/**
+ * @brief 获取已保存的性能测试结果
+ * 
+ * @param count 结果数量输出
+ * @return const ut_bench_result_t* 结果数组
+ */
+const ut_bench_result_t *ut_bench_get_results(unsigned int *count);
+
+/**
+ * @brief 清除已保存的性能测试结果
+ */
+void ut_bench_clear_results(void);
+
+/**
+ * @brief 以JSON格式输出性能测试结果
+ * 
+ * 每个结果独占一行，便于与基线文件逐行比较
+ * 
+ * @param out 输出流
+ * @return int 0表示成功，非0表示失败
+ */
+int ut_bench_write_json(FILE *out);
+
+/**
+ * @brief 与基线结果比较，报告性能回退
+ * 
+ * 基线为ut_bench_write_json输出的文件，按名称匹配中位数
+ * 
+ * @param baseline_path 基线文件路径
+ * @param tolerance 允许的相对退化比例，例如0.1表示10%
+ * @return int 回退的测试数量，基线无法读取时返回-1
+ */
+int ut_bench_compare_baseline(const char *baseline_path, double tolerance);
+
 /* 当前测试状态 */
 extern ut_statistics_t *ut_current_stats;
 extern bool ut_current_test_failed;
@@ -183,9 +183,34 @@ typedef enum {
     SENSOR_EVENT_THRESHOLD_HIGH, /**< 高于阈值 */
     SENSOR_EVENT_THRESHOLD_LOW,  /**< 低于阈值 */
     SENSOR_EVENT_ERROR,          /**< 错误事件 */
+    SENSOR_EVENT_BATCH_READY,    /**< 批量缓冲区达到水位 */
     SENSOR_EVENT_CUSTOM          /**< 自定义事件 */
 } sensor_event_type_t;
 
+/**
+ * @brief 带时间戳的采样
+ *
+ * 批量模式下的紧凑采样格式，标量传感器只使用data[0]，三轴传感器依次
+ * 为x、y、z
+ */
+typedef struct {
+    uint32_t timestamp_us;       /**< 采样时间戳(微秒) */
+    float data[3];               /**< 采样值 */
+} sensor_sample_t;
+
+/* 批量模式配置 */
+typedef struct {
+    uint16_t watermark;          /**< 水位(样本数)，积累到该数量时通知读取，0表示关闭批量模式 */
+    uint32_t max_latency_ms;     /**< 最大上报延迟(毫秒)，未达水位时超过该时间也通知读取，0表示不限 */
+} sensor_batch_config_t;
+
+/* 批量模式统计信息 */
+typedef struct {
+    uint32_t samples;            /**< 进入批量缓冲区的样本数 */
+    uint32_t dropped;            /**< 缓冲区满而丢弃的样本数 */
+    uint32_t bursts;             /**< 硬件FIFO突发读取次数 */
+} sensor_batch_stats_t;
+
 /* 传感器事件 */
 typedef struct {
     sensor_event_type_t type;    /**< 事件类型 */
@@ -243,6 +268,49 @@ int sensor_stop(sensor_handle_t handle);
  */
 int sensor_read(sensor_handle_t handle, sensor_value_t* value);
 
+/**
+ * @brief 配置批量模式
+ *
+ * 开启后传感器以配置的采样率持续采样，带硬件FIFO的传感器在水位中断中
+ * 一次突发读出FIFO中的全部样本，样本进入驱动的有界环形缓冲区，不再为
+ * 每个样本唤醒任务。达到水位时产生SENSOR_EVENT_BATCH_READY事件
+ *
+ * @param handle 传感器句柄
+ * @param config 批量模式配置
+ * @return int 成功返回0，失败返回错误码
+ */
+int sensor_set_batch(sensor_handle_t handle, const sensor_batch_config_t* config);
+
+/**
+ * @brief 批量读取带时间戳的采样
+ *
+ * 缓冲区中有样本时立即返回，否则最多等待timeout_ms
+ *
+ * @param handle 传感器句柄
+ * @param samples 采样输出数组
+ * @param max_count 数组容量
+ * @param timeout_ms 超时时间(毫秒)，0表示不等待
+ * @return int 读取的样本数，负值表示错误码
+ */
+int sensor_read_batch(sensor_handle_t handle, sensor_sample_t* samples, uint32_t max_count, uint32_t timeout_ms);
+
+/**
+ * @brief 立即读出硬件FIFO中的样本，不等待水位
+ *
+ * @param handle 传感器句柄
+ * @return int 成功返回0，失败返回错误码
+ */
+int sensor_flush_batch(sensor_handle_t handle);
+
+/**
+ * @brief 获取批量模式统计信息
+ *
+ * @param handle 传感器句柄
+ * @param stats 返回的统计信息
+ * @return int 成功返回0，失败返回错误码
+ */
+int sensor_get_batch_stats(sensor_handle_t handle, sensor_batch_stats_t* stats);
+
 /**
  * @brief 设置传感器采样率
  * 
@@ -0,0 +1,131 @@
+/**
+ * @file sensor_stream_api.h
+ * @brief 传感器批量采样流接口定义
+ *
+ * 该头文件定义了平台无关的传感器采样流，供带硬件FIFO的传感器驱动实现
+ * sensor_read_batch。驱动在水位中断中一次突发读出FIFO，把样本连同回推的
+ * 时间戳压入有界环形缓冲区；读取者按批取出，每批只需一次唤醒。
+ * 缓冲区为单生产者单消费者结构，生产者(中断或驱动任务)与消费者之间无需加锁。
+ */
+
+#ifndef SENSOR_STREAM_API_H
+#define SENSOR_STREAM_API_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "feature/sensor_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 环形缓冲区深度(样本数)，必须为2的幂 */
+#ifndef CONFIG_SENSOR_STREAM_DEPTH
+#define CONFIG_SENSOR_STREAM_DEPTH  256
+#endif
+
+#if (CONFIG_SENSOR_STREAM_DEPTH & (CONFIG_SENSOR_STREAM_DEPTH - 1)) != 0
+#error "CONFIG_SENSOR_STREAM_DEPTH must be a power of two"
+#endif
+
+/* 错误码定义 */
+#define SENSOR_STREAM_OK              0   /**< 操作成功 */
+#define SENSOR_STREAM_INVALID_PARAM  -1   /**< 无效参数 */
+
+/**
+ * @brief 传感器采样流对象
+ *
+ * 由驱动嵌入到设备结构体中，字段由采样流内部维护。head只由生产者修改，
+ * tail只由消费者修改
+ */
+typedef struct {
+    sensor_sample_t ring[CONFIG_SENSOR_STREAM_DEPTH];   /**< 样本环形缓冲区 */
+    volatile uint32_t head;                             /**< 写入计数 */
+    volatile uint32_t tail;                             /**< 读取计数 */
+    uint16_t watermark;                                 /**< 水位，0表示每个样本都通知 */
+    uint32_t period_us;                                 /**< 平滑后的采样周期估计 */
+    uint32_t last_irq_us;                               /**< 上次水位中断时间 */
+    bool period_valid;                                  /**< last_irq_us有效 */
+    sensor_batch_stats_t stats;                         /**< 统计信息 */
+} sensor_stream_t;
+
+/**
+ * @brief 初始化采样流
+ *
+ * @param stream 采样流对象
+ * @param watermark 水位(样本数)
+ * @param period_us 标称采样周期(微秒)，作为周期估计的初值
+ * @return int 0表示成功，非0表示失败
+ */
+int sensor_stream_init(sensor_stream_t *stream, uint16_t watermark, uint32_t period_us);
+
+/**
+ * @brief 清空采样流并重新开始周期估计
+ *
+ * 只能在生产者停止时调用，例如重新配置采样率之后
+ *
+ * @param stream 采样流对象
+ * @param period_us 新的标称采样周期(微秒)
+ */
+void sensor_stream_reset(sensor_stream_t *stream, uint32_t period_us);
+
+/**
+ * @brief 压入单个样本
+ *
+ * 缓冲区满时丢弃新样本并计数，已缓冲的旧样本保持不变
+ *
+ * @param stream 采样流对象
+ * @param sample 样本
+ * @return bool true表示本次压入使缓冲量达到水位，驱动应通知读取者
+ */
+bool sensor_stream_push(sensor_stream_t *stream, const sensor_sample_t *sample);
+
+/**
+ * @brief 压入一次FIFO突发读出的样本并回推时间戳
+ *
+ * 硬件FIFO中的样本没有时间戳，最后一个样本视为在irq_timestamp_us时刻产生，
+ * 之前的样本按估计周期依次回推。周期由相邻两次水位中断的时间差和样本数
+ * 平滑估计，以跟踪传感器振荡器相对标称频率的偏差。samples中的
+ * timestamp_us字段被覆盖
+ *
+ * @param stream 采样流对象
+ * @param samples 按采样顺序排列的样本
+ * @param count 样本数
+ * @param irq_timestamp_us 水位中断时间(微秒)
+ * @return bool true表示缓冲量达到水位，驱动应通知读取者
+ */
+bool sensor_stream_push_fifo(sensor_stream_t *stream, sensor_sample_t *samples, uint32_t count,
+                             uint32_t irq_timestamp_us);
+
+/**
+ * @brief 批量取出样本
+ *
+ * @param stream 采样流对象
+ * @param samples 样本输出数组
+ * @param max_count 数组容量
+ * @return uint32_t 取出的样本数
+ */
+uint32_t sensor_stream_pop(sensor_stream_t *stream, sensor_sample_t *samples, uint32_t max_count);
+
+/**
+ * @brief 获取已缓冲的样本数
+ *
+ * @param stream 采样流对象
+ * @return uint32_t 样本数
+ */
+uint32_t sensor_stream_count(const sensor_stream_t *stream);
+
+/**
+ * @brief 获取统计信息
+ *
+ * @param stream 采样流对象
+ * @param stats 统计信息输出
+ * @return int 0表示成功，非0表示失败
+ */
+int sensor_stream_get_stats(const sensor_stream_t *stream, sensor_batch_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SENSOR_STREAM_API_H */
@@ -99,6 +99,16 @@ uint32_t platform_get_time_ms(void)
     return (uint32_t)(esp_timer_get_time() / 1000);
 }
 
+/**
+ * @brief 获取系统运行时间（微秒）
+ * 
+ * @return uint64_t 系统运行时间（微秒）
+ */
+uint64_t platform_get_time_us(void)
+{
+    return (uint64_t)esp_timer_get_time();
+}
+
 /**
  * @brief ESP32系统初始化
  * 
@@ -96,6 +96,36 @@ uint32_t platform_get_time_ms(void)
     return HAL_GetTick();
 }
 
+/**
+ * @brief 获取系统运行时间（微秒）
+ * 
+ * 由毫秒tick与SysTick当前计数值合成，读取期间发生tick进位时重新读取。
+ * 假定SysTick是HAL的时基（HAL默认配置）。SysTick未使能或重装值与HAL时基
+ * 不符时退化为HAL_GetTick的毫秒精度。若HAL_InitTick被改为使用TIM作为时基、
+ * 同时SysTick以相同频率另作他用（例如FreeRTOS的节拍），两者相位无关，
+ * 亚毫秒部分不可信，需自行提供基于TIM或DWT周期计数器的实现
+ * 
+ * @return uint64_t 系统运行时间（微秒）
+ */
+uint64_t platform_get_time_us(void)
+{
+    uint32_t ms;
+    uint32_t val;
+    uint32_t load = SysTick->LOAD + 1;
+    
+    if ((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) == 0 ||
+        load != SystemCoreClock / (1000U / uwTickFreq)) {
+        return (uint64_t)HAL_GetTick() * 1000;
+    }
+    
+    do {
+        ms = HAL_GetTick();
+        val = SysTick->VAL;
+    } while (ms != HAL_GetTick());
+    
+    return (uint64_t)ms * 1000 + ((uint64_t)(load - val) * 1000 * uwTickFreq) / load;
+}
+
 /**
  * @brief 系统时钟配置
  * 
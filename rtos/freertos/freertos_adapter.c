@@ -5,7 +5,12 @@
  * 该文件实现了FreeRTOS的适配层，将FreeRTOS的API映射到统一的RTOS抽象接口
  */
 
+/* 适配层实现真实的互斥锁接口，不参与剖析重定向 */
+#define RTOS_MUTEX_PROFILE_NO_REDIRECT
 #include "rtos_api.h"
+#if defined(CONFIG_RTOS_MUTEX_PROFILING) && CONFIG_RTOS_MUTEX_PROFILING
+#include "mutex_profile.h"
+#endif
 #include "FreeRTOS.h"
 #include "task.h"
 #include "semphr.h"
@@ -20,6 +25,13 @@
  */
 int rtos_init(void)
 {
+#if defined(CONFIG_RTOS_MUTEX_PROFILING) && CONFIG_RTOS_MUTEX_PROFILING
+    /* 在任何线程创建互斥锁之前创建剖析登记锁 */
+    if (rtos_mutex_profile_init() != RTOS_OK) {
+        return RTOS_ERROR;
+    }
+#endif
+
     /* FreeRTOS不需要特殊的初始化，直接返回成功 */
     return RTOS_OK;
 }
@@ -124,6 +136,17 @@ rtos_thread_t rtos_thread_get_current(void)
     return (rtos_thread_t)xTaskGetCurrentTaskHandle();
 }
 
+/**
+ * @brief 获取线程名称
+ * 
+ * @param thread 线程句柄，NULL表示当前线程
+ * @return const char* 线程名称，失败返回NULL
+ */
+const char *rtos_thread_get_name(rtos_thread_t thread)
+{
+    return pcTaskGetName((TaskHandle_t)thread);
+}
+
 /**
  * @brief 创建信号量
  * 
@@ -212,7 +235,13 @@ int rtos_sem_give(rtos_sem_t sem)
         return RTOS_INVALID_PARAM;
     }
     
-    result = xSemaphoreGive((SemaphoreHandle_t)sem);
+    if (xPortIsInsideInterrupt()) {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        result = xSemaphoreGiveFromISR((SemaphoreHandle_t)sem, &xHigherPriorityTaskWoken);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    } else {
+        result = xSemaphoreGive((SemaphoreHandle_t)sem);
+    }
     
     return (result == pdTRUE) ? RTOS_OK : RTOS_ERROR;
 }
@@ -5,7 +5,12 @@
  * 该文件实现了ThreadX的适配层，将ThreadX的API映射到统一的RTOS抽象接口
  */
 
+/* 适配层实现真实的互斥锁接口，不参与剖析重定向 */
+#define RTOS_MUTEX_PROFILE_NO_REDIRECT
 #include "common/rtos_api.h"
+#if defined(CONFIG_RTOS_MUTEX_PROFILING) && CONFIG_RTOS_MUTEX_PROFILING
+#include "common/mutex_profile.h"
+#endif
 #include "common/error_api.h"
 #include "tx_api.h"
 #include <stdlib.h>
@@ -37,10 +42,20 @@ int rtos_init(void)
     
     /* 创建内存池 */
     status = tx_byte_pool_create(&byte_pool, "memory_pool", byte_pool_buffer, TX_BYTE_POOL_SIZE);
+    if (status != TX_SUCCESS) {
+        return RTOS_ERROR;
+    }
+
+#if defined(CONFIG_RTOS_MUTEX_PROFILING) && CONFIG_RTOS_MUTEX_PROFILING
+    /* 在任何线程创建互斥锁之前创建剖析登记锁 */
+    if (rtos_mutex_profile_init() != RTOS_OK) {
+        return RTOS_ERROR;
+    }
+#endif
     
     /* ThreadX在使用前需要先调用tx_kernel_enter() */
     /* 但这个函数会立即启动调度器，因此在这里不调用它 */
-    return (status == TX_SUCCESS) ? RTOS_OK : RTOS_ERROR;
+    return RTOS_OK;
 }
 
 /**
@@ -202,6 +217,23 @@ rtos_thread_t rtos_thread_get_current(void)
     return (rtos_thread_t)tx_thread_identify();
 }
 
+/**
+ * @brief 获取线程名称
+ * 
+ * @param thread 线程句柄，NULL表示当前线程
+ * @return const char* 线程名称，失败返回NULL
+ */
+const char *rtos_thread_get_name(rtos_thread_t thread)
+{
+    TX_THREAD *thread_ptr = (thread != NULL) ? (TX_THREAD *)thread : tx_thread_identify();
+    
+    if (thread_ptr == TX_NULL) {
+        return NULL;
+    }
+    
+    return thread_ptr->tx_thread_name;
+}
+
 /**
  * @brief 创建信号量
  * 
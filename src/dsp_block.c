@@ -0,0 +1,252 @@
+/**
+ * @file dsp_block.c
+ * @brief 块处理数字信号处理实现
+ *
+ * 所有滤波器按块处理样本，状态在块之间保持，热点循环中不调用函数、不做
+ * 参数检查，以便编译器展开和使用DSP乘加指令。
+ */
+
+#include "common/dsp_block.h"
+#include <string.h>
+
+/**
+ * @brief 饱和到16位
+ */
+static inline int16_t dsp_sat16(int64_t value) {
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)value;
+}
+
+/**
+ * @brief 初始化滑动平均滤波器
+ */
+int dsp_moving_average_init(dsp_moving_average_t *filter, uint16_t window) {
+    if (filter == NULL || window == 0 || window > CONFIG_DSP_MOVING_AVERAGE_MAX_WINDOW) {
+        return DSP_INVALID_PARAM;
+    }
+
+    memset(filter, 0, sizeof(dsp_moving_average_t));
+    filter->window = window;
+
+    return DSP_OK;
+}
+
+/**
+ * @brief 滑动平均滤波
+ *
+ * 维护窗口和，每个样本只做一次加减，与窗口长度无关
+ */
+void dsp_moving_average_process(dsp_moving_average_t *filter, const int16_t *in, int16_t *out, uint32_t count) {
+    int32_t sum = filter->sum;
+    uint16_t index = filter->index;
+    uint16_t window = filter->window;
+    uint32_t i = 0;
+
+    /* 窗口填满前按已有样本数求平均 */
+    for (; i < count && filter->filled < window; i++) {
+        sum += in[i];
+        filter->history[index] = in[i];
+        index = (index + 1 == window) ? 0 : index + 1;
+        filter->filled++;
+        out[i] = (int16_t)(sum / filter->filled);
+    }
+
+    for (; i < count; i++) {
+        int16_t sample = in[i];
+        sum += sample - filter->history[index];
+        filter->history[index] = sample;
+        index = (index + 1 == window) ? 0 : index + 1;
+        out[i] = (int16_t)(sum / window);
+    }
+
+    filter->sum = sum;
+    filter->index = index;
+}
+
+/**
+ * @brief 初始化中值滤波器
+ */
+int dsp_median_init(dsp_median_t *filter, uint8_t window) {
+    if (filter == NULL || window == 0 || window > CONFIG_DSP_MEDIAN_MAX_WINDOW) {
+        return DSP_INVALID_PARAM;
+    }
+
+    memset(filter, 0, sizeof(dsp_median_t));
+    filter->window = window;
+
+    return DSP_OK;
+}
+
+/**
+ * @brief 中值滤波
+ */
+void dsp_median_process(dsp_median_t *filter, const int16_t *in, int16_t *out, uint32_t count) {
+    int16_t *sorted = filter->sorted;
+
+    for (uint32_t i = 0; i < count; i++) {
+        int16_t sample = in[i];
+        uint8_t n = filter->filled;
+        uint8_t pos;
+
+        if (n == filter->window) {
+            /* 从排序窗口中移除最旧样本 */
+            int16_t oldest = filter->history[filter->index];
+            pos = 0;
+            while (sorted[pos] != oldest) {
+                pos++;
+            }
+            memmove(&sorted[pos], &sorted[pos + 1], (size_t)(n - pos - 1) * sizeof(int16_t));
+            n--;
+        } else {
+            filter->filled++;
+        }
+
+        /* 插入新样本 */
+        pos = n;
+        while (pos > 0 && sorted[pos - 1] > sample) {
+            sorted[pos] = sorted[pos - 1];
+            pos--;
+        }
+        sorted[pos] = sample;
+
+        filter->history[filter->index] = sample;
+        filter->index = (filter->index + 1 == filter->window) ? 0 : filter->index + 1;
+
+        out[i] = sorted[filter->filled / 2];
+    }
+}
+
+/**
+ * @brief 初始化双二阶级联滤波器
+ */
+int dsp_biquad_init(dsp_biquad_t *filter, const int16_t *coeffs, uint8_t stages, int8_t post_shift) {
+    if (filter == NULL || coeffs == NULL || stages == 0 || stages > CONFIG_DSP_BIQUAD_MAX_STAGES ||
+        post_shift < 0 || post_shift > 15) {
+        return DSP_INVALID_PARAM;
+    }
+
+    memset(filter, 0, sizeof(dsp_biquad_t));
+    filter->stages = stages;
+    filter->post_shift = post_shift;
+
+    /* 转换为CMSIS-DSP布局，反馈系数取反后与前馈系数统一为乘加 */
+    for (uint8_t s = 0; s < stages; s++) {
+        const int16_t *src = &coeffs[s * 5];
+        int16_t *dst = &filter->coeffs[s * 6];
+
+        dst[0] = src[0];
+        dst[1] = 0;
+        dst[2] = src[1];
+        dst[3] = src[2];
+        dst[4] = dsp_sat16(-(int32_t)src[3]);
+        dst[5] = dsp_sat16(-(int32_t)src[4]);
+    }
+
+#if defined(CONFIG_DSP_USE_CMSIS) && CONFIG_DSP_USE_CMSIS
+    arm_biquad_cascade_df1_init_q15(&filter->instance, stages, filter->coeffs, filter->state, post_shift);
+#endif
+
+    return DSP_OK;
+}
+
+/**
+ * @brief 双二阶级联滤波
+ */
+void dsp_biquad_process(dsp_biquad_t *filter, const int16_t *in, int16_t *out, uint32_t count) {
+#if defined(CONFIG_DSP_USE_CMSIS) && CONFIG_DSP_USE_CMSIS
+    arm_biquad_cascade_df1_q15(&filter->instance, (q15_t *)in, out, count);
+#else
+    const int16_t *src = in;
+    int shift = 15 - filter->post_shift;
+
+    /* 逐级处理整块样本，每级的系数和状态在循环中保持在寄存器里 */
+    for (uint8_t s = 0; s < filter->stages; s++) {
+        const int16_t *c = &filter->coeffs[s * 6];
+        int16_t *state = &filter->state[s * 4];
+        int32_t b0 = c[0], b1 = c[2], b2 = c[3], a1 = c[4], a2 = c[5];
+        int16_t x1 = state[0], x2 = state[1], y1 = state[2], y2 = state[3];
+
+        for (uint32_t i = 0; i < count; i++) {
+            int16_t x0 = src[i];
+            int64_t acc = (int64_t)b0 * x0 + (int64_t)b1 * x1 + (int64_t)b2 * x2 +
+                          (int64_t)a1 * y1 + (int64_t)a2 * y2;
+            int16_t y0 = dsp_sat16(acc >> shift);
+
+            x2 = x1;
+            x1 = x0;
+            y2 = y1;
+            y1 = y0;
+            out[i] = y0;
+        }
+
+        state[0] = x1;
+        state[1] = x2;
+        state[2] = y1;
+        state[3] = y2;
+
+        /* 后续各级在输出缓冲区上原地处理 */
+        src = out;
+    }
+#endif
+}
+
+/**
+ * @brief 初始化抽取器
+ */
+int dsp_decimator_init(dsp_decimator_t *decimator, uint16_t factor) {
+    if (decimator == NULL || factor == 0) {
+        return DSP_INVALID_PARAM;
+    }
+
+    memset(decimator, 0, sizeof(dsp_decimator_t));
+    decimator->factor = factor;
+
+    return DSP_OK;
+}
+
+/**
+ * @brief 抽取
+ */
+uint32_t dsp_decimator_process(dsp_decimator_t *decimator, const int16_t *in, uint32_t count, int16_t *out) {
+    int32_t sum = decimator->sum;
+    uint16_t phase = decimator->phase;
+    uint16_t factor = decimator->factor;
+    uint32_t produced = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        sum += in[i];
+        if (++phase == factor) {
+            out[produced++] = (int16_t)(sum / factor);
+            sum = 0;
+            phase = 0;
+        }
+    }
+
+    decimator->sum = sum;
+    decimator->phase = phase;
+
+    return produced;
+}
+
+/**
+ * @brief 原始值转换为定点工程单位
+ */
+void dsp_convert_q16(const uint16_t *raw, int32_t *out, uint32_t count, int32_t gain_q16, int32_t offset) {
+    for (uint32_t i = 0; i < count; i++) {
+        out[i] = (int32_t)(((int64_t)raw[i] * gain_q16) >> 16) + offset;
+    }
+}
+
+/**
+ * @brief 原始值转换为浮点工程单位
+ */
+void dsp_convert_f32(const uint16_t *raw, float *out, uint32_t count, float gain, float offset) {
+    for (uint32_t i = 0; i < count; i++) {
+        out[i] = (float)raw[i] * gain + offset;
+    }
+}
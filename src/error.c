@@ -9,24 +9,134 @@
 #include <stdio.h>
 #include <string.h>
 
+#if (CURRENT_PLATFORM == PLATFORM_ESP32)
+#include "freertos/FreeRTOS.h"
+#endif
+
 #if (CURRENT_RTOS != RTOS_NONE)
 #include "common/rtos_api.h"
+#define ERROR_GET_TIME_MS()     rtos_get_time_ms()
+#else
+extern uint32_t platform_get_time_ms(void);
+#define ERROR_GET_TIME_MS()     platform_get_time_ms()
 #endif
 
 /* 错误回调函数最大数量 */
 #define MAX_ERROR_CALLBACKS  5
 
+/* 独立统计的模块数量，模块ID超出范围的错误只计入总数 */
+#define ERROR_STAT_MODULES   32
+
+/* 延迟分发线程参数 */
+#define ERROR_DISPATCH_STACK_SIZE   1024
+
+#if defined(__arm__)
+/*
+ * Cortex-M上使用PRIMASK临界区实现原子操作。Cortex-M0（FM33）没有LDREX/STREX，
+ * __atomic内建函数会变成libatomic调用；单核上关中断即可保证原子性
+ */
+static inline uint32_t error_irq_lock(void)
+{
+    uint32_t primask;
+
+    __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (primask) : : "memory");
+    return primask;
+}
+
+static inline void error_irq_unlock(uint32_t primask)
+{
+    __asm volatile ("msr primask, %0" : : "r" (primask) : "memory");
+}
+
+/* IPSR非零表示正在执行异常或中断处理 */
+static inline bool error_in_isr(void)
+{
+    uint32_t ipsr;
+
+    __asm volatile ("mrs %0, ipsr" : "=r" (ipsr));
+    return ipsr != 0;
+}
+
+static inline uint32_t error_atomic_load(const volatile uint32_t *ptr)
+{
+    uint32_t val = *ptr;
+
+    __asm volatile ("" : : : "memory");
+    return val;
+}
+
+static inline void error_atomic_store(volatile uint32_t *ptr, uint32_t val)
+{
+    __asm volatile ("" : : : "memory");
+    *ptr = val;
+}
+
+static inline void error_atomic_inc(volatile uint32_t *ptr)
+{
+    uint32_t primask = error_irq_lock();
+
+    (*ptr)++;
+    error_irq_unlock(primask);
+}
+
+static inline bool error_atomic_cas(volatile uint32_t *ptr, uint32_t *expected, uint32_t val)
+{
+    uint32_t primask = error_irq_lock();
+    bool ok = (*ptr == *expected);
+
+    if (ok) {
+        *ptr = val;
+    } else {
+        *expected = *ptr;
+    }
+    error_irq_unlock(primask);
+
+    return ok;
+}
+
+#define ERROR_ATOMIC_LOAD(ptr)          error_atomic_load(ptr)
+#define ERROR_ATOMIC_STORE(ptr, val)    error_atomic_store((ptr), (val))
+#define ERROR_ATOMIC_INC(ptr)           error_atomic_inc(ptr)
+#define ERROR_ATOMIC_CAS(ptr, exp, val) error_atomic_cas((ptr), (exp), (val))
+#define ERROR_IRQ_DISABLE()             ((void)error_irq_lock())
+#define ERROR_IN_ISR()                  error_in_isr()
+#else
+/* 其他平台（ESP32双核、主机）使用GCC/Clang原子内建函数 */
+#define ERROR_ATOMIC_LOAD(ptr)          __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define ERROR_ATOMIC_STORE(ptr, val)    __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#define ERROR_ATOMIC_INC(ptr)           __atomic_fetch_add((ptr), 1, __ATOMIC_RELAXED)
+#define ERROR_ATOMIC_CAS(ptr, exp, val) \
+    __atomic_compare_exchange_n((ptr), (exp), (val), true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+#if (CURRENT_PLATFORM == PLATFORM_ESP32)
+/* 只屏蔽当前核的中断，另一个核上的任务照常运行 */
+#define ERROR_IRQ_DISABLE()             portDISABLE_INTERRUPTS()
+#define ERROR_IN_ISR()                  xPortInIsrContext()
+#else
+/* 主机上没有中断 */
+#define ERROR_IRQ_DISABLE()
+#define ERROR_IN_ISR()                  false
+#endif
+#endif
+
+#if ((CONFIG_ERROR_QUEUE_SIZE) & ((CONFIG_ERROR_QUEUE_SIZE) - 1)) != 0
+#error "CONFIG_ERROR_QUEUE_SIZE must be a power of two"
+#endif
+
 /* 错误描述结构体 */
 typedef struct {
     uint32_t code;           /**< 错误码 */
     const char *description; /**< 错误描述 */
 } error_description_t;
 
-/* 错误统计结构体 */
+/* 错误记录，在报告上下文中写入，在分发上下文中读取 */
 typedef struct {
-    uint32_t module;         /**< 模块ID */
-    uint32_t count;          /**< 错误计数 */
-} error_statistics_t;
+    uint32_t sequence;       /**< 槽位序号，用于无锁同步 */
+    uint32_t code;           /**< 错误码 */
+    const char *file;        /**< 文件名 */
+    uint32_t line;           /**< 行号 */
+    uint32_t timestamp;      /**< 报告时间（毫秒） */
+    uint32_t repeat;         /**< 入队后又折叠进来的相同错误次数 */
+} error_record_t;
 
 /* 错误回调信息结构体 */
 typedef struct {
@@ -35,13 +145,49 @@ typedef struct {
     bool used;                 /**< 是否已使用 */
 } error_callback_info_t;
 
+/* 单个模块的令牌桶，令牌以千分之一为单位 */
+typedef struct {
+    uint32_t rate;           /**< 每秒补充的令牌数，0表示不限速 */
+    uint32_t burst;          /**< 桶容量 */
+    uint32_t tokens;         /**< 当前令牌数（千分之一） */
+    uint32_t last_refill;    /**< 上次补充时间（毫秒） */
+    uint32_t limited;        /**< 被限速丢弃的记录数 */
+} error_rate_limit_t;
+
 /* 全局变量 */
 static error_callback_info_t g_error_callbacks[MAX_ERROR_CALLBACKS] = {0};
-static error_statistics_t g_error_statistics[16] = {0};  /* 最多统计16个模块 */
-static uint32_t g_statistics_count = 0;
+static uint32_t g_error_statistics[ERROR_STAT_MODULES] = {0};  /* 按模块ID直接索引 */
+static uint32_t g_error_total = 0;
+
+/* 多生产者单消费者无锁环形队列 */
+static error_record_t g_error_queue[CONFIG_ERROR_QUEUE_SIZE];
+static uint32_t g_error_queue_head = 0;     /* 生产者通过CAS竞争 */
+static uint32_t g_error_queue_tail = 0;     /* 仅分发上下文访问 */
+static uint32_t g_error_dropped = 0;
+
+/* 致命错误钩子 */
+static error_panic_hook_t g_error_panic_hook = NULL;
 
+/* 聚合与限速，历史按最近出现的顺序排列，下标0为最近一条 */
+static error_history_entry_t g_error_history[CONFIG_ERROR_HISTORY_SIZE];
+static uint32_t g_error_history_count = 0;
+static bool g_error_summary_pending = false;
+static uint32_t g_error_window_ms = CONFIG_ERROR_AGGREGATE_WINDOW_MS;
+static error_rate_limit_t g_error_rate_limits[ERROR_STAT_MODULES];
+
+#if (CURRENT_RTOS != RTOS_NONE)
+static rtos_mutex_t g_error_mutex = NULL;   /* 保护回调表、聚合历史与限速参数 */
+static rtos_sem_t g_error_sem = NULL;
+static rtos_thread_t g_error_thread = NULL;
+#endif
+
+/* 互斥锁仅在线程上下文获取，裸机下聚合状态只在主循环中访问 */
 #if (CURRENT_RTOS != RTOS_NONE)
-static rtos_mutex_t g_error_mutex = NULL;
+#define ERROR_LOCK()        rtos_mutex_lock(g_error_mutex, UINT32_MAX)
+#define ERROR_UNLOCK()      rtos_mutex_unlock(g_error_mutex)
+#else
+#define ERROR_LOCK()
+#define ERROR_UNLOCK()
 #endif
 
 /* 错误描述表 */
@@ -59,6 +205,25 @@ static const error_description_t g_error_descriptions[] = {
     { 0, NULL }  /* 结束标记 */
 };
 
+#if (CURRENT_RTOS != RTOS_NONE)
+/**
+ * @brief 错误分发线程
+ * 
+ * @param arg 未使用
+ */
+static void error_dispatch_thread(void *arg)
+{
+    uint32_t timeout;
+    
+    while (1) {
+        /* 有未输出的折叠汇总时按窗口定时唤醒，错误风暴停止后也能输出汇总 */
+        timeout = (g_error_summary_pending && g_error_window_ms != 0) ? g_error_window_ms : UINT32_MAX;
+        rtos_sem_take(g_error_sem, timeout);
+        error_process();
+    }
+}
+#endif
+
 /**
  * @brief 错误处理初始化
  * 
@@ -66,18 +231,57 @@ static const error_description_t g_error_descriptions[] = {
  */
 int error_init(void)
 {
+    uint32_t i;
+    
     /* 初始化回调数组 */
     memset(g_error_callbacks, 0, sizeof(g_error_callbacks));
     
     /* 初始化统计信息 */
     memset(g_error_statistics, 0, sizeof(g_error_statistics));
-    g_statistics_count = 0;
+    g_error_total = 0;
+    
+    /* 初始化错误队列，槽位序号等于其首次可写入的位置 */
+    for (i = 0; i < CONFIG_ERROR_QUEUE_SIZE; i++) {
+        g_error_queue[i].sequence = i;
+    }
+    g_error_queue_head = 0;
+    g_error_queue_tail = 0;
+    g_error_dropped = 0;
+    
+    /* 初始化聚合历史与限速参数 */
+    memset(g_error_history, 0, sizeof(g_error_history));
+    g_error_history_count = 0;
+    g_error_summary_pending = false;
+    g_error_window_ms = CONFIG_ERROR_AGGREGATE_WINDOW_MS;
+    for (i = 0; i < ERROR_STAT_MODULES; i++) {
+        g_error_rate_limits[i].rate = CONFIG_ERROR_RATE_LIMIT;
+        g_error_rate_limits[i].burst = CONFIG_ERROR_RATE_BURST;
+        g_error_rate_limits[i].tokens = CONFIG_ERROR_RATE_BURST * 1000;
+        g_error_rate_limits[i].last_refill = 0;
+        g_error_rate_limits[i].limited = 0;
+    }
     
 #if (CURRENT_RTOS != RTOS_NONE)
     /* 创建互斥锁 */
     if (rtos_mutex_create(&g_error_mutex) != 0) {
         return -1;
     }
+    
+    /* 创建分发信号量与分发线程 */
+    if (rtos_sem_create(&g_error_sem, 0, CONFIG_ERROR_QUEUE_SIZE) != 0) {
+        rtos_mutex_delete(g_error_mutex);
+        g_error_mutex = NULL;
+        return -1;
+    }
+    
+    if (rtos_thread_create(&g_error_thread, "error_dispatch", error_dispatch_thread, NULL,
+                           ERROR_DISPATCH_STACK_SIZE, RTOS_PRIORITY_LOW) != 0) {
+        rtos_sem_delete(g_error_sem);
+        rtos_mutex_delete(g_error_mutex);
+        g_error_sem = NULL;
+        g_error_mutex = NULL;
+        return -1;
+    }
 #endif
     
     return 0;
@@ -91,6 +295,18 @@ int error_init(void)
 int error_deinit(void)
 {
 #if (CURRENT_RTOS != RTOS_NONE)
+    /* 删除分发线程 */
+    if (g_error_thread != NULL) {
+        rtos_thread_delete(g_error_thread);
+        g_error_thread = NULL;
+    }
+    
+    /* 删除信号量 */
+    if (g_error_sem != NULL) {
+        rtos_sem_delete(g_error_sem);
+        g_error_sem = NULL;
+    }
+    
     /* 删除互斥锁 */
     if (g_error_mutex != NULL) {
         rtos_mutex_delete(g_error_mutex);
@@ -185,77 +401,344 @@ int error_unregister_callback(error_callback_t callback)
  */
 static void update_error_statistics(uint32_t module)
 {
-    int i;
+    uint32_t index = (module >> 24) & 0xFF;
     
-    /* 模块ID取高8位 */
-    module &= 0xFF000000;
+    ERROR_ATOMIC_INC(&g_error_total);
     
-    /* 查找模块统计信息 */
-    for (i = 0; i < g_statistics_count; i++) {
-        if (g_error_statistics[i].module == module) {
-            g_error_statistics[i].count++;
-            return;
-        }
+    if (index < ERROR_STAT_MODULES) {
+        ERROR_ATOMIC_INC(&g_error_statistics[index]);
+    }
+}
+
+/**
+ * @brief 尝试把错误折叠进最近入队且尚未被取出的相同记录
+ * 
+ * 错误风暴中同一位置的错误连续出现时只占用一个槽位，避免在聚合之前就因
+ * 队列满而丢弃。通过CAS把槽位序号从“已发布”改回“已占用”来独占该槽位，
+ * 期间消费者视其为未就绪，修改后重新发布。消费者取出前以同样的CAS认领
+ * 槽位，已被认领的槽位CAS失败，不再折叠
+ * 
+ * @param pos 最近一次被占用的队列位置
+ * @param error_code 错误码
+ * @param file 文件名
+ * @param line 行号
+ * @return bool true表示已折叠，false表示需要占用新槽位
+ */
+static bool error_queue_coalesce(uint32_t pos, uint32_t error_code, const char *file, uint32_t line)
+{
+    error_record_t *record = &g_error_queue[pos & (CONFIG_ERROR_QUEUE_SIZE - 1)];
+    uint32_t published = pos + 1;
+    bool match;
+    
+    if (ERROR_ATOMIC_LOAD(&record->sequence) != published ||
+        !ERROR_ATOMIC_CAS(&record->sequence, &published, pos)) {
+        return false;
     }
     
-    /* 模块不存在，添加新的统计信息 */
-    if (g_statistics_count < sizeof(g_error_statistics) / sizeof(g_error_statistics[0])) {
-        g_error_statistics[g_statistics_count].module = module;
-        g_error_statistics[g_statistics_count].count = 1;
-        g_statistics_count++;
+    match = (record->code == error_code && record->file == file && record->line == line);
+    if (match) {
+        record->repeat++;
     }
+    
+    ERROR_ATOMIC_STORE(&record->sequence, pos + 1);
+    
+    return match;
 }
 
 /**
- * @brief 报告错误
+ * @brief 将错误记录写入无锁队列
  * 
  * @param error_code 错误码
  * @param file 文件名
  * @param line 行号
- * @return int 0表示成功，非0表示失败
+ * @return bool true表示写入成功，false表示队列已满
  */
-int error_report(uint32_t error_code, const char *file, uint32_t line)
+static bool error_queue_push(uint32_t error_code, const char *file, uint32_t line)
 {
-    int i;
-    uint8_t severity;
+    uint32_t pos = ERROR_ATOMIC_LOAD(&g_error_queue_head);
+    error_record_t *record;
+    int32_t diff;
     
-    if (error_code == ERROR_OK) {
-        return 0;  /* 无错误，不处理 */
+    if (error_queue_coalesce(pos - 1, error_code, file, line)) {
+        return true;
     }
     
-    /* 获取错误严重程度 */
-    severity = error_code & 0xFF;
+    for (;;) {
+        record = &g_error_queue[pos & (CONFIG_ERROR_QUEUE_SIZE - 1)];
+        diff = (int32_t)(ERROR_ATOMIC_LOAD(&record->sequence) - pos);
+        
+        if (diff == 0) {
+            /* 槽位空闲，抢占写入位置 */
+            if (ERROR_ATOMIC_CAS(&g_error_queue_head, &pos, pos + 1)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* 队列已满 */
+            return false;
+        } else {
+            /* 其他生产者已抢占该位置 */
+            pos = ERROR_ATOMIC_LOAD(&g_error_queue_head);
+        }
+    }
     
-#if (CURRENT_RTOS != RTOS_NONE)
-    /* 获取互斥锁 */
-    rtos_mutex_lock(g_error_mutex, UINT32_MAX);
-#endif
+    record->code = error_code;
+    record->file = file;
+    record->line = line;
+    record->timestamp = ERROR_GET_TIME_MS();
+    record->repeat = 0;
     
-    /* 更新统计信息 */
-    update_error_statistics(error_code & 0xFF000000);
+    /* 发布记录 */
+    ERROR_ATOMIC_STORE(&record->sequence, pos + 1);
+    
+    return true;
+}
+
+/**
+ * @brief 从无锁队列取出一条错误记录，仅由分发上下文调用
+ * 
+ * 复制前通过CAS把序号从“已发布”改为“已占用”认领槽位，与折叠的生产者互斥：
+ * 生产者先认领时本次视为未就绪，消费者先认领时折叠失败并占用新槽位
+ * 
+ * @param out 输出记录
+ * @return bool true表示取出成功，false表示队列为空
+ */
+static bool error_queue_pop(error_record_t *out)
+{
+    uint32_t pos = g_error_queue_tail;
+    error_record_t *record = &g_error_queue[pos & (CONFIG_ERROR_QUEUE_SIZE - 1)];
+    uint32_t published = pos + 1;
+    
+    /* 弱CAS可能伪失败，序号仍为“已发布”时重试 */
+    while (!ERROR_ATOMIC_CAS(&record->sequence, &published, pos)) {
+        if (published != pos + 1) {
+            return false;
+        }
+    }
+    
+    out->code = record->code;
+    out->file = record->file;
+    out->line = record->line;
+    out->timestamp = record->timestamp;
+    out->repeat = record->repeat;
+    
+    /* 归还槽位给下一轮生产者 */
+    ERROR_ATOMIC_STORE(&record->sequence, pos + CONFIG_ERROR_QUEUE_SIZE);
+    g_error_queue_tail = pos + 1;
+    
+    return true;
+}
+
+/**
+ * @brief 输出条目在窗口内被折叠的次数并清零
+ * 
+ * @param entry 历史条目
+ */
+static void error_history_summarize(error_history_entry_t *entry)
+{
+    if (entry->suppressed > 0) {
+        LOG_WARN("Error: 0x%08X, File: %s, Line: %d repeated %u times",
+                 entry->code, entry->file, entry->line, entry->suppressed);
+        entry->suppressed = 0;
+    }
+}
+
+/**
+ * @brief 查找或分配错误历史条目
+ * 
+ * 以错误码、文件和行号为键。命中的条目移到最前，历史已满时淘汰最久
+ * 未出现的条目，因此频繁出现的错误始终保留在历史中
+ * 
+ * @param record 错误记录
+ * @param is_new 输出是否为新分配的条目
+ * @return error_history_entry_t* 历史条目，位于下标0
+ */
+static error_history_entry_t *error_history_lookup(const error_record_t *record, bool *is_new)
+{
+    error_history_entry_t found;
+    uint32_t i;
+    
+    for (i = 0; i < g_error_history_count; i++) {
+        error_history_entry_t *entry = &g_error_history[i];
+        
+        if (entry->code == record->code && entry->line == record->line && entry->file == record->file) {
+            found = *entry;
+            memmove(&g_error_history[1], &g_error_history[0], i * sizeof(error_history_entry_t));
+            g_error_history[0] = found;
+            *is_new = false;
+            return &g_error_history[0];
+        }
+    }
+    
+    if (g_error_history_count < CONFIG_ERROR_HISTORY_SIZE) {
+        g_error_history_count++;
+    } else {
+        /* 淘汰前输出其未汇总的折叠次数 */
+        error_history_summarize(&g_error_history[CONFIG_ERROR_HISTORY_SIZE - 1]);
+    }
+    memmove(&g_error_history[1], &g_error_history[0],
+            (g_error_history_count - 1) * sizeof(error_history_entry_t));
+    
+    memset(&g_error_history[0], 0, sizeof(error_history_entry_t));
+    g_error_history[0].code = record->code;
+    g_error_history[0].file = record->file;
+    g_error_history[0].line = record->line;
+    g_error_history[0].first_timestamp = record->timestamp;
+    *is_new = true;
+    
+    return &g_error_history[0];
+}
+
+/**
+ * @brief 输出所有窗口已结束的折叠汇总
+ * 
+ * 错误风暴停止后不会再有同一错误触发新窗口，由分发上下文定期调用
+ * 
+ * @param now 当前时间（毫秒）
+ */
+static void error_history_flush(uint32_t now)
+{
+    bool pending = false;
+    uint32_t i;
+    
+    for (i = 0; i < g_error_history_count; i++) {
+        error_history_entry_t *entry = &g_error_history[i];
+        
+        if (entry->suppressed == 0) {
+            continue;
+        }
+        if ((now - entry->window_start) >= g_error_window_ms) {
+            error_history_summarize(entry);
+        } else {
+            pending = true;
+        }
+    }
+    
+    g_error_summary_pending = pending;
+}
+
+/**
+ * @brief 从模块令牌桶中取一个令牌
+ * 
+ * @param code 错误码
+ * @param now 当前时间（毫秒）
+ * @return bool true表示允许输出，false表示被限速
+ */
+static bool error_rate_limit_take(uint32_t code, uint32_t now)
+{
+    uint32_t index = (code >> 24) & 0xFF;
+    error_rate_limit_t *limit;
+    uint32_t elapsed;
+    uint32_t capacity;
+    
+    if (index >= ERROR_STAT_MODULES || g_error_rate_limits[index].rate == 0) {
+        return true;
+    }
+    
+    limit = &g_error_rate_limits[index];
+    capacity = limit->burst * 1000;
+    
+    /* 按经过时间补充令牌，rate个/秒即rate个千分之一令牌/毫秒 */
+    elapsed = now - limit->last_refill;
+    limit->last_refill = now;
+    if (elapsed >= capacity / limit->rate) {
+        limit->tokens = capacity;
+    } else {
+        limit->tokens += elapsed * limit->rate;
+        if (limit->tokens > capacity) {
+            limit->tokens = capacity;
+        }
+    }
+    
+    if (limit->tokens < 1000) {
+        limit->limited++;
+        return false;
+    }
+    
+    limit->tokens -= 1000;
+    return true;
+}
+
+/**
+ * @brief 聚合重复错误并执行限速
+ * 
+ * 窗口内重复出现的同一错误只计数；窗口结束后首次出现时先输出汇总，
+ * 再按模块令牌桶决定是否输出日志和调用回调。入队前已折叠的重复次数
+ * 直接计入折叠数。致命错误不受限制。
+ * 
+ * @param record 错误记录
+ * @return bool true表示需要分发，false表示已被聚合或限速
+ */
+static bool error_aggregate(const error_record_t *record)
+{
+    error_history_entry_t *entry;
+    bool dispatch = true;
+    bool is_new;
+    
+    entry = error_history_lookup(record, &is_new);
+    entry->count += 1 + record->repeat;
+    entry->last_timestamp = record->timestamp;
+    
+    if ((record->code & 0xFF) == ERROR_SEVERITY_FATAL) {
+        return true;
+    }
+    
+    if (!is_new && (record->timestamp - entry->window_start) < g_error_window_ms) {
+        dispatch = false;
+    } else {
+        /* 新窗口开始，汇总上一个窗口中被折叠的记录 */
+        error_history_summarize(entry);
+        entry->window_start = record->timestamp;
+        
+        if (!error_rate_limit_take(record->code, record->timestamp)) {
+            dispatch = false;
+        }
+    }
+    
+    entry->suppressed += record->repeat + (dispatch ? 0 : 1);
+    if (entry->suppressed > 0) {
+        g_error_summary_pending = true;
+    }
+    
+    return dispatch;
+}
+
+/**
+ * @brief 输出日志并调用注册的回调函数
+ * 
+ * @param record 错误记录
+ */
+static void error_dispatch_record(const error_record_t *record)
+{
+    int i;
     
     /* 根据错误严重程度输出日志 */
-    switch (severity) {
+    switch (record->code & 0xFF) {
         case ERROR_SEVERITY_INFO:
-            LOG_INFO("Error: 0x%08X, File: %s, Line: %d", error_code, file, line);
+            LOG_INFO("Error: 0x%08X, File: %s, Line: %d", record->code, record->file, record->line);
             break;
         case ERROR_SEVERITY_WARNING:
-            LOG_WARN("Error: 0x%08X, File: %s, Line: %d", error_code, file, line);
+            LOG_WARN("Error: 0x%08X, File: %s, Line: %d", record->code, record->file, record->line);
             break;
         case ERROR_SEVERITY_ERROR:
         case ERROR_SEVERITY_CRITICAL:
         case ERROR_SEVERITY_FATAL:
-            LOG_ERROR("Error: 0x%08X, File: %s, Line: %d", error_code, file, line);
+            LOG_ERROR("Error: 0x%08X, File: %s, Line: %d", record->code, record->file, record->line);
             break;
         default:
-            LOG_ERROR("Unknown Error: 0x%08X, File: %s, Line: %d", error_code, file, line);
+            LOG_ERROR("Unknown Error: 0x%08X, File: %s, Line: %d", record->code, record->file, record->line);
             break;
     }
     
+#if (CURRENT_RTOS != RTOS_NONE)
+    /* 获取互斥锁 */
+    rtos_mutex_lock(g_error_mutex, UINT32_MAX);
+#endif
+    
     /* 调用注册的回调函数 */
     for (i = 0; i < MAX_ERROR_CALLBACKS; i++) {
         if (g_error_callbacks[i].used && g_error_callbacks[i].callback != NULL) {
-            g_error_callbacks[i].callback(error_code, file, line, g_error_callbacks[i].user_data);
+            g_error_callbacks[i].callback(record->code, record->file, record->line,
+                                          g_error_callbacks[i].user_data);
         }
     }
     
@@ -263,16 +746,219 @@ int error_report(uint32_t error_code, const char *file, uint32_t line)
     /* 释放互斥锁 */
     rtos_mutex_unlock(g_error_mutex);
 #endif
+}
+
+/**
+ * @brief 报告错误
+ * 
+ * 只做原子计数和入队，可在任意上下文（包括中断）中调用，
+ * 日志输出和回调由分发上下文延迟执行
+ * 
+ * @param error_code 错误码
+ * @param file 文件名
+ * @param line 行号
+ * @return int 0表示成功，非0表示失败
+ */
+int error_report(uint32_t error_code, const char *file, uint32_t line)
+{
+    uint8_t severity;
+    
+    if (error_code == ERROR_OK) {
+        return 0;  /* 无错误，不处理 */
+    }
+    
+    /* 获取错误严重程度 */
+    severity = error_code & 0xFF;
+    
+    /* 更新统计信息 */
+    update_error_statistics(error_code & 0xFF000000);
+    
+    /* 写入队列，队列满时丢弃并计数；致命错误即使丢弃也要停机 */
+    if (!error_queue_push(error_code, file, line)) {
+        ERROR_ATOMIC_INC(&g_error_dropped);
+        if (severity != ERROR_SEVERITY_FATAL) {
+            return -1;
+        }
+    }
     
-    /* 如果是致命错误，停止系统 */
+    /*
+     * 致命错误：停机后分发上下文不会再运行，线程上下文中直接输出该记录。
+     * 中断上下文中不能输出日志、获取互斥锁或抢占分发上下文的出队位置，
+     * 只能依赖中断安全的钩子。之后关中断并停机
+     */
     if (severity == ERROR_SEVERITY_FATAL) {
-        LOG_ERROR("Fatal error detected, system halted.");
+        error_panic_hook_t hook = g_error_panic_hook;
+        
+        if (!ERROR_IN_ISR()) {
+            LOG_ERROR("Error: 0x%08X, File: %s, Line: %d", error_code, file, line);
+            LOG_ERROR("Fatal error detected, system halted.");
+        }
+        
+        ERROR_IRQ_DISABLE();
+        if (hook != NULL) {
+            hook(error_code, file, line);
+        }
         while (1);  /* 死循环 */
     }
     
+#if (CURRENT_RTOS != RTOS_NONE)
+    /* 唤醒分发线程 */
+    if (g_error_sem != NULL) {
+        rtos_sem_give(g_error_sem);
+    }
+#endif
+    
     return 0;
 }
 
+/**
+ * @brief 处理队列中的错误记录
+ * 
+ * @return uint32_t 本次处理的记录数
+ */
+uint32_t error_process(void)
+{
+    error_record_t record;
+    uint32_t count = 0;
+    bool dispatch;
+    
+    while (error_queue_pop(&record)) {
+        ERROR_LOCK();
+        dispatch = error_aggregate(&record);
+        ERROR_UNLOCK();
+        
+        if (dispatch) {
+            error_dispatch_record(&record);
+        }
+        count++;
+    }
+    
+    /* 输出窗口已结束但之后没有再出现的错误的折叠汇总 */
+    ERROR_LOCK();
+    if (g_error_summary_pending) {
+        error_history_flush(ERROR_GET_TIME_MS());
+    }
+    ERROR_UNLOCK();
+    
+    return count;
+}
+
+/**
+ * @brief 设置致命错误钩子
+ * 
+ * @param hook 钩子函数，NULL表示不调用
+ */
+void error_set_panic_hook(error_panic_hook_t hook)
+{
+    g_error_panic_hook = hook;
+}
+
+/**
+ * @brief 获取因队列满而丢弃的错误记录数
+ * 
+ * @return uint32_t 丢弃的记录数
+ */
+uint32_t error_get_dropped_count(void)
+{
+    return ERROR_ATOMIC_LOAD(&g_error_dropped);
+}
+
+/**
+ * @brief 设置重复错误聚合窗口
+ * 
+ * @param window_ms 窗口长度（毫秒），0表示不聚合
+ * @return int 0表示成功，非0表示失败
+ */
+int error_set_aggregation_window(uint32_t window_ms)
+{
+    ERROR_LOCK();
+    g_error_window_ms = window_ms;
+    ERROR_UNLOCK();
+    
+    return 0;
+}
+
+/**
+ * @brief 设置模块的错误输出限速
+ * 
+ * @param module 模块标识，0表示所有模块
+ * @param rate 每秒允许输出的错误数，0表示不限速
+ * @param burst 允许的突发数量
+ * @return int 0表示成功，非0表示失败
+ */
+int error_set_rate_limit(uint32_t module, uint32_t rate, uint32_t burst)
+{
+    uint32_t index = (module >> 24) & 0xFF;
+    uint32_t i;
+    
+    if (rate != 0 && burst == 0) {
+        return -1;
+    }
+    
+    if (module != 0 && index >= ERROR_STAT_MODULES) {
+        return -1;
+    }
+    
+    ERROR_LOCK();
+    for (i = 0; i < ERROR_STAT_MODULES; i++) {
+        if (module == 0 || i == index) {
+            g_error_rate_limits[i].rate = rate;
+            g_error_rate_limits[i].burst = burst;
+            g_error_rate_limits[i].tokens = burst * 1000;
+        }
+    }
+    ERROR_UNLOCK();
+    
+    return 0;
+}
+
+/**
+ * @brief 获取被限速丢弃的错误记录数
+ * 
+ * @param module 模块标识，0表示所有模块
+ * @return uint32_t 被限速的记录数
+ */
+uint32_t error_get_rate_limited_count(uint32_t module)
+{
+    uint32_t index = (module >> 24) & 0xFF;
+    uint32_t count = 0;
+    uint32_t i;
+    
+    ERROR_LOCK();
+    for (i = 0; i < ERROR_STAT_MODULES; i++) {
+        if (module == 0 || i == index) {
+            count += g_error_rate_limits[i].limited;
+        }
+    }
+    ERROR_UNLOCK();
+    
+    return count;
+}
+
+/**
+ * @brief 获取最近出现的不同错误
+ * 
+ * @param entries 输出数组，按最近出现的顺序排列
+ * @param max_entries 数组容量
+ * @return uint32_t 实际输出的条目数
+ */
+uint32_t error_get_aggregate_history(error_history_entry_t *entries, uint32_t max_entries)
+{
+    uint32_t count;
+    
+    if (entries == NULL) {
+        return 0;
+    }
+    
+    /* 历史已按最近出现的顺序排列，加锁避免读到分发上下文正在移动的条目 */
+    ERROR_LOCK();
+    count = (g_error_history_count < max_entries) ? g_error_history_count : max_entries;
+    memcpy(entries, g_error_history, count * sizeof(error_history_entry_t));
+    ERROR_UNLOCK();
+    
+    return count;
+}
+
 /**
  * @brief 获取错误描述
  * 
@@ -302,39 +988,22 @@ const char *error_get_description(uint32_t error_code)
  */
 int error_get_statistics(uint32_t module, uint32_t *count)
 {
-    int i;
+    uint32_t index = (module >> 24) & 0xFF;
     
     if (count == NULL) {
         return -1;
     }
     
-    *count = 0;
-    
-#if (CURRENT_RTOS != RTOS_NONE)
-    /* 获取互斥锁 */
-    rtos_mutex_lock(g_error_mutex, UINT32_MAX);
-#endif
-    
     if (module == 0) {
         /* 统计所有模块的错误 */
-        for (i = 0; i < g_statistics_count; i++) {
-            *count += g_error_statistics[i].count;
-        }
-    } else {
+        *count = ERROR_ATOMIC_LOAD(&g_error_total);
+    } else if (index < ERROR_STAT_MODULES) {
         /* 统计指定模块的错误 */
-        for (i = 0; i < g_statistics_count; i++) {
-            if (g_error_statistics[i].module == module) {
-                *count = g_error_statistics[i].count;
-                break;
-            }
-        }
+        *count = ERROR_ATOMIC_LOAD(&g_error_statistics[index]);
+    } else {
+        *count = 0;
     }
     
-#if (CURRENT_RTOS != RTOS_NONE)
-    /* 释放互斥锁 */
-    rtos_mutex_unlock(g_error_mutex);
-#endif
-    
     return 0;
 }
 
@@ -346,31 +1015,19 @@ int error_get_statistics(uint32_t module, uint32_t *count)
  */
 int error_clear_statistics(uint32_t module)
 {
-    int i;
-    
-#if (CURRENT_RTOS != RTOS_NONE)
-    /* 获取互斥锁 */
-    rtos_mutex_lock(g_error_mutex, UINT32_MAX);
-#endif
+    uint32_t index = (module >> 24) & 0xFF;
+    uint32_t i;
     
     if (module == 0) {
         /* 清除所有模块的统计信息 */
-        memset(g_error_statistics, 0, sizeof(g_error_statistics));
-        g_statistics_count = 0;
-    } else {
-        /* 清除指定模块的统计信息 */
-        for (i = 0; i < g_statistics_count; i++) {
-            if (g_error_statistics[i].module == module) {
-                g_error_statistics[i].count = 0;
-                break;
-            }
+        for (i = 0; i < ERROR_STAT_MODULES; i++) {
+            ERROR_ATOMIC_STORE(&g_error_statistics[i], 0);
         }
+        ERROR_ATOMIC_STORE(&g_error_total, 0);
+    } else if (index < ERROR_STAT_MODULES) {
+        /* 清除指定模块的统计信息 */
+        ERROR_ATOMIC_STORE(&g_error_statistics[index], 0);
     }
     
-#if (CURRENT_RTOS != RTOS_NONE)
-    /* 释放互斥锁 */
-    rtos_mutex_unlock(g_error_mutex);
-#endif
-    
     return 0;
 }
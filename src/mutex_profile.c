@@ -0,0 +1,467 @@
+/**
+ * @file mutex_profile.c
+ * @brief RTOS互斥锁性能剖析实现
+ *
+ * 剖析记录保存在以互斥锁句柄为键的开放寻址哈希表中，查找为O(1)。
+ * 获取互斥锁时先以零超时尝试，失败即计为一次竞争并记录当时的持有者，
+ * 再按调用者给定的超时阻塞等待。优先级继承生效时，最近一次竞争的持有者
+ * 即为被临时提升优先级的线程。除超时计数外，所有统计字段都只在持有
+ * 该互斥锁期间更新，因此无需额外加锁。
+ */
+
+/* 本文件调用真实的互斥锁接口 */
+#define RTOS_MUTEX_PROFILE_NO_REDIRECT
+
+#include "common/mutex_profile.h"
+#include "common/error_api.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+/* 计时源，默认使用平台层微秒时间，可在编译时替换为CPU周期计数器 */
+#ifndef MUTEX_PROFILE_TIME_US
+extern uint64_t platform_get_time_us(void);
+#define MUTEX_PROFILE_TIME_US()     platform_get_time_us()
+#endif
+
+/* 剖析记录 */
+typedef struct {
+    rtos_mutex_profile_info_t info;     /**< 对外统计信息 */
+    uint64_t acquire_us;                /**< 本次获取的时间戳 */
+} mutex_profile_record_t;
+
+/* 剖析状态 */
+static struct {
+    mutex_profile_record_t records[CONFIG_RTOS_MUTEX_PROFILE_MAX];  /**< 哈希表 */
+    mutex_profile_record_t *order[CONFIG_RTOS_MUTEX_PROFILE_MAX];   /**< 按登记顺序排列 */
+    uint32_t count;                                                 /**< 登记数量 */
+    rtos_mutex_t registry_mutex;                                    /**< 保护登记过程 */
+    bool initialized;                                               /**< 是否已初始化 */
+} g_mutex_profile;
+
+/**
+ * @brief 计算句柄的哈希槽位
+ */
+static uint32_t mutex_profile_hash(rtos_mutex_t mutex)
+{
+    uintptr_t key = (uintptr_t)mutex;
+
+    key ^= key >> 7;
+    key ^= key >> 13;
+
+    return (uint32_t)(key % CONFIG_RTOS_MUTEX_PROFILE_MAX);
+}
+
+/**
+ * @brief 查找互斥锁对应的剖析记录
+ *
+ * @param mutex 互斥锁句柄
+ * @return mutex_profile_record_t* 剖析记录，未登记返回NULL
+ */
+static mutex_profile_record_t *mutex_profile_find(rtos_mutex_t mutex)
+{
+    uint32_t index = mutex_profile_hash(mutex);
+    uint32_t i;
+
+    for (i = 0; i < CONFIG_RTOS_MUTEX_PROFILE_MAX; i++) {
+        mutex_profile_record_t *record = &g_mutex_profile.records[index];
+
+        if (record->info.mutex == mutex) {
+            return record;
+        }
+        if (record->info.mutex == NULL) {
+            return NULL;
+        }
+
+        index = (index + 1) % CONFIG_RTOS_MUTEX_PROFILE_MAX;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 清零剖析记录的统计计数
+ */
+static void mutex_profile_clear(rtos_mutex_profile_info_t *info)
+{
+    info->acquisitions = 0;
+    info->contentions = 0;
+    info->timeouts = 0;
+    info->max_wait_us = 0;
+    info->total_wait_us = 0;
+    info->max_hold_us = 0;
+    info->total_hold_us = 0;
+    info->max_hold_owner = NULL;
+    info->last_blocker = NULL;
+}
+
+/**
+ * @brief 登记互斥锁，表满时返回NULL，该互斥锁不参与统计
+ *
+ * 同一句柄被删除后重新创建时复用原记录；表中没有空槽位时回收探测链上
+ * 第一个已删除的记录。记录不会被置空，其他线程无锁查找时探测链保持完整
+ */
+static mutex_profile_record_t *mutex_profile_insert(rtos_mutex_t mutex, const char *file, uint32_t line)
+{
+    uint32_t index = mutex_profile_hash(mutex);
+    mutex_profile_record_t *reuse = NULL;
+    mutex_profile_record_t *record = NULL;
+    uint32_t i;
+
+    for (i = 0; i < CONFIG_RTOS_MUTEX_PROFILE_MAX; i++) {
+        mutex_profile_record_t *slot = &g_mutex_profile.records[index];
+
+        if (slot->info.mutex == mutex) {
+            record = slot;
+            break;
+        }
+        if (slot->info.mutex == NULL) {
+            break;
+        }
+        if (reuse == NULL && slot->info.deleted) {
+            reuse = slot;
+        }
+
+        index = (index + 1) % CONFIG_RTOS_MUTEX_PROFILE_MAX;
+    }
+
+    if (record == NULL) {
+        if (i < CONFIG_RTOS_MUTEX_PROFILE_MAX) {
+            /* 空槽位优先，保留已删除互斥锁的统计信息 */
+            record = &g_mutex_profile.records[index];
+            g_mutex_profile.order[g_mutex_profile.count++] = record;
+        } else if (reuse != NULL) {
+            record = reuse;
+        } else {
+            return NULL;
+        }
+    }
+
+    mutex_profile_clear(&record->info);
+    record->acquire_us = 0;
+    record->info.owner = NULL;
+    record->info.deleted = false;
+    record->info.name = file;
+    record->info.line = line;
+    record->info.mutex = mutex;
+
+    return record;
+}
+
+/**
+ * @brief 去掉文件名中的目录部分
+ */
+static const char *mutex_profile_basename(const char *path)
+{
+    const char *name = path;
+
+    if (path == NULL) {
+        return "?";
+    }
+
+    for (; *path != '\0'; path++) {
+        if (*path == '/' || *path == '\\') {
+            name = path + 1;
+        }
+    }
+
+    return name;
+}
+
+/**
+ * @brief 初始化互斥锁剖析
+ *
+ * 由rtos_init调用，在任何线程创建互斥锁之前创建登记锁
+ *
+ * @return int 0表示成功，非0表示失败
+ */
+int rtos_mutex_profile_init(void)
+{
+    if (g_mutex_profile.initialized) {
+        return RTOS_OK;
+    }
+
+    if (rtos_mutex_create(&g_mutex_profile.registry_mutex) != RTOS_OK) {
+        return RTOS_ERROR;
+    }
+    g_mutex_profile.initialized = true;
+
+    return RTOS_OK;
+}
+
+/**
+ * @brief 创建互斥锁并登记剖析记录
+ *
+ * @param mutex 互斥锁句柄指针
+ * @param file 创建处文件名
+ * @param line 创建处行号
+ * @return int 0表示成功，非0表示失败
+ */
+int rtos_mutex_profile_create(rtos_mutex_t *mutex, const char *file, uint32_t line)
+{
+    int ret;
+
+    ret = rtos_mutex_create(mutex);
+    if (ret != RTOS_OK) {
+        return ret;
+    }
+
+    /* rtos_init之前创建的互斥锁照常工作，但不参与统计 */
+    if (!g_mutex_profile.initialized) {
+        return RTOS_OK;
+    }
+
+    rtos_mutex_lock(g_mutex_profile.registry_mutex, UINT32_MAX);
+    if (mutex_profile_insert(*mutex, mutex_profile_basename(file), line) == NULL) {
+        LOG_WARN("Mutex profile table full, %s:%u not profiled", mutex_profile_basename(file), line);
+    }
+    rtos_mutex_unlock(g_mutex_profile.registry_mutex);
+
+    return RTOS_OK;
+}
+
+/**
+ * @brief 删除互斥锁，保留其统计信息直到记录被回收
+ *
+ * @param mutex 互斥锁句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int rtos_mutex_profile_delete(rtos_mutex_t mutex)
+{
+    mutex_profile_record_t *record = mutex_profile_find(mutex);
+
+    if (record != NULL) {
+        record->info.deleted = true;
+        record->info.owner = NULL;
+    }
+
+    return rtos_mutex_delete(mutex);
+}
+
+/**
+ * @brief 获取互斥锁并记录等待与竞争
+ *
+ * @param mutex 互斥锁句柄
+ * @param timeout_ms 超时时间（毫秒），0表示不等待，UINT32_MAX表示永久等待
+ * @return int 0表示成功，非0表示失败
+ */
+int rtos_mutex_profile_lock(rtos_mutex_t mutex, uint32_t timeout_ms)
+{
+    mutex_profile_record_t *record = mutex_profile_find(mutex);
+    const char *blocker = NULL;
+    bool contended = false;
+    uint64_t start_us;
+    uint64_t now_us;
+    uint32_t wait_us;
+    int ret;
+
+    if (record == NULL) {
+        return rtos_mutex_lock(mutex, timeout_ms);
+    }
+
+    start_us = MUTEX_PROFILE_TIME_US();
+
+    ret = rtos_mutex_lock(mutex, 0);
+    if (ret != RTOS_OK && timeout_ms != 0) {
+        /* 持有者名称在锁外读取，仅用于诊断 */
+        blocker = record->info.owner;
+        contended = true;
+        ret = rtos_mutex_lock(mutex, timeout_ms);
+    }
+
+    if (ret != RTOS_OK) {
+        record->info.timeouts++;
+        return ret;
+    }
+
+    /* 以下字段仅在持有该互斥锁时更新 */
+    now_us = MUTEX_PROFILE_TIME_US();
+    wait_us = (uint32_t)(now_us - start_us);
+
+    record->info.acquisitions++;
+    if (contended) {
+        record->info.contentions++;
+        record->info.last_blocker = blocker;
+        record->info.total_wait_us += wait_us;
+        if (wait_us > record->info.max_wait_us) {
+            record->info.max_wait_us = wait_us;
+        }
+    }
+
+    record->acquire_us = now_us;
+    record->info.owner = rtos_thread_get_name(NULL);
+
+    return RTOS_OK;
+}
+
+/**
+ * @brief 释放互斥锁并记录持有时间
+ *
+ * @param mutex 互斥锁句柄
+ * @return int 0表示成功，非0表示失败
+ */
+int rtos_mutex_profile_unlock(rtos_mutex_t mutex)
+{
+    mutex_profile_record_t *record = mutex_profile_find(mutex);
+    uint32_t hold_us;
+
+    if (record != NULL && record->info.owner != NULL) {
+        hold_us = (uint32_t)(MUTEX_PROFILE_TIME_US() - record->acquire_us);
+
+        record->info.total_hold_us += hold_us;
+        if (hold_us > record->info.max_hold_us) {
+            record->info.max_hold_us = hold_us;
+            record->info.max_hold_owner = record->info.owner;
+        }
+        record->info.owner = NULL;
+    }
+
+    return rtos_mutex_unlock(mutex);
+}
+
+/**
+ * @brief 设置互斥锁的显示名称
+ *
+ * @param mutex 互斥锁句柄
+ * @param name 名称，需在整个运行期间有效
+ * @return int 0表示成功，非0表示失败
+ */
+int rtos_mutex_profile_set_name(rtos_mutex_t mutex, const char *name)
+{
+    mutex_profile_record_t *record;
+
+    if (mutex == NULL || name == NULL) {
+        return RTOS_INVALID_PARAM;
+    }
+
+    record = mutex_profile_find(mutex);
+    if (record == NULL) {
+        return RTOS_ERROR;
+    }
+
+    record->info.name = name;
+    record->info.line = 0;
+
+    return RTOS_OK;
+}
+
+/**
+ * @brief 获取已登记的互斥锁数量
+ *
+ * @return uint32_t 互斥锁数量
+ */
+uint32_t rtos_mutex_profile_get_count(void)
+{
+    return g_mutex_profile.count;
+}
+
+/**
+ * @brief 获取指定序号的互斥锁统计信息
+ *
+ * @param index 序号
+ * @param info 统计信息输出
+ * @return int 0表示成功，非0表示失败
+ */
+int rtos_mutex_profile_get_info(uint32_t index, rtos_mutex_profile_info_t *info)
+{
+    if (info == NULL || index >= g_mutex_profile.count) {
+        return RTOS_INVALID_PARAM;
+    }
+
+    memcpy(info, &g_mutex_profile.order[index]->info, sizeof(rtos_mutex_profile_info_t));
+
+    return RTOS_OK;
+}
+
+/**
+ * @brief 清零所有互斥锁的统计计数
+ */
+void rtos_mutex_profile_reset(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < g_mutex_profile.count; i++) {
+        mutex_profile_clear(&g_mutex_profile.order[i]->info);
+    }
+}
+
+/**
+ * @brief 以表格形式打印所有互斥锁统计信息
+ */
+void rtos_mutex_profile_dump(void)
+{
+    uint32_t i;
+
+    printf("%-24s %5s %10s %8s %6s %10s %10s %-12s %-12s\r\n",
+           "mutex", "line", "acquire", "contend", "tmo",
+           "max_wait", "max_hold", "owner", "blocker");
+
+    for (i = 0; i < g_mutex_profile.count; i++) {
+        const rtos_mutex_profile_info_t *info = &g_mutex_profile.order[i]->info;
+
+        printf("%-24s %5u %10u %8u %6u %10u %10u %-12s %-12s%s\r\n",
+               info->name, (unsigned)info->line,
+               (unsigned)info->acquisitions, (unsigned)info->contentions,
+               (unsigned)info->timeouts,
+               (unsigned)info->max_wait_us, (unsigned)info->max_hold_us,
+               info->owner ? info->owner : "-",
+               info->last_blocker ? info->last_blocker : "-",
+               info->deleted ? " (deleted)" : "");
+    }
+}
+
+/**
+ * @brief 以JSON格式输出所有互斥锁统计信息
+ *
+ * @param buffer 输出缓冲区
+ * @param size 缓冲区大小
+ * @return int 写入的字节数（不含结尾'\0'），缓冲区不足返回-1
+ */
+int rtos_mutex_profile_to_json(char *buffer, uint32_t size)
+{
+    uint32_t offset = 0;
+    uint32_t i;
+    int len;
+
+    if (buffer == NULL || size == 0) {
+        return -1;
+    }
+
+    len = snprintf(buffer, size, "[");
+    if (len < 0 || (uint32_t)len >= size) {
+        return -1;
+    }
+    offset = (uint32_t)len;
+
+    for (i = 0; i < g_mutex_profile.count; i++) {
+        const rtos_mutex_profile_info_t *info = &g_mutex_profile.order[i]->info;
+
+        len = snprintf(buffer + offset, size - offset,
+                       "%s{\"name\":\"%s\",\"line\":%u,\"deleted\":%s,"
+                       "\"acquisitions\":%u,\"contentions\":%u,\"timeouts\":%u,"
+                       "\"max_wait_us\":%u,\"total_wait_us\":%" PRIu64 ","
+                       "\"max_hold_us\":%u,\"total_hold_us\":%" PRIu64 ","
+                       "\"owner\":\"%s\",\"max_hold_owner\":\"%s\",\"last_blocker\":\"%s\"}",
+                       (i > 0) ? "," : "",
+                       info->name, (unsigned)info->line, info->deleted ? "true" : "false",
+                       (unsigned)info->acquisitions, (unsigned)info->contentions,
+                       (unsigned)info->timeouts,
+                       (unsigned)info->max_wait_us, info->total_wait_us,
+                       (unsigned)info->max_hold_us, info->total_hold_us,
+                       info->owner ? info->owner : "",
+                       info->max_hold_owner ? info->max_hold_owner : "",
+                       info->last_blocker ? info->last_blocker : "");
+        if (len < 0 || (uint32_t)len >= size - offset) {
+            return -1;
+        }
+        offset += (uint32_t)len;
+    }
+
+    len = snprintf(buffer + offset, size - offset, "]");
+    if (len < 0 || (uint32_t)len >= size - offset) {
+        return -1;
+    }
+    offset += (uint32_t)len;
+
+    return (int)offset;
+}
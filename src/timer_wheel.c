@@ -0,0 +1,609 @@
+/**
+ * @file timer_wheel.c
+ * @brief 分层时间轮软件定时器实现
+ *
+ * 该文件实现了四层、每层64槽的分层时间轮。第0层槽位精度为1个tick，
+ * 第n层槽位覆盖64^n个tick，高层槽位在低层回绕时逐级迁移到低层。
+ * 所有软件定时器共享一个内核定时器，到期的定时器先移入待回调链表，
+ * 释放锁后再逐个执行回调，回调中可以安全地启动或停止任意定时器。
+ */
+
+#include "common/timer_wheel.h"
+#include "common/error_api.h"
+#include <string.h>
+
+#if (CURRENT_RTOS != RTOS_NONE)
+#include "common/rtos_api.h"
+#endif
+
+#define TW_SLOT_MASK        (TIMER_WHEEL_SLOTS - 1)
+
+/* RTOS环境下默认由内核定时器按系统时间驱动，手动推进模式下由调用者逐tick推进 */
+#if (CURRENT_RTOS != RTOS_NONE) && !defined(CONFIG_TIMER_WHEEL_MANUAL_TICK)
+#define TW_KERNEL_DRIVEN    1
+#else
+#define TW_KERNEL_DRIVEN    0
+#endif
+
+/* 槽位链表头，使用哨兵节点使插入和删除均为O(1) */
+typedef struct {
+    timer_wheel_timer_t *next;
+    timer_wheel_timer_t *prev;
+} tw_list_t;
+
+/* 时间轮状态 */
+static struct {
+    tw_list_t slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];    /**< 各层槽位 */
+    tw_list_t expired;                                          /**< 待回调链表 */
+    uint32_t current;                                           /**< 最近一次处理完成的tick */
+    uint32_t tick_ms;                                           /**< tick周期（毫秒） */
+    timer_wheel_stats_t stats;                                  /**< 统计信息 */
+    bool initialized;                                           /**< 是否已初始化 */
+#if TW_KERNEL_DRIVEN
+    uint32_t last_ms;                                           /**< 上次推进对应的系统时间 */
+    rtos_timer_t kernel_timer;                                  /**< 驱动时间轮的内核定时器 */
+#endif
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_mutex_t mutex;                                         /**< 互斥锁 */
+#endif
+} g_timer_wheel;
+
+/* 加锁与解锁 */
+#if (CURRENT_RTOS != RTOS_NONE)
+#define TW_LOCK()       rtos_mutex_lock(g_timer_wheel.mutex, UINT32_MAX)
+#define TW_UNLOCK()     rtos_mutex_unlock(g_timer_wheel.mutex)
+#elif defined(__arm__)
+/* 裸机环境下tick中断与主循环会同时访问时间轮，使用PRIMASK临界区保护 */
+static inline uint32_t tw_irq_lock(void)
+{
+    uint32_t primask;
+
+    __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (primask) : : "memory");
+    return primask;
+}
+
+static inline void tw_irq_unlock(uint32_t primask)
+{
+    __asm volatile ("msr primask, %0" : : "r" (primask) : "memory");
+}
+
+/* PRIMASK保存在调用者栈上，嵌套或并发进入临界区互不干扰 */
+#define TW_LOCK()       uint32_t tw_primask = tw_irq_lock()
+#define TW_UNLOCK()     tw_irq_unlock(tw_primask)
+#else
+/* 主机单线程环境无需加锁 */
+#define TW_LOCK()
+#define TW_UNLOCK()
+#endif
+
+/**
+ * @brief 将链表头转换为哨兵节点指针
+ */
+static timer_wheel_timer_t *tw_head(tw_list_t *list)
+{
+    return (timer_wheel_timer_t *)(void *)list;
+}
+
+/**
+ * @brief 初始化空链表
+ */
+static void tw_list_init(tw_list_t *list)
+{
+    list->next = tw_head(list);
+    list->prev = tw_head(list);
+}
+
+/**
+ * @brief 判断链表是否为空
+ */
+static bool tw_list_empty(tw_list_t *list)
+{
+    return list->next == tw_head(list);
+}
+
+/**
+ * @brief 将定时器追加到链表尾部
+ */
+static void tw_list_append(tw_list_t *list, timer_wheel_timer_t *timer)
+{
+    timer->next = tw_head(list);
+    timer->prev = list->prev;
+    list->prev->next = timer;
+    list->prev = timer;
+}
+
+/**
+ * @brief 将定时器从所在链表中摘除
+ */
+static void tw_list_remove(timer_wheel_timer_t *timer)
+{
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+    timer->next = NULL;
+    timer->prev = NULL;
+}
+
+/**
+ * @brief 毫秒转换为tick数（向上取整，至少为1）
+ */
+static uint32_t tw_ms_to_ticks(uint32_t ms)
+{
+    uint32_t ticks = (ms + g_timer_wheel.tick_ms - 1) / g_timer_wheel.tick_ms;
+
+    if (ticks == 0) {
+        ticks = 1;
+    }
+    if (ticks > TIMER_WHEEL_MAX_TICKS) {
+        ticks = TIMER_WHEEL_MAX_TICKS;
+    }
+
+    return ticks;
+}
+
+/**
+ * @brief 获取当前时间对应的tick
+ *
+ * RTOS环境下包含尚未推进的延迟tick，保证新启动的定时器不会提前到期
+ */
+static uint32_t tw_now(void)
+{
+#if TW_KERNEL_DRIVEN
+    return g_timer_wheel.current +
+           (rtos_get_time_ms() - g_timer_wheel.last_ms) / g_timer_wheel.tick_ms;
+#else
+    return g_timer_wheel.current;
+#endif
+}
+
+/**
+ * @brief 根据到期时间将定时器挂入对应层的槽位
+ */
+static void tw_enqueue(timer_wheel_timer_t *timer)
+{
+    uint32_t expires = timer->expires;
+    uint32_t delta = expires - g_timer_wheel.current;
+    uint32_t level;
+    uint32_t index;
+
+    if ((int32_t)delta <= 0) {
+        /* 已经过期（周期定时器回调滞后），挂入下一个槽位，下一次推进时立即到期 */
+        expires = g_timer_wheel.current + 1;
+        delta = 1;
+    } else if (delta > TIMER_WHEEL_MAX_TICKS) {
+        expires = g_timer_wheel.current + TIMER_WHEEL_MAX_TICKS;
+        delta = TIMER_WHEEL_MAX_TICKS;
+    }
+
+    /* 选择能够容纳该超时的最低层 */
+    for (level = 0; level < TIMER_WHEEL_LEVELS - 1; level++) {
+        if (delta < (1UL << ((level + 1) * TIMER_WHEEL_SLOT_BITS))) {
+            break;
+        }
+    }
+
+    index = (expires >> (level * TIMER_WHEEL_SLOT_BITS)) & TW_SLOT_MASK;
+    tw_list_append(&g_timer_wheel.slots[level][index], timer);
+    timer->state = TIMER_WHEEL_STATE_PENDING;
+}
+
+/**
+ * @brief 将高层槽位中的定时器重新分配到低层
+ *
+ * @param level 层号
+ * @param index 槽位索引
+ */
+static void tw_cascade(uint32_t level, uint32_t index)
+{
+    tw_list_t *slot = &g_timer_wheel.slots[level][index];
+    timer_wheel_timer_t *timer;
+
+    while (!tw_list_empty(slot)) {
+        timer = slot->next;
+        tw_list_remove(timer);
+        if (timer->expires == g_timer_wheel.current) {
+            /* 恰好在本tick到期，直接挂入本tick即将收集的第0层槽位 */
+            tw_list_append(&g_timer_wheel.slots[0][g_timer_wheel.current & TW_SLOT_MASK], timer);
+        } else {
+            tw_enqueue(timer);
+        }
+        g_timer_wheel.stats.cascades++;
+    }
+}
+
+/**
+ * @brief 推进一个tick，将到期定时器移入待回调链表
+ *
+ * @return uint32_t 本次到期的定时器数量
+ */
+static uint32_t tw_advance(void)
+{
+    uint32_t index;
+    uint32_t level;
+    uint32_t count = 0;
+    tw_list_t *slot;
+    timer_wheel_timer_t *timer;
+
+    /* 先前进再收集，超时为n个tick的定时器恰好在第n次推进时到期 */
+    g_timer_wheel.current++;
+    index = g_timer_wheel.current & TW_SLOT_MASK;
+
+    /* 第0层回绕时逐级迁移高层槽位 */
+    if (index == 0) {
+        for (level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+            uint32_t level_index = (g_timer_wheel.current >> (level * TIMER_WHEEL_SLOT_BITS)) & TW_SLOT_MASK;
+            tw_cascade(level, level_index);
+            if (level_index != 0) {
+                break;
+            }
+        }
+    }
+
+    slot = &g_timer_wheel.slots[0][index];
+    while (!tw_list_empty(slot)) {
+        timer = slot->next;
+        tw_list_remove(timer);
+        tw_list_append(&g_timer_wheel.expired, timer);
+        timer->state = TIMER_WHEEL_STATE_EXPIRED;
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief 摘除链表中的所有定时器并置为空闲状态
+ */
+static void tw_detach_all(tw_list_t *list)
+{
+    timer_wheel_timer_t *timer;
+
+    while (!tw_list_empty(list)) {
+        timer = list->next;
+        tw_list_remove(timer);
+        timer->state = TIMER_WHEEL_STATE_IDLE;
+    }
+}
+
+/**
+ * @brief 依次执行待回调链表中的定时器回调
+ *
+ * 每次只在锁内摘取一个定时器，回调在锁外执行，
+ * 因此回调中可以启动、停止或重置任意定时器
+ */
+static void tw_dispatch(void)
+{
+    timer_wheel_timer_t *timer;
+    timer_wheel_func_t callback;
+    void *arg;
+
+    for (;;) {
+        TW_LOCK();
+
+        if (tw_list_empty(&g_timer_wheel.expired)) {
+            TW_UNLOCK();
+            break;
+        }
+
+        timer = g_timer_wheel.expired.next;
+        tw_list_remove(timer);
+        callback = timer->callback;
+        arg = timer->arg;
+
+        /* 周期定时器在回调前重新挂入，以到期时间为基准避免累计漂移 */
+        if (timer->period != 0) {
+            timer->expires += timer->period;
+            tw_enqueue(timer);
+        } else {
+            timer->state = TIMER_WHEEL_STATE_IDLE;
+            g_timer_wheel.stats.active_timers--;
+        }
+
+        g_timer_wheel.stats.total_expired++;
+
+        TW_UNLOCK();
+
+        if (callback != NULL) {
+            callback(timer, arg);
+        }
+    }
+}
+
+#if TW_KERNEL_DRIVEN
+/**
+ * @brief 内核定时器回调，驱动时间轮
+ */
+static void tw_kernel_timer_callback(rtos_timer_t timer, void *arg)
+{
+    (void)timer;
+    (void)arg;
+
+    timer_wheel_process();
+}
+#endif
+
+/**
+ * @brief 初始化时间轮
+ *
+ * @param tick_ms 时间轮tick周期（毫秒），0表示使用CONFIG_TIMER_WHEEL_TICK_MS
+ * @return int 0表示成功，非0表示失败
+ */
+int timer_wheel_init(uint32_t tick_ms)
+{
+    uint32_t level;
+    uint32_t index;
+
+    if (g_timer_wheel.initialized) {
+        return TIMER_WHEEL_OK;
+    }
+
+    memset(&g_timer_wheel, 0, sizeof(g_timer_wheel));
+    g_timer_wheel.tick_ms = (tick_ms != 0) ? tick_ms : CONFIG_TIMER_WHEEL_TICK_MS;
+
+    for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (index = 0; index < TIMER_WHEEL_SLOTS; index++) {
+            tw_list_init(&g_timer_wheel.slots[level][index]);
+        }
+    }
+    tw_list_init(&g_timer_wheel.expired);
+
+#if (CURRENT_RTOS != RTOS_NONE)
+    /* 创建互斥锁 */
+    if (rtos_mutex_create(&g_timer_wheel.mutex) != 0) {
+        REPORT_ERROR(ERROR_MODULE_RTOS | ERROR_TYPE_INIT | ERROR_SEVERITY_ERROR);
+        return TIMER_WHEEL_ERROR;
+    }
+#endif
+
+#if TW_KERNEL_DRIVEN
+    g_timer_wheel.last_ms = rtos_get_time_ms();
+
+    /* 创建唯一的内核定时器 */
+    if (rtos_timer_create(&g_timer_wheel.kernel_timer, "timer_wheel", g_timer_wheel.tick_ms,
+                          true, 0, tw_kernel_timer_callback) != 0) {
+        rtos_mutex_delete(g_timer_wheel.mutex);
+        REPORT_ERROR(ERROR_MODULE_RTOS | ERROR_TYPE_RESOURCE | ERROR_SEVERITY_ERROR);
+        return TIMER_WHEEL_ERROR;
+    }
+
+    if (rtos_timer_start(g_timer_wheel.kernel_timer) != 0) {
+        rtos_timer_delete(g_timer_wheel.kernel_timer);
+        rtos_mutex_delete(g_timer_wheel.mutex);
+        REPORT_ERROR(ERROR_MODULE_RTOS | ERROR_TYPE_RESOURCE | ERROR_SEVERITY_ERROR);
+        return TIMER_WHEEL_ERROR;
+    }
+#endif
+
+    g_timer_wheel.initialized = true;
+
+    return TIMER_WHEEL_OK;
+}
+
+/**
+ * @brief 去初始化时间轮
+ *
+ * @return int 0表示成功，非0表示失败
+ */
+int timer_wheel_deinit(void)
+{
+    uint32_t level;
+    uint32_t index;
+
+    if (!g_timer_wheel.initialized) {
+        return TIMER_WHEEL_NOT_INIT;
+    }
+
+#if TW_KERNEL_DRIVEN
+    rtos_timer_stop(g_timer_wheel.kernel_timer);
+    rtos_timer_delete(g_timer_wheel.kernel_timer);
+#endif
+
+    /* 摘除所有挂起的定时器，使其回到空闲状态，之后可以重新启动 */
+    for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (index = 0; index < TIMER_WHEEL_SLOTS; index++) {
+            tw_detach_all(&g_timer_wheel.slots[level][index]);
+        }
+    }
+    tw_detach_all(&g_timer_wheel.expired);
+    g_timer_wheel.stats.active_timers = 0;
+
+#if (CURRENT_RTOS != RTOS_NONE)
+    rtos_mutex_delete(g_timer_wheel.mutex);
+#endif
+
+    g_timer_wheel.initialized = false;
+
+    return TIMER_WHEEL_OK;
+}
+
+/**
+ * @brief 初始化软件定时器对象
+ *
+ * @param timer 定时器对象
+ * @param callback 回调函数
+ * @param arg 回调参数
+ * @return int 0表示成功，非0表示失败
+ */
+int timer_wheel_timer_init(timer_wheel_timer_t *timer, timer_wheel_func_t callback, void *arg)
+{
+    if (timer == NULL || callback == NULL) {
+        return TIMER_WHEEL_INVALID_PARAM;
+    }
+
+    memset(timer, 0, sizeof(timer_wheel_timer_t));
+    timer->callback = callback;
+    timer->arg = arg;
+    timer->state = TIMER_WHEEL_STATE_IDLE;
+
+    return TIMER_WHEEL_OK;
+}
+
+/**
+ * @brief 启动软件定时器
+ *
+ * @param timer 定时器对象
+ * @param timeout_ms 首次超时时间（毫秒）
+ * @param period_ms 周期（毫秒），0表示单次定时器
+ * @return int 0表示成功，非0表示失败
+ */
+int timer_wheel_start(timer_wheel_timer_t *timer, uint32_t timeout_ms, uint32_t period_ms)
+{
+    if (timer == NULL || timer->callback == NULL) {
+        return TIMER_WHEEL_INVALID_PARAM;
+    }
+
+    if (!g_timer_wheel.initialized) {
+        return TIMER_WHEEL_NOT_INIT;
+    }
+
+    TW_LOCK();
+
+    /* 已启动的定时器先摘除 */
+    if (timer->state != TIMER_WHEEL_STATE_IDLE) {
+        tw_list_remove(timer);
+    } else {
+        g_timer_wheel.stats.active_timers++;
+    }
+
+    timer->timeout = tw_ms_to_ticks(timeout_ms);
+    timer->period = (period_ms != 0) ? tw_ms_to_ticks(period_ms) : 0;
+    timer->expires = tw_now() + timer->timeout;
+    tw_enqueue(timer);
+
+    TW_UNLOCK();
+
+    return TIMER_WHEEL_OK;
+}
+
+/**
+ * @brief 停止软件定时器
+ *
+ * @param timer 定时器对象
+ * @return int 0表示成功，非0表示失败
+ */
+int timer_wheel_stop(timer_wheel_timer_t *timer)
+{
+    if (timer == NULL) {
+        return TIMER_WHEEL_INVALID_PARAM;
+    }
+
+    if (!g_timer_wheel.initialized) {
+        return TIMER_WHEEL_NOT_INIT;
+    }
+
+    TW_LOCK();
+
+    if (timer->state != TIMER_WHEEL_STATE_IDLE) {
+        tw_list_remove(timer);
+        timer->state = TIMER_WHEEL_STATE_IDLE;
+        g_timer_wheel.stats.active_timers--;
+    }
+
+    TW_UNLOCK();
+
+    return TIMER_WHEEL_OK;
+}
+
+/**
+ * @brief 重置软件定时器
+ *
+ * @param timer 定时器对象
+ * @return int 0表示成功，非0表示失败
+ */
+int timer_wheel_reset(timer_wheel_timer_t *timer)
+{
+    if (timer == NULL || timer->timeout == 0) {
+        return TIMER_WHEEL_INVALID_PARAM;
+    }
+
+    if (!g_timer_wheel.initialized) {
+        return TIMER_WHEEL_NOT_INIT;
+    }
+
+    TW_LOCK();
+
+    if (timer->state != TIMER_WHEEL_STATE_IDLE) {
+        tw_list_remove(timer);
+    } else {
+        g_timer_wheel.stats.active_timers++;
+    }
+
+    timer->expires = tw_now() + timer->timeout;
+    tw_enqueue(timer);
+
+    TW_UNLOCK();
+
+    return TIMER_WHEEL_OK;
+}
+
+/**
+ * @brief 查询软件定时器是否处于运行状态
+ *
+ * @param timer 定时器对象
+ * @return bool true表示已启动且尚未到期
+ */
+bool timer_wheel_is_active(const timer_wheel_timer_t *timer)
+{
+    return (timer != NULL && timer->state == TIMER_WHEEL_STATE_PENDING);
+}
+
+/**
+ * @brief 推进时间轮并批量执行到期回调
+ */
+void timer_wheel_process(void)
+{
+    uint32_t batch = 0;
+
+    if (!g_timer_wheel.initialized) {
+        return;
+    }
+
+    TW_LOCK();
+
+#if TW_KERNEL_DRIVEN
+    {
+        /* 按系统时间补齐内核定时器延迟期间错过的tick */
+        uint32_t elapsed = rtos_get_time_ms() - g_timer_wheel.last_ms;
+        uint32_t ticks = elapsed / g_timer_wheel.tick_ms;
+
+        g_timer_wheel.last_ms += ticks * g_timer_wheel.tick_ms;
+        while (ticks-- > 0) {
+            batch += tw_advance();
+        }
+    }
+#else
+    batch = tw_advance();
+#endif
+
+    if (batch > g_timer_wheel.stats.max_batch) {
+        g_timer_wheel.stats.max_batch = batch;
+    }
+
+    TW_UNLOCK();
+
+    if (batch > 0) {
+        tw_dispatch();
+    }
+}
+
+/**
+ * @brief 获取时间轮统计信息
+ *
+ * @param stats 统计信息输出
+ * @return int 0表示成功，非0表示失败
+ */
+int timer_wheel_get_stats(timer_wheel_stats_t *stats)
+{
+    if (stats == NULL) {
+        return TIMER_WHEEL_INVALID_PARAM;
+    }
+
+    if (!g_timer_wheel.initialized) {
+        return TIMER_WHEEL_NOT_INIT;
+    }
+
+    TW_LOCK();
+    memcpy(stats, &g_timer_wheel.stats, sizeof(timer_wheel_stats_t));
+    TW_UNLOCK();
+
+    return TIMER_WHEEL_OK;
+}
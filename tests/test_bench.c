@@ -0,0 +1,215 @@
+/**
+ * @file test_bench.c
+ * @brief 性能基准测试
+ *
+ * 该文件使用UT_BENCH测量核心模块热点路径的耗时，结果由test_main输出为JSON
+ */
+
+#include "unit_test.h"
+#include "memory_manager.h"
+#include "dsp_block.h"
+#include "base/uart_tx_coalesce_api.h"
+#include <string.h>
+
+/* 基准测试缓冲区，使用全局变量防止拷贝被编译器优化掉 */
+static uint8_t bench_src[4096];
+static uint8_t bench_dst[4096];
+
+#ifdef CONFIG_DSP_BLOCK_ENABLED
+/* DSP基准样本块 */
+#define BENCH_DSP_BLOCK     256
+static int16_t bench_dsp_in[BENCH_DSP_BLOCK];
+static int16_t bench_dsp_out[BENCH_DSP_BLOCK];
+#endif
+
+/* 基准测试内存池 */
+static mem_pool_handle_t bench_pool = NULL;
+
+/* 发送合并基准使用的合并器，发送的数据复制到捕获缓冲区后立即完成 */
+#define BENCH_FRAME_SIZE    16
+static uart_tx_coalesce_t bench_tx;
+static uint8_t bench_capture[4096];
+static uint32_t bench_captured = 0;
+
+/**
+ * @brief 内存拷贝基准，作为其他测试的参照
+ */
+static void bench_memcpy(void)
+{
+    UT_BENCH_BYTES("memcpy_64", 64, 64) {
+        memcpy(bench_dst, bench_src, 64);
+    }
+    
+    UT_BENCH_BYTES("memcpy_4096", 64, sizeof(bench_dst)) {
+        memcpy(bench_dst, bench_src, sizeof(bench_dst));
+    }
+}
+
+/**
+ * @brief 系统内存分配与释放基准
+ */
+static void bench_mem_alloc(void)
+{
+    UT_BENCH("mem_alloc_free_64", 64) {
+        void *ptr = mem_alloc(64);
+        mem_free(ptr);
+    }
+}
+
+/**
+ * @brief 内存池分配与释放基准
+ */
+static void bench_mem_pool_alloc(void)
+{
+    UT_ASSERT_NOT_NULL(bench_pool);
+    if (bench_pool == NULL) {
+        return;
+    }
+    
+    UT_BENCH("mem_pool_alloc_free_64", 64) {
+        void *ptr = mem_pool_alloc(bench_pool, 64);
+        mem_pool_free(bench_pool, ptr);
+    }
+}
+
+/* 发送合并基准的发送操作：复制到捕获缓冲区后立即完成 */
+static int bench_tx_start(void *ctx, const uint8_t *data, uint32_t len)
+{
+    if (len > sizeof(bench_capture)) {
+        len = sizeof(bench_capture);
+    }
+    memcpy(bench_capture, data, len);
+    bench_captured += len;
+
+    uart_tx_coalesce_complete((uart_tx_coalesce_t *)ctx);
+    return 0;
+}
+
+static uint32_t bench_tx_lock(void *ctx)
+{
+    (void)ctx;
+    return 0;
+}
+
+static void bench_tx_unlock(void *ctx, uint32_t key)
+{
+    (void)ctx;
+    (void)key;
+}
+
+static uint32_t bench_tx_now_ms(void)
+{
+    return 0;
+}
+
+static const uart_tx_coalesce_ops_t bench_tx_ops = {
+    bench_tx_start,
+    bench_tx_lock,
+    bench_tx_unlock,
+    bench_tx_now_ms
+};
+
+/**
+ * @brief 发送合并基准
+ *
+ * 通过uart_tx_coalesce_write提交16字节的小帧，发送操作把数据复制到捕获缓冲区，
+ * 测量小帧进入合并缓冲区并被发送出去的单帧开销
+ */
+static void bench_tx_coalesce(void)
+{
+    int ret = 0;
+
+    UT_ASSERT_EQUAL_INT(UART_TX_COALESCE_OK, uart_tx_coalesce_init(&bench_tx, &bench_tx_ops, &bench_tx));
+    bench_captured = 0;
+
+    UT_BENCH_BYTES("uart_tx_coalesce_write_16", 64, BENCH_FRAME_SIZE) {
+        ret = uart_tx_coalesce_write(&bench_tx, bench_src, BENCH_FRAME_SIZE);
+    }
+    UT_ASSERT_EQUAL_INT(BENCH_FRAME_SIZE, ret);
+
+    UT_ASSERT_EQUAL_INT(UART_TX_COALESCE_OK, uart_tx_coalesce_flush(&bench_tx));
+    UT_ASSERT(bench_captured > 0);
+
+    uart_tx_coalesce_deinit(&bench_tx);
+}
+
+#ifdef CONFIG_DSP_BLOCK_ENABLED
+/**
+ * @brief DSP逐样本与按块处理基准
+ *
+ * 两种方式处理同样多的样本，差值即逐样本调用的开销
+ */
+static void bench_dsp_block(void)
+{
+    /* 二阶巴特沃斯低通，截止频率为采样率的1/10，post_shift为1 */
+    static const int16_t coeffs[5] = {1105, 2210, 1105, -18727, 6763};
+    dsp_biquad_t biquad;
+    dsp_moving_average_t average;
+    uint32_t i;
+
+    for (i = 0; i < BENCH_DSP_BLOCK; i++) {
+        bench_dsp_in[i] = (int16_t)((i * 37) & 0x0FFF);
+    }
+
+    UT_ASSERT_EQUAL_INT(DSP_OK, dsp_biquad_init(&biquad, coeffs, 1, 1));
+    UT_ASSERT_EQUAL_INT(DSP_OK, dsp_moving_average_init(&average, 16));
+
+    UT_BENCH_BYTES("dsp_biquad_per_sample_256", 64, sizeof(bench_dsp_in)) {
+        for (i = 0; i < BENCH_DSP_BLOCK; i++) {
+            dsp_biquad_process(&biquad, &bench_dsp_in[i], &bench_dsp_out[i], 1);
+        }
+    }
+
+    UT_BENCH_BYTES("dsp_biquad_block_256", 64, sizeof(bench_dsp_in)) {
+        dsp_biquad_process(&biquad, bench_dsp_in, bench_dsp_out, BENCH_DSP_BLOCK);
+    }
+
+    UT_BENCH_BYTES("dsp_average_per_sample_256", 64, sizeof(bench_dsp_in)) {
+        for (i = 0; i < BENCH_DSP_BLOCK; i++) {
+            dsp_moving_average_process(&average, &bench_dsp_in[i], &bench_dsp_out[i], 1);
+        }
+    }
+
+    UT_BENCH_BYTES("dsp_average_block_256", 64, sizeof(bench_dsp_in)) {
+        dsp_moving_average_process(&average, bench_dsp_in, bench_dsp_out, BENCH_DSP_BLOCK);
+    }
+}
+#endif
+
+/* 基准测试套件初始化 */
+static void bench_test_setup(void)
+{
+    mem_init();
+    mem_pool_create(8192, &bench_pool);
+}
+
+/* 基准测试套件清理 */
+static void bench_test_teardown(void)
+{
+    if (bench_pool != NULL) {
+        mem_pool_destroy(bench_pool);
+        bench_pool = NULL;
+    }
+}
+
+/* 基准测试案例 */
+static ut_test_case_t bench_test_cases[] = {
+    {"内存拷贝基准", bench_memcpy},
+    {"系统内存分配基准", bench_mem_alloc},
+    {"内存池分配基准", bench_mem_pool_alloc},
+    {"发送合并基准", bench_tx_coalesce},
+#ifdef CONFIG_DSP_BLOCK_ENABLED
+    {"DSP块处理基准", bench_dsp_block},
+#endif
+};
+
+/* 基准测试套件 */
+ut_test_suite_t bench_test_suite = {
+    "性能基准测试套件",
+    bench_test_cases,
+    sizeof(bench_test_cases) / sizeof(bench_test_cases[0]),
+    bench_test_setup,
+    bench_test_teardown,
+    NULL,
+    NULL
+};
@@ -0,0 +1,425 @@
+/**
+ * @file test_block_cache.c
+ * @brief 块设备扇区缓存单元测试
+ *
+ * 该文件以内存模拟块设备，测试缓存的LRU淘汰、脏块合并写回、顺序读取预读、
+ * 大块读写绕过缓存时与脏块的一致性，以及冲刷与卸载
+ */
+
+#include "unit_test.h"
+#include "base/block_cache_api.h"
+#include <string.h>
+
+#define TEST_BLOCK_SIZE         16
+#define TEST_BLOCK_COUNT        64
+#define TEST_ENTRY_COUNT        8
+
+/* 每个缓存项占用块数据、缓存项和两个哈希桶 */
+#define TEST_ENTRY_COST         (TEST_BLOCK_SIZE + sizeof(block_cache_entry_t) + 2 * sizeof(uint16_t))
+#define TEST_MEMORY_SIZE(batch) ((batch) * TEST_BLOCK_SIZE + TEST_ENTRY_COUNT * TEST_ENTRY_COST)
+
+/* 模拟块设备 */
+typedef struct {
+    uint8_t data[TEST_BLOCK_COUNT][TEST_BLOCK_SIZE];
+    uint32_t reads;
+    uint32_t writes;
+    uint32_t syncs;
+    uint32_t last_block;
+    uint32_t last_count;
+    bool fail_write;
+} test_device_t;
+
+static test_device_t device;
+static block_cache_t cache;
+static uint32_t cache_memory[(TEST_MEMORY_SIZE(8) + 3) / 4];
+
+static int test_device_read(void *context, uint32_t block, void *buffer, uint32_t count)
+{
+    test_device_t *dev = (test_device_t *)context;
+
+    dev->reads++;
+    dev->last_block = block;
+    dev->last_count = count;
+    memcpy(buffer, dev->data[block], count * TEST_BLOCK_SIZE);
+    return 0;
+}
+
+static int test_device_write(void *context, uint32_t block, const void *buffer, uint32_t count)
+{
+    test_device_t *dev = (test_device_t *)context;
+
+    if (dev->fail_write) {
+        return -1;
+    }
+
+    dev->writes++;
+    dev->last_block = block;
+    dev->last_count = count;
+    memcpy(dev->data[block], buffer, count * TEST_BLOCK_SIZE);
+    return 0;
+}
+
+static int test_device_sync(void *context)
+{
+    ((test_device_t *)context)->syncs++;
+    return 0;
+}
+
+/* 以块号和代次填充块内容 */
+static void fill_block(uint8_t *buffer, uint32_t block, uint8_t generation)
+{
+    for (uint32_t i = 0; i < TEST_BLOCK_SIZE; i++) {
+        buffer[i] = (uint8_t)(block * 7 + i + generation * 0x40);
+    }
+}
+
+static bool check_block(const uint8_t *buffer, uint32_t block, uint8_t generation)
+{
+    uint8_t expect[TEST_BLOCK_SIZE];
+
+    fill_block(expect, block, generation);
+    return memcmp(buffer, expect, TEST_BLOCK_SIZE) == 0;
+}
+
+/* 设备内容复位为第0代，按配置初始化缓存 */
+static int setup_cache(uint16_t batch_blocks, uint16_t bypass_blocks)
+{
+    block_cache_config_t config;
+
+    memset(&device, 0, sizeof(device));
+    for (uint32_t i = 0; i < TEST_BLOCK_COUNT; i++) {
+        fill_block(device.data[i], i, 0);
+    }
+
+    memset(&config, 0, sizeof(config));
+    config.device.read = test_device_read;
+    config.device.write = test_device_write;
+    config.device.sync = test_device_sync;
+    config.device.context = &device;
+    config.device.block_size = TEST_BLOCK_SIZE;
+    config.device.block_count = TEST_BLOCK_COUNT;
+    config.memory = cache_memory;
+    config.memory_size = TEST_MEMORY_SIZE(batch_blocks);
+    config.batch_blocks = batch_blocks;
+    config.bypass_blocks = bypass_blocks;
+
+    return block_cache_init(&cache, &config);
+}
+
+/* 测试初始化参数检查与内存划分 */
+static void test_block_cache_init(void)
+{
+    block_cache_config_t config;
+    uint8_t buffer[TEST_BLOCK_SIZE];
+
+    UT_ASSERT_EQUAL_INT(BLOCK_CACHE_OK, setup_cache(4, 0));
+    UT_ASSERT_EQUAL_INT(TEST_ENTRY_COUNT, cache.entry_count);
+    UT_ASSERT_EQUAL_INT(TEST_ENTRY_COUNT / 2, cache.bypass_blocks);
+    UT_ASSERT_EQUAL_INT(BLOCK_CACHE_OK, block_cache_deinit(&cache));
+
+    config = cache.config;
+    UT_ASSERT_EQUAL_INT(BLOCK_CACHE_INVALID_PARAM, block_cache_init(NULL, &config));
+
+    config.memory = (uint8_t *)cache_memory + 2;
+    UT_ASSERT_EQUAL_INT(BLOCK_CACHE_INVALID_PARAM, block_cache_init(&cache, &config));
+
+    config = cache.config;
+    config.device.block_size = 6;
+    UT_ASSERT_EQUAL_INT(BLOCK_CACHE_INVALID_PARAM, block_cache_init(&cache, &config));
+
+    /* 不足两个缓存块 */
+    config = cache.config;
+    config.memory_size = 4 * TEST_BLOCK_SIZE + TEST_ENTRY_COST;
+    UT_ASSERT_EQUAL_INT(BLOCK_CACHE_NO_MEMORY, block_cache_init(&cache, &config));
+
+    /* 只读设备拒绝写入 */
+    config = cache.config;
+    config.device.write = NULL;
+    UT_ASSERT_EQUAL_INT(BLOCK_CACHE_OK, block_cache_init(&cache, &config));
+    UT_ASSERT_EQUAL_INT(BLOCK_CACHE_READ_ONLY, block_cache_write(&cache, 0, buffer, 1));
+    UT_ASSERT_EQUAL_INT(BLOCK_CACHE_INVALID_PARAM, block_cache_read(&cache, TEST_BLOCK_COUNT - 1, buffer, 2));
+    block_cache_deinit(&cache);
+}
+
+/* 测试LRU淘汰最久未使用的块，淘汰脏块时先写回 */
+static void test_block_cache_lru(void)
+{
+    uint8_t buffer[TEST_BLOCK_SIZE];
+    block_cache_stats_t stats;
+    uint32_t reads;
+
+    /* 关闭预读，每次未命中恰好读一块 */
+    setup_cache(0, 0);
+
+    for (uint32_t i = 0; i < TEST_ENTRY_COUNT; i++) {
+        UT_ASSERT_EQUAL_INT(BLOCK_CACHE_OK, block_cache_read(&cache, i, buffer, 1));
+        UT_ASSERT(check_block(buffer, i, 0));
+    }
+    UT_ASSERT_EQUAL_INT(TEST_ENTRY_COUNT, device.reads);
+
+    /* 访问块0后，最久未使用的是块1 */
+    block_cache_read(&cache, 0, buffer, 1);
+    UT_ASSERT_EQUAL_INT(TEST_ENTRY_COUNT, device.reads);
+    block_cache_read(&cache, 8, buffer, 1);
+    UT_ASSERT_EQUAL_INT(TEST_ENTRY_COUNT + 1, device.reads);
+
+    reads = device.reads;
+    block_cache_read(&cache, 0, buffer, 1);
+    UT_ASSERT_EQUAL_INT(reads, device.reads);
+    block_cache_read(&cache, 1, buffer, 1);
+    UT_ASSERT_EQUAL_INT(reads + 1, device.reads);
+    UT_ASSERT(check_block(buffer, 1, 0));
+
+    block_cache_get_stats(&cache, &stats);
+    UT_ASSERT_EQUAL_INT(2, stats.hits);
+    UT_ASSERT_EQUAL_INT(TEST_ENTRY_COUNT + 2, stats.misses);
+    UT_ASSERT_EQUAL_INT(2, stats.evictions);
+
+    /* 写入的脏块在被淘汰前不访问设备 */
+    fill_block(buffer, 40, 1);
+    block_cache_write(&cache, 40, buffer, 1);
+    UT_ASSERT_EQUAL_INT(0, device.writes);
+
+    for (uint32_t i = 0; i < TEST_ENTRY_COUNT; i++) {
+        block_cache_read(&cache, 50 + i, buffer, 1);
+    }
+    UT_ASSERT_EQUAL_INT(1, device.writes);
+    UT_ASSERT(check_block(device.data[40], 40, 1));
+
+    /* 被淘汰后重新从设备读取到的是写回的内容 */
+    reads = device.reads;
+    block_cache_read(&cache, 40, buffer, 1);
+    UT_ASSERT_EQUAL_INT(reads + 1, device.reads);
+    UT_ASSERT(check_block(buffer, 40, 1));
+
+    block_cache_deinit(&cache);
+}
+
+/* 测试连续脏块合并为一次多块写入 */
+static void test_block_cache_writeback_merge(void)
+{
+    static const uint32_t order[] = {12, 10, 20, 15, 11, 14, 13};
+    uint8_t buffer[TEST_BLOCK_SIZE];
+    block_cache_stats_t stats;
+
+    setup_cache(4, 0);
+
+    /* 乱序写入块10~15与块20 */
+    for (uint32_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+        fill_block(buffer, order[i], 1);
+        UT_ASSERT_EQUAL_INT(BLOCK_CACHE_OK, block_cache_write(&cache, order[i], buffer, 1));
+    }
+    UT_ASSERT_EQUAL_INT(0, device.writes);
+    UT_ASSERT_EQUAL_INT(7, cache.dirty_count);
+
+    /* 读回命中缓存中的新数据 */
+    block_cache_read(&cache, 13, buffer, 1);
+    UT_ASSERT(check_block(buffer, 13, 1));
+    UT_ASSERT_EQUAL_INT(0, device.reads);
+
+    /* 块10~15按合并上限拆为4块与2块，块20单独写入 */
+    UT_ASSERT_EQUAL_INT(BLOCK_CACHE_OK, block_cache_flush(&cache));
+    UT_ASSERT_EQUAL_INT(3, device.writes);
+    UT_ASSERT_EQUAL_INT(0, cache.dirty_count);
+    for (uint32_t i = 10; i <= 15; i++) {
+        UT_ASSERT(check_block(device.data[i], i, 1));
+    }
+    UT_ASSERT(check_block(device.data[20], 20, 1));
+    UT_ASSERT(check_block(device.data[16], 16, 0));
+
+    block_cache_get_stats(&cache, &stats);
+    UT_ASSERT_EQUAL_INT(7, stats.writebacks);
+    UT_ASSERT_EQUAL_INT(3, stats.device_writes);
+
+    /* 关闭合并时逐块写回 */
+    block_cache_deinit(&cache);
+    setup_cache(0, 0);
+    for (uint32_t i = 10; i < 13; i++) {
+        fill_block(buffer, i, 2);
+        block_cache_write(&cache, i, buffer, 1);
+    }
+    block_cache_flush(&cache);
+    UT_ASSERT_EQUAL_INT(3, device.writes);
+    block_cache_deinit(&cache);
+}
+
+/* 测试顺序读取时预读窗口逐次加倍 */
+static void test_block_cache_readahead(void)
+{
+    uint8_t buffer[TEST_BLOCK_SIZE];
+    block_cache_stats_t stats;
+
+    setup_cache(4, 0);
+
+    /* 首次读取不预读 */
+    block_cache_read(&cache, 30, buffer, 1);
+    UT_ASSERT_EQUAL_INT(1, device.reads);
+    UT_ASSERT_EQUAL_INT(1, device.last_count);
+
+    /* 紧接上次读取，未命中块与1块预读一次读出 */
+    block_cache_read(&cache, 31, buffer, 1);
+    UT_ASSERT(check_block(buffer, 31, 0));
+    UT_ASSERT_EQUAL_INT(2, device.reads);
+    UT_ASSERT_EQUAL_INT(31, device.last_block);
+    UT_ASSERT_EQUAL_INT(2, device.last_count);
+
+    /* 预读的块命中 */
+    block_cache_read(&cache, 32, buffer, 1);
+    UT_ASSERT(check_block(buffer, 32, 0));
+    UT_ASSERT_EQUAL_INT(2, device.reads);
+
+    /* 窗口加倍到合并上限，超出暂存区时分两次读取 */
+    block_cache_read(&cache, 33, buffer, 1);
+    UT_ASSERT(check_block(buffer, 33, 0));
+    UT_ASSERT_EQUAL_INT(4, device.reads);
+    UT_ASSERT_EQUAL_INT(34, device.last_block);
+    UT_ASSERT_EQUAL_INT(4, device.last_count);
+
+    for (uint32_t i = 34; i < 38; i++) {
+        block_cache_read(&cache, i, buffer, 1);
+        UT_ASSERT(check_block(buffer, i, 0));
+    }
+    UT_ASSERT_EQUAL_INT(4, device.reads);
+
+    block_cache_get_stats(&cache, &stats);
+    UT_ASSERT_EQUAL_INT(5, stats.readahead_blocks);
+    UT_ASSERT_EQUAL_INT(5, stats.readahead_hits);
+
+    /* 随机读取打断顺序检测 */
+    block_cache_read(&cache, 3, buffer, 1);
+    block_cache_read(&cache, 60, buffer, 1);
+    UT_ASSERT_EQUAL_INT(6, device.reads);
+    UT_ASSERT_EQUAL_INT(1, device.last_count);
+
+    /* 预读不越过设备末尾 */
+    block_cache_read(&cache, 61, buffer, 1);
+    block_cache_read(&cache, 62, buffer, 1);
+    block_cache_read(&cache, 63, buffer, 1);
+    UT_ASSERT(check_block(buffer, 63, 0));
+    UT_ASSERT_EQUAL_INT(63, device.last_block);
+    UT_ASSERT_EQUAL_INT(1, device.last_count);
+    block_cache_get_stats(&cache, &stats);
+    UT_ASSERT_EQUAL_INT(6, stats.readahead_blocks);
+
+    block_cache_deinit(&cache);
+}
+
+/* 测试大块读写绕过缓存，与缓存中的脏块保持一致 */
+static void test_block_cache_bypass(void)
+{
+    uint8_t buffer[4 * TEST_BLOCK_SIZE];
+    block_cache_stats_t stats;
+
+    setup_cache(0, 4);
+
+    /* 块5的新数据只在缓存中 */
+    fill_block(buffer, 5, 1);
+    block_cache_write(&cache, 5, buffer, 1);
+
+    /* 绕过读取一次读设备，脏块覆盖设备上的旧数据 */
+    UT_ASSERT_EQUAL_INT(BLOCK_CACHE_OK, block_cache_read(&cache, 4, buffer, 4));
+    UT_ASSERT_EQUAL_INT(1, device.reads);
+    UT_ASSERT_EQUAL_INT(4, device.last_count);
+    UT_ASSERT(check_block(buffer, 4, 0));
+    UT_ASSERT(check_block(buffer + TEST_BLOCK_SIZE, 5, 1));
+    UT_ASSERT(check_block(buffer + 2 * TEST_BLOCK_SIZE, 6, 0));
+    UT_ASSERT(check_block(device.data[5], 5, 0));
+
+    /* 绕过读取不把块放入缓存 */
+    block_cache_read(&cache, 6, buffer, 1);
+    UT_ASSERT_EQUAL_INT(2, device.reads);
+
+    /* 绕过写入直接写设备，已缓存的副本更新并变为干净块 */
+    for (uint32_t i = 0; i < 4; i++) {
+        fill_block(buffer + i * TEST_BLOCK_SIZE, 4 + i, 2);
+    }
+    UT_ASSERT_EQUAL_INT(BLOCK_CACHE_OK, block_cache_write(&cache, 4, buffer, 4));
+    UT_ASSERT_EQUAL_INT(1, device.writes);
+    UT_ASSERT_EQUAL_INT(0, cache.dirty_count);
+    UT_ASSERT(check_block(device.data[5], 5, 2));
+
+    block_cache_read(&cache, 5, buffer, 1);
+    UT_ASSERT(check_block(buffer, 5, 2));
+    block_cache_read(&cache, 6, buffer, 1);
+    UT_ASSERT(check_block(buffer, 6, 2));
+    UT_ASSERT_EQUAL_INT(2, device.reads);
+
+    /* 冲刷时不再写回旧的脏数据 */
+    block_cache_flush(&cache);
+    UT_ASSERT_EQUAL_INT(1, device.writes);
+    UT_ASSERT(check_block(device.data[5], 5, 2));
+
+    block_cache_get_stats(&cache, &stats);
+    UT_ASSERT_EQUAL_INT(8, stats.bypass_blocks);
+
+    block_cache_deinit(&cache);
+}
+
+/* 测试冲刷、写回失败保留脏块、卸载写回以及丢弃缓存 */
+static void test_block_cache_flush(void)
+{
+    uint8_t buffer[TEST_BLOCK_SIZE];
+
+    setup_cache(4, 0);
+
+    /* 没有脏块时只落盘 */
+    UT_ASSERT_EQUAL_INT(BLOCK_CACHE_OK, block_cache_flush(&cache));
+    UT_ASSERT_EQUAL_INT(0, device.writes);
+    UT_ASSERT_EQUAL_INT(1, device.syncs);
+
+    fill_block(buffer, 7, 1);
+    block_cache_write(&cache, 7, buffer, 1);
+
+    /* 写回失败时块仍为脏块，设备恢复后可再次冲刷 */
+    device.fail_write = true;
+    UT_ASSERT_EQUAL_INT(BLOCK_CACHE_IO_ERROR, block_cache_flush(&cache));
+    UT_ASSERT_EQUAL_INT(1, cache.dirty_count);
+    UT_ASSERT_EQUAL_INT(1, device.syncs);
+
+    device.fail_write = false;
+    UT_ASSERT_EQUAL_INT(BLOCK_CACHE_OK, block_cache_flush(&cache));
+    UT_ASSERT_EQUAL_INT(0, cache.dirty_count);
+    UT_ASSERT_EQUAL_INT(2, device.syncs);
+    UT_ASSERT(check_block(device.data[7], 7, 1));
+
+    /* 卸载时写回剩余脏块 */
+    fill_block(buffer, 8, 1);
+    block_cache_write(&cache, 8, buffer, 1);
+    UT_ASSERT_EQUAL_INT(BLOCK_CACHE_OK, block_cache_deinit(&cache));
+    UT_ASSERT(check_block(device.data[8], 8, 1));
+    UT_ASSERT_EQUAL_INT(BLOCK_CACHE_INVALID_PARAM, block_cache_flush(&cache));
+
+    /* 丢弃缓存后未写回的数据丢失，重新从设备读取 */
+    setup_cache(4, 0);
+    fill_block(buffer, 9, 1);
+    block_cache_write(&cache, 9, buffer, 1);
+    UT_ASSERT_EQUAL_INT(BLOCK_CACHE_OK, block_cache_invalidate(&cache));
+    block_cache_read(&cache, 9, buffer, 1);
+    UT_ASSERT(check_block(buffer, 9, 0));
+    UT_ASSERT_EQUAL_INT(1, device.reads);
+    block_cache_flush(&cache);
+    UT_ASSERT_EQUAL_INT(0, device.writes);
+
+    block_cache_deinit(&cache);
+}
+
+/* 块缓存测试案例 */
+static ut_test_case_t block_cache_test_cases[] = {
+    {"初始化测试", test_block_cache_init},
+    {"LRU淘汰测试", test_block_cache_lru},
+    {"写回合并测试", test_block_cache_writeback_merge},
+    {"顺序预读测试", test_block_cache_readahead},
+    {"绕过缓存测试", test_block_cache_bypass},
+    {"冲刷测试", test_block_cache_flush}
+};
+
+/* 块缓存测试套件 */
+ut_test_suite_t block_cache_test_suite = {
+    "块缓存测试套件",
+    block_cache_test_cases,
+    sizeof(block_cache_test_cases) / sizeof(block_cache_test_cases[0]),
+    NULL,
+    NULL,
+    NULL,
+    NULL
+};
@@ -0,0 +1,335 @@
+/**
+ * @file test_dsp_block.c
+ * @brief 块处理数字信号处理单元测试
+ *
+ * 该文件把滑动平均、中值、双二阶级联和抽取的输出与逐点计算的参考实现
+ * 比较，并验证任意分块处理与逐样本处理的输出和滤波器状态完全一致
+ */
+
+#include "unit_test.h"
+#include "dsp_block.h"
+#include <string.h>
+
+#ifdef CONFIG_DSP_BLOCK_ENABLED
+
+/* 测试信号长度 */
+#define DSP_TEST_SAMPLES    512
+
+/* 二阶巴特沃斯低通，截止频率为采样率的1/10，post_shift为1 */
+static const int16_t dsp_test_lowpass[5] = {1105, 2210, 1105, -18727, 6763};
+
+/* 两级级联：上述低通后接截止频率为采样率1/4的低通 */
+static const int16_t dsp_test_cascade[10] = {
+    1105, 2210, 1105, -18727, 6763,
+    4798, 9597, 4798, 0, 2809
+};
+
+/* 逐块处理时依次使用的块长度，包含1和跨越多个窗口的长度 */
+static const uint32_t dsp_test_chunks[] = {1, 7, 3, 64, 2, 31, 1, 100};
+
+static int16_t dsp_in[DSP_TEST_SAMPLES];
+static int16_t dsp_out[DSP_TEST_SAMPLES];
+static int16_t dsp_ref[DSP_TEST_SAMPLES];
+
+/* 生成带噪声、尖峰和满幅值的测试信号 */
+static void dsp_make_signal(void)
+{
+    uint32_t seed = 12345;
+
+    for (uint32_t i = 0; i < DSP_TEST_SAMPLES; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int32_t noise = (int32_t)((seed >> 16) & 0x3FF) - 512;
+        int32_t value = ((i / 32) & 1) ? 12000 : -12000;
+
+        value += noise;
+        if (i % 53 == 0) {
+            value = (i & 1) ? INT16_MAX : INT16_MIN;
+        }
+        /* 重复值检验中值窗口移除最旧样本 */
+        if (i % 17 == 0 && i > 0) {
+            value = dsp_in[i - 1];
+        }
+        dsp_in[i] = (int16_t)value;
+    }
+}
+
+/* 第index块的长度，按dsp_test_chunks循环取值，不超过剩余样本数 */
+static uint32_t dsp_chunk_length(uint32_t index, uint32_t offset)
+{
+    uint32_t length = dsp_test_chunks[index % (sizeof(dsp_test_chunks) / sizeof(dsp_test_chunks[0]))];
+
+    return (length < DSP_TEST_SAMPLES - offset) ? length : DSP_TEST_SAMPLES - offset;
+}
+
+/* 参考实现：饱和到16位 */
+static int16_t ref_sat16(int64_t value)
+{
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)value;
+}
+
+/* 参考实现：直接按差分方程逐级计算双二阶级联 */
+static void ref_biquad(const int16_t *coeffs, uint8_t stages, int8_t post_shift,
+                       const int16_t *in, int16_t *out, uint32_t count)
+{
+    memcpy(out, in, count * sizeof(int16_t));
+
+    for (uint8_t s = 0; s < stages; s++) {
+        const int16_t *c = &coeffs[s * 5];
+        int64_t x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+
+        for (uint32_t i = 0; i < count; i++) {
+            int64_t x0 = out[i];
+            int64_t acc = c[0] * x0 + c[1] * x1 + c[2] * x2 - c[3] * y1 - c[4] * y2;
+            int16_t y0 = ref_sat16(acc >> (15 - post_shift));
+
+            x2 = x1;
+            x1 = x0;
+            y2 = y1;
+            y1 = y0;
+            out[i] = y0;
+        }
+    }
+}
+
+/* 测试初始化参数检查 */
+static void test_dsp_init(void)
+{
+    dsp_moving_average_t average;
+    dsp_median_t median;
+    dsp_biquad_t biquad;
+    dsp_decimator_t decimator;
+
+    UT_ASSERT_EQUAL_INT(DSP_INVALID_PARAM, dsp_moving_average_init(&average, 0));
+    UT_ASSERT_EQUAL_INT(DSP_INVALID_PARAM,
+                        dsp_moving_average_init(&average, CONFIG_DSP_MOVING_AVERAGE_MAX_WINDOW + 1));
+    UT_ASSERT_EQUAL_INT(DSP_INVALID_PARAM, dsp_median_init(&median, 0));
+    UT_ASSERT_EQUAL_INT(DSP_INVALID_PARAM, dsp_median_init(&median, CONFIG_DSP_MEDIAN_MAX_WINDOW + 1));
+    UT_ASSERT_EQUAL_INT(DSP_INVALID_PARAM, dsp_biquad_init(&biquad, dsp_test_lowpass, 0, 1));
+    UT_ASSERT_EQUAL_INT(DSP_INVALID_PARAM,
+                        dsp_biquad_init(&biquad, dsp_test_lowpass, CONFIG_DSP_BIQUAD_MAX_STAGES + 1, 1));
+    UT_ASSERT_EQUAL_INT(DSP_INVALID_PARAM, dsp_biquad_init(&biquad, dsp_test_lowpass, 1, 16));
+    UT_ASSERT_EQUAL_INT(DSP_INVALID_PARAM, dsp_decimator_init(&decimator, 0));
+
+    UT_ASSERT_EQUAL_INT(DSP_OK, dsp_moving_average_init(&average, CONFIG_DSP_MOVING_AVERAGE_MAX_WINDOW));
+    UT_ASSERT_EQUAL_INT(DSP_OK, dsp_median_init(&median, CONFIG_DSP_MEDIAN_MAX_WINDOW));
+    UT_ASSERT_EQUAL_INT(DSP_OK, dsp_biquad_init(&biquad, dsp_test_lowpass, 1, 1));
+    UT_ASSERT_EQUAL_INT(DSP_OK, dsp_decimator_init(&decimator, 4));
+}
+
+/* 测试滑动平均与逐点求平均的参考结果一致 */
+static void test_dsp_moving_average(void)
+{
+    dsp_moving_average_t average;
+    const uint16_t window = 16;
+
+    dsp_make_signal();
+    for (uint32_t i = 0; i < DSP_TEST_SAMPLES; i++) {
+        uint32_t n = (i + 1 < window) ? i + 1 : window;
+        int32_t sum = 0;
+
+        for (uint32_t j = 0; j < n; j++) {
+            sum += dsp_in[i - j];
+        }
+        dsp_ref[i] = (int16_t)(sum / (int32_t)n);
+    }
+
+    dsp_moving_average_init(&average, window);
+    dsp_moving_average_process(&average, dsp_in, dsp_out, DSP_TEST_SAMPLES);
+    UT_ASSERT(memcmp(dsp_out, dsp_ref, sizeof(dsp_out)) == 0);
+}
+
+/* 测试中值滤波与排序窗口的参考结果一致，包括偶数窗口和窗口未填满阶段 */
+static void test_dsp_median(void)
+{
+    static const uint8_t windows[] = {1, 4, 5, CONFIG_DSP_MEDIAN_MAX_WINDOW};
+    dsp_median_t median;
+
+    dsp_make_signal();
+    for (uint32_t w = 0; w < sizeof(windows); w++) {
+        uint8_t window = windows[w];
+
+        for (uint32_t i = 0; i < DSP_TEST_SAMPLES; i++) {
+            int16_t sorted[CONFIG_DSP_MEDIAN_MAX_WINDOW];
+            uint32_t n = (i + 1 < window) ? i + 1 : window;
+
+            /* 插入排序窗口内样本 */
+            for (uint32_t j = 0; j < n; j++) {
+                int16_t sample = dsp_in[i - j];
+                uint32_t pos = j;
+
+                while (pos > 0 && sorted[pos - 1] > sample) {
+                    sorted[pos] = sorted[pos - 1];
+                    pos--;
+                }
+                sorted[pos] = sample;
+            }
+            dsp_ref[i] = sorted[n / 2];
+        }
+
+        UT_ASSERT_EQUAL_INT(DSP_OK, dsp_median_init(&median, window));
+        dsp_median_process(&median, dsp_in, dsp_out, DSP_TEST_SAMPLES);
+        UT_ASSERT(memcmp(dsp_out, dsp_ref, sizeof(dsp_out)) == 0);
+    }
+
+    /* 孤立尖峰被完全滤除 */
+    memset(dsp_in, 0, sizeof(dsp_in));
+    dsp_in[100] = INT16_MAX;
+    dsp_median_init(&median, 3);
+    dsp_median_process(&median, dsp_in, dsp_out, DSP_TEST_SAMPLES);
+    for (uint32_t i = 0; i < DSP_TEST_SAMPLES; i++) {
+        UT_ASSERT_EQUAL_INT(0, dsp_out[i]);
+    }
+}
+
+/* 测试双二阶级联与差分方程参考结果一致，直流增益为1 */
+static void test_dsp_biquad(void)
+{
+    dsp_biquad_t biquad;
+
+    dsp_make_signal();
+
+    ref_biquad(dsp_test_lowpass, 1, 1, dsp_in, dsp_ref, DSP_TEST_SAMPLES);
+    dsp_biquad_init(&biquad, dsp_test_lowpass, 1, 1);
+    dsp_biquad_process(&biquad, dsp_in, dsp_out, DSP_TEST_SAMPLES);
+    UT_ASSERT(memcmp(dsp_out, dsp_ref, sizeof(dsp_out)) == 0);
+
+    ref_biquad(dsp_test_cascade, 2, 1, dsp_in, dsp_ref, DSP_TEST_SAMPLES);
+    dsp_biquad_init(&biquad, dsp_test_cascade, 2, 1);
+    dsp_biquad_process(&biquad, dsp_in, dsp_out, DSP_TEST_SAMPLES);
+    UT_ASSERT(memcmp(dsp_out, dsp_ref, sizeof(dsp_out)) == 0);
+
+    /* 原地处理 */
+    memcpy(dsp_out, dsp_in, sizeof(dsp_out));
+    dsp_biquad_init(&biquad, dsp_test_cascade, 2, 1);
+    dsp_biquad_process(&biquad, dsp_out, dsp_out, DSP_TEST_SAMPLES);
+    UT_ASSERT(memcmp(dsp_out, dsp_ref, sizeof(dsp_out)) == 0);
+
+    /* 阶跃输入稳定后输出等于输入，系数量化误差在1%以内 */
+    for (uint32_t i = 0; i < DSP_TEST_SAMPLES; i++) {
+        dsp_in[i] = 10000;
+    }
+    dsp_biquad_init(&biquad, dsp_test_lowpass, 1, 1);
+    dsp_biquad_process(&biquad, dsp_in, dsp_out, DSP_TEST_SAMPLES);
+    UT_ASSERT(dsp_out[DSP_TEST_SAMPLES - 1] > 9900 && dsp_out[DSP_TEST_SAMPLES - 1] < 10100);
+}
+
+/* 测试抽取器按组求平均，不足一组的样本留到下一块 */
+static void test_dsp_decimator(void)
+{
+    dsp_decimator_t decimator;
+    uint32_t produced = 0;
+    uint32_t expected = 0;
+    uint32_t k, offset, length;
+    const uint16_t factor = 6;
+
+    dsp_make_signal();
+    for (uint32_t i = 0; i + factor <= DSP_TEST_SAMPLES; i += factor) {
+        int32_t sum = 0;
+
+        for (uint32_t j = 0; j < factor; j++) {
+            sum += dsp_in[i + j];
+        }
+        dsp_ref[expected++] = (int16_t)(sum / factor);
+    }
+
+    dsp_decimator_init(&decimator, factor);
+    for (k = 0, offset = 0; offset < DSP_TEST_SAMPLES; offset += length, k++) {
+        length = dsp_chunk_length(k, offset);
+        produced += dsp_decimator_process(&decimator, &dsp_in[offset], length, &dsp_out[produced]);
+    }
+
+    UT_ASSERT_EQUAL_INT(expected, produced);
+    UT_ASSERT(memcmp(dsp_out, dsp_ref, expected * sizeof(int16_t)) == 0);
+    UT_ASSERT_EQUAL_INT(DSP_TEST_SAMPLES % factor, decimator.phase);
+
+    /* 原地抽取 */
+    memcpy(dsp_out, dsp_in, sizeof(dsp_out));
+    dsp_decimator_init(&decimator, factor);
+    UT_ASSERT_EQUAL_INT(expected, dsp_decimator_process(&decimator, dsp_out, DSP_TEST_SAMPLES, dsp_out));
+    UT_ASSERT(memcmp(dsp_out, dsp_ref, expected * sizeof(int16_t)) == 0);
+}
+
+/* 测试任意分块处理与逐样本处理的输出和状态逐位一致 */
+static void test_dsp_block_equivalence(void)
+{
+    dsp_moving_average_t average_block, average_sample;
+    dsp_median_t median_block, median_sample;
+    dsp_biquad_t biquad_block, biquad_sample;
+    uint32_t i, k, offset, length;
+
+    dsp_make_signal();
+
+    /* 滑动平均 */
+    dsp_moving_average_init(&average_block, 10);
+    dsp_moving_average_init(&average_sample, 10);
+    for (k = 0, offset = 0; offset < DSP_TEST_SAMPLES; offset += length, k++) {
+        length = dsp_chunk_length(k, offset);
+        dsp_moving_average_process(&average_block, &dsp_in[offset], &dsp_out[offset], length);
+    }
+    for (i = 0; i < DSP_TEST_SAMPLES; i++) {
+        dsp_moving_average_process(&average_sample, &dsp_in[i], &dsp_ref[i], 1);
+    }
+    UT_ASSERT(memcmp(dsp_out, dsp_ref, sizeof(dsp_out)) == 0);
+    UT_ASSERT(memcmp(average_block.history, average_sample.history, sizeof(average_block.history)) == 0);
+    UT_ASSERT_EQUAL_INT(average_sample.sum, average_block.sum);
+    UT_ASSERT_EQUAL_INT(average_sample.index, average_block.index);
+    UT_ASSERT_EQUAL_INT(average_sample.filled, average_block.filled);
+
+    /* 中值 */
+    dsp_median_init(&median_block, 7);
+    dsp_median_init(&median_sample, 7);
+    for (k = 0, offset = 0; offset < DSP_TEST_SAMPLES; offset += length, k++) {
+        length = dsp_chunk_length(k, offset);
+        dsp_median_process(&median_block, &dsp_in[offset], &dsp_out[offset], length);
+    }
+    for (i = 0; i < DSP_TEST_SAMPLES; i++) {
+        dsp_median_process(&median_sample, &dsp_in[i], &dsp_ref[i], 1);
+    }
+    UT_ASSERT(memcmp(dsp_out, dsp_ref, sizeof(dsp_out)) == 0);
+    UT_ASSERT(memcmp(median_block.history, median_sample.history, sizeof(median_block.history)) == 0);
+    UT_ASSERT(memcmp(median_block.sorted, median_sample.sorted, sizeof(median_block.sorted)) == 0);
+    UT_ASSERT_EQUAL_INT(median_sample.index, median_block.index);
+    UT_ASSERT_EQUAL_INT(median_sample.filled, median_block.filled);
+
+    /* 双二阶级联 */
+    dsp_biquad_init(&biquad_block, dsp_test_cascade, 2, 1);
+    dsp_biquad_init(&biquad_sample, dsp_test_cascade, 2, 1);
+    for (k = 0, offset = 0; offset < DSP_TEST_SAMPLES; offset += length, k++) {
+        length = dsp_chunk_length(k, offset);
+        dsp_biquad_process(&biquad_block, &dsp_in[offset], &dsp_out[offset], length);
+    }
+    for (i = 0; i < DSP_TEST_SAMPLES; i++) {
+        dsp_biquad_process(&biquad_sample, &dsp_in[i], &dsp_ref[i], 1);
+    }
+    UT_ASSERT(memcmp(dsp_out, dsp_ref, sizeof(dsp_out)) == 0);
+    UT_ASSERT(memcmp(biquad_block.state, biquad_sample.state, sizeof(biquad_block.state)) == 0);
+}
+
+/* DSP测试案例 */
+static ut_test_case_t dsp_block_test_cases[] = {
+    {"初始化测试", test_dsp_init},
+    {"滑动平均测试", test_dsp_moving_average},
+    {"中值滤波测试", test_dsp_median},
+    {"双二阶滤波测试", test_dsp_biquad},
+    {"抽取测试", test_dsp_decimator},
+    {"分块与逐样本一致性测试", test_dsp_block_equivalence}
+};
+
+/* DSP测试套件 */
+ut_test_suite_t dsp_block_test_suite = {
+    "块处理DSP测试套件",
+    dsp_block_test_cases,
+    sizeof(dsp_block_test_cases) / sizeof(dsp_block_test_cases[0]),
+    NULL,
+    NULL,
+    NULL,
+    NULL
+};
+
+#endif /* CONFIG_DSP_BLOCK_ENABLED */
@@ -0,0 +1,445 @@
+/**
+ * @file test_flash_fs.c
+ * @brief Flash文件系统单元测试
+ *
+ * 该文件在主机Flash模拟驱动上测试文件系统的文件与目录操作、大文件定位、
+ * 重命名与重新挂载、元数据块迁移和任意位置掉电恢复
+ */
+
+#include "unit_test.h"
+#include "flash_fs_api.h"
+#include "host_flash_api.h"
+#include <stdio.h>
+#include <string.h>
+
+/* 测试使用整个模拟Flash，每块一个扇区 */
+#define FS_TEST_BLOCK_COUNT     16
+
+/* Flash设备句柄 */
+static flash_handle_t fs_flash = NULL;
+
+/* 分区配置 */
+static flash_fs_config_t fs_config;
+
+/* 挂载配置 */
+static fs_mount_config_t fs_mount_config;
+
+/* 文件系统句柄 */
+static fs_handle_t fs_handle = NULL;
+
+/* 大文件测试数据 */
+static uint8_t fs_data[20000];
+
+/* 按位置生成测试数据 */
+static uint8_t fs_pattern(uint32_t pos, uint32_t seed)
+{
+    return (uint8_t)((pos * 31 + seed * 7 + (pos >> 8)) & 0xFF);
+}
+
+/* 写入整个文件 */
+static int fs_write_file(const char *path, const void *data, uint32_t size)
+{
+    fs_file_handle_t file;
+    uint32_t written = 0;
+    int ret;
+
+    ret = fs_open(fs_handle, path, FS_MODE_WRITE | FS_MODE_CREATE | FS_MODE_TRUNCATE, &file);
+    if (ret != 0) {
+        return ret;
+    }
+
+    ret = fs_write(file, data, size, &written);
+    if (ret == 0 && written != size) {
+        ret = -1;
+    }
+    if (fs_close(file) != 0 && ret == 0) {
+        ret = -1;
+    }
+
+    return ret;
+}
+
+/* 读取整个文件，返回读取的字节数，失败返回负数 */
+static int fs_read_file(const char *path, void *data, uint32_t size)
+{
+    fs_file_handle_t file;
+    uint32_t bytes_read = 0;
+    int ret;
+
+    ret = fs_open(fs_handle, path, FS_MODE_READ, &file);
+    if (ret != 0) {
+        return ret;
+    }
+
+    ret = fs_read(file, data, size, &bytes_read);
+    fs_close(file);
+
+    return (ret == 0) ? (int)bytes_read : ret;
+}
+
+/* 模拟重新上电并挂载 */
+static int fs_power_cycle(void)
+{
+    fs_unmount(fs_handle);
+    flash_deinit(fs_flash);
+    if (flash_init(NULL, NULL, &fs_flash) != 0) {
+        return -1;
+    }
+    fs_config.flash = fs_flash;
+
+    return fs_mount(&fs_mount_config, &fs_handle);
+}
+
+/**
+ * @brief 测试基本文件与目录操作
+ */
+static void test_flash_fs_basic(void)
+{
+    fs_file_handle_t file;
+    fs_dir_handle_t dir;
+    fs_file_info_t info;
+    char buffer[64];
+    uint32_t count;
+    int ret;
+
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_mkdir(fs_handle, "/data"));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_write_file("/data/config.txt", "mode=auto", 9));
+    memset(buffer, 0, sizeof(buffer));
+    UT_ASSERT_EQUAL_INT(9, fs_read_file("/data/config.txt", buffer, sizeof(buffer)));
+    UT_ASSERT_EQUAL_STRING("mode=auto", buffer);
+
+    /* 追加写入 */
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_open(fs_handle, "/data/config.txt", FS_MODE_WRITE | FS_MODE_APPEND, &file));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_write(file, ";fast", 5, NULL));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_close(file));
+    memset(buffer, 0, sizeof(buffer));
+    UT_ASSERT_EQUAL_INT(14, fs_read_file("/data/config.txt", buffer, sizeof(buffer)));
+    UT_ASSERT_EQUAL_STRING("mode=auto;fast", buffer);
+
+    /* 目录 */
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_mkdir(fs_handle, "/logs"));
+    UT_ASSERT_EQUAL_INT(ERROR_ALREADY_EXISTS, fs_mkdir(fs_handle, "/logs"));
+    UT_ASSERT_EQUAL_INT(ERROR_NOT_FOUND, fs_mkdir(fs_handle, "/missing/child"));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_write_file("/logs/a.log", "a", 1));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_write_file("/logs/b.log", "bb", 2));
+
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_stat(fs_handle, "/logs/b.log", &info));
+    UT_ASSERT_EQUAL_INT(2, info.size);
+    UT_ASSERT(!info.is_directory);
+    UT_ASSERT_EQUAL_STRING("b.log", info.name);
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_stat(fs_handle, "/logs", &info));
+    UT_ASSERT(info.is_directory);
+
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_opendir(fs_handle, "/logs", &dir));
+    count = 0;
+    while ((ret = fs_readdir(dir, &info)) == 0) {
+        count++;
+    }
+    UT_ASSERT_EQUAL_INT(1, ret);
+    UT_ASSERT_EQUAL_INT(2, count);
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_closedir(dir));
+
+    /* 非空目录不能删除 */
+    UT_ASSERT_EQUAL_INT(ERROR_BUSY, fs_rmdir(fs_handle, "/logs"));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_remove(fs_handle, "/logs/a.log"));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_remove(fs_handle, "/logs/b.log"));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_rmdir(fs_handle, "/logs"));
+    UT_ASSERT_EQUAL_INT(ERROR_NOT_FOUND, fs_stat(fs_handle, "/logs", &info));
+
+    /* 打开模式检查 */
+    UT_ASSERT_EQUAL_INT(ERROR_NOT_FOUND, fs_open(fs_handle, "/none.txt", FS_MODE_READ, &file));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_open(fs_handle, "/data/config.txt", FS_MODE_READ, &file));
+    UT_ASSERT_EQUAL_INT(ERROR_PERMISSION, fs_write(file, "x", 1, NULL));
+    UT_ASSERT_EQUAL_INT(ERROR_BUSY, fs_remove(fs_handle, "/data/config.txt"));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_close(file));
+}
+
+/**
+ * @brief 测试跨越多块的大文件、随机定位和中间改写
+ */
+static void test_flash_fs_large_file(void)
+{
+    static uint8_t readback[sizeof(fs_data)];
+    fs_file_handle_t file;
+    flash_fs_stats_t stats;
+    uint32_t bytes_read;
+    uint32_t pos;
+    uint32_t i;
+
+    for (i = 0; i < sizeof(fs_data); i++) {
+        fs_data[i] = fs_pattern(i, 1);
+    }
+
+    /* 分多次写入 */
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_open(fs_handle, "/big.bin", FS_MODE_WRITE | FS_MODE_CREATE, &file));
+    for (i = 0; i < sizeof(fs_data); i += 1000) {
+        UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_write(file, fs_data + i, 1000, NULL));
+    }
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_close(file));
+
+    memset(readback, 0, sizeof(readback));
+    UT_ASSERT_EQUAL_INT(sizeof(fs_data), fs_read_file("/big.bin", readback, sizeof(readback)));
+    UT_ASSERT(memcmp(fs_data, readback, sizeof(fs_data)) == 0);
+
+    /* 随机定位读取 */
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_open(fs_handle, "/big.bin", FS_MODE_READ | FS_MODE_WRITE, &file));
+    for (i = 0; i < 40; i++) {
+        uint8_t chunk[37];
+
+        pos = (i * 7919) % (sizeof(fs_data) - sizeof(chunk));
+        UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_seek(file, (int32_t)pos, FS_SEEK_SET));
+        UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_read(file, chunk, sizeof(chunk), &bytes_read));
+        UT_ASSERT_EQUAL_INT(sizeof(chunk), bytes_read);
+        UT_ASSERT(memcmp(chunk, fs_data + pos, sizeof(chunk)) == 0);
+    }
+
+    /* 改写中间一段，前后内容保持不变 */
+    for (i = 9000; i < 9500; i++) {
+        fs_data[i] = fs_pattern(i, 2);
+    }
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_seek(file, 9000, FS_SEEK_SET));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_write(file, fs_data + 9000, 500, NULL));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_seek(file, 8990, FS_SEEK_SET));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_read(file, readback, 520, &bytes_read));
+    UT_ASSERT(memcmp(readback, fs_data + 8990, 520) == 0);
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_close(file));
+
+    /* 在末尾追加，尾块剩余空间直接续写 */
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, flash_fs_get_stats(fs_handle, &stats));
+    pos = stats.inplace_appends;
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_open(fs_handle, "/big.bin", FS_MODE_WRITE | FS_MODE_APPEND, &file));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_write(file, "tail", 4, NULL));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_close(file));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, flash_fs_get_stats(fs_handle, &stats));
+    UT_ASSERT_EQUAL_INT(pos + 1, stats.inplace_appends);
+
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_power_cycle());
+    memset(readback, 0, sizeof(readback));
+    UT_ASSERT_EQUAL_INT(sizeof(fs_data), fs_read_file("/big.bin", readback, sizeof(readback)));
+    UT_ASSERT(memcmp(fs_data, readback, sizeof(fs_data)) == 0);
+
+    /* 删除后空间被回收 */
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_remove(fs_handle, "/big.bin"));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, flash_fs_get_stats(fs_handle, &stats));
+    UT_ASSERT_EQUAL_INT(4, stats.used_blocks);
+}
+
+/**
+ * @brief 测试重命名替换与重新挂载
+ */
+static void test_flash_fs_rename(void)
+{
+    fs_file_info_t info;
+    char buffer[32];
+
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_mkdir(fs_handle, "/cfg"));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_write_file("/cfg/app.json", "{\"v\":1}", 7));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_write_file("/cfg/app.json.tmp", "{\"v\":2}", 7));
+
+    /* 替换已存在的目标 */
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_rename(fs_handle, "/cfg/app.json.tmp", "/cfg/app.json"));
+    UT_ASSERT_EQUAL_INT(ERROR_NOT_FOUND, fs_stat(fs_handle, "/cfg/app.json.tmp", &info));
+
+    /* 跨目录移动，目录不能移动到自己的子目录 */
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_mkdir(fs_handle, "/cfg/old"));
+    UT_ASSERT_EQUAL_INT(ERROR_INVALID_PARAM, fs_rename(fs_handle, "/cfg", "/cfg/old/cfg"));
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_rename(fs_handle, "/cfg/old", "/archive"));
+
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_power_cycle());
+    memset(buffer, 0, sizeof(buffer));
+    UT_ASSERT_EQUAL_INT(7, fs_read_file("/flash/cfg/app.json", buffer, sizeof(buffer)));
+    UT_ASSERT_EQUAL_STRING("{\"v\":2}", buffer);
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_stat(fs_handle, "/archive", &info));
+    UT_ASSERT(info.is_directory);
+    UT_ASSERT_EQUAL_INT(ERROR_NOT_FOUND, fs_stat(fs_handle, "/cfg/old", &info));
+}
+
+/**
+ * @brief 测试元数据块迁移与擦除分布
+ *
+ * 反复改写不能内联的小文件使元数据日志多次压缩，元数据块对按block_cycles
+ * 迁移到新块；锚点块之外的各块擦除次数接近
+ */
+static void test_flash_fs_wear(void)
+{
+    flash_fs_stats_t stats;
+    uint32_t record[32];
+    uint32_t min_erase = 0xFFFFFFFF;
+    uint32_t max_erase = 0;
+    uint32_t i;
+
+    memset(record, 0xA5, sizeof(record));
+    for (i = 0; i < 3000; i++) {
+        char path[16];
+
+        snprintf(path, sizeof(path), "/counter%u", (unsigned)(i % 4));
+        record[0] = i;
+        UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_write_file(path, record, sizeof(record)));
+    }
+
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, flash_fs_get_stats(fs_handle, &stats));
+    UT_ASSERT(stats.compactions > 0);
+    UT_ASSERT(stats.relocations > 0);
+    UT_ASSERT_EQUAL_INT(4, stats.entries);
+
+    for (i = 2; i < FS_TEST_BLOCK_COUNT; i++) {
+        uint32_t count = host_flash_get_erase_count(i);
+
+        if (count < min_erase) {
+            min_erase = count;
+        }
+        if (count > max_erase) {
+            max_erase = count;
+        }
+    }
+    UT_ASSERT(min_erase > 0);
+    UT_ASSERT(max_erase <= min_erase * 3);
+
+    UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_power_cycle());
+    for (i = 0; i < 4; i++) {
+        char path[16];
+
+        snprintf(path, sizeof(path), "/counter%u", (unsigned)i);
+        memset(record, 0, sizeof(record));
+        UT_ASSERT_EQUAL_INT(sizeof(record), fs_read_file(path, record, sizeof(record)));
+        UT_ASSERT_EQUAL_INT(3000 - 4 + i, record[0]);
+        UT_ASSERT_EQUAL_INT(0xA5A5A5A5, record[31]);
+    }
+}
+
+/**
+ * @brief 测试任意位置掉电后的恢复
+ *
+ * 反复以"写临时文件再重命名"的方式更新一个跨越多块的文件，同时在另一个文件
+ * 末尾追加日志，在不同的编程或擦除操作中注入掉电。重新上电挂载后目标文件
+ * 完整等于掉电前最后一次成功提交的版本或正在提交的版本，日志长度不小于最后
+ * 一次成功同步的长度，并且文件系统可以继续写入
+ */
+static void test_flash_fs_power_loss(void)
+{
+    static uint8_t readback[6000];
+    fs_file_handle_t log;
+    uint32_t committed;
+    uint32_t pending;
+    uint32_t log_synced;
+    uint32_t countdown;
+    uint32_t version;
+    fs_file_info_t info;
+    int ret;
+
+    for (countdown = 1; countdown < 40000; countdown += 997) {
+        UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_format(fs_handle));
+
+        for (uint32_t i = 0; i < sizeof(readback); i++) {
+            fs_data[i] = fs_pattern(i, 0);
+        }
+        UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_write_file("/state.bin", fs_data, sizeof(readback)));
+        UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_open(fs_handle, "/events.log", FS_MODE_WRITE | FS_MODE_CREATE, &log));
+        committed = 0;
+        pending = 0;
+        log_synced = 0;
+
+        host_flash_inject_power_loss(countdown);
+        for (version = 1; ; version++) {
+            for (uint32_t i = 0; i < sizeof(readback); i++) {
+                fs_data[i] = fs_pattern(i, version);
+            }
+            if (fs_write_file("/state.tmp", fs_data, sizeof(readback)) != ERROR_NONE) {
+                break;
+            }
+            pending = version;
+            if (fs_rename(fs_handle, "/state.tmp", "/state.bin") != ERROR_NONE) {
+                break;
+            }
+            committed = version;
+
+            if (fs_write(log, "event-record-0123456789\n", 24, NULL) != ERROR_NONE ||
+                fs_flush(log) != ERROR_NONE) {
+                break;
+            }
+            log_synced += 24;
+        }
+        UT_ASSERT(host_flash_is_powered_off());
+        fs_close(log);
+
+        /* 重新上电，挂载不需要扫描整个分区 */
+        UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_power_cycle());
+
+        memset(readback, 0, sizeof(readback));
+        UT_ASSERT_EQUAL_INT(sizeof(readback), fs_read_file("/state.bin", readback, sizeof(readback)));
+        for (uint32_t i = 0; i < sizeof(readback); i++) {
+            fs_data[i] = fs_pattern(i, committed);
+        }
+        ret = memcmp(readback, fs_data, sizeof(readback));
+        if (ret != 0) {
+            for (uint32_t i = 0; i < sizeof(readback); i++) {
+                fs_data[i] = fs_pattern(i, pending);
+            }
+            ret = memcmp(readback, fs_data, sizeof(readback));
+        }
+        UT_ASSERT_EQUAL_INT(0, ret);
+
+        UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_stat(fs_handle, "/events.log", &info));
+        UT_ASSERT(info.size >= log_synced && info.size <= log_synced + 24);
+
+        /* 恢复后可以继续写入 */
+        UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_write_file("/state.tmp", "ok", 2));
+        UT_ASSERT_EQUAL_INT(ERROR_NONE, fs_rename(fs_handle, "/state.tmp", "/state.bin"));
+        UT_ASSERT_EQUAL_INT(2, fs_read_file("/state.bin", readback, sizeof(readback)));
+    }
+}
+
+/* 每个测试案例使用新格式化的文件系统 */
+static void flash_fs_test_setup(void)
+{
+    uint32_t sector_size = 0;
+
+    host_flash_format();
+    flash_init(NULL, NULL, &fs_flash);
+    flash_get_info(fs_flash, NULL, &sector_size, NULL);
+
+    memset(&fs_config, 0, sizeof(fs_config));
+    fs_config.flash = fs_flash;
+    fs_config.base_address = 0;
+    fs_config.block_size = sector_size;
+    fs_config.block_count = FS_TEST_BLOCK_COUNT;
+    fs_config.block_cycles = 8;
+
+    memset(&fs_mount_config, 0, sizeof(fs_mount_config));
+    strcpy(fs_mount_config.path, "/flash");
+    fs_mount_config.type = FS_TYPE_LITTLEFS;
+    fs_mount_config.format_if_empty = true;
+    fs_mount_config.fs_config = &fs_config;
+
+    fs_init();
+    fs_mount(&fs_mount_config, &fs_handle);
+}
+
+/* 测试案例清理 */
+static void flash_fs_test_teardown(void)
+{
+    fs_deinit();
+    flash_deinit(fs_flash);
+    fs_flash = NULL;
+    fs_handle = NULL;
+}
+
+/* 文件系统测试案例 */
+static ut_test_case_t flash_fs_test_cases[] = {
+    {"基本操作测试", test_flash_fs_basic},
+    {"大文件定位与改写测试", test_flash_fs_large_file},
+    {"重命名与重新挂载测试", test_flash_fs_rename},
+    {"元数据迁移与擦除分布测试", test_flash_fs_wear},
+    {"任意位置掉电测试", test_flash_fs_power_loss}
+};
+
+/* 文件系统测试套件 */
+ut_test_suite_t flash_fs_test_suite = {
+    "Flash文件系统测试套件",
+    flash_fs_test_cases,
+    sizeof(flash_fs_test_cases) / sizeof(flash_fs_test_cases[0]),
+    NULL,
+    NULL,
+    flash_fs_test_setup,
+    flash_fs_test_teardown
+};
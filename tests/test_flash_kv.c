@@ -0,0 +1,291 @@
+/**
+ * @file test_flash_kv.c
+ * @brief Flash键值存储单元测试
+ *
+ * 该文件在主机Flash模拟驱动上测试键值存储的读写、重新挂载、回收和掉电恢复
+ */
+
+#include "unit_test.h"
+#include "flash_kv_api.h"
+#include "host_flash_api.h"
+#include <stdio.h>
+#include <string.h>
+
+/* 测试使用的扇区数量 */
+#define KV_TEST_SECTORS     4
+
+/* Flash设备句柄 */
+static flash_handle_t kv_flash = NULL;
+
+/* 存储区域配置 */
+static flash_kv_config_t kv_config;
+
+/* 键值存储对象较大，使用静态存储 */
+static flash_kv_t kv_store;
+
+/**
+ * @brief 测试基本读写与删除
+ */
+static void test_flash_kv_basic(void)
+{
+    char value[32];
+    int ret;
+
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_set(&kv_store, "wifi.ssid", "office", 6));
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_set(&kv_store, "wifi.pass", "secret", 6));
+
+    memset(value, 0, sizeof(value));
+    ret = flash_kv_get(&kv_store, "wifi.ssid", value, sizeof(value));
+    UT_ASSERT_EQUAL_INT(6, ret);
+    UT_ASSERT_EQUAL_STRING("office", value);
+
+    /* 覆盖写入后读到新值 */
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_set(&kv_store, "wifi.ssid", "home-network", 12));
+    memset(value, 0, sizeof(value));
+    ret = flash_kv_get(&kv_store, "wifi.ssid", value, sizeof(value));
+    UT_ASSERT_EQUAL_INT(12, ret);
+    UT_ASSERT_EQUAL_STRING("home-network", value);
+
+    /* 缓冲区较小时返回实际长度 */
+    memset(value, 0, sizeof(value));
+    ret = flash_kv_get(&kv_store, "wifi.ssid", value, 4);
+    UT_ASSERT_EQUAL_INT(12, ret);
+    UT_ASSERT_EQUAL_STRING("home", value);
+
+    /* 删除 */
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_delete(&kv_store, "wifi.pass"));
+    UT_ASSERT_EQUAL_INT(FLASH_KV_NOT_FOUND, flash_kv_get(&kv_store, "wifi.pass", value, sizeof(value)));
+    UT_ASSERT_EQUAL_INT(FLASH_KV_NOT_FOUND, flash_kv_delete(&kv_store, "wifi.pass"));
+
+    /* 无效参数 */
+    UT_ASSERT_EQUAL_INT(FLASH_KV_INVALID_PARAM, flash_kv_set(&kv_store, "", "x", 1));
+    UT_ASSERT_EQUAL_INT(FLASH_KV_INVALID_PARAM, flash_kv_set(NULL, "key", "x", 1));
+}
+
+/**
+ * @brief 测试非法配置的格式化被拒绝且不擦除数据
+ */
+static void test_flash_kv_format_invalid(void)
+{
+    flash_kv_config_t bad_config;
+    char value[32];
+
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_set(&kv_store, "boot.count", "7", 1));
+
+    /* 扇区大小未按字对齐 */
+    bad_config = kv_config;
+    bad_config.sector_size = kv_config.sector_size - 2;
+    UT_ASSERT_EQUAL_INT(FLASH_KV_INVALID_PARAM, flash_kv_format(&kv_store, &bad_config));
+
+    /* 扇区容纳不下最大记录 */
+    bad_config = kv_config;
+    bad_config.sector_size = FLASH_KV_RECORD_MAX_SIZE;
+    UT_ASSERT_EQUAL_INT(FLASH_KV_INVALID_PARAM, flash_kv_format(&kv_store, &bad_config));
+
+    /* 基地址未按字对齐 */
+    bad_config = kv_config;
+    bad_config.base_address = 2;
+    UT_ASSERT_EQUAL_INT(FLASH_KV_INVALID_PARAM, flash_kv_format(&kv_store, &bad_config));
+
+    /* 存储仍处于挂载状态，重新挂载后数据仍在 */
+    memset(value, 0, sizeof(value));
+    UT_ASSERT_EQUAL_INT(1, flash_kv_get(&kv_store, "boot.count", value, sizeof(value)));
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_unmount(&kv_store));
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_mount(&kv_store, &kv_config));
+    memset(value, 0, sizeof(value));
+    UT_ASSERT_EQUAL_INT(1, flash_kv_get(&kv_store, "boot.count", value, sizeof(value)));
+    UT_ASSERT_EQUAL_STRING("7", value);
+}
+
+/**
+ * @brief 测试重新挂载后索引重建
+ */
+static void test_flash_kv_remount(void)
+{
+    char value[32];
+    int ret;
+
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_set(&kv_store, "device.id", "A1B2", 4));
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_set(&kv_store, "device.id", "C3D4", 4));
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_set(&kv_store, "token", "t0", 2));
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_delete(&kv_store, "token"));
+
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_unmount(&kv_store));
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_mount(&kv_store, &kv_config));
+
+    memset(value, 0, sizeof(value));
+    ret = flash_kv_get(&kv_store, "device.id", value, sizeof(value));
+    UT_ASSERT_EQUAL_INT(4, ret);
+    UT_ASSERT_EQUAL_STRING("C3D4", value);
+    UT_ASSERT_EQUAL_INT(FLASH_KV_NOT_FOUND, flash_kv_get(&kv_store, "token", value, sizeof(value)));
+}
+
+/**
+ * @brief 测试回收与擦除均衡
+ *
+ * 反复更新少量键，写入量远大于区域容量
+ */
+static void test_flash_kv_gc_wear(void)
+{
+    flash_kv_stats_t stats;
+    char key[16];
+    uint32_t value;
+    uint32_t i;
+
+    for (i = 0; i < 4000; i++) {
+        snprintf(key, sizeof(key), "sensor.%u", (unsigned)(i % 16));
+        value = i;
+        UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_set(&kv_store, key, &value, sizeof(value)));
+    }
+
+    /* 重新挂载后每个键都是最后一次写入的值 */
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_unmount(&kv_store));
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_mount(&kv_store, &kv_config));
+    for (i = 0; i < 16; i++) {
+        snprintf(key, sizeof(key), "sensor.%u", (unsigned)i);
+        value = 0;
+        UT_ASSERT_EQUAL_INT(sizeof(value), flash_kv_get(&kv_store, key, &value, sizeof(value)));
+        UT_ASSERT_EQUAL_INT(4000 - 16 + i, value);
+    }
+
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_get_stats(&kv_store, &stats));
+    UT_ASSERT(stats.max_erase_count > 0);
+    UT_ASSERT(stats.max_erase_count - stats.min_erase_count <= 1);
+    UT_ASSERT(stats.free_sectors >= 1);
+}
+
+/**
+ * @brief 测试掉电中断的写入
+ *
+ * 在日志末尾写入只有记录头的半条记录，重新挂载后旧数据完整且可以继续写入
+ */
+static void test_flash_kv_torn_write(void)
+{
+    static const uint8_t torn[8] = {5, 0x5A, 4, 0, 0x12, 0x34, 0x56, 0x78};
+    flash_kv_stats_t stats;
+    char value[16];
+    uint32_t address;
+
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_set(&kv_store, "mode", "auto", 4));
+
+    address = kv_config.base_address + kv_store.head * kv_config.sector_size +
+              kv_store.sectors[kv_store.head].write_offset;
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_write(kv_flash, address, torn, sizeof(torn)));
+
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_unmount(&kv_store));
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_mount(&kv_store, &kv_config));
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_get_stats(&kv_store, &stats));
+    UT_ASSERT_EQUAL_INT(1, stats.corrupt_records);
+
+    memset(value, 0, sizeof(value));
+    UT_ASSERT_EQUAL_INT(4, flash_kv_get(&kv_store, "mode", value, sizeof(value)));
+    UT_ASSERT_EQUAL_STRING("auto", value);
+
+    UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_set(&kv_store, "mode", "manual", 6));
+    memset(value, 0, sizeof(value));
+    UT_ASSERT_EQUAL_INT(6, flash_kv_get(&kv_store, "mode", value, sizeof(value)));
+    UT_ASSERT_EQUAL_STRING("manual", value);
+}
+
+/**
+ * @brief 测试任意位置掉电后的恢复
+ *
+ * 在主机Flash模拟器的不同编程或擦除操作中注入掉电，覆盖记录写入和回收迁移
+ * 过程。重新上电挂载后每个键的值是最后一次成功写入的值，或者是掉电时正在
+ * 写入的值
+ */
+static void test_flash_kv_power_loss(void)
+{
+    uint32_t committed[3];
+    uint32_t pending;
+    uint32_t value;
+    uint32_t countdown;
+    uint32_t i;
+    char key[8];
+
+    for (countdown = 1; countdown < 6000; countdown += 53) {
+        UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_format(&kv_store, &kv_config));
+        for (i = 0; i < 3; i++) {
+            snprintf(key, sizeof(key), "k%u", (unsigned)i);
+            committed[i] = i;
+            UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_set(&kv_store, key, &committed[i], sizeof(uint32_t)));
+        }
+
+        /* 持续更新直到掉电 */
+        host_flash_inject_power_loss(countdown);
+        for (i = 3; ; i++) {
+            snprintf(key, sizeof(key), "k%u", (unsigned)(i % 3));
+            pending = i;
+            if (flash_kv_set(&kv_store, key, &pending, sizeof(pending)) != FLASH_KV_OK) {
+                break;
+            }
+            committed[i % 3] = i;
+        }
+        UT_ASSERT(host_flash_is_powered_off());
+
+        /* 重新上电并挂载 */
+        flash_kv_unmount(&kv_store);
+        flash_deinit(kv_flash);
+        UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_init(NULL, NULL, &kv_flash));
+        kv_config.flash = kv_flash;
+        UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_mount(&kv_store, &kv_config));
+
+        for (i = 0; i < 3; i++) {
+            snprintf(key, sizeof(key), "k%u", (unsigned)i);
+            value = 0xFFFFFFFF;
+            UT_ASSERT_EQUAL_INT(sizeof(value), flash_kv_get(&kv_store, key, &value, sizeof(value)));
+            UT_ASSERT(value == committed[i] || value == pending);
+        }
+
+        /* 恢复后可以继续写入 */
+        value = 0x5A5A5A5A;
+        UT_ASSERT_EQUAL_INT(FLASH_KV_OK, flash_kv_set(&kv_store, "k0", &value, sizeof(value)));
+        flash_kv_unmount(&kv_store);
+    }
+}
+
+/* 每个测试案例使用新格式化的存储区域 */
+static void flash_kv_test_setup(void)
+{
+    uint32_t sector_size = 0;
+
+    flash_init(NULL, NULL, &kv_flash);
+    flash_get_info(kv_flash, NULL, &sector_size, NULL);
+
+    memset(&kv_config, 0, sizeof(kv_config));
+    kv_config.flash = kv_flash;
+    kv_config.base_address = 0;
+    kv_config.sector_size = sector_size;
+    kv_config.sector_count = KV_TEST_SECTORS;
+
+    flash_kv_format(&kv_store, &kv_config);
+}
+
+/* 测试案例清理 */
+static void flash_kv_test_teardown(void)
+{
+    flash_kv_unmount(&kv_store);
+    flash_deinit(kv_flash);
+    kv_flash = NULL;
+}
+
+/* 键值存储测试案例 */
+static ut_test_case_t flash_kv_test_cases[] = {
+    {"基本读写测试", test_flash_kv_basic},
+    {"格式化参数检查测试", test_flash_kv_format_invalid},
+    {"重新挂载测试", test_flash_kv_remount},
+    {"回收与擦除均衡测试", test_flash_kv_gc_wear},
+    {"掉电写入恢复测试", test_flash_kv_torn_write},
+    {"任意位置掉电测试", test_flash_kv_power_loss}
+};
+
+/* 键值存储测试套件 */
+ut_test_suite_t flash_kv_test_suite = {
+    "Flash键值存储测试套件",
+    flash_kv_test_cases,
+    sizeof(flash_kv_test_cases) / sizeof(flash_kv_test_cases[0]),
+    NULL,
+    NULL,
+    flash_kv_test_setup,
+    flash_kv_test_teardown
+};
@@ -0,0 +1,505 @@
+/**
+ * @file test_framebuffer.c
+ * @brief 帧缓冲单元测试
+ *
+ * 该文件测试各像素格式下的裁剪填充、画线、帧缓冲间复制、位图与字符绘制、
+ * 字形缓存和脏矩形刷新。按字处理的结果与逐像素设置的参考结果逐点比较
+ */
+
+#include "unit_test.h"
+#include "framebuffer_api.h"
+#include <string.h>
+
+/* 测试帧缓冲尺寸，宽度不是8和4的倍数 */
+#define FB_TEST_WIDTH       45
+#define FB_TEST_HEIGHT      20
+#define FB_TEST_WORDS       (FRAMEBUFFER_SIZE(FB_TEST_WIDTH, FB_TEST_HEIGHT, FRAMEBUFFER_FORMAT_RGB565) / 4)
+
+/* 字形缓存 */
+#define FB_TEST_GLYPH_SLOT  (5 * 7 * 2)
+#define FB_TEST_GLYPH_SLOTS 2
+
+static uint32_t fb_memory[FB_TEST_WORDS];
+static uint32_t fb_ref_memory[FB_TEST_WORDS];
+static uint32_t fb_glyph_memory[(FB_TEST_GLYPH_SLOT * FB_TEST_GLYPH_SLOTS + 3) / 4];
+
+static framebuffer_t fb;
+static framebuffer_t fb_ref;
+
+/* 5x7字体，字符'0'到'2' */
+static const uint8_t fb_font_data[] = {
+    0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E,
+    0x04, 0x06, 0x04, 0x04, 0x04, 0x04, 0x0E,
+    0x0E, 0x11, 0x10, 0x08, 0x04, 0x02, 0x1F
+};
+
+static const framebuffer_font_t fb_font = {5, 7, 1, '0', '2', fb_font_data};
+
+/* 刷新回调记录 */
+static framebuffer_rect_t flush_area;
+static const void *flush_data;
+static uint32_t flush_stride;
+static uint32_t flush_count;
+static int flush_result;
+
+static int test_flush(void *context, const framebuffer_rect_t *area, const void *data, uint32_t stride)
+{
+    (void)context;
+
+    flush_area = *area;
+    flush_data = data;
+    flush_stride = stride;
+    flush_count++;
+    return flush_result;
+}
+
+/* 按格式初始化帧缓冲，glyphs为true时启用字形缓存 */
+static int fb_setup(framebuffer_t *target, uint32_t *memory, framebuffer_format_t format, bool glyphs)
+{
+    framebuffer_config_t config;
+
+    memset(&config, 0, sizeof(config));
+    config.width = FB_TEST_WIDTH;
+    config.height = FB_TEST_HEIGHT;
+    config.format = format;
+    config.memory = memory;
+    config.memory_size = FB_TEST_WORDS * 4;
+    config.flush = test_flush;
+    if (glyphs) {
+        config.glyph_cache = fb_glyph_memory;
+        config.glyph_cache_size = sizeof(fb_glyph_memory);
+        config.glyph_slot_size = FB_TEST_GLYPH_SLOT;
+    }
+
+    flush_count = 0;
+    flush_result = 0;
+    memset(memory, 0x5A, FB_TEST_WORDS * 4);
+    return framebuffer_init(target, &config);
+}
+
+/* 两个帧缓冲的像素是否全部相同 */
+static bool fb_equal(const framebuffer_t *a, const framebuffer_t *b)
+{
+    for (int16_t y = 0; y < FB_TEST_HEIGHT; y++) {
+        for (int16_t x = 0; x < FB_TEST_WIDTH; x++) {
+            uint32_t pa;
+            uint32_t pb;
+
+            framebuffer_get_pixel(a, x, y, &pa);
+            framebuffer_get_pixel(b, x, y, &pb);
+            if (pa != pb) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/* 逐像素设置的参考矩形填充 */
+static void fb_ref_fill(framebuffer_t *target, int16_t x, int16_t y, int16_t width, int16_t height, uint32_t color)
+{
+    for (int16_t j = y; j < y + height; j++) {
+        for (int16_t i = x; i < x + width; i++) {
+            framebuffer_set_pixel(target, i, j, color);
+        }
+    }
+}
+
+/* 以伪随机内容填满帧缓冲 */
+static void fb_scramble(framebuffer_t *target, uint32_t seed)
+{
+    for (int16_t y = 0; y < FB_TEST_HEIGHT; y++) {
+        for (int16_t x = 0; x < FB_TEST_WIDTH; x++) {
+            seed = seed * 1103515245U + 12345U;
+            framebuffer_set_pixel(target, x, y, (seed >> 16) & 0xFFFF);
+        }
+    }
+}
+
+/* 测试初始化参数检查 */
+static void test_framebuffer_init(void)
+{
+    framebuffer_config_t config;
+
+    UT_ASSERT_EQUAL_INT(FRAMEBUFFER_OK, fb_setup(&fb, fb_memory, FRAMEBUFFER_FORMAT_MONO, false));
+    UT_ASSERT_EQUAL_INT(8, fb.stride);
+    UT_ASSERT_EQUAL_INT(FRAMEBUFFER_OK, fb_setup(&fb, fb_memory, FRAMEBUFFER_FORMAT_GRAY8, false));
+    UT_ASSERT_EQUAL_INT(48, fb.stride);
+    UT_ASSERT_EQUAL_INT(FRAMEBUFFER_OK, fb_setup(&fb, fb_memory, FRAMEBUFFER_FORMAT_RGB565, true));
+    UT_ASSERT_EQUAL_INT(92, fb.stride);
+    UT_ASSERT_EQUAL_INT(FB_TEST_GLYPH_SLOTS, fb.glyph_count);
+
+    config = fb.config;
+    config.memory_size = FRAMEBUFFER_SIZE(FB_TEST_WIDTH, FB_TEST_HEIGHT, FRAMEBUFFER_FORMAT_RGB565) - 1;
+    UT_ASSERT_EQUAL_INT(FRAMEBUFFER_NO_MEMORY, framebuffer_init(&fb, &config));
+
+    config = fb.config;
+    config.memory = (uint8_t *)fb_memory + 2;
+    UT_ASSERT_EQUAL_INT(FRAMEBUFFER_INVALID_PARAM, framebuffer_init(&fb, &config));
+
+    UT_ASSERT_EQUAL_INT(FRAMEBUFFER_INVALID_PARAM, framebuffer_init(&fb, NULL));
+}
+
+/* 测试各格式下的矩形填充与裁剪 */
+static void test_framebuffer_fill(void)
+{
+    static const framebuffer_format_t formats[] = {
+        FRAMEBUFFER_FORMAT_MONO, FRAMEBUFFER_FORMAT_GRAY8, FRAMEBUFFER_FORMAT_RGB565
+    };
+    static const uint32_t colors[] = {1, 0xA5, 0xF81F};
+    framebuffer_rect_t clip = {3, 2, 37, 15};
+
+    for (uint32_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+        fb_setup(&fb, fb_memory, formats[f], false);
+        fb_setup(&fb_ref, fb_ref_memory, formats[f], false);
+        framebuffer_fill(&fb, 0);
+        fb_ref_fill(&fb_ref, 0, 0, FB_TEST_WIDTH, FB_TEST_HEIGHT, 0);
+        UT_ASSERT(fb_equal(&fb, &fb_ref));
+
+        /* 不同起点和宽度覆盖字首字尾的各种情况 */
+        for (int16_t x = -3; x < 12; x++) {
+            framebuffer_fill_rect(&fb, x, (int16_t)(x + 3), (uint16_t)(x * 3 + 9), 2, colors[f]);
+            fb_ref_fill(&fb_ref, x, (int16_t)(x + 3), (int16_t)(x * 3 + 9), 2, colors[f]);
+        }
+        UT_ASSERT(fb_equal(&fb, &fb_ref));
+
+        /* 裁剪区域内填充，区域外不变 */
+        framebuffer_set_clip(&fb, &clip);
+        framebuffer_set_clip(&fb_ref, &clip);
+        framebuffer_fill(&fb, 0);
+        fb_ref_fill(&fb_ref, 3, 2, 37, 15, 0);
+        framebuffer_fill_rect(&fb, -10, -10, 100, 14, colors[f]);
+        fb_ref_fill(&fb_ref, 3, 2, 37, 2, colors[f]);
+        framebuffer_set_clip(&fb, NULL);
+        framebuffer_set_clip(&fb_ref, NULL);
+        UT_ASSERT(fb_equal(&fb, &fb_ref));
+
+        /* 脏矩形为所有填充区域的并集 */
+        fb.dirty_x0 = 0;
+        fb.dirty_x1 = 0;
+        framebuffer_fill_rect(&fb, 40, 1, 20, 2, colors[f]);
+        framebuffer_fill_rect(&fb, 5, 10, 3, 1, colors[f]);
+        UT_ASSERT_EQUAL_INT(5, fb.dirty_x0);
+        UT_ASSERT_EQUAL_INT(1, fb.dirty_y0);
+        UT_ASSERT_EQUAL_INT(FB_TEST_WIDTH, fb.dirty_x1);
+        UT_ASSERT_EQUAL_INT(11, fb.dirty_y1);
+    }
+
+    /* 16位格式按CPU字节序存放 */
+    fb_setup(&fb, fb_memory, FRAMEBUFFER_FORMAT_RGB565, false);
+    framebuffer_fill_rect(&fb, 1, 0, 4, 1, 0x1234);
+    UT_ASSERT_EQUAL_INT(0x1234, ((const uint16_t *)(const void *)fb.pixels)[3]);
+    UT_ASSERT_EQUAL_INT(0x5A5A, ((const uint16_t *)(const void *)fb.pixels)[5]);
+}
+
+/* 测试画线和矩形边框 */
+static void test_framebuffer_line(void)
+{
+    framebuffer_rect_t clip = {2, 2, 30, 12};
+
+    fb_setup(&fb, fb_memory, FRAMEBUFFER_FORMAT_MONO, false);
+    fb_setup(&fb_ref, fb_ref_memory, FRAMEBUFFER_FORMAT_MONO, false);
+    framebuffer_fill(&fb, 0);
+    framebuffer_fill(&fb_ref, 0);
+
+    /* 水平和竖直线 */
+    framebuffer_draw_line(&fb, 30, 4, 3, 4, 1);
+    fb_ref_fill(&fb_ref, 3, 4, 28, 1, 1);
+    framebuffer_draw_line(&fb, 9, 19, 9, 0, 1);
+    fb_ref_fill(&fb_ref, 9, 0, 1, 20, 1);
+    UT_ASSERT(fb_equal(&fb, &fb_ref));
+
+    /* 对角线两端点都被绘制 */
+    framebuffer_draw_line(&fb, 20, 0, 39, 19, 1);
+    for (int16_t i = 0; i < 20; i++) {
+        framebuffer_set_pixel(&fb_ref, (int16_t)(20 + i), i, 1);
+    }
+    UT_ASSERT(fb_equal(&fb, &fb_ref));
+
+    /* 斜线：每列恰好一个像素，端点正确 */
+    framebuffer_fill(&fb, 0);
+    framebuffer_draw_line(&fb, 0, 0, 44, 10, 1);
+    for (int16_t x = 0; x < FB_TEST_WIDTH; x++) {
+        uint32_t count = 0;
+
+        for (int16_t y = 0; y < FB_TEST_HEIGHT; y++) {
+            uint32_t pixel;
+            framebuffer_get_pixel(&fb, x, y, &pixel);
+            count += pixel;
+        }
+        UT_ASSERT_EQUAL_INT(1, count);
+    }
+
+    /* 裁剪后只保留区域内的点 */
+    framebuffer_fill(&fb, 0);
+    fb_setup(&fb_ref, fb_ref_memory, FRAMEBUFFER_FORMAT_MONO, false);
+    framebuffer_fill(&fb_ref, 0);
+    framebuffer_draw_line(&fb_ref, -5, -3, 50, 25, 1);
+    framebuffer_set_clip(&fb, &clip);
+    framebuffer_draw_line(&fb, -5, -3, 50, 25, 1);
+    framebuffer_set_clip(&fb, NULL);
+    for (int16_t y = 0; y < FB_TEST_HEIGHT; y++) {
+        for (int16_t x = 0; x < FB_TEST_WIDTH; x++) {
+            uint32_t pixel;
+            uint32_t expected;
+
+            framebuffer_get_pixel(&fb, x, y, &pixel);
+            framebuffer_get_pixel(&fb_ref, x, y, &expected);
+            if (x < 2 || x >= 32 || y < 2 || y >= 14) {
+                expected = 0;
+            }
+            UT_ASSERT_EQUAL_INT(expected, pixel);
+        }
+    }
+
+    /* 矩形边框 */
+    fb_setup(&fb, fb_memory, FRAMEBUFFER_FORMAT_GRAY8, false);
+    fb_setup(&fb_ref, fb_ref_memory, FRAMEBUFFER_FORMAT_GRAY8, false);
+    framebuffer_fill(&fb, 0);
+    framebuffer_fill(&fb_ref, 0);
+    framebuffer_draw_rect(&fb, 5, 3, 10, 6, 7);
+    fb_ref_fill(&fb_ref, 5, 3, 10, 6, 7);
+    fb_ref_fill(&fb_ref, 6, 4, 8, 4, 0);
+    UT_ASSERT(fb_equal(&fb, &fb_ref));
+}
+
+/* 测试帧缓冲间复制 */
+static void test_framebuffer_blit(void)
+{
+    static const framebuffer_format_t formats[] = {
+        FRAMEBUFFER_FORMAT_MONO, FRAMEBUFFER_FORMAT_RGB565
+    };
+    static const int16_t offsets[][2] = {
+        {0, 0}, {3, 5}, {8, 16}, {5, 1}, {13, 2}, {-4, 7}
+    };
+
+    for (uint32_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+        for (uint32_t n = 0; n < sizeof(offsets) / sizeof(offsets[0]); n++) {
+            int16_t dx = offsets[n][0];
+            int16_t sx = offsets[n][1];
+            framebuffer_rect_t rect = {sx, 3, 30, 9};
+
+            /* 源帧缓冲 */
+            fb_setup(&fb_ref, fb_ref_memory, formats[f], false);
+            fb_scramble(&fb_ref, 7 + n);
+
+            fb_setup(&fb, fb_memory, formats[f], false);
+            framebuffer_fill(&fb, 0);
+            UT_ASSERT_EQUAL_INT(FRAMEBUFFER_OK, framebuffer_blit(&fb, dx, 6, &fb_ref, &rect));
+
+            for (int16_t y = 0; y < FB_TEST_HEIGHT; y++) {
+                for (int16_t x = 0; x < FB_TEST_WIDTH; x++) {
+                    uint32_t pixel;
+                    uint32_t expected = 0;
+
+                    if (x >= dx && x < dx + 30 && y >= 6 && y < 15 && x - dx + sx < FB_TEST_WIDTH) {
+                        framebuffer_get_pixel(&fb_ref, (int16_t)(x - dx + sx), (int16_t)(y - 3), &expected);
+                    }
+                    framebuffer_get_pixel(&fb, x, y, &pixel);
+                    UT_ASSERT_EQUAL_INT(expected, pixel);
+                }
+            }
+        }
+    }
+
+    /* 同一帧缓冲内向右下和左上重叠移动 */
+    for (uint32_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+        static const int16_t moves[][2] = {{3, 0}, {-5, 0}, {2, 3}, {-9, -2}};
+
+        for (uint32_t n = 0; n < sizeof(moves) / sizeof(moves[0]); n++) {
+            framebuffer_rect_t rect = {10, 4, 25, 12};
+            int16_t tx = (int16_t)(10 + moves[n][0]);
+            int16_t ty = (int16_t)(4 + moves[n][1]);
+
+            fb_setup(&fb, fb_memory, formats[f], false);
+            fb_setup(&fb_ref, fb_ref_memory, formats[f], false);
+            fb_scramble(&fb, 100 + n);
+            fb_scramble(&fb_ref, 100 + n);
+
+            UT_ASSERT_EQUAL_INT(FRAMEBUFFER_OK, framebuffer_blit(&fb, tx, ty, &fb, &rect));
+
+            for (int16_t y = 0; y < FB_TEST_HEIGHT; y++) {
+                for (int16_t x = 0; x < FB_TEST_WIDTH; x++) {
+                    uint32_t pixel;
+                    uint32_t expected;
+
+                    if (x >= tx && x < tx + 25 && y >= ty && y < ty + 12) {
+                        framebuffer_get_pixel(&fb_ref, (int16_t)(x - tx + 10), (int16_t)(y - ty + 4), &expected);
+                    } else {
+                        framebuffer_get_pixel(&fb_ref, x, y, &expected);
+                    }
+                    framebuffer_get_pixel(&fb, x, y, &pixel);
+                    UT_ASSERT_EQUAL_INT(expected, pixel);
+                }
+            }
+        }
+    }
+
+    /* 格式不同时不支持 */
+    fb_setup(&fb, fb_memory, FRAMEBUFFER_FORMAT_MONO, false);
+    fb_setup(&fb_ref, fb_ref_memory, FRAMEBUFFER_FORMAT_GRAY8, false);
+    UT_ASSERT_EQUAL_INT(FRAMEBUFFER_NOT_SUPPORTED, framebuffer_blit(&fb, 0, 0, &fb_ref, NULL));
+}
+
+/* 测试位图绘制 */
+static void test_framebuffer_bitmap(void)
+{
+    static const framebuffer_format_t formats[] = {
+        FRAMEBUFFER_FORMAT_MONO, FRAMEBUFFER_FORMAT_GRAY8, FRAMEBUFFER_FORMAT_RGB565
+    };
+    static const uint32_t colors[][2] = {
+        {1, 0}, {0, 1}, {1, FRAMEBUFFER_TRANSPARENT}, {0, FRAMEBUFFER_TRANSPARENT}
+    };
+    uint8_t bitmap[3 * 11];
+
+    for (uint32_t i = 0; i < sizeof(bitmap); i++) {
+        bitmap[i] = (uint8_t)(i * 37 + 11);
+    }
+
+    for (uint32_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+        for (uint32_t c = 0; c < sizeof(colors) / sizeof(colors[0]); c++) {
+            for (int16_t x = -2; x < 12; x += 3) {
+                uint32_t color = colors[c][0];
+                uint32_t bg_color = colors[c][1];
+
+                fb_setup(&fb, fb_memory, formats[f], false);
+                fb_setup(&fb_ref, fb_ref_memory, formats[f], false);
+                fb_scramble(&fb, 3);
+                fb_scramble(&fb_ref, 3);
+
+                framebuffer_draw_bitmap(&fb, x, 12, 21, 11, bitmap, color, bg_color);
+
+                for (int16_t row = 0; row < 11; row++) {
+                    for (int16_t col = 0; col < 21; col++) {
+                        if ((bitmap[row * 3 + col / 8] >> (col % 8)) & 1) {
+                            framebuffer_set_pixel(&fb_ref, (int16_t)(x + col), (int16_t)(12 + row), color);
+                        } else if (bg_color != FRAMEBUFFER_TRANSPARENT) {
+                            framebuffer_set_pixel(&fb_ref, (int16_t)(x + col), (int16_t)(12 + row), bg_color);
+                        }
+                    }
+                }
+                UT_ASSERT(fb_equal(&fb, &fb_ref));
+            }
+        }
+    }
+}
+
+/* 测试字符绘制与字形缓存 */
+static void test_framebuffer_glyph(void)
+{
+    framebuffer_stats_t stats;
+
+    /* 有缓存与无缓存结果一致 */
+    fb_setup(&fb, fb_memory, FRAMEBUFFER_FORMAT_RGB565, true);
+    fb_setup(&fb_ref, fb_ref_memory, FRAMEBUFFER_FORMAT_RGB565, false);
+    framebuffer_fill(&fb, 0);
+    framebuffer_fill(&fb_ref, 0);
+
+    UT_ASSERT_EQUAL_INT(FRAMEBUFFER_OK, framebuffer_draw_string(&fb, -2, 1, &fb_font, "0120\n21", 0xFFFF, 0x001F));
+    framebuffer_draw_string(&fb_ref, -2, 1, &fb_font, "0120\n21", 0xFFFF, 0x001F);
+    UT_ASSERT(fb_equal(&fb, &fb_ref));
+
+    /* 只有两项时按最久未用淘汰，只有第二行的'2'命中 */
+    framebuffer_get_stats(&fb, &stats);
+    UT_ASSERT_EQUAL_INT(1, stats.glyph_hits);
+    UT_ASSERT_EQUAL_INT(5, stats.glyph_misses);
+
+    /* 颜色不同时重新渲染 */
+    framebuffer_draw_char(&fb, 40, 15, &fb_font, '1', 0x07E0, 0x001F);
+    framebuffer_draw_char(&fb_ref, 40, 15, &fb_font, '1', 0x07E0, 0x001F);
+    framebuffer_draw_char(&fb, 20, 15, &fb_font, '1', 0x07E0, 0x001F);
+    framebuffer_draw_char(&fb_ref, 20, 15, &fb_font, '1', 0x07E0, 0x001F);
+    UT_ASSERT(fb_equal(&fb, &fb_ref));
+    framebuffer_get_stats(&fb, &stats);
+    UT_ASSERT_EQUAL_INT(6, stats.glyph_misses);
+    UT_ASSERT_EQUAL_INT(2, stats.glyph_hits);
+
+    /* 透明背景不经过缓存 */
+    framebuffer_draw_char(&fb, 10, 10, &fb_font, '2', 0xF800, FRAMEBUFFER_TRANSPARENT);
+    framebuffer_draw_char(&fb_ref, 10, 10, &fb_font, '2', 0xF800, FRAMEBUFFER_TRANSPARENT);
+    UT_ASSERT(fb_equal(&fb, &fb_ref));
+    framebuffer_get_stats(&fb, &stats);
+    UT_ASSERT_EQUAL_INT(8, stats.glyph_hits + stats.glyph_misses);
+
+    /* 单色格式与逐点绘制一致，超出字体范围的字符返回错误 */
+    fb_setup(&fb, fb_memory, FRAMEBUFFER_FORMAT_MONO, false);
+    fb_setup(&fb_ref, fb_ref_memory, FRAMEBUFFER_FORMAT_MONO, false);
+    framebuffer_fill(&fb, 0);
+    framebuffer_fill(&fb_ref, 0);
+    framebuffer_draw_char(&fb, 3, 2, &fb_font, '2', 1, 0);
+    for (int16_t row = 0; row < 7; row++) {
+        for (int16_t col = 0; col < 5; col++) {
+            framebuffer_set_pixel(&fb_ref, (int16_t)(3 + col), (int16_t)(2 + row), (fb_font_data[14 + row] >> col) & 1);
+        }
+    }
+    UT_ASSERT(fb_equal(&fb, &fb_ref));
+    UT_ASSERT_EQUAL_INT(FRAMEBUFFER_INVALID_PARAM, framebuffer_draw_char(&fb, 0, 0, &fb_font, 'A', 1, 0));
+}
+
+/* 测试脏矩形刷新 */
+static void test_framebuffer_flush(void)
+{
+    framebuffer_stats_t stats;
+
+    /* 单色格式区域按8像素对齐，右边界截断 */
+    fb_setup(&fb, fb_memory, FRAMEBUFFER_FORMAT_MONO, false);
+    UT_ASSERT_EQUAL_INT(FRAMEBUFFER_OK, framebuffer_flush(&fb));
+    UT_ASSERT_EQUAL_INT(0, flush_count);
+
+    framebuffer_set_pixel(&fb, 11, 3, 1);
+    framebuffer_fill_rect(&fb, 30, 5, 20, 2, 1);
+    UT_ASSERT_EQUAL_INT(FRAMEBUFFER_OK, framebuffer_flush(&fb));
+    UT_ASSERT_EQUAL_INT(1, flush_count);
+    UT_ASSERT_EQUAL_INT(8, flush_area.x);
+    UT_ASSERT_EQUAL_INT(3, flush_area.y);
+    UT_ASSERT_EQUAL_INT(37, flush_area.width);
+    UT_ASSERT_EQUAL_INT(4, flush_area.height);
+    UT_ASSERT(flush_data == fb.pixels + 3 * 8 + 1);
+    UT_ASSERT_EQUAL_INT(8, flush_stride);
+
+    /* 刷新后没有脏区域 */
+    UT_ASSERT_EQUAL_INT(FRAMEBUFFER_OK, framebuffer_flush(&fb));
+    UT_ASSERT_EQUAL_INT(1, flush_count);
+
+    /* 16位格式，失败后保留脏区域 */
+    fb_setup(&fb, fb_memory, FRAMEBUFFER_FORMAT_RGB565, false);
+    framebuffer_fill_rect(&fb, 5, 7, 3, 2, 0x1234);
+    flush_result = -1;
+    UT_ASSERT_EQUAL_INT(FRAMEBUFFER_FLUSH_ERROR, framebuffer_flush(&fb));
+    flush_result = 0;
+    UT_ASSERT_EQUAL_INT(FRAMEBUFFER_OK, framebuffer_flush(&fb));
+    UT_ASSERT_EQUAL_INT(2, flush_count);
+    UT_ASSERT_EQUAL_INT(5, flush_area.x);
+    UT_ASSERT_EQUAL_INT(7, flush_area.y);
+    UT_ASSERT_EQUAL_INT(3, flush_area.width);
+    UT_ASSERT_EQUAL_INT(2, flush_area.height);
+    UT_ASSERT(flush_data == fb.pixels + 7 * 92 + 10);
+
+    framebuffer_invalidate(&fb);
+    framebuffer_flush(&fb);
+    framebuffer_get_stats(&fb, &stats);
+    UT_ASSERT_EQUAL_INT(2, stats.flushes);
+    UT_ASSERT_EQUAL_INT(6 + FB_TEST_WIDTH * FB_TEST_HEIGHT, stats.flushed_pixels);
+}
+
+/* 帧缓冲测试案例 */
+static ut_test_case_t framebuffer_test_cases[] = {
+    {"初始化测试", test_framebuffer_init},
+    {"裁剪填充测试", test_framebuffer_fill},
+    {"画线测试", test_framebuffer_line},
+    {"帧缓冲复制测试", test_framebuffer_blit},
+    {"位图绘制测试", test_framebuffer_bitmap},
+    {"字形缓存测试", test_framebuffer_glyph},
+    {"脏矩形刷新测试", test_framebuffer_flush}
+};
+
+/* 帧缓冲测试套件 */
+ut_test_suite_t framebuffer_test_suite = {
+    "帧缓冲测试套件",
+    framebuffer_test_cases,
+    sizeof(framebuffer_test_cases) / sizeof(framebuffer_test_cases[0]),
+    NULL,
+    NULL,
+    NULL,
+    NULL
+};
@@ -0,0 +1,230 @@
+/**
+ * @file test_host_flash.c
+ * @brief 主机Flash模拟器单元测试
+ *
+ * 该文件测试模拟器的NOR编程语义、时序与擦除次数模型、掉电注入和文件映射
+ */
+
+#include "unit_test.h"
+#include "host_flash_api.h"
+#include <stdio.h>
+#include <string.h>
+
+/* 文件映射测试使用的文件 */
+#define HOST_FLASH_TEST_FILE    "host_flash_test.bin"
+
+/* Flash设备句柄 */
+static flash_handle_t test_flash = NULL;
+
+/* 扇区大小 */
+static uint32_t test_sector_size = 0;
+
+/**
+ * @brief 测试NOR编程语义
+ */
+static void test_host_flash_nor_semantics(void)
+{
+    static const uint32_t pattern[2] = {0x12345678, 0x0F0F0F0F};
+    uint32_t value[2];
+    uint32_t word;
+    host_flash_stats_t stats;
+
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_read(test_flash, 0, value, sizeof(value)));
+    UT_ASSERT_EQUAL_INT(0xFFFFFFFF, value[0]);
+
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_write(test_flash, 0, pattern, sizeof(pattern)));
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_read(test_flash, 0, value, sizeof(value)));
+    UT_ASSERT_EQUAL_INT(0x12345678, value[0]);
+    UT_ASSERT_EQUAL_INT(0x0F0F0F0F, value[1]);
+
+    /* 只清零位的重复编程允许 */
+    word = 0x02040608;
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_write(test_flash, 0, &word, sizeof(word)));
+
+    /* 需要把0写为1的编程被拒绝且不修改内容 */
+    word = 0xF0F0F0F0;
+    UT_ASSERT_EQUAL_INT(ERROR_IO, flash_write(test_flash, 4, &word, sizeof(word)));
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_read(test_flash, 4, &word, sizeof(word)));
+    UT_ASSERT_EQUAL_INT(0x0F0F0F0F, word);
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, host_flash_get_stats(&stats));
+    UT_ASSERT_EQUAL_INT(1, stats.violations);
+
+    /* 地址和长度必须字对齐 */
+    UT_ASSERT_EQUAL_INT(ERROR_INVALID_PARAM, flash_write(test_flash, 2, &word, sizeof(word)));
+    UT_ASSERT_EQUAL_INT(ERROR_INVALID_PARAM, flash_write(test_flash, 8, &word, 3));
+
+    /* 擦除整个扇区 */
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_erase_sector(test_flash, 4));
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_read(test_flash, 0, value, sizeof(value)));
+    UT_ASSERT_EQUAL_INT(0xFFFFFFFF, value[0]);
+    UT_ASSERT_EQUAL_INT(0xFFFFFFFF, value[1]);
+}
+
+/**
+ * @brief 测试时序模型和擦除次数
+ */
+static void test_host_flash_timing_wear(void)
+{
+    host_flash_timing_t timing = {0, 1000, 2000, false};
+    host_flash_stats_t stats;
+    uint32_t data[16];
+
+    memset(data, 0, sizeof(data));
+    host_flash_set_timing(&timing);
+
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_write(test_flash, test_sector_size, data, sizeof(data)));
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_erase_sector(test_flash, test_sector_size));
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_erase_sector(test_flash, test_sector_size));
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_erase_sector(test_flash, 2 * test_sector_size));
+
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, host_flash_get_stats(&stats));
+    UT_ASSERT_EQUAL_INT(16, stats.program_words);
+    UT_ASSERT_EQUAL_INT(3, stats.erase_ops);
+    UT_ASSERT(stats.elapsed_ns == 16ULL * 1000 + 3ULL * 2000 * 1000);
+
+    UT_ASSERT_EQUAL_INT(0, host_flash_get_erase_count(0));
+    UT_ASSERT_EQUAL_INT(2, host_flash_get_erase_count(1));
+    UT_ASSERT_EQUAL_INT(1, host_flash_get_erase_count(2));
+    UT_ASSERT_EQUAL_INT(2, stats.max_erase_count);
+}
+
+/**
+ * @brief 测试掉电注入
+ */
+static void test_host_flash_power_loss(void)
+{
+    uint32_t data[4] = {0, 0, 0, 0};
+    uint32_t value[4];
+
+    /* 第3个字编程时掉电 */
+    host_flash_inject_power_loss(3);
+    UT_ASSERT_EQUAL_INT(ERROR_IO, flash_write(test_flash, 0, data, sizeof(data)));
+    UT_ASSERT(host_flash_is_powered_off());
+    UT_ASSERT_EQUAL_INT(ERROR_IO, flash_read(test_flash, 0, value, sizeof(value)));
+
+    /* 重新上电后前两个字完整，第3个字只编程了一半 */
+    flash_deinit(test_flash);
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_init(NULL, NULL, &test_flash));
+    UT_ASSERT(!host_flash_is_powered_off());
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_read(test_flash, 0, value, sizeof(value)));
+    UT_ASSERT_EQUAL_INT(0, value[0]);
+    UT_ASSERT_EQUAL_INT(0, value[1]);
+    UT_ASSERT(value[2] != 0 && value[2] != 0xFFFFFFFF);
+    UT_ASSERT_EQUAL_INT(0xFFFFFFFF, value[3]);
+
+    /* 擦除时掉电，扇区只有一部分被擦除 */
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_write(test_flash, test_sector_size - 4, data, 4));
+    host_flash_inject_power_loss(1);
+    UT_ASSERT_EQUAL_INT(ERROR_IO, flash_erase_sector(test_flash, 0));
+    flash_deinit(test_flash);
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_init(NULL, NULL, &test_flash));
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_read(test_flash, 0, value, sizeof(value)));
+    UT_ASSERT_EQUAL_INT(0xFFFFFFFF, value[0]);
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_read(test_flash, test_sector_size - 4, value, 4));
+    UT_ASSERT_EQUAL_INT(0, value[0]);
+}
+
+/**
+ * @brief 测试不对齐的顺序写入
+ */
+static void test_host_flash_stream(void)
+{
+    uint8_t data[16];
+    uint8_t value[24];
+    uint32_t i;
+
+    for (i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)i;
+    }
+
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_write_begin(test_flash, 3));
+    UT_ASSERT_EQUAL_INT(ERROR_BUSY, flash_write_begin(test_flash, 3));
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_write_stream(test_flash, data, 1));
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_write_stream(test_flash, &data[1], 10));
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_write_stream(test_flash, &data[11], 5));
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_write_end(test_flash));
+
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_read(test_flash, 0, value, sizeof(value)));
+    UT_ASSERT_EQUAL_INT(0xFF, value[2]);
+    UT_ASSERT(memcmp(&value[3], data, sizeof(data)) == 0);
+    UT_ASSERT_EQUAL_INT(0xFF, value[19]);
+}
+
+/**
+ * @brief 测试文件映射存储
+ */
+static void test_host_flash_file(void)
+{
+    uint32_t word = 0xA5A5A5A5;
+    uint32_t value = 0;
+
+    remove(HOST_FLASH_TEST_FILE);
+
+    /* 初始化状态下不能切换存储 */
+    UT_ASSERT_EQUAL_INT(ERROR_BUSY, host_flash_open_file(HOST_FLASH_TEST_FILE));
+
+    flash_deinit(test_flash);
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, host_flash_open_file(HOST_FLASH_TEST_FILE));
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_init(NULL, NULL, &test_flash));
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_read(test_flash, 64, &value, sizeof(value)));
+    UT_ASSERT_EQUAL_INT(0xFFFFFFFF, value);
+    UT_ASSERT_EQUAL_INT(0, host_flash_get_erase_count(2));
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_erase_sector(test_flash, 2 * test_sector_size));
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_erase_sector(test_flash, 2 * test_sector_size));
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_write(test_flash, 64, &word, sizeof(word)));
+    flash_deinit(test_flash);
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, host_flash_close_file());
+
+    /* 内存存储的擦除次数不写入文件 */
+    host_flash_format();
+
+    /* 重新映射后内容和擦除次数保留 */
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, host_flash_open_file(HOST_FLASH_TEST_FILE));
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_init(NULL, NULL, &test_flash));
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, flash_read(test_flash, 64, &value, sizeof(value)));
+    UT_ASSERT_EQUAL_INT(0xA5A5A5A5, value);
+    UT_ASSERT_EQUAL_INT(2, host_flash_get_erase_count(2));
+    UT_ASSERT_EQUAL_INT(0, host_flash_get_erase_count(3));
+    flash_deinit(test_flash);
+    UT_ASSERT_EQUAL_INT(DRIVER_OK, host_flash_close_file());
+
+    remove(HOST_FLASH_TEST_FILE);
+    flash_init(NULL, NULL, &test_flash);
+}
+
+/* 每个测试案例从全新擦除的存储开始 */
+static void host_flash_test_setup(void)
+{
+    host_flash_format();
+    flash_init(NULL, NULL, &test_flash);
+    flash_get_info(test_flash, NULL, &test_sector_size, NULL);
+}
+
+/* 测试案例清理，恢复默认模型 */
+static void host_flash_test_teardown(void)
+{
+    host_flash_inject_power_loss(0);
+    host_flash_set_timing(NULL);
+    flash_deinit(test_flash);
+    test_flash = NULL;
+}
+
+/* 主机Flash模拟器测试案例 */
+static ut_test_case_t host_flash_test_cases[] = {
+    {"NOR编程语义测试", test_host_flash_nor_semantics},
+    {"时序与擦除次数测试", test_host_flash_timing_wear},
+    {"掉电注入测试", test_host_flash_power_loss},
+    {"顺序写入测试", test_host_flash_stream},
+    {"文件映射测试", test_host_flash_file}
+};
+
+/* 主机Flash模拟器测试套件 */
+ut_test_suite_t host_flash_test_suite = {
+    "主机Flash模拟器测试套件",
+    host_flash_test_cases,
+    sizeof(host_flash_test_cases) / sizeof(host_flash_test_cases[0]),
+    NULL,
+    NULL,
+    host_flash_test_setup,
+    host_flash_test_teardown
+};
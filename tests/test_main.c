@@ -7,18 +7,52 @@
 
 #include "unit_test.h"
 #include <stdio.h>
+#include <stdlib.h>
 
 /* 导入测试套件 */
 extern ut_test_suite_t adc_test_suite;
 extern ut_test_suite_t pwm_test_suite;
+extern ut_test_suite_t bench_test_suite;
+extern ut_test_suite_t flash_kv_test_suite;
+extern ut_test_suite_t host_flash_test_suite;
+extern ut_test_suite_t flash_fs_test_suite;
+extern ut_test_suite_t tm1681_test_suite;
+extern ut_test_suite_t framebuffer_test_suite;
+extern ut_test_suite_t sensor_stream_test_suite;
+extern ut_test_suite_t block_cache_test_suite;
+#ifdef CONFIG_TIMER_WHEEL_ENABLED
+extern ut_test_suite_t timer_wheel_test_suite;
+#endif
+#ifdef CONFIG_DSP_BLOCK_ENABLED
+extern ut_test_suite_t dsp_block_test_suite;
+#endif
 extern int test_power(void);
 
 /* 所有测试套件 */
 static ut_test_suite_t *all_test_suites[] = {
     &adc_test_suite,
-    &pwm_test_suite
+    &pwm_test_suite,
+    &bench_test_suite,
+    &flash_kv_test_suite,
+    &host_flash_test_suite,
+    &flash_fs_test_suite,
+    &tm1681_test_suite,
+    &framebuffer_test_suite,
+    &sensor_stream_test_suite,
+    &block_cache_test_suite,
+#ifdef CONFIG_TIMER_WHEEL_ENABLED
+    &timer_wheel_test_suite,
+#endif
+#ifdef CONFIG_DSP_BLOCK_ENABLED
+    &dsp_block_test_suite,
+#endif
 };
 
+/* 基准结果输出与基线比较，由环境变量指定路径，允许10%的波动 */
+#define BENCH_OUTPUT_ENV        "UT_BENCH_OUTPUT"
+#define BENCH_BASELINE_ENV      "UT_BENCH_BASELINE"
+#define BENCH_TOLERANCE         0.10
+
 /**
  * @brief 单元测试主函数
  * 
@@ -27,17 +61,43 @@ static ut_test_suite_t *all_test_suites[] = {
 int main(void)
 {
     int ret;
+    unsigned int i;
+    ut_statistics_t stats;
     
     /* 打印测试标题 */
     printf("\n");
     printf("==================================================\n");
     printf("          嵌入式设备软件架构单元测试              \n");
     printf("==================================================\n");
-      /* 运行所有测试套件 */
-    ret = ut_run_suites(all_test_suites, sizeof(all_test_suites) / sizeof(all_test_suites[0]));
+    
+    /* 运行所有测试套件，套件以指针数组登记，逐个运行 */
+    ut_init_statistics(&stats);
+    for (i = 0; i < sizeof(all_test_suites) / sizeof(all_test_suites[0]); i++) {
+        ut_run_suite(all_test_suites[i], &stats);
+    }
+    ut_print_statistics(&stats);
+    ret = (stats.failed_cases > 0) ? 1 : 0;
     
     /* 运行电源管理测试 */
     test_power();
     
+    /* 输出基准结果，未指定文件时输出到标准输出 */
+    {
+        const char *output_path = getenv(BENCH_OUTPUT_ENV);
+        const char *baseline_path = getenv(BENCH_BASELINE_ENV);
+        FILE *out = (output_path != NULL) ? fopen(output_path, "w") : stdout;
+        
+        if (out != NULL) {
+            ut_bench_write_json(out);
+            if (out != stdout) {
+                fclose(out);
+            }
+        }
+        
+        if (baseline_path != NULL && ut_bench_compare_baseline(baseline_path, BENCH_TOLERANCE) != 0) {
+            ret = 1;
+        }
+    }
+    
     return ret;
 }
@@ -0,0 +1,226 @@
+/**
+ * @file test_sensor_stream.c
+ * @brief 传感器批量采样流单元测试
+ *
+ * 该文件测试采样流的水位通知、满缓冲丢弃、跨环形缓冲区边界的批量取出、
+ * FIFO突发样本的时间戳回推与周期估计，以及清空后的重新估计
+ */
+
+#include "unit_test.h"
+#include "feature/sensor_stream_api.h"
+#include <string.h>
+
+static sensor_stream_t stream;
+static sensor_sample_t samples[CONFIG_SENSOR_STREAM_DEPTH];
+
+/* 生成以序号标记的样本 */
+static sensor_sample_t make_sample(uint32_t index)
+{
+    sensor_sample_t sample;
+
+    sample.timestamp_us = index;
+    sample.data[0] = (float)index;
+    sample.data[1] = (float)index * 2.0f;
+    sample.data[2] = -(float)index;
+    return sample;
+}
+
+/* 测试初始化参数检查 */
+static void test_sensor_stream_init(void)
+{
+    sensor_batch_stats_t stats;
+
+    UT_ASSERT_EQUAL_INT(SENSOR_STREAM_INVALID_PARAM, sensor_stream_init(NULL, 4, 1000));
+    UT_ASSERT_EQUAL_INT(SENSOR_STREAM_INVALID_PARAM,
+                        sensor_stream_init(&stream, CONFIG_SENSOR_STREAM_DEPTH + 1, 1000));
+    UT_ASSERT_EQUAL_INT(SENSOR_STREAM_OK, sensor_stream_init(&stream, 4, 1000));
+    UT_ASSERT_EQUAL_INT(0, sensor_stream_count(&stream));
+
+    UT_ASSERT_EQUAL_INT(SENSOR_STREAM_OK, sensor_stream_get_stats(&stream, &stats));
+    UT_ASSERT_EQUAL_INT(0, stats.samples);
+    UT_ASSERT_EQUAL_INT(0, stats.dropped);
+    UT_ASSERT_EQUAL_INT(0, stats.bursts);
+}
+
+/* 测试水位只在跨越时通知一次 */
+static void test_sensor_stream_watermark(void)
+{
+    sensor_sample_t sample;
+    uint32_t i;
+
+    sensor_stream_init(&stream, 4, 1000);
+
+    for (i = 0; i < 3; i++) {
+        sample = make_sample(i);
+        UT_ASSERT(!sensor_stream_push(&stream, &sample));
+    }
+    sample = make_sample(3);
+    UT_ASSERT(sensor_stream_push(&stream, &sample));
+
+    /* 未取走前超过水位不重复通知 */
+    sample = make_sample(4);
+    UT_ASSERT(!sensor_stream_push(&stream, &sample));
+    UT_ASSERT_EQUAL_INT(5, sensor_stream_count(&stream));
+
+    /* 取到水位以下后再次跨越时重新通知 */
+    UT_ASSERT_EQUAL_INT(5, sensor_stream_pop(&stream, samples, CONFIG_SENSOR_STREAM_DEPTH));
+    for (i = 0; i < 4; i++) {
+        sample = make_sample(10 + i);
+        UT_ASSERT(sensor_stream_push(&stream, &sample) == (i == 3));
+    }
+
+    /* 水位为0时每个样本都通知 */
+    sensor_stream_init(&stream, 0, 1000);
+    sample = make_sample(0);
+    UT_ASSERT(sensor_stream_push(&stream, &sample));
+}
+
+/* 测试缓冲区满时丢弃新样本，旧样本保持不变 */
+static void test_sensor_stream_overflow(void)
+{
+    sensor_batch_stats_t stats;
+    sensor_sample_t sample;
+    uint32_t i;
+
+    sensor_stream_init(&stream, 0, 1000);
+
+    for (i = 0; i < CONFIG_SENSOR_STREAM_DEPTH + 3; i++) {
+        sample = make_sample(i);
+        sensor_stream_push(&stream, &sample);
+    }
+    UT_ASSERT_EQUAL_INT(CONFIG_SENSOR_STREAM_DEPTH, sensor_stream_count(&stream));
+
+    sensor_stream_get_stats(&stream, &stats);
+    UT_ASSERT_EQUAL_INT(CONFIG_SENSOR_STREAM_DEPTH, stats.samples);
+    UT_ASSERT_EQUAL_INT(3, stats.dropped);
+
+    UT_ASSERT_EQUAL_INT(CONFIG_SENSOR_STREAM_DEPTH,
+                        sensor_stream_pop(&stream, samples, CONFIG_SENSOR_STREAM_DEPTH));
+    UT_ASSERT_EQUAL_INT(0, samples[0].timestamp_us);
+    UT_ASSERT_EQUAL_INT(CONFIG_SENSOR_STREAM_DEPTH - 1, samples[CONFIG_SENSOR_STREAM_DEPTH - 1].timestamp_us);
+    UT_ASSERT_EQUAL_INT(0, sensor_stream_count(&stream));
+}
+
+/* 测试跨越环形缓冲区边界的分段取出 */
+static void test_sensor_stream_wrap(void)
+{
+    sensor_sample_t sample;
+    uint32_t next = 0;
+    uint32_t expect = 0;
+    uint32_t round;
+    uint32_t i;
+
+    sensor_stream_init(&stream, 0, 1000);
+
+    /* 每轮压入和取出的数量与深度互质，读写位置遍历缓冲区各处 */
+    for (round = 0; round < 40; round++) {
+        uint32_t count;
+
+        for (i = 0; i < 37; i++) {
+            sample = make_sample(next++);
+            sensor_stream_push(&stream, &sample);
+        }
+
+        count = sensor_stream_pop(&stream, samples, 29 + (round % 3) * 4);
+        for (i = 0; i < count; i++) {
+            UT_ASSERT_EQUAL_INT(expect, samples[i].timestamp_us);
+            UT_ASSERT(samples[i].data[1] == (float)expect * 2.0f);
+            expect++;
+        }
+    }
+
+    /* 取空剩余样本 */
+    while (sensor_stream_count(&stream) > 0) {
+        uint32_t count = sensor_stream_pop(&stream, samples, 7);
+
+        for (i = 0; i < count; i++) {
+            UT_ASSERT_EQUAL_INT(expect, samples[i].timestamp_us);
+            expect++;
+        }
+    }
+    UT_ASSERT_EQUAL_INT(next, expect);
+}
+
+/* 测试FIFO突发样本的时间戳回推和周期估计 */
+static void test_sensor_stream_fifo(void)
+{
+    sensor_sample_t burst[8];
+    sensor_batch_stats_t stats;
+    uint32_t i;
+
+    sensor_stream_init(&stream, 8, 1000);
+
+    /* 首次突发按标称周期回推 */
+    memset(burst, 0, sizeof(burst));
+    UT_ASSERT(sensor_stream_push_fifo(&stream, burst, 8, 100000));
+    UT_ASSERT_EQUAL_INT(8, sensor_stream_pop(&stream, samples, 8));
+    for (i = 0; i < 8; i++) {
+        UT_ASSERT_EQUAL_INT(100000 - (7 - i) * 1000, samples[i].timestamp_us);
+    }
+
+    /* 实测周期为1080微秒，估计值向其平滑靠拢 */
+    memset(burst, 0, sizeof(burst));
+    sensor_stream_push_fifo(&stream, burst, 8, 100000 + 8 * 1080);
+    UT_ASSERT_EQUAL_INT(1010, stream.period_us);
+    UT_ASSERT_EQUAL_INT(8, sensor_stream_pop(&stream, samples, 8));
+    UT_ASSERT_EQUAL_INT(100000 + 8 * 1080, samples[7].timestamp_us);
+    UT_ASSERT_EQUAL_INT(100000 + 8 * 1080 - 7 * 1010, samples[0].timestamp_us);
+
+    for (i = 0; i < 64; i++) {
+        memset(burst, 0, sizeof(burst));
+        sensor_stream_push_fifo(&stream, burst, 8, 100000 + (i + 2) * 8 * 1080);
+        sensor_stream_pop(&stream, samples, 8);
+    }
+    /* 平滑取整后稳定在实测周期以下不足2^3微秒处 */
+    UT_ASSERT(stream.period_us > 1080 - 8 && stream.period_us <= 1080);
+
+    sensor_stream_get_stats(&stream, &stats);
+    UT_ASSERT_EQUAL_INT(66, stats.bursts);
+    UT_ASSERT_EQUAL_INT(66 * 8, stats.samples);
+}
+
+/* 测试清空后重新开始周期估计 */
+static void test_sensor_stream_reset(void)
+{
+    sensor_sample_t burst[4];
+    uint32_t i;
+
+    sensor_stream_init(&stream, 4, 1000);
+    memset(burst, 0, sizeof(burst));
+    sensor_stream_push_fifo(&stream, burst, 4, 50000);
+    UT_ASSERT_EQUAL_INT(4, sensor_stream_count(&stream));
+
+    sensor_stream_reset(&stream, 500);
+    UT_ASSERT_EQUAL_INT(0, sensor_stream_count(&stream));
+    UT_ASSERT_EQUAL_INT(0, sensor_stream_pop(&stream, samples, 4));
+
+    /* 清空后不使用旧的中断时间修正周期 */
+    memset(burst, 0, sizeof(burst));
+    UT_ASSERT(sensor_stream_push_fifo(&stream, burst, 4, 90000));
+    UT_ASSERT_EQUAL_INT(500, stream.period_us);
+    UT_ASSERT_EQUAL_INT(4, sensor_stream_pop(&stream, samples, 4));
+    for (i = 0; i < 4; i++) {
+        UT_ASSERT_EQUAL_INT(90000 - (3 - i) * 500, samples[i].timestamp_us);
+    }
+}
+
+/* 采样流测试案例 */
+static ut_test_case_t sensor_stream_test_cases[] = {
+    {"初始化测试", test_sensor_stream_init},
+    {"水位通知测试", test_sensor_stream_watermark},
+    {"满缓冲丢弃测试", test_sensor_stream_overflow},
+    {"环形回绕测试", test_sensor_stream_wrap},
+    {"FIFO时间戳回推测试", test_sensor_stream_fifo},
+    {"清空测试", test_sensor_stream_reset}
+};
+
+/* 采样流测试套件 */
+ut_test_suite_t sensor_stream_test_suite = {
+    "传感器采样流测试套件",
+    sensor_stream_test_cases,
+    sizeof(sensor_stream_test_cases) / sizeof(sensor_stream_test_cases[0]),
+    NULL,
+    NULL,
+    NULL,
+    NULL
+};
@@ -0,0 +1,247 @@
+/**
+ * @file test_timer_wheel.c
+ * @brief 分层时间轮单元测试
+ *
+ * 该文件测试时间轮的单次定时、周期定时和层间迁移，每调用一次
+ * timer_wheel_process推进一个tick。RTOS环境下测试程序需以
+ * CONFIG_TIMER_WHEEL_MANUAL_TICK编译，避免内核定时器同时推进时间轮
+ */
+
+#include "unit_test.h"
+#include "timer_wheel.h"
+#include "config.h"
+#include <string.h>
+
+#ifdef CONFIG_TIMER_WHEEL_ENABLED
+
+#if (CURRENT_RTOS != RTOS_NONE) && !defined(CONFIG_TIMER_WHEEL_MANUAL_TICK)
+#error "时间轮测试需要CONFIG_TIMER_WHEEL_MANUAL_TICK"
+#endif
+
+/* 测试使用的tick周期（毫秒） */
+#define TW_TEST_TICK_MS     1
+
+/* 回调记录 */
+typedef struct {
+    uint32_t count;         /**< 回调次数 */
+    uint32_t last_tick;     /**< 最近一次回调时的tick */
+    void *last_arg;         /**< 最近一次回调参数 */
+} tw_test_record_t;
+
+/* 当前tick计数，每次推进后加1 */
+static uint32_t tw_test_tick;
+
+/**
+ * @brief 测试回调，记录回调次数与时刻
+ */
+static void tw_test_callback(timer_wheel_timer_t *timer, void *arg)
+{
+    tw_test_record_t *record = (tw_test_record_t *)arg;
+
+    (void)timer;
+
+    record->count++;
+    record->last_tick = tw_test_tick;
+    record->last_arg = arg;
+}
+
+/**
+ * @brief 推进指定数量的tick
+ */
+static void tw_test_advance(uint32_t ticks)
+{
+    while (ticks-- > 0) {
+        tw_test_tick++;
+        timer_wheel_process();
+    }
+}
+
+/**
+ * @brief 测试单次定时器
+ */
+static void test_timer_wheel_one_shot(void)
+{
+    timer_wheel_timer_t timer;
+    tw_test_record_t record;
+
+    memset(&record, 0, sizeof(record));
+    UT_ASSERT_EQUAL_INT(TIMER_WHEEL_OK, timer_wheel_timer_init(&timer, tw_test_callback, &record));
+    UT_ASSERT(!timer_wheel_is_active(&timer));
+
+    UT_ASSERT_EQUAL_INT(TIMER_WHEEL_OK, timer_wheel_start(&timer, 10, 0));
+    UT_ASSERT(timer_wheel_is_active(&timer));
+
+    /* 超时前不回调 */
+    tw_test_advance(9);
+    UT_ASSERT_EQUAL_INT(0, record.count);
+
+    /* 第10次推进时回调一次并回到空闲状态 */
+    tw_test_advance(1);
+    UT_ASSERT_EQUAL_INT(1, record.count);
+    UT_ASSERT_EQUAL_INT(10, record.last_tick);
+    UT_ASSERT(record.last_arg == &record);
+    UT_ASSERT(!timer_wheel_is_active(&timer));
+
+    tw_test_advance(100);
+    UT_ASSERT_EQUAL_INT(1, record.count);
+
+    /* 停止后不再回调 */
+    UT_ASSERT_EQUAL_INT(TIMER_WHEEL_OK, timer_wheel_start(&timer, 5, 0));
+    tw_test_advance(3);
+    UT_ASSERT_EQUAL_INT(TIMER_WHEEL_OK, timer_wheel_stop(&timer));
+    tw_test_advance(10);
+    UT_ASSERT_EQUAL_INT(1, record.count);
+
+    /* 重置后从当前时刻重新计时 */
+    UT_ASSERT_EQUAL_INT(TIMER_WHEEL_OK, timer_wheel_start(&timer, 5, 0));
+    tw_test_advance(4);
+    UT_ASSERT_EQUAL_INT(TIMER_WHEEL_OK, timer_wheel_reset(&timer));
+    tw_test_advance(4);
+    UT_ASSERT_EQUAL_INT(1, record.count);
+    tw_test_advance(1);
+    UT_ASSERT_EQUAL_INT(2, record.count);
+
+    /* 无效参数 */
+    UT_ASSERT_EQUAL_INT(TIMER_WHEEL_INVALID_PARAM, timer_wheel_timer_init(&timer, NULL, NULL));
+    UT_ASSERT_EQUAL_INT(TIMER_WHEEL_INVALID_PARAM, timer_wheel_start(NULL, 1, 0));
+    UT_ASSERT_EQUAL_INT(TIMER_WHEEL_INVALID_PARAM, timer_wheel_stop(NULL));
+}
+
+/**
+ * @brief 测试周期定时器
+ */
+static void test_timer_wheel_periodic(void)
+{
+    timer_wheel_timer_t timer;
+    tw_test_record_t record;
+    timer_wheel_stats_t stats;
+    uint32_t start_tick = tw_test_tick;
+
+    memset(&record, 0, sizeof(record));
+    timer_wheel_timer_init(&timer, tw_test_callback, &record);
+
+    /* 首次超时20个tick，之后每7个tick回调一次 */
+    UT_ASSERT_EQUAL_INT(TIMER_WHEEL_OK, timer_wheel_start(&timer, 20, 7));
+    tw_test_advance(20);
+    UT_ASSERT_EQUAL_INT(1, record.count);
+    UT_ASSERT_EQUAL_INT(start_tick + 20, record.last_tick);
+
+    /* 周期以到期时间为基准，不随回调时刻漂移 */
+    tw_test_advance(7 * 10);
+    UT_ASSERT_EQUAL_INT(11, record.count);
+    UT_ASSERT_EQUAL_INT(start_tick + 20 + 7 * 10, record.last_tick);
+    UT_ASSERT(timer_wheel_is_active(&timer));
+
+    UT_ASSERT_EQUAL_INT(TIMER_WHEEL_OK, timer_wheel_get_stats(&stats));
+    UT_ASSERT_EQUAL_INT(1, stats.active_timers);
+    UT_ASSERT_EQUAL_INT(11, stats.total_expired);
+
+    UT_ASSERT_EQUAL_INT(TIMER_WHEEL_OK, timer_wheel_stop(&timer));
+    tw_test_advance(20);
+    UT_ASSERT_EQUAL_INT(11, record.count);
+
+    UT_ASSERT_EQUAL_INT(TIMER_WHEEL_OK, timer_wheel_get_stats(&stats));
+    UT_ASSERT_EQUAL_INT(0, stats.active_timers);
+}
+
+/**
+ * @brief 测试高层槽位迁移后按时到期
+ */
+static void test_timer_wheel_cascade(void)
+{
+    static const uint32_t timeouts[] = {
+        63,                                     /* 第0层 */
+        64 + 5,                                 /* 第1层 */
+        3 * 64 + 17,                            /* 第1层，跨越多次回绕 */
+        64 * 64 + 100                           /* 第2层 */
+    };
+    timer_wheel_timer_t timers[sizeof(timeouts) / sizeof(timeouts[0])];
+    tw_test_record_t records[sizeof(timeouts) / sizeof(timeouts[0])];
+    timer_wheel_stats_t stats;
+    uint32_t start_tick;
+    uint32_t i;
+
+    /* 先推进若干tick，使定时器跨越槽位边界挂入 */
+    tw_test_advance(37);
+    start_tick = tw_test_tick;
+
+    memset(records, 0, sizeof(records));
+    for (i = 0; i < sizeof(timeouts) / sizeof(timeouts[0]); i++) {
+        timer_wheel_timer_init(&timers[i], tw_test_callback, &records[i]);
+        UT_ASSERT_EQUAL_INT(TIMER_WHEEL_OK, timer_wheel_start(&timers[i], timeouts[i], 0));
+    }
+
+    tw_test_advance(64 * 64 + 200);
+
+    /* 每个定时器恰好在超时对应的推进中回调一次 */
+    for (i = 0; i < sizeof(timeouts) / sizeof(timeouts[0]); i++) {
+        UT_ASSERT_EQUAL_INT(1, records[i].count);
+        UT_ASSERT_EQUAL_INT(start_tick + timeouts[i], records[i].last_tick);
+    }
+
+    UT_ASSERT_EQUAL_INT(TIMER_WHEEL_OK, timer_wheel_get_stats(&stats));
+    UT_ASSERT(stats.cascades >= 3);
+    UT_ASSERT_EQUAL_INT(0, stats.active_timers);
+}
+
+/**
+ * @brief 测试去初始化后定时器被摘除
+ */
+static void test_timer_wheel_deinit(void)
+{
+    timer_wheel_timer_t timers[2];
+    tw_test_record_t record;
+
+    memset(&record, 0, sizeof(record));
+    timer_wheel_timer_init(&timers[0], tw_test_callback, &record);
+    timer_wheel_timer_init(&timers[1], tw_test_callback, &record);
+    UT_ASSERT_EQUAL_INT(TIMER_WHEEL_OK, timer_wheel_start(&timers[0], 3, 0));
+    UT_ASSERT_EQUAL_INT(TIMER_WHEEL_OK, timer_wheel_start(&timers[1], 500, 10));
+
+    /* 去初始化后定时器回到空闲状态，不再引用时间轮 */
+    UT_ASSERT_EQUAL_INT(TIMER_WHEEL_OK, timer_wheel_deinit());
+    UT_ASSERT(!timer_wheel_is_active(&timers[0]));
+    UT_ASSERT(!timer_wheel_is_active(&timers[1]));
+    UT_ASSERT(timers[0].next == NULL && timers[1].next == NULL);
+
+    /* 重新初始化后可以再次启动，统计从零开始 */
+    UT_ASSERT_EQUAL_INT(TIMER_WHEEL_OK, timer_wheel_init(TW_TEST_TICK_MS));
+    UT_ASSERT_EQUAL_INT(TIMER_WHEEL_OK, timer_wheel_start(&timers[0], 3, 0));
+    tw_test_advance(3);
+    UT_ASSERT_EQUAL_INT(1, record.count);
+    UT_ASSERT(!timer_wheel_is_active(&timers[1]));
+}
+
+/* 每个测试案例使用新初始化的时间轮 */
+static void timer_wheel_test_setup(void)
+{
+    tw_test_tick = 0;
+    timer_wheel_init(TW_TEST_TICK_MS);
+}
+
+/* 测试案例清理 */
+static void timer_wheel_test_teardown(void)
+{
+    timer_wheel_deinit();
+}
+
+/* 时间轮测试案例 */
+static ut_test_case_t timer_wheel_test_cases[] = {
+    {"单次定时测试", test_timer_wheel_one_shot},
+    {"周期定时测试", test_timer_wheel_periodic},
+    {"层间迁移测试", test_timer_wheel_cascade},
+    {"去初始化测试", test_timer_wheel_deinit}
+};
+
+/* 时间轮测试套件 */
+ut_test_suite_t timer_wheel_test_suite = {
+    "时间轮测试套件",
+    timer_wheel_test_cases,
+    sizeof(timer_wheel_test_cases) / sizeof(timer_wheel_test_cases[0]),
+    NULL,
+    NULL,
+    timer_wheel_test_setup,
+    timer_wheel_test_teardown
+};
+
+#endif /* CONFIG_TIMER_WHEEL_ENABLED */
@@ -0,0 +1,306 @@
+/**
+ * @file test_tm1681.c
+ * @brief TM1681帧缓冲单元测试
+ *
+ * 该文件在主机TM1681模拟传输层上测试初始化、局部刷新与突发合并、
+ * 异步传输下的暂存区复用、传输出错和等待失败后的重发
+ */
+
+#include "unit_test.h"
+#include "tm1681_api.h"
+#include "host_tm1681_api.h"
+#include <string.h>
+
+/* 测试点阵尺寸，占用48字节显示RAM */
+#define TM1681_TEST_WIDTH       24
+#define TM1681_TEST_HEIGHT      16
+#define TM1681_TEST_SIZE        (TM1681_TEST_WIDTH * 2)
+
+/* 帧对象 */
+static tm1681_frame_t tm_frame;
+
+/* 按传输层初始化帧对象并清零统计 */
+static int tm_init(uint16_t merge_gap)
+{
+    tm1681_transport_t transport;
+
+    host_tm1681_reset();
+    host_tm1681_get_transport(&transport, merge_gap);
+    return tm1681_frame_init(&tm_frame, TM1681_TEST_WIDTH, TM1681_TEST_HEIGHT, &transport);
+}
+
+/* 控制器RAM与显示缓冲区是否一致 */
+static bool tm_ram_matches(void)
+{
+    return memcmp(host_tm1681_get_ram(), tm_frame.buffer, TM1681_TEST_SIZE) == 0;
+}
+
+/* 刷新并返回本次发送的选通帧数 */
+static uint32_t tm_refresh_frames(void)
+{
+    host_tm1681_stats_t before;
+    host_tm1681_stats_t after;
+
+    host_tm1681_get_stats(&before);
+    if (tm1681_frame_refresh(&tm_frame) != TM1681_OK) {
+        return UINT32_MAX;
+    }
+    tm1681_frame_sync(&tm_frame, 100);
+    host_tm1681_get_stats(&after);
+
+    return after.frames - before.frames;
+}
+
+/* 测试初始化 */
+static void test_tm1681_init(void)
+{
+    host_tm1681_stats_t stats;
+    tm1681_transport_t transport;
+    const uint8_t *ram;
+
+    UT_ASSERT_EQUAL_INT(TM1681_OK, tm_init(TM1681_MERGE_NONE));
+    host_tm1681_get_stats(&stats);
+    ram = host_tm1681_get_ram();
+
+    /* 设置数据模式并把使用的RAM清零，未使用的RAM不写入 */
+    UT_ASSERT_EQUAL_INT(2, stats.frames);
+    UT_ASSERT_EQUAL_INT(TM1681_CMD_DATA_MODE | TM1681_ADDR_AUTO_INC, stats.data_mode);
+    UT_ASSERT_EQUAL_INT(TM1681_TEST_SIZE, stats.data_bytes);
+    UT_ASSERT_EQUAL_INT(0, stats.protocol_errors);
+    UT_ASSERT_EQUAL_INT(0, ram[0]);
+    UT_ASSERT_EQUAL_INT(0, ram[TM1681_TEST_SIZE - 1]);
+    UT_ASSERT_EQUAL_INT(0xFF, ram[TM1681_TEST_SIZE]);
+
+    /* 没有修改时刷新不发送任何帧 */
+    UT_ASSERT_EQUAL_INT(0, tm_refresh_frames());
+
+    /* 超出控制器RAM的尺寸被拒绝 */
+    host_tm1681_get_transport(&transport, TM1681_MERGE_NONE);
+    UT_ASSERT_EQUAL_INT(TM1681_INVALID_PARAM, tm1681_frame_init(&tm_frame, 48, 16, &transport));
+    UT_ASSERT_EQUAL_INT(TM1681_OK, tm1681_frame_init(&tm_frame, 64, 8, &transport));
+
+    UT_ASSERT_EQUAL_INT(TM1681_OK, tm1681_frame_command(&tm_frame, 0x8F));
+    host_tm1681_get_stats(&stats);
+    UT_ASSERT_EQUAL_INT(0x8F, stats.last_command);
+    UT_ASSERT_EQUAL_INT(TM1681_OK, tm1681_frame_deinit(&tm_frame));
+}
+
+/* 测试局部刷新 */
+static void test_tm1681_partial_refresh(void)
+{
+    host_tm1681_stats_t before;
+    host_tm1681_stats_t after;
+    bool on = false;
+
+    UT_ASSERT_EQUAL_INT(TM1681_OK, tm_init(TM1681_MERGE_NONE));
+
+    /* 同一列的多个像素只写一个字节 */
+    tm1681_frame_set_pixel(&tm_frame, 5, 0, true);
+    tm1681_frame_set_pixel(&tm_frame, 5, 3, true);
+    tm1681_frame_set_pixel(&tm_frame, 5, 7, true);
+    host_tm1681_get_stats(&before);
+    UT_ASSERT_EQUAL_INT(1, tm_refresh_frames());
+    host_tm1681_get_stats(&after);
+    UT_ASSERT_EQUAL_INT(1, after.data_bytes - before.data_bytes);
+    UT_ASSERT_EQUAL_INT(0x89, host_tm1681_get_ram()[5]);
+    UT_ASSERT(tm_ram_matches());
+
+    /* 第二个字节行位于下标x + width */
+    tm1681_frame_set_pixel(&tm_frame, 5, 8, true);
+    UT_ASSERT_EQUAL_INT(1, tm_refresh_frames());
+    UT_ASSERT_EQUAL_INT(0x01, host_tm1681_get_ram()[5 + TM1681_TEST_WIDTH]);
+    UT_ASSERT_EQUAL_INT(TM1681_OK, tm1681_frame_get_pixel(&tm_frame, 5, 8, &on));
+    UT_ASSERT(on);
+
+    /* 写入相同值或改回原值不产生传输 */
+    tm1681_frame_set_pixel(&tm_frame, 5, 0, true);
+    UT_ASSERT_EQUAL_INT(0, tm_refresh_frames());
+    tm1681_frame_set_pixel(&tm_frame, 6, 0, true);
+    tm1681_frame_set_pixel(&tm_frame, 6, 0, false);
+    UT_ASSERT_EQUAL_INT(0, tm_refresh_frames());
+
+    /* 清除后重绘相同内容不产生传输 */
+    tm1681_frame_clear(&tm_frame);
+    tm1681_frame_set_pixel(&tm_frame, 5, 0, true);
+    tm1681_frame_set_pixel(&tm_frame, 5, 3, true);
+    tm1681_frame_set_pixel(&tm_frame, 5, 7, true);
+    tm1681_frame_set_pixel(&tm_frame, 5, 8, true);
+    UT_ASSERT_EQUAL_INT(0, tm_refresh_frames());
+
+    /* 清除后只写入原来点亮的两个字节 */
+    tm1681_frame_clear(&tm_frame);
+    UT_ASSERT_EQUAL_INT(2, tm_refresh_frames());
+    UT_ASSERT(tm_ram_matches());
+
+    UT_ASSERT_EQUAL_INT(TM1681_INVALID_PARAM, tm1681_frame_set_pixel(&tm_frame, TM1681_TEST_WIDTH, 0, true));
+    UT_ASSERT_EQUAL_INT(TM1681_INVALID_PARAM, tm1681_frame_set_pixel(&tm_frame, 0, TM1681_TEST_HEIGHT, true));
+    tm1681_frame_deinit(&tm_frame);
+}
+
+/* 测试突发合并与区域写入 */
+static void test_tm1681_burst_merge(void)
+{
+    static const uint8_t glyph[2] = {0xFF, 0x81};   /* 8x2位图 */
+    static const uint8_t area[3] = {0x0F, 0xF0, 0x3C};  /* 12x2区域，行间不补齐 */
+    host_tm1681_stats_t before;
+    host_tm1681_stats_t after;
+
+    /* 间隔不超过合并间隔时合并为一帧，未变字节一并写入 */
+    UT_ASSERT_EQUAL_INT(TM1681_OK, tm_init(2));
+    tm1681_frame_set_pixel(&tm_frame, 0, 0, true);
+    tm1681_frame_set_pixel(&tm_frame, 3, 0, true);
+    host_tm1681_get_stats(&before);
+    UT_ASSERT_EQUAL_INT(1, tm_refresh_frames());
+    host_tm1681_get_stats(&after);
+    UT_ASSERT_EQUAL_INT(4, after.data_bytes - before.data_bytes);
+
+    /* 间隔超过合并间隔时分为两帧 */
+    tm1681_frame_set_pixel(&tm_frame, 10, 0, true);
+    tm1681_frame_set_pixel(&tm_frame, 20, 0, true);
+    UT_ASSERT_EQUAL_INT(2, tm_refresh_frames());
+    UT_ASSERT(tm_ram_matches());
+    tm1681_frame_deinit(&tm_frame);
+
+    /* 全部合并时整帧一次写入 */
+    UT_ASSERT_EQUAL_INT(TM1681_OK, tm_init(TM1681_MERGE_ALL));
+    tm1681_frame_set_pixel(&tm_frame, 0, 0, true);
+    tm1681_frame_set_pixel(&tm_frame, 23, 15, true);
+    host_tm1681_get_stats(&before);
+    UT_ASSERT_EQUAL_INT(1, tm_refresh_frames());
+    host_tm1681_get_stats(&after);
+    UT_ASSERT_EQUAL_INT(TM1681_TEST_SIZE, after.data_bytes - before.data_bytes);
+    UT_ASSERT(tm_ram_matches());
+
+    /* 位图超出右下角的部分被裁剪 */
+    UT_ASSERT_EQUAL_INT(TM1681_OK, tm1681_frame_draw_bitmap(&tm_frame, 20, 14, 8, 2, glyph));
+    UT_ASSERT_EQUAL_INT(1, tm_refresh_frames());
+    UT_ASSERT_EQUAL_INT(0xC0, host_tm1681_get_ram()[20 + TM1681_TEST_WIDTH]);
+    UT_ASSERT_EQUAL_INT(0x40, host_tm1681_get_ram()[21 + TM1681_TEST_WIDTH]);
+    UT_ASSERT(tm_ram_matches());
+
+    /* 区域数据按连续位流解析 */
+    tm1681_frame_clear(&tm_frame);
+    UT_ASSERT_EQUAL_INT(TM1681_OK, tm1681_frame_set_area(&tm_frame, 0, 0, 12, 2, area));
+    UT_ASSERT_EQUAL_INT(0x03, tm_frame.buffer[0]);
+    UT_ASSERT_EQUAL_INT(0x00, tm_frame.buffer[4]);
+    UT_ASSERT_EQUAL_INT(0x02, tm_frame.buffer[6]);
+    UT_ASSERT_EQUAL_INT(0x02, tm_frame.buffer[9]);
+    UT_ASSERT_EQUAL_INT(0x00, tm_frame.buffer[10]);
+    UT_ASSERT_EQUAL_INT(TM1681_INVALID_PARAM, tm1681_frame_set_area(&tm_frame, 20, 0, 12, 2, area));
+    UT_ASSERT_EQUAL_INT(1, tm_refresh_frames());
+    UT_ASSERT(tm_ram_matches());
+    tm1681_frame_deinit(&tm_frame);
+}
+
+/* 测试异步传输 */
+static void test_tm1681_async(void)
+{
+    host_tm1681_stats_t stats;
+    tm1681_stats_t frame_stats;
+
+    UT_ASSERT_EQUAL_INT(TM1681_OK, tm_init(TM1681_MERGE_NONE));
+    host_tm1681_set_async(true);
+
+    /* 每次刷新都写入分散的字节，暂存区用满后必须等待传输完成才能复用 */
+    for (uint16_t step = 0; step < 200; step++) {
+        for (uint16_t x = step % 3; x < TM1681_TEST_WIDTH; x += 3) {
+            tm1681_frame_set_pixel(&tm_frame, x, (uint16_t)((x + step) % TM1681_TEST_HEIGHT), (step & 1) == 0);
+        }
+        UT_ASSERT_EQUAL_INT(TM1681_OK, tm1681_frame_refresh(&tm_frame));
+    }
+
+    /* 帧只在wait中执行，同步前控制器内容落后于缓冲区 */
+    host_tm1681_get_stats(&stats);
+    UT_ASSERT(stats.max_queued > 1);
+    UT_ASSERT_EQUAL_INT(TM1681_OK, tm1681_frame_sync(&tm_frame, 100));
+    UT_ASSERT(tm_ram_matches());
+
+    tm1681_frame_get_stats(&tm_frame, &frame_stats);
+    UT_ASSERT(frame_stats.waits > 0);
+    UT_ASSERT_EQUAL_INT(200, frame_stats.refreshes);
+    host_tm1681_get_stats(&stats);
+    UT_ASSERT_EQUAL_INT(frame_stats.frames, stats.frames);
+    UT_ASSERT_EQUAL_INT(frame_stats.bytes, stats.bytes);
+    UT_ASSERT_EQUAL_INT(0, stats.protocol_errors);
+
+    UT_ASSERT_EQUAL_INT(TM1681_OK, tm1681_frame_deinit(&tm_frame));
+    host_tm1681_set_async(false);
+}
+
+/* 测试传输出错后重发 */
+static void test_tm1681_retry(void)
+{
+    UT_ASSERT_EQUAL_INT(TM1681_OK, tm_init(TM1681_MERGE_NONE));
+
+    tm1681_frame_set_pixel(&tm_frame, 1, 0, true);
+    tm1681_frame_set_pixel(&tm_frame, 11, 0, true);
+    tm1681_frame_set_pixel(&tm_frame, 21, 9, true);
+
+    /* 第二帧失败，第一帧已写入 */
+    host_tm1681_inject_error(2);
+    UT_ASSERT_EQUAL_INT(TM1681_IO_ERROR, tm1681_frame_refresh(&tm_frame));
+    UT_ASSERT_EQUAL_INT(0x01, host_tm1681_get_ram()[1]);
+    UT_ASSERT_EQUAL_INT(0x00, host_tm1681_get_ram()[11]);
+
+    /* 再次刷新只发送未成功的两帧 */
+    UT_ASSERT_EQUAL_INT(2, tm_refresh_frames());
+    UT_ASSERT(tm_ram_matches());
+    UT_ASSERT_EQUAL_INT(0, tm_refresh_frames());
+
+    tm1681_frame_deinit(&tm_frame);
+}
+
+/* 测试异步传输等待失败后重发 */
+static void test_tm1681_wait_failure(void)
+{
+    /* 初始化写入的帧确认完成后，失败时只重发之后排队的帧 */
+    UT_ASSERT_EQUAL_INT(TM1681_OK, tm_init(TM1681_MERGE_NONE));
+    UT_ASSERT_EQUAL_INT(TM1681_OK, tm1681_frame_sync(&tm_frame, 100));
+    host_tm1681_set_async(true);
+
+    /* 等待失败时排队的帧被丢弃，错误码原样返回 */
+    tm1681_frame_set_pixel(&tm_frame, 2, 0, true);
+    tm1681_frame_set_pixel(&tm_frame, 12, 8, true);
+    UT_ASSERT_EQUAL_INT(TM1681_OK, tm1681_frame_refresh(&tm_frame));
+    host_tm1681_inject_wait_error(TM1681_IO_ERROR);
+    UT_ASSERT_EQUAL_INT(TM1681_IO_ERROR, tm1681_frame_sync(&tm_frame, 100));
+    UT_ASSERT(!tm_ram_matches());
+
+    /* 影子副本已与缓冲区一致，仍重新发送失败的两帧 */
+    UT_ASSERT_EQUAL_INT(2, tm_refresh_frames());
+    UT_ASSERT(tm_ram_matches());
+    UT_ASSERT_EQUAL_INT(0, tm_refresh_frames());
+
+    /* 超时的帧之后仍会执行，与重发的帧一起写入相同内容 */
+    tm1681_frame_set_pixel(&tm_frame, 20, 15, true);
+    UT_ASSERT_EQUAL_INT(TM1681_OK, tm1681_frame_refresh(&tm_frame));
+    host_tm1681_inject_wait_error(TM1681_TIMEOUT);
+    UT_ASSERT_EQUAL_INT(TM1681_TIMEOUT, tm1681_frame_sync(&tm_frame, 100));
+    UT_ASSERT_EQUAL_INT(2, tm_refresh_frames());
+    UT_ASSERT(tm_ram_matches());
+    UT_ASSERT_EQUAL_INT(0, tm_refresh_frames());
+
+    UT_ASSERT_EQUAL_INT(TM1681_OK, tm1681_frame_deinit(&tm_frame));
+    host_tm1681_set_async(false);
+}
+
+/* TM1681测试案例 */
+static ut_test_case_t tm1681_test_cases[] = {
+    {"初始化测试", test_tm1681_init},
+    {"局部刷新测试", test_tm1681_partial_refresh},
+    {"突发合并与区域写入测试", test_tm1681_burst_merge},
+    {"异步传输测试", test_tm1681_async},
+    {"传输出错重发测试", test_tm1681_retry},
+    {"等待失败重发测试", test_tm1681_wait_failure}
+};
+
+/* TM1681测试套件 */
+ut_test_suite_t tm1681_test_suite = {
+    "TM1681帧缓冲测试套件",
+    tm1681_test_cases,
+    sizeof(tm1681_test_cases) / sizeof(tm1681_test_cases[0]),
+    NULL,
+    NULL,
+    NULL,
+    NULL
+};
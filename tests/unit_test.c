@@ -5,16 +5,31 @@
  * 该文件实现了简单的单元测试框架功能
  */
 
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
 #include "unit_test.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#else
+extern uint64_t platform_get_time_us(void);
+#endif
+
 /* 全局测试状态 */
 ut_statistics_t *ut_current_stats = NULL;
 bool ut_current_test_failed = false;
 
+/* 性能测试采样与结果，性能测试不可重入 */
+static uint64_t ut_bench_samples[UT_BENCH_MAX_SAMPLES];
+static ut_bench_result_t ut_bench_results[UT_BENCH_MAX_RESULTS];
+static unsigned int ut_bench_result_count = 0;
+
 /**
  * @brief 初始化测试统计信息
  * 
@@ -312,3 +327,253 @@ void ut_print_statistics(ut_statistics_t *stats)
         printf(UT_COLOR_RED "\n存在测试失败！\n" UT_COLOR_RESET);
     }
 }
+
+/**
+ * @brief 获取当前时间（纳秒）
+ * 
+ * @return uint64_t 当前时间
+ */
+uint64_t ut_bench_time_ns(void)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    struct timespec ts;
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#else
+    return platform_get_time_us() * 1000ULL;
+#endif
+}
+
+/**
+ * @brief 采样值比较函数
+ */
+static int ut_bench_compare_samples(const void *a, const void *b)
+{
+    uint64_t va = *(const uint64_t *)a;
+    uint64_t vb = *(const uint64_t *)b;
+    
+    return (va > vb) - (va < vb);
+}
+
+/**
+ * @brief 统计采样结果并保存
+ * 
+ * @param state 运行状态
+ */
+static void ut_bench_finish(ut_bench_state_t *state)
+{
+    ut_bench_result_t result;
+    uint64_t sum = 0;
+    uint32_t p99_index;
+    uint32_t i;
+    
+    qsort(ut_bench_samples, state->count, sizeof(uint64_t), ut_bench_compare_samples);
+    
+    for (i = 0; i < state->count; i++) {
+        sum += ut_bench_samples[i];
+    }
+    
+    /* P99取向上取整的排名 */
+    p99_index = (state->count * 99 + 99) / 100;
+    if (p99_index > 0) {
+        p99_index--;
+    }
+    
+    result.name = state->name;
+    result.samples = state->count;
+    result.batch = state->batch;
+    result.bytes = state->bytes;
+    result.min_ns = ut_bench_samples[0];
+    result.median_ns = ut_bench_samples[state->count / 2];
+    result.p99_ns = ut_bench_samples[p99_index];
+    result.max_ns = ut_bench_samples[state->count - 1];
+    result.mean_ns = sum / state->count;
+    
+    printf(UT_COLOR_BLUE "  性能测试: %-32s" UT_COLOR_RESET
+           " min %8lu ns  median %8lu ns  p99 %8lu ns  (%u x %u)",
+           result.name, (unsigned long)result.min_ns, (unsigned long)result.median_ns,
+           (unsigned long)result.p99_ns, result.samples, result.batch);
+    if (result.bytes > 0 && result.median_ns > 0) {
+        printf("  %.2f MB/s", (double)result.bytes * 1000.0 / (double)result.median_ns);
+    }
+    printf("\n");
+    
+    if (ut_bench_result_count < UT_BENCH_MAX_RESULTS) {
+        ut_bench_results[ut_bench_result_count++] = result;
+    }
+}
+
+/**
+ * @brief 开始一个性能测试
+ * 
+ * @param name 性能测试名称
+ * @param reps 采样次数
+ * @param bytes 每次迭代处理的字节数
+ * @return ut_bench_state_t 运行状态
+ */
+ut_bench_state_t ut_bench_begin(const char *name, uint32_t reps, uint32_t bytes)
+{
+    ut_bench_state_t state;
+    
+    memset(&state, 0, sizeof(state));
+    state.name = name;
+    state.reps = (reps == 0) ? 1 : (reps > UT_BENCH_MAX_SAMPLES ? UT_BENCH_MAX_SAMPLES : reps);
+    state.bytes = bytes;
+    state.batch = 1;
+    state.start_ns = ut_bench_time_ns();
+    
+    return state;
+}
+
+/**
+ * @brief 推进性能测试
+ * 
+ * 每完成一批迭代读取一次时间。预热阶段将批量加倍直到单次采样
+ * 足够长，以抵消计时分辨率和计时开销
+ * 
+ * @param state 运行状态
+ * @return bool true表示继续执行循环体，false表示测试结束
+ */
+bool ut_bench_next(ut_bench_state_t *state)
+{
+    uint64_t elapsed;
+    
+    if (state->iter < state->batch) {
+        state->iter++;
+        return true;
+    }
+    
+    elapsed = ut_bench_time_ns() - state->start_ns;
+    
+    if (state->warmup < UT_BENCH_WARMUP_SAMPLES) {
+        if (elapsed < UT_BENCH_MIN_SAMPLE_NS && state->batch < 0x40000000UL) {
+            state->batch *= 2;
+        } else {
+            state->warmup++;
+        }
+    } else {
+        ut_bench_samples[state->count++] = elapsed / state->batch;
+        if (state->count >= state->reps) {
+            ut_bench_finish(state);
+            return false;
+        }
+    }
+    
+    state->iter = 1;
+    state->start_ns = ut_bench_time_ns();
+    
+    return true;
+}
+
+/**
+ * @brief 获取已保存的性能测试结果
+ * 
+ * @param count 结果数量输出
+ * @return const ut_bench_result_t* 结果数组
+ */
+const ut_bench_result_t *ut_bench_get_results(unsigned int *count)
+{
+    if (count != NULL) {
+        *count = ut_bench_result_count;
+    }
+    
+    return ut_bench_results;
+}
+
+/**
+ * @brief 清除已保存的性能测试结果
+ */
+void ut_bench_clear_results(void)
+{
+    ut_bench_result_count = 0;
+}
+
+/**
+ * @brief 以JSON格式输出性能测试结果
+ * 
+ * @param out 输出流
+ * @return int 0表示成功，非0表示失败
+ */
+int ut_bench_write_json(FILE *out)
+{
+    unsigned int i;
+    
+    if (out == NULL) {
+        return -1;
+    }
+    
+    fprintf(out, "{\"benchmarks\": [\n");
+    for (i = 0; i < ut_bench_result_count; i++) {
+        const ut_bench_result_t *r = &ut_bench_results[i];
+        
+        fprintf(out, "{\"name\": \"%s\", \"samples\": %u, \"batch\": %u, \"bytes\": %u, "
+                     "\"min_ns\": %lu, \"median_ns\": %lu, \"p99_ns\": %lu, "
+                     "\"max_ns\": %lu, \"mean_ns\": %lu}%s\n",
+                r->name, r->samples, r->batch, r->bytes,
+                (unsigned long)r->min_ns, (unsigned long)r->median_ns, (unsigned long)r->p99_ns,
+                (unsigned long)r->max_ns, (unsigned long)r->mean_ns,
+                (i + 1 < ut_bench_result_count) ? "," : "");
+    }
+    fprintf(out, "]}\n");
+    
+    return 0;
+}
+
+/**
+ * @brief 与基线结果比较，报告性能回退
+ * 
+ * @param baseline_path 基线文件路径
+ * @param tolerance 允许的相对退化比例
+ * @return int 回退的测试数量，基线无法读取时返回-1
+ */
+int ut_bench_compare_baseline(const char *baseline_path, double tolerance)
+{
+    FILE *fp;
+    char line[512];
+    int regressions = 0;
+    unsigned int i;
+    
+    if (baseline_path == NULL) {
+        return -1;
+    }
+    
+    fp = fopen(baseline_path, "r");
+    if (fp == NULL) {
+        return -1;
+    }
+    
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        char name[128];
+        unsigned long baseline_ns;
+        const char *name_pos = strstr(line, "\"name\": \"");
+        const char *median_pos = strstr(line, "\"median_ns\": ");
+        
+        if (name_pos == NULL || median_pos == NULL) {
+            continue;
+        }
+        if (sscanf(name_pos + 9, "%127[^\"]", name) != 1 ||
+            sscanf(median_pos + 13, "%lu", &baseline_ns) != 1) {
+            continue;
+        }
+        
+        for (i = 0; i < ut_bench_result_count; i++) {
+            const ut_bench_result_t *r = &ut_bench_results[i];
+            
+            if (strcmp(r->name, name) != 0) {
+                continue;
+            }
+            
+            if ((double)r->median_ns > (double)baseline_ns * (1.0 + tolerance)) {
+                regressions++;
+                printf(UT_COLOR_RED "性能回退: %s, 基线: %lu ns, 当前: %lu ns\n" UT_COLOR_RESET,
+                       name, baseline_ns, (unsigned long)r->median_ns);
+            }
+            break;
+        }
+    }
+    
+    fclose(fp);
+    
+    return regressions;
+}
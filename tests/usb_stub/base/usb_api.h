@@ -0,0 +1,111 @@
+/**
+ * @file usb_api.h
+ * @brief STM32 USB驱动主机测试用的USB接口定义
+ *
+ * drivers/base/usb/stm32_usb.c按端点地址、完成回调带状态的传输模型编写，
+ * 与include/base/usb_api.h中的通用传输定义不一致。主机测试编译驱动时用该头
+ * 文件代替，只提供驱动使用的传输类型；操作状态、设备句柄和流接口直接包含
+ * include/base/usb_stream_api.h，与驱动实现的接口一致
+ */
+
+#ifndef USB_API_H
+#define USB_API_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "base/usb_stream_api.h"
+
+/* USB端点类型 */
+typedef enum {
+    USB_ENDPOINT_CONTROL,
+    USB_ENDPOINT_ISOCHRONOUS,
+    USB_ENDPOINT_BULK,
+    USB_ENDPOINT_INTERRUPT
+} usb_endpoint_type_t;
+
+/* USB速度 */
+typedef enum {
+    USB_SPEED_LOW,
+    USB_SPEED_FULL,
+    USB_SPEED_HIGH
+} usb_speed_t;
+
+/* USB设备状态 */
+typedef enum {
+    USB_DEVICE_DISCONNECTED,
+    USB_DEVICE_CONNECTED,
+    USB_DEVICE_DEFAULT,
+    USB_DEVICE_ADDRESS,
+    USB_DEVICE_CONFIGURED,
+    USB_DEVICE_SUSPENDED,
+    USB_DEVICE_RESUMED
+} usb_device_state_t;
+
+/* 传输类型 */
+typedef enum {
+    USB_TRANSFER_SETUP,
+    USB_TRANSFER_DATA,
+    USB_TRANSFER_STATUS
+} usb_transfer_type_t;
+
+/* 描述符类型 */
+#define USB_DESC_TYPE_DEVICE            0x01
+#define USB_DESC_TYPE_CONFIGURATION     0x02
+#define USB_DESC_TYPE_STRING            0x03
+
+/* USB传输请求 */
+typedef struct {
+    uint8_t ep_addr;
+    uint8_t *buffer;
+    uint32_t length;
+    uint32_t actual_length;
+    usb_transfer_type_t type;
+} usb_transfer_t;
+
+/* 传输完成回调 */
+typedef void (*usb_callback_t)(void *arg, usb_status_t status, usb_transfer_t *transfer);
+
+/* 设备状态回调 */
+typedef void (*usb_device_state_callback_t)(void *arg, usb_device_state_t state);
+
+/* 描述符 */
+typedef struct {
+    const uint8_t *buffer;
+    uint16_t length;
+} usb_descriptor_t;
+
+/* 端点配置 */
+typedef struct {
+    uint8_t ep_addr;
+    usb_endpoint_type_t type;
+    uint16_t max_packet_size;
+} usb_endpoint_config_t;
+
+/* 接口配置 */
+typedef struct {
+    const usb_endpoint_config_t *endpoints;
+    uint8_t num_endpoints;
+} usb_interface_config_t;
+
+/* USB配置参数 */
+typedef struct {
+    usb_descriptor_t device_descriptor;
+    usb_descriptor_t config_descriptor;
+    const usb_descriptor_t *string_descriptors;
+    uint8_t num_string_descriptors;
+    const usb_interface_config_t *interfaces;
+    uint8_t num_interfaces;
+} usb_config_t;
+
+/* 主机模式设备信息 */
+typedef struct {
+    uint8_t address;
+} usb_host_device_info_t;
+
+int usb_init(const usb_config_t *config, usb_device_state_callback_t state_callback, void *arg, usb_handle_t *handle);
+int usb_deinit(usb_handle_t handle);
+int usb_transfer(usb_handle_t handle, usb_transfer_t *transfer, usb_callback_t callback, void *arg);
+int usb_cancel_transfer(usb_handle_t handle, uint8_t ep_addr);
+int usb_register_endpoint_callback(usb_handle_t handle, uint8_t ep_addr, usb_callback_t callback, void *arg);
+
+#endif /* USB_API_H */
@@ -0,0 +1,144 @@
+/**
+ * @file stm32_platform.h
+ * @brief STM32 USB驱动主机测试用的HAL桩定义
+ *
+ * 在主机上编译drivers/base/usb/stm32_usb.c时代替platform/mcu/stm32_platform.h，
+ * 只提供驱动用到的PCD、USBD类型和函数声明。函数由test_usb_queue.c实现，
+ * 记录端点操作的调用顺序，不访问硬件
+ */
+
+#ifndef STM32_PLATFORM_H
+#define STM32_PLATFORM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* HAL状态 */
+typedef enum {
+    HAL_OK = 0,
+    HAL_ERROR,
+    HAL_BUSY,
+    HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+/* PCD端点 */
+typedef struct {
+    uint8_t num;
+    uint8_t is_in;
+    uint8_t is_stall;
+    uint8_t *xfer_buff;
+    uint32_t xfer_len;
+    uint32_t xfer_count;
+} PCD_EPTypeDef;
+
+/* PCD初始化参数 */
+typedef struct {
+    uint32_t dev_endpoints;
+    uint32_t speed;
+    uint32_t dma_enable;
+    uint32_t phy_itface;
+    uint32_t Sof_enable;
+    uint32_t low_power_enable;
+    uint32_t vbus_sensing_enable;
+    uint32_t use_dedicated_ep1;
+} PCD_InitTypeDef;
+
+/* PCD句柄 */
+typedef struct {
+    void *Instance;
+    PCD_InitTypeDef Init;
+    PCD_EPTypeDef IN_ep[16];
+    PCD_EPTypeDef OUT_ep[16];
+    uint32_t Setup[12];
+} PCD_HandleTypeDef;
+
+/* USB设备库句柄 */
+typedef struct {
+    uint8_t id;
+} USBD_HandleTypeDef;
+
+typedef enum {
+    USBD_SPEED_HIGH = 0,
+    USBD_SPEED_FULL = 1,
+    USBD_SPEED_LOW = 2
+} USBD_SpeedTypeDef;
+
+/* PCD回调编号 */
+typedef enum {
+    HAL_PCD_SOF_CB_ID,
+    HAL_PCD_SETUP_STAGE_CB_ID,
+    HAL_PCD_RESET_CB_ID,
+    HAL_PCD_SUSPEND_CB_ID,
+    HAL_PCD_RESUME_CB_ID,
+    HAL_PCD_CONNECT_CB_ID,
+    HAL_PCD_DISCONNECT_CB_ID,
+    HAL_PCD_DATA_OUT_STAGE_CB_ID,
+    HAL_PCD_DATA_IN_STAGE_CB_ID,
+    HAL_PCD_ISO_OUT_INCOMPLETE_CB_ID,
+    HAL_PCD_ISO_IN_INCOMPLETE_CB_ID
+} HAL_PCD_CallbackIDTypeDef;
+
+#define USB_OTG_FS          ((void *)0x50000000UL)
+
+#define PCD_PHY_ULPI        1U
+#define PCD_PHY_EMBEDDED    2U
+#define PCD_SPEED_HIGH      0U
+#define PCD_SPEED_FULL      2U
+
+#define PCD_ENDP_OUT        0U
+#define PCD_ENDP_IN         1U
+
+#define EP_TYPE_CTRL        0U
+#define EP_TYPE_ISOC        1U
+#define EP_TYPE_BULK        2U
+#define EP_TYPE_INTR        3U
+
+/* 主机上无中断，关中断只记录状态 */
+extern uint32_t stub_primask;
+
+static inline uint32_t __get_PRIMASK(void) {
+    return stub_primask;
+}
+
+static inline void __disable_irq(void) {
+    stub_primask = 1;
+}
+
+static inline void __set_PRIMASK(uint32_t primask) {
+    stub_primask = primask;
+}
+
+/* PCD接口 */
+HAL_StatusTypeDef HAL_PCD_Init(PCD_HandleTypeDef *hpcd);
+HAL_StatusTypeDef HAL_PCD_DeInit(PCD_HandleTypeDef *hpcd);
+HAL_StatusTypeDef HAL_PCD_Start(PCD_HandleTypeDef *hpcd);
+HAL_StatusTypeDef HAL_PCD_Stop(PCD_HandleTypeDef *hpcd);
+HAL_StatusTypeDef HAL_PCD_DevConnect(PCD_HandleTypeDef *hpcd);
+HAL_StatusTypeDef HAL_PCD_DevDisconnect(PCD_HandleTypeDef *hpcd);
+HAL_StatusTypeDef HAL_PCD_SetAddress(PCD_HandleTypeDef *hpcd, uint8_t address);
+HAL_StatusTypeDef HAL_PCD_RegisterCallback(PCD_HandleTypeDef *hpcd, HAL_PCD_CallbackIDTypeDef id, void *callback);
+HAL_StatusTypeDef HAL_PCD_EP_Open(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, uint16_t ep_mps, uint8_t ep_type);
+HAL_StatusTypeDef HAL_PCD_EP_Transmit(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, uint8_t *buf, uint32_t len);
+HAL_StatusTypeDef HAL_PCD_EP_Receive(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, uint8_t *buf, uint32_t len);
+HAL_StatusTypeDef HAL_PCD_EP_Abort(PCD_HandleTypeDef *hpcd, uint8_t ep_addr);
+HAL_StatusTypeDef HAL_PCD_EP_Flush(PCD_HandleTypeDef *hpcd, uint8_t ep_addr);
+HAL_StatusTypeDef HAL_PCD_EP_ClrStall(PCD_HandleTypeDef *hpcd, uint8_t ep_addr);
+
+/* USB设备库底层接口 */
+int USBD_Init(USBD_HandleTypeDef *pdev, void *pdesc, uint8_t id);
+int USBD_LL_SetupStage(USBD_HandleTypeDef *pdev, uint8_t *psetup);
+int USBD_LL_DataOutStage(USBD_HandleTypeDef *pdev, uint8_t epnum, uint8_t *pdata);
+int USBD_LL_DataInStage(USBD_HandleTypeDef *pdev, uint8_t epnum, uint8_t *pdata);
+int USBD_LL_SOF(USBD_HandleTypeDef *pdev);
+int USBD_LL_SetSpeed(USBD_HandleTypeDef *pdev, USBD_SpeedTypeDef speed);
+int USBD_LL_Reset(USBD_HandleTypeDef *pdev);
+int USBD_LL_Suspend(USBD_HandleTypeDef *pdev);
+int USBD_LL_Resume(USBD_HandleTypeDef *pdev);
+int USBD_LL_IsoINIncomplete(USBD_HandleTypeDef *pdev, uint8_t epnum);
+int USBD_LL_IsoOUTIncomplete(USBD_HandleTypeDef *pdev, uint8_t epnum);
+int USBD_LL_DevConnected(USBD_HandleTypeDef *pdev);
+int USBD_LL_DevDisconnected(USBD_HandleTypeDef *pdev);
+uint32_t USBD_LL_GetRxDataSize(USBD_HandleTypeDef *pdev, uint8_t epnum);
+
+#endif /* STM32_PLATFORM_H */
@@ -0,0 +1,547 @@
+/**
+ * @file test_usb_queue.c
+ * @brief STM32 USB端点传输队列与流的主机测试
+ *
+ * 该文件把drivers/base/usb/stm32_usb.c与本目录的HAL桩一起编译，记录端点的
+ * 发送、接收、中止和刷新调用，并模拟传输完成中断，测试队列顺序、零长度包、
+ * 取消时先中止再刷新、IN/OUT流的缓冲区轮转，以及去初始化时取消全部传输。
+ *
+ * 依赖本目录的桩头文件，不参与固件和run_tests构建。启用ENABLE_TESTS的主机构建
+ * 生成usb_queue_test并注册到ctest，也可以单独编译运行：
+ *
+ *   gcc -std=c99 -DCONFIG_USB_HAL_STUB_TEST -Itests/usb_stub -Iinclude -Iinclude/common -Idrivers \
+ *       tests/usb_stub/test_usb_queue.c tests/unit_test.c -o usb_queue_test
+ */
+
+#ifdef CONFIG_USB_HAL_STUB_TEST
+
+#include "unit_test.h"
+#include "base/usb/stm32_usb.c"
+
+#define TEST_EP_IN          0x81
+#define TEST_EP_OUT         0x02
+#define TEST_EP_INT         0x83
+#define TEST_MPS            64
+#define TEST_LOG_SIZE       64
+
+/* HAL调用类型 */
+typedef enum {
+    STUB_CALL_TRANSMIT,
+    STUB_CALL_RECEIVE,
+    STUB_CALL_ABORT,
+    STUB_CALL_FLUSH,
+    STUB_CALL_STOP
+} stub_call_type_t;
+
+/* HAL调用记录 */
+typedef struct {
+    stub_call_type_t type;
+    uint8_t ep_addr;
+    uint8_t *buf;
+    uint32_t len;
+} stub_call_t;
+
+/* 传输完成回调记录 */
+typedef struct {
+    uint32_t count;
+    usb_status_t status[8];
+    uint32_t actual[8];
+    uint32_t calls_at_callback[8];
+} test_record_t;
+
+uint32_t stub_primask;
+
+static stub_call_t stub_calls[TEST_LOG_SIZE];
+static uint32_t stub_call_count;
+static uint32_t stub_rx_size;
+
+static usb_handle_t usb;
+static test_record_t record;
+static uint8_t tx_data[8][256];
+static uint8_t stream_buffers[2][TEST_MPS];
+
+static const usb_endpoint_config_t test_endpoints[] = {
+    {TEST_EP_IN, USB_ENDPOINT_BULK, TEST_MPS},
+    {TEST_EP_OUT, USB_ENDPOINT_BULK, TEST_MPS},
+    {TEST_EP_INT, USB_ENDPOINT_INTERRUPT, TEST_MPS}
+};
+
+static const usb_interface_config_t test_interface = {
+    test_endpoints,
+    sizeof(test_endpoints) / sizeof(test_endpoints[0])
+};
+
+/* 记录一次HAL调用 */
+static void stub_log(stub_call_type_t type, uint8_t ep_addr, uint8_t *buf, uint32_t len)
+{
+    if (stub_call_count < TEST_LOG_SIZE) {
+        stub_calls[stub_call_count].type = type;
+        stub_calls[stub_call_count].ep_addr = ep_addr;
+        stub_calls[stub_call_count].buf = buf;
+        stub_calls[stub_call_count].len = len;
+    }
+    stub_call_count++;
+}
+
+HAL_StatusTypeDef HAL_PCD_EP_Transmit(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, uint8_t *buf, uint32_t len)
+{
+    stub_log(STUB_CALL_TRANSMIT, ep_addr, buf, len);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCD_EP_Receive(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, uint8_t *buf, uint32_t len)
+{
+    stub_log(STUB_CALL_RECEIVE, ep_addr, buf, len);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCD_EP_Abort(PCD_HandleTypeDef *hpcd, uint8_t ep_addr)
+{
+    stub_log(STUB_CALL_ABORT, ep_addr, NULL, 0);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCD_EP_Flush(PCD_HandleTypeDef *hpcd, uint8_t ep_addr)
+{
+    stub_log(STUB_CALL_FLUSH, ep_addr, NULL, 0);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCD_Init(PCD_HandleTypeDef *hpcd) { return HAL_OK; }
+HAL_StatusTypeDef HAL_PCD_DeInit(PCD_HandleTypeDef *hpcd) { return HAL_OK; }
+HAL_StatusTypeDef HAL_PCD_Start(PCD_HandleTypeDef *hpcd) { return HAL_OK; }
+HAL_StatusTypeDef HAL_PCD_Stop(PCD_HandleTypeDef *hpcd)
+{
+    stub_log(STUB_CALL_STOP, 0, NULL, 0);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_PCD_DevConnect(PCD_HandleTypeDef *hpcd) { return HAL_OK; }
+HAL_StatusTypeDef HAL_PCD_DevDisconnect(PCD_HandleTypeDef *hpcd) { return HAL_OK; }
+HAL_StatusTypeDef HAL_PCD_SetAddress(PCD_HandleTypeDef *hpcd, uint8_t address) { return HAL_OK; }
+HAL_StatusTypeDef HAL_PCD_RegisterCallback(PCD_HandleTypeDef *hpcd, HAL_PCD_CallbackIDTypeDef id, void *callback) { return HAL_OK; }
+HAL_StatusTypeDef HAL_PCD_EP_Open(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, uint16_t ep_mps, uint8_t ep_type) { return HAL_OK; }
+HAL_StatusTypeDef HAL_PCD_EP_ClrStall(PCD_HandleTypeDef *hpcd, uint8_t ep_addr) { return HAL_OK; }
+
+int USBD_Init(USBD_HandleTypeDef *pdev, void *pdesc, uint8_t id) { return 0; }
+int USBD_LL_SetupStage(USBD_HandleTypeDef *pdev, uint8_t *psetup) { return 0; }
+int USBD_LL_DataOutStage(USBD_HandleTypeDef *pdev, uint8_t epnum, uint8_t *pdata) { return 0; }
+int USBD_LL_DataInStage(USBD_HandleTypeDef *pdev, uint8_t epnum, uint8_t *pdata) { return 0; }
+int USBD_LL_SOF(USBD_HandleTypeDef *pdev) { return 0; }
+int USBD_LL_SetSpeed(USBD_HandleTypeDef *pdev, USBD_SpeedTypeDef speed) { return 0; }
+int USBD_LL_Reset(USBD_HandleTypeDef *pdev) { return 0; }
+int USBD_LL_Suspend(USBD_HandleTypeDef *pdev) { return 0; }
+int USBD_LL_Resume(USBD_HandleTypeDef *pdev) { return 0; }
+int USBD_LL_IsoINIncomplete(USBD_HandleTypeDef *pdev, uint8_t epnum) { return 0; }
+int USBD_LL_IsoOUTIncomplete(USBD_HandleTypeDef *pdev, uint8_t epnum) { return 0; }
+int USBD_LL_DevConnected(USBD_HandleTypeDef *pdev) { return 0; }
+int USBD_LL_DevDisconnected(USBD_HandleTypeDef *pdev) { return 0; }
+
+uint32_t USBD_LL_GetRxDataSize(USBD_HandleTypeDef *pdev, uint8_t epnum)
+{
+    return stub_rx_size;
+}
+
+/* 统计某类HAL调用的次数 */
+static uint32_t stub_count(stub_call_type_t type)
+{
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < stub_call_count && i < TEST_LOG_SIZE; i++) {
+        if (stub_calls[i].type == type) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static const stub_call_t *stub_last(void)
+{
+    return &stub_calls[stub_call_count - 1];
+}
+
+/* 模拟IN端点传输完成中断 */
+static void stub_in_complete(uint8_t ep_num, uint32_t count)
+{
+    stm32_usb_t *usb_dev = (stm32_usb_t *)usb;
+
+    usb_dev->hpcd.IN_ep[ep_num].xfer_count = count;
+    HAL_PCD_DataInStageCallback(&usb_dev->hpcd, ep_num);
+}
+
+/* 模拟OUT端点收到数据的中断 */
+static void stub_out_complete(uint8_t ep_num, uint32_t count)
+{
+    stm32_usb_t *usb_dev = (stm32_usb_t *)usb;
+
+    stub_rx_size = count;
+    HAL_PCD_DataOutStageCallback(&usb_dev->hpcd, ep_num);
+}
+
+/* 传输完成回调，记录回调时已发生的HAL调用数 */
+static void test_transfer_callback(void *arg, usb_status_t status, usb_transfer_t *transfer)
+{
+    test_record_t *rec = (test_record_t *)arg;
+
+    if (rec->count < 8) {
+        rec->status[rec->count] = status;
+        rec->actual[rec->count] = transfer->actual_length;
+        rec->calls_at_callback[rec->count] = stub_call_count;
+    }
+    rec->count++;
+}
+
+/* 流回调 */
+static void test_stream_callback(void *arg, uint8_t ep_addr, usb_status_t status, uint32_t length)
+{
+    test_record_t *rec = (test_record_t *)arg;
+
+    if (rec->count < 8) {
+        rec->status[rec->count] = status;
+        rec->actual[rec->count] = length;
+    }
+    rec->count++;
+}
+
+/* 提交一个传输 */
+static int test_submit(uint8_t ep_addr, uint8_t index, uint32_t length)
+{
+    usb_transfer_t transfer;
+
+    memset(&transfer, 0, sizeof(transfer));
+    transfer.ep_addr = ep_addr;
+    transfer.buffer = tx_data[index];
+    transfer.length = length;
+    transfer.type = USB_TRANSFER_DATA;
+    return usb_transfer(usb, &transfer, test_transfer_callback, &record);
+}
+
+/* 打开两个缓冲区的流 */
+static int test_stream_open(uint8_t ep_addr)
+{
+    usb_stream_config_t config;
+
+    memset(&config, 0, sizeof(config));
+    config.ep_addr = ep_addr;
+    config.buffers[0] = stream_buffers[0];
+    config.buffers[1] = stream_buffers[1];
+    config.buffer_count = 2;
+    config.buffer_size = TEST_MPS;
+    config.auto_zlp = true;
+    config.callback = test_stream_callback;
+    config.arg = &record;
+    return usb_stream_open(usb, &config);
+}
+
+/* 测试传输按提交顺序执行，下一个传输在回调前启动 */
+static void test_usb_queue_order(void)
+{
+    for (uint8_t i = 0; i < CONFIG_USB_EP_QUEUE_DEPTH; i++) {
+        UT_ASSERT_EQUAL_INT(0, test_submit(TEST_EP_IN, i, 10 + i));
+    }
+    UT_ASSERT(test_submit(TEST_EP_IN, 4, 10) != 0);
+
+    /* 只有队首在传输 */
+    UT_ASSERT_EQUAL_INT(1, stub_call_count);
+    UT_ASSERT(stub_calls[0].type == STUB_CALL_TRANSMIT);
+    UT_ASSERT(stub_calls[0].buf == tx_data[0]);
+
+    stub_in_complete(1, 10);
+    UT_ASSERT_EQUAL_INT(1, record.count);
+    UT_ASSERT_EQUAL_INT(USB_STATUS_COMPLETE, record.status[0]);
+    UT_ASSERT_EQUAL_INT(10, record.actual[0]);
+    UT_ASSERT_EQUAL_INT(2, record.calls_at_callback[0]);
+    UT_ASSERT(stub_last()->buf == tx_data[1]);
+
+    for (uint8_t i = 1; i < CONFIG_USB_EP_QUEUE_DEPTH; i++) {
+        stub_in_complete(1, 10 + i);
+    }
+    UT_ASSERT_EQUAL_INT(CONFIG_USB_EP_QUEUE_DEPTH, record.count);
+    UT_ASSERT_EQUAL_INT(CONFIG_USB_EP_QUEUE_DEPTH, stub_count(STUB_CALL_TRANSMIT));
+    UT_ASSERT_EQUAL_INT(13, record.actual[3]);
+
+    /* 队列空时的完成中断被忽略 */
+    stub_in_complete(1, 0);
+    UT_ASSERT_EQUAL_INT(CONFIG_USB_EP_QUEUE_DEPTH, record.count);
+    UT_ASSERT_EQUAL_INT(CONFIG_USB_EP_QUEUE_DEPTH, stub_call_count);
+}
+
+/* 测试批量IN传输以整包结束时补发零长度包 */
+static void test_usb_queue_zlp(void)
+{
+    UT_ASSERT_EQUAL_INT(0, test_submit(TEST_EP_IN, 0, 2 * TEST_MPS));
+    UT_ASSERT_EQUAL_INT(0, test_submit(TEST_EP_IN, 1, 5));
+
+    stub_in_complete(1, 2 * TEST_MPS);
+    UT_ASSERT_EQUAL_INT(1, record.count);
+    UT_ASSERT_EQUAL_INT(2, stub_call_count);
+    UT_ASSERT(stub_last()->buf == NULL);
+    UT_ASSERT_EQUAL_INT(0, stub_last()->len);
+
+    /* 零长度包发送完成后才启动下一个传输 */
+    stub_in_complete(1, 0);
+    UT_ASSERT_EQUAL_INT(1, record.count);
+    UT_ASSERT_EQUAL_INT(3, stub_call_count);
+    UT_ASSERT(stub_last()->buf == tx_data[1]);
+    stub_in_complete(1, 5);
+    UT_ASSERT_EQUAL_INT(2, record.count);
+
+    /* 中断端点不补发 */
+    UT_ASSERT_EQUAL_INT(0, test_submit(TEST_EP_INT, 2, TEST_MPS));
+    stub_in_complete(3, TEST_MPS);
+    UT_ASSERT_EQUAL_INT(3, record.count);
+    UT_ASSERT_EQUAL_INT(4, stub_call_count);
+}
+
+/* 测试取消时先中止端点再刷新FIFO，排队的传输以错误状态完成 */
+static void test_usb_queue_cancel(void)
+{
+    for (uint8_t i = 0; i < 3; i++) {
+        test_submit(TEST_EP_IN, i, 10);
+    }
+
+    UT_ASSERT_EQUAL_INT(0, usb_cancel_transfer(usb, TEST_EP_IN));
+    UT_ASSERT_EQUAL_INT(3, stub_call_count);
+    UT_ASSERT(stub_calls[1].type == STUB_CALL_ABORT);
+    UT_ASSERT_EQUAL_INT(TEST_EP_IN, stub_calls[1].ep_addr);
+    UT_ASSERT(stub_calls[2].type == STUB_CALL_FLUSH);
+    UT_ASSERT_EQUAL_INT(TEST_EP_IN, stub_calls[2].ep_addr);
+
+    UT_ASSERT_EQUAL_INT(3, record.count);
+    for (uint8_t i = 0; i < 3; i++) {
+        UT_ASSERT_EQUAL_INT(USB_STATUS_ERROR, record.status[i]);
+        UT_ASSERT_EQUAL_INT(0, record.actual[i]);
+    }
+
+    /* 中止前已触发的完成中断不再回调 */
+    stub_in_complete(1, 10);
+    UT_ASSERT_EQUAL_INT(3, record.count);
+    UT_ASSERT_EQUAL_INT(3, stub_call_count);
+
+    /* 取消后端点空闲，新传输立即启动 */
+    UT_ASSERT_EQUAL_INT(0, test_submit(TEST_EP_IN, 3, 10));
+    UT_ASSERT(stub_last()->type == STUB_CALL_TRANSMIT);
+
+    /* OUT端点按方向位刷新接收FIFO */
+    test_submit(TEST_EP_OUT, 4, TEST_MPS);
+    usb_cancel_transfer(usb, TEST_EP_OUT);
+    UT_ASSERT(stub_calls[stub_call_count - 2].type == STUB_CALL_ABORT);
+    UT_ASSERT_EQUAL_INT(TEST_EP_OUT, stub_calls[stub_call_count - 2].ep_addr);
+    UT_ASSERT(stub_last()->type == STUB_CALL_FLUSH);
+    UT_ASSERT_EQUAL_INT(TEST_EP_OUT, stub_last()->ep_addr);
+}
+
+/* 测试IN流的写入、缓冲区轮转和刷新 */
+static void test_usb_stream_in(void)
+{
+    uint8_t data[160];
+    uint32_t bytes;
+
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)i;
+    }
+
+    UT_ASSERT_EQUAL_INT(0, test_stream_open(TEST_EP_IN));
+    UT_ASSERT(test_submit(TEST_EP_IN, 0, 10) != 0);
+
+    /* 写满的缓冲区立即发送 */
+    UT_ASSERT_EQUAL_INT(100, usb_stream_write(usb, TEST_EP_IN, data, 100));
+    UT_ASSERT_EQUAL_INT(1, stub_count(STUB_CALL_TRANSMIT));
+    UT_ASSERT(stub_last()->buf == stream_buffers[0]);
+    UT_ASSERT_EQUAL_INT(TEST_MPS, stub_last()->len);
+    usb_stream_available(usb, TEST_EP_IN, &bytes);
+    UT_ASSERT_EQUAL_INT(TEST_MPS - 36, bytes);
+
+    /* 两个缓冲区都在队列中时不再接受数据 */
+    UT_ASSERT_EQUAL_INT(TEST_MPS - 36, usb_stream_write(usb, TEST_EP_IN, data + 100, 50));
+    UT_ASSERT_EQUAL_INT(0, usb_stream_write(usb, TEST_EP_IN, data, 10));
+    UT_ASSERT(memcmp(stream_buffers[1], data + TEST_MPS, TEST_MPS) == 0);
+
+    stub_in_complete(1, TEST_MPS);
+    UT_ASSERT_EQUAL_INT(1, record.count);
+    UT_ASSERT_EQUAL_INT(TEST_MPS, record.actual[0]);
+    UT_ASSERT_EQUAL_INT(2, stub_count(STUB_CALL_TRANSMIT));
+    UT_ASSERT(stub_last()->buf == stream_buffers[1]);
+
+    /* 刷新发送未写满的缓冲区 */
+    UT_ASSERT_EQUAL_INT(20, usb_stream_write(usb, TEST_EP_IN, data, 20));
+    UT_ASSERT_EQUAL_INT(0, usb_stream_flush(usb, TEST_EP_IN));
+    stub_in_complete(1, TEST_MPS);
+    UT_ASSERT_EQUAL_INT(3, stub_count(STUB_CALL_TRANSMIT));
+    UT_ASSERT(stub_last()->buf == stream_buffers[0]);
+    UT_ASSERT_EQUAL_INT(20, stub_last()->len);
+    UT_ASSERT(memcmp(stream_buffers[0], data, 20) == 0);
+    stub_in_complete(1, 20);
+    UT_ASSERT_EQUAL_INT(3, record.count);
+
+    /* 没有数据时刷新不发送 */
+    UT_ASSERT_EQUAL_INT(0, usb_stream_flush(usb, TEST_EP_IN));
+    UT_ASSERT_EQUAL_INT(3, stub_count(STUB_CALL_TRANSMIT));
+    UT_ASSERT_EQUAL_INT(0, usb_stream_close(usb, TEST_EP_IN));
+}
+
+/* 测试OUT流按接收顺序读取并重新投递缓冲区 */
+static void test_usb_stream_out(void)
+{
+    uint8_t data[TEST_MPS];
+    uint32_t bytes;
+
+    /* 全部缓冲区已投递，队首在接收 */
+    UT_ASSERT_EQUAL_INT(0, test_stream_open(TEST_EP_OUT));
+    UT_ASSERT_EQUAL_INT(1, stub_count(STUB_CALL_RECEIVE));
+    UT_ASSERT(stub_last()->buf == stream_buffers[0]);
+    UT_ASSERT_EQUAL_INT(0, usb_stream_read(usb, TEST_EP_OUT, data, sizeof(data)));
+
+    memset(stream_buffers[0], 0xA5, 10);
+    stub_out_complete(2, 10);
+    UT_ASSERT_EQUAL_INT(1, record.count);
+    UT_ASSERT_EQUAL_INT(10, record.actual[0]);
+    UT_ASSERT_EQUAL_INT(2, stub_count(STUB_CALL_RECEIVE));
+    UT_ASSERT(stub_last()->buf == stream_buffers[1]);
+
+    usb_stream_available(usb, TEST_EP_OUT, &bytes);
+    UT_ASSERT_EQUAL_INT(10, bytes);
+    UT_ASSERT_EQUAL_INT(4, usb_stream_read(usb, TEST_EP_OUT, data, 4));
+    usb_stream_available(usb, TEST_EP_OUT, &bytes);
+    UT_ASSERT_EQUAL_INT(6, bytes);
+
+    /* 读空的缓冲区排在正在接收的缓冲区之后重新投递 */
+    UT_ASSERT_EQUAL_INT(6, usb_stream_read(usb, TEST_EP_OUT, data + 4, sizeof(data)));
+    UT_ASSERT_EQUAL_INT(0xA5, data[9]);
+    UT_ASSERT_EQUAL_INT(2, stub_count(STUB_CALL_RECEIVE));
+
+    memset(stream_buffers[1], 0x5A, TEST_MPS);
+    stub_out_complete(2, TEST_MPS);
+    UT_ASSERT_EQUAL_INT(3, stub_count(STUB_CALL_RECEIVE));
+    UT_ASSERT(stub_last()->buf == stream_buffers[0]);
+    UT_ASSERT_EQUAL_INT(TEST_MPS, usb_stream_read(usb, TEST_EP_OUT, data, sizeof(data)));
+    UT_ASSERT_EQUAL_INT(0x5A, data[TEST_MPS - 1]);
+    UT_ASSERT_EQUAL_INT(0, usb_stream_close(usb, TEST_EP_OUT));
+}
+
+/* 测试关闭流时中止端点，关闭后不再回调且端点可用于普通传输 */
+static void test_usb_stream_close(void)
+{
+    uint8_t data[TEST_MPS];
+
+    test_stream_open(TEST_EP_OUT);
+    UT_ASSERT_EQUAL_INT(0, usb_stream_close(usb, TEST_EP_OUT));
+    UT_ASSERT_EQUAL_INT(3, stub_call_count);
+    UT_ASSERT(stub_calls[1].type == STUB_CALL_ABORT);
+    UT_ASSERT_EQUAL_INT(TEST_EP_OUT, stub_calls[1].ep_addr);
+    UT_ASSERT(stub_calls[2].type == STUB_CALL_FLUSH);
+    UT_ASSERT_EQUAL_INT(0, record.count);
+
+    stub_out_complete(2, 10);
+    UT_ASSERT_EQUAL_INT(0, record.count);
+    UT_ASSERT(usb_stream_read(usb, TEST_EP_OUT, data, sizeof(data)) < 0);
+
+    UT_ASSERT_EQUAL_INT(0, test_submit(TEST_EP_OUT, 0, TEST_MPS));
+    UT_ASSERT(stub_last()->type == STUB_CALL_RECEIVE);
+    usb_cancel_transfer(usb, TEST_EP_OUT);
+
+    /* IN流关闭时丢弃正在发送的缓冲区 */
+    record.count = 0;
+    test_stream_open(TEST_EP_IN);
+    usb_stream_write(usb, TEST_EP_IN, data, sizeof(data));
+    UT_ASSERT(stub_last()->type == STUB_CALL_TRANSMIT);
+    UT_ASSERT_EQUAL_INT(0, usb_stream_close(usb, TEST_EP_IN));
+    UT_ASSERT(stub_calls[stub_call_count - 2].type == STUB_CALL_ABORT);
+    UT_ASSERT_EQUAL_INT(TEST_EP_IN, stub_calls[stub_call_count - 2].ep_addr);
+    UT_ASSERT(stub_last()->type == STUB_CALL_FLUSH);
+    UT_ASSERT_EQUAL_INT(0, record.count);
+}
+
+/* 测试去初始化时取消全部端点上的传输并关闭流，再停止外设 */
+static void test_usb_deinit(void)
+{
+    stm32_usb_t *usb_dev = (stm32_usb_t *)usb;
+    uint8_t data[TEST_MPS];
+
+    /* IN端点正在补发零长度包，其后排队一个传输；OUT端点上打开流 */
+    test_submit(TEST_EP_IN, 0, 2 * TEST_MPS);
+    test_submit(TEST_EP_IN, 1, 10);
+    stub_in_complete(1, 2 * TEST_MPS);
+    UT_ASSERT_EQUAL_INT(1, record.count);
+    test_stream_open(TEST_EP_OUT);
+
+    /* 每个端点先中止再刷新，排队的传输以错误状态回调，最后停止外设 */
+    UT_ASSERT_EQUAL_INT(0, usb_deinit(usb));
+    UT_ASSERT_EQUAL_INT(2, record.count);
+    UT_ASSERT_EQUAL_INT(USB_STATUS_ERROR, record.status[1]);
+    UT_ASSERT_EQUAL_INT(3, stub_count(STUB_CALL_ABORT));
+    UT_ASSERT_EQUAL_INT(3, stub_count(STUB_CALL_FLUSH));
+    UT_ASSERT(stub_last()->type == STUB_CALL_STOP);
+
+    for (int i = 0; i < STM32_USB_MAX_ENDPOINTS; i++) {
+        UT_ASSERT_EQUAL_INT(0, usb_dev->endpoints[i].queue_count);
+        UT_ASSERT(!usb_dev->endpoints[i].zlp_pending);
+        UT_ASSERT(!usb_dev->endpoints[i].stream.open);
+    }
+
+    /* 之后的完成中断和流操作不再访问旧的传输 */
+    stub_in_complete(1, 0);
+    stub_out_complete(2, 10);
+    UT_ASSERT_EQUAL_INT(2, record.count);
+    UT_ASSERT(usb_stream_read(usb, TEST_EP_OUT, data, sizeof(data)) < 0);
+}
+
+/* 每个测试案例使用新初始化的设备 */
+static void usb_queue_test_setup(void)
+{
+    usb_config_t config;
+
+    memset(&config, 0, sizeof(config));
+    config.interfaces = &test_interface;
+    config.num_interfaces = 1;
+
+    memset(&record, 0, sizeof(record));
+    usb_init(&config, NULL, NULL, &usb);
+    stub_call_count = 0;
+}
+
+/* 测试案例清理 */
+static void usb_queue_test_teardown(void)
+{
+    usb_deinit(usb);
+}
+
+/* USB队列测试案例 */
+static ut_test_case_t usb_queue_test_cases[] = {
+    {"队列顺序测试", test_usb_queue_order},
+    {"零长度包测试", test_usb_queue_zlp},
+    {"取消传输测试", test_usb_queue_cancel},
+    {"IN流测试", test_usb_stream_in},
+    {"OUT流测试", test_usb_stream_out},
+    {"关闭流测试", test_usb_stream_close},
+    {"去初始化测试", test_usb_deinit}
+};
+
+/* USB队列测试套件 */
+ut_test_suite_t usb_queue_test_suite = {
+    "STM32 USB队列测试套件",
+    usb_queue_test_cases,
+    sizeof(usb_queue_test_cases) / sizeof(usb_queue_test_cases[0]),
+    NULL,
+    NULL,
+    usb_queue_test_setup,
+    usb_queue_test_teardown
+};
+
+/**
+ * @brief 主机测试入口
+ *
+ * @return int 0表示全部通过，非0表示存在失败
+ */
+int main(void)
+{
+    ut_statistics_t stats;
+
+    ut_init_statistics(&stats);
+    ut_run_suite(&usb_queue_test_suite, &stats);
+    ut_print_statistics(&stats);
+
+    return (stats.failed_cases == 0) ? 0 : 1;
+}
+
+#endif /* CONFIG_USB_HAL_STUB_TEST */